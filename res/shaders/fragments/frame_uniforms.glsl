@@ -26,6 +26,11 @@ layout (std140, binding = 1) uniform b_InstanceLevelUniforms {
     uniform mat4 u_ModelView;
     // Normal Matrix for transforming normals
     uniform mat4 u_NormalMatrix;
+    // Converts compressed positions back to model space (position * scale + offset)
+    uniform vec4 u_PositionScale;
+    uniform vec4 u_PositionOffset;
+    // How the mesh's vertices are encoded, see vertex_decode.glsl
+    uniform uint u_VertexEncoding;
 };
 
 #define FLAG_ENABLE_COLOR_CORRECTION (1 << 0)
@@ -0,0 +1,50 @@
+// Decodes the vertex inputs from vs_common.glsl, which may be compressed (see VertexCompression in the engine)
+// Requires the instance level uniforms from frame_uniforms.glsl
+
+#define VERTEX_ENCODING_FLOAT         0u
+#define VERTEX_ENCODING_OCT_NORMAL    1u
+#define VERTEX_ENCODING_TANGENT_FRAME 2u
+
+// The decoded vertex attributes, in model space. These are filled in by DecodeVertex
+vec3 inPosition;
+vec3 inNormal;
+vec3 inTangent;
+vec3 inBiTangent;
+
+// Unpacks a normal that was projected onto an octahedron and folded into the -1 to 1 square
+vec3 DecodeOctahedral(vec2 encoded) {
+    vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
+
+// Rotates a vector by a unit quaternion
+vec3 RotateByQuaternion(vec4 q, vec3 v) {
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+// Unpacks a quaternion tangent frame, the sign of W is the handedness of the bitangent
+void DecodeTangentFrame(vec4 frame, out vec3 normal, out vec3 tangent, out vec3 bitangent) {
+    vec4 q = normalize(frame);
+    tangent = RotateByQuaternion(q, vec3(1.0, 0.0, 0.0));
+    normal = RotateByQuaternion(q, vec3(0.0, 0.0, 1.0));
+    bitangent = cross(normal, tangent) * (frame.w < 0.0 ? -1.0 : 1.0);
+}
+
+// Fills in inPosition, inNormal, inTangent and inBiTangent, should be called at the start of main
+void DecodeVertex() {
+    inPosition = inRawPosition * u_PositionScale.xyz + u_PositionOffset.xyz;
+    if (u_VertexEncoding == VERTEX_ENCODING_TANGENT_FRAME) {
+        DecodeTangentFrame(inRawTangent, inNormal, inTangent, inBiTangent);
+    } else if (u_VertexEncoding == VERTEX_ENCODING_OCT_NORMAL) {
+        inNormal = DecodeOctahedral(inRawNormal.xy);
+        inTangent = vec3(0.0);
+        inBiTangent = vec3(0.0);
+    } else {
+        inNormal = inRawNormal;
+        inTangent = inRawTangent.xyz;
+        inBiTangent = inRawBiTangent;
+    }
+}
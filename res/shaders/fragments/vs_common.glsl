@@ -1,12 +1,13 @@
 
-// Vertex inputs
-layout(location = 0) in vec3 inPosition;
+// Vertex inputs, the position, normal and tangents may be compressed so shaders should call
+// DecodeVertex and use the decoded values from vertex_decode.glsl instead
+layout(location = 0) in vec3 inRawPosition;
 layout(location = 1) in vec3 inColor;
-layout(location = 2) in vec3 inNormal;
+layout(location = 2) in vec3 inRawNormal;
 layout(location = 3) in vec2 inUV;
 
-layout(location = 4) in vec3 inTangent;
-layout(location = 5) in vec3 inBiTangent;
+layout(location = 4) in vec4 inRawTangent;
+layout(location = 5) in vec3 inRawBiTangent;
 
 // Standard vertex shader outputs
 layout(location = 0) out vec3 outViewPos;
@@ -17,3 +18,5 @@ layout(location = 4) out mat3 outTBN;
 
 // Include the matrices and frame level parameters
 #include "frame_uniforms.glsl"
+// Include the functions for decoding compressed vertices
+#include "vertex_decode.glsl"
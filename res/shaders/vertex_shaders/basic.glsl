@@ -4,6 +4,8 @@
 #include "../fragments/vs_common.glsl"
 
 void main() {
+	// Unpack the vertex attributes, which may be compressed
+	DecodeVertex();
 
 	gl_Position = u_ModelViewProjection * vec4(inPosition, 1.0);
 
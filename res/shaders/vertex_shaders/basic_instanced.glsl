@@ -10,6 +10,8 @@ layout(location = 8) in mat4 inModelTransform;
 layout(location = 12) in mat3 inNormalMatrix;
 
 void main() {
+	// Unpack the vertex attributes, which may be compressed
+	DecodeVertex();
 	// We take the hit of doing a matrix multiplication instead of using more bandwidth to send all the matrices
 	gl_Position = (u_ViewProjection * inModelTransform) * vec4(inPosition, 1.0); 
 
@@ -11,6 +11,8 @@ uniform sampler2D s_NormalMap;
 uniform float u_Scale;
 
 void main() {
+	// Unpack the vertex attributes, which may be compressed
+	DecodeVertex();
     
     // Read our displacement value from the texture and apply the scale
     float displacement = textureLod(s_Heightmap, inUV, 0).r * u_Scale;
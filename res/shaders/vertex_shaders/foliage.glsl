@@ -9,6 +9,8 @@ uniform float u_VerticalScale;
 uniform float u_WindSpeed;
 
 void main() {
+	// Unpack the vertex attributes, which may be compressed
+	DecodeVertex();
     // Determine the offset based on our simple wind calcualtion
     vec3 windFactor = normalize(u_WindDirection) * sin(u_Time * u_WindSpeed) * cos(inPosition.z * u_VerticalScale) * u_WindStrength;
 	// Calculate the output world position
@@ -6,11 +6,15 @@ layout(location = 0) out vec3 outNormal;
 
 uniform mat4 u_ClippedView;
 uniform mat3 u_EnvironmentRotation;
+// Converts compressed positions back to model space, see fragments/vertex_decode.glsl
+uniform vec3 u_PositionScale = vec3(1.0);
+uniform vec3 u_PositionOffset = vec3(0.0);
 
 void main() {
-    vec4 pos = u_ClippedView * vec4(inPosition, 1.0);
+    vec3 position = inPosition * u_PositionScale + u_PositionOffset;
+    vec4 pos = u_ClippedView * vec4(position, 1.0);
     gl_Position = pos.xyww;
 
     // Normals
-    outNormal = normalize(u_EnvironmentRotation * inPosition);
+    outNormal = normalize(u_EnvironmentRotation * position);
 }
\ No newline at end of file
@@ -10,6 +10,8 @@ layout(location = 6) in vec4 inTextureWeights;
 layout(location = 7) out vec4 outTextureWeights;
 
 void main() {
+	// Unpack the vertex attributes, which may be compressed
+	DecodeVertex();
 
 	gl_Position = u_ModelViewProjection * vec4(inPosition, 1.0);
 
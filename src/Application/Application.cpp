@@ -12,6 +12,7 @@
 #include "Utils/FileHelpers.h"
 #include "Utils/ResourceManager/ResourceManager.h"
 #include "Utils/ImGuiHelper.h"
+#include "Utils/MeshOptimizer.h"
 
 // Graphics
 #include "Graphics/Buffers/IndexBuffer.h"
@@ -29,6 +30,7 @@
 
 // Gameplay
 #include "Gameplay/Material.h"
+#include "Gameplay/Prefab.h"
 #include "Gameplay/GameObject.h"
 #include "Gameplay/Scene.h"
 
@@ -79,7 +81,14 @@ Application::Application() :
 	_windowTitle("INFR - 2350U"),
 	_currentScene(nullptr),
 	_targetScene(nullptr),
-	_renderOutput(nullptr)
+	_renderOutput(nullptr),
+	_jobs(nullptr),
+	_frame(nullptr),
+	_frameLoop(nullptr),
+	_sceneLoader(nullptr),
+	_sceneLoadBudget(4.0f),
+	_worldStreamer(nullptr),
+	_streamingBudget(2.0f)
 { }
 
 Application::~Application() = default; 
@@ -123,7 +132,7 @@ bool Application::LoadScene(const std::string& path) {
 		std::string manifestPath = std::filesystem::path(path).stem().string() + "-manifest.json";
 		if (std::filesystem::exists(manifestPath)) {
 			LOG_INFO("Loading manifest from \"{}\"", manifestPath);
-			ResourceManager::LoadManifest(manifestPath);
+			ResourceManager::LoadManifest(manifestPath, true, _jobs.get());
 		}
 
 		Gameplay::Scene::Sptr scene = Gameplay::Scene::Load(path);
@@ -134,9 +143,21 @@ bool Application::LoadScene(const std::string& path) {
 }
 
 void Application::LoadScene(const Gameplay::Scene::Sptr& scene) {
+	// An explicit scene change wins over one that is still loading
+	if (_sceneLoader != nullptr) {
+		_sceneLoader->Cancel();
+	}
 	_targetScene = scene;
 }
 
+bool Application::LoadSceneAsync(const std::string& path) {
+	if (std::filesystem::exists(path) || std::filesystem::exists(Gameplay::Scene::GetBinaryPath(path))) {
+		_sceneLoader->Start(path);
+		return true;
+	}
+	return false;
+}
+
 void Application::SaveSettings()
 {
 	std::filesystem::path appdata = getenv("APPDATA");
@@ -175,13 +196,73 @@ void Application::_Run()
 	// By default, we want our viewport to be the whole screen
 	_primaryViewport = { 0, 0, _windowSize.x, _windowSize.y };
 
+	// Spin up our worker threads, a negative count sizes the pool to the machine
+	_jobs = std::make_unique<JobSystem>(JsonGet(_appSettings, "worker_threads", -1));
+	_frame = std::make_unique<FrameGraph>(*_jobs);
+
+	// Configure our simulation rate
+	Timing::_singleton._fixedDeltaTime = 1.0f / glm::max(JsonGet(_appSettings, "tick_rate", 60.0f), 1.0f);
+	_frameLoop = std::make_unique<FrameLoop>(*_jobs, *_frame);
+	_frameLoop->FixedDeltaTime = Timing::_singleton._fixedDeltaTime;
+	_frameLoop->MaxTicksPerFrame = glm::max(JsonGet(_appSettings, "max_ticks_per_frame", 5), 1);
+
+	// The editor pokes at the scene from ImGui at any point in the frame, so we only pipeline in game
+	_frameLoop->IsPipelined = !_isEditor && JsonGet(_appSettings, "pipelined_simulation", false);
+
+	_sceneLoader = std::make_unique<SceneLoader>(*_jobs);
+	_sceneLoadBudget = glm::max(JsonGet(_appSettings, "scene_load_budget_ms", 4.0f), 0.1f);
+
+	_worldStreamer = std::make_unique<WorldStreamer>(*_jobs);
+	_worldStreamer->MaxConcurrentLoads = glm::max(JsonGet(_appSettings, "streaming_max_concurrent_loads", 4), 1);
+	_streamingBudget = glm::max(JsonGet(_appSettings, "streaming_budget_ms", 2.0f), 0.1f);
+
+	// Mesh optimization statistics are only useful when tuning the optimizer, so they're off unless asked for
+	MeshOptimizer::Verbose = JsonGet(_appSettings, "verbose_mesh_optimizer", false);
+
 	// Register all component and resource types
 	_RegisterClasses();
 
+	// Resource types with a budget will unload resources that aren't in use to stay within it
+	if (_appSettings.contains("resource_budgets_mb") && _appSettings["resource_budgets_mb"].is_object()) {
+		for (auto& [typeName, budget] : _appSettings["resource_budgets_mb"].items()) {
+			if (budget.is_number()) {
+				ResourceManager::SetMemoryBudget(typeName, static_cast<size_t>(glm::max(budget.get<double>(), 0.0) * 1024.0 * 1024.0));
+			}
+		}
+	}
+
 
 	// Load all layers
 	_Load();
 
+	// The stages of each frame, the frame loop decides when the ticks run around them
+	FrameLoop::Stages stages;
+	stages.BeginTicks = [this](int ticks) {
+		Timing& timing = Timing::_singleton;
+		timing._ticksThisFrame = ticks;
+		timing._interpolationAlpha = _frameLoop->InterpolationAlpha();
+
+		// The ticks read input from a copy taken here on the main thread, so they don't race the
+		// window callbacks when pipelined, and presses in frames without a tick aren't lost
+		if (ticks > 0) {
+			InputEngine::SampleTickInput();
+		}
+	};
+	stages.Simulate = [this](int ticks) { _Simulate(ticks); };
+	stages.Capture = [this](float alpha) {
+		_Update();
+
+		// Blend the last two simulation states for rendering, before LateUpdate so layers can capture them
+		_currentScene->InterpolateTransforms(alpha);
+
+		_LateUpdate();
+	};
+	stages.Render = [this]() {
+		_PreRender();
+		_RenderScene(); 
+		_PostRender();
+	};
+
 	// Grab current time as the previous frame
 	double lastFrame =  glfwGetTime();
 
@@ -189,11 +270,27 @@ void Application::_Run()
 	_isRunning = true;
 	// Infinite loop as long as the application is running
 	while (_isRunning) {
+		// Make progress on any scene that is loading in the background
+		if (_sceneLoader->IsLoading()) {
+			Gameplay::Scene::Sptr loaded = _sceneLoader->Tick(_sceneLoadBudget);
+			if (loaded != nullptr) {
+				_targetScene = loaded;
+			}
+		}
+
 		// Handle scene switching
 		if (_targetScene != nullptr) {
 			_HandleSceneChange();
 		}
 
+		// Stream the world in and out around the camera
+		if (_worldStreamer->IsStreaming() && _currentScene->MainCamera != nullptr) {
+			_worldStreamer->Tick(_currentScene->MainCamera->GetGameObject()->GetWorldPosition(), _streamingBudget);
+		}
+
+		// Unload resources that nothing is using if their type is over budget
+		ResourceManager::Update();
+
 		if (InputEngine::IsKeyDown(GLFW_KEY_1))
 		{
 
@@ -238,13 +335,11 @@ void Application::_Run()
 
 		// Core update loop
 		if (_currentScene != nullptr) {
-			_Update();
-			_LateUpdate();
-			_PreRender();
-			_RenderScene(); 
-			_PostRender();
+			_frameLoop->RunFrame(scaledDt, stages);
 		}
 
+		_frameLoop->EndFrame();
+
 		// Store timing for next loop
 		lastFrame = thisFrame;
 
@@ -257,6 +352,13 @@ void Application::_Run()
 
 	// Unload all our layers
 	_Unload();
+
+	// Make sure no jobs outlive the systems they reference
+	_sceneLoader = nullptr;
+	_worldStreamer = nullptr;
+	_frameLoop = nullptr;
+	_frame = nullptr;
+	_jobs = nullptr;
 }
 
 void Application::_RegisterClasses()
@@ -277,6 +379,7 @@ void Application::_RegisterClasses()
 	ResourceManager::RegisterType<MeshResource>();
 	ResourceManager::RegisterType<Font>();
 	ResourceManager::RegisterType<Framebuffer>();
+	ResourceManager::RegisterType<Prefab>();
 
 	// Register all of our component types so we can load them from files
 	ComponentManager::RegisterType<Camera>();
@@ -317,6 +420,31 @@ void Application::_Load() {
 	GuiBatcher::SetWindowSize(_windowSize);
 }
 
+void Application::_FixedUpdate() {
+	for (const auto& layer : _layers) {
+		if (layer->Enabled && *(layer->Overrides & AppLayerFunctions::OnFixedUpdate)) {
+			layer->OnFixedUpdate();
+		}
+	}
+}
+
+void Application::WaitForSimulation() {
+	_frameLoop->WaitForSimulation();
+}
+
+void Application::_Simulate(int ticks) {
+	for (int ix = 0; ix < ticks; ix++) {
+		InputEngine::BeginTick();
+		try {
+			_FixedUpdate();
+		} catch (...) {
+			InputEngine::EndTick();
+			throw;
+		}
+		InputEngine::EndTick();
+	}
+}
+
 void Application::_Update() {
 	for (const auto& layer : _layers) {
 		if (layer->Enabled && *(layer->Overrides & AppLayerFunctions::OnUpdate)) {
@@ -345,6 +473,9 @@ void Application::_PreRender()
 
 	for (const auto& layer : _layers) {
 		if (layer->Enabled && *(layer->Overrides & AppLayerFunctions::OnPreRender)) {
+			if (!layer->RendersFromSnapshot) {
+				WaitForSimulation();
+			}
 			layer->OnPreRender();
 		}
 	}
@@ -355,6 +486,9 @@ void Application::_RenderScene() {
 	Framebuffer::Sptr result = nullptr;
 	for (const auto& layer : _layers) {
 		if (layer->Enabled && *(layer->Overrides & AppLayerFunctions::OnRender)) {
+			if (!layer->RendersFromSnapshot) {
+				WaitForSimulation();
+			}
 			layer->OnRender(result);
 			Framebuffer::Sptr layerResult = layer->GetRenderOutput(); 
 			result = layerResult != nullptr ? layerResult : result;
@@ -369,6 +503,9 @@ void Application::_PostRender() {
 	for (auto it = _layers.crbegin(); it != _layers.crend(); it++) {
 		const auto& layer = *it;
 		if (layer->Enabled && *(layer->Overrides & AppLayerFunctions::OnPostRender)) {
+			if (!layer->RendersFromSnapshot) {
+				WaitForSimulation();
+			}
 			layer->OnPostRender();
 		}
 	}
@@ -400,6 +537,9 @@ void Application::_HandleSceneChange() {
 	}
 
 	_currentScene = _targetScene;
+
+	// Start the new scene's simulation from a clean slate
+	_frameLoop->Reset();
 	
 	// Let the layers know that we've loaded in a new scene
 	for (const auto& layer : _layers) {
@@ -408,8 +548,19 @@ void Application::_HandleSceneChange() {
 		}
 	}
 
-	// Wake up all game objects in the scene
-	_currentScene->Awake();
+	// Wake up all game objects in the scene, scenes from the background loader are already awake
+	if (!_currentScene->GetIsAwake()) {
+		_currentScene->Awake();
+	}
+
+	// Start streaming in the cells around the camera, if the scene has been split up
+	_worldStreamer->SetScene(_currentScene);
+
+	// Report how much loading was skipped by sharing identical assets
+	ResourceManager::DedupStats dedup = ResourceManager::TakeDedupStats();
+	if (dedup.NumResources > 0) {
+		LOG_INFO("Reused {} duplicate assets, avoiding {:.2f}MB of duplicated data", dedup.NumResources, dedup.NumBytes / (1024.0 * 1024.0));
+	}
 
 	// If we are not in editor mode, scenes play by default
 	if (!_isEditor) {
@@ -468,6 +619,20 @@ nlohmann::json Application::_GetDefaultAppSettings()
 
 	result["window_width"]  = DEFAULT_WINDOW_WIDTH;
 	result["window_height"] = DEFAULT_WINDOW_HEIGHT;
+	result["worker_threads"] = -1;
+	result["tick_rate"] = 60.0f;
+	result["max_ticks_per_frame"] = 5;
+	result["pipelined_simulation"] = false;
+	result["scene_load_budget_ms"] = 4.0f;
+	result["streaming_budget_ms"] = 2.0f;
+	result["streaming_max_concurrent_loads"] = 4;
+	result["verbose_mesh_optimizer"] = false;
+	// Budgets for each resource type in megabytes, 0 means unlimited
+	result["resource_budgets_mb"] = {
+		{ "Texture2D",    0.0f },
+		{ "TextureCube",  0.0f },
+		{ "MeshResource", 0.0f }
+	};
 	return result;
 }
 
@@ -4,6 +4,11 @@
 #include <json.hpp>
 #include "Utils/Macros.h"
 #include "Application/ApplicationLayer.h"
+#include "Application/JobSystem.h"
+#include "Application/FrameGraph.h"
+#include "Application/FrameLoop.h"
+#include "Application/SceneLoader.h"
+#include "Application/WorldStreamer.h"
 #include "Gameplay/Scene.h"
 
 struct GLFWwindow;
@@ -28,6 +33,10 @@ public:
 	} EditorState;
 
 	static Application& Get();
+	/**
+	 * Returns true once the application has been started, tools and tests use the engine without one
+	 */
+	static bool IsStarted() { return _singleton != nullptr; }
 	/**
 	 * Called by the entry point to begin the application, creating the singleton 
 	 * intance and performing any library initialization
@@ -79,12 +88,55 @@ public:
 	 * @param scene The scene to switch to
 	 */
 	void LoadScene(const Gameplay::Scene::Sptr& scene);
+	/**
+	 * Loads a scene from disk over multiple frames, the current scene keeps running until the
+	 * new scene is completely loaded. Only a small amount of time is spent on the load each
+	 * frame (see the "scene_load_budget_ms" setting)
+	 * 
+	 * @param path The path to the scene file to load
+	 * @returns True if the file was found and the load has started, false if otherwise
+	 */
+	bool LoadSceneAsync(const std::string& path);
+	/**
+	 * Returns true while a scene is being loaded by LoadSceneAsync
+	 */
+	bool IsLoadingScene() const { return _sceneLoader != nullptr && _sceneLoader->IsLoading(); }
+	/**
+	 * Gets the progress of the scene being loaded by LoadSceneAsync, from 0 to 1
+	 */
+	float GetSceneLoadProgress() const { return _sceneLoader != nullptr ? _sceneLoader->GetProgress() : 0.0f; }
 
 	/**
 	 * Gets the currently loaded scene that the application is working from
 	 */
 	Gameplay::Scene::Sptr CurrentScene() { return _currentScene == nullptr ? _targetScene : _currentScene; }
 
+	/**
+	 * Gets the application's job system, which can be used to run work across all cores
+	 * of the machine. Only valid while the application is running
+	 */
+	JobSystem& Jobs() { return *_jobs; }
+	/**
+	 * Gets the frame graph, which is used to schedule work for a phase of the frame (update,
+	 * physics, cull, build draw list) on the job system, so that independent work overlaps.
+	 * All of it's work is complete by the end of the frame. Only valid while the application
+	 * is running
+	 */
+	FrameGraph& Frame() { return *_frame; }
+
+	/**
+	 * Gets the world streamer, which loads and unloads the cells of streamed scenes around the
+	 * main camera (see Scene::SaveStreamed). Only valid while the application is running
+	 */
+	WorldStreamer& Streamer() { return *_worldStreamer; }
+
+	/**
+	 * Blocks until any simulation step that is running in parallel with rendering has
+	 * completed. Layers that need to read live scene state while rendering should call this
+	 * first, this is a no-op when the simulation is not pipelined
+	 */
+	void WaitForSimulation();
+
 	/**
 	 * Gets the layer of the given type from the application, or nullptr if it does not exist
 	 * 
@@ -142,9 +194,27 @@ protected:
 
 	Framebuffer::Sptr _renderOutput;
 
+	// Worker threads shared by all systems in the application
+	JobSystem::Uptr _jobs;
+	// Orders the work for each phase of the frame on the above
+	FrameGraph::Uptr _frame;
+
+	// Decides how many fixed updates each frame runs, and runs them alongside rendering when pipelined
+	FrameLoop::Uptr _frameLoop;
+
+	// Handles loading scenes in the background, and the time it may spend on the main thread each frame
+	SceneLoader::Uptr _sceneLoader;
+	float             _sceneLoadBudget;
+
+	// Streams cells of large scenes in and out around the camera, and the time it may spend on the main thread each frame
+	WorldStreamer::Uptr _worldStreamer;
+	float               _streamingBudget;
+
 	void _Run();
 	void _RegisterClasses();
 	void _Load();
+	void _FixedUpdate();
+	void _Simulate(int ticks);
 	void _Update();
 	void _LateUpdate();
 	void _PreRender();
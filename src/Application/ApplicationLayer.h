@@ -24,6 +24,7 @@ ENUM_FLAGS(AppLayerFunctions, uint32_t,
 	OnRender       = 1 << 7,
     OnPostRender   = 1 << 8,
 	OnWindowResize = 1 << 9,
+	OnFixedUpdate  = 1 << 10,
 
 	All = 0xFFFFFFFF
 )
@@ -51,6 +52,12 @@ public:
 	 * Tells the application which functions should be invoked for this layer
 	 */
 	AppLayerFunctions Overrides = AppLayerFunctions::All;
+	/**
+	 * When true, the layer only reads state that it captured during OnLateUpdate when
+	 * rendering (see SnapshotBuffer), so the application does not need to wait for a
+	 * pipelined simulation step to finish before invoking it's render functions
+	 */
+	bool RendersFromSnapshot = false;
 
 	virtual ~ApplicationLayer() = default;
 
@@ -78,6 +85,11 @@ public:
 	 * Invoked when the application updates, at varying time steps (see Timing class)
 	 */
 	virtual void OnUpdate() {};
+	/**
+	 * Invoked at a fixed rate, before OnUpdate. May be invoked zero or more times per frame
+	 * (see Timing::FixedDeltaTime)
+	 */
+	virtual void OnFixedUpdate() {};
 	/**
 	 * Invoked after all layers in an application have been updated
 	 */
@@ -0,0 +1,131 @@
+#include "Application/FrameGraph.h"
+
+#include <algorithm>
+
+FrameGraph::FrameGraph(JobSystem& jobs) :
+	_jobs(jobs),
+	_phases(),
+	_lock()
+{
+	AddDependency(FramePhase::Physics, FramePhase::Update);
+	AddDependency(FramePhase::Cull, FramePhase::Physics);
+	AddDependency(FramePhase::BuildDrawList, FramePhase::Cull);
+}
+
+FrameGraph::~FrameGraph() {
+	// Jobs may reference whoever scheduled them, so they can't be left running
+	try {
+		EndFrame();
+	} catch (...) { }
+}
+
+void FrameGraph::AddDependency(FramePhase phase, FramePhase dependency) {
+	std::lock_guard<std::mutex> lock(_lock);
+	std::vector<FramePhase>& dependencies = _Get(phase).Dependencies;
+	if (phase != dependency && std::find(dependencies.begin(), dependencies.end(), dependency) == dependencies.end()) {
+		dependencies.push_back(dependency);
+	}
+}
+
+void FrameGraph::ClearDependencies(FramePhase phase) {
+	std::lock_guard<std::mutex> lock(_lock);
+	_Get(phase).Dependencies.clear();
+}
+
+bool FrameGraph::DependsOn(FramePhase phase, FramePhase dependency) const {
+	std::lock_guard<std::mutex> lock(_lock);
+	const std::vector<FramePhase>& dependencies = _Get(phase).Dependencies;
+	return std::find(dependencies.begin(), dependencies.end(), dependency) != dependencies.end();
+}
+
+JobSystem::JobHandle FrameGraph::Schedule(FramePhase phase, const JobSystem::JobFunc& task) {
+	std::lock_guard<std::mutex> lock(_lock);
+	JobSystem::JobHandle job = _jobs.Schedule(task, _GetDependencyJobs(phase));
+	_Get(phase).Jobs.push_back(job);
+	return job;
+}
+
+JobSystem::JobHandle FrameGraph::ParallelFor(FramePhase phase, size_t count, size_t grainSize, const JobSystem::RangeFunc& body) {
+	std::lock_guard<std::mutex> lock(_lock);
+	JobSystem::JobHandle job = _jobs.ParallelFor(count, grainSize, body, _GetDependencyJobs(phase));
+	_Get(phase).Jobs.push_back(job);
+	return job;
+}
+
+void FrameGraph::Run(FramePhase phase, const JobSystem::JobFunc& task) {
+	std::vector<JobSystem::JobHandle> dependencies;
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		dependencies = _GetDependencyJobs(phase);
+	}
+	_jobs.WaitAll(dependencies);
+	task();
+}
+
+JobSystem::JobHandle FrameGraph::After(FramePhase phase) {
+	std::lock_guard<std::mutex> lock(_lock);
+	PhaseState& state = _Get(phase);
+	_Compact(state);
+	return state.Jobs.empty() ? nullptr : state.Jobs[0];
+}
+
+void FrameGraph::Wait(FramePhase phase) {
+	std::vector<JobSystem::JobHandle> jobs;
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		jobs = _Get(phase).Jobs;
+	}
+
+	// Once they're done, the jobs we waited on don't need to hold up anyone else, and any
+	// exception they threw has been reported
+	auto forget = [&]() {
+		std::lock_guard<std::mutex> lock(_lock);
+		std::vector<JobSystem::JobHandle>& current = _Get(phase).Jobs;
+		current.erase(std::remove_if(current.begin(), current.end(), [&](const JobSystem::JobHandle& job) {
+			return std::find(jobs.begin(), jobs.end(), job) != jobs.end();
+		}), current.end());
+	};
+	try {
+		_jobs.WaitAll(jobs);
+	} catch (...) {
+		forget();
+		throw;
+	}
+	forget();
+}
+
+void FrameGraph::EndFrame() {
+	std::vector<JobSystem::JobHandle> jobs;
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		for (PhaseState& state : _phases) {
+			jobs.insert(jobs.end(), state.Jobs.begin(), state.Jobs.end());
+			state.Jobs.clear();
+		}
+	}
+	_jobs.WaitAll(jobs);
+}
+
+std::vector<JobSystem::JobHandle> FrameGraph::_GetDependencyJobs(FramePhase phase) {
+	std::vector<JobSystem::JobHandle> result;
+	for (FramePhase dependency : _Get(phase).Dependencies) {
+		PhaseState& state = _Get(dependency);
+		_Compact(state);
+		result.insert(result.end(), state.Jobs.begin(), state.Jobs.end());
+	}
+	return result;
+}
+
+void FrameGraph::_Compact(PhaseState& state) {
+	// Finished jobs can be dropped, unless they failed and still need to be reported
+	state.Jobs.erase(std::remove_if(state.Jobs.begin(), state.Jobs.end(), [](const JobSystem::JobHandle& job) {
+		return JobSystem::IsComplete(job) && !job->Exception;
+	}), state.Jobs.end());
+
+	// A single join keeps phases with lots of small jobs from handing out huge dependency lists
+	if (state.Jobs.size() > 1) {
+		JobSystem::JobHandle join = _jobs.Schedule([]() {}, state.Jobs);
+		state.Jobs.clear();
+		state.Jobs.push_back(join);
+	}
+}
@@ -0,0 +1,124 @@
+#pragma once
+#include <array>
+#include <mutex>
+#include <vector>
+
+#include "Application/JobSystem.h"
+#include "Utils/Macros.h"
+
+/**
+ * The phases that make up a frame, in the order that they are normally run
+ */
+enum class FramePhase {
+	// Component updates, including the fixed simulation ticks
+	Update = 0,
+	// Stepping the physics world
+	Physics,
+	// Working out what is visible and at what level of detail
+	Cull,
+	// Gathering everything that will be drawn into the render layer's snapshot
+	BuildDrawList,
+	Count
+};
+
+/**
+ * The frame graph lets systems hand work for a phase of the frame to the job system without
+ * knowing who else has work in that phase. Each phase declares which phases it depends on,
+ * and work scheduled in a phase will only start once all the work that has been scheduled so
+ * far in those phases has completed. Work in phases that do not depend on each other is free
+ * to overlap
+ *
+ * Phases can be entered more than once per frame (ex: Update and Physics once per fixed tick),
+ * since work only waits on what has already been scheduled, not on everything in the frame
+ */
+class FrameGraph final {
+public:
+	MAKE_PTRS(FrameGraph);
+	NO_COPY(FrameGraph);
+	NO_MOVE(FrameGraph);
+
+	/**
+	 * Creates a frame graph that schedules it's work on the given job system. The phases start
+	 * out with the default dependencies of Update -> Physics -> Cull -> BuildDrawList
+	 */
+	FrameGraph(JobSystem& jobs);
+	~FrameGraph();
+
+	/**
+	 * Declares that work in a phase may not start until all work scheduled so far in another
+	 * phase has completed. Should only be called while no frame is in progress
+	 *
+	 * @param phase The phase that has the dependency
+	 * @param dependency The phase that must complete first
+	 */
+	void AddDependency(FramePhase phase, FramePhase dependency);
+	/**
+	 * Removes all of the dependencies of a phase, so that it's work may start right away
+	 */
+	void ClearDependencies(FramePhase phase);
+	/**
+	 * Returns true if work in phase will wait on work in dependency
+	 */
+	bool DependsOn(FramePhase phase, FramePhase dependency) const;
+
+	/**
+	 * Schedules a job in the given phase of the frame
+	 *
+	 * @param phase The phase that the work belongs to
+	 * @param task The function to invoke on a worker thread
+	 * @returns A handle to the new job
+	 */
+	JobSystem::JobHandle Schedule(FramePhase phase, const JobSystem::JobFunc& task);
+	/**
+	 * Schedules a parallel for in the given phase of the frame, see JobSystem::ParallelFor
+	 *
+	 * @returns A handle that completes once all chunks have completed
+	 */
+	JobSystem::JobHandle ParallelFor(FramePhase phase, size_t count, size_t grainSize, const JobSystem::RangeFunc& body);
+	/**
+	 * Runs work for the given phase on the calling thread, after waiting for the phases that it
+	 * depends on. Used for work that must stay on the thread that is running the frame
+	 */
+	void Run(FramePhase phase, const JobSystem::JobFunc& task);
+
+	/**
+	 * Gets a handle that completes once all work scheduled so far in the given phase has
+	 * completed, for work outside of the graph that needs to wait on a phase
+	 *
+	 * @returns The handle to depend on, or nullptr if the phase has no outstanding work
+	 */
+	JobSystem::JobHandle After(FramePhase phase);
+
+	/**
+	 * Blocks until all work scheduled so far in the given phase has completed
+	 *
+	 * @throws Rethrows the first exception thrown by the phase's jobs
+	 */
+	void Wait(FramePhase phase);
+	/**
+	 * Waits for all work in all phases, and starts a new frame
+	 *
+	 * @throws Rethrows the first exception thrown by any job in the frame
+	 */
+	void EndFrame();
+
+protected:
+	struct PhaseState {
+		// Phases that work in this phase must wait on
+		std::vector<FramePhase>           Dependencies;
+		// Work that has been scheduled in this phase during the current frame
+		std::vector<JobSystem::JobHandle> Jobs;
+	};
+
+	JobSystem& _jobs;
+	std::array<PhaseState, static_cast<size_t>(FramePhase::Count)> _phases;
+	// Guards _phases, since fixed ticks may run on a worker thread when the simulation is pipelined
+	mutable std::mutex _lock;
+
+	PhaseState& _Get(FramePhase phase) { return _phases[static_cast<size_t>(phase)]; }
+	const PhaseState& _Get(FramePhase phase) const { return _phases[static_cast<size_t>(phase)]; }
+	// Gets the outstanding jobs of all the phases that the given phase depends on, _lock must be held
+	std::vector<JobSystem::JobHandle> _GetDependencyJobs(FramePhase phase);
+	// Collapses a phase's finished and outstanding jobs into as few handles as possible, _lock must be held
+	void _Compact(PhaseState& state);
+};
@@ -0,0 +1,80 @@
+#include "Application/FrameLoop.h"
+
+#include <cmath>
+
+FrameLoop::FrameLoop(JobSystem& jobs, FrameGraph& frame) :
+	FixedDeltaTime(1.0f / 60.0f),
+	MaxTicksPerFrame(5),
+	IsPipelined(false),
+	_jobs(jobs),
+	_frame(frame),
+	_tickAccumulator(0.0f),
+	_ticksThisFrame(0),
+	_interpolationAlpha(0.0f),
+	_simulationJob(nullptr)
+{ }
+
+FrameLoop::~FrameLoop() {
+	// The ticks reference whoever gave us the stages, so they can't be left running
+	try {
+		WaitForSimulation();
+	} catch (...) { }
+}
+
+void FrameLoop::RunFrame(float dt, const Stages& stages) {
+	// Work out how many fixed steps we owe, dropping any time we couldn't catch up on
+	_tickAccumulator += dt;
+	_ticksThisFrame = 0;
+	while (_tickAccumulator >= FixedDeltaTime && _ticksThisFrame < MaxTicksPerFrame) {
+		_tickAccumulator -= FixedDeltaTime;
+		_ticksThisFrame++;
+	}
+	if (_tickAccumulator >= FixedDeltaTime) {
+		_tickAccumulator = fmodf(_tickAccumulator, FixedDeltaTime);
+	}
+	_interpolationAlpha = _tickAccumulator / FixedDeltaTime;
+
+	if (stages.BeginTicks) {
+		stages.BeginTicks(_ticksThisFrame);
+	}
+
+	// When pipelined, the ticks are deferred until the render state has been captured below,
+	// so we render one fixed step behind the simulation
+	if (!IsPipelined && stages.Simulate) {
+		stages.Simulate(_ticksThisFrame);
+	}
+
+	if (stages.Capture) {
+		stages.Capture(_interpolationAlpha);
+	}
+
+	// Everything that renders from a snapshot has captured it, so the next frame can be simulated
+	// once the draw list jobs are no longer reading the scene
+	if (IsPipelined && _ticksThisFrame > 0 && stages.Simulate) {
+		int ticks = _ticksThisFrame;
+		_simulationJob = _jobs.Schedule([simulate = stages.Simulate, ticks]() { simulate(ticks); }, { _frame.After(FramePhase::BuildDrawList) });
+	}
+
+	if (stages.Render) {
+		stages.Render();
+	}
+}
+
+void FrameLoop::EndFrame() {
+	// Input and scene changes must not happen under a running simulation
+	WaitForSimulation();
+	_frame.EndFrame();
+}
+
+void FrameLoop::WaitForSimulation() {
+	if (_simulationJob != nullptr) {
+		// Clear the handle first, so a failed tick is only reported once
+		JobSystem::JobHandle job = _simulationJob;
+		_simulationJob = nullptr;
+		_jobs.Wait(job);
+	}
+}
+
+void FrameLoop::Reset() {
+	_tickAccumulator = 0.0f;
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <functional>
+
+#include "Application/JobSystem.h"
+#include "Application/FrameGraph.h"
+#include "Utils/Macros.h"
+
+/**
+ * The frame loop decides how many fixed simulation ticks each frame owes, and runs the stages of
+ * a frame around them in the order the application needs: simulate, capture the state that will
+ * be rendered, then render it
+ *
+ * When pipelined, a frame's ticks are deferred until the capture's draw list has been built, and
+ * then run on the job system while the captured frame renders. Frames are then drawn one fixed
+ * step behind the simulation, but otherwise show exactly what they would have without pipelining
+ *
+ * This is kept apart from the application so that tests can run the same loop without a window
+ */
+class FrameLoop final {
+public:
+	MAKE_PTRS(FrameLoop);
+	NO_COPY(FrameLoop);
+	NO_MOVE(FrameLoop);
+
+	/**
+	 * The work done in each frame, any of these may be left empty
+	 */
+	struct Stages {
+		// Invoked on the calling thread once the number of ticks for the frame is known, before any of them run
+		std::function<void(int ticks)>   BeginTicks;
+		// Runs the given number of fixed ticks, on the job system when pipelined
+		std::function<void(int ticks)>   Simulate;
+		// Captures the state that will be rendered, alpha is how far the frame is between the last two ticks
+		std::function<void(float alpha)> Capture;
+		// Draws the captured state
+		std::function<void()>            Render;
+	};
+
+	/**
+	 * Creates a frame loop that schedules pipelined ticks on the given job system, after the
+	 * BuildDrawList phase of the given frame graph
+	 */
+	FrameLoop(JobSystem& jobs, FrameGraph& frame);
+	~FrameLoop();
+
+	// The length of a single simulation tick, in seconds
+	float FixedDeltaTime;
+	// Maximum number of ticks to run in a single frame, so that a slow frame can't cause a spiral
+	int   MaxTicksPerFrame;
+	// When true, a frame's ticks run on the job system while the frame renders
+	bool  IsPipelined;
+
+	/**
+	 * Runs the stages for a single frame. When pipelined, the ticks may still be running when
+	 * this returns, call EndFrame before touching the simulation again
+	 *
+	 * @param dt The scaled time since the last frame, in seconds
+	 * @param stages The work to do in the frame
+	 */
+	void RunFrame(float dt, const Stages& stages);
+	/**
+	 * Waits for any pipelined ticks, then for all work in the frame graph, and starts a new frame
+	 */
+	void EndFrame();
+
+	/**
+	 * Blocks until any ticks that are running in parallel with rendering have completed, this is
+	 * a no-op when nothing is running
+	 */
+	void WaitForSimulation();
+	/**
+	 * Drops any time that has not been consumed by a tick, ex: when switching scenes
+	 */
+	void Reset();
+
+	/**
+	 * The number of ticks that the last frame ran
+	 */
+	int TicksThisFrame() const { return _ticksThisFrame; }
+	/**
+	 * How far the last frame was between the previous and current ticks, in the 0-1 range
+	 */
+	float InterpolationAlpha() const { return _interpolationAlpha; }
+
+protected:
+	JobSystem&  _jobs;
+	FrameGraph& _frame;
+
+	// Scaled time that has not yet been consumed by a simulation tick
+	float _tickAccumulator;
+	int   _ticksThisFrame;
+	float _interpolationAlpha;
+
+	JobSystem::JobHandle _simulationJob;
+};
@@ -0,0 +1,213 @@
+#include "Application/JobSystem.h"
+
+#include <algorithm>
+
+#include "Logging.h"
+
+// The job system that the current thread is a worker for, and the index of it's queue
+static thread_local const JobSystem* CurrentSystem = nullptr;
+static thread_local size_t CurrentQueueIndex = 0;
+
+JobSystem::JobSystem(int numWorkers) :
+	_workers(std::vector<std::thread>()),
+	_queues(std::vector<std::unique_ptr<WorkQueue>>()),
+	_queuedJobs(0),
+	_isRunning(true)
+{
+	if (numWorkers < 0) {
+		unsigned int hardwareThreads = std::thread::hardware_concurrency();
+		numWorkers = hardwareThreads > 1 ? static_cast<int>(hardwareThreads) - 1 : 0;
+	}
+
+	// Queues need to exist before any worker starts stealing from them
+	for (int ix = 0; ix <= numWorkers; ix++) {
+		_queues.push_back(std::make_unique<WorkQueue>());
+	}
+	for (int ix = 0; ix < numWorkers; ix++) {
+		_workers.emplace_back(&JobSystem::_WorkerMain, this, static_cast<size_t>(ix + 1));
+	}
+
+	LOG_INFO("Started job system with {} worker threads", numWorkers);
+}
+
+JobSystem::~JobSystem() {
+	{
+		std::lock_guard<std::mutex> lock(_sleepLock);
+		_isRunning = false;
+	}
+	_wake.notify_all();
+
+	for (auto& worker : _workers) {
+		worker.join();
+	}
+}
+
+JobSystem::JobHandle JobSystem::Schedule(const JobFunc& task, const std::vector<JobHandle>& dependencies) {
+	JobHandle job = std::make_shared<Job>();
+	job->Task = task;
+
+	for (const JobHandle& dependency : dependencies) {
+		if (dependency == nullptr) {
+			continue;
+		}
+		std::lock_guard<std::mutex> lock(dependency->Lock);
+		if (!dependency->IsDone.load(std::memory_order_acquire)) {
+			job->PendingDependencies++;
+			dependency->Continuations.push_back(job);
+		} else if (dependency->Exception && !job->Exception) {
+			job->Exception = dependency->Exception;
+		}
+	}
+
+	// Release the scheduling guard, if all dependencies are already done we can queue right away
+	if (--job->PendingDependencies == 0) {
+		_Enqueue(job);
+	}
+	return job;
+}
+
+JobSystem::JobHandle JobSystem::Then(const JobHandle& job, const JobFunc& task) {
+	return Schedule(task, { job });
+}
+
+JobSystem::JobHandle JobSystem::ParallelFor(size_t count, size_t grainSize, const RangeFunc& body, const std::vector<JobHandle>& dependencies) {
+	if (grainSize == 0) {
+		grainSize = std::max<size_t>(1, (count + NumThreads() - 1) / NumThreads());
+	}
+
+	std::vector<JobHandle> chunks;
+	chunks.reserve((count + grainSize - 1) / grainSize);
+	for (size_t begin = 0; begin < count; begin += grainSize) {
+		size_t end = std::min(begin + grainSize, count);
+		chunks.push_back(Schedule([body, begin, end]() { body(begin, end); }, dependencies));
+	}
+
+	// Empty job that lets callers wait on or depend on the whole range
+	return Schedule([]() {}, chunks.empty() ? dependencies : chunks);
+}
+
+void JobSystem::Wait(const JobHandle& job) {
+	size_t queueIndex = _CurrentQueue();
+	while (!IsComplete(job)) {
+		// Help out rather than blocking, this also guarantees progress when there are no workers
+		if (!_TryRunOne(queueIndex)) {
+			std::this_thread::yield();
+		}
+	}
+	if (job != nullptr && job->Exception) {
+		std::rethrow_exception(job->Exception);
+	}
+}
+
+void JobSystem::WaitAll(const std::vector<JobHandle>& jobs) {
+	// Wait on everything before throwing, so nothing the caller owns is still in use by a job
+	std::exception_ptr firstException = nullptr;
+	for (const JobHandle& job : jobs) {
+		try {
+			Wait(job);
+		} catch (...) {
+			if (!firstException) {
+				firstException = std::current_exception();
+			}
+		}
+	}
+	if (firstException) {
+		std::rethrow_exception(firstException);
+	}
+}
+
+void JobSystem::_WorkerMain(size_t queueIndex) {
+	CurrentSystem = this;
+	CurrentQueueIndex = queueIndex;
+
+	while (_isRunning) {
+		if (!_TryRunOne(queueIndex)) {
+			std::unique_lock<std::mutex> lock(_sleepLock);
+			_wake.wait(lock, [this]() { return _queuedJobs > 0 || !_isRunning; });
+		}
+	}
+}
+
+void JobSystem::_Enqueue(const JobHandle& job) {
+	{
+		// Incrementing under the sleep lock means a worker can't miss the wake up. This has to
+		// happen before the job is visible, otherwise a thread could pop it and decrement first
+		std::lock_guard<std::mutex> lock(_sleepLock);
+		_queuedJobs++;
+	}
+	WorkQueue& queue = *_queues[_CurrentQueue()];
+	{
+		std::lock_guard<std::mutex> lock(queue.Lock);
+		queue.Jobs.push_back(job);
+	}
+	_wake.notify_one();
+}
+
+bool JobSystem::_TryRunOne(size_t queueIndex) {
+	JobHandle job = nullptr;
+
+	// Our own queue is used as a stack, so that we work on the most recent (and cache-warm) jobs first
+	{
+		WorkQueue& queue = *_queues[queueIndex];
+		std::lock_guard<std::mutex> lock(queue.Lock);
+		if (!queue.Jobs.empty()) {
+			job = queue.Jobs.back();
+			queue.Jobs.pop_back();
+		}
+	}
+
+	// Steal the oldest job from another queue
+	for (size_t ix = 1; job == nullptr && ix < _queues.size(); ix++) {
+		WorkQueue& queue = *_queues[(queueIndex + ix) % _queues.size()];
+		std::unique_lock<std::mutex> lock(queue.Lock, std::try_to_lock);
+		if (lock.owns_lock() && !queue.Jobs.empty()) {
+			job = queue.Jobs.front();
+			queue.Jobs.pop_front();
+		}
+	}
+
+	if (job == nullptr) {
+		return false;
+	}
+
+	_queuedJobs--;
+	_Execute(job);
+	return true;
+}
+
+void JobSystem::_Execute(const JobHandle& job) {
+	// A failed dependency means our inputs are garbage, so we skip the task and pass the failure on
+	if (job->Task && !job->Exception) {
+		try {
+			job->Task();
+		} catch (...) {
+			// Letting this escape a worker would terminate the application, the waiter gets it instead
+			job->Exception = std::current_exception();
+		}
+	}
+
+	std::vector<JobHandle> continuations;
+	{
+		std::lock_guard<std::mutex> lock(job->Lock);
+		job->IsDone.store(true, std::memory_order_release);
+		continuations.swap(job->Continuations);
+	}
+	// Release our captures now, since handles may be kept around long after the job has run
+	job->Task = nullptr;
+
+	for (const JobHandle& continuation : continuations) {
+		if (job->Exception) {
+			std::lock_guard<std::mutex> lock(continuation->Lock);
+			if (!continuation->Exception) {
+				continuation->Exception = job->Exception;
+			}
+		}
+		if (--continuation->PendingDependencies == 0) {
+			_Enqueue(continuation);
+		}
+	}
+}
+
+size_t JobSystem::_CurrentQueue() const {
+	return CurrentSystem == this ? CurrentQueueIndex : 0;
+}
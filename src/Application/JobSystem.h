@@ -0,0 +1,140 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Utils/Macros.h"
+
+/**
+ * The job system is a work-stealing thread pool that is owned by the application. Jobs may
+ * depend on other jobs, in which case they are only queued once all of their dependencies
+ * have completed, allowing independent work to be expressed as a task graph
+ *
+ * Each worker thread has it's own queue, and will steal from the other queues when it runs
+ * out of work. Threads that are not workers (such as the main thread) push to a shared queue,
+ * and will help execute jobs while waiting on a result
+ *
+ * An exception thrown by a job is caught on the thread that ran it, and rethrown to whoever
+ * waits on the job. Jobs that depend on a failed job are skipped and carry the exception
+ * forward, so waiting on the end of a task graph (ex: a ParallelFor) reports any failure in it
+ */
+class JobSystem final {
+public:
+	MAKE_PTRS(JobSystem);
+	NO_COPY(JobSystem);
+	NO_MOVE(JobSystem);
+
+	typedef std::function<void()> JobFunc;
+	typedef std::function<void(size_t begin, size_t end)> RangeFunc;
+
+	/**
+	 * A single unit of work, use the JobHandle returned from the scheduling functions
+	 * to wait on or depend on a job
+	 */
+	struct Job {
+		JobFunc Task;
+		// Number of dependencies that have not completed, plus one while the job is being scheduled
+		std::atomic<int>  PendingDependencies;
+		std::atomic<bool> IsDone;
+		// Jobs that depend on this one, guarded by Lock
+		std::vector<std::shared_ptr<Job>> Continuations;
+		// The exception thrown by this job or by one of it's dependencies, guarded by Lock until IsDone
+		std::exception_ptr Exception;
+		std::mutex        Lock;
+
+		Job() : PendingDependencies(1), IsDone(false) {}
+	};
+	typedef std::shared_ptr<Job> JobHandle;
+
+	/**
+	 * Creates a new job system with the given number of worker threads
+	 *
+	 * @param numWorkers The number of worker threads to spawn, or a negative value to size the
+	 *                   pool to the machine (one less than the number of hardware threads, to
+	 *                   leave room for the main thread)
+	 */
+	JobSystem(int numWorkers = -1);
+	~JobSystem();
+
+	/**
+	 * Schedules a job to run once all of the given dependencies have completed
+	 *
+	 * @param task The function to invoke on a worker thread
+	 * @param dependencies The jobs that must complete before this job may start, null handles are ignored
+	 * @returns A handle to the new job
+	 */
+	JobHandle Schedule(const JobFunc& task, const std::vector<JobHandle>& dependencies = {});
+	/**
+	 * Schedules a continuation that will run after the given job has completed
+	 *
+	 * @param job The job to continue from
+	 * @param task The function to invoke once job has completed
+	 * @returns A handle to the continuation job
+	 */
+	JobHandle Then(const JobHandle& job, const JobFunc& task);
+	/**
+	 * Splits the range [0, count) into chunks of at most grainSize elements, and invokes
+	 * body on each chunk in parallel
+	 *
+	 * @param count The number of elements in the range
+	 * @param grainSize The maximum number of elements to handle in a single job, 0 to split evenly between threads
+	 * @param body The function to invoke for each chunk, with the begin and end index of the chunk
+	 * @param dependencies The jobs that must complete before any chunk may start
+	 * @returns A handle that completes once all chunks have completed
+	 */
+	JobHandle ParallelFor(size_t count, size_t grainSize, const RangeFunc& body, const std::vector<JobHandle>& dependencies = {});
+
+	/**
+	 * Blocks until the given job has completed. The calling thread will execute other jobs while it waits
+	 *
+	 * @throws Rethrows the exception if the job, or any job it depends on, threw one
+	 */
+	void Wait(const JobHandle& job);
+	/**
+	 * Blocks until all of the given jobs have completed
+	 *
+	 * @throws Rethrows the first exception thrown by any of the jobs, after all of them have completed
+	 */
+	void WaitAll(const std::vector<JobHandle>& jobs);
+
+	/**
+	 * Returns true if the job has finished executing, null handles are considered complete
+	 */
+	static bool IsComplete(const JobHandle& job) { return job == nullptr || job->IsDone.load(std::memory_order_acquire); }
+
+	/**
+	 * Gets the number of worker threads in the pool, not including the main thread
+	 */
+	int NumWorkers() const { return static_cast<int>(_workers.size()); }
+	/**
+	 * Gets the number of threads that may be executing jobs at once, including the main thread
+	 */
+	int NumThreads() const { return NumWorkers() + 1; }
+
+protected:
+	struct WorkQueue {
+		std::mutex            Lock;
+		std::deque<JobHandle> Jobs;
+	};
+
+	std::vector<std::thread> _workers;
+	// One queue per worker, plus a shared queue at index 0 for external threads
+	std::vector<std::unique_ptr<WorkQueue>> _queues;
+
+	// Number of jobs that are sitting in a queue, guarded by _sleepLock when incremented
+	std::atomic<size_t>     _queuedJobs;
+	std::mutex              _sleepLock;
+	std::condition_variable _wake;
+	std::atomic<bool>       _isRunning;
+
+	void _WorkerMain(size_t queueIndex);
+	void _Enqueue(const JobHandle& job);
+	bool _TryRunOne(size_t queueIndex);
+	void _Execute(const JobHandle& job);
+	size_t _CurrentQueue() const;
+};
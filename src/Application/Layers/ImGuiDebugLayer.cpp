@@ -15,6 +15,9 @@
 #include "../Windows/DebugWindow.h"
 #include "../Windows/GBufferPreviews.h"
 
+// The size of the cells that the editor splits scenes into when saving a streamed scene, in world units
+static constexpr float StreamingCellSize = 32.0f;
+
 ImGuiDebugLayer::ImGuiDebugLayer() :
 	ApplicationLayer(),
 	_dockInvalid(true)
@@ -163,7 +166,7 @@ void ImGuiDebugLayer::OnRender(const Framebuffer::Sptr& prevLayer)
 				if (ImGui::MenuItem("Load Scene", NULL, false)) {
 					std::optional<std::string> path = FileDialogs::OpenFile("Scene File\0*.json\0\0");
 					if (path.has_value()) {
-						app.LoadScene(path.value());
+						app.LoadSceneAsync(path.value());
 					}
 				}
 
@@ -178,6 +181,17 @@ void ImGuiDebugLayer::OnRender(const Framebuffer::Sptr& prevLayer)
 					}
 				}
 
+				// Save the scene split into cells that are streamed in around the camera
+				if (ImGui::MenuItem("Save Streamed Scene", NULL, false, !app.CurrentScene()->IsStreamed())) {
+					std::optional<std::string> path = FileDialogs::SaveFile("Scene File\0*.json\0\0");
+					if (path.has_value()) {
+						app.CurrentScene()->SaveStreamed(path.value(), StreamingCellSize, StreamingCellSize * 1.5f, StreamingCellSize * 2.0f);
+
+						std::string newFilename = std::filesystem::path(path.value()).stem().string() + "-manifest.json";
+						ResourceManager::SaveManifest(newFilename);
+					}
+				}
+
 				ImGui::EndMenu();
 			}
 
@@ -205,6 +219,16 @@ void ImGuiDebugLayer::OnRender(const Framebuffer::Sptr& prevLayer)
 				ImGui::EndMenu();
 			}
 
+			// Show how far along a background scene load is
+			if (app.IsLoadingScene()) {
+				ImGui::ProgressBar(app.GetSceneLoadProgress(), ImVec2(200.0f, 0.0f), "Loading scene...");
+			}
+
+			// Show how much of a streamed world is resident
+			if (app.Streamer().IsStreaming()) {
+				ImGui::Text("Cells: %d/%d (%d loading)", app.Streamer().NumLoadedCells(), app.Streamer().NumCells(), app.Streamer().NumPendingCells());
+			}
+
 			ImGui::EndMenuBar();
 		}
 		ImGui::End();
@@ -317,6 +341,13 @@ void ImGuiDebugLayer::_RenderGameWindow()
 
 	ImGui::Text("FPS: %.*0f", 3, 1.0f / Timing::Current().DeltaTime());
 
+	// Show how many triangles the levels of detail are saving us
+	RenderLayer::Sptr renderLayer = app.GetLayer<RenderLayer>();
+	if (renderLayer != nullptr) {
+		ImGui::SameLine();
+		ImGui::Text("(%.2f ms) Triangles: %zu / %zu", Timing::Current().DeltaTime() * 1000.0f, renderLayer->GetTrianglesDrawn(), renderLayer->GetFullDetailTriangles());
+	}
+
 	// Determine the relative position of the window
 	ImVec2 subPos = ImGui::GetWindowPos();
 	ImVec2 cursorPos = ImGui::GetCursorPos();
@@ -8,6 +8,8 @@ InstancedRenderingTestLayer::InstancedRenderingTestLayer()
 	: ApplicationLayer()
 {
 	Name = "Instanced Rendering";
+	// Only draws from it's own buffers, which are filled when the scene loads
+	RendersFromSnapshot = true;
 	Overrides = AppLayerFunctions::OnSceneLoad | AppLayerFunctions::OnRender | AppLayerFunctions::OnUpdate;
 }
 
@@ -93,8 +95,8 @@ void InstancedRenderingTestLayer::_UpdateInstances() {
 	for (int ix = 0; ix < _instances.size(); ix++) {
 		// For now just update everything regardless of if it's changed or not
 		// A smarter system would only update if the data is old
-		data[ix].ModelMatrix  = _instances[ix]->GetTransform();
-		data[ix].NormalMatrix = glm::mat3(glm::transpose(glm::inverse(_instances[ix]->GetTransform())));
+		data[ix].ModelMatrix  = _instances[ix]->GetRenderTransform();
+		data[ix].NormalMatrix = glm::mat3(glm::transpose(glm::inverse(_instances[ix]->GetRenderTransform())));
 	}
 
 	// Unmap the buffer so that the GPU can see it again
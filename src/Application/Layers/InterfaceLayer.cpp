@@ -8,12 +8,28 @@ InterfaceLayer::InterfaceLayer() :
 	ApplicationLayer()
 {
 	Name = "Interface";
-	Overrides = AppLayerFunctions::OnRender | AppLayerFunctions::OnWindowResize;
+	RendersFromSnapshot = true;
+	Overrides = AppLayerFunctions::OnLateUpdate | AppLayerFunctions::OnRender | AppLayerFunctions::OnWindowResize;
 }
 
 InterfaceLayer::~InterfaceLayer()
 { }
 
+void InterfaceLayer::OnLateUpdate() {
+	// Gets the application instance
+	Application& app = Application::Get();
+
+	// Our projection matrix will be our entire window for now
+	glm::mat4 proj = glm::ortho(0.0f, (float)app.GetWindowSize().x, (float)app.GetWindowSize().y, 0.0f, -1.0f, 1.0f);
+	GuiBatcher::SetProjection(proj);
+
+	// Walk the GUI objects while the simulation is idle, and keep the geometry to draw in OnRender
+	GuiBatcher::BeginCapture(_drawLists.Back());
+	app.CurrentScene()->RenderGUI();
+	GuiBatcher::EndCapture();
+	_drawLists.Publish();
+}
+
 void InterfaceLayer::OnRender(const Framebuffer::Sptr& prevLayer) {
 	// Gets the application instance
 	Application& app = Application::Get();
@@ -33,15 +49,8 @@ void InterfaceLayer::OnRender(const Framebuffer::Sptr& prevLayer) {
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-	// Our projection matrix will be our entire window for now
-	glm::mat4 proj = glm::ortho(0.0f, (float)app.GetWindowSize().x, (float)app.GetWindowSize().y, 0.0f, -1.0f, 1.0f);
-	GuiBatcher::SetProjection(proj);
-
-	// Iterate over and render all the GUI objects
-	app.CurrentScene()->RenderGUI();
-
-	// Flush the Gui Batch renderer
-	GuiBatcher::Flush();
+	// Draw the GUI objects that were captured in LateUpdate
+	GuiBatcher::Draw(_drawLists.Front());
 
 	// Disable alpha blending
 	glDisable(GL_BLEND);
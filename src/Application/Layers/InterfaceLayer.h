@@ -2,6 +2,8 @@
 #include "../ApplicationLayer.h"
 #include "Graphics/Framebuffer.h"
 #include "Graphics/Buffers/UniformBuffer.h"
+#include "Graphics/GuiBatcher.h"
+#include "../SnapshotBuffer.h"
 
 class InterfaceLayer final : public ApplicationLayer {
 public:
@@ -12,6 +14,11 @@ public:
 		
 	// Inherited from ApplicationLayer
 
+	virtual void OnLateUpdate() override;
 	virtual void OnRender(const Framebuffer::Sptr& prevLayer) override;
 	virtual void OnWindowResize(const glm::ivec2& oldSize, const glm::ivec2& newSize) override;
+
+protected:
+	// The GUI geometry captured in LateUpdate, so we can draw it without reading the scene
+	SnapshotBuffer<GuiBatcher::DrawList> _drawLists;
 };
\ No newline at end of file
@@ -6,18 +6,20 @@ LogicUpdateLayer::LogicUpdateLayer() :
 	ApplicationLayer()
 {
 	Name = "Logic";
-	Overrides = AppLayerFunctions::OnUpdate;
+	Overrides = AppLayerFunctions::OnFixedUpdate;
 }
 
 LogicUpdateLayer::~LogicUpdateLayer() = default;
 
-void LogicUpdateLayer::OnUpdate()
+void LogicUpdateLayer::OnFixedUpdate()
 {
 	Application& app = Application::Get();
+	const Gameplay::Scene::Sptr& scene = app.CurrentScene();
+	float dt = Timing::Current().FixedDeltaTime();
 
 	// Perform updates for all components
-	app.CurrentScene()->Update(Timing::Current().DeltaTime());
+	app.Frame().Run(FramePhase::Update, [&]() { scene->Update(dt, &app.Jobs()); });
 
 	// Update our worlds physics!
-	app.CurrentScene()->DoPhysics(Timing::Current().DeltaTime());
+	app.Frame().Run(FramePhase::Physics, [&]() { scene->DoPhysics(dt); });
 }
@@ -10,7 +10,7 @@ public:
 
 	// Inherited from ApplicationLayer
 
-	virtual void OnUpdate() override;
+	virtual void OnFixedUpdate() override;
 
 protected:
 
@@ -6,7 +6,8 @@ ParticleLayer::ParticleLayer() :
 	ApplicationLayer()
 {
 	Name = "Particles";
-	Overrides = AppLayerFunctions::OnUpdate | AppLayerFunctions::OnRender;
+	RendersFromSnapshot = true;
+	Overrides = AppLayerFunctions::OnUpdate | AppLayerFunctions::OnLateUpdate | AppLayerFunctions::OnRender;
 }
 
 ParticleLayer::~ParticleLayer()
@@ -27,11 +28,23 @@ void ParticleLayer::OnUpdate()
 	}
 }
 
-void ParticleLayer::OnRender(const Framebuffer::Sptr& prevLayer)
+void ParticleLayer::OnLateUpdate()
 {
-	Application::Get().CurrentScene()->Components().Each<ParticleSystem>([](const ParticleSystem::Sptr& system) {
+	// The particle buffers are only touched by OnUpdate on this thread, so all we need to capture
+	// is which systems to draw
+	std::vector<ParticleSystem::Sptr>& systems = _systems.Back();
+	systems.clear();
+	Application::Get().CurrentScene()->Components().Each<ParticleSystem>([&](const ParticleSystem::Sptr& system) {
 		if (system->IsEnabled) {
-			system->Render();
+			systems.push_back(system);
 		}
 	});
+	_systems.Publish();
+}
+
+void ParticleLayer::OnRender(const Framebuffer::Sptr& prevLayer)
+{
+	for (const ParticleSystem::Sptr& system : _systems.Front()) {
+		system->Render();
+	}
 }
@@ -1,5 +1,8 @@
 #pragma once
 #include "../ApplicationLayer.h"
+#include "../SnapshotBuffer.h"
+
+class ParticleSystem;
 
 
 class ParticleLayer : public ApplicationLayer {
@@ -9,6 +12,12 @@ public:
 	virtual ~ParticleLayer();
 
 	void OnUpdate() override;
+	void OnLateUpdate() override;
 	void OnRender(const Framebuffer::Sptr& prevLayer) override;
 
+protected:
+	// The enabled particle systems captured in LateUpdate, so that rendering doesn't walk the scene's
+	// component lists while the simulation may be changing them
+	SnapshotBuffer<std::vector<std::shared_ptr<ParticleSystem>>> _systems;
+
 };
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include "Gameplay/Components/ComponentManager.h"
 #include "Gameplay/Components/RenderComponent.h"
 #include "Gameplay/Components/Light.h"
+#include "Utils/JsonGlmHelpers.h"
 
 // GLM math library
 #include <GLM/glm.hpp>
@@ -24,23 +25,151 @@ RenderLayer::RenderLayer() :
 	_frameUniforms(nullptr),
 	_instanceUniforms(nullptr),
 	_renderFlags(RenderFlags::EnableColorCorrection),
-	_clearColor({ 0.1f, 0.1f, 0.1f, 1.0f })
+	_clearColor({ 0.1f, 0.1f, 0.1f, 1.0f }),
+	_lodEnabled(true),
+	_lodPixelError(1.0f),
+	_lodHysteresis(0.75f),
+	_snapshots()
 {
 	Name = "Rendering";
+	RendersFromSnapshot = true;
 	Overrides = 
-		AppLayerFunctions::OnAppLoad | 
+		AppLayerFunctions::OnAppLoad | AppLayerFunctions::OnLateUpdate |
 		AppLayerFunctions::OnPreRender | AppLayerFunctions::OnRender | AppLayerFunctions::OnPostRender | 
 		AppLayerFunctions::OnWindowResize;
 }
 
 RenderLayer::~RenderLayer() = default;
 
+void RenderLayer::OnLateUpdate()
+{
+	using namespace Gameplay;
+
+	Application& app = Application::Get();
+	const Scene::Sptr& scene = app.CurrentScene();
+
+	// We capture into the back snapshot, the front one is untouched until OnPreRender publishes this one
+	FrameSnapshot& snapshot = _snapshots.Back();
+	snapshot.IsValid = scene->MainCamera != nullptr;
+	snapshot.DrawCalls.clear();
+	snapshot.Lights.clear();
+	snapshot.TrianglesDrawn = 0;
+	snapshot.FullDetailTriangles = 0;
+	if (!snapshot.IsValid) {
+		return;
+	}
+
+	Camera::Sptr camera = scene->MainCamera;
+	snapshot.View = camera->GetRenderView();
+	snapshot.Projection = camera->GetProjection();
+	snapshot.ViewProjection = snapshot.Projection * snapshot.View;
+	snapshot.CameraPosition = camera->GetGameObject()->GetRenderTransform()[3];
+	snapshot.AmbientLight = scene->GetAmbientLight();
+	snapshot.SkyboxRotation = scene->GetSkyboxRotation();
+	snapshot.Environment = scene->GetSkyboxTexture();
+	snapshot.ColorLUT = scene->GetColorLUT();
+	snapshot.DrawPhysicsDebug = scene->GetPhysicsDebugDrawMode() != BulletDebugMode::None;
+
+	// Converts a size relative to the camera's distance into pixels, for picking levels of detail
+	bool isOrtho = camera->GetOrthoEnabled();
+	float pixelScale = snapshot.Projection[1][1] * app.GetPrimaryViewport().w * 0.5f;
+
+	// Grab everything up front, so the jobs below never touch the scene's component lists
+	_cullList.clear();
+	scene->Components().Each<RenderComponent>([&](const RenderComponent::Sptr& renderable) {
+		_cullList.push_back(renderable);
+	});
+	_cullLods.resize(_cullList.size());
+
+	FrameGraph& frame = app.Frame();
+	Material::Sptr defaultMat = scene->DefaultMaterial;
+	frame.ParallelFor(FramePhase::Cull, _cullList.size(), 64, [this, defaultMat, cameraPos = snapshot.CameraPosition, isOrtho, pixelScale](size_t begin, size_t end) {
+		for (size_t ix = begin; ix < end; ix++) {
+			_cullLods[ix] = _CullRenderable(_cullList[ix], defaultMat, cameraPos, isOrtho, pixelScale);
+		}
+	});
+
+	// Gathered in order, so the draw calls come out the same no matter how the culling was split up
+	frame.Schedule(FramePhase::BuildDrawList, [this, &snapshot]() {
+		for (size_t ix = 0; ix < _cullList.size(); ix++) {
+			if (_cullLods[ix] >= 0) {
+				_AppendDrawCalls(snapshot, _cullList[ix], _cullLods[ix]);
+			}
+		}
+		// Let go of the components, in case the scene is unloaded before we cull again
+		_cullList.clear();
+	});
+
+	scene->Components().Each<Light>([&](const Light::Sptr& light) {
+		snapshot.Lights.push_back({ 
+			glm::vec3(light->GetGameObject()->GetRenderTransform()[3]), 
+			light->GetColor(), 
+			light->GetIntensity(), 
+			light->GetRadius() 
+		});
+	});
+}
+
+int RenderLayer::_CullRenderable(const Gameplay::RenderComponent::Sptr& renderable, const Gameplay::Material::Sptr& defaultMat, 
+	const glm::vec3& cameraPos, bool isOrtho, float pixelScale)
+{
+	// Early bail if mesh not set
+	if (renderable->GetMesh() == nullptr) {
+		return -1;
+	}
+
+	// If we don't have a material, try getting the scene's fallback material
+	// If none exists, do not draw anything
+	if (renderable->GetMaterial() == nullptr) {
+		if (defaultMat != nullptr) {   
+			renderable->SetMaterial(defaultMat); 
+		} else {
+			return -1;
+		}
+	}
+
+	// Swap in a simplified mesh if the object is small enough on screen that nobody would notice
+	const VertexArrayObject::Sptr& mesh = renderable->GetMesh();
+	const glm::mat4& model = renderable->GetGameObject()->GetRenderTransform();
+	int lodLevel = _lodEnabled ? SelectLod(mesh, model, renderable->GetLodLevel(), cameraPos, isOrtho, pixelScale, _lodPixelError, _lodHysteresis) : 0;
+	renderable->SetLodLevel(lodLevel);
+	return lodLevel;
+}
+
+void RenderLayer::_AppendDrawCalls(FrameSnapshot& snapshot, const Gameplay::RenderComponent::Sptr& renderable, int lodLevel)
+{
+	VertexArrayObject::Sptr mesh = renderable->GetMesh();
+	const glm::mat4& model = renderable->GetGameObject()->GetRenderTransform();
+	snapshot.FullDetailTriangles += mesh->GetElementCount() / 3;
+	if (lodLevel > 0) {
+		mesh = mesh->GetLods()[lodLevel - 1].Mesh;
+	}
+	snapshot.TrianglesDrawn += mesh->GetElementCount() / 3;
+
+	// Meshes with several materials get a draw call per submesh, which are kept together so
+	// that they can all be drawn from the same buffers
+	const std::vector<Submesh>& submeshes = mesh->GetSubmeshes();
+	if (submeshes.empty()) {
+		snapshot.DrawCalls.push_back({ mesh, renderable->GetMaterial(), model, 0, mesh->GetElementCount() });
+	} else {
+		for (const Submesh& submesh : submeshes) {
+			snapshot.DrawCalls.push_back({ mesh, renderable->GetMaterial(submesh.MaterialSlot), model, submesh.FirstIndex, submesh.IndexCount });
+		}
+	}
+}
+
 void RenderLayer::OnPreRender()
 {
 	using namespace Gameplay;
 
 	Application& app = Application::Get();
 
+	// The draw list is built on the job system while the rest of LateUpdate runs, once it's done the
+	// captured snapshot becomes the one we draw
+	app.Frame().Wait(FramePhase::BuildDrawList);
+	_snapshots.Publish();
+	const FrameSnapshot& snapshot = _snapshots.Front();
+
 	// Clear the color and depth buffers
 	const glm::vec4 colors[4] = {
 		glm::vec4(0.0f),
@@ -53,13 +182,11 @@ void RenderLayer::OnPreRender()
 	// Clear the framebuffer. Note that this also binds and sets the viewport
 	_ClearFramebuffer(_primaryFBO, colors, 4);
 
-	
-	// Grab shorthands to the camera and shader from the scene
-	Camera::Sptr camera = app.CurrentScene()->MainCamera;
+	if (!snapshot.IsValid) {
+		return;
+	}
 
-	// Cache the camera's viewprojection
-	glm::mat4 viewProj = camera->GetViewProjection();
-	DebugDrawer::Get().SetViewProjection(viewProj);
+	DebugDrawer::Get().SetViewProjection(snapshot.ViewProjection);
 
 	// The current material that is bound for rendering
 	Material::Sptr currentMat = nullptr;
@@ -67,15 +194,13 @@ void RenderLayer::OnPreRender()
 
 	// Bind the skybox texture to a reserved texture slot
 	// See Material.h and Material.cpp for how we're reserving texture slots
-	TextureCube::Sptr environment = app.CurrentScene()->GetSkyboxTexture();
-	if (environment) {
-		environment->Bind(15);
+	if (snapshot.Environment) {
+		snapshot.Environment->Bind(15);
 	}
 
 	// Binding the color correction LUT
-	Texture3D::Sptr colorLUT = app.CurrentScene()->GetColorLUT();
-	if (colorLUT) {
-		colorLUT->Bind(14);
+	if (snapshot.ColorLUT) {
+		snapshot.ColorLUT->Bind(14);
 	}
 
 	// Here we'll bind all the UBOs to their corresponding slots
@@ -83,15 +208,18 @@ void RenderLayer::OnPreRender()
 	_instanceUniforms->Bind(INSTANCE_UBO_BINDING);
 	_lightingUbo->Bind(LIGHTING_UBO_BINDING);
 
-	// Draw physics debug
-	app.CurrentScene()->DrawPhysicsDebug();
+	// Draw physics debug, the physics world is not part of the snapshot so we need the simulation to be idle
+	if (snapshot.DrawPhysicsDebug) {
+		app.WaitForSimulation();
+		app.CurrentScene()->DrawPhysicsDebug();
+	}
 
 	// Upload frame level uniforms
 	auto& frameData = _frameUniforms->GetData();
-	frameData.u_Projection = camera->GetProjection();
-	frameData.u_View = camera->GetView();
-	frameData.u_ViewProjection = camera->GetViewProjection();
-	frameData.u_CameraPos = glm::vec4(camera->GetGameObject()->GetPosition(), 1.0f);
+	frameData.u_Projection = snapshot.Projection;
+	frameData.u_View = snapshot.View;
+	frameData.u_ViewProjection = snapshot.ViewProjection;
+	frameData.u_CameraPos = glm::vec4(snapshot.CameraPosition, 1.0f);
 	frameData.u_Time = static_cast<float>(Timing::Current().TimeSinceSceneLoad());
 	frameData.u_DeltaTime = Timing::Current().DeltaTime();
 	frameData.u_RenderFlags = _renderFlags;
@@ -101,24 +229,19 @@ void RenderLayer::OnPreRender()
 void RenderLayer::OnRender(const Framebuffer::Sptr& prevLayer)
 {
 	using namespace Gameplay;
+	const FrameSnapshot& snapshot = _snapshots.Front();
 
-	Application& app = Application::Get();
-
-
-	// Grab shorthands to the camera and shader from the scene
-	Camera::Sptr camera = app.CurrentScene()->MainCamera;
-
-	glm::mat4 view = camera->GetView();
+	if (!snapshot.IsValid) {
+		return;
+	}
 
-	// Cache the camera's viewprojection
-	glm::mat4 viewProj = camera->GetViewProjection(); 
+	const glm::mat4& view = snapshot.View;
+	const glm::mat4& viewProj = snapshot.ViewProjection;
 
 	// The current material that is bound for rendering
 	Material::Sptr currentMat = nullptr;
 	ShaderProgram::Sptr shader = nullptr;
 
-	Material::Sptr defaultMat = app.CurrentScene()->DefaultMaterial;
-
 	// Make sure depth testing and culling are re-enabled
 	glEnable(GL_DEPTH_TEST);
 	glEnable(GL_CULL_FACE); 
@@ -127,47 +250,51 @@ void RenderLayer::OnRender(const Framebuffer::Sptr& prevLayer)
 	// Disable blending, we want to override any existing colors
 	glDisable(GL_BLEND);
 
-	// Render all our objects
-	app.CurrentScene()->Components().Each<RenderComponent>([&](const RenderComponent::Sptr& renderable) {
-		// Early bail if mesh not set
-		if (renderable->GetMesh() == nullptr) {
-			return;
-		}
-
-		// If we don't have a material, try getting the scene's fallback material
-		// If none exists, do not draw anything
-		if (renderable->GetMaterial() == nullptr) {
-			if (defaultMat != nullptr) {   
-				renderable->SetMaterial(defaultMat); 
-			} else {
-				return;
-			}
-		}
+	// The mesh and transform of the last draw, so submeshes of the same object don't rebind the
+	// VAO or re-upload the instance uniforms
+	VertexArrayObject::Sptr currentMesh = nullptr;
+	const glm::mat4* currentModel = nullptr;
 
+	// Render all our objects
+	for (const auto& drawCall : snapshot.DrawCalls) {
 		// If the material has changed, we need to bind the new shader and set up our material and frame data
 		// Note: This is a good reason why we should be sorting the render components in ComponentManager
-		if (renderable->GetMaterial() != currentMat) {
-			currentMat = renderable->GetMaterial();
+		if (drawCall.Material != currentMat) {
+			currentMat = drawCall.Material;
 			shader = currentMat->GetShader();
 
 			shader->Bind();
 			currentMat->Apply();
 		}
 
-		// Grab the game object so we can do some stuff with it
-		GameObject* object = renderable->GetGameObject();
-
-		// Use our uniform buffer for our instance level uniforms
-		auto& instanceData = _instanceUniforms->GetData();
-		instanceData.u_Model = object->GetTransform();
-		instanceData.u_ModelViewProjection = viewProj * object->GetTransform();
-		instanceData.u_ModelView = view * object->GetTransform();
-		instanceData.u_NormalMatrix = glm::mat3(glm::transpose(glm::inverse(object->GetTransform())));
-		_instanceUniforms->Update();
+		// Use our uniform buffer for our instance level uniforms, these include how to decode the mesh's vertices
+		if (currentModel == nullptr || *currentModel != drawCall.Model || drawCall.Mesh != currentMesh) {
+			currentModel = &drawCall.Model;
+
+			auto& instanceData = _instanceUniforms->GetData();
+			const glm::mat4& model = drawCall.Model;
+			instanceData.u_Model = model;
+			instanceData.u_ModelViewProjection = viewProj * model;
+			instanceData.u_ModelView = view * model;
+			instanceData.u_NormalMatrix = glm::mat3(glm::transpose(glm::inverse(model)));
+			instanceData.u_VertexEncoding = drawCall.Mesh->GetVertexEncoding();
+			if (instanceData.u_VertexEncoding != VertexEncoding::Float) {
+				instanceData.u_PositionScale = glm::vec4(drawCall.Mesh->GetBoundsMax() - drawCall.Mesh->GetBoundsMin(), 0.0f);
+				instanceData.u_PositionOffset = glm::vec4(drawCall.Mesh->GetBoundsMin(), 0.0f);
+			} else {
+				instanceData.u_PositionScale = glm::vec4(1.0f, 1.0f, 1.0f, 0.0f);
+				instanceData.u_PositionOffset = glm::vec4(0.0f);
+			}
+			_instanceUniforms->Update();
+		}
 
-		// Draw the object
-		renderable->GetMesh()->Draw();
-	});
+		// Draw the object, only binding it's VAO if the last draw was from a different mesh
+		if (drawCall.Mesh != currentMesh) {
+			currentMesh = drawCall.Mesh;
+			currentMesh->Bind();
+		}
+		currentMesh->DrawRange(drawCall.FirstElement, drawCall.ElementCount);
+	}
 
 
 
@@ -211,16 +338,14 @@ void RenderLayer::OnPostRender() {
 void RenderLayer::_AccumulateLighting()
 {
 	using namespace Gameplay;
-
-	Application& app = Application::Get();
-	Scene::Sptr& scene = app.CurrentScene();
+	const FrameSnapshot& snapshot = _snapshots.Front();
 
 	// Update our lighting UBO for any shaders that need it
 	LightingUboStruct& data = _lightingUbo->GetData();
-	data.AmbientCol = scene->GetAmbientLight();
-	data.EnvironmentRotation = scene->GetSkyboxRotation() * glm::inverse(glm::mat3(scene->MainCamera->GetView()));
+	data.AmbientCol = snapshot.AmbientLight;
+	data.EnvironmentRotation = snapshot.SkyboxRotation * glm::inverse(glm::mat3(snapshot.View));
 
-	const glm::vec3& ambient = scene->GetAmbientLight();
+	const glm::vec3& ambient = snapshot.AmbientLight;
 	const glm::vec4 colors[2] = {
 		{ ambient, 1.0f },         // diffuse (multiplicative)
 		{ 0.0f, 0.0f, 0.0f, 1.0f } // specular (additive)
@@ -240,21 +365,20 @@ void RenderLayer::_AccumulateLighting()
 	_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color2)->Bind(3); // emissive
 	_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color3)->Bind(4); // view pos
 
-	const glm::mat4& view = scene->MainCamera->GetView();
+	const glm::mat4& view = snapshot.View;
 
 	// Send in how many active lights we have and the global lighting settings
 	data.AmbientCol = glm::vec3(0.1f);
 	int ix = 0;
-	app.CurrentScene()->Components().Each<Light>([&](const Light::Sptr& light) {
+	for (const auto& light : snapshot.Lights) {
 		// Get the light's position in view space, since we're doing view space lighting
-		glm::vec4 pos = glm::vec4(light->GetGameObject()->GetWorldPosition(), 1.0f);
-		pos = view * pos;
+		glm::vec4 pos = view * glm::vec4(light.Position, 1.0f);
 
 		// Copy to the ubo data
 		data.Lights[ix].Position = (glm::vec3)(pos) / pos.w;
-		data.Lights[ix].Intensity = light->GetIntensity();
-		data.Lights[ix].Color = light->GetColor();
-		data.Lights[ix].Attenuation = 1.0f / (1.0f + light->GetRadius());  
+		data.Lights[ix].Intensity = light.Intensity;
+		data.Lights[ix].Color = light.Color;
+		data.Lights[ix].Attenuation = 1.0f / (1.0f + light.Radius);  
 
 		ix++;
 
@@ -270,7 +394,7 @@ void RenderLayer::_AccumulateLighting()
 
 			ix = 0;
 		}
-	});
+	}
 
 	// If we have lights left over that haven't been drawn, draw them now
 	if (ix > 0) {
@@ -290,6 +414,7 @@ void RenderLayer::_AccumulateLighting()
 void RenderLayer::_Composite()
 {
 	using namespace Gameplay;
+	const FrameSnapshot& snapshot = _snapshots.Front();
 	Application& app = Application::Get();
 
 	Scene::Sptr& scene = app.CurrentScene();
@@ -329,7 +454,7 @@ void RenderLayer::_Composite()
 	);
 
 	// Use our cubemap to draw our skybox
-	scene->DrawSkybox();
+	scene->DrawSkybox(snapshot.Projection, snapshot.View);
 
 	_outputBuffer->Unbind();
 }
@@ -358,6 +483,41 @@ void RenderLayer::_ClearFramebuffer(Framebuffer::Sptr& buffer, const glm::vec4*
 	glDepthFunc(GL_LESS);
 }
 
+int RenderLayer::SelectLod(const VertexArrayObject::Sptr& mesh, const glm::mat4& model, int currentLevel, const glm::vec3& cameraPos,
+						   bool isOrtho, float pixelScale, float pixelError, float hysteresis)
+{
+	const std::vector<VertexArrayObject::Lod>& lods = mesh->GetLods();
+	if (lods.empty() || !mesh->HasBounds()) {
+		return 0;
+	}
+
+	// Work out how many pixels the mesh's bounding radius covers, the LOD errors are relative to it
+	glm::vec3 center = (mesh->GetBoundsMin() + mesh->GetBoundsMax()) * 0.5f;
+	float radius = glm::length(mesh->GetBoundsMax() - mesh->GetBoundsMin()) * 0.5f;
+	float scale = glm::max(glm::length(glm::vec3(model[0])), glm::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+	float screenRadius = radius * scale * pixelScale;
+	if (!isOrtho) {
+		float distance = glm::length(glm::vec3(model * glm::vec4(center, 1.0f)) - cameraPos);
+		// If the camera is inside the bounds, we need all the detail we can get
+		if (distance <= radius * scale) {
+			return 0;
+		}
+		screenRadius /= distance;
+	}
+
+	// Pick the coarsest level that is still within the error threshold. Levels coarser than the one
+	// we're using now need to be under the threshold by a margin, so we don't keep switching back and forth
+	int result = 0;
+	for (int ix = 0; ix < static_cast<int>(lods.size()); ix++) {
+		float threshold = ix + 1 > currentLevel ? pixelError * hysteresis : pixelError;
+		if (lods[ix].Error * screenRadius > threshold) {
+			break;
+		}
+		result = ix + 1;
+	}
+	return result;
+}
+
 void RenderLayer::OnWindowResize(const glm::ivec2& oldSize, const glm::ivec2& newSize)
 {
 	if (newSize.x * newSize.y == 0) return;
@@ -376,6 +536,13 @@ void RenderLayer::OnAppLoad(const nlohmann::json& config)
 {
 	Application& app = Application::Get();
 
+	if (config.contains(Name) && config[Name].is_object()) {
+		const nlohmann::json& settings = config[Name];
+		_lodEnabled = JsonGet(settings, "lod_enabled", _lodEnabled);
+		_lodPixelError = glm::max(JsonGet(settings, "lod_pixel_error", _lodPixelError), 0.0f);
+		_lodHysteresis = glm::clamp(JsonGet(settings, "lod_hysteresis", _lodHysteresis), 0.0f, 1.0f);
+	}
+
 	// GL states, we'll enable depth testing and backface fulling
 	glEnable(GL_DEPTH_TEST);
 	glEnable(GL_CULL_FACE);
@@ -486,3 +653,35 @@ const Framebuffer::Sptr& RenderLayer::GetLightingBuffer() const {
 	return _lightingFBO;
 }
 
+bool RenderLayer::IsLodEnabled() const {
+	return _lodEnabled;
+}
+
+void RenderLayer::SetLodEnabled(bool value) {
+	_lodEnabled = value;
+}
+
+float RenderLayer::GetLodPixelError() const {
+	return _lodPixelError;
+}
+
+void RenderLayer::SetLodPixelError(float value) {
+	_lodPixelError = glm::max(value, 0.0f);
+}
+
+size_t RenderLayer::GetTrianglesDrawn() const {
+	return _snapshots.Front().TrianglesDrawn;
+}
+
+size_t RenderLayer::GetFullDetailTriangles() const {
+	return _snapshots.Front().FullDetailTriangles;
+}
+
+nlohmann::json RenderLayer::GetDefaultConfig() {
+	return {
+		{ "lod_enabled", true },
+		{ "lod_pixel_error", 1.0f },
+		{ "lod_hysteresis", 0.75f }
+	};
+}
+
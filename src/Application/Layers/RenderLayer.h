@@ -1,12 +1,18 @@
 #pragma once
 #include "../ApplicationLayer.h"
+#include "../SnapshotBuffer.h"
 #include "Graphics/Framebuffer.h"
 #include "Graphics/Buffers/UniformBuffer.h"
 #include "Graphics/ShaderProgram.h"
 #include "Graphics/VertexArrayObject.h"
+#include "Graphics/Textures/TextureCube.h"
+#include "Graphics/Textures/Texture3D.h"
+#include "Gameplay/Material.h"
 
 #define MAX_LIGHTS 8
 
+namespace Gameplay { class RenderComponent; }
+
 ENUM_FLAGS(RenderFlags, uint32_t,
 	None = 0,
 	EnableColorCorrection = 1 << 0
@@ -48,6 +54,11 @@ public:
 		glm::mat4 u_ModelView;
 		// Normal Matrix for transforming normals
 		glm::mat4 u_NormalMatrix;
+		// Converts compressed positions back to model space (position * scale + offset), see VertexCompression
+		glm::vec4 u_PositionScale;
+		glm::vec4 u_PositionOffset;
+		// How the mesh's vertices are encoded
+		VertexEncoding u_VertexEncoding;
 	};
 
 	/// <summary>
@@ -76,6 +87,48 @@ public:
 		glm::mat4 EnvironmentRotation;
 	};
 
+	/// <summary>
+	/// Everything the render layer needs from the scene to draw a frame. This is captured
+	/// during LateUpdate while the simulation is idle, so that when pipelining is enabled
+	/// the next frame can be simulated while this one is being drawn
+	///
+	/// The draw calls are filled in by jobs in the Cull and BuildDrawList phases of the frame
+	/// graph, and the snapshot is only published for drawing once OnPreRender has waited on
+	/// BuildDrawList
+	/// </summary>
+	struct FrameSnapshot {
+		// Draws a range of the mesh's elements, there is one per submesh
+		struct DrawCall {
+			VertexArrayObject::Sptr  Mesh;
+			Gameplay::Material::Sptr Material;
+			glm::mat4                Model;
+			uint32_t                 FirstElement;
+			uint32_t                 ElementCount;
+		};
+		struct LightInfo {
+			glm::vec3 Position;
+			glm::vec3 Color;
+			float     Intensity;
+			float     Radius;
+		};
+
+		bool      IsValid = false;
+		glm::mat4 View;
+		glm::mat4 Projection;
+		glm::mat4 ViewProjection;
+		glm::vec3 CameraPosition;
+		glm::vec3 AmbientLight;
+		glm::mat3 SkyboxRotation;
+		TextureCube::Sptr Environment;
+		Texture3D::Sptr   ColorLUT;
+		bool      DrawPhysicsDebug = false;
+		size_t    TrianglesDrawn = 0;
+		size_t    FullDetailTriangles = 0;
+
+		std::vector<DrawCall>  DrawCalls;
+		std::vector<LightInfo> Lights;
+	};
+
 	RenderLayer();
 	virtual ~RenderLayer();
 
@@ -95,14 +148,50 @@ public:
 
 	const Framebuffer::Sptr& GetLightingBuffer() const;
 
+	/// <summary>
+	/// Gets whether objects are drawn with simplified levels of detail when they are small on screen
+	/// </summary>
+	bool IsLodEnabled() const;
+	/// <summary>
+	/// Sets whether objects are drawn with simplified levels of detail when they are small on screen
+	/// </summary>
+	void SetLodEnabled(bool value);
+	/// <summary>
+	/// Gets how far, in pixels, a level of detail may move the surface before we use a more detailed one
+	/// </summary>
+	float GetLodPixelError() const;
+	/// <summary>
+	/// Sets how far, in pixels, a level of detail may move the surface before we use a more detailed one
+	/// </summary>
+	void SetLodPixelError(float value);
+
+	/// <summary>
+	/// Picks the coarsest level of detail of a mesh whose error stays under pixelError on screen, where
+	/// 0 is the full detail mesh. Levels coarser than currentLevel must be under pixelError * hysteresis
+	/// </summary>
+	/// <param name="pixelScale">Pixels covered by one unit at a distance of one unit (or by one unit for orthographic cameras)</param>
+	static int SelectLod(const VertexArrayObject::Sptr& mesh, const glm::mat4& model, int currentLevel, const glm::vec3& cameraPos,
+						 bool isOrtho, float pixelScale, float pixelError, float hysteresis);
+
+	/// <summary>
+	/// Gets the number of triangles in the draw calls of the frame being drawn
+	/// </summary>
+	size_t GetTrianglesDrawn() const;
+	/// <summary>
+	/// Gets the number of triangles the frame would have drawn if every object used it's full detail mesh
+	/// </summary>
+	size_t GetFullDetailTriangles() const;
+
 	// Inherited from ApplicationLayer
 
 	virtual void OnAppLoad(const nlohmann::json& config) override;
+	virtual void OnLateUpdate() override;
 	virtual void OnPreRender() override;
 	virtual void OnRender(const Framebuffer::Sptr& prevLayer) override;
 	virtual void OnPostRender() override;
 	virtual void OnWindowResize(const glm::ivec2& oldSize, const glm::ivec2& newSize) override;
 	virtual Framebuffer::Sptr GetRenderOutput() override;
+	virtual nlohmann::json GetDefaultConfig() override;
 
 protected:
 	Framebuffer::Sptr   _primaryFBO;
@@ -117,6 +206,19 @@ protected:
 	glm::vec4         _clearColor;
 	RenderFlags       _renderFlags;
 
+	bool              _lodEnabled;
+	// The most pixels that a level of detail can move the surface by on screen
+	float             _lodPixelError;
+	// A level of detail only gets coarser once it's error is below this fraction of the
+	// threshold, so objects near the threshold don't flicker between levels
+	float             _lodHysteresis;
+
+	// The scene state for the frame being drawn (front), and the one being captured (back)
+	SnapshotBuffer<FrameSnapshot> _snapshots;
+	// The renderables being culled this frame, and the level of detail picked for each (or -1 to skip it)
+	std::vector<std::shared_ptr<Gameplay::RenderComponent>> _cullList;
+	std::vector<int>  _cullLods;
+
 	const int FRAME_UBO_BINDING = 0;
 	UniformBuffer<FrameLevelUniforms>::Sptr _frameUniforms;
 
@@ -126,6 +228,17 @@ protected:
 	const int LIGHTING_UBO_BINDING = 2;
 	UniformBuffer<LightingUboStruct>::Sptr _lightingUbo;
 
+	/// <summary>
+	/// Picks the level of detail to draw a renderable at, or -1 if it should not be drawn
+	/// this frame. Safe to call for different renderables from several threads at once
+	/// </summary>
+	int _CullRenderable(const std::shared_ptr<Gameplay::RenderComponent>& renderable, const Gameplay::Material::Sptr& defaultMat, 
+		const glm::vec3& cameraPos, bool isOrtho, float pixelScale);
+	/// <summary>
+	/// Adds the draw calls for a renderable that passed culling to the snapshot
+	/// </summary>
+	void _AppendDrawCalls(FrameSnapshot& snapshot, const std::shared_ptr<Gameplay::RenderComponent>& renderable, int lodLevel);
+
 	void _AccumulateLighting();
 	void _Composite();
 	void _ClearFramebuffer(Framebuffer::Sptr& buffer, const glm::vec4* colors, int layers);
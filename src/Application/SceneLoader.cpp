@@ -0,0 +1,201 @@
+#include "Application/SceneLoader.h"
+
+#include <chrono>
+#include <filesystem>
+#include <Logging.h>
+
+#include "Utils/FileHelpers.h"
+
+// How much of the progress bar each stage covers, building is whatever is left over
+static constexpr float ParseProgress = 0.05f;
+static constexpr float ResourceProgress = 0.45f;
+
+SceneLoader::SceneLoader(JobSystem& jobs) :
+	_jobs(jobs),
+	_stage(SceneLoadStage::Idle),
+	_path(""),
+	_parseJob(nullptr),
+	_parsed(nullptr),
+	_isBinary(false),
+	_resources(nullptr),
+	_scene(nullptr),
+	_steps(std::deque<Gameplay::Scene::LoadStep>()),
+	_totalSteps(0),
+	_stepProgress(0.0f)
+{ }
+
+SceneLoader::~SceneLoader() {
+	Cancel();
+}
+
+void SceneLoader::Start(const std::string& path) {
+	Cancel();
+
+	LOG_INFO("Loading scene from \"{}\" in the background", path);
+	_path = path;
+	_StartParse(true, true);
+}
+
+void SceneLoader::Cancel() {
+	// Jobs that are still running only hold on to their own results, so we can just let them finish
+	_stage = SceneLoadStage::Idle;
+	_parseJob = nullptr;
+	_parsed = nullptr;
+	_resources = nullptr;
+	_steps.clear();
+	_totalSteps = 0;
+	_stepProgress = 0.0f;
+	_scene = nullptr;
+}
+
+bool SceneLoader::IsLoading() const {
+	return _stage != SceneLoadStage::Idle && _stage != SceneLoadStage::Failed;
+}
+
+float SceneLoader::GetProgress() const {
+	switch (_stage) {
+		case SceneLoadStage::Parsing:
+			return 0.0f;
+		case SceneLoadStage::Resources:
+			return ParseProgress + ResourceProgress * (_resources == nullptr || _resources->NumResources() == 0 ? 1.0f :
+				static_cast<float>(_resources->NumResources() - _resources->NumRemaining()) / _resources->NumResources());
+		case SceneLoadStage::Building:
+			return ParseProgress + ResourceProgress + (1.0f - ParseProgress - ResourceProgress) * (_totalSteps == 0 ? 1.0f :
+				(static_cast<float>(_totalSteps - _steps.size()) + _stepProgress) / _totalSteps);
+		default:
+			return 0.0f;
+	}
+}
+
+Gameplay::Scene::Sptr SceneLoader::Tick(float budgetMs) {
+	Gameplay::Scene::LoadDeadline deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(static_cast<int64_t>(budgetMs * 1000.0f));
+
+	if (_stage == SceneLoadStage::Parsing) {
+		if (!JobSystem::IsComplete(_parseJob)) {
+			return nullptr;
+		}
+		if (!_parsed->Error.empty()) {
+			_Fail(_parsed->Error);
+			return nullptr;
+		}
+		_isBinary = _parsed->UseBinary;
+
+		// Only the manifest for the first attempt is loaded, if we fall back from binary it's already in place
+		if (_parsed->HasManifest) {
+			ResourceManager::LoadManifestFromJson(_parsed->Manifest);
+			_parsed->Manifest = nlohmann::ordered_json();
+
+			// Independent resources are decoded in parallel, and created as soon as their dependencies are
+			_resources = std::make_unique<ManifestPreloader>(_jobs);
+			_resources->Start();
+		}
+		_stage = SceneLoadStage::Resources;
+	}
+
+	if (_stage == SceneLoadStage::Resources) {
+		double remaining = std::chrono::duration<double, std::milli>(deadline - std::chrono::steady_clock::now()).count();
+		if (_resources != nullptr && (remaining <= 0.0 || !_resources->Update(static_cast<float>(remaining)))) {
+			return nullptr;
+		}
+
+		if (!_BeginBuild()) {
+			return nullptr;
+		}
+	}
+
+	if (_stage == SceneLoadStage::Building) {
+		// Steps check the deadline between each object or component, so they only overrun it by one of them
+		while (!_steps.empty() && std::chrono::steady_clock::now() < deadline) {
+			LoadStepResult result = _steps.front()(_stepProgress, deadline);
+			if (result == LoadStepResult::Failed) {
+				// A bad binary scene can still be recovered from the JSON
+				if (_isBinary) {
+					LOG_WARN("Failed to load binary scene for \"{}\", falling back to JSON", _path);
+					_steps.clear();
+					_scene = nullptr;
+					_StartParse(false, false);
+				} else {
+					_Fail("Scene data is invalid");
+				}
+				return nullptr;
+			}
+			if (result == LoadStepResult::Done) {
+				_steps.pop_front();
+				_stepProgress = 0.0f;
+			}
+		}
+		if (!_steps.empty()) {
+			return nullptr;
+		}
+
+		LOG_INFO("Finished loading scene \"{}\"", _path);
+		Gameplay::Scene::Sptr result = _scene;
+		result->_filePath = _path;
+		Cancel();
+		return result;
+	}
+
+	return nullptr;
+}
+
+void SceneLoader::_StartParse(bool allowBinary, bool loadManifest) {
+	_stage = SceneLoadStage::Parsing;
+
+	std::shared_ptr<ParseResult> result = std::make_shared<ParseResult>();
+	_parsed = result;
+
+	std::string path = _path;
+	_parseJob = _jobs.Schedule([result, path, allowBinary, loadManifest]() {
+		try {
+			if (loadManifest) {
+				std::string manifestPath = std::filesystem::path(path).stem().string() + "-manifest.json";
+				if (std::filesystem::exists(manifestPath)) {
+					result->Manifest = nlohmann::ordered_json::parse(FileHelpers::ReadFile(manifestPath));
+					result->HasManifest = true;
+				}
+			}
+
+			// Binary scenes are mapped on the main thread, since that is practically free
+			result->UseBinary = allowBinary && Gameplay::Scene::_HasUpToDateBinary(path);
+			if (!result->UseBinary) {
+				if (!std::filesystem::exists(path)) {
+					result->Error = "File does not exist";
+					return;
+				}
+				result->Scene = std::make_shared<const nlohmann::json>(nlohmann::json::parse(FileHelpers::ReadFile(path)));
+			}
+		}
+		catch (const std::exception& e) {
+			result->Error = e.what();
+		}
+	});
+}
+
+bool SceneLoader::_BeginBuild() {
+	_steps.clear();
+	_scene = _isBinary ?
+		Gameplay::Scene::_BeginLoadBinary(Gameplay::Scene::GetBinaryPath(_path), _steps) :
+		Gameplay::Scene::_BeginLoadJson(_parsed->Scene, _steps);
+
+	if (_scene == nullptr) {
+		if (_isBinary) {
+			LOG_WARN("Failed to load binary scene for \"{}\", falling back to JSON", _path);
+			_StartParse(false, false);
+		} else {
+			_Fail("Scene data is invalid");
+		}
+		return false;
+	}
+
+	_scene->_QueueAwake(_steps);
+	_totalSteps = _steps.size();
+	_stepProgress = 0.0f;
+	_stage = SceneLoadStage::Building;
+	return true;
+}
+
+void SceneLoader::_Fail(const std::string& message) {
+	LOG_ERROR("Failed to load scene \"{}\": {}", _path, message);
+	Cancel();
+	_stage = SceneLoadStage::Failed;
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <deque>
+#include <string>
+#include <EnumToString.h>
+
+#include "Application/JobSystem.h"
+#include "Gameplay/Scene.h"
+#include "Utils/Macros.h"
+#include "Utils/ResourceManager/ManifestPreloader.h"
+
+/**
+ * The stages that a scene goes through while being loaded by a SceneLoader
+ */
+ENUM(SceneLoadStage, int,
+	Idle,      // No scene is being loaded
+	Parsing,   // The manifest and scene files are being read and parsed on a worker thread
+	Resources, // Resources are being decoded on worker threads and created on the main thread, in dependency order
+	Building,  // Objects and components are being created, and then woken up
+	Failed     // The last load could not be completed
+);
+
+/**
+ * Loads a scene over multiple frames, so that switching scenes does not freeze the window
+ *
+ * File reading, parsing and decoding happen on the application's worker threads. Anything that
+ * needs the main thread (creating GL objects, constructing objects and components, OnLoad and
+ * Awake) is queued up and run from Tick, which stops once the frame's time budget is spent
+ */
+class SceneLoader final {
+public:
+	MAKE_PTRS(SceneLoader);
+	NO_COPY(SceneLoader);
+	NO_MOVE(SceneLoader);
+
+	/**
+	 * Creates a new scene loader that will use the given job system for background work
+	 *
+	 * @param jobs The job system to run parsing and decoding on, must outlive the loader
+	 */
+	SceneLoader(JobSystem& jobs);
+	~SceneLoader();
+
+	/**
+	 * Starts loading the scene at the given path, along with it's manifest if it has one.
+	 * Any load that is already in progress will be abandoned
+	 *
+	 * @param path The path to the scene's JSON file
+	 */
+	void Start(const std::string& path);
+	/**
+	 * Abandons the load that is in progress, if any
+	 */
+	void Cancel();
+
+	/**
+	 * Does as much main thread work for the current load as fits in the given budget. Work is
+	 * only interrupted between objects or components, so the budget may be overrun by one of them
+	 *
+	 * @param budgetMs The maximum amount of time to spend, in milliseconds
+	 * @returns The loaded scene, once it is completely loaded and awake, otherwise nullptr
+	 */
+	Gameplay::Scene::Sptr Tick(float budgetMs);
+
+	/**
+	 * Returns true if a scene is currently being loaded
+	 */
+	bool IsLoading() const;
+	/**
+	 * Gets the current stage of the load
+	 */
+	SceneLoadStage GetStage() const { return _stage; }
+	/**
+	 * Gets the overall progress of the current load, from 0 to 1
+	 */
+	float GetProgress() const;
+	/**
+	 * Gets the path of the scene being loaded
+	 */
+	const std::string& GetPath() const { return _path; }
+
+protected:
+	// The results of the parsing job, only touched by the main thread once the job is complete
+	struct ParseResult {
+		bool                                   HasManifest = false;
+		nlohmann::ordered_json                 Manifest;
+		bool                                   UseBinary = false;
+		std::shared_ptr<const nlohmann::json>  Scene;
+		std::string                            Error;
+	};
+
+	JobSystem&      _jobs;
+	SceneLoadStage  _stage;
+	std::string     _path;
+
+	JobSystem::JobHandle         _parseJob;
+	std::shared_ptr<ParseResult> _parsed;
+	bool                         _isBinary;
+
+	ManifestPreloader::Uptr _resources;
+
+	Gameplay::Scene::Sptr                   _scene;
+	std::deque<Gameplay::Scene::LoadStep>   _steps;
+	size_t _totalSteps;
+	float  _stepProgress;
+
+	void _StartParse(bool allowBinary, bool loadManifest);
+	bool _BeginBuild();
+	void _Fail(const std::string& message);
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+/**
+ * Holds two copies of the state that a layer captures for rendering, so that the copy being
+ * drawn is never the one being captured. Layers capture into the back copy during OnLateUpdate,
+ * publish it once it is complete, and only draw from the front copy. The front copy stays
+ * untouched until the next publish, no matter what the simulation does to the scene
+ *
+ * The copies are reused, so any containers in them keep their capacity between frames
+ */
+template <typename T>
+class SnapshotBuffer final {
+public:
+	SnapshotBuffer() :
+		_buffers(),
+		_front(0)
+	{ }
+
+	/**
+	 * Gets the copy that is being captured for the next frame
+	 */
+	T& Back() { return _buffers[_front ^ 1]; }
+	/**
+	 * Gets the most recently published copy, which is the one that should be drawn
+	 */
+	const T& Front() const { return _buffers[_front]; }
+
+	/**
+	 * Makes the back copy the one that is drawn, the old front copy will be captured into next
+	 */
+	void Publish() { _front ^= 1; }
+
+private:
+	T   _buffers[2];
+	int _front;
+};
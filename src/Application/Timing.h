@@ -16,6 +16,21 @@ public:
 	inline float TimeSinceAppLoad() { return _timeSinceSceneLoad; }
 	inline float UnscaledTimeSinceAppLoad() { return _unscaledTimeSinceSceneLoad; }
 
+	/**
+	 * The length of a single simulation tick, in seconds. Logic and physics are advanced
+	 * by this amount each tick, regardless of the frame rate
+	 */
+	inline float FixedDeltaTime() { return _fixedDeltaTime; }
+	/**
+	 * How far the current frame is between the previous and current simulation ticks, in
+	 * the 0-1 range. Used to interpolate transforms for rendering
+	 */
+	inline float InterpolationAlpha() { return _interpolationAlpha; }
+	/**
+	 * The number of simulation ticks that were run during this frame
+	 */
+	inline int TicksThisFrame() { return _ticksThisFrame; }
+
 	static inline Timing& Current() { return _singleton; }
 
 	static inline float TimeScale() { return _timeScale; }
@@ -33,6 +48,10 @@ protected:
 	float _timeSinceAppLoad = 0;
 	float _unscaledTimeSinceAppLoad = 0;
 
+	float _fixedDeltaTime = 1.0f / 60.0f;
+	float _interpolationAlpha = 0;
+	int   _ticksThisFrame = 0;
+
 	static inline float _timeScale = 1.0f;
 };
 
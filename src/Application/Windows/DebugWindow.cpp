@@ -37,4 +37,16 @@ void DebugWindow::RenderMenuBar()
 	if (changed) {
 		renderLayer->SetRenderFlags(flags);
 	}
+
+	ImGui::Separator();
+
+	bool lodEnabled = renderLayer->IsLodEnabled();
+	if (ImGui::Checkbox("Enable LODs", &lodEnabled)) {
+		renderLayer->SetLodEnabled(lodEnabled);
+	}
+	float lodError = renderLayer->GetLodPixelError();
+	ImGui::SetNextItemWidth(80.0f);
+	if (ImGui::DragFloat("LOD Pixel Error", &lodError, 0.05f, 0.0f, 32.0f)) {
+		renderLayer->SetLodPixelError(lodError);
+	}
 }
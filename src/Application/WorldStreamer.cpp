@@ -0,0 +1,232 @@
+#include "Application/WorldStreamer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <Logging.h>
+
+#include "Utils/FileHelpers.h"
+
+WorldStreamer::WorldStreamer(JobSystem& jobs) :
+	MaxConcurrentLoads(4),
+	_jobs(jobs),
+	_scene(std::weak_ptr<Gameplay::Scene>()),
+	_cellSize(0.0f),
+	_loadRadius(0.0f),
+	_unloadRadius(0.0f),
+	_cells(std::vector<Cell>()),
+	_cellLookup(std::unordered_map<glm::ivec2, size_t>()),
+	_active(std::vector<size_t>()),
+	_numLoaded(0)
+{ }
+
+WorldStreamer::~WorldStreamer() {
+	SetScene(nullptr);
+}
+
+void WorldStreamer::SetScene(const Gameplay::Scene::Sptr& scene) {
+	// Jobs that are still running only hold on to their own results, so we can just let them finish
+	_scene = scene;
+	_cells.clear();
+	_cellLookup.clear();
+	_active.clear();
+	_numLoaded = 0;
+
+	if (scene == nullptr || !scene->IsStreamed()) {
+		return;
+	}
+
+	const Gameplay::Scene::StreamingSettings& streaming = scene->GetStreaming();
+	_cellSize = streaming.CellSize;
+	_loadRadius = streaming.LoadRadius;
+	_unloadRadius = glm::max(streaming.UnloadRadius, streaming.LoadRadius);
+
+	_cells.reserve(streaming.Cells.size());
+	for (const auto& info : streaming.Cells) {
+		Cell cell;
+		cell.Coord = info.Coord;
+		cell.Path = info.Path;
+		cell.State = StreamingCellState::Unloaded;
+		cell.Job = nullptr;
+		_cellLookup[cell.Coord] = _cells.size();
+		_cells.push_back(std::move(cell));
+	}
+
+	LOG_INFO("Streaming {} cells of {} units, loading within {} and unloading past {}", _cells.size(), _cellSize, _loadRadius, _unloadRadius);
+}
+
+int WorldStreamer::NumPendingCells() const {
+	int result = 0;
+	for (size_t index : _active) {
+		StreamingCellState state = _cells[index].State;
+		if (state == StreamingCellState::Parsing || state == StreamingCellState::Building) {
+			result++;
+		}
+	}
+	return result;
+}
+
+void WorldStreamer::Tick(const glm::vec3& focus, float budgetMs) {
+	Gameplay::Scene::Sptr scene = _scene.lock();
+	if (scene == nullptr || _cells.empty()) {
+		return;
+	}
+
+	Gameplay::Scene::LoadDeadline deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(static_cast<int64_t>(budgetMs * 1000.0f));
+	glm::vec2 point = glm::vec2(focus);
+
+	// Unload cells that have moved out of range, the gap between the radii stops cells on the edge from thrashing
+	for (size_t ix = 0; ix < _active.size();) {
+		Cell& cell = _cells[_active[ix]];
+		if (_DistanceToCell(cell, point) > _unloadRadius) {
+			_Unload(cell);
+			_active[ix] = _active.back();
+			_active.pop_back();
+		} else {
+			ix++;
+		}
+	}
+
+	// Start loading the closest cells that are in range, we only look at the cells around the focus
+	int pending = NumPendingCells();
+	if (pending < MaxConcurrentLoads) {
+		glm::ivec2 min = glm::ivec2(glm::floor((point - _loadRadius) / _cellSize));
+		glm::ivec2 max = glm::ivec2(glm::floor((point + _loadRadius) / _cellSize));
+
+		std::vector<std::pair<float, size_t>> candidates;
+		for (int y = min.y; y <= max.y; y++) {
+			for (int x = min.x; x <= max.x; x++) {
+				auto it = _cellLookup.find(glm::ivec2(x, y));
+				if (it == _cellLookup.end() || _cells[it->second].State != StreamingCellState::Unloaded) {
+					continue;
+				}
+				float distance = _DistanceToCell(_cells[it->second], point);
+				if (distance <= _loadRadius) {
+					candidates.emplace_back(distance, it->second);
+				}
+			}
+		}
+
+		std::sort(candidates.begin(), candidates.end());
+		for (size_t ix = 0; ix < candidates.size() && pending < MaxConcurrentLoads; ix++, pending++) {
+			_StartLoad(candidates[ix].second);
+		}
+	}
+
+	// Do the main thread work for the closest cells first, so the area around the camera fills in first
+	std::sort(_active.begin(), _active.end(), [&](size_t a, size_t b) {
+		return _DistanceToCell(_cells[a], point) < _DistanceToCell(_cells[b], point);
+	});
+	for (size_t index : _active) {
+		if (std::chrono::steady_clock::now() >= deadline) {
+			break;
+		}
+
+		Cell& cell = _cells[index];
+		if (cell.State == StreamingCellState::Parsing) {
+			if (!JobSystem::IsComplete(cell.Job)) {
+				continue;
+			}
+			if (!cell.Parsed->Error.empty()) {
+				LOG_WARN("Failed to load streaming cell \"{}\": {}", cell.Path, cell.Parsed->Error);
+				_Unload(cell);
+				cell.State = StreamingCellState::Failed;
+				continue;
+			}
+			_BeginBuild(cell);
+		}
+
+		if (cell.State == StreamingCellState::Building) {
+			while (!cell.Steps.empty() && std::chrono::steady_clock::now() < deadline) {
+				float progress = 0.0f;
+				LoadStepResult result = cell.Steps.front()(progress, deadline);
+				if (result == LoadStepResult::Failed) {
+					LOG_WARN("Failed to load streaming cell \"{}\"", cell.Path);
+					_Unload(cell);
+					cell.State = StreamingCellState::Failed;
+					break;
+				}
+				if (result == LoadStepResult::Done) {
+					cell.Steps.pop_front();
+				}
+			}
+
+			if (cell.State == StreamingCellState::Building && cell.Steps.empty()) {
+				cell.State = StreamingCellState::Loaded;
+				_numLoaded++;
+			}
+		}
+	}
+
+	// Cells that failed are never loaded again, so they don't need to be tracked
+	_active.erase(std::remove_if(_active.begin(), _active.end(), [&](size_t index) {
+		return _cells[index].State == StreamingCellState::Failed;
+	}), _active.end());
+}
+
+float WorldStreamer::_DistanceToCell(const Cell& cell, const glm::vec2& point) const {
+	glm::vec2 cellMin = glm::vec2(cell.Coord) * _cellSize;
+	glm::vec2 nearest = glm::clamp(point, cellMin, cellMin + _cellSize);
+	return glm::length(point - nearest);
+}
+
+void WorldStreamer::_StartLoad(size_t index) {
+	Cell& cell = _cells[index];
+	cell.State = StreamingCellState::Parsing;
+
+	std::shared_ptr<ParseResult> result = std::make_shared<ParseResult>();
+	cell.Parsed = result;
+
+	std::string path = cell.Path;
+	cell.Job = _jobs.Schedule([result, path]() {
+		try {
+			if (!std::filesystem::exists(path)) {
+				result->Error = "File does not exist";
+				return;
+			}
+
+			nlohmann::json blob = nlohmann::json::parse(FileHelpers::ReadFile(path));
+			if (!blob.contains("objects") || !blob["objects"].is_array()) {
+				result->Error = "Objects not present in cell";
+				return;
+			}
+			result->Objects = std::make_shared<const nlohmann::json>(std::move(blob["objects"]));
+		}
+		catch (const std::exception& e) {
+			result->Error = e.what();
+		}
+	});
+
+	_active.push_back(index);
+}
+
+void WorldStreamer::_BeginBuild(Cell& cell) {
+	cell.Objects = std::make_shared<std::vector<Gameplay::GameObject::Wptr>>();
+	Gameplay::Scene::_QueueLoadObjects(_scene, cell.Parsed->Objects, true, cell.Steps, cell.Objects);
+	cell.Parsed = nullptr;
+	cell.Job = nullptr;
+	cell.State = StreamingCellState::Building;
+}
+
+void WorldStreamer::_Unload(Cell& cell) {
+	if (cell.State == StreamingCellState::Loaded) {
+		_numLoaded--;
+	}
+
+	// Cells that are part way through building may have already added some objects
+	Gameplay::Scene::Sptr scene = _scene.lock();
+	if (scene != nullptr && cell.Objects != nullptr) {
+		for (const auto& weakObject : *cell.Objects) {
+			Gameplay::GameObject::Sptr object = weakObject.lock();
+			if (object != nullptr) {
+				scene->RemoveGameObject(object);
+			}
+		}
+	}
+
+	cell.State = StreamingCellState::Unloaded;
+	cell.Job = nullptr;
+	cell.Parsed = nullptr;
+	cell.Steps.clear();
+	cell.Objects = nullptr;
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <EnumToString.h>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "GLM/gtx/hash.hpp"
+
+#include "Application/JobSystem.h"
+#include "Gameplay/Scene.h"
+#include "Utils/Macros.h"
+
+/**
+ * The states that a cell of a streamed scene moves through
+ */
+ENUM(StreamingCellState, int,
+	Unloaded, // None of the cell's objects are in the scene
+	Parsing,  // The cell's file is being read and parsed on a worker thread
+	Building, // The cell's objects are being added to the scene
+	Loaded,   // All of the cell's objects are in the scene
+	Failed    // The cell's file is missing or invalid, it will not be loaded again
+);
+
+/**
+ * Loads and unloads the cells of a streamed scene (see Scene::SaveStreamed) around a focus
+ * point, usually the camera, so that worlds can be much larger than what fits in memory
+ *
+ * Cells are read and parsed on the application's worker threads. Adding the objects to the
+ * scene has to happen on the main thread, so it is spread across frames by Tick, which stops
+ * once the frame's time budget is spent. Cells are unloaded by removing their objects from
+ * the scene, references to those objects will resolve again if the cell is loaded back in
+ */
+class WorldStreamer final {
+public:
+	MAKE_PTRS(WorldStreamer);
+	NO_COPY(WorldStreamer);
+	NO_MOVE(WorldStreamer);
+
+	// The maximum number of cells that can be parsing or building at the same time
+	int MaxConcurrentLoads;
+
+	/**
+	 * Creates a new world streamer that will use the given job system for background work
+	 *
+	 * @param jobs The job system to run parsing on, must outlive the streamer
+	 */
+	WorldStreamer(JobSystem& jobs);
+	~WorldStreamer();
+
+	/**
+	 * Sets the scene to stream cells into, and forgets about all cells of the last scene.
+	 * Scenes that are not streamed are ignored
+	 *
+	 * @param scene The scene to stream, or nullptr to stop streaming
+	 */
+	void SetScene(const Gameplay::Scene::Sptr& scene);
+
+	/**
+	 * Unloads cells that are too far from the focus point, starts loading cells that are close
+	 * enough, and does as much main thread work for loading cells as fits in the given budget.
+	 * Closer cells are always loaded first
+	 *
+	 * @param focus The point in world space to stream around, only the X and Y axes are used
+	 * @param budgetMs The maximum amount of time to spend, in milliseconds
+	 */
+	void Tick(const glm::vec3& focus, float budgetMs);
+
+	/**
+	 * Returns true if the current scene is streamed
+	 */
+	bool IsStreaming() const { return !_cells.empty(); }
+	/**
+	 * Gets the total number of cells in the current scene
+	 */
+	int NumCells() const { return static_cast<int>(_cells.size()); }
+	/**
+	 * Gets the number of cells that are completely loaded
+	 */
+	int NumLoadedCells() const { return _numLoaded; }
+	/**
+	 * Gets the number of cells that are currently being loaded
+	 */
+	int NumPendingCells() const;
+
+protected:
+	// The results of parsing a cell, only touched by the main thread once the job is complete
+	struct ParseResult {
+		std::shared_ptr<const nlohmann::json> Objects;
+		std::string                           Error;
+	};
+
+	struct Cell {
+		glm::ivec2                    Coord;
+		std::string                   Path;
+		StreamingCellState            State;
+		JobSystem::JobHandle          Job;
+		std::shared_ptr<ParseResult>  Parsed;
+		std::deque<Gameplay::Scene::LoadStep>  Steps;
+		// The objects that were added to the scene, filled in once the cell is loaded
+		std::shared_ptr<std::vector<Gameplay::GameObject::Wptr>> Objects;
+	};
+
+	JobSystem&  _jobs;
+	std::weak_ptr<Gameplay::Scene> _scene;
+
+	float _cellSize;
+	float _loadRadius;
+	float _unloadRadius;
+
+	std::vector<Cell> _cells;
+	std::unordered_map<glm::ivec2, size_t> _cellLookup;
+	// Indices of all cells that are not unloaded, so we never need to look at the whole world
+	std::vector<size_t> _active;
+	int _numLoaded;
+
+	// Gets the distance on the X and Y axes from a point to the nearest point in a cell
+	float _DistanceToCell(const Cell& cell, const glm::vec2& point) const;
+
+	void _StartLoad(size_t index);
+	void _BeginBuild(Cell& cell);
+	void _Unload(Cell& cell);
+};
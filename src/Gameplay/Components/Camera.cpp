@@ -101,10 +101,18 @@ namespace Gameplay {
 	}
 
 	const glm::mat4& Camera::GetViewProjection() const {
-		_viewProjection = __CalculateProjection() * GetGameObject()->GetInverseTransform();
+		_viewProjection = __CalculateProjection() * GetView();
 		return _viewProjection;
 	}
 
+	glm::mat4 Camera::GetRenderView() const {
+		return glm::inverse(GetGameObject()->GetRenderTransform());
+	}
+
+	glm::mat4 Camera::GetRenderViewProjection() const {
+		return __CalculateProjection() * GetRenderView();
+	}
+
 	const glm::vec4& Camera::GetClearColor() const
 	{
 		return _clearColor;
@@ -20,6 +20,7 @@ namespace Gameplay {
 	// IComponent implementation
 	public:
 		virtual void RenderImGui() override;
+		virtual UpdateAccess GetUpdateAccess() const override { return UpdateAccess::Parallel(); }
 
 		MAKE_TYPENAME(Camera);
 
@@ -69,7 +70,7 @@ namespace Gameplay {
 		bool GetOrthoEnabled() const { return _isOrtho; }
 
 		/// <summary>
-		/// Gets the view matrix for this camera
+		/// Gets the view matrix for this camera, based on the gameobject's simulated transform
 		/// </summary>
 		const glm::mat4& GetView() const;
 		/// <summary>
@@ -81,6 +82,17 @@ namespace Gameplay {
 		/// </summary>
 		const glm::mat4& GetViewProjection() const;
 
+		/// <summary>
+		/// Gets the view matrix for rendering, based on the gameobject's render transform (which is
+		/// interpolated between simulation ticks). This is recalculated on each call, so the render
+		/// layer grabs it once per frame
+		/// </summary>
+		glm::mat4 GetRenderView() const;
+		/// <summary>
+		/// Gets the combined view-projection matrix for rendering, see GetRenderView
+		/// </summary>
+		glm::mat4 GetRenderViewProjection() const;
+
 		const glm::vec4& GetClearColor() const;
 		void SetClearColor(const glm::vec4& color);
 
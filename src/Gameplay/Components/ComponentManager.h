@@ -15,6 +15,9 @@ namespace Gameplay {
 	public:
 		typedef std::function<IComponent::Sptr(const nlohmann::json&)> LoadComponentFunc;
 		typedef std::function<IComponent::Sptr()> CreateComponentFunc;
+		typedef std::function<IComponent::Sptr(const IComponent&)> CloneComponentFunc;
+		typedef std::function<void(IComponent&, const IComponent&)> CopyComponentFunc;
+		typedef std::function<IComponent::Sptr(BinaryReader&)> LoadBinaryComponentFunc;
 
 		/// <summary>
 		/// Loads a component with the given type name from a JSON blob
@@ -49,6 +52,86 @@ namespace Gameplay {
 			return nullptr;
 		}
 
+		/// <summary>
+		/// Loads a component with the given type name from a binary scene
+		/// If the type name does not correspond to a registered type, or the data
+		/// is invalid, will return nullptr
+		/// </summary>
+		/// <param name="typeName">The name of the type to load (taken from GetComponentTypeName of component)</param>
+		/// <param name="reader">The reader to decode the component from</param>
+		/// <param name="isNative">True if the component was written with ToBinary, false if it was written as CBOR (see SaveBinary)</param>
+		/// <returns>The component as decoded from the binary data, or nullptr</returns>
+		inline IComponent::Sptr LoadBinary(const std::string& typeName, BinaryReader& reader, bool isNative) {
+			// Types without binary hooks are stored as their JSON representation
+			if (!isNative) {
+				uint32_t size = reader.Read<uint32_t>();
+				const uint8_t* data = reader.ReadSpan(size);
+				if (data == nullptr) {
+					return nullptr;
+				}
+				nlohmann::json blob = nlohmann::json::from_cbor(data, data + size, true, false);
+				if (blob.is_discarded()) {
+					reader.Fail();
+					return nullptr;
+				}
+				return Load(typeName, blob);
+			}
+
+			auto typeIt = _TypeNameMap.find(typeName);
+			if (typeIt != _TypeNameMap.end() && typeIt->second.has_value()) {
+				auto loaderIt = _TypeBinaryLoadRegistry.find(typeIt->second.value());
+				if (loaderIt != _TypeBinaryLoadRegistry.end()) {
+					// Invoke the loader, also load additional component data
+					IComponent::Sptr result = loaderIt->second(reader);
+					if (result == nullptr) {
+						reader.Fail();
+						return nullptr;
+					}
+					IComponent::LoadBaseBinary(result, reader);
+					if (!reader.IsValid()) {
+						return nullptr;
+					}
+
+					// Make sure the component knows it's own type
+					result->_realType = typeIt->second.value();
+					result->_weakSelfPtr = result;
+
+					// Add the component to the global pools
+					_Components[result->_realType].push_back(result);
+					return result;
+				}
+			}
+			return nullptr;
+		}
+
+		/// <summary>
+		/// Writes a component to a binary scene, using the type's binary hooks if it has them
+		/// and falling back to CBOR encoded JSON if not
+		/// </summary>
+		/// <param name="component">The component to write</param>
+		/// <param name="writer">The writer to append the component data to</param>
+		/// <param name="isNative">Should match HasBinaryFormat for the component's type</param>
+		static void SaveBinary(const IComponent::Sptr& component, BinaryWriter& writer, bool isNative) {
+			if (isNative) {
+				component->ToBinary(writer);
+				IComponent::SaveBaseBinary(component, writer);
+			} else {
+				nlohmann::json blob = component->ToJson();
+				IComponent::SaveBaseJson(component, blob);
+				std::vector<uint8_t> data = nlohmann::json::to_cbor(blob);
+				writer.Write<uint32_t>(static_cast<uint32_t>(data.size()));
+				writer.WriteBytes(data.data(), data.size());
+			}
+		}
+
+		/// <summary>
+		/// Returns true if components of the given type define binary read/write hooks
+		/// </summary>
+		/// <param name="type">The component type to check</param>
+		static bool HasBinaryFormat(const std::type_index& type) {
+			return _TypeBinaryLoadRegistry.find(type) != _TypeBinaryLoadRegistry.end();
+		}
+
 		/// <summary>
 		/// Creates a component with the given type name
 		/// If the type name does not correspond to a registered type, will
@@ -104,6 +187,88 @@ namespace Gameplay {
 			return nullptr;
 		}
 
+		/// <summary>
+		/// Creates a copy of the given component using it's copy constructor, and adds the copy to the
+		/// global pools. The copy is not attached to any gameobject and receives a new GUID
+		/// If the component's type cannot be copied (see CanCopy), will return nullptr
+		/// </summary>
+		/// <param name="source">The component to copy</param>
+		/// <returns>A new component with the same state as source, or nullptr</returns>
+		inline IComponent::Sptr Clone(const IComponent& source) {
+			IComponent::Sptr result = CloneDetached(source);
+			if (result != nullptr) {
+				_Components[result->_realType].push_back(result);
+			}
+			return result;
+		}
+
+		/// <summary>
+		/// Same as Clone, but does not add the result to any component pools. Used for storing
+		/// component templates (ex: in prefabs) that should never be updated or rendered
+		/// </summary>
+		/// <param name="source">The component to copy</param>
+		/// <returns>A new component with the same state as source, or nullptr</returns>
+		static IComponent::Sptr CloneDetached(const IComponent& source) {
+			auto it = _TypeCloneRegistry.find(source._realType);
+			if (it != _TypeCloneRegistry.end() && it->second) {
+				IComponent::Sptr result = it->second(source);
+				result->_realType = source._realType;
+				result->_weakSelfPtr = result;
+				return result;
+			}
+			return nullptr;
+		}
+
+		/// <summary>
+		/// Copies the state of one component into another of the same type, without modifying the
+		/// target's GUID or gameobject
+		/// </summary>
+		/// <param name="target">The component to overwrite</param>
+		/// <param name="source">The component to copy state from</param>
+		/// <returns>True if the state was copied, false if the types differ or cannot be copied</returns>
+		static bool CopyState(IComponent& target, const IComponent& source) {
+			if (target._realType != source._realType) {
+				return false;
+			}
+			auto it = _TypeCopyRegistry.find(source._realType);
+			if (it != _TypeCopyRegistry.end() && it->second) {
+				it->second(target, source);
+				return true;
+			}
+			return false;
+		}
+
+		/// <summary>
+		/// Returns true if components of the given type can be copied directly, without going
+		/// through JSON. Types that own external handles (bullet bodies, GL buffers) opt out
+		/// by deleting their copy constructor (see NO_COPY)
+		/// </summary>
+		/// <param name="type">The component type to check</param>
+		static bool CanCopy(const std::type_index& type) {
+			return _TypeCopyRegistry.find(type) != _TypeCopyRegistry.end();
+		}
+
+		/// <summary>
+		/// Same as Load, but does not add the result to any component pools
+		/// </summary>
+		/// <param name="typeName">The name of the type to load (taken from GetComponentTypeName of component)</param>
+		/// <param name="blob">The JSON blob to decode</param>
+		/// <returns>The component as decoded from the JSON data, or nullptr</returns>
+		static IComponent::Sptr LoadDetached(const std::string& typeName, const nlohmann::json& blob) {
+			auto typeIt = _TypeNameMap.find(typeName);
+			if (typeIt != _TypeNameMap.end() && typeIt->second.has_value()) {
+				LoadComponentFunc callback = _TypeLoadRegistry[typeIt->second.value()];
+				if (callback) {
+					IComponent::Sptr result = callback(blob);
+					IComponent::LoadBaseJson(result, blob);
+					result->_realType = typeIt->second.value();
+					result->_weakSelfPtr = result;
+					return result;
+				}
+			}
+			return nullptr;
+		}
+
 		/// <summary>
 		/// 
 		/// </summary>
@@ -226,6 +391,15 @@ namespace Gameplay {
 				// name to type index mapping
 				_TypeLoadRegistry[type] = &ComponentManager::ParseTypeFromBlob<T>;
 				_TypeCreateRegistry[type] = &ComponentManager::_InternalCreate<T>;
+				// Binary hooks are optional, types without them are stored as JSON in binary scenes
+				if constexpr (test_binary<T, BinaryReader&>::value) {
+					_TypeBinaryLoadRegistry[type] = &ComponentManager::ParseTypeFromBinary<T>;
+				}
+				// Only register copy helpers for types that can safely be copied
+				if constexpr (std::is_copy_constructible<T>::value && std::is_copy_assignable<T>::value) {
+					_TypeCloneRegistry[type] = &ComponentManager::_InternalClone<T>;
+					_TypeCopyRegistry[type] = &ComponentManager::_InternalCopy<T>;
+				}
 				_TypeNameMap[StringTools::SanitizeClassName(typeid(T).name())] = type;
 			}
 		}
@@ -249,6 +423,12 @@ namespace Gameplay {
 		inline static std::unordered_map<std::type_index, LoadComponentFunc> _TypeLoadRegistry;
 		// Stores functions to load components from JSON, indexed on the type that they load
 		inline static std::unordered_map<std::type_index, CreateComponentFunc> _TypeCreateRegistry;
+		// Stores functions to load components from binary scenes, only for types with binary hooks
+		inline static std::unordered_map<std::type_index, LoadBinaryComponentFunc> _TypeBinaryLoadRegistry;
+		// Stores functions to copy-construct components, only for types that are copyable
+		inline static std::unordered_map<std::type_index, CloneComponentFunc> _TypeCloneRegistry;
+		// Stores functions to copy state between existing components, only for types that are copyable
+		inline static std::unordered_map<std::type_index, CopyComponentFunc> _TypeCopyRegistry;
 
 		// Weak pointers let us store a reference to an object stored by a shared pointer, without
 		// actually increasing the reference count. Thus components will be destroyed at the correct
@@ -260,6 +440,11 @@ namespace Gameplay {
 			return T::FromJson(blob);
 		}
 
+		template <typename T>
+		static IComponent::Sptr ParseTypeFromBinary(BinaryReader& reader) {
+			return T::FromBinary(reader);
+		}
+
 		template <typename ComponentType>
 		static IComponent::Sptr _InternalCreate() {
 			// We can use typeid and type_index to get a unique ID for our types
@@ -278,6 +463,16 @@ namespace Gameplay {
 			return component;
 		}
 
+		template <typename ComponentType>
+		static IComponent::Sptr _InternalClone(const IComponent& source) {
+			return std::make_shared<ComponentType>(static_cast<const ComponentType&>(source));
+		}
+
+		template <typename ComponentType>
+		static void _InternalCopy(IComponent& target, const IComponent& source) {
+			static_cast<ComponentType&>(target) = static_cast<const ComponentType&>(source);
+		}
+
 		/// <summary>
 		/// Removes a given component from the global pools. To be used in the IComponent destructor
 		/// </summary>
@@ -49,6 +49,7 @@ public:
 	virtual void StartGUI() override;
 	virtual void FinishGUI() override;
 	virtual void RenderImGui() override;
+	virtual Gameplay::UpdateAccess GetUpdateAccess() const override { return Gameplay::UpdateAccess::Parallel(); }
 	MAKE_TYPENAME(GuiPanel);
 	virtual nlohmann::json ToJson() const override;
 	static GuiPanel::Sptr FromJson(const nlohmann::json& blob);
@@ -70,6 +70,7 @@ public:
 	virtual void Awake() override;
 	virtual void RenderGUI() override;
 	virtual void RenderImGui() override;
+	virtual Gameplay::UpdateAccess GetUpdateAccess() const override { return Gameplay::UpdateAccess::Parallel(); }
 	MAKE_TYPENAME(GuiText);
 	virtual nlohmann::json ToJson() const override;
 	static GuiText::Sptr FromJson(const nlohmann::json& blob);
@@ -71,6 +71,7 @@ public:
 	// Inherited from IComponent
 
 	virtual void RenderImGui() override;
+	virtual Gameplay::UpdateAccess GetUpdateAccess() const override { return Gameplay::UpdateAccess::Parallel(); }
 	virtual nlohmann::json ToJson() const override;
 	virtual void StartGUI() override;
 	virtual void FinishGUI() override;
@@ -24,6 +24,18 @@ namespace Gameplay {
 		data["enabled"] = instance->IsEnabled;
 	}
 
+	void IComponent::LoadBaseBinary(const Sptr& result, BinaryReader& reader)
+	{
+		result->OverrideGUID(reader.ReadGuid());
+		result->IsEnabled = reader.Read<uint8_t>() != 0;
+	}
+
+	void IComponent::SaveBaseBinary(const Sptr& instance, BinaryWriter& writer)
+	{
+		writer.WriteGuid(instance->GetGUID());
+		writer.Write<uint8_t>(instance->IsEnabled ? 1 : 0);
+	}
+
 	IComponent::IComponent() :
 		IResource(),
 		IsEnabled(true),
@@ -31,7 +43,22 @@ namespace Gameplay {
 		_context(nullptr)
 	{ }
 
+	IComponent::IComponent(const IComponent& other) :
+		IResource(),
+		IsEnabled(other.IsEnabled),
+		_realType(other._realType),
+		_context(nullptr)
+	{ }
+
+	IComponent& IComponent::operator=(const IComponent& other) {
+		IsEnabled = other.IsEnabled;
+		return *this;
+	}
+
 	IComponent::~IComponent() {
-		_context->GetScene()->Components().Remove(this);
+		// Prefab templates are never attached to a gameobject
+		if (_context != nullptr) {
+			_context->GetScene()->Components().Remove(this);
+		}
 	}
 }
@@ -1,5 +1,7 @@
 #pragma once
 #include <memory>
+#include <typeindex>
+#include <vector>
 #include "json.hpp"
 #include <imgui.h>
 #include <GLM/glm.hpp>
@@ -8,6 +10,7 @@
 #include "Utils/ResourceManager/ResourceManager.h"
 #include "Utils/ResourceManager/IResource.h"
 #include "Utils/TypeHelpers.h"
+#include "Utils/BinaryStream.h"
 
 namespace Gameplay {
 	// We pre-declare GameObject to avoid circular dependencies in the headers
@@ -18,6 +21,29 @@ namespace Gameplay {
 		class RigidBody;
 	}
 
+	/// <summary>
+	/// Describes how a component type may be updated, so that the scene can update objects
+	/// on worker threads. See IComponent::GetUpdateAccess
+	/// </summary>
+	struct UpdateAccess {
+		// True if Update may run on a worker thread, while other objects are being updated
+		bool IsParallel = false;
+		// Component types on other gameobjects that Update reads from
+		std::vector<std::type_index> Reads;
+		// Component types on other gameobjects that Update modifies
+		std::vector<std::type_index> Writes;
+
+		template <typename T>
+		UpdateAccess& Read() { Reads.push_back(std::type_index(typeid(T))); return *this; }
+		template <typename T>
+		UpdateAccess& Write() { Writes.push_back(std::type_index(typeid(T))); return *this; }
+
+		/// <summary>
+		/// Access for components that are safe to update on a worker thread
+		/// </summary>
+		static UpdateAccess Parallel() { UpdateAccess result; result.IsParallel = true; return result; }
+	};
+
 	/// <summary>
 	/// Base class for components that can be attached to game objects
 	/// 
@@ -27,6 +53,12 @@ namespace Gameplay {
 	/// static std::shared_ptr<Type> FromJson(const nlohmann::json&);
 	/// 
 	/// where Type is the Type of component
+	/// 
+	/// Components may optionally define a binary format for faster scene loading, by defining
+	/// 
+	/// static std::shared_ptr<Type> FromBinary(BinaryReader&);
+	/// 
+	/// and overriding ToBinary to write the matching data
 	/// </summary>
 	class IComponent : public IResource {
 	public:
@@ -92,6 +124,13 @@ namespace Gameplay {
 		/// </summary>
 		/// <param name="context">The game object that the component belongs to</param>
 		virtual void Awake() { };
+		/// <summary>
+		/// Invoked when a component is taken out of use, either because it is being thrown away
+		/// or because it's game object has been returned to a prefab pool. Components should
+		/// release anything they have registered with the scene (ex: physics bodies), Awake
+		/// will be invoked again if the component is put back into use
+		/// </summary>
+		virtual void OnUnload() { };
 
 		/// <summary>
 		/// Invoked during the update loop
@@ -100,6 +139,23 @@ namespace Gameplay {
 		/// <param name="deltaTime">The time since the last frame, in seconds</param>
 		virtual void Update(float deltaTime) {};
 
+		/// <summary>
+		/// Components can override this to allow the scene to run their Update on worker
+		/// threads. A parallel Update may only touch this component, other components on
+		/// the same gameobject, the local position, rotation and scale of it's gameobject,
+		/// and components of the types it declares in Reads and Writes on other gameobjects.
+		/// It must not read world transforms, create or destroy objects or components, or
+		/// touch any other shared state (ex: input). Components that do not override Update
+		/// should return UpdateAccess::Parallel()
+		///
+		/// Objects are only updated on a worker thread if all of their enabled components are
+		/// parallel, and still run their components in order. Objects whose declared access
+		/// conflicts (ex: one writes a type that another reads or has) are never updated at the
+		/// same time, so the result is the same as a serial update. This is queried once per
+		/// component type, so the result should not depend on the state of the component
+		/// </summary>
+		virtual UpdateAccess GetUpdateAccess() const { return UpdateAccess(); }
+
 		/// <summary>
 		/// All components should override this to allow us to render component
 		/// info in ImGui for easy editing
@@ -114,6 +170,14 @@ namespace Gameplay {
 		/// </summary>
 		virtual std::string ComponentTypeName() const = 0;
 
+		/// <summary>
+		/// Writes the component to a binary scene, components that override this must also
+		/// define a static FromBinary that reads the same data back. Types without binary hooks
+		/// are stored in binary scenes as CBOR encoded JSON
+		/// </summary>
+		/// <param name="writer">The writer to append the component data to</param>
+		virtual void ToBinary(BinaryWriter& writer) const {}
+
 		/// <summary>
 		/// Gets the gameobject that this component is attached to
 		/// </summary>
@@ -156,9 +220,18 @@ namespace Gameplay {
 	protected:
 		IComponent();
 
+		/// <summary>
+		/// Copying a component only copies the base state (IsEnabled), the copy
+		/// receives a new GUID and is not attached to any game object. This lets
+		/// derived components use their default copy constructors for prefabs
+		/// </summary>
+		IComponent(const IComponent& other);
+		IComponent& operator =(const IComponent& other);
+
 	private:
 		friend class ComponentManager;
 		friend class GameObject;
+		friend class Prefab;
 
 		std::type_index _realType;
 		GameObject* _context;
@@ -169,6 +242,8 @@ namespace Gameplay {
 
 		static void LoadBaseJson(const IComponent::Sptr& result, const nlohmann::json& blob);
 		static void SaveBaseJson(const IComponent::Sptr& instance, nlohmann::json& data);
+		static void LoadBaseBinary(const IComponent::Sptr& result, BinaryReader& reader);
+		static void SaveBaseBinary(const IComponent::Sptr& instance, BinaryWriter& writer);
 	};
 
 	/// <summary>
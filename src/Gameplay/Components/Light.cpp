@@ -92,6 +92,26 @@ inline nlohmann::json Light::ToJson() const {
 	};
 }
 
+void Light::ToBinary(BinaryWriter& writer) const {
+	writer.Write(_color);
+	writer.Write(_radius);
+	writer.Write(_direction);
+	writer.Write(_params);
+	writer.Write(static_cast<int32_t>(_type));
+	writer.Write(_intensity);
+}
+
+Light::Sptr Light::FromBinary(BinaryReader& reader) {
+	Light::Sptr result = std::make_shared<Light>();
+	result->_color = reader.Read<glm::vec3>();
+	result->_radius = reader.Read<float>();
+	result->_direction = reader.Read<glm::vec3>();
+	result->_params = reader.Read<glm::vec3>();
+	result->_type = static_cast<LightType>(reader.Read<int32_t>());
+	result->_intensity = reader.Read<float>();
+	return result;
+}
+
 void Light::RenderImGui()
 {
 	LABEL_LEFT(ImGui::ColorPicker3, "    Color", &_color.x);
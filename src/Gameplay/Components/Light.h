@@ -42,9 +42,12 @@ public:
 
 public:
 	virtual void RenderImGui() override;
+	virtual Gameplay::UpdateAccess GetUpdateAccess() const override { return Gameplay::UpdateAccess::Parallel(); }
 	MAKE_TYPENAME(Light);
 	virtual nlohmann::json ToJson() const override;
 	static Light::Sptr FromJson(const nlohmann::json& blob);
+	virtual void ToBinary(BinaryWriter& writer) const override;
+	static Light::Sptr FromBinary(BinaryReader& reader);
 
 protected:
 	LightType _type;
@@ -25,6 +25,7 @@ public:
 	virtual void OnLeavingTrigger(const std::shared_ptr<Gameplay::Physics::TriggerVolume>& trigger) override;
 	virtual void Awake() override;
 	virtual void RenderImGui() override;
+	virtual Gameplay::UpdateAccess GetUpdateAccess() const override { return Gameplay::UpdateAccess::Parallel(); }
 	virtual nlohmann::json ToJson() const override;
 	static MaterialSwapBehaviour::Sptr FromJson(const nlohmann::json& blob);
 	MAKE_TYPENAME(MaterialSwapBehaviour);
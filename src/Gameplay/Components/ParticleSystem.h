@@ -10,6 +10,8 @@ ENUM(ParticleType, uint32_t,
 class ParticleSystem : public Gameplay::IComponent{
 public:
 	MAKE_PTRS(ParticleSystem);
+	// We own GL buffers, so we can't be shallow copied
+	NO_COPY(ParticleSystem);
 
 	ParticleSystem();
 	~ParticleSystem();
@@ -22,6 +24,7 @@ public:
 	// Inherited from IComponent
 
 	virtual void RenderImGui() override;
+	virtual Gameplay::UpdateAccess GetUpdateAccess() const override { return Gameplay::UpdateAccess::Parallel(); }
 	virtual void Awake() override;
 	virtual nlohmann::json ToJson() const override;
 	static ParticleSystem::Sptr FromJson(const nlohmann::json& blob);
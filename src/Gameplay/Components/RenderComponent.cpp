@@ -7,17 +7,30 @@
 RenderComponent::RenderComponent(const Gameplay::MeshResource::Sptr& mesh, const Gameplay::Material::Sptr& material) :
 	_mesh(mesh), 
 	_material(material), 
+	_slotMaterials(std::vector<Gameplay::Material::Sptr>()),
+	_lodLevel(0),
 	_meshBuilderParams(std::vector<MeshBuilderParam>()) 
 { }
 
 RenderComponent::RenderComponent() : 
 	_mesh(nullptr), 
 	_material(nullptr), 
+	_slotMaterials(std::vector<Gameplay::Material::Sptr>()),
+	_lodLevel(0),
 	_meshBuilderParams(std::vector<MeshBuilderParam>())
 { }
 
 void RenderComponent::SetMesh(const Gameplay::MeshResource::Sptr& mesh) {
 	_mesh = mesh;
+	_lodLevel = 0;
+}
+
+int RenderComponent::GetLodLevel() const {
+	return _lodLevel;
+}
+
+void RenderComponent::SetLodLevel(int level) {
+	_lodLevel = level;
 }
 
 const Gameplay::MeshResource::Sptr& RenderComponent::GetMeshResource() const {
@@ -36,10 +49,35 @@ const Gameplay::Material::Sptr& RenderComponent::GetMaterial() const {
 	return _material;
 }
 
+const Gameplay::Material::Sptr& RenderComponent::GetMaterial(uint32_t slot) const {
+	if (slot < _slotMaterials.size() && _slotMaterials[slot] != nullptr) {
+		return _slotMaterials[slot];
+	}
+	return _material;
+}
+
+void RenderComponent::SetMaterial(uint32_t slot, const Gameplay::Material::Sptr& mat) {
+	if (slot >= _slotMaterials.size()) {
+		_slotMaterials.resize(slot + 1);
+	}
+	_slotMaterials[slot] = mat;
+	// Trim off any unused slots at the end, so we don't save them
+	while (!_slotMaterials.empty() && _slotMaterials.back() == nullptr) {
+		_slotMaterials.pop_back();
+	}
+}
+
 nlohmann::json RenderComponent::ToJson() const {
 	nlohmann::json result;
 	result["mesh"] = _mesh ? _mesh->GetGUID().str() : "null";
 	result["material"] = _material ? _material->GetGUID().str() : "null";
+	if (!_slotMaterials.empty()) {
+		std::vector<std::string> slots;
+		for (const auto& material : _slotMaterials) {
+			slots.push_back(material ? material->GetGUID().str() : "null");
+		}
+		result["slot_materials"] = slots;
+	}
 	return result;
 }
 
@@ -47,15 +85,55 @@ RenderComponent::Sptr RenderComponent::FromJson(const nlohmann::json& data) {
 	RenderComponent::Sptr result = std::make_shared<RenderComponent>();
 	result->_mesh = ResourceManager::Get<Gameplay::MeshResource>(Guid(data["mesh"].get<std::string>()));
 	result->_material = ResourceManager::Get<Gameplay::Material>(Guid(data["material"].get<std::string>()));
+	if (data.contains("slot_materials") && data["slot_materials"].is_array()) {
+		for (const auto& slot : data["slot_materials"]) {
+			result->_slotMaterials.push_back(ResourceManager::Get<Gameplay::Material>(Guid(slot.get<std::string>())));
+		}
+	}
+
+	return result;
+}
 
+void RenderComponent::ToBinary(BinaryWriter& writer) const {
+	writer.WriteGuid(_mesh ? _mesh->GetGUID() : Guid());
+	writer.WriteGuid(_material ? _material->GetGUID() : Guid());
+	writer.Write(static_cast<uint32_t>(_slotMaterials.size()));
+	for (const auto& material : _slotMaterials) {
+		writer.WriteGuid(material ? material->GetGUID() : Guid());
+	}
+}
+
+RenderComponent::Sptr RenderComponent::FromBinary(BinaryReader& reader) {
+	RenderComponent::Sptr result = std::make_shared<RenderComponent>();
+	result->_mesh = ResourceManager::Get<Gameplay::MeshResource>(reader.ReadGuid());
+	result->_material = ResourceManager::Get<Gameplay::Material>(reader.ReadGuid());
+	uint32_t numSlots = reader.Read<uint32_t>();
+	for (uint32_t ix = 0; ix < numSlots; ix++) {
+		result->_slotMaterials.push_back(ResourceManager::Get<Gameplay::Material>(reader.ReadGuid()));
+	}
 	return result;
 }
 
 void RenderComponent::RenderImGui() {
-	ImGui::Text("Indexed:   %s", GetMesh() != nullptr ? (_mesh->Mesh->GetIndexBuffer() != nullptr ? "true" : "false") : "N/A");
+	IndexBuffer::Sptr indices = GetMesh() != nullptr ? _mesh->Mesh->GetIndexBuffer() : nullptr;
+	ImGui::Text("Indexed:   %s", GetMesh() != nullptr ? (indices != nullptr ? (~indices->GetElementType()).c_str() : "false") : "N/A");
 	ImGui::Text("Triangles: %d", GetMesh() != nullptr ? (_mesh->Mesh->GetElementCount() / 3) : 0);
+	ImGui::Text("LOD:       %d / %d", _lodLevel, GetMesh() != nullptr ? static_cast<int>(_mesh->Mesh->GetLods().size()) : 0);
 	ImGui::Text("Source:    %s", (_mesh == nullptr || _mesh->Filename.empty()) ? "Generated" : _mesh->Filename.c_str());
 	ImGui::Separator();
 	ImGui::Text("Material:  %s", _material != nullptr ? _material->Name.c_str() : "NULL");
 	ImGuiHelper::ResourceDragTarget<Gameplay::Material>(_material);
+
+	// Let each of the mesh's material slots be given it's own material
+	if (_mesh != nullptr && _mesh->MaterialSlots.size() > 1) {
+		for (uint32_t slot = 0; slot < _mesh->MaterialSlots.size(); slot++) {
+			Gameplay::Material::Sptr material = slot < _slotMaterials.size() ? _slotMaterials[slot] : nullptr;
+			ImGui::PushID(static_cast<int>(slot));
+			ImGui::Text("Slot %u (%s): %s", slot, _mesh->MaterialSlots[slot].c_str(), material != nullptr ? material->Name.c_str() : "Default");
+			if (ImGuiHelper::ResourceDragTarget<Gameplay::Material>(material)) {
+				SetMaterial(slot, material);
+			}
+			ImGui::PopID();
+		}
+	}
 }
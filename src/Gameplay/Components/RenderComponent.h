@@ -26,9 +26,17 @@ public:
 	/// </summary>
 	VertexArrayObject::Sptr GetMesh() const;
 	/// <summary>
-	/// Gets the material that this renderer is using
+	/// Gets the default material that this renderer is using, for any material slot that has not
+	/// been given it's own material
 	/// </summary>
 	const Gameplay::Material::Sptr& GetMaterial() const;
+	/// <summary>
+	/// Gets the material that submeshes using the given material slot are drawn with, see
+	/// VertexArrayObject::GetSubmeshes and MeshResource::MaterialSlots
+	/// </summary>
+	/// <param name="slot">The index of the material slot</param>
+	/// <returns>The slot's material, or the default material if the slot has not been given one</returns>
+	const Gameplay::Material::Sptr& GetMaterial(uint32_t slot) const;
 
 	/// <summary>
 	/// Sets this render component's mesh resource, from which the VAO will be retrieved for rendering
@@ -41,12 +49,34 @@ public:
 	/// </summary>
 	/// <param name="mat">The material for this object</param>
 	void SetMaterial(const Gameplay::Material::Sptr& mat);
+	/// <summary>
+	/// Sets the material for one of the mesh's material slots, so that the mesh can be drawn with
+	/// several materials from the same buffers
+	/// </summary>
+	/// <param name="slot">The index of the material slot</param>
+	/// <param name="mat">The material for the slot, or nullptr to use the default material</param>
+	void SetMaterial(uint32_t slot, const Gameplay::Material::Sptr& mat);
+
+	/// <summary>
+	/// Gets the level of detail that the renderer picked for this object last frame, 0 is the full
+	/// detail mesh and higher levels index into VertexArrayObject::GetLods (minus one)
+	/// </summary>
+	int GetLodLevel() const;
+	/// <summary>
+	/// Sets the level of detail to draw this object with, this is called by the renderer each frame
+	/// based on how large the object is on screen
+	/// </summary>
+	/// <param name="level">The level of detail, 0 for the full detail mesh</param>
+	void SetLodLevel(int level);
 
 	// Inherited from IComponent
 
 	virtual void RenderImGui() override;
+	virtual Gameplay::UpdateAccess GetUpdateAccess() const override { return Gameplay::UpdateAccess::Parallel(); }
 	virtual nlohmann::json ToJson() const override;
 	static RenderComponent::Sptr FromJson(const nlohmann::json& data);
+	virtual void ToBinary(BinaryWriter& writer) const override;
+	static RenderComponent::Sptr FromBinary(BinaryReader& reader);
 	MAKE_TYPENAME(RenderComponent);
 
 protected:
@@ -54,6 +84,10 @@ protected:
 	Gameplay::MeshResource::Sptr _mesh;
 	// The object's material
 	Gameplay::Material::Sptr      _material;
+	// Materials for each of the mesh's material slots, nullptr slots use _material
+	std::vector<Gameplay::Material::Sptr> _slotMaterials;
+	// The level of detail picked last frame, kept so the renderer can avoid flickering between levels
+	int                           _lodLevel;
 
 	// If we want to use MeshFactory, we can populate this list
 	std::vector<MeshBuilderParam> _meshBuilderParams;
@@ -9,6 +9,11 @@ void RotatingBehaviour::Update(float deltaTime) {
 	GetGameObject()->SetRotation(GetGameObject()->GetRotationEuler() + RotationSpeed * deltaTime);
 }
 
+Gameplay::UpdateAccess RotatingBehaviour::GetUpdateAccess() const {
+	// Only touches our own rotation
+	return Gameplay::UpdateAccess::Parallel();
+}
+
 void RotatingBehaviour::RenderImGui() {
 	LABEL_LEFT(ImGui::DragFloat3, "Speed", &RotationSpeed.x);
 }
@@ -24,3 +29,13 @@ RotatingBehaviour::Sptr RotatingBehaviour::FromJson(const nlohmann::json& data)
 	result->RotationSpeed = JsonGet(data, "speed", result->RotationSpeed);
 	return result;
 }
+
+void RotatingBehaviour::ToBinary(BinaryWriter& writer) const {
+	writer.Write(RotationSpeed);
+}
+
+RotatingBehaviour::Sptr RotatingBehaviour::FromBinary(BinaryReader& reader) {
+	RotatingBehaviour::Sptr result = std::make_shared<RotatingBehaviour>();
+	result->RotationSpeed = reader.Read<glm::vec3>();
+	return result;
+}
@@ -12,11 +12,14 @@ public:
 	glm::vec3 RotationSpeed;
 
 	virtual void Update(float deltaTime) override;
+	virtual Gameplay::UpdateAccess GetUpdateAccess() const override;
 
 	virtual void RenderImGui() override;
 
 	virtual nlohmann::json ToJson() const override;
 	static RotatingBehaviour::Sptr FromJson(const nlohmann::json& data);
+	virtual void ToBinary(BinaryWriter& writer) const override;
+	static RotatingBehaviour::Sptr FromBinary(BinaryReader& reader);
 
 	MAKE_TYPENAME(RotatingBehaviour);
 };
@@ -20,6 +20,7 @@ public:
 	virtual void OnTriggerVolumeEntered(const std::shared_ptr<Gameplay::Physics::RigidBody>& body) override;
 	virtual void OnTriggerVolumeLeaving(const std::shared_ptr<Gameplay::Physics::RigidBody>& body) override;
 	virtual void RenderImGui() override;
+	virtual Gameplay::UpdateAccess GetUpdateAccess() const override { return Gameplay::UpdateAccess::Parallel(); }
 	virtual nlohmann::json ToJson() const override;
 	static TriggerVolumeEnterBehaviour::Sptr FromJson(const nlohmann::json& blob);
 	MAKE_TYPENAME(TriggerVolumeEnterBehaviour);
@@ -14,63 +14,29 @@
 #include "Gameplay/Scene.h"
 
 namespace Gameplay {
+	// Bits of the flags byte for gameobjects in binary scenes
+	static constexpr uint8_t BinaryFlagHidden = 1 << 0;
+	static constexpr uint8_t BinaryFlagAlwaysLoaded = 1 << 1;
+
 	GameObject::GameObject() :
 		IResource(),
 		Name("Unknown"),
 		HideInHierarchy(false),
+		AlwaysLoaded(false),
+		_isStreamed(false),
+		_isPooled(false),
 		_components(std::vector<IComponent::Sptr>()),
 		_scene(nullptr),
-		_position(ZERO),
-		_rotation(glm::quat(glm::vec3(0.0f))),
-		_scale(ONE),
-		_localTransform(MAT4_IDENTITY),
-		_inverseLocalTransform(MAT4_IDENTITY),
-		_isLocalTransformDirty(true),
-		_worldTransform(MAT4_IDENTITY),
-		_inverseWorldTransform(MAT4_IDENTITY),
-		_isWorldTransformDirty(true),
+		_transform(TransformStore::InvalidHandle),
 		_parent(WeakRef()),
 		_children(std::vector<WeakRef>())
 	{ }
 
-	void GameObject::_RecalcLocalTransform() const
-	{
-		if (_isLocalTransformDirty) {
-			_localTransform = glm::translate(MAT4_IDENTITY, _position) * glm::mat4_cast(_rotation) * glm::scale(MAT4_IDENTITY, _scale);
-			_inverseLocalTransform = glm::inverse(_localTransform);
-			_isLocalTransformDirty = false;
-			_isWorldTransformDirty = true;
-
-			// Dirty all the child objects world transforms
-			for (const auto& childPtr : _children) {
-				GameObject::Sptr childSptr = childPtr;
-				if (childSptr != nullptr) {
-					childSptr->_isWorldTransformDirty = true;
-				}
-			}
-		}
-	}
-
-	void GameObject::_RecalcWorldTransform() const {
-		// Start by determining our local transform if required
-		_RecalcLocalTransform();
-
-		// If our world transform has been marked as dirty, we need to recalculate it!
-		if (_isWorldTransformDirty) {
-			GameObject::Sptr parent = _parent;
-
-			// If out parent exists, we apply our local transformation relative to the parent's world transformation
-			if (parent != nullptr) {
-				_worldTransform = parent->GetTransform() * _localTransform;
-				_inverseWorldTransform = glm::inverse(_worldTransform);
-			}
-
-			// If our parent is null, we can simply use the local transform as the world transform
-			else {
-				_worldTransform = _localTransform;
-				_inverseWorldTransform = _inverseLocalTransform;
-			}
-			_isWorldTransformDirty = false;
+	GameObject::~GameObject() {
+		// If our scene was destroyed first, the store and our handle went with it
+		std::shared_ptr<TransformStore> transforms = _transformStore.lock();
+		if (transforms != nullptr && _transform != TransformStore::InvalidHandle) {
+			transforms->Destroy(_transform);
 		}
 	}
 
@@ -82,7 +48,7 @@ namespace Gameplay {
 	}
 
 	void GameObject::LookAt(const glm::vec3& point) {
-		glm::mat4 rot = glm::lookAt(_position, point, glm::vec3(0.0f, 0.0f, 1.0f));
+		glm::mat4 rot = glm::lookAt(GetPosition(), point, glm::vec3(0.0f, 0.0f, 1.0f));
 		// Take the conjugate of the quaternion, as lookAt returns the *inverse* rotation
 		SetRotation(glm::conjugate(glm::quat_cast(rot)));
 	}
@@ -111,13 +77,15 @@ namespace Gameplay {
 		}
 	}
 
+	// The store moves transforms around as objects are created and destroyed, so the getters
+	// return copies rather than references that could be left dangling
+
 	void GameObject::SetPostion(const glm::vec3& position) {
-		_position = position;
-		_isLocalTransformDirty = true;
+		_scene->_transforms->SetPosition(_transform, position);
 	}
 
-	const glm::vec3& GameObject::GetPosition() const {
-		return _position;
+	glm::vec3 GameObject::GetPosition() const {
+		return _scene->_transforms->GetPosition(_transform);
 	}
 
 	glm::vec3 GameObject::GetWorldPosition() const {
@@ -125,51 +93,48 @@ namespace Gameplay {
 	}
 
 	void GameObject::SetRotation(const glm::quat& value) {
-		_rotation = value;
-		_isLocalTransformDirty = true;
+		_scene->_transforms->SetRotation(_transform, value);
 	}
 
-	const glm::quat& GameObject::GetRotation() const {
-		return _rotation;
+	glm::quat GameObject::GetRotation() const {
+		return _scene->_transforms->GetRotation(_transform);
 	}
 
 	void GameObject::SetRotation(const glm::vec3& eulerAngles) {
-		_rotation = glm::quat(glm::radians(eulerAngles));
-		_isLocalTransformDirty = true;
+		_scene->_transforms->SetRotation(_transform, glm::quat(glm::radians(eulerAngles)));
 	}
 
 	glm::vec3 GameObject::GetRotationEuler() const {
-		return glm::degrees(glm::eulerAngles(_rotation));
+		return glm::degrees(glm::eulerAngles(GetRotation()));
 	}
 
 	void GameObject::SetScale(const glm::vec3& value) {
-		_scale = value;
-		_isLocalTransformDirty = true;
+		_scene->_transforms->SetScale(_transform, value);
+	}
+
+	glm::vec3 GameObject::GetScale() const {
+		return _scene->_transforms->GetScale(_transform);
 	}
 
-	const glm::vec3& GameObject::GetScale() const {
-		return _scale;
+	glm::mat4 GameObject::GetTransform() const {
+		return _scene->_transforms->GetWorld(_transform);
 	}
 
-	const glm::mat4& GameObject::GetTransform() const {
-		_RecalcWorldTransform();
-		return _worldTransform;
+	glm::mat4 GameObject::GetInverseTransform() const {
+		return _scene->_transforms->GetInverseWorld(_transform);
 	}
 
-	const glm::mat4& GameObject::GetInverseTransform() const {
-		_RecalcWorldTransform();
-		return _inverseWorldTransform;
+	glm::mat4 GameObject::GetRenderTransform() const {
+		return _scene->_transforms->GetRenderWorld(_transform);
 	}
 
-	const glm::mat4& GameObject::GetLocalTransform() const
+	glm::mat4 GameObject::GetLocalTransform() const
 	{
-		_RecalcLocalTransform();
-		return _localTransform;
+		return _scene->_transforms->GetLocal(_transform);
 	}
 
-	const glm::mat4& GameObject::GetInverseLocalTransform() const {
-		_RecalcLocalTransform();
-		return _inverseLocalTransform;
+	glm::mat4 GameObject::GetInverseLocalTransform() const {
+		return _scene->_transforms->GetInverseLocal(_transform);
 	}
 
 	void GameObject::RenderGUI() {
@@ -216,8 +181,6 @@ namespace Gameplay {
 			}
 		}
 
-		_RecalcLocalTransform();
-		_RecalcWorldTransform();
 		_PurgeDeletedChildren();
 	}
 
@@ -250,12 +213,7 @@ namespace Gameplay {
 
 		// Make a new component, forwarding the arguments
 		std::shared_ptr<IComponent> component = _scene->_components.Create(type);
-		// Let the component know we are the parent
-		component->_context = this;
-
-		// Append it to the binding component's storage, and invoke the OnLoad
-		_components.push_back(component);
-		component->OnLoad();
+		_AttachComponent(component);
 
 		if (_scene->GetIsAwake()) {
 			component->Awake();
@@ -264,6 +222,15 @@ namespace Gameplay {
 		return component;
 	}
 
+	void GameObject::_AttachComponent(const IComponent::Sptr& component) {
+		// Let the component know we are the parent
+		component->_context = this;
+
+		// Append it to the binding component's storage, and invoke the OnLoad
+		_components.push_back(component);
+		component->OnLoad();
+	}
+
 	void GameObject::AddChild(const GameObject::Sptr& child) {
 		// If the object already has a parent, remove it from the other object
 		if (child->_parent != nullptr) {
@@ -279,7 +246,7 @@ namespace Gameplay {
 			// applies to the child
 			_children.push_back(child);
 			child->_parent = _selfRef.lock();
-			child->_isWorldTransformDirty = true;
+			_scene->_transforms->SetParent(child->_transform, _transform);
 		} else {
 			LOG_WARN("Attempting to add same child twice, ignoring: {}", child->Name);
 		}
@@ -292,6 +259,7 @@ namespace Gameplay {
 		if (it != _children.end()) { 
 			// Clear the object's parent and remove from our list of children
 			child->_parent.Reset();
+			_scene->_transforms->SetParent(child->_transform, TransformStore::InvalidHandle);
 			_children.erase(it);
 			return true;
 		} else {
@@ -353,17 +321,20 @@ namespace Gameplay {
 				ImGui::EndPopup();
 			}
 
-			// Render position label
-			_isLocalTransformDirty |= LABEL_LEFT(ImGui::DragFloat3, "Position", &_position.x, 0.01f);
+			// Render position label, the store owns the value so we edit a copy
+			glm::vec3 position = GetPosition();
+			if (LABEL_LEFT(ImGui::DragFloat3, "Position", &position.x, 0.01f)) {
+				SetPostion(position);
+			}
 			
 			// Get the ImGui storage state so we can avoid gimbal locking issues by storing euler angles in the editor
 			glm::vec3 euler = GetRotationEuler();
 			ImGuiStorage* guiStore = ImGui::GetStateStorage();
 
-			// Extract the angles from the storage, note that we're only using the address of the position for unique IDs
-			euler.x = guiStore->GetFloat(ImGui::GetID(&_position.x), euler.x);
-			euler.y = guiStore->GetFloat(ImGui::GetID(&_position.y), euler.y);
-			euler.z = guiStore->GetFloat(ImGui::GetID(&_position.z), euler.z);
+			// Extract the angles from the storage, we're already in this object's ID scope so names are unique
+			euler.x = guiStore->GetFloat(ImGui::GetID("EulerX"), euler.x);
+			euler.y = guiStore->GetFloat(ImGui::GetID("EulerY"), euler.y);
+			euler.z = guiStore->GetFloat(ImGui::GetID("EulerZ"), euler.z);
 
 			//Draw the slider for angles
 			if (LABEL_LEFT(ImGui::DragFloat3, "Rotation", &euler.x, 1.0f)) {
@@ -371,16 +342,21 @@ namespace Gameplay {
 				euler = Wrap(euler, -180.0f, 180.0f);
 
 				// Update the editor state with our new values
-				guiStore->SetFloat(ImGui::GetID(&_position.x), euler.x);
-				guiStore->SetFloat(ImGui::GetID(&_position.y), euler.y);
-				guiStore->SetFloat(ImGui::GetID(&_position.z), euler.z);
+				guiStore->SetFloat(ImGui::GetID("EulerX"), euler.x);
+				guiStore->SetFloat(ImGui::GetID("EulerY"), euler.y);
+				guiStore->SetFloat(ImGui::GetID("EulerZ"), euler.z);
 
 				//Send new rotation to the gameobject
 				SetRotation(euler);
 			}
 			
 			// Draw the scale
-			_isLocalTransformDirty |= LABEL_LEFT(ImGui::DragFloat3, "Scale   ", &_scale.x, 0.01f, 0.0f);
+			glm::vec3 scale = GetScale();
+			if (LABEL_LEFT(ImGui::DragFloat3, "Scale   ", &scale.x, 0.01f, 0.0f)) {
+				SetScale(scale);
+			}
+
+			ImGui::Checkbox("Always Loaded", &AlwaysLoaded);
 
 			ImGui::Separator();
 			ImGui::TextUnformatted("Components");
@@ -438,10 +414,6 @@ namespace Gameplay {
 			ImGui::Unindent();
 		}
 		ImGui::PopID(); // Pop the ImGui ID scope for the object
-
-		// For if we're not in play mode
-		_RecalcLocalTransform();
-		_RecalcWorldTransform();
 	}
 
 	std::shared_ptr<GameObject> GameObject::SelfRef() {
@@ -454,17 +426,18 @@ namespace Gameplay {
 		// protected. We can call it here since Scene is a friend class of GameObjects
 		GameObject::Sptr result(new GameObject());
 		result->_scene = scene;
+		result->_transform = scene->_transforms->Create();
+		result->_transformStore = scene->_transforms;
 
 		// Load in basic info
 		result->Name = data["name"];
 		result->_guid = Guid(data["guid"]);
 		result->_parent = WeakRef(Guid(data.contains("parent") ? data["parent"] : "null"), nullptr);
-		result->_position = (data["position"]);
-		result->_rotation = (data["rotation"]);
-		result->_scale    = (data["scale"]);
+		result->SetPostion((glm::vec3)(data["position"]));
+		result->SetRotation((glm::quat)(data["rotation"]));
+		result->SetScale((glm::vec3)(data["scale"]));
 		result->HideInHierarchy = JsonGet(data, "hide_in_inspector", false);
-		result->_isLocalTransformDirty = true;
-		result->_isWorldTransformDirty = true;
+		result->AlwaysLoaded = JsonGet(data, "always_loaded", false);
 
 		// Since our components are stored based on the type name, we iterate
 		// on the keys and values from the components object
@@ -484,16 +457,48 @@ namespace Gameplay {
 		return result;
 	}
 
+	GameObject::Sptr GameObject::FromBinary(Scene* scene, BinaryReader& reader)
+	{
+		GameObject::Sptr result(new GameObject());
+		result->_scene = scene;
+		result->_transform = scene->_transforms->Create();
+		result->_transformStore = scene->_transforms;
+
+		result->Name = std::string(reader.ReadString());
+		result->_guid = reader.ReadGuid();
+		result->_parent = WeakRef(reader.ReadGuid(), nullptr);
+		result->SetPostion(reader.Read<glm::vec3>());
+		result->SetRotation(reader.Read<glm::quat>());
+		result->SetScale(reader.Read<glm::vec3>());
+		uint8_t flags = reader.Read<uint8_t>();
+		result->HideInHierarchy = (flags & BinaryFlagHidden) != 0;
+		result->AlwaysLoaded = (flags & BinaryFlagAlwaysLoaded) != 0;
+
+		return result;
+	}
+
+	void GameObject::ToBinary(BinaryWriter& writer) const {
+		GameObject::Sptr parent = _parent;
+		writer.WriteString(Name);
+		writer.WriteGuid(_guid);
+		writer.WriteGuid(parent == nullptr ? Guid() : parent->_guid);
+		writer.Write(GetPosition());
+		writer.Write(GetRotation());
+		writer.Write(GetScale());
+		writer.Write<uint8_t>((HideInHierarchy ? BinaryFlagHidden : 0) | (AlwaysLoaded ? BinaryFlagAlwaysLoaded : 0));
+	}
+
 	nlohmann::json GameObject::ToJson() const {
 		GameObject::Sptr parent = _parent;
 		nlohmann::json result = {
 			{ "name", Name },
 			{ "guid", _guid.str() },
-			{ "position", _position },
-			{ "rotation", _rotation },
-			{ "scale",    _scale },
+			{ "position", GetPosition() },
+			{ "rotation", GetRotation() },
+			{ "scale",    GetScale() },
 			{ "parent",   parent == nullptr ? "null" : parent->_guid.str() },
-			{ "hide_in_inspector", HideInHierarchy }
+			{ "hide_in_inspector", HideInHierarchy },
+			{ "always_loaded", AlwaysLoaded }
 		};
 		result["components"] = nlohmann::json();
 		for (auto& component : _components) {
@@ -557,25 +562,25 @@ namespace Gameplay {
 		// If we already determined the value is null, return null now
 		if (isNull) { return nullptr; }
 
-		// If the Ptr is uninitialized, try and look up the object in the scene
-		if (GetIsEmpty()) {
-			// We need a reference to the scene in order to search gameobjects :pensive:
-			if (SceneContext != nullptr) {
-				GameObject::Sptr result = SceneContext->FindObjectByGUID(ResourceGUID);
-				Ptr = result;
-				isNull = result == nullptr;
-				return result;
-			}
-			// If there's no scene, return null
-			else {
-				isNull = true;
-				return nullptr;
-			}
+		// If we've already found the object and it's still around, we're done
+		GameObject::Sptr result = Ptr.lock();
+		if (result != nullptr) {
+			return result;
 		}
-		// We've looked up the weak ptr, try and lock it
-		else {
-			return Ptr.lock();
+
+		// If the Ptr is uninitialized or the object has gone away, try and look up the object
+		// in the scene. Objects in streamed scenes can come and go, so we keep trying
+		if (SceneContext != nullptr) {
+			result = SceneContext->FindObjectByGUID(ResourceGUID);
+			Ptr = result;
+			isNull = !ResourceGUID.isValid();
+			return result;
+		}
+		// If there's no scene and we never had an object, the reference is null
+		else if (GetIsEmpty()) {
+			isNull = true;
 		}
+		return nullptr;
 	}
 
 	bool GameObject::WeakRef::GetIsEmpty() const {
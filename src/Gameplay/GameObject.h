@@ -12,6 +12,7 @@
 #include "Gameplay/Components/IComponent.h"
 #include "Gameplay/Components/ComponentManager.h"
 #include "Utils/ResourceManager/IResource.h"
+#include "Gameplay/TransformStore.h"
 
 class InspectorWindow;
 class HierarchyWindow;
@@ -34,9 +35,14 @@ namespace Gameplay {
 		typedef std::shared_ptr<GameObject> Sptr;
 		typedef std::weak_ptr<GameObject> Wptr;
 
+		virtual ~GameObject();
+
 		/// <summary>
 		/// Structure to assist in wrapping weak references to GameObjects
 		/// Can track the object's GUID before and after creation
+		/// 
+		/// References are resolved lazily, and are looked up again if the object goes away, so
+		/// references to objects in streaming cells will find the object once it's cell loads
 		/// </summary>
 		struct WeakRef {
 		protected:
@@ -139,6 +145,10 @@ namespace Gameplay {
 		// Hack to hide instances from the hierarchy (like when adding lots of instances)
 		bool HideInHierarchy = false;
 
+		// For streamed scenes, keeps this object (and it's children) in the scene itself rather
+		// than in a streaming cell, use for things that move around the world like the player
+		bool AlwaysLoaded = false;
+
 		/// <summary>
 		/// Rotates this object to look at the given point in world coordinates
 		/// </summary>
@@ -178,7 +188,7 @@ namespace Gameplay {
 		/// <summary>
 		/// Gets the object's position in world space
 		/// </summary>
-		const glm::vec3& GetPosition() const;
+		glm::vec3 GetPosition() const;
 
 		glm::vec3 GetWorldPosition() const;
 
@@ -190,7 +200,7 @@ namespace Gameplay {
 		/// <summary>
 		/// Gets the object's rotation as a quaternion value
 		/// </summary>
-		const glm::quat& GetRotation() const;
+		glm::quat GetRotation() const;
 
 		/// <summary>
 		/// Sets the rotation of the object in euler degrees (yaw, pitch, roll)
@@ -210,21 +220,27 @@ namespace Gameplay {
 		/// <summary>
 		/// Gets the scaling factor for the game object
 		/// </summary>
-		const glm::vec3& GetScale() const;
+		glm::vec3 GetScale() const;
 
 		/// <summary>
 		/// Gets or recalculates and gets the object's world transform
 		/// This matrix transforms points from local space to world space
 		/// </summary>
-		const glm::mat4& GetTransform() const;
+		glm::mat4 GetTransform() const;
 		/// <summary>
 		/// Gets or recalculates the inverse of this object's world transform
 		/// This matrix transforms points from world space to local space
 		/// </summary>
-		const glm::mat4& GetInverseTransform() const;
+		glm::mat4 GetInverseTransform() const;
+
+		/// <summary>
+		/// Gets the object's world transform interpolated between the last two simulation
+		/// ticks, this should only be used for rendering
+		/// </summary>
+		glm::mat4 GetRenderTransform() const;
 
-		const glm::mat4& GetLocalTransform() const;
-		const glm::mat4& GetInverseLocalTransform() const;
+		glm::mat4 GetLocalTransform() const;
+		glm::mat4 GetInverseLocalTransform() const;
 
 		/// <summary>
 		/// Allows components to render GUI elements to the screen
@@ -334,26 +350,26 @@ namespace Gameplay {
 		/// </summary>
 		nlohmann::json ToJson() const;
 
+		/// <summary>
+		/// Loads a game object (without it's components) from a binary scene, components
+		/// are stored seperately grouped by type (see Scene::SaveBinary)
+		/// </summary>
+		static GameObject::Sptr FromBinary(Scene* scene, BinaryReader& reader);
+		/// <summary>
+		/// Writes this object (without it's components) to a binary scene
+		/// </summary>
+		void ToBinary(BinaryWriter& writer) const;
+
 	private:
 		friend class Scene;
+		friend class Prefab;
 		friend class InspectorWindow;
 		friend class HierarchyWindow;
 
-		// Rotation of the object as a quaternion
-		glm::quat _rotation;
-		// Position of the object
-		glm::vec3 _position;
-		// The scale of the object
-		glm::vec3 _scale;
-
-		// The object's world transform
-		mutable glm::mat4 _localTransform;
-		mutable glm::mat4 _inverseLocalTransform;
-		mutable bool _isLocalTransformDirty;
-
-		mutable glm::mat4 _worldTransform;
-		mutable glm::mat4 _inverseWorldTransform;
-		mutable bool _isWorldTransformDirty;
+		// Handle to our position, rotation, scale and matrices in the scene's transform store
+		TransformStore::Handle _transform;
+		// The store that owns our handle, objects can outlive their scene so we can't go through _scene to release it
+		std::weak_ptr<TransformStore> _transformStore;
 
 		// For the hierarchy
 		WeakRef _parent;
@@ -368,16 +384,22 @@ namespace Gameplay {
 		// or load, we don't need to worry about ref counting
 		Scene* _scene;
 
+		// True if this object was loaded from a streaming cell, these are saved with the cell
+		// instead of with the scene
+		bool _isStreamed;
+		// True while this object is sitting unused in a PrefabPool, the scene won't update it
+		bool _isPooled;
+
 		/// <summary>
 		/// Only scenes will be allowed to create gameobjects
 		/// </summary>
 		GameObject();
 
-		// Recalculates the transform matrix for the object when required
-		void _RecalcLocalTransform() const;
-		void _RecalcWorldTransform() const;
-
 		void _PurgeDeletedChildren();
+
+		// Attaches an already created component to this object and invokes OnLoad,
+		// does not invoke Awake
+		void _AttachComponent(const IComponent::Sptr& component);
 	};
 
 }
\ No newline at end of file
@@ -11,6 +11,13 @@ std::wstring InputEngine::__inputText = LR"()";
 
 ButtonState InputEngine::__mouseState[GLFW_MOUSE_BUTTON_LAST + 1];
 ButtonState InputEngine::__keyState[GLFW_KEY_LAST + 1];
+uint8_t InputEngine::__keyEdges[GLFW_KEY_LAST + 1];
+uint8_t InputEngine::__mouseEdges[GLFW_MOUSE_BUTTON_LAST + 1];
+InputEngine::TickInput InputEngine::__tickInput;
+
+// True while the current thread is running a simulation tick, and should read the sampled tick input.
+// Thread local since a pipelined simulation runs on a worker while the main thread handles the frame
+static thread_local bool IsInTick = false;
 
 void InputEngine::Init(GLFWwindow* window)
 {
@@ -22,30 +29,35 @@ void InputEngine::Init(GLFWwindow* window)
 }
 
 ButtonState InputEngine::GetKeyState(int keyCode) {
-	return (keyCode <= GLFW_KEY_LAST) ? __keyState[keyCode] : ButtonState::Up;
+	const ButtonState* keys = IsInTick ? __tickInput.Keys : __keyState;
+	return (keyCode <= GLFW_KEY_LAST) ? keys[keyCode] : ButtonState::Up;
 }
 
 ButtonState InputEngine::GetMouseState(int button)
 {
-	return (button <= GLFW_MOUSE_BUTTON_LAST) ? __mouseState[button] : ButtonState::Up;
+	const ButtonState* mouse = IsInTick ? __tickInput.Mouse : __mouseState;
+	return (button <= GLFW_MOUSE_BUTTON_LAST) ? mouse[button] : ButtonState::Up;
 }
 
 bool InputEngine::IsKeyDown(int keyCode) {
-	return (keyCode <= GLFW_KEY_LAST) ? *__keyState[keyCode] & 0b01 : false;
+	return *GetKeyState(keyCode) & 0b01;
 }
 
 bool InputEngine::IsMouseButtonDown(int button) {
-	return (button <= GLFW_MOUSE_BUTTON_LAST) ? *__mouseState[button] & 0b01 : false;
+	return *GetMouseState(button) & 0b01;
 }
 
-const glm::dvec2& InputEngine::GetMousePos() {
+glm::dvec2 InputEngine::GetMousePos() {
+	if (IsInTick) {
+		return __tickInput.MousePos;
+	}
 	Application& app = Application::Get();
 	glm::vec4 viewport = app.GetPrimaryViewport();
 	return (__mousePos - glm::dvec2(viewport.x, viewport.y));
 }
 
 glm::dvec2 InputEngine::GetMouseDelta() {
-	return __mousePos - __prevMousePos;
+	return IsInTick ? __tickInput.MouseDelta : __mousePos - __prevMousePos;
 }
 
 void InputEngine::SetCursorMode(CursorMode mode) {
@@ -79,6 +91,62 @@ void InputEngine::EndFrame() {
 	}
 }
 
+void InputEngine::SampleTickInput() {
+	for (int ix = 0; ix < GLFW_KEY_LAST + 1; ix++) {
+		__tickInput.KeysDown[ix] = *__keyState[ix] & 0b01;
+		__tickInput.Keys[ix] = __TickButtonState(__keyEdges[ix], __tickInput.KeysDown[ix]);
+		__keyEdges[ix] = 0;
+	}
+	for (int ix = 0; ix < GLFW_MOUSE_BUTTON_LAST + 1; ix++) {
+		__tickInput.MouseDown[ix] = *__mouseState[ix] & 0b01;
+		__tickInput.Mouse[ix] = __TickButtonState(__mouseEdges[ix], __tickInput.MouseDown[ix]);
+		__mouseEdges[ix] = 0;
+	}
+
+	// The mouse has moved since the last tick, not the last frame
+	glm::dvec2 mousePos = GetMousePos();
+	__tickInput.MouseDelta = mousePos - __tickInput.MousePos;
+	__tickInput.MousePos = mousePos;
+}
+
+void InputEngine::BeginTick() {
+	IsInTick = true;
+}
+
+void InputEngine::EndTick() {
+	IsInTick = false;
+	for (int ix = 0; ix < GLFW_KEY_LAST + 1; ix++) {
+		__tickInput.Keys[ix] = __AgeTickButtonState(__tickInput.Keys[ix], __tickInput.KeysDown[ix]);
+	}
+	for (int ix = 0; ix < GLFW_MOUSE_BUTTON_LAST + 1; ix++) {
+		__tickInput.Mouse[ix] = __AgeTickButtonState(__tickInput.Mouse[ix], __tickInput.MouseDown[ix]);
+	}
+	__tickInput.MouseDelta = glm::dvec2(0.0);
+}
+
+ButtonState InputEngine::__TickButtonState(uint8_t edges, bool isDown) {
+	// A press wins over a release, so a key that was tapped within a frame still gets pressed
+	if (edges & 0b01) {
+		return ButtonState::Pressed;
+	}
+	if (edges & 0b10) {
+		return ButtonState::Released;
+	}
+	return isDown ? ButtonState::Down : ButtonState::Up;
+}
+
+ButtonState InputEngine::__AgeTickButtonState(ButtonState state, bool isDown) {
+	switch (state) {
+		// A key that was tapped within a frame is already up again, so the next tick sees it released
+		case ButtonState::Pressed:
+			return isDown ? ButtonState::Down : ButtonState::Released;
+		case ButtonState::Released:
+			return ButtonState::Up;
+		default:
+			return state;
+	}
+}
+
 
 void InputEngine::__KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
 	if (key == GLFW_KEY_UNKNOWN)
@@ -87,9 +155,11 @@ void InputEngine::__KeyCallback(GLFWwindow* window, int key, int scancode, int a
 	switch (action) {
 		case GLFW_PRESS:
 			__keyState[key] = ButtonState::Pressed;
+			__keyEdges[key] |= 0b01;
 			break;
 		case GLFW_RELEASE:
 			__keyState[key] = ButtonState::Released;
+			__keyEdges[key] |= 0b10;
 			break;
 		default:
 			break;
@@ -106,8 +176,10 @@ void InputEngine::__MouseButtonCallback(GLFWwindow* window, int button, int acti
 
 	if (action == GLFW_PRESS) {
 		__mouseState[button] = ButtonState::Pressed;
+		__mouseEdges[button] |= 0b01;
 	} else if (action == GLFW_RELEASE) {
 		__mouseState[button] = ButtonState::Released;
+		__mouseEdges[button] |= 0b10;
 	}
 }
 
@@ -2,6 +2,7 @@
 
 #include <GLM/glm.hpp>
 #include <string>
+#include <cstdint>
 #include <EnumToString.h>
 #include "GLFW/glfw3.h"
 
@@ -18,6 +19,15 @@ ENUM(CursorMode, int,
 	 Hidden   = GLFW_CURSOR_HIDDEN
 );
 
+/// <summary>
+/// Tracks the keyboard and mouse state for the application
+///
+/// Code that runs once per frame sees presses and releases for the frame that they happened
+/// in. Simulation ticks (see Application::_Simulate) may run zero or several times a frame,
+/// so they read from a copy of the input that is sampled on the main thread before the ticks
+/// run. Presses and releases are held until a tick runs, and are only seen by the first tick
+/// after they happened, so a tap is never dropped or seen twice
+/// </summary>
 class InputEngine {
 public:
 	static void Init(GLFWwindow* window);
@@ -28,7 +38,7 @@ public:
 	static bool IsKeyDown(int keyCode);
 	static bool IsMouseButtonDown(int button);
 
-	static const glm::dvec2& GetMousePos();
+	static glm::dvec2 GetMousePos();
 	static glm::dvec2 GetMouseDelta();
 
 	static void SetCursorMode(CursorMode mode);
@@ -38,6 +48,22 @@ public:
 
 	static void EndFrame();
 
+	/// <summary>
+	/// Copies the current input for the simulation ticks that are about to run, consuming any
+	/// presses and releases that have not been seen by a tick yet. Must be called on the main
+	/// thread, and only when at least one tick will run
+	/// </summary>
+	static void SampleTickInput();
+	/// <summary>
+	/// Makes the calling thread read from the sampled tick input until EndTick is called
+	/// </summary>
+	static void BeginTick();
+	/// <summary>
+	/// Ends a simulation tick, so that the presses and releases in the sampled input are not
+	/// seen again by the next tick
+	/// </summary>
+	static void EndTick();
+
 private:
 	static GLFWwindow*  __window;
 	static ButtonState  __keyState[GLFW_KEY_LAST + 1];
@@ -47,6 +73,27 @@ private:
 	static glm::dvec2   __scrollDelta;
 	static std::wstring __inputText;
 
+	// Presses and releases that have not been sampled for a tick yet, bit 0 for a press and bit 1 for a release
+	static uint8_t      __keyEdges[GLFW_KEY_LAST + 1];
+	static uint8_t      __mouseEdges[GLFW_MOUSE_BUTTON_LAST + 1];
+
+	// The input that simulation ticks read from, see SampleTickInput
+	struct TickInput {
+		ButtonState Keys[GLFW_KEY_LAST + 1];
+		ButtonState Mouse[GLFW_MOUSE_BUTTON_LAST + 1];
+		// Whether each button was down when the input was sampled, for ticks after the first
+		bool        KeysDown[GLFW_KEY_LAST + 1];
+		bool        MouseDown[GLFW_MOUSE_BUTTON_LAST + 1];
+		glm::dvec2  MousePos;
+		glm::dvec2  MouseDelta;
+	};
+	static TickInput    __tickInput;
+
+	// Works out the state that the first tick should see for a button, from it's edges and whether it's down now
+	static ButtonState __TickButtonState(uint8_t edges, bool isDown);
+	// Moves a button on to the state that the next tick should see
+	static ButtonState __AgeTickButtonState(ButtonState state, bool isDown);
+
 	static void __KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
 	static void __CharCallback(GLFWwindow* window, uint32_t keycode);
 	static void __MouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
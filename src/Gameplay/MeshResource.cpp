@@ -1,15 +1,118 @@
 #include "MeshResource.h"
 #include <filesystem>
+#include <mutex>
+#include <sstream>
+#include <iomanip>
+#include <unordered_map>
+#include <btBulletCollisionCommon.h>
 
 #include "Utils/ObjLoader.h"
+#include "Utils/OptimizedObjLoader.h"
+#include "Utils/FileHelpers.h"
+#include "Utils/MeshOptimizer.h"
+#include "Utils/MeshSimplifier.h"
+#include "Application/Application.h"
 
 namespace Gameplay {
+	typedef MeshBuilder<VertexPosNormTexColTangents> Builder;
+
+	// Bump this whenever MeshFactory, MeshSimplifier or MeshOptimizer change the meshes they make, so that
+	// generated meshes in the cache are made again
+	static constexpr uint32_t GeneratorVersion = 1;
+	// The folder that generated meshes are cached in, named after their GetParamsKey
+	static const std::string generatedCacheFolder = "cache/meshes/";
+
+	// The generated meshes that are in use, by their GetParamsKey. This holds GL objects so it's only used on the main thread
+	static std::unordered_map<uint64_t, std::weak_ptr<VertexArrayObject>> generatedMeshes;
+	// Workers generating identical meshes would otherwise write the same cache file at the same time
+	static std::mutex cacheWriteMutex;
+
+	// Names a generated mesh after the shapes it's made of, so we can tell them apart in the log
+	static std::string DescribeParams(const std::vector<MeshBuilderParam>& params) {
+		std::string result = "";
+		for (const MeshBuilderParam& param : params) {
+			result += (result.empty() ? "" : " + ") + std::string(~param.Type);
+		}
+		return result;
+	}
+
+	static std::string GetCachePath(uint64_t key) {
+		std::stringstream stream;
+		stream << generatedCacheFolder << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+		return stream.str();
+	}
+
+	// Builds a mesh from it's parameters, and saves it to the cache. Failing to write the cache isn't
+	// a problem, the mesh will just be generated again next time. Tangents are split between jobs if it's not null
+	static void GenerateParameterized(Builder& mesh, const std::vector<MeshBuilderParam>& params, uint64_t key, JobSystem* jobs) {
+		for (const MeshBuilderParam& param : params) {
+			MeshFactory::AddParameterized(mesh, param);
+		}
+		MeshFactory::CalculateTBN(mesh, jobs);
+		MeshSimplifier::GenerateLods(mesh, DescribeParams(params));
+		MeshOptimizer::Optimize(mesh, DescribeParams(params));
+
+		if (mesh.GetVertexCount() > 0) {
+			std::lock_guard<std::mutex> lock(cacheWriteMutex);
+			try {
+				std::filesystem::create_directories(generatedCacheFolder);
+				OptimizedObjLoader::SaveBinaryFile(mesh, GetCachePath(key));
+			} catch (const std::exception& e) {
+				LOG_WARN("Failed to cache generated mesh \"{}\": {}", DescribeParams(params), e.what());
+			}
+		}
+	}
+
+	// Loads an OBJ file with levels of detail and the triangles in cache order, the same as OptimizedObjLoader
+	// bakes it. Meant for loading the OBJ directly, so these are worked out again every time it's loaded
+	static Builder LoadObjMesh(const std::string& filename, JobSystem* jobs, std::vector<std::string>* materialSlots) {
+		Builder mesh = ObjLoader::LoadMeshFromFile(filename, true, jobs, materialSlots);
+		MeshSimplifier::GenerateLods(mesh, filename);
+		MeshOptimizer::Optimize(mesh, filename);
+		return mesh;
+	}
+
+	// Gets the VAO for a generated mesh, sharing it with any other resource that has the same parameters. If
+	// generated is null, the mesh is loaded from the cache, or generated if it's not there. Must be called on the main thread
+	static VertexArrayObject::Sptr GetGeneratedMesh(const std::vector<MeshBuilderParam>& params, uint64_t key, Builder* generated) {
+		auto it = generatedMeshes.find(key);
+		if (it != generatedMeshes.end()) {
+			VertexArrayObject::Sptr shared = it->second.lock();
+			if (shared != nullptr) {
+				return shared;
+			}
+		}
+
+		VertexArrayObject::Sptr result = nullptr;
+		std::string cachePath = GetCachePath(key);
+		if (generated == nullptr && std::filesystem::exists(cachePath)) {
+			result = OptimizedObjLoader::LoadFromFile(cachePath);
+			if (result != nullptr) {
+				LOG_TRACE("Loaded generated mesh \"{}\" from \"{}\"", DescribeParams(params), cachePath);
+			}
+		}
+		// The cache was missing or invalid, so we'll have to generate it after all
+		if (result == nullptr) {
+			Builder mesh;
+			if (generated == nullptr) {
+				GenerateParameterized(mesh, params, key, &Application::Get().Jobs());
+				generated = &mesh;
+			}
+			result = generated->Bake();
+		}
+
+		generatedMeshes[key] = result;
+		return result;
+	}
+
 	MeshResource::MeshResource() :
 		IResource(),
 		Filename(""),
 		MeshBuilderParams(std::vector<MeshBuilderParam>()),
 		Mesh(nullptr),
-		BulletTriMesh(nullptr)
+		MaterialSlots(std::vector<std::string>()),
+		BulletTriMesh(nullptr),
+		_generatedKey(0)
 	{ }
 
 	MeshResource::MeshResource(const std::string& filename) :
@@ -17,9 +120,17 @@ namespace Gameplay {
 		Filename(filename),
 		MeshBuilderParams(std::vector<MeshBuilderParam>()),
 		Mesh(nullptr),
-		BulletTriMesh(nullptr)
+		MaterialSlots(std::vector<std::string>()),
+		BulletTriMesh(nullptr),
+		_generatedKey(0)
 	{
-		Mesh = ObjLoader::LoadFromFile(filename);
+		#ifdef OPTIMIZED_OBJ_LOADER
+		OptimizedObjLoader::MeshInfo info;
+		Mesh = OptimizedObjLoader::LoadFromFile(filename, &info, &Application::Get().Jobs());
+		MaterialSlots = std::move(info.MaterialSlots);
+		#else
+		Mesh = LoadObjMesh(filename, &Application::Get().Jobs(), &MaterialSlots).Bake();
+		#endif
 	}
 
 	MeshResource::~MeshResource() = default;
@@ -39,40 +150,130 @@ namespace Gameplay {
 		return result;
 	}
 
+	ResourceMemoryUsage MeshResource::GetMemoryUsage() const {
+		ResourceMemoryUsage result = { 0, 0 };
+		if (Mesh != nullptr) {
+			// Generated meshes belong to their cache entry, which every resource with the same parameters
+			// shares, so the resource manager should count them once rather than once per resource
+			auto it = _generatedKey != 0 ? generatedMeshes.find(_generatedKey) : generatedMeshes.end();
+			if (it != generatedMeshes.end() && it->second.lock() == Mesh) {
+				result.Shared = Mesh->GetGpuMemoryUsage();
+				result.SharedKey = _generatedKey;
+			} else {
+				result.Gpu += Mesh->GetGpuMemoryUsage();
+			}
+		}
+		// Bullet keeps it's own copy of the triangles for colliders
+		if (BulletTriMesh != nullptr) {
+			const IndexedMeshArray& parts = BulletTriMesh->getIndexedMeshArray();
+			for (int ix = 0; ix < parts.size(); ix++) {
+				result.Cpu += (size_t)parts[ix].m_numVertices * parts[ix].m_vertexStride;
+				result.Cpu += (size_t)parts[ix].m_numTriangles * parts[ix].m_triangleIndexStride;
+			}
+		}
+		if (ColliderMeshData != nullptr && ColliderMeshData.get() != this) {
+			ResourceMemoryUsage collider = ColliderMeshData->GetMemoryUsage();
+			result.Cpu += collider.Cpu;
+			result.Gpu += collider.Gpu;
+		}
+		return result;
+	}
+
+	bool MeshResource::CanReload() const {
+		// Collider meshes are not saved in the manifest, so we would lose them
+		return ColliderMeshData == nullptr && (!MeshBuilderParams.empty() || (!Filename.empty() && Filename != "null"));
+	}
+
+	std::string MeshResource::GetContentKey(const std::string& filename) {
+		uint64_t hash = FileHelpers::HashFile(filename);
+		return hash != 0 ? std::to_string(hash) : "";
+	}
+
+	uint64_t MeshResource::GetParamsKey(const std::vector<MeshBuilderParam>& params) {
+		// Changes to how meshes are generated or stored make the old cache files out of date
+		uint16_t binaryVersion = OptimizedObjLoader::GetBinaryVersion();
+		uint64_t hash = FileHelpers::HashData(&GeneratorVersion, sizeof(GeneratorVersion));
+		hash = FileHelpers::HashData(&binaryVersion, sizeof(binaryVersion), hash);
+		for (const MeshBuilderParam& param : params) {
+			// Include the terminator, so that the boundaries between parameters are part of the key
+			std::string json = param.ToJson().dump();
+			hash = FileHelpers::HashData(json.c_str(), json.size() + 1, hash);
+		}
+		return hash;
+	}
+
 	MeshResource::Sptr MeshResource::FromJson(const nlohmann::json & blob)
 	{
 		MeshResource::Sptr result = std::make_shared<MeshResource>();
 		if (blob.contains("params") && blob["params"].is_array()) {
 			std::vector<nlohmann::json> meshbuilderParams = blob["params"].get<std::vector<nlohmann::json>>();
-			MeshBuilder<VertexPosNormTexColTangents> mesh;
 			for (int ix = 0; ix < meshbuilderParams.size(); ix++) {
-				MeshBuilderParam p = MeshBuilderParam::FromJson(meshbuilderParams[ix]);
-				result->MeshBuilderParams.push_back(p);
-				MeshFactory::AddParameterized(mesh, p);
+				result->MeshBuilderParams.push_back(MeshBuilderParam::FromJson(meshbuilderParams[ix]));
 			}
-			MeshFactory::CalculateTBN(mesh);
-			result->Mesh = mesh.Bake();
+			result->GenerateMesh();
 		} else {
 			result->Filename = JsonGet<std::string>(blob, "filename", "null");
 			if (result->Filename != "null" && std::filesystem::exists(result->Filename)) {
 				#ifdef OPTIMIZED_OBJ_LOADER
-				result->Mesh = OptimizedObjLoader::LoadFromFile(result->Filename);
+				OptimizedObjLoader::MeshInfo info;
+				result->Mesh = OptimizedObjLoader::LoadFromFile(result->Filename, &info, &Application::Get().Jobs());
+				result->MaterialSlots = std::move(info.MaterialSlots);
 				#else
-				result->Mesh = ObjLoader::LoadFromFile(result->Filename);
+				result->Mesh = LoadObjMesh(result->Filename, &Application::Get().Jobs(), &result->MaterialSlots).Bake();
 				#endif
-
 			}
 		}
 		return result;
 	}
 
-	void MeshResource::GenerateMesh() {
-		MeshBuilder<VertexPosNormTexColTangents> mesh;
-		for (auto& param : MeshBuilderParams) {
-			MeshFactory::AddParameterized(mesh, param);
+	std::function<MeshResource::Sptr()> MeshResource::PrepareFromJson(const nlohmann::json& blob, JobSystem* jobs)
+	{
+		std::shared_ptr<Builder> mesh = nullptr;
+		std::vector<MeshBuilderParam> params;
+		std::vector<std::string> materialSlots;
+		std::string filename = "";
+		uint64_t paramsKey = 0;
+		if (blob.contains("params") && blob["params"].is_array()) {
+			for (const auto& param : blob["params"]) {
+				params.push_back(MeshBuilderParam::FromJson(param));
+			}
+			// Cached meshes go straight to OpenGL when they're loaded, so we only generate the ones that aren't cached
+			paramsKey = GetParamsKey(params);
+			if (!std::filesystem::exists(GetCachePath(paramsKey))) {
+				mesh = std::make_shared<Builder>();
+				GenerateParameterized(*mesh, params, paramsKey, jobs);
+			}
+		} else {
+			filename = JsonGet<std::string>(blob, "filename", "null");
+			#ifdef OPTIMIZED_OBJ_LOADER
+			// The optimized loader goes straight to OpenGL, so it has to run on the main thread
+			return [blob]() { return FromJson(blob); };
+			#else
+			if (filename != "null" && std::filesystem::exists(filename)) {
+				// We're already on a worker, but large files still get split between the preloader's other workers
+				mesh = std::make_shared<Builder>(LoadObjMesh(filename, jobs, &materialSlots));
+			}
+			#endif
 		}
-		MeshFactory::CalculateTBN(mesh);
-		Mesh = mesh.Bake();
+
+		return [mesh, params, materialSlots, filename, paramsKey]() {
+			MeshResource::Sptr result = std::make_shared<MeshResource>();
+			result->MeshBuilderParams = params;
+			result->MaterialSlots = materialSlots;
+			result->Filename = filename;
+			if (!params.empty()) {
+				result->Mesh = GetGeneratedMesh(params, paramsKey, mesh.get());
+				result->_generatedKey = paramsKey;
+			} else if (mesh != nullptr) {
+				result->Mesh = mesh->Bake();
+			}
+			return result;
+		};
+	}
+
+	void MeshResource::GenerateMesh() {
+		_generatedKey = GetParamsKey(MeshBuilderParams);
+		Mesh = GetGeneratedMesh(MeshBuilderParams, _generatedKey, nullptr);
 	}
 
 	void MeshResource::AddParam(const MeshBuilderParam & param) {
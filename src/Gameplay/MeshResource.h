@@ -1,4 +1,6 @@
 #pragma once
+#include <functional>
+
 #include "Utils/ResourceManager/IResource.h"
 #include "Graphics/VertexArrayObject.h"
 #include "Utils/MeshFactory.h"
@@ -40,6 +42,11 @@ namespace Gameplay {
 		/// The VAO for rendering this mesh in OpenGL
 		/// </summary>
 		VertexArrayObject::Sptr         Mesh;
+		/// <summary>
+		/// The names of the material slots used by the mesh's submeshes (ex: the usemtl names from an
+		/// OBJ file), see VertexArrayObject::GetSubmeshes and RenderComponent::SetMaterial
+		/// </summary>
+		std::vector<std::string>        MaterialSlots;
 
 
 		/// <summary>
@@ -52,7 +59,9 @@ namespace Gameplay {
 		std::shared_ptr<btTriangleMesh> BulletTriMesh;
 
 		/// <summary>
-		/// Generates a new mesh from the mesh builder parameters
+		/// Generates a new mesh from the mesh builder parameters. Resources with identical parameters
+		/// share the same VAO, and generated meshes are cached on disk so later runs can load them
+		/// instead of generating them again (see GetParamsKey)
 		/// </summary>
 		void GenerateMesh();
 		/// <summary>
@@ -64,6 +73,33 @@ namespace Gameplay {
 		// Inherited from IResource
 
 		virtual nlohmann::json ToJson() const override;
+		virtual ResourceMemoryUsage GetMemoryUsage() const override;
+		virtual bool CanReload() const override;
 		static MeshResource::Sptr FromJson(const nlohmann::json& blob);
+
+		/// <summary>
+		/// Loads or generates the mesh data on the calling thread, and returns a function that
+		/// must be invoked on the main thread to send it to OpenGL (see ResourceManager::PrepareLoad)
+		/// </summary>
+		/// <param name="blob">The manifest entry for the mesh</param>
+		/// <param name="jobs">The job system to split large meshes between, or nullptr to do all the work on the calling thread</param>
+		static std::function<MeshResource::Sptr()> PrepareFromJson(const nlohmann::json& blob, JobSystem* jobs);
+
+		/// <summary>
+		/// Gets a key that identifies the mesh that would be loaded from the given file, based on
+		/// the file's contents (see ResourceManager::CreateAsset)
+		/// </summary>
+		/// <returns>The key for the mesh, or an empty string if the file could not be read</returns>
+		static std::string GetContentKey(const std::string& filename);
+
+		/// <summary>
+		/// Gets a key that identifies the mesh generated from a list of mesh builder parameters, based on
+		/// their JSON representation. Identical parameter lists always have the same key
+		/// </summary>
+		static uint64_t GetParamsKey(const std::vector<MeshBuilderParam>& params);
+
+	protected:
+		// The GetParamsKey of the generated mesh that Mesh was shared from, or 0 if it wasn't generated
+		uint64_t _generatedKey;
 	};
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "Gameplay/MeshResource.h"
 #include "Gameplay/Components/RenderComponent.h"
 
+#include "Graphics/VertexCompression.h"
 #include "Utils/GlmBulletConversions.h"
 
 namespace Gameplay::Physics {
@@ -111,6 +112,17 @@ namespace Gameplay::Physics {
 					}
 				};
 
+				// Helper for extracting a position from a raw vertex buffer datastore, compressed positions
+				// are stored relative to the mesh's bounds (see VertexCompression)
+				bool isCompressed = posAttrib.Type == AttributeType::UShort && posAttrib.Normalized;
+				auto getPosition = [&](uint8_t* dataStore, size_t vertex) {
+					uint8_t* data = dataStore + (posAttrib.Stride * vertex) + posAttrib.Offset;
+					if (isCompressed) {
+						return VertexCompression::DecodePosition(reinterpret_cast<uint16_t*>(data), vao->GetBoundsMin(), vao->GetBoundsMax());
+					}
+					return *reinterpret_cast<glm::vec3*>(data);
+				};
+
 				// Allocate some space to read data from OpenGL and read our buffer data back into CPU memory
 				uint8_t* vertexStore = reinterpret_cast<uint8_t*>(malloc(vertexBuff->GetTotalSize()));
 				glGetNamedBufferSubData(vertexBuff->GetHandle(), 0, vertexBuff->GetTotalSize(), vertexStore);
@@ -130,9 +142,9 @@ namespace Gameplay::Physics {
 						int i3 = getBufferIndex(indexBuff, indexStore, static_cast<int>(ix + 2));
 
 						// Find the positions for the indices
-						glm::vec3 p1 = *reinterpret_cast<glm::vec3*>(vertexStore + (posAttrib.Stride * i1) + posAttrib.Offset);
-						glm::vec3 p2 = *reinterpret_cast<glm::vec3*>(vertexStore + (posAttrib.Stride * i2) + posAttrib.Offset);
-						glm::vec3 p3 = *reinterpret_cast<glm::vec3*>(vertexStore + (posAttrib.Stride * i3) + posAttrib.Offset);
+						glm::vec3 p1 = getPosition(vertexStore, i1);
+						glm::vec3 p2 = getPosition(vertexStore, i2);
+						glm::vec3 p3 = getPosition(vertexStore, i3);
 
 						// Add the triangle
 						_triMesh->addTriangle(ToBt(p1), ToBt(p2), ToBt(p3));
@@ -146,9 +158,9 @@ namespace Gameplay::Physics {
 				else {
 					// Iterate over triangles, and add each to the mesh
 					for (size_t ix = 0; ix < vertexBuff->GetElementCount(); ix+=3) {
-						glm::vec3 p1 = *reinterpret_cast<glm::vec3*>(vertexStore + ((ix + 0) * posAttrib.Stride) + posAttrib.Offset);
-						glm::vec3 p2 = *reinterpret_cast<glm::vec3*>(vertexStore + ((ix + 1) * posAttrib.Stride) + posAttrib.Offset);
-						glm::vec3 p3 = *reinterpret_cast<glm::vec3*>(vertexStore + ((ix + 2) * posAttrib.Stride) + posAttrib.Offset);
+						glm::vec3 p1 = getPosition(vertexStore, ix + 0);
+						glm::vec3 p2 = getPosition(vertexStore, ix + 1);
+						glm::vec3 p3 = getPosition(vertexStore, ix + 2);
 						_triMesh->addTriangle(ToBt(p1), ToBt(p2), ToBt(p3));
 					}
 				}
@@ -18,7 +18,8 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 		_isShapeDirty(true),
 		_collisionGroup(0x01),
 		_collisionMask(0xFFFFFFFF),
-		_prevScale(glm::vec3(1.0f))
+		_prevScale(glm::vec3(1.0f)),
+		_isInWorld(false)
 	{ }
 
 	PhysicsBase::~PhysicsBase() {
@@ -138,6 +139,27 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 		return _collisionMask;
 	}
 
+	void PhysicsBase::SetInWorld(bool value) {
+		// Before Awake there's no bullet object yet, it gets added when it's created
+		if (value == _isInWorld || _scene == nullptr) {
+			return;
+		}
+		if (value) {
+			_AddToWorld();
+		} else {
+			_RemoveFromWorld();
+		}
+		_isInWorld = value;
+	}
+
+	bool PhysicsBase::IsInWorld() const {
+		return _isInWorld;
+	}
+
+	void PhysicsBase::OnUnload() {
+		SetInWorld(false);
+	}
+
 	ICollider::Sptr PhysicsBase::AddCollider(const ICollider::Sptr& collider) {
 		if (_scene != nullptr) {
 			collider->Awake(GetGameObject());
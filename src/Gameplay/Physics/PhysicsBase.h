@@ -1,6 +1,7 @@
 #pragma once
 #include "Gameplay/Components/IComponent.h"
 #include "Gameplay/Physics/ICollider.h"
+#include "Utils/Macros.h"
 
 class btTransform;
 
@@ -15,6 +16,8 @@ namespace Gameplay {
 		class PhysicsBase : public IComponent {
 		public:
 			typedef std::shared_ptr<PhysicsBase> Sptr;
+			// Physics components own bullet objects, so they can't be shallow copied
+			NO_COPY(PhysicsBase);
 			virtual ~PhysicsBase();
 
 			/// <summary>
@@ -70,6 +73,18 @@ namespace Gameplay {
 			void RemoveCollider(const ICollider::Sptr& collider);
 
 
+			/// <summary>
+			/// Adds or removes this object's bullet body from the physics world. A removed body keeps
+			/// all of it's state, but won't collide or trigger anything until it's added back
+			/// (ex: when an object is returned to a PrefabPool). Does nothing before Awake
+			/// </summary>
+			/// <param name="value">True to add the body to the world, false to remove it</param>
+			void SetInWorld(bool value);
+			/// <summary>
+			/// Returns true if this object's bullet body is in the physics world
+			/// </summary>
+			bool IsInWorld() const;
+
 			/// <summary>
 			/// Invoked for each RigidBody before the physics world is stepped forward a frame,
 			/// handles body initialization, shape changes, mass changes, etc...
@@ -83,6 +98,12 @@ namespace Gameplay {
 			/// <param name="dt">The time in seconds since the last frame</param>
 			virtual void PhysicsPostStep(float dt) = 0;
 
+			// Takes our body out of the physics world, see SetInWorld
+			virtual void OnUnload() override;
+
+			// Physics bodies do their work in the physics steps, not in Update
+			virtual UpdateAccess GetUpdateAccess() const override { return UpdateAccess::Parallel(); }
+
 			// Delete awake to ensure derived classes override it
 
 			virtual void Awake() = 0;
@@ -103,6 +124,9 @@ namespace Gameplay {
 
 			glm::vec3 _prevScale;
 
+			// True while our bullet object is in the physics world, set by Awake and SetInWorld
+			bool _isInWorld;
+
 			PhysicsBase();
 
 			void _RenderImGuiBase();
@@ -125,6 +149,10 @@ namespace Gameplay {
 			// Gets the bullet broadphase proxy that we can use for clearing collisions
 			virtual btBroadphaseProxy* _GetBroadphaseHandle() = 0;
 
+			// Adds or removes our bullet object from the physics world, only called once the object exists
+			virtual void _AddToWorld() = 0;
+			virtual void _RemoveFromWorld() = 0;
+
 			static int _editorSelectedColliderType;
 		};
 	}
@@ -32,8 +32,10 @@ namespace Gameplay::Physics {
 
 	RigidBody::~RigidBody() {
 		if (_body != nullptr) {
-			// Remove from the physics world
-			_scene->GetPhysicsWorld()->removeRigidBody(_body);
+			// Remove from the physics world, unless we've already been taken out of it
+			if (_isInWorld) {
+				_scene->GetPhysicsWorld()->removeRigidBody(_body);
+			}
 
 			// Clean up all our memory
 			delete _motionState;
@@ -223,6 +225,7 @@ namespace Gameplay::Physics {
 		_body->setUserPointer(&SelfRef());
 
 		_scene->GetPhysicsWorld()->addRigidBody(_body);
+		_isInWorld = true;
 
 		// If the object is kinematic (driven by a controller), tell bullet that
 		if (_type == RigidBodyType::Kinematic) {
@@ -338,6 +341,21 @@ namespace Gameplay::Physics {
 		}
 	}
 
+	void RigidBody::_AddToWorld() {
+		// Start from wherever the gameobject is now, rather than where the body was removed
+		btTransform transform;
+		_CopyGameobjectTransformTo(transform);
+		_body->setWorldTransform(transform);
+		_motionState->setWorldTransform(transform);
+		_body->clearForces();
+
+		_scene->GetPhysicsWorld()->addRigidBody(_body, _collisionGroup, _collisionMask);
+	}
+
+	void RigidBody::_RemoveFromWorld() {
+		_scene->GetPhysicsWorld()->removeRigidBody(_body);
+	}
+
 	btBroadphaseProxy* RigidBody::_GetBroadphaseHandle() {
 		return _body != nullptr ? _body->getBroadphaseProxy() : nullptr;
 	}
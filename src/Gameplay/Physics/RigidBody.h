@@ -202,5 +202,7 @@ namespace Gameplay::Physics {
 		void _HandleStateDirty();
 
 		virtual btBroadphaseProxy* _GetBroadphaseHandle() override;
+		virtual void _AddToWorld() override;
+		virtual void _RemoveFromWorld() override;
 	};
 }
\ No newline at end of file
@@ -18,7 +18,9 @@ namespace Gameplay::Physics {
 
 	TriggerVolume::~TriggerVolume() {
 		if (_ghost != nullptr) {
-			_scene->GetPhysicsWorld()->removeCollisionObject(_ghost);
+			if (_isInWorld) {
+				_scene->GetPhysicsWorld()->removeCollisionObject(_ghost);
+			}
 			delete _ghost;
 		}
 	}
@@ -169,7 +171,8 @@ namespace Gameplay::Physics {
 
 		// Add the object to the scene
 		_scene->GetPhysicsWorld()->addCollisionObject(_ghost);
-		
+		_isInWorld = true;
+
 		// Copy over group and mask info
 		_ghost->getBroadphaseHandle()->m_collisionFilterGroup = _collisionGroup;
 		_ghost->getBroadphaseHandle()->m_collisionFilterMask  = _collisionMask;
@@ -191,6 +194,19 @@ namespace Gameplay::Physics {
 		return result;
 	}
 
+	void TriggerVolume::_AddToWorld() {
+		btTransform transform;
+		_CopyGameobjectTransformTo(transform);
+		_ghost->setWorldTransform(transform);
+		_scene->GetPhysicsWorld()->addCollisionObject(_ghost, _collisionGroup, _collisionMask);
+	}
+
+	void TriggerVolume::_RemoveFromWorld() {
+		_scene->GetPhysicsWorld()->removeCollisionObject(_ghost);
+		// Anything that was inside will have to enter again once we're added back
+		_currentCollisions.clear();
+	}
+
 	btBroadphaseProxy* TriggerVolume::_GetBroadphaseHandle() {
 		return _ghost != nullptr ? _ghost->getBroadphaseHandle() : nullptr;
 	}
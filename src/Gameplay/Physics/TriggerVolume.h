@@ -57,6 +57,8 @@ namespace Gameplay::Physics {
 		std::vector<std::weak_ptr<RigidBody>> _currentCollisions;
 
 		virtual btBroadphaseProxy* _GetBroadphaseHandle() override;
+		virtual void _AddToWorld() override;
+		virtual void _RemoveFromWorld() override;
 
 	};
 }
\ No newline at end of file
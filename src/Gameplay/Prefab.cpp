@@ -0,0 +1,341 @@
+#include "Gameplay/Prefab.h"
+
+#include "Utils/JsonGlmHelpers.h"
+#include "Utils/GlmDefines.h"
+
+#include "Gameplay/Scene.h"
+#include "Gameplay/Physics/PhysicsBase.h"
+
+namespace Gameplay {
+	Prefab::Prefab() :
+		IResource(),
+		Name(""),
+		_nodes(std::vector<Node>())
+	{ }
+
+	Prefab::~Prefab() = default;
+
+	Prefab::Sptr Prefab::FromGameObject(const GameObject::Sptr& root) {
+		Prefab::Sptr result = std::make_shared<Prefab>();
+		result->Name = root->Name;
+		result->_AddNodeFromObject(root, -1);
+		return result;
+	}
+
+	GameObject::Sptr Prefab::Instantiate(Scene* scene) const {
+		std::vector<GameObject::Sptr> objects;
+		_Instantiate(scene, objects);
+		return objects.empty() ? nullptr : objects[0];
+	}
+
+	void Prefab::_Instantiate(Scene* scene, std::vector<GameObject::Sptr>& objects) const {
+		objects.reserve(_nodes.size());
+
+		for (const Node& node : _nodes) {
+			GameObject::Sptr object = scene->CreateGameObject(node.Name);
+			object->SetPostion(node.Position);
+			object->SetRotation(node.Rotation);
+			object->SetScale(node.Scale);
+			object->HideInHierarchy = node.HideInHierarchy;
+
+			// Parents always precede children, so the parent has already been created
+			if (node.Parent >= 0) {
+				objects[node.Parent]->AddChild(object);
+			}
+
+			object->_components.reserve(node.Components.size());
+			for (const ComponentTemplate& data : node.Components) {
+				IComponent::Sptr component = _CreateComponent(scene, data);
+				if (component != nullptr) {
+					object->_AttachComponent(component);
+				}
+			}
+
+			objects.push_back(object);
+		}
+
+		// We wait until the whole hierarchy exists before waking, so components
+		// can find their siblings and children
+		if (scene->GetIsAwake()) {
+			for (const auto& object : objects) {
+				object->Awake();
+			}
+		}
+	}
+
+	void Prefab::_Reset(std::vector<GameObject::Sptr>& objects) const {
+		LOG_ASSERT(objects.size() == _nodes.size(), "Instance does not match the prefab's hierarchy!");
+
+		for (size_t ix = 0; ix < _nodes.size(); ix++) {
+			const Node& node = _nodes[ix];
+			const GameObject::Sptr& object = objects[ix];
+			Scene* scene = object->GetScene();
+
+			object->SetPostion(node.Position);
+			object->SetRotation(node.Rotation);
+			object->SetScale(node.Scale);
+			object->HideInHierarchy = node.HideInHierarchy;
+
+			// If components were added or removed since the instance was created, rebuild them all
+			bool matches = object->_components.size() == node.Components.size();
+			for (size_t iy = 0; matches && iy < node.Components.size(); iy++) {
+				matches = object->_components[iy]->ComponentTypeName() == node.Components[iy].TypeName;
+			}
+
+			if (!matches) {
+				for (const auto& component : object->_components) {
+					_Teardown(component);
+				}
+				object->_components.clear();
+				for (const ComponentTemplate& data : node.Components) {
+					IComponent::Sptr component = _CreateComponent(scene, data);
+					if (component != nullptr) {
+						object->_AttachComponent(component);
+					}
+				}
+			} else {
+				for (size_t iy = 0; iy < node.Components.size(); iy++) {
+					const ComponentTemplate& data = node.Components[iy];
+					// Copyable components just have their state overwritten in place
+					if (data.Instance != nullptr && ComponentManager::CopyState(*object->_components[iy], *data.Instance)) {
+						continue;
+					}
+
+					// Otherwise we need to replace the component with a fresh one
+					IComponent::Sptr replacement = _CreateComponent(scene, data);
+					if (replacement == nullptr) {
+						LOG_WARN("Failed to reset component \"{}\" on prefab instance \"{}\", keeping the old one", data.TypeName, object->Name);
+						continue;
+					}
+					_Teardown(object->_components[iy]);
+					replacement->_context = object.get();
+					object->_components[iy] = replacement;
+					replacement->OnLoad();
+				}
+			}
+		}
+
+		// Copying state will overwrite any references that components resolve in
+		// Awake, so let them look them up again
+		for (const auto& object : objects) {
+			if (object->GetScene()->GetIsAwake()) {
+				object->Awake();
+			}
+		}
+	}
+
+	void Prefab::_Activate(std::vector<GameObject::Sptr>& objects) {
+		for (const auto& object : objects) {
+			object->_isPooled = false;
+		}
+
+		// Components that were replaced by _Reset add their own bodies in Awake, this puts
+		// back any that were kept from before the instance was released
+		for (const auto& object : objects) {
+			for (const auto& component : object->_components) {
+				Physics::PhysicsBase* physics = dynamic_cast<Physics::PhysicsBase*>(component.get());
+				if (physics != nullptr && physics->IsEnabled) {
+					physics->SetInWorld(true);
+				}
+			}
+		}
+	}
+
+	void Prefab::_Deactivate(std::vector<GameObject::Sptr>& objects) {
+		for (const auto& object : objects) {
+			object->HideInHierarchy = true;
+			object->_isPooled = true;
+			for (const auto& component : object->_components) {
+				_Teardown(component);
+			}
+		}
+	}
+
+	void Prefab::_Teardown(const IComponent::Sptr& component) {
+		// Disabled bodies still collide, so components need to let go of anything they put in the scene
+		component->IsEnabled = false;
+		component->OnUnload();
+	}
+
+	IComponent::Sptr Prefab::_CreateComponent(Scene* scene, const ComponentTemplate& data) {
+		if (data.Instance != nullptr) {
+			return scene->Components().Clone(*data.Instance);
+		}
+
+		IComponent::Sptr result = scene->Components().Load(data.TypeName, data.Blob);
+		// The blob stores the template's GUID, so make sure every instance is unique
+		if (result != nullptr) {
+			result->OverrideGUID(Guid::New());
+		}
+		return result;
+	}
+
+	void Prefab::_AddNodeFromObject(const GameObject::Sptr& object, int parent) {
+		Node node;
+		node.Name = object->Name;
+		node.Position = object->GetPosition();
+		node.Rotation = object->GetRotation();
+		node.Scale = object->GetScale();
+		node.HideInHierarchy = object->HideInHierarchy;
+		node.Parent = parent;
+
+		for (const auto& component : object->_components) {
+			ComponentTemplate data;
+			data.TypeName = component->ComponentTypeName();
+			data.Instance = ComponentManager::CloneDetached(*component);
+			if (data.Instance == nullptr) {
+				data.Blob = component->ToJson();
+				IComponent::SaveBaseJson(component, data.Blob);
+			}
+			node.Components.push_back(data);
+		}
+
+		int index = static_cast<int>(_nodes.size());
+		_nodes.push_back(node);
+
+		for (const auto& child : object->GetChildren()) {
+			GameObject::Sptr childPtr = child;
+			if (childPtr != nullptr) {
+				_AddNodeFromObject(childPtr, index);
+			}
+		}
+	}
+
+	void Prefab::_AddNodeFromJson(const nlohmann::json& blob, int parent) {
+		Node node;
+		node.Name = JsonGet<std::string>(blob, "name", "Unknown");
+		node.Position = JsonGet(blob, "position", ZERO_3);
+		node.Rotation = JsonGet(blob, "rotation", glm::quat(glm::vec3(0.0f)));
+		node.Scale = JsonGet(blob, "scale", ONE_3);
+		node.HideInHierarchy = JsonGet(blob, "hide_in_inspector", false);
+		node.Parent = parent;
+
+		if (blob.contains("components") && blob["components"].is_object()) {
+			for (auto& [typeName, value] : blob["components"].items()) {
+				ComponentTemplate data;
+				data.TypeName = typeName;
+
+				// Parse the component once up front, and only keep the JSON around if we can't copy it
+				IComponent::Sptr component = ComponentManager::LoadDetached(typeName, value);
+				if (component == nullptr) {
+					LOG_WARN("Prefab \"{}\" contains unknown component type \"{}\", ignoring", Name, typeName);
+					continue;
+				}
+				if (ComponentManager::CanCopy(component->_realType)) {
+					data.Instance = component;
+				} else {
+					data.Blob = value;
+				}
+				node.Components.push_back(data);
+			}
+		}
+
+		int index = static_cast<int>(_nodes.size());
+		_nodes.push_back(node);
+
+		if (blob.contains("children") && blob["children"].is_array()) {
+			for (auto& child : blob["children"]) {
+				_AddNodeFromJson(child, index);
+			}
+		}
+	}
+
+	nlohmann::json Prefab::_NodeToJson(int index) const {
+		const Node& node = _nodes[index];
+		nlohmann::json result = {
+			{ "name", node.Name },
+			{ "position", node.Position },
+			{ "rotation", node.Rotation },
+			{ "scale",    node.Scale },
+			{ "hide_in_inspector", node.HideInHierarchy }
+		};
+		result["components"] = nlohmann::json::object();
+		for (const ComponentTemplate& data : node.Components) {
+			if (data.Instance != nullptr) {
+				result["components"][data.TypeName] = data.Instance->ToJson();
+				IComponent::SaveBaseJson(data.Instance, result["components"][data.TypeName]);
+			} else {
+				result["components"][data.TypeName] = data.Blob;
+			}
+		}
+		result["children"] = std::vector<nlohmann::json>();
+		for (int ix = index + 1; ix < _nodes.size(); ix++) {
+			if (_nodes[ix].Parent == index) {
+				result["children"].push_back(_NodeToJson(ix));
+			}
+		}
+		return result;
+	}
+
+	nlohmann::json Prefab::ToJson() const {
+		return {
+			{ "name", Name },
+			{ "root", _nodes.empty() ? nlohmann::json() : _NodeToJson(0) }
+		};
+	}
+
+	Prefab::Sptr Prefab::FromJson(const nlohmann::json& blob) {
+		Prefab::Sptr result = std::make_shared<Prefab>();
+		result->Name = JsonGet<std::string>(blob, "name", "");
+		if (blob.contains("root") && blob["root"].is_object()) {
+			result->_AddNodeFromJson(blob["root"], -1);
+		}
+		return result;
+	}
+
+	PrefabPool::PrefabPool(const Prefab::Sptr& prefab, Scene* scene, int initialSize) :
+		_prefab(prefab),
+		_scene(scene),
+		_instances(std::vector<Instance>()),
+		_free(std::vector<size_t>()),
+		_lookup(std::unordered_map<const GameObject*, size_t>())
+	{
+		for (int ix = 0; ix < initialSize; ix++) {
+			size_t index = _CreateInstance();
+			Release(_instances[index].Objects[0]);
+		}
+	}
+
+	PrefabPool::~PrefabPool() = default;
+
+	GameObject::Sptr PrefabPool::Spawn() {
+		// No free instances, make a new one
+		if (_free.empty()) {
+			size_t index = _CreateInstance();
+			return _instances[index].Objects[0];
+		}
+
+		size_t index = _free.back();
+		_free.pop_back();
+
+		Instance& instance = _instances[index];
+		_prefab->_Reset(instance.Objects);
+		Prefab::_Activate(instance.Objects);
+		instance.IsActive = true;
+		return instance.Objects[0];
+	}
+
+	bool PrefabPool::Release(const GameObject::Sptr& root) {
+		auto it = _lookup.find(root.get());
+		if (it == _lookup.end() || !_instances[it->second].IsActive) {
+			return false;
+		}
+
+		Instance& instance = _instances[it->second];
+		Prefab::_Deactivate(instance.Objects);
+		instance.IsActive = false;
+		_free.push_back(it->second);
+		return true;
+	}
+
+	size_t PrefabPool::_CreateInstance() {
+		Instance instance;
+		_prefab->_Instantiate(_scene, instance.Objects);
+		instance.IsActive = true;
+
+		size_t index = _instances.size();
+		_lookup[instance.Objects[0].get()] = index;
+		_instances.push_back(instance);
+		return index;
+	}
+}
@@ -0,0 +1,142 @@
+#pragma once
+#include <unordered_map>
+
+#include "Utils/ResourceManager/IResource.h"
+#include "Gameplay/GameObject.h"
+
+namespace Gameplay {
+	class Scene;
+	class PrefabPool;
+
+	/// <summary>
+	/// A prefab stores a pre-parsed template of a gameobject hierarchy that can be
+	/// instantiated into a scene many times. Components that can be copied (see
+	/// ComponentManager::CanCopy) are instantiated by copying the template state
+	/// directly, all others are loaded from a cached JSON blob
+	/// </summary>
+	class Prefab : public IResource {
+	public:
+		typedef std::shared_ptr<Prefab> Sptr;
+
+		// Human readable name for the prefab
+		std::string Name;
+
+		Prefab();
+		virtual ~Prefab();
+
+		/// <summary>
+		/// Creates a new prefab template from an existing gameobject and all of it's children
+		/// </summary>
+		/// <param name="root">The object to use as the root of the template</param>
+		static Prefab::Sptr FromGameObject(const GameObject::Sptr& root);
+
+		/// <summary>
+		/// Creates a new instance of this prefab in the given scene. If the scene is
+		/// already awake, Awake will be invoked on all new components once the whole
+		/// hierarchy has been created
+		/// </summary>
+		/// <param name="scene">The scene to create the objects in</param>
+		/// <returns>The root gameobject of the new instance</returns>
+		GameObject::Sptr Instantiate(Scene* scene) const;
+
+		/// <summary>
+		/// Gets the number of gameobjects that are created for each instance of this prefab
+		/// </summary>
+		int NumObjects() const { return static_cast<int>(_nodes.size()); }
+
+		// Inherited from IResource
+
+		virtual nlohmann::json ToJson() const override;
+		static Prefab::Sptr FromJson(const nlohmann::json& blob);
+
+	protected:
+		friend class PrefabPool;
+
+		struct ComponentTemplate {
+			std::string      TypeName;
+			// Detached copy of the component state, or nullptr if the type can't be copied
+			IComponent::Sptr Instance;
+			// The JSON data to load the component from when it can't be copied
+			nlohmann::json   Blob;
+		};
+
+		struct Node {
+			std::string Name;
+			glm::vec3   Position;
+			glm::quat   Rotation;
+			glm::vec3   Scale;
+			bool        HideInHierarchy;
+			// Index of the parent node, -1 for the root. Parents always precede their children
+			int         Parent;
+			std::vector<ComponentTemplate> Components;
+		};
+
+		std::vector<Node> _nodes;
+
+		void _Instantiate(Scene* scene, std::vector<GameObject::Sptr>& objects) const;
+		void _Reset(std::vector<GameObject::Sptr>& objects) const;
+		static void _Activate(std::vector<GameObject::Sptr>& objects);
+		static void _Deactivate(std::vector<GameObject::Sptr>& objects);
+		// Disables a component and invokes OnUnload, for components that are being released or thrown away
+		static void _Teardown(const IComponent::Sptr& component);
+
+		static IComponent::Sptr _CreateComponent(Scene* scene, const ComponentTemplate& data);
+
+		void _AddNodeFromObject(const GameObject::Sptr& object, int parent);
+		void _AddNodeFromJson(const nlohmann::json& blob, int parent);
+		nlohmann::json _NodeToJson(int index) const;
+	};
+
+	/// <summary>
+	/// Recycles instances of a prefab within a scene. Released instances have all of
+	/// their components disabled and unloaded (removing their physics bodies from the
+	/// world), are skipped by the scene's update, and are reset to the prefab's template
+	/// state the next time they are spawned
+	///
+	/// Instances that are spawned from a pool should be returned via Release instead
+	/// of Scene::RemoveGameObject
+	/// </summary>
+	class PrefabPool {
+	public:
+		typedef std::shared_ptr<PrefabPool> Sptr;
+
+		/// <summary>
+		/// Creates a new pool for the given prefab
+		/// </summary>
+		/// <param name="prefab">The prefab to create instances of</param>
+		/// <param name="scene">The scene that instances will be created in</param>
+		/// <param name="initialSize">The number of instances to create up front</param>
+		PrefabPool(const Prefab::Sptr& prefab, Scene* scene, int initialSize = 0);
+		~PrefabPool();
+
+		/// <summary>
+		/// Gets a free instance from the pool, or creates a new instance if none are free
+		/// </summary>
+		/// <returns>The root object of the instance</returns>
+		GameObject::Sptr Spawn();
+		/// <summary>
+		/// Returns an instance to the pool, disabling all of it's components
+		/// </summary>
+		/// <param name="root">The root object of an instance returned by Spawn</param>
+		/// <returns>True if the object was from this pool and has been released</returns>
+		bool Release(const GameObject::Sptr& root);
+
+		int NumActive() const { return static_cast<int>(_instances.size() - _free.size()); }
+		int NumFree() const { return static_cast<int>(_free.size()); }
+
+	protected:
+		struct Instance {
+			std::vector<GameObject::Sptr> Objects;
+			bool IsActive;
+		};
+
+		Prefab::Sptr _prefab;
+		Scene*       _scene;
+
+		std::vector<Instance> _instances;
+		std::vector<size_t>   _free;
+		std::unordered_map<const GameObject*, size_t> _lookup;
+
+		size_t _CreateInstance();
+	};
+}
@@ -3,8 +3,13 @@
 #include <GLFW/glfw3.h>
 #include <locale>
 #include <codecvt>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <unordered_set>
 
 #include "Utils/FileHelpers.h"
+#include "Utils/MappedFile.h"
 #include "Utils/GlmBulletConversions.h"
 
 #include "Gameplay/Physics/RigidBody.h"
@@ -18,9 +23,43 @@
 #include "Application/Application.h"
 
 namespace Gameplay {
+	// Minimum number of objects to update in a single job, smaller runs are updated inline
+	static constexpr size_t ParallelUpdateGrain = 256;
+
+	// Identifies binary scene files ("BSCN"), and the version of the layout they were written with.
+	// Bump the version whenever the layout changes, files from other versions fall back to JSON
+	static constexpr uint32_t BinarySceneMagic = 0x4E435342;
+	static constexpr uint32_t BinarySceneVersion = 2;
+
+	// Fixed size header at the start of a binary scene, offsets are from the start of the file
+	//
+	// The string table is a list of length-prefixed strings, and the GUID table is a packed
+	// array of 16 byte GUIDs. The body holds the scene settings, then a record per gameobject,
+	// then a block per component type. Each block stores it's size so that blocks for types
+	// that are no longer registered can be skipped
+	struct BinarySceneHeader {
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t StringTableOffset;
+		uint32_t StringCount;
+		uint32_t GuidTableOffset;
+		uint32_t GuidCount;
+		uint32_t BodyOffset;
+		uint32_t BodySize;
+	};
+
+	// True once a load step that has handled at least one item has run past it's deadline, so that
+	// a step never overruns the budget by more than one item, and still moves forward when it starts late
+	static bool LoadStepOutOfTime(size_t handled, Scene::LoadDeadline deadline) {
+		return handled > 0 && std::chrono::steady_clock::now() >= deadline;
+	}
+
 	Scene::Scene() :
+		_transforms(std::make_shared<TransformStore>()),
 		_objects(std::vector<GameObject::Sptr>()),
 		_deletionQueue(std::vector<std::weak_ptr<GameObject>>()),
+		_objectLookup(std::unordered_map<Guid, GameObject::Wptr>()),
+		_streaming(StreamingSettings()),
 		IsPlaying(false),
 		MainCamera(nullptr),
 		DefaultMaterial(nullptr),
@@ -46,7 +85,10 @@ namespace Gameplay {
 		_skyboxShader = nullptr;
 		_skyboxMesh = nullptr;
 		_skyboxTexture = nullptr;
+		// Objects that are still referenced elsewhere hold a weak pointer to the transform store,
+		// so they won't try to release their handles once it's gone
 		_objects.clear();
+		_objectLookup.clear();
 		_CleanupPhysics();
 	}
 
@@ -95,11 +137,18 @@ namespace Gameplay {
 		GameObject::Sptr result(new GameObject());
 		result->Name = name;
 		result->_scene = this;
+		result->_transform = _transforms->Create();
+		result->_transformStore = _transforms;
 		result->_selfRef = result;
-		_objects.push_back(result);
+		_AddObject(result);
 		return result;
 	}
 
+	void Scene::_AddObject(const GameObject::Sptr& object) {
+		_objects.push_back(object);
+		_objectLookup[object->_guid] = object;
+	}
+
 	void Scene::RemoveGameObject(const GameObject::Sptr& object) {
 		_deletionQueue.push_back(object);
 	}
@@ -112,10 +161,8 @@ namespace Gameplay {
 	}
 
 	GameObject::Sptr Scene::FindObjectByGUID(Guid id) const {
-		auto it = std::find_if(_objects.begin(), _objects.end(), [&](const GameObject::Sptr& obj) {
-			return obj->_guid == id;
-		});
-		return it == _objects.end() ? nullptr : *it;
+		auto it = _objectLookup.find(id);
+		return it == _objectLookup.end() ? nullptr : it->second.lock();
 	}
 
 	void Scene::SetAmbientLight(const glm::vec3& value) {
@@ -127,27 +174,121 @@ namespace Gameplay {
 	}
 
 	void Scene::Awake() {
-		// Not a huge fan of this, but we need to get window size to notify our camera
-		// of the current screen size
-		Application& app = Application::Get();
-		glm::ivec2 windowSize = app.GetWindowSize();
-		if (MainCamera != nullptr) {
-			MainCamera->ResizeWindow(windowSize.x, windowSize.y);
-		}
+		std::deque<LoadStep> steps;
+		_QueueAwake(steps);
+		_RunSteps(steps);
+	}
 
-		if (_skyboxMesh == nullptr) {
-			_skyboxMesh = ResourceManager::CreateAsset<MeshResource>();
-			_skyboxMesh->AddParam(MeshBuilderParam::CreateCube(glm::vec3(0.0f), glm::vec3(1.0f)));
-			_skyboxMesh->AddParam(MeshBuilderParam::CreateInvert());
-			_skyboxMesh->GenerateMesh();
-		}
+	void Scene::_QueueLoadObjects(const std::weak_ptr<Scene>& scene, const std::shared_ptr<const nlohmann::json>& objects, bool isStreamed,
+		std::deque<LoadStep>& steps, const std::shared_ptr<std::vector<GameObject::Wptr>>& loaded)
+	{
+		// Keep the new objects around until they've all been linked up and woken up
+		std::shared_ptr<std::vector<GameObject::Sptr>> created = std::make_shared<std::vector<GameObject::Sptr>>();
+		created->reserve(objects->size());
+
+		std::shared_ptr<size_t> next = std::make_shared<size_t>(0);
+		steps.push_back([scene, objects, isStreamed, created, next, loaded](float& progress, LoadDeadline deadline) {
+			Scene::Sptr result = scene.lock();
+			if (result == nullptr) {
+				return LoadStepResult::Failed;
+			}
 
-		// Call awake on all gameobjects
-		for (auto& obj : _objects) {
-			obj->Awake();
-		}
+			for (size_t handled = 0; *next < objects->size() && !LoadStepOutOfTime(handled, deadline); (*next)++, handled++) {
+				GameObject::Sptr obj = GameObject::FromJson(result.get(), (*objects)[*next]);
+				obj->_scene = result.get();
+				obj->_parent.SceneContext = result.get();
+				obj->_selfRef = obj;
+				obj->_isStreamed = isStreamed;
+				result->_AddObject(obj);
+				created->push_back(obj);
+				if (loaded != nullptr) {
+					loaded->push_back(obj);
+				}
+			}
+			if (*next < objects->size()) {
+				progress = static_cast<float>(*next) / objects->size();
+				return LoadStepResult::Continue;
+			}
+
+			// Re-build the parent hierarchy 
+			for (const auto& object : *created) {
+				if (object->GetParent() != nullptr) {
+					object->GetParent()->AddChild(object);
+				}
+			}
+
+			*next = 0;
+			return LoadStepResult::Done;
+		});
+
+		// Objects added to a running scene need to be woken up, otherwise the scene's Awake handles it
+		steps.push_back([scene, created, next](float& progress, LoadDeadline deadline) {
+			Scene::Sptr result = scene.lock();
+			if (result == nullptr) {
+				return LoadStepResult::Failed;
+			}
+
+			if (result->_isAwake) {
+				for (size_t handled = 0; *next < created->size() && !LoadStepOutOfTime(handled, deadline); (*next)++, handled++) {
+					(*created)[*next]->Awake();
+				}
+				if (*next < created->size()) {
+					progress = static_cast<float>(*next) / created->size();
+					return LoadStepResult::Continue;
+				}
+			}
 
-		_isAwake = true;
+			created->clear();
+			return LoadStepResult::Done;
+		});
+	}
+
+	void Scene::_QueueAwake(std::deque<LoadStep>& steps) {
+		steps.push_back([this](float& progress, LoadDeadline deadline) {
+			// Not a huge fan of this, but we need to get window size to notify our camera
+			// of the current screen size. Tools and tests load scenes without a window
+			if (MainCamera != nullptr && Application::IsStarted()) {
+				glm::ivec2 windowSize = Application::Get().GetWindowSize();
+				MainCamera->ResizeWindow(windowSize.x, windowSize.y);
+			}
+
+			if (_skyboxMesh == nullptr) {
+				_skyboxMesh = ResourceManager::CreateAsset<MeshResource>();
+				_skyboxMesh->AddParam(MeshBuilderParam::CreateCube(glm::vec3(0.0f), glm::vec3(1.0f)));
+				_skyboxMesh->AddParam(MeshBuilderParam::CreateInvert());
+				_skyboxMesh->GenerateMesh();
+			}
+			return LoadStepResult::Done;
+		});
+
+		// Call awake on all gameobjects, a batch at a time
+		std::shared_ptr<size_t> next = std::make_shared<size_t>(0);
+		steps.push_back([this, next](float& progress, LoadDeadline deadline) {
+			for (size_t handled = 0; *next < _objects.size() && !LoadStepOutOfTime(handled, deadline); (*next)++, handled++) {
+				_objects[*next]->Awake();
+			}
+			if (*next < _objects.size()) {
+				progress = static_cast<float>(*next) / _objects.size();
+				return LoadStepResult::Continue;
+			}
+
+			_isAwake = true;
+			return LoadStepResult::Done;
+		});
+	}
+
+	bool Scene::_RunSteps(std::deque<LoadStep>& steps) {
+		float progress = 0.0f;
+		while (!steps.empty()) {
+			LoadStepResult result = steps.front()(progress, LoadDeadline::max());
+			if (result == LoadStepResult::Failed) {
+				return false;
+			}
+			if (result == LoadStepResult::Done) {
+				steps.pop_front();
+			}
+		}
+		return true;
 	}
 
 	void Scene::DoPhysics(float dt) {
@@ -160,7 +301,8 @@ namespace Gameplay {
 
 		if (IsPlaying) {
 
-			_physicsWorld->stepSimulation(dt, 1);
+			// dt is a fixed tick, so we take exactly one step of that size
+			_physicsWorld->stepSimulation(dt, 1, dt);
 
 			_components.Each<Gameplay::Physics::RigidBody>([=](const std::shared_ptr<Gameplay::Physics::RigidBody>& body) {
 				body->PhysicsPostStep(dt);
@@ -169,6 +311,9 @@ namespace Gameplay {
 				body->PhysicsPostStep(dt);
 			});
 		}
+
+		// Rigidbodies write back their positions, so flush the transforms again
+		_transforms->Update();
 	}
 
 	void Scene::DrawPhysicsDebug() {
@@ -178,14 +323,22 @@ namespace Gameplay {
 		}
 	}
 
-	void Scene::Update(float dt) {
+	void Scene::Update(float dt, JobSystem* jobs) {
+		// Keep the state from the last tick around so that rendering can interpolate
+		_transforms->SaveState();
+
 		_FlushDeleteQueue();
 		if (IsPlaying) {
-			for (auto& obj : _objects) {
-				obj->Update(dt);
-			}
+			_UpdateObjects(dt, jobs);
 		}
 		_FlushDeleteQueue();
+
+		// Recalculate all the world transforms that changed this frame in one pass
+		_transforms->Update();
+	}
+
+	void Scene::InterpolateTransforms(float alpha) {
+		_transforms->Interpolate(alpha);
 	}
 
 	void Scene::RenderGUI()
@@ -204,10 +357,21 @@ namespace Gameplay {
 
 	Scene::Sptr Scene::FromJson(const nlohmann::json& data)
 	{
+		// The steps are all run before we return, so we can safely point at the caller's blob
+		std::deque<LoadStep> steps;
+		Scene::Sptr result = _BeginLoadJson(std::shared_ptr<const nlohmann::json>(std::shared_ptr<void>(), &data), steps);
+		_RunSteps(steps);
+		return result;
+	}
+
+	Scene::Sptr Scene::_BeginLoadJson(const std::shared_ptr<const nlohmann::json>& blob, std::deque<LoadStep>& steps)
+	{
+		const nlohmann::json& data = *blob;
 
 		Scene::Sptr result = std::make_shared<Scene>();
 		result->MainCamera = nullptr;
 		result->_objects.clear();
+		result->_objectLookup.clear();
 		result->DefaultMaterial = ResourceManager::Get<Material>(Guid(data["default_material"]));
 
 		if (data.contains("ambient")) {
@@ -222,25 +386,35 @@ namespace Gameplay {
 			result->SetSkyboxRotation(glm::mat3_cast((glm::quat)(blob["orientation"])));
 		}
 
+		if (data.contains("streaming") && data["streaming"].is_object()) {
+			const nlohmann::json& streaming = data["streaming"];
+			result->_streaming.CellSize = JsonGet(streaming, "cell_size", 0.0f);
+			result->_streaming.LoadRadius = JsonGet(streaming, "load_radius", result->_streaming.CellSize);
+			result->_streaming.UnloadRadius = glm::max(JsonGet(streaming, "unload_radius", result->_streaming.LoadRadius), result->_streaming.LoadRadius);
+			if (streaming.contains("cells") && streaming["cells"].is_array() && result->_streaming.CellSize > 0.0f) {
+				for (const auto& cell : streaming["cells"]) {
+					result->_streaming.Cells.push_back({ (glm::ivec2)cell["coord"], cell["file"].get<std::string>() });
+				}
+			}
+		}
+
 		// Make sure the scene has objects, then load them all in!
 		LOG_ASSERT(data["objects"].is_array(), "Objects not present in scene!");
-		for (auto& object : data["objects"]) {
-			GameObject::Sptr obj = GameObject::FromJson(result.get(), object);
-			obj->_scene = result.get();
-			obj->_parent.SceneContext = result.get();
-			obj->_selfRef = obj;
-			result->_objects.push_back(obj);
-		}
+		result->_objects.reserve(data["objects"].size());
 
-		// Re-build the parent hierarchy 
-		for (const auto& object : result->_objects) {
-			if (object->GetParent() != nullptr) {
-				object->GetParent()->AddChild(object);
-			}
-		}
+		// The steps hold a weak reference, the scene is owned by whoever is running the steps
+		std::weak_ptr<Scene> weakResult = result;
+		_QueueLoadObjects(weakResult, std::shared_ptr<const nlohmann::json>(blob, &data["objects"]), false, steps);
 
 		// Create and load camera config
-		result->MainCamera = result->_components.GetComponentByGUID<Camera>(Guid(data["main_camera"]));
+		steps.push_back([weakResult, blob](float& progress, LoadDeadline deadline) {
+			Scene::Sptr result = weakResult.lock();
+			if (result == nullptr) {
+				return LoadStepResult::Failed;
+			}
+			result->MainCamera = result->_components.GetComponentByGUID<Camera>(Guid((*blob)["main_camera"]));
+			return LoadStepResult::Done;
+		});
 	
 		return result;
 	}
@@ -259,14 +433,20 @@ namespace Gameplay {
 		blob["skybox"]["texture"] = _skyboxTexture ? _skyboxTexture->GetGUID().str() : "null";
 		blob["skybox"]["orientation"] = (glm::quat)_skyboxRotation;
 
-		// Save renderables
+		// Save renderables, objects from streaming cells are stored in their cells
 		std::vector<nlohmann::json> objects;
-		objects.resize(_objects.size());
-		for (int ix = 0; ix < _objects.size(); ix++) {
-			objects[ix] = _objects[ix]->ToJson();
+		objects.reserve(_objects.size());
+		for (const auto& object : _objects) {
+			if (!object->_isStreamed) {
+				objects.push_back(object->ToJson());
+			}
 		}
 		blob["objects"] = objects;
 
+		if (IsStreamed()) {
+			blob["streaming"] = _StreamingToJson(_streaming);
+		}
+
 		// Save camera info
 		blob["main_camera"] = MainCamera != nullptr ? MainCamera->GetGUID().str() : "null";
 
@@ -278,15 +458,423 @@ namespace Gameplay {
 		// Save data to file
 		FileHelpers::WriteContentsToFile(path, ToJson().dump(1, '\t'));
 		LOG_INFO("Saved scene to \"{}\"", path);
+
+		// The JSON stays the source of truth for version control, the binary is for fast loading.
+		// Binary scenes don't know about cells, so streamed scenes are always loaded from JSON
+		if (IsStreamed()) {
+			std::error_code error;
+			std::filesystem::remove(GetBinaryPath(path), error);
+			LOG_INFO("Changes to objects in streaming cells are not saved, use SaveStreamed to rebuild the cells");
+		} else {
+			SaveBinary(GetBinaryPath(path));
+		}
+	}
+
+	void Scene::SaveStreamed(const std::string& path, float cellSize, float loadRadius, float unloadRadius) {
+		// Only the loaded cells are in memory, so we can't re-partition a streamed scene
+		if (IsStreamed()) {
+			LOG_WARN("Scene is already streamed, only objects that are always loaded can be saved (see Save)");
+			return;
+		}
+		LOG_ASSERT(cellSize > 0.0f, "Cell size must be greater than zero!");
+
+		std::filesystem::path scenePath = std::filesystem::path(path);
+		std::filesystem::path cellFolder = scenePath.parent_path() / (scenePath.stem().string() + "-cells");
+
+		// Clear out cells from the last save, the world may have shrunk
+		std::error_code error;
+		std::filesystem::create_directories(cellFolder, error);
+		for (const auto& entry : std::filesystem::directory_iterator(cellFolder, error)) {
+			if (entry.path().extension() == ".json") {
+				std::filesystem::remove(entry.path(), error);
+			}
+		}
+
+		// The camera always stays loaded, since it's what drives the streaming
+		GameObject* cameraRoot = MainCamera != nullptr ? MainCamera->GetGameObject() : nullptr;
+		while (cameraRoot != nullptr && cameraRoot->GetParent() != nullptr) {
+			cameraRoot = cameraRoot->GetParent().get();
+		}
+
+		// Sort objects by the cell of their root object, so hierarchies are never split between cells
+		std::vector<nlohmann::json> persistent;
+		std::map<std::pair<int, int>, std::vector<nlohmann::json>> cells;
+		for (const auto& object : _objects) {
+			GameObject::Sptr root = object;
+			while (root->GetParent() != nullptr) {
+				root = root->GetParent();
+			}
+
+			if (root->AlwaysLoaded || root.get() == cameraRoot) {
+				persistent.push_back(object->ToJson());
+			} else {
+				glm::ivec2 coord = glm::ivec2(glm::floor(glm::vec2(root->GetPosition()) / cellSize));
+				cells[{ coord.x, coord.y }].push_back(object->ToJson());
+			}
+		}
+
+		StreamingSettings streaming;
+		streaming.CellSize = cellSize;
+		streaming.LoadRadius = loadRadius;
+		streaming.UnloadRadius = glm::max(unloadRadius, loadRadius);
+		for (auto& [coord, objects] : cells) {
+			StreamingCell cell;
+			cell.Coord = glm::ivec2(coord.first, coord.second);
+			cell.Path = (cellFolder / (std::to_string(coord.first) + "_" + std::to_string(coord.second) + ".json")).string();
+
+			nlohmann::json cellBlob;
+			cellBlob["coord"] = cell.Coord;
+			cellBlob["objects"] = objects;
+			FileHelpers::WriteContentsToFile(cell.Path, cellBlob.dump(1, '\t'));
+			streaming.Cells.push_back(cell);
+		}
+
+		// Write the scene itself, with only the objects that are always loaded
+		nlohmann::json blob = ToJson();
+		blob["objects"] = persistent;
+		blob["streaming"] = _StreamingToJson(streaming);
+		FileHelpers::WriteContentsToFile(path, blob.dump(1, '\t'));
+		std::filesystem::remove(GetBinaryPath(path), error);
+
+		_filePath = path;
+		LOG_INFO("Saved streamed scene to \"{}\" with {} cells and {} objects that are always loaded", path, streaming.Cells.size(), persistent.size());
+	}
+
+	nlohmann::json Scene::_StreamingToJson(const StreamingSettings& streaming) {
+		nlohmann::json result;
+		result["cell_size"] = streaming.CellSize;
+		result["load_radius"] = streaming.LoadRadius;
+		result["unload_radius"] = streaming.UnloadRadius;
+		result["cells"] = std::vector<nlohmann::json>();
+		for (const auto& cell : streaming.Cells) {
+			result["cells"].push_back({
+				{ "coord", cell.Coord },
+				{ "file", cell.Path }
+			});
+		}
+		return result;
 	}
 
 	Scene::Sptr Scene::Load(const std::string& path)
 	{
 		LOG_INFO("Loading scene from \"{}\"", path);
+		double startTime = glfwGetTime();
+
+		// Prefer the binary scene, as long as it is not older than the JSON (ex: the JSON was edited by hand)
+		if (_HasUpToDateBinary(path)) {
+			std::string binaryPath = GetBinaryPath(path);
+			Scene::Sptr result = LoadBinary(binaryPath);
+			if (result != nullptr) {
+				result->_filePath = path;
+				LOG_INFO("Loaded {} objects from binary scene in {:.2f}ms", result->_objects.size(), (glfwGetTime() - startTime) * 1000.0);
+				return result;
+			}
+			LOG_WARN("Failed to load binary scene \"{}\", falling back to JSON", binaryPath);
+		}
+
 		std::string content = FileHelpers::ReadFile(path);
 		nlohmann::json blob = nlohmann::json::parse(content);
 		Scene::Sptr result = FromJson(blob);
 		result->_filePath = path;
+		LOG_INFO("Loaded {} objects from JSON scene in {:.2f}ms", result->_objects.size(), (glfwGetTime() - startTime) * 1000.0);
+		return result;
+	}
+
+	std::string Scene::GetBinaryPath(const std::string& path) {
+		return std::filesystem::path(path).replace_extension(".bscene").string();
+	}
+
+	bool Scene::_HasUpToDateBinary(const std::string& path) {
+		std::error_code error;
+		std::string binaryPath = GetBinaryPath(path);
+		return std::filesystem::exists(binaryPath, error) &&
+			(!std::filesystem::exists(path, error) || std::filesystem::last_write_time(binaryPath, error) >= std::filesystem::last_write_time(path, error));
+	}
+
+	void Scene::SaveBinary(const std::string& path) const {
+		BinaryWriter body;
+
+		// Scene settings
+		body.WriteGuid(DefaultMaterial ? DefaultMaterial->GetGUID() : Guid());
+		body.Write(GetAmbientLight());
+		body.WriteGuid(_skyboxMesh ? _skyboxMesh->GetGUID() : Guid());
+		body.WriteGuid(_skyboxShader ? _skyboxShader->GetGUID() : Guid());
+		body.WriteGuid(_skyboxTexture ? _skyboxTexture->GetGUID() : Guid());
+		body.Write((glm::quat)_skyboxRotation);
+		body.WriteGuid(MainCamera ? MainCamera->GetGUID() : Guid());
+
+		// Gameobjects, components refer to their object by it's index in this list
+		body.Write<uint32_t>(static_cast<uint32_t>(_objects.size()));
+		for (const auto& object : _objects) {
+			object->ToBinary(body);
+		}
+
+		// Group components by type so that each type is decoded in a single run
+		std::map<std::string, std::vector<std::pair<uint32_t, IComponent::Sptr>>> blocks;
+		for (uint32_t ix = 0; ix < _objects.size(); ix++) {
+			for (const auto& component : _objects[ix]->_components) {
+				blocks[component->ComponentTypeName()].emplace_back(ix, component);
+			}
+		}
+
+		body.Write<uint32_t>(static_cast<uint32_t>(blocks.size()));
+		for (const auto& [typeName, components] : blocks) {
+			bool isNative = ComponentManager::HasBinaryFormat(std::type_index(typeid(*components[0].second)));
+
+			body.WriteString(typeName);
+			body.Write<uint8_t>(isNative ? 1 : 0);
+			body.Write<uint32_t>(static_cast<uint32_t>(components.size()));
+			size_t sizeOffset = body.Position();
+			body.Write<uint32_t>(0);
+
+			for (const auto& [objectIndex, component] : components) {
+				body.Write<uint32_t>(objectIndex);
+				ComponentManager::SaveBinary(component, body, isNative);
+			}
+			body.Patch<uint32_t>(sizeOffset, static_cast<uint32_t>(body.Position() - sizeOffset - sizeof(uint32_t)));
+		}
+
+		// Tables go between the header and the body, now that we know everything that was interned
+		BinaryWriter file;
+		BinarySceneHeader header;
+		header.Magic = BinarySceneMagic;
+		header.Version = BinarySceneVersion;
+		file.Write(header);
+
+		header.StringTableOffset = static_cast<uint32_t>(file.Position());
+		header.StringCount = static_cast<uint32_t>(body.Strings().size());
+		for (const std::string& value : body.Strings()) {
+			file.Write<uint32_t>(static_cast<uint32_t>(value.size()));
+			file.WriteBytes(value.data(), value.size());
+		}
+
+		header.GuidTableOffset = static_cast<uint32_t>(file.Position());
+		header.GuidCount = static_cast<uint32_t>(body.Guids().size());
+		for (const Guid& value : body.Guids()) {
+			file.WriteBytes(value.bytes(), 16);
+		}
+
+		header.BodyOffset = static_cast<uint32_t>(file.Position());
+		header.BodySize = static_cast<uint32_t>(body.Position());
+		file.WriteBytes(body.Data().data(), body.Data().size());
+		file.Patch(0, header);
+
+		std::ofstream out(path, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!out) {
+			LOG_ERROR("Could not open file '{}' for writing", path);
+			return;
+		}
+		out.write(reinterpret_cast<const char*>(file.Data().data()), file.Data().size());
+		LOG_INFO("Saved binary scene to \"{}\"", path);
+	}
+
+	Scene::Sptr Scene::LoadBinary(const std::string& path)
+	{
+		std::deque<LoadStep> steps;
+		Scene::Sptr result = _BeginLoadBinary(path, steps);
+		if (result == nullptr || !_RunSteps(steps)) {
+			return nullptr;
+		}
+		return result;
+	}
+
+	// Everything the binary load steps need to keep decoding a mapped scene over multiple frames
+	struct BinarySceneState {
+		MappedFile                    File;
+		std::vector<std::string_view> Strings;
+		std::vector<Guid>             Guids;
+		BinaryReader                  Body;
+		std::string                   Path;
+		Guid                          MainCamera;
+		uint32_t                      ObjectCount;
+		uint32_t                      ObjectsLoaded;
+		uint32_t                      BlocksRemaining;
+
+		// The block of components that we're part way through
+		BinaryReader                  Block;
+		std::string                   BlockTypeName;
+		bool                          BlockIsNative;
+		uint32_t                      BlockComponentsRemaining;
+
+		BinarySceneState(const std::string& path) :
+			File(path),
+			Body(nullptr, 0),
+			Path(path),
+			MainCamera(Guid()),
+			ObjectCount(0),
+			ObjectsLoaded(0),
+			BlocksRemaining(0),
+			Block(nullptr, 0),
+			BlockIsNative(false),
+			BlockComponentsRemaining(0)
+		{ }
+	};
+
+	Scene::Sptr Scene::_BeginLoadBinary(const std::string& path, std::deque<LoadStep>& steps)
+	{
+		std::shared_ptr<BinarySceneState> state = std::make_shared<BinarySceneState>(path);
+		const MappedFile& file = state->File;
+		if (!file.IsOpen() || file.Size() < sizeof(BinarySceneHeader)) {
+			return nullptr;
+		}
+
+		BinarySceneHeader header;
+		memcpy(&header, file.Data(), sizeof(BinarySceneHeader));
+		if (header.Magic != BinarySceneMagic) {
+			LOG_WARN("\"{}\" is not a binary scene", path);
+			return nullptr;
+		}
+		if (header.Version != BinarySceneVersion) {
+			LOG_WARN("Binary scene \"{}\" has version {}, expected {}", path, header.Version, BinarySceneVersion);
+			return nullptr;
+		}
+		if (static_cast<uint64_t>(header.BodyOffset) + header.BodySize > file.Size() ||
+			header.StringTableOffset > file.Size() || 
+			static_cast<uint64_t>(header.GuidTableOffset) + header.GuidCount * 16ull > file.Size()) {
+			return nullptr;
+		}
+
+		// Strings are viewed in place, the state keeps the file mapped until all steps have run
+		state->Strings.reserve(std::min<size_t>(header.StringCount, file.Size()));
+		BinaryReader stringReader(file.Data() + header.StringTableOffset, file.Size() - header.StringTableOffset);
+		for (uint32_t ix = 0; ix < header.StringCount && stringReader.IsValid(); ix++) {
+			uint32_t length = stringReader.Read<uint32_t>();
+			const uint8_t* data = stringReader.ReadSpan(length);
+			state->Strings.emplace_back(reinterpret_cast<const char*>(data), data != nullptr ? length : 0);
+		}
+		if (!stringReader.IsValid()) {
+			return nullptr;
+		}
+
+		state->Guids.reserve(header.GuidCount);
+		const uint8_t* guidData = file.Data() + header.GuidTableOffset;
+		for (uint32_t ix = 0; ix < header.GuidCount; ix++) {
+			state->Guids.push_back(Guid::FromBytes(const_cast<uint8_t*>(guidData + ix * 16)));
+		}
+
+		state->Body = BinaryReader(file.Data() + header.BodyOffset, header.BodySize, &state->Strings, &state->Guids);
+		BinaryReader& reader = state->Body;
+
+		Scene::Sptr result = std::make_shared<Scene>();
+		result->MainCamera = nullptr;
+		result->_objects.clear();
+		result->_objectLookup.clear();
+		result->DefaultMaterial = ResourceManager::Get<Material>(reader.ReadGuid());
+		result->SetAmbientLight(reader.Read<glm::vec3>());
+		result->_skyboxMesh = ResourceManager::Get<MeshResource>(reader.ReadGuid());
+		result->SetSkyboxShader(ResourceManager::Get<ShaderProgram>(reader.ReadGuid()));
+		result->SetSkyboxTexture(ResourceManager::Get<TextureCube>(reader.ReadGuid()));
+		result->SetSkyboxRotation(glm::mat3_cast(reader.Read<glm::quat>()));
+		state->MainCamera = reader.ReadGuid();
+
+		state->ObjectCount = reader.Read<uint32_t>();
+		if (!reader.IsValid() || state->ObjectCount > reader.Remaining()) {
+			return nullptr;
+		}
+		result->_objects.reserve(state->ObjectCount);
+
+		// The steps hold a weak reference, the scene is owned by whoever is running the steps
+		std::weak_ptr<Scene> weakResult = result;
+
+		// Gameobjects, a batch at a time
+		steps.push_back([weakResult, state](float& progress, LoadDeadline deadline) {
+			Scene::Sptr result = weakResult.lock();
+			if (result == nullptr) {
+				return LoadStepResult::Failed;
+			}
+
+			BinaryReader& reader = state->Body;
+			for (size_t handled = 0; state->ObjectsLoaded < state->ObjectCount && reader.IsValid() && !LoadStepOutOfTime(handled, deadline); state->ObjectsLoaded++, handled++) {
+				GameObject::Sptr obj = GameObject::FromBinary(result.get(), reader);
+				obj->_parent.SceneContext = result.get();
+				obj->_selfRef = obj;
+				result->_AddObject(obj);
+			}
+			if (!reader.IsValid()) {
+				LOG_WARN("Binary scene \"{}\" is truncated or corrupt", state->Path);
+				return LoadStepResult::Failed;
+			}
+			if (state->ObjectsLoaded < state->ObjectCount) {
+				progress = static_cast<float>(state->ObjectsLoaded) / state->ObjectCount;
+				return LoadStepResult::Continue;
+			}
+
+			state->BlocksRemaining = reader.Read<uint32_t>();
+			return LoadStepResult::Done;
+		});
+
+		// Components, a batch at a time, moving through the blocks in order
+		steps.push_back([weakResult, state](float& progress, LoadDeadline deadline) {
+			Scene::Sptr result = weakResult.lock();
+			if (result == nullptr) {
+				return LoadStepResult::Failed;
+			}
+
+			BinaryReader& reader = state->Body;
+			size_t handled = 0;
+			while (!LoadStepOutOfTime(handled, deadline) && reader.IsValid()) {
+				// Move on to the next block
+				if (state->BlockComponentsRemaining == 0) {
+					if (state->BlocksRemaining == 0) {
+						break;
+					}
+					state->BlocksRemaining--;
+					state->BlockTypeName = std::string(reader.ReadString());
+					state->BlockIsNative = reader.Read<uint8_t>() != 0;
+					state->BlockComponentsRemaining = reader.Read<uint32_t>();
+					uint32_t size = reader.Read<uint32_t>();
+					const uint8_t* blockData = reader.ReadSpan(size);
+					if (blockData == nullptr) {
+						break;
+					}
+					state->Block = BinaryReader(blockData, size, &state->Strings, &state->Guids);
+				}
+
+				BinaryReader& block = state->Block;
+				for (; state->BlockComponentsRemaining > 0 && !LoadStepOutOfTime(handled, deadline); state->BlockComponentsRemaining--, handled++) {
+					uint32_t objectIndex = block.Read<uint32_t>();
+					if (objectIndex >= result->_objects.size()) {
+						block.Fail();
+						break;
+					}
+
+					IComponent::Sptr component = result->_components.LoadBinary(state->BlockTypeName, block, state->BlockIsNative);
+					if (component == nullptr) {
+						// We can't find the end of a single component without it's type, so skip the rest of the block
+						if (block.IsValid()) {
+							LOG_WARN("Skipping {} components of unknown type \"{}\"", state->BlockComponentsRemaining, state->BlockTypeName);
+							state->BlockComponentsRemaining = 0;
+						}
+						break;
+					}
+					result->_objects[objectIndex]->_AttachComponent(component);
+				}
+
+				if (!block.IsValid()) {
+					reader.Fail();
+				}
+			}
+
+			if (!reader.IsValid()) {
+				LOG_WARN("Binary scene \"{}\" is truncated or corrupt", state->Path);
+				return LoadStepResult::Failed;
+			}
+			if (state->BlocksRemaining > 0 || state->BlockComponentsRemaining > 0) {
+				progress = static_cast<float>(reader.Position()) / (reader.Position() + reader.Remaining());
+				return LoadStepResult::Continue;
+			}
+
+			// Re-build the parent hierarchy 
+			for (const auto& object : result->_objects) {
+				if (object->GetParent() != nullptr) {
+					object->GetParent()->AddChild(object);
+				}
+			}
+
+			result->MainCamera = result->_components.GetComponentByGUID<Camera>(state->MainCamera);
+			return LoadStepResult::Done;
+		});
+
 		return result;
 	}
 
@@ -329,16 +917,149 @@ namespace Gameplay {
 
 
 	void Scene::_FlushDeleteQueue() {
+		if (_deletionQueue.empty()) {
+			return;
+		}
+
+		// Remove everything in one pass over the object list, cells unload lots of objects at once
+		std::unordered_set<GameObject*> removed;
 		for (auto& weakPtr : _deletionQueue) {
-			if (weakPtr.expired()) continue;
-			auto& it = std::find(_objects.begin(), _objects.end(), weakPtr.lock());
-			if (it != _objects.end()) {
-				_objects.erase(it);
+			GameObject::Sptr object = weakPtr.lock();
+			if (object == nullptr || !removed.insert(object.get()).second) continue;
+
+			// Detach from the parent, the object may be kept alive elsewhere
+			GameObject::Sptr parent = object->GetParent();
+			if (parent != nullptr) {
+				parent->RemoveChild(object);
+			}
+
+			auto it = _objectLookup.find(object->_guid);
+			if (it != _objectLookup.end() && it->second.lock() == object) {
+				_objectLookup.erase(it);
 			}
 		}
+		_objects.erase(std::remove_if(_objects.begin(), _objects.end(), [&](const GameObject::Sptr& object) {
+			return removed.count(object.get()) > 0;
+		}), _objects.end());
 		_deletionQueue.clear();
 	}
 
+	// Returns true if the type is in the list
+	static bool ContainsType(const std::vector<std::type_index>& types, const std::type_index& type) {
+		return std::find(types.begin(), types.end(), type) != types.end();
+	}
+
+	// Adds the type to the list, if it is not already in it
+	static void AddType(std::vector<std::type_index>& types, const std::type_index& type) {
+		if (!ContainsType(types, type)) {
+			types.push_back(type);
+		}
+	}
+
+	bool Scene::_CanUpdateInParallel(const GameObject::Sptr& object) {
+		_objectAccess.clear();
+		for (const auto& component : object->_components) {
+			if (!component->IsEnabled) {
+				continue;
+			}
+
+			std::type_index type = std::type_index(typeid(*component.get()));
+			auto it = _updateAccess.find(type);
+			if (it == _updateAccess.end()) {
+				it = _updateAccess.emplace(type, component->GetUpdateAccess()).first;
+			}
+			if (!it->second.IsParallel) {
+				return false;
+			}
+			_objectAccess.emplace_back(type, &it->second);
+		}
+		return true;
+	}
+
+	bool Scene::_ConflictsWithRun() const {
+		for (const auto& [type, access] : _objectAccess) {
+			// Every component implicitly modifies itself during update
+			if (ContainsType(_runReads, type) || ContainsType(_runWrites, type)) {
+				return true;
+			}
+			for (const auto& read : access->Reads) {
+				if (ContainsType(_runOwned, read) || ContainsType(_runWrites, read)) {
+					return true;
+				}
+			}
+			for (const auto& written : access->Writes) {
+				if (ContainsType(_runOwned, written) || ContainsType(_runReads, written) || ContainsType(_runWrites, written)) {
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	void Scene::_AddToRun(GameObject* object) {
+		_parallelRun.push_back(object);
+		for (const auto& [type, access] : _objectAccess) {
+			AddType(_runOwned, type);
+			for (const auto& read : access->Reads) {
+				AddType(_runReads, read);
+			}
+			for (const auto& written : access->Writes) {
+				AddType(_runWrites, written);
+			}
+		}
+	}
+
+	void Scene::_UpdateObjects(float dt, JobSystem* jobs) {
+		// Objects in a run can only see each other through the types they declared, and a run never
+		// holds two objects whose declarations conflict, so updating a run of them in any order gives
+		// the same result as updating them one after another
+		auto flushRun = [&]() {
+			if (_parallelRun.empty()) {
+				return;
+			}
+			_transforms->BeginParallelWrites();
+			if (_parallelRun.size() < ParallelUpdateGrain * 2) {
+				for (GameObject* object : _parallelRun) {
+					object->Update(dt);
+				}
+			} else {
+				jobs->Wait(jobs->ParallelFor(_parallelRun.size(), ParallelUpdateGrain, [&](size_t begin, size_t end) {
+					for (size_t ix = begin; ix < end; ix++) {
+						_parallelRun[ix]->Update(dt);
+					}
+				}));
+			}
+			_transforms->EndParallelWrites();
+			_parallelRun.clear();
+			_runOwned.clear();
+			_runReads.clear();
+			_runWrites.clear();
+		};
+
+		// Components may create objects while updating (ex: firing a bolt), which can grow the list under
+		// us, so we index rather than iterate. New objects get their first update next tick
+		size_t count = _objects.size();
+		for (size_t ix = 0; ix < count; ix++) {
+			GameObject* object = _objects[ix].get();
+			// Objects waiting in a prefab pool aren't part of the game until they are spawned again
+			if (object->_isPooled) {
+				continue;
+			}
+			if (jobs != nullptr && _CanUpdateInParallel(_objects[ix])) {
+				// Anything the run touches that this object also touches has to be finished before it starts
+				if (_ConflictsWithRun()) {
+					flushRun();
+				}
+				_AddToRun(object);
+			} else {
+				// Anything else may look at any object, so everything before it must be done and nothing after it started
+				flushRun();
+				object->Update(dt);
+			}
+		}
+		flushRun();
+	}
+
 	void Scene::DrawAllGameObjectGUIs()
 	{
 		for (auto& object : _objects) {
@@ -355,20 +1076,31 @@ namespace Gameplay {
 	}
 
 	void Scene::DrawSkybox()
+	{
+		if (MainCamera != nullptr) {
+			DrawSkybox(MainCamera->GetProjection(), MainCamera->GetRenderView());
+		}
+	}
+
+	void Scene::DrawSkybox(const glm::mat4& projection, const glm::mat4& view)
 	{
 		if (_skyboxShader != nullptr &&
 			_skyboxMesh != nullptr &&
 			_skyboxMesh->Mesh != nullptr &&
-			_skyboxTexture != nullptr &&
-			MainCamera != nullptr) {
+			_skyboxTexture != nullptr) {
 			
 			glDepthMask(false);
 			glDisable(GL_CULL_FACE);
 			glDepthFunc(GL_LEQUAL); 
 
 			_skyboxShader->Bind();
-			_skyboxShader->SetUniformMatrix("u_ClippedView", MainCamera->GetProjection());
-			_skyboxShader->SetUniformMatrix("u_EnvironmentRotation", _skyboxRotation * glm::inverse(glm::mat3(MainCamera->GetView())));
+			_skyboxShader->SetUniformMatrix("u_ClippedView", projection);
+			_skyboxShader->SetUniformMatrix("u_EnvironmentRotation", _skyboxRotation * glm::inverse(glm::mat3(view)));
+			// The skybox cube is generated, so it's positions are compressed relative to it's bounds
+			const VertexArrayObject::Sptr& mesh = _skyboxMesh->Mesh;
+			bool isCompressed = mesh->GetVertexEncoding() != VertexEncoding::Float;
+			_skyboxShader->SetUniform("u_PositionScale", isCompressed ? mesh->GetBoundsMax() - mesh->GetBoundsMin() : glm::vec3(1.0f));
+			_skyboxShader->SetUniform("u_PositionOffset", isCompressed ? mesh->GetBoundsMin() : glm::vec3(0.0f));
 			_skyboxTexture->Bind(0);
 			_skyboxMesh->Mesh->Draw();
 
@@ -10,6 +10,11 @@
 #include "Graphics/Buffers/UniformBuffer.h"
 #include "Graphics/Textures/Texture3D.h"
 
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+
 struct GLFWwindow;
 
 class TextureCube;
@@ -17,6 +22,18 @@ class ShaderProgram;
 
 class InspectorWindow;
 class HierarchyWindow;
+class SceneLoader;
+class WorldStreamer;
+class JobSystem;
+
+/// <summary>
+/// The result of running a single step of loading a scene, see Scene::LoadStep
+/// </summary>
+ENUM(LoadStepResult, int,
+	Done,     // The step has finished, and the next step may run
+	Continue, // The step has more work to do, and should be run again
+	Failed    // The data was invalid, and the load should be abandoned
+);
 
 namespace Gameplay {
 	namespace Physics {
@@ -34,6 +51,44 @@ namespace Gameplay {
 	class Scene {
 	public:
 		typedef std::shared_ptr<Scene> Sptr;
+
+		/// <summary>
+		/// The time that a load step should hand control back by
+		/// </summary>
+		typedef std::chrono::steady_clock::time_point LoadDeadline;
+		/// <summary>
+		/// A small unit of work for loading a scene, so that loading can be spread over multiple
+		/// frames. Steps must be run in order on the main thread. A step checks the deadline after
+		/// each object or component it handles, and returns Continue once it has passed, but always
+		/// handles at least one so that loading moves forward. The step should set progress to how
+		/// much of it's own work has been completed, from 0 to 1
+		/// </summary>
+		typedef std::function<LoadStepResult(float& progress, LoadDeadline deadline)> LoadStep;
+
+		/// <summary>
+		/// A cell of a streamed scene, holding all of the objects who's root object is within
+		/// the cell on the X and Y axes (see SaveStreamed)
+		/// </summary>
+		struct StreamingCell {
+			glm::ivec2  Coord;
+			// The path to the JSON file that stores the cell's objects
+			std::string Path;
+		};
+
+		/// <summary>
+		/// Describes how a scene has been split into cells that are loaded and unloaded around
+		/// the camera. The scene itself only stores the objects that are always loaded
+		/// </summary>
+		struct StreamingSettings {
+			// The size of a cell along the X and Y axes, in world units
+			float CellSize = 0.0f;
+			// Cells are loaded once they are within this distance of the camera
+			float LoadRadius = 0.0f;
+			// Cells are unloaded once they are further than this from the camera, should be
+			// larger than LoadRadius so cells on the edge don't load and unload every frame
+			float UnloadRadius = 0.0f;
+			std::vector<StreamingCell> Cells;
+		};
 		
 		// The camera for our scene
 		Camera::Sptr               MainCamera;
@@ -89,9 +144,8 @@ namespace Gameplay {
 		/// <param name="name">The name of the object to find</param>
 		GameObject::Sptr FindObjectByName(const std::string name) const;
 		/// <summary>
-		/// Searches all render objects in the scene and returns the first
-		/// one who's guid matches the one given, or nullptr if no object
-		/// is found
+		/// Finds the object in the scene who's guid matches the one given,
+		/// or nullptr if no object is found
 		/// </summary>
 		/// <param name="id">The guid of the object to find</param>
 		GameObject::Sptr FindObjectByGUID(Guid id) const;
@@ -132,12 +186,20 @@ namespace Gameplay {
 
 		/// <summary>
 		/// Performs updates on all enabled components and gameobjects in the
-		/// scene
+		/// scene, should be invoked once per fixed simulation tick
 		/// 
 		/// Only invokes events if IsPlaying is true
 		/// </summary>
 		/// <param name="dt">The time in seconds since the last frame</param>
-		void Update(float dt);
+		/// <param name="jobs">The job system to update parallel-safe objects on, or nullptr to update everything on the calling thread</param>
+		void Update(float dt, JobSystem* jobs = nullptr);
+
+		/// <summary>
+		/// Calculates the render transforms of all objects by interpolating between the
+		/// last two simulation ticks, should be called once per frame before rendering
+		/// </summary>
+		/// <param name="alpha">How far we are between the previous and current tick, in the 0-1 range</param>
+		void InterpolateTransforms(float alpha);
 
 		/// <summary>
 		/// Draws all GUI objects in the scene
@@ -151,6 +213,11 @@ namespace Gameplay {
 		void DrawAllGameObjectGUIs();
 
 		void DrawSkybox();
+		/// <summary>
+		/// Draws the skybox using the given camera matrices, only reads the skybox settings
+		/// of the scene so it is safe to call while the scene is being updated
+		/// </summary>
+		void DrawSkybox(const glm::mat4& projection, const glm::mat4& view);
 
 		/// <summary>
 		/// Gets the scene's Bullet physics world
@@ -181,6 +248,48 @@ namespace Gameplay {
 		/// <returns>A new scene loaded from the file</returns>
 		static Scene::Sptr Load(const std::string& path);
 
+		/// <summary>
+		/// Saves this scene to a binary scene file, which is much faster to load than JSON.
+		/// Save will write a binary scene alongside the JSON file automatically
+		/// </summary>
+		/// <param name="path">The path of the file to write to</param>
+		void SaveBinary(const std::string& path) const;
+		/// <summary>
+		/// Loads a scene from a binary scene file, by mapping it into memory and decoding it in place
+		/// </summary>
+		/// <param name="path">The path of the file to read from</param>
+		/// <returns>A new scene loaded from the file, or nullptr if the file is missing, invalid or from another version</returns>
+		static Scene::Sptr LoadBinary(const std::string& path);
+		/// <summary>
+		/// Gets the path of the binary scene that is stored alongside a JSON scene
+		/// </summary>
+		/// <param name="path">The path of the JSON scene</param>
+		static std::string GetBinaryPath(const std::string& path);
+
+		/// <summary>
+		/// Saves this scene split up into cells on the X and Y axes, so that large worlds can be
+		/// streamed in around the camera instead of being loaded all at once. Each root object
+		/// is placed in the cell that it's position falls in, along with all of it's children.
+		/// The main camera and objects marked AlwaysLoaded are saved with the scene itself
+		/// 
+		/// Cells are written to a folder next to the scene, and streamed scenes are only ever
+		/// saved as JSON
+		/// </summary>
+		/// <param name="path">The path of the scene file to write to</param>
+		/// <param name="cellSize">The size of each cell, in world units</param>
+		/// <param name="loadRadius">The distance from the camera that cells are loaded at</param>
+		/// <param name="unloadRadius">The distance from the camera that cells are unloaded at</param>
+		void SaveStreamed(const std::string& path, float cellSize, float loadRadius, float unloadRadius);
+
+		/// <summary>
+		/// Returns true if this scene's content is split into cells that need to be streamed in
+		/// </summary>
+		bool IsStreamed() const { return !_streaming.Cells.empty(); }
+		/// <summary>
+		/// Gets the cells and settings used to stream this scene's content, see SaveStreamed
+		/// </summary>
+		const StreamingSettings& GetStreaming() const { return _streaming; }
+
 
 		int NumObjects() const;
 		GameObject::Sptr GetObjectByIndex(int index) const;
@@ -188,6 +297,8 @@ namespace Gameplay {
 	protected:
 		friend class HierarchyWindow;
 		friend class GameObject;
+		friend class ::SceneLoader;
+		friend class ::WorldStreamer;
 
 		// The component manager will store all components for objects in this scene
 		ComponentManager _components;
@@ -213,9 +324,29 @@ namespace Gameplay {
 		// Our physics scene's global gravity, default matches earth's gravity (m/s^2)
 		glm::vec3 _gravity;
 
+		// Stores the transforms of all objects in our scene, objects only hold a weak pointer to it
+		// since they may outlive the scene
+		std::shared_ptr<TransformStore> _transforms;
+
 		// Stores all the objects in our scene
 		std::vector<GameObject::Sptr>  _objects;
 		std::vector<std::weak_ptr<GameObject>>  _deletionQueue;
+		// Lets us find objects by GUID without searching, since references are resolved by GUID
+		std::unordered_map<Guid, GameObject::Wptr> _objectLookup;
+
+		// How the scene is split into cells, empty if the scene is not streamed
+		StreamingSettings _streaming;
+
+		// Caches the result of IComponent::GetUpdateAccess for each component type
+		std::unordered_map<std::type_index, UpdateAccess> _updateAccess;
+		// The objects in the run of parallel-safe objects being built by _UpdateObjects, kept to reuse the memory
+		std::vector<GameObject*> _parallelRun;
+		// The component types in the run, and the types that the run declared it reads and writes on other objects
+		std::vector<std::type_index> _runOwned;
+		std::vector<std::type_index> _runReads;
+		std::vector<std::type_index> _runWrites;
+		// The enabled components of the object being considered for the run, with their access
+		std::vector<std::pair<std::type_index, const UpdateAccess*>> _objectAccess;
 
 		// Info for rendering our skybox will be stored in the scene itself
 		std::shared_ptr<ShaderProgram>       _skyboxShader;
@@ -240,5 +371,73 @@ namespace Gameplay {
 		void _CleanupPhysics();
 
 		void _FlushDeleteQueue();
+
+		/// <summary>
+		/// Adds an object to the scene's object list and GUID lookup
+		/// </summary>
+		void _AddObject(const GameObject::Sptr& object);
+
+		static nlohmann::json _StreamingToJson(const StreamingSettings& streaming);
+
+		/// <summary>
+		/// Updates all gameobjects in object order, each running it's enabled components in
+		/// order, exactly like calling GameObject::Update on each of them. Runs of objects whose
+		/// enabled components all declare a parallel update are spread across the job system,
+		/// any other object is updated on the calling thread between those runs
+		/// </summary>
+		/// <param name="dt">The time in seconds since the last frame</param>
+		/// <param name="jobs">The job system to use, or nullptr to update everything on the calling thread</param>
+		void _UpdateObjects(float dt, JobSystem* jobs);
+		/// <summary>
+		/// Looks up the access of the object's enabled components into _objectAccess, and returns
+		/// true if all of them may be updated on a worker thread
+		/// </summary>
+		bool _CanUpdateInParallel(const GameObject::Sptr& object);
+		/// <summary>
+		/// Returns true if the access in _objectAccess conflicts with any object in the current run,
+		/// meaning the object can't be updated at the same time as the run
+		/// </summary>
+		bool _ConflictsWithRun() const;
+		/// <summary>
+		/// Adds an object to the current run, after _CanUpdateInParallel has gathered it's access
+		/// </summary>
+		void _AddToRun(GameObject* object);
+
+		/// <summary>
+		/// Returns true if the scene at the given path has a binary scene alongside it that is
+		/// at least as new as the JSON file
+		/// </summary>
+		static bool _HasUpToDateBinary(const std::string& path);
+
+		/// <summary>
+		/// Creates a scene from a parsed JSON blob, and queues the steps to load it's objects.
+		/// The blob must stay alive until all steps have run
+		/// </summary>
+		static Scene::Sptr _BeginLoadJson(const std::shared_ptr<const nlohmann::json>& data, std::deque<LoadStep>& steps);
+		/// <summary>
+		/// Creates a scene from a binary scene file, and queues the steps to load it's objects
+		/// and components. Returns nullptr if the file is missing, invalid or from another version
+		/// </summary>
+		static Scene::Sptr _BeginLoadBinary(const std::string& path, std::deque<LoadStep>& steps);
+		/// <summary>
+		/// Queues the steps to load an array of objects into a scene and link them up with their
+		/// parents. If the scene is already awake by the time the objects are loaded, they will
+		/// be woken up as well. The array must stay alive until all steps have run
+		/// </summary>
+		/// <param name="scene">The scene to load the objects into</param>
+		/// <param name="objects">The JSON array of objects to load</param>
+		/// <param name="isStreamed">True if the objects come from a streaming cell</param>
+		/// <param name="steps">The list to append the steps to</param>
+		/// <param name="loaded">If not null, receives each object as soon as it is added to the scene</param>
+		static void _QueueLoadObjects(const std::weak_ptr<Scene>& scene, const std::shared_ptr<const nlohmann::json>& objects, bool isStreamed,
+			std::deque<LoadStep>& steps, const std::shared_ptr<std::vector<GameObject::Wptr>>& loaded = nullptr);
+		/// <summary>
+		/// Queues the steps to wake up the scene, see Awake
+		/// </summary>
+		void _QueueAwake(std::deque<LoadStep>& steps);
+		/// <summary>
+		/// Runs all steps to completion, returns false if any step failed
+		/// </summary>
+		static bool _RunSteps(std::deque<LoadStep>& steps);
 	};
 }
\ No newline at end of file
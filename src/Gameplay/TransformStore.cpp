@@ -0,0 +1,485 @@
+#include "Gameplay/TransformStore.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include <Logging.h>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define TRANSFORM_STORE_SSE 1
+#else
+#define TRANSFORM_STORE_SSE 0
+#endif
+
+namespace Gameplay {
+	// Multiplies two column major matrices, out = a * b. Out may not alias a or b
+	static inline void MulMat4(const glm::mat4& a, const glm::mat4& b, glm::mat4& out) {
+		#if TRANSFORM_STORE_SSE
+		__m128 a0 = _mm_loadu_ps(&a[0][0]);
+		__m128 a1 = _mm_loadu_ps(&a[1][0]);
+		__m128 a2 = _mm_loadu_ps(&a[2][0]);
+		__m128 a3 = _mm_loadu_ps(&a[3][0]);
+		for (int col = 0; col < 4; col++) {
+			const float* b_col = &b[col][0];
+			__m128 result = _mm_mul_ps(a0, _mm_set1_ps(b_col[0]));
+			result = _mm_add_ps(result, _mm_mul_ps(a1, _mm_set1_ps(b_col[1])));
+			result = _mm_add_ps(result, _mm_mul_ps(a2, _mm_set1_ps(b_col[2])));
+			result = _mm_add_ps(result, _mm_mul_ps(a3, _mm_set1_ps(b_col[3])));
+			_mm_storeu_ps(&out[col][0], result);
+		}
+		#else
+		out = a * b;
+		#endif
+	}
+
+	// Permutes a dense array so that result[ix] = data[order[ix]]
+	template <typename T>
+	static void Permute(std::vector<T>& data, const std::vector<uint32_t>& order) {
+		std::vector<T> result;
+		result.reserve(data.size());
+		for (uint32_t index : order) {
+			result.push_back(data[index]);
+		}
+		data.swap(result);
+	}
+
+	TransformStore::TransformStore() :
+		_generation(1),
+		_updateGeneration(1),
+		_dirtyBegin(0),
+		_needsSort(false),
+		_isParallelWriting(false)
+	{ }
+
+	TransformStore::~TransformStore() = default;
+
+	TransformStore::Handle TransformStore::Create() {
+		Handle handle;
+		if (!_freeHandles.empty()) {
+			handle = _freeHandles.back();
+			_freeHandles.pop_back();
+		} else {
+			handle = static_cast<Handle>(_denseIndex.size());
+			_denseIndex.push_back(InvalidHandle);
+		}
+
+		uint32_t index = static_cast<uint32_t>(_handles.size());
+		_denseIndex[handle] = index;
+
+		_positions.push_back(glm::vec3(0.0f));
+		_rotations.push_back(glm::quat(glm::vec3(0.0f)));
+		_scales.push_back(glm::vec3(1.0f));
+		_locals.push_back(glm::mat4(1.0f));
+		_inverseLocals.push_back(glm::mat4(1.0f));
+		_worlds.push_back(glm::mat4(1.0f));
+		_inverseWorlds.push_back(glm::mat4(1.0f));
+		_parents.push_back(InvalidHandle);
+		_handles.push_back(handle);
+		_childCounts.push_back(0);
+		_localDirty.push_back(0);
+		_worldDirty.push_back(0);
+		_worldVersions.push_back(0);
+		_parentVersions.push_back(0);
+		_validGenerations.push_back(0);
+		_previousPositions.push_back(glm::vec3(0.0f));
+		_previousRotations.push_back(glm::quat(glm::vec3(0.0f)));
+		_previousScales.push_back(glm::vec3(1.0f));
+		_hasPrevious.push_back(0);
+		_renderWorlds.push_back(glm::mat4(1.0f));
+
+		// New roots are appended to the end, so the ordering is still valid
+		_Touch(index);
+		return handle;
+	}
+
+	void TransformStore::Destroy(Handle handle) {
+		uint32_t index = _Dense(handle);
+		LOG_ASSERT(index != InvalidHandle, "Attempting to destroy a transform that does not exist!");
+
+		// Any children become roots, and need their world matrices recalculated
+		if (_childCounts[index] > 0) {
+			for (uint32_t ix = 0; ix < _handles.size(); ix++) {
+				if (_parents[ix] == handle) {
+					_parents[ix] = InvalidHandle;
+					_worldDirty[ix] = 1;
+					_Touch(ix);
+				}
+			}
+		}
+		if (_parents[index] != InvalidHandle) {
+			_childCounts[_Dense(_parents[index])]--;
+		}
+
+		// Swap the last transform into our slot
+		uint32_t last = static_cast<uint32_t>(_handles.size() - 1);
+		if (index != last) {
+			_positions[index]        = _positions[last];
+			_rotations[index]        = _rotations[last];
+			_scales[index]           = _scales[last];
+			_locals[index]           = _locals[last];
+			_inverseLocals[index]    = _inverseLocals[last];
+			_worlds[index]           = _worlds[last];
+			_inverseWorlds[index]    = _inverseWorlds[last];
+			_parents[index]          = _parents[last];
+			_handles[index]          = _handles[last];
+			_childCounts[index]      = _childCounts[last];
+			_localDirty[index]       = _localDirty[last];
+			_worldDirty[index]       = _worldDirty[last];
+			_worldVersions[index]    = _worldVersions[last];
+			_parentVersions[index]   = _parentVersions[last];
+			_validGenerations[index] = _validGenerations[last];
+			_previousPositions[index] = _previousPositions[last];
+			_previousRotations[index] = _previousRotations[last];
+			_previousScales[index]    = _previousScales[last];
+			_hasPrevious[index]       = _hasPrevious[last];
+			_renderWorlds[index]      = _renderWorlds[last];
+			_denseIndex[_handles[index]] = index;
+
+			// The moved transform may now come before it's parent
+			_needsSort = true;
+		}
+
+		_positions.pop_back();
+		_rotations.pop_back();
+		_scales.pop_back();
+		_locals.pop_back();
+		_inverseLocals.pop_back();
+		_worlds.pop_back();
+		_inverseWorlds.pop_back();
+		_parents.pop_back();
+		_handles.pop_back();
+		_childCounts.pop_back();
+		_localDirty.pop_back();
+		_worldDirty.pop_back();
+		_worldVersions.pop_back();
+		_parentVersions.pop_back();
+		_validGenerations.pop_back();
+		_previousPositions.pop_back();
+		_previousRotations.pop_back();
+		_previousScales.pop_back();
+		_hasPrevious.pop_back();
+		_renderWorlds.pop_back();
+
+		_denseIndex[handle] = InvalidHandle;
+		_freeHandles.push_back(handle);
+	}
+
+	void TransformStore::SetParent(Handle handle, Handle parent) {
+		uint32_t index = _Dense(handle);
+		if (_parents[index] == parent) {
+			return;
+		}
+
+		if (_parents[index] != InvalidHandle) {
+			_childCounts[_Dense(_parents[index])]--;
+		}
+		_parents[index] = parent;
+		if (parent != InvalidHandle) {
+			uint32_t parentIndex = _Dense(parent);
+			_childCounts[parentIndex]++;
+			// Children must always come after their parents
+			_needsSort |= parentIndex > index;
+		}
+
+		_worldDirty[index] = 1;
+		_Touch(index);
+	}
+
+	void TransformStore::SetPosition(Handle handle, const glm::vec3& value) {
+		uint32_t index = _Dense(handle);
+		_positions[index] = value;
+		_localDirty[index] = 1;
+		_Touch(index);
+	}
+
+	const glm::vec3& TransformStore::GetPosition(Handle handle) const {
+		return _positions[_Dense(handle)];
+	}
+
+	void TransformStore::SetRotation(Handle handle, const glm::quat& value) {
+		uint32_t index = _Dense(handle);
+		_rotations[index] = value;
+		_localDirty[index] = 1;
+		_Touch(index);
+	}
+
+	const glm::quat& TransformStore::GetRotation(Handle handle) const {
+		return _rotations[_Dense(handle)];
+	}
+
+	void TransformStore::SetScale(Handle handle, const glm::vec3& value) {
+		uint32_t index = _Dense(handle);
+		_scales[index] = value;
+		_localDirty[index] = 1;
+		_Touch(index);
+	}
+
+	const glm::vec3& TransformStore::GetScale(Handle handle) const {
+		return _scales[_Dense(handle)];
+	}
+
+	const glm::mat4& TransformStore::GetLocal(Handle handle) const {
+		uint32_t index = _Dense(handle);
+		if (_localDirty[index]) {
+			_RecalcLocal(index);
+		}
+		return _locals[index];
+	}
+
+	const glm::mat4& TransformStore::GetInverseLocal(Handle handle) const {
+		uint32_t index = _Dense(handle);
+		if (_localDirty[index]) {
+			_RecalcLocal(index);
+		}
+		return _inverseLocals[index];
+	}
+
+	const glm::mat4& TransformStore::GetWorld(Handle handle) const {
+		uint32_t index = _Dense(handle);
+		// If nothing has changed since the last update, or we've already resolved
+		// this transform, we can return the cached matrix right away
+		if (_updateGeneration != _generation && _validGenerations[index] != _generation) {
+			_ResolveWorld(index);
+		}
+		return _worlds[index];
+	}
+
+	const glm::mat4& TransformStore::GetInverseWorld(Handle handle) const {
+		uint32_t index = _Dense(handle);
+		if (_updateGeneration != _generation && _validGenerations[index] != _generation) {
+			_ResolveWorld(index);
+		}
+		return _inverseWorlds[index];
+	}
+
+	void TransformStore::Update() {
+		if (_needsSort) {
+			_SortByDepth();
+		}
+		if (_updateGeneration == _generation) {
+			return;
+		}
+
+		// Since parents always precede their children, nothing before the first
+		// modified transform can have changed
+		uint32_t count = static_cast<uint32_t>(_handles.size());
+		for (uint32_t ix = static_cast<uint32_t>(_dirtyBegin); ix < count; ix++) {
+			if (_localDirty[ix]) {
+				_RecalcLocal(ix);
+			}
+			uint32_t parent = _ParentDense(ix);
+			if (_worldDirty[ix] || (parent != InvalidHandle && _parentVersions[ix] != _worldVersions[parent])) {
+				_RecalcWorld(ix, parent);
+			}
+		}
+
+		_dirtyBegin = count;
+		_updateGeneration = _generation;
+	}
+
+	void TransformStore::SaveState() {
+		_previousPositions = _positions;
+		_previousRotations = _rotations;
+		_previousScales = _scales;
+		std::fill(_hasPrevious.begin(), _hasPrevious.end(), 1);
+	}
+
+	void TransformStore::Interpolate(float alpha) {
+		// Make sure the current world matrices are valid and the store is sorted
+		Update();
+
+		uint32_t count = static_cast<uint32_t>(_handles.size());
+		for (uint32_t ix = 0; ix < count; ix++) {
+			uint32_t parent = _ParentDense(ix);
+			bool isMoving = _hasPrevious[ix] && (
+				_previousPositions[ix] != _positions[ix] ||
+				_previousRotations[ix] != _rotations[ix] ||
+				_previousScales[ix] != _scales[ix]);
+
+			// Static roots can use the simulation result directly
+			if (!isMoving && parent == InvalidHandle) {
+				_renderWorlds[ix] = _worlds[ix];
+				continue;
+			}
+
+			glm::mat4 local;
+			if (isMoving) {
+				glm::vec3 position = glm::mix(_previousPositions[ix], _positions[ix], alpha);
+				glm::vec3 scale = glm::mix(_previousScales[ix], _scales[ix], alpha);
+				glm::mat3 rotation = glm::mat3_cast(glm::slerp(_previousRotations[ix], _rotations[ix], alpha));
+				local[0] = glm::vec4(rotation[0] * scale.x, 0.0f);
+				local[1] = glm::vec4(rotation[1] * scale.y, 0.0f);
+				local[2] = glm::vec4(rotation[2] * scale.z, 0.0f);
+				local[3] = glm::vec4(position, 1.0f);
+			} else {
+				local = _locals[ix];
+			}
+
+			// Parents precede their children, so the parent's render transform is already done
+			if (parent != InvalidHandle) {
+				MulMat4(_renderWorlds[parent], local, _renderWorlds[ix]);
+			} else {
+				_renderWorlds[ix] = local;
+			}
+		}
+	}
+
+	const glm::mat4& TransformStore::GetRenderWorld(Handle handle) const {
+		return _renderWorlds[_Dense(handle)];
+	}
+
+	void TransformStore::BeginParallelWrites() {
+		LOG_ASSERT(!_isParallelWriting, "Parallel write sections cannot be nested!");
+		_isParallelWriting = true;
+	}
+
+	void TransformStore::EndParallelWrites() {
+		LOG_ASSERT(_isParallelWriting, "EndParallelWrites called without BeginParallelWrites!");
+		_isParallelWriting = false;
+		// We don't know which transforms were touched, but the dirty flags are per-transform,
+		// so the next update just needs to scan all of them
+		_generation++;
+		_dirtyBegin = 0;
+	}
+
+	void TransformStore::_Touch(uint32_t index) {
+		// The shared counters would race, EndParallelWrites takes care of them instead
+		if (_isParallelWriting) {
+			return;
+		}
+		_generation++;
+		_dirtyBegin = std::min<size_t>(_dirtyBegin, index);
+	}
+
+	void TransformStore::_RecalcLocal(uint32_t index) const {
+		const glm::vec3& position = _positions[index];
+		const glm::vec3& scale = _scales[index];
+		glm::mat3 rotation = glm::mat3_cast(_rotations[index]);
+
+		// Local = T * R * S, built directly rather than multiplying 3 matrices
+		glm::mat4& local = _locals[index];
+		local[0] = glm::vec4(rotation[0] * scale.x, 0.0f);
+		local[1] = glm::vec4(rotation[1] * scale.y, 0.0f);
+		local[2] = glm::vec4(rotation[2] * scale.z, 0.0f);
+		local[3] = glm::vec4(position, 1.0f);
+
+		// Since the matrix is affine, the inverse is S^-1 * R^T * T^-1, so we
+		// can skip the general purpose inverse
+		glm::vec3 invScale = 1.0f / scale;
+		glm::mat3 invRotScale;
+		for (int col = 0; col < 3; col++) {
+			for (int row = 0; row < 3; row++) {
+				invRotScale[col][row] = rotation[row][col] * invScale[row];
+			}
+		}
+		glm::mat4& inverse = _inverseLocals[index];
+		inverse[0] = glm::vec4(invRotScale[0], 0.0f);
+		inverse[1] = glm::vec4(invRotScale[1], 0.0f);
+		inverse[2] = glm::vec4(invRotScale[2], 0.0f);
+		inverse[3] = glm::vec4(-(invRotScale * position), 1.0f);
+
+		_localDirty[index] = 0;
+		_worldDirty[index] = 1;
+	}
+
+	void TransformStore::_RecalcWorld(uint32_t index, uint32_t parent) const {
+		if (parent != InvalidHandle) {
+			MulMat4(_worlds[parent], _locals[index], _worlds[index]);
+			// inverse(P * L) = inverse(L) * inverse(P)
+			MulMat4(_inverseLocals[index], _inverseWorlds[parent], _inverseWorlds[index]);
+			_parentVersions[index] = _worldVersions[parent];
+		} else {
+			_worlds[index] = _locals[index];
+			_inverseWorlds[index] = _inverseLocals[index];
+		}
+		_worldDirty[index] = 0;
+		_worldVersions[index]++;
+		_validGenerations[index] = _generation;
+	}
+
+	void TransformStore::_ResolveWorld(uint32_t index) const {
+		// Walk up to the first ancestor that is still valid, then resolve back down from there. Doing
+		// this with a loop rather than recursion keeps deep hierarchies from overflowing the stack
+		_resolveChain.clear();
+		_resolveChain.push_back(index);
+		for (uint32_t parent = _ParentDense(index); parent != InvalidHandle && _validGenerations[parent] != _generation; parent = _ParentDense(parent)) {
+			_resolveChain.push_back(parent);
+		}
+
+		for (auto it = _resolveChain.rbegin(); it != _resolveChain.rend(); it++) {
+			uint32_t ix = *it;
+			uint32_t parent = _ParentDense(ix);
+			if (_localDirty[ix]) {
+				_RecalcLocal(ix);
+			}
+			if (_worldDirty[ix] || (parent != InvalidHandle && _parentVersions[ix] != _worldVersions[parent])) {
+				_RecalcWorld(ix, parent);
+			}
+			_validGenerations[ix] = _generation;
+		}
+	}
+
+	void TransformStore::_SortByDepth() {
+		uint32_t count = static_cast<uint32_t>(_handles.size());
+
+		// Determine how deep in the hierarchy each transform is. Each walk up the hierarchy stops at the
+		// first ancestor that we already know the depth of, so every transform is only visited once
+		std::vector<uint32_t> depths(count, InvalidHandle);
+		uint32_t maxDepth = 0;
+		for (uint32_t ix = 0; ix < count; ix++) {
+			_resolveChain.clear();
+			uint32_t known = ix;
+			while (known != InvalidHandle && depths[known] == InvalidHandle) {
+				_resolveChain.push_back(known);
+				known = _ParentDense(known);
+			}
+			uint32_t depth = known == InvalidHandle ? 0 : depths[known] + 1;
+			for (auto it = _resolveChain.rbegin(); it != _resolveChain.rend(); it++) {
+				depths[*it] = depth++;
+			}
+			maxDepth = std::max(maxDepth, depths[ix]);
+		}
+
+		// A counting sort on depth guarantees that parents precede their children, while keeping
+		// siblings in creation order
+		std::vector<uint32_t> offsets(maxDepth + 2, 0);
+		for (uint32_t ix = 0; ix < count; ix++) {
+			offsets[depths[ix] + 1]++;
+		}
+		std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+		std::vector<uint32_t> order(count);
+		for (uint32_t ix = 0; ix < count; ix++) {
+			order[offsets[depths[ix]]++] = ix;
+		}
+
+		Permute(_positions, order);
+		Permute(_rotations, order);
+		Permute(_scales, order);
+		Permute(_locals, order);
+		Permute(_inverseLocals, order);
+		Permute(_worlds, order);
+		Permute(_inverseWorlds, order);
+		Permute(_parents, order);
+		Permute(_handles, order);
+		Permute(_childCounts, order);
+		Permute(_localDirty, order);
+		Permute(_worldDirty, order);
+		Permute(_worldVersions, order);
+		Permute(_parentVersions, order);
+		Permute(_validGenerations, order);
+		Permute(_previousPositions, order);
+		Permute(_previousRotations, order);
+		Permute(_previousScales, order);
+		Permute(_hasPrevious, order);
+		Permute(_renderWorlds, order);
+
+		for (uint32_t ix = 0; ix < count; ix++) {
+			_denseIndex[_handles[ix]] = ix;
+		}
+
+		_needsSort = false;
+		_dirtyBegin = 0;
+		_generation++;
+	}
+}
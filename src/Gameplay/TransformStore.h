@@ -0,0 +1,171 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+#include <GLM/glm.hpp>
+#include <GLM/gtc/quaternion.hpp>
+
+#include "Utils/Macros.h"
+
+namespace Gameplay {
+	/// <summary>
+	/// Stores the transforms for all gameobjects in a scene as a structure of arrays
+	///
+	/// Transforms are kept sorted so that parents always precede their children, which
+	/// lets Update recalculate every dirty world matrix in a single linear pass. Objects
+	/// hold a stable handle, since the dense index of a transform changes as the
+	/// hierarchy is re-sorted
+	///
+	/// Reading a world matrix before Update has been called will resolve just the
+	/// chain of parents for that object, so reads are always up to date
+	/// </summary>
+	class TransformStore {
+	public:
+		NO_COPY(TransformStore);
+		NO_MOVE(TransformStore);
+
+		typedef uint32_t Handle;
+		static constexpr Handle InvalidHandle = 0xFFFFFFFF;
+
+		TransformStore();
+		~TransformStore();
+
+		/// <summary>
+		/// Allocates a new identity transform with no parent
+		/// </summary>
+		Handle Create();
+		/// <summary>
+		/// Releases a transform, any children of the transform will become roots
+		/// </summary>
+		/// <param name="handle">The handle to release</param>
+		void Destroy(Handle handle);
+
+		/// <summary>
+		/// Sets the parent of a transform, or InvalidHandle to make it a root
+		/// </summary>
+		void SetParent(Handle handle, Handle parent);
+
+		void SetPosition(Handle handle, const glm::vec3& value);
+		const glm::vec3& GetPosition(Handle handle) const;
+
+		void SetRotation(Handle handle, const glm::quat& value);
+		const glm::quat& GetRotation(Handle handle) const;
+
+		void SetScale(Handle handle, const glm::vec3& value);
+		const glm::vec3& GetScale(Handle handle) const;
+
+		/// <summary>
+		/// Gets the transform from local space to parent space
+		/// </summary>
+		const glm::mat4& GetLocal(Handle handle) const;
+		/// <summary>
+		/// Gets the transform from parent space to local space
+		/// </summary>
+		const glm::mat4& GetInverseLocal(Handle handle) const;
+		/// <summary>
+		/// Gets the transform from local space to world space
+		/// </summary>
+		const glm::mat4& GetWorld(Handle handle) const;
+		/// <summary>
+		/// Gets the transform from world space to local space
+		/// </summary>
+		const glm::mat4& GetInverseWorld(Handle handle) const;
+
+		/// <summary>
+		/// Recalculates all dirty local and world matrices in a single pass over the store,
+		/// starting from the first transform that has changed since the last update
+		/// </summary>
+		void Update();
+
+		/// <summary>
+		/// Stores the current position, rotation and scale of every transform as the
+		/// previous simulation state, should be called at the start of each fixed tick
+		/// </summary>
+		void SaveState();
+		/// <summary>
+		/// Calculates the render transform for every object by interpolating between the
+		/// previous and current simulation states, in a single pass over the store
+		/// </summary>
+		/// <param name="alpha">How far between the previous and current state to interpolate, in the 0-1 range</param>
+		void Interpolate(float alpha);
+		/// <summary>
+		/// Gets the local to world transform as calculated by the last call to Interpolate
+		/// </summary>
+		const glm::mat4& GetRenderWorld(Handle handle) const;
+
+		/// <summary>
+		/// Begins a section where multiple threads may set the position, rotation or scale of
+		/// different transforms at once. Only the per-transform setters and getters for position,
+		/// rotation and scale are safe to call until EndParallelWrites is called
+		/// </summary>
+		void BeginParallelWrites();
+		/// <summary>
+		/// Ends a parallel write section, and marks the store as modified
+		/// </summary>
+		void EndParallelWrites();
+
+		/// <summary>
+		/// Gets the number of live transforms in the store
+		/// </summary>
+		size_t Size() const { return _handles.size(); }
+
+	protected:
+		// Dense arrays, all indexed by the same dense index
+		std::vector<glm::vec3>         _positions;
+		std::vector<glm::quat>         _rotations;
+		std::vector<glm::vec3>         _scales;
+		mutable std::vector<glm::mat4> _locals;
+		mutable std::vector<glm::mat4> _inverseLocals;
+		mutable std::vector<glm::mat4> _worlds;
+		mutable std::vector<glm::mat4> _inverseWorlds;
+		// Parent of each transform, stored as a handle so that swapping entries doesn't invalidate it
+		std::vector<Handle>            _parents;
+		std::vector<Handle>            _handles;
+		std::vector<uint32_t>          _childCounts;
+		mutable std::vector<uint8_t>   _localDirty;
+		// Set when the local matrix has been recalculated but the world matrix has not
+		mutable std::vector<uint8_t>   _worldDirty;
+		// Bumped whenever a world matrix is recalculated, children store the version of
+		// their parent that they were last calculated with
+		mutable std::vector<uint32_t>  _worldVersions;
+		mutable std::vector<uint32_t>  _parentVersions;
+		// The value of _generation the last time the world matrix was known to be valid
+		mutable std::vector<uint32_t>  _validGenerations;
+		// State at the start of the current tick, for render interpolation
+		std::vector<glm::vec3>         _previousPositions;
+		std::vector<glm::quat>         _previousRotations;
+		std::vector<glm::vec3>         _previousScales;
+		// 0 for transforms created since the last SaveState, which have no previous state
+		std::vector<uint8_t>           _hasPrevious;
+		std::vector<glm::mat4>         _renderWorlds;
+
+		// Scratch space for walking up the hierarchy in _ResolveWorld and _SortByDepth
+		mutable std::vector<uint32_t> _resolveChain;
+
+		// Maps handles to dense indices, InvalidHandle for free handles
+		std::vector<uint32_t> _denseIndex;
+		std::vector<Handle>   _freeHandles;
+
+		// Incremented on every modification
+		uint32_t _generation;
+		// The generation at the end of the last call to Update
+		uint32_t _updateGeneration;
+		// The first dense index that has been modified since the last Update
+		size_t   _dirtyBegin;
+		// True when a parent may come after one of it's children
+		bool     _needsSort;
+		// True while inside of a parallel write section, see BeginParallelWrites
+		bool     _isParallelWriting;
+
+		inline uint32_t _Dense(Handle handle) const { return _denseIndex[handle]; }
+		inline uint32_t _ParentDense(uint32_t index) const {
+			return _parents[index] == InvalidHandle ? InvalidHandle : _denseIndex[_parents[index]];
+		}
+
+		void _Touch(uint32_t index);
+		void _RecalcLocal(uint32_t index) const;
+		void _RecalcWorld(uint32_t index, uint32_t parent) const;
+		void _ResolveWorld(uint32_t index) const;
+		void _SortByDepth();
+	};
+}
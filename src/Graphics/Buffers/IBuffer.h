@@ -43,6 +43,16 @@ public:
 	/// <param name="elementCount">The number of elements to upload</param>
 	virtual void LoadData(const void* data, uint32_t elementSize, uint32_t elementCount);
 
+	/// <summary>
+	/// Allocates immutable storage for this buffer and fills it with data, using glNamedBufferStorage.
+	/// The buffer can not be loaded or updated again afterwards, but the driver can place it
+	/// optimally, and the data is copied straight from the given pointer (ex: a mapped file)
+	/// </summary>
+	/// <param name="data">The data that you want to load into the buffer</param>
+	/// <param name="elementSize">The size of a single element, in bytes</param>
+	/// <param name="elementCount">The number of elements to upload</param>
+	void LoadStorage(const void* data, uint32_t elementSize, uint32_t elementCount);
+
 	/// <summary>
 	/// Updates data within the buffer, optionally resizing the buffer
 	/// </summary>
@@ -76,6 +86,10 @@ public:
 	/// </summary>
 	uint32_t GetTotalSize() const { return _size; }
 	/// <summary>
+	/// Returns true if the buffer's storage was allocated with LoadStorage, and can no longer be changed
+	/// </summary>
+	bool IsImmutable() const { return _isImmutable; }
+	/// <summary>
 	/// Returns the type of buffer (ex GL_ARRAY_BUFFER, GL_ARRAY_ELEMENT_BUFFER, etc...)
 	/// </summary>
 	BufferType GetType() const { return _type; }
@@ -120,6 +134,7 @@ public:
 
 	// Inherited from IGraphicsResource
 	virtual GlResourceType GetResourceClass() const override;
+	virtual size_t GetGpuMemoryUsage() const override { return _size; }
 
 protected:
 	/// <summary>
@@ -134,4 +149,5 @@ protected:
 	uint32_t _size; // The size of the buffer in bytes
 	BufferUsage _usage; // The buffer usage mode (GL_STATIC_DRAW, GL_DYNAMIC_DRAW)
 	BufferType _type; // The buffer type (ex GL_ARRAY_BUFFER, GL_ARRAY_ELEMENT_BUFFER)
+	bool _isImmutable; // True once storage has been allocated with glNamedBufferStorage
 };
@@ -3,6 +3,8 @@
 #include <cstdint>
 #include <stdexcept>
 #include <memory>
+#include <vector>
+#include <cstring>
 #include <EnumToString.h>
 
 #include "Graphics/GlEnums.h"
@@ -43,6 +45,18 @@ public:
 		_elementType = elementType;
 	}
 
+	/// <summary>
+	/// Allocates immutable storage for our index buffer and fills it with data, see IBuffer::LoadStorage
+	/// </summary>
+	/// <param name="data">The pointer to the data to load in</param>
+	/// <param name="elementSize">The size of a single element, in bytes</param>
+	/// <param name="elementCount">The number of elements to upload</param>
+	/// <param name="elementType">The type of elements you are storing (GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT)</param>
+	inline void LoadStorage(const void* data, uint32_t elementSize, uint32_t elementCount, IndexType elementType) {
+		IBuffer::LoadStorage(data, elementSize, elementCount);
+		_elementType = elementType;
+	}
+
 	/// <summary>
 	/// Loads data of a known type into this index buffer
 	/// </summary>
@@ -52,6 +66,63 @@ public:
 	template <typename T>
 	void LoadData(const T* data, uint32_t count) { throw std::runtime_error("Must be one of uint8_t, uint16_t or uint32_t"); } // Note, see template specializations below
 
+	/// <summary>
+	/// Loads 32 bit indices into this buffer, storing them as 16 bit indices if that's enough to
+	/// address every vertex (see GetSmallestType). This halves the size of most meshes' index buffers
+	/// </summary>
+	/// <param name="data">A pointer to the start of the indices</param>
+	/// <param name="count">The number of indices to upload</param>
+	/// <param name="vertexCount">The number of vertices that the indices refer to</param>
+	void LoadIndices(const uint32_t* data, uint32_t count, size_t vertexCount) {
+		IndexType type = GetSmallestType(vertexCount);
+		if (type == IndexType::UInt) {
+			LoadData(data, count);
+		} else {
+			std::vector<uint8_t> converted = ConvertIndices(data, count, type);
+			LoadData(converted.data(), static_cast<uint32_t>(GetIndexTypeSize(type)), count, type);
+		}
+	}
+
+	/// <summary>
+	/// Gets the smallest index type that can address the given number of vertices. We never pick UByte,
+	/// since most hardware converts those to 16 bit indices anyways
+	/// </summary>
+	/// <param name="vertexCount">The number of vertices that will be indexed</param>
+	static IndexType GetSmallestType(size_t vertexCount) {
+		return vertexCount <= 65536 ? IndexType::UShort : IndexType::UInt;
+	}
+
+	/// <summary>
+	/// Converts 32 bit indices into the given index type, the indices must all fit in the type
+	/// </summary>
+	/// <param name="data">A pointer to the start of the indices</param>
+	/// <param name="count">The number of indices to convert</param>
+	/// <param name="type">The type of index to convert to</param>
+	/// <returns>The raw bytes of the converted indices</returns>
+	static std::vector<uint8_t> ConvertIndices(const uint32_t* data, size_t count, IndexType type) {
+		std::vector<uint8_t> result(count * GetIndexTypeSize(type));
+		switch (type) {
+			case IndexType::UByte:
+				for (size_t ix = 0; ix < count; ix++) {
+					result[ix] = static_cast<uint8_t>(data[ix]);
+				}
+				break;
+			case IndexType::UShort:
+				for (size_t ix = 0; ix < count; ix++) {
+					uint16_t index = static_cast<uint16_t>(data[ix]);
+					memcpy(result.data() + ix * sizeof(uint16_t), &index, sizeof(uint16_t));
+				}
+				break;
+			case IndexType::UInt:
+				memcpy(result.data(), data, count * sizeof(uint32_t));
+				break;
+			case IndexType::Unknown:
+			default:
+				break;
+		}
+		return result;
+	}
+
 	/// <summary>
 	/// Gets the underlying index type for this buffer (GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT, GL_UNSIGNED_INT)
 	/// </summary>
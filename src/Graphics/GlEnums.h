@@ -192,6 +192,38 @@ constexpr size_t GetTexelSize(PixelFormat format, PixelType type) {
 	return GetTexelComponentSize(type) * GetTexelComponentCount(format);
 }
 
+/*
+ * Estimates the number of bytes the driver uses to store a single texel of the given internal format.
+ * Drivers tend to pad 3 component formats out to 4 components, so we assume that they do
+ * @param format The internal format of the texture
+ * @returns The estimated size of a single texel, or 0 if the format is unknown
+ */
+constexpr size_t GetInternalFormatSize(InternalFormat format) {
+	switch (format) {
+		case InternalFormat::R8:
+			return 1;
+		case InternalFormat::R16:
+		case InternalFormat::RG8:
+			return 2;
+		case InternalFormat::Depth:
+		case InternalFormat::DepthStencil:
+		case InternalFormat::RGB8:
+		case InternalFormat::SRGB:
+		case InternalFormat::RGB10:
+		case InternalFormat::RGBA8:
+		case InternalFormat::SRGBA:
+			return 4;
+		case InternalFormat::RGB16:
+		case InternalFormat::RGBA16:
+			return 8;
+		case InternalFormat::RGB32F:
+		case InternalFormat::RGB32AF:
+			return 16;
+		default:
+			return 0;
+	}
+}
+
 
 /*
 	* Represents the type of data used in a shader in a more useful format for us
@@ -13,6 +13,7 @@ IndexBuffer::Sptr GuiBatcher::__ibo = nullptr;
 
 Texture2D::Sptr GuiBatcher::__defaultUITexture = nullptr;
 int GuiBatcher::__defaultEdgeRadius = 0;
+GuiBatcher::DrawList* GuiBatcher::__captureList = nullptr;
 
 VertexBuffer::Sptr GuiBatcher::__vbo = nullptr;
 ShaderProgram::Sptr GuiBatcher::__shader = nullptr;
@@ -33,6 +34,7 @@ void GuiBatcher::PushRect(const glm::vec2& min, const glm::vec2& max, const glm:
 		
 	// Grab mesh info for the texture batch
 	MeshData& mesh = _meshBuilders[tex.get()];
+	mesh.Texture = tex;
 	// We can use the vertex count for depth, so that things drawn later have a bit of spacing
 	float depth = mesh.Builder.GetVertexCount() / 1000.0f;
 
@@ -113,6 +115,7 @@ void GuiBatcher::RenderText(const std::wstring& text, const Font::Sptr& font, co
 	// Grab the mesh builder and make sure it's a texture batch
 	MeshData& mesh = _meshBuilders[atlas.get()];
 	mesh.IsFont = true;
+	mesh.Texture = atlas;
 
 	// Allocate some space for the vertices
 	VertexPosColTex verts[4];
@@ -188,26 +191,77 @@ void GuiBatcher::Flush()
 
 	// Iterate over each texture and it's mesh
 	for (auto&[key, value] : _meshBuilders) {
-		Texture2D* tex = key;
 		// If the texture exists and the mesh has data
-		if (tex != nullptr && value.Builder.GetIndexCount() > 0) {
-			// Update the VAO and it's buffers
-			__vao->Bind();
-			__vbo->UpdateData(value.Builder.GetVertexDataPtr(), sizeof(VertexPosColTex), value.Builder.GetVertexCount(), true);
-			__ibo->UpdateData(value.Builder.GetIndexDataPtr(), sizeof(uint32_t), value.Builder.GetIndexCount(), true);
-
-			// Bind texture, send uniforms to shader
-			tex->Bind(0);
-			ShaderProgram::Sptr shader = value.IsFont ? __fontShader : __shader;
-			shader->Bind();
-			shader->SetUniformMatrix(0, &__projection, 1, false);
-
-			// Draw geometry
-			__vao->Draw();
+		if (key != nullptr && value.Builder.GetIndexCount() > 0) {
+			if (__captureList != nullptr) {
+				// Hand the geometry over to the list, the builder we get back is reset below
+				DrawList::Batch& batch = __captureList->Batches.emplace_back();
+				batch.Texture = value.Texture;
+				batch.IsFont = value.IsFont;
+				batch.SetsScissor = false;
+				std::swap(batch.Builder, value.Builder);
+			} else {
+				__DrawBatch(value.Texture, value.IsFont, value.Builder, __projection);
+			}
 
 			// Clear mesh
 			value.Builder.Reset();
 		}
+		value.Texture = nullptr;
+	}
+}
+
+void GuiBatcher::BeginCapture(DrawList& list) {
+	LOG_ASSERT(__captureList == nullptr, "GUI capture is already in progress");
+	list.Batches.clear();
+	list.Projection = __projection;
+	__captureList = &list;
+}
+
+void GuiBatcher::EndCapture() {
+	LOG_ASSERT(__captureList != nullptr, "No GUI capture is in progress");
+	Flush();
+	__captureList = nullptr;
+}
+
+void GuiBatcher::Draw(const DrawList& list) {
+	for (const DrawList::Batch& batch : list.Batches) {
+		if (batch.SetsScissor) {
+			glScissor(batch.Scissor.x, batch.Scissor.y, batch.Scissor.z, batch.Scissor.w);
+		}
+		if (batch.Texture != nullptr) {
+			__DrawBatch(batch.Texture, batch.IsFont, batch.Builder, list.Projection);
+		}
+	}
+}
+
+void GuiBatcher::__DrawBatch(const Texture2D::Sptr& tex, bool isFont, const MeshBuilder<VertexPosColTex>& builder, const glm::mat4& projection) {
+	__StaticInit();
+
+	// Update the VAO and it's buffers
+	__vao->Bind();
+	__vbo->UpdateData(builder.GetVertexDataPtr(), sizeof(VertexPosColTex), builder.GetVertexCount(), true);
+	__ibo->UpdateData(builder.GetIndexDataPtr(), sizeof(uint32_t), builder.GetIndexCount(), true);
+
+	// Bind texture, send uniforms to shader
+	tex->Bind(0);
+	ShaderProgram::Sptr shader = isFont ? __fontShader : __shader;
+	shader->Bind();
+	shader->SetUniformMatrix(0, &projection, 1, false);
+
+	// Draw geometry
+	__vao->Draw();
+}
+
+void GuiBatcher::__SetScissor(int x, int y, int width, int height) {
+	if (__captureList != nullptr) {
+		DrawList::Batch& batch = __captureList->Batches.emplace_back();
+		batch.Texture = nullptr;
+		batch.IsFont = false;
+		batch.SetsScissor = true;
+		batch.Scissor = glm::ivec4(x, y, width, height);
+	} else {
+		glScissor(x, y, width, height);
 	}
 }
 
@@ -355,7 +409,7 @@ void GuiBatcher::PushScissorRect(const glm::vec2& min, const glm::vec2& max) {
 
 	// Draw current geo with the current scissor, then update it
 	Flush();
-	glScissor(minWin.x, maxWin.y, width, height);
+	__SetScissor(minWin.x, maxWin.y, width, height);
 }
 
 void GuiBatcher::PopScissorRect() {
@@ -371,7 +425,7 @@ void GuiBatcher::PopScissorRect() {
 
 	// Draw current geo with the current scissor, then update it
 	Flush();
-	glScissor(glm::min(bounds.Min.x, bounds.Max.x), glm::min(bounds.Min.y, bounds.Max.y), width, height);
+	__SetScissor(glm::min(bounds.Min.x, bounds.Max.x), glm::min(bounds.Min.y, bounds.Max.y), width, height);
 }
 
 void GuiBatcher::SetDefaultTexture(const Texture2D::Sptr& value) {
@@ -16,6 +16,25 @@
 	/// </summary>
 	class GuiBatcher {
 	public:
+		/// <summary>
+		/// GUI geometry that has been captured instead of drawn, so that it can be drawn later
+		/// without walking the scene again. See BeginCapture
+		/// </summary>
+		struct DrawList {
+			struct Batch {
+				// The texture to draw with, or null if the batch only changes the scissor rect
+				Texture2D::Sptr Texture;
+				bool            IsFont;
+				// When set, the scissor rect (x, y, width, height) is changed before the batch is drawn
+				bool            SetsScissor;
+				glm::ivec4      Scissor;
+				MeshBuilder<VertexPosColTex> Builder;
+			};
+
+			glm::mat4          Projection = glm::mat4(1.0f);
+			std::vector<Batch> Batches;
+		};
+
 		/// <summary>
 		/// Adds a rectangle to the GUI batch, with a given border radius in pixels.
 		/// This can be used with textures to create rounded borders
@@ -70,6 +89,24 @@
 		/// </summary>
 		static void Flush();
 
+		/// <summary>
+		/// Starts capturing the GUI into a draw list instead of drawing it. Until EndCapture
+		/// is called, flushes and scissor changes are recorded into the list and nothing is
+		/// sent to OpenGL, so the GUI can be walked while the scene is safe to read and drawn
+		/// at some later point in the frame
+		/// </summary>
+		/// <param name="list">The list to capture into, any existing batches are cleared</param>
+		static void BeginCapture(DrawList& list);
+		/// <summary>
+		/// Stops capturing into the draw list passed to BeginCapture, flushing any geometry
+		/// that has not been flushed yet
+		/// </summary>
+		static void EndCapture();
+		/// <summary>
+		/// Draws a list that was recorded with BeginCapture and EndCapture
+		/// </summary>
+		static void Draw(const DrawList& list);
+
 		/// <summary>
 		/// Push a new transform to the stack, this will be multiplied with the
 		/// existing transformation
@@ -121,6 +158,8 @@
 		struct MeshData {
 			MeshBuilder<VertexPosColTex> Builder;
 			bool IsFont;
+			// Keeps the texture alive until the geometry is flushed, since captured geometry may outlive it's object
+			Texture2D::Sptr Texture;
 		};
 
 		static glm::ivec2 __windowSize;
@@ -138,5 +177,12 @@
 		static Texture2D::Sptr __defaultUITexture;
 		static int __defaultEdgeRadius;
 
+		// The list being captured into, or null if we are drawing directly
+		static DrawList* __captureList;
+
 		static void __StaticInit();
+		// Sends a batch of geometry to OpenGL
+		static void __DrawBatch(const Texture2D::Sptr& tex, bool isFont, const MeshBuilder<VertexPosColTex>& builder, const glm::mat4& projection);
+		// Sets the OpenGL scissor rect, or records it if we are capturing
+		static void __SetScissor(int x, int y, int width, int height);
 	};
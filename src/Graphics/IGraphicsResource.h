@@ -58,6 +58,16 @@ public:
 	 */
 	virtual uint32_t GetHandle() const;
 
+	/**
+	 * Gets an estimate of how much video memory this resource is using, in bytes
+	 */
+	virtual size_t GetGpuMemoryUsage() const { return 0; }
+	/**
+	 * Gets an estimate of how much system memory this resource is holding on to, in bytes,
+	 * not counting the size of the object itself
+	 */
+	virtual size_t GetCpuMemoryUsage() const { return 0; }
+
 protected:
 	IGraphicsResource();
 	
@@ -5,7 +5,8 @@ bool ITexture::__isStaticInit = false;
 
 ITexture::ITexture(TextureType type) :
 	IGraphicsResource(),
-	_type(type)
+	_type(type),
+	_isDirty(true)
 {
 	__StaticInit();
 	_Recreate();
@@ -47,6 +48,30 @@ GlResourceType ITexture::GetResourceClass() const {
 	return GlResourceType::Texture;
 }
 
+ResourceMemoryUsage ITexture::GetMemoryUsage() const {
+	return { GetCpuMemoryUsage(), GetGpuMemoryUsage() };
+}
+
+size_t ITexture::_EstimateMemoryUsage(InternalFormat format, uint32_t width, uint32_t height, uint32_t depth, bool hasMipMaps) {
+	if ((size_t)width * height * depth == 0) {
+		return 0;
+	}
+
+	// Each mip level halves every dimension until they all hit 1
+	size_t texelSize = GetInternalFormatSize(format);
+	size_t result = 0;
+	while (true) {
+		result += (size_t)width * height * depth * texelSize;
+		if (!hasMipMaps || (width == 1 && height == 1 && depth == 1)) {
+			break;
+		}
+		width  = glm::max(width  / 2, 1u);
+		height = glm::max(height / 2, 1u);
+		depth  = glm::max(depth  / 2, 1u);
+	}
+	return result;
+}
+
 void ITexture::__StaticInit()
 {
 	// If we've already run the static initializer, abort now
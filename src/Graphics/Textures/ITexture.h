@@ -52,15 +52,38 @@ public:
 
 	virtual GlResourceType GetResourceClass() const override;
 
+	// Inherited from IResource
+
+	virtual ResourceMemoryUsage GetMemoryUsage() const override;
+	virtual bool IsDirty() const override { return _isDirty; }
+	virtual void ClearDirty() override { _isDirty = false; }
+
 protected:
 	ITexture(TextureType type);
 
+	/// <summary>
+	/// Flags the texture as needing to be written to the manifest again, should be called
+	/// whenever anything that ToJson writes changes
+	/// </summary>
+	void _MarkDirty() { _isDirty = true; _ContentChanged(); }
+
+	/// <summary>
+	/// Estimates how much video memory a texture with the given dimensions uses
+	/// </summary>
+	/// <param name="format">The internal format of the texture</param>
+	/// <param name="width">The width of the first level, in texels</param>
+	/// <param name="height">The height of the first level, in texels</param>
+	/// <param name="depth">The depth of the first level, in texels</param>
+	/// <param name="hasMipMaps">True if the texture has a full chain of mip levels</param>
+	static size_t _EstimateMemoryUsage(InternalFormat format, uint32_t width, uint32_t height, uint32_t depth, bool hasMipMaps);
+
 	/// <summary>
 	/// Recreates the texture, for instance when we want to resize an image
 	/// </summary>
 	virtual void _Recreate();
 
 	TextureType _type; // The type for this texture, mainly used for debugging
+	bool _isDirty; // True if the texture has changed since it was last written to the manifest
 
 // STATIC SECTION
 private:
@@ -1,5 +1,5 @@
 #include "Texture1D.h"
-#include "Utils/Base64.h"
+#include "Utils/BlobStore.h"
 #include "Utils/JsonGlmHelpers.h"
 #include <stb_image.h>
 
@@ -31,16 +31,19 @@ Texture1D::Texture1D(const Texture1DDescription& description) :
 void Texture1D::SetMinFilter(MinFilter value) {
 	_description.MinificationFilter = value;
 	glTextureParameteri(_rendererId, GL_TEXTURE_MIN_FILTER, *_description.MinificationFilter);
+	_MarkDirty();
 }
 
 void Texture1D::SetMagFilter(MagFilter value) {
 	_description.MagnificationFilter = value;
 	glTextureParameteri(_rendererId, GL_TEXTURE_MAG_FILTER, *_description.MagnificationFilter);
+	_MarkDirty();
 }
 
 void Texture1D::SetWrap(WrapMode value) {
 	_description.Wrap = value;
 	glTextureParameteri(_rendererId, GL_TEXTURE_WRAP_S, *_description.Wrap);
+	_MarkDirty();
 }
 
 void Texture1D::LoadData(uint32_t size, PixelFormat format, PixelType type, void* data, uint32_t offset /*= 0*/)
@@ -57,6 +60,7 @@ void Texture1D::LoadData(uint32_t size, PixelFormat format, PixelType type, void
 
 	// Upload our data to our image
 	glTextureSubImage1D(_rendererId, 0, offset, size, (GLenum)format, (GLenum)type, data);
+	_MarkDirty();
 
 	// If requested, generate mip-maps for our texture
 	if (_description.GenerateMipMaps) {
@@ -64,6 +68,10 @@ void Texture1D::LoadData(uint32_t size, PixelFormat format, PixelType type, void
 	}
 }
 
+size_t Texture1D::GetGpuMemoryUsage() const {
+	return _EstimateMemoryUsage(_description.Format, _description.Size, 1, 1, _description.GenerateMipMaps);
+}
+
 nlohmann::json Texture1D::ToJson() const
 {
 	nlohmann::json result = {
@@ -83,9 +91,9 @@ nlohmann::json Texture1D::ToJson() const
 
 		if (_description.Size > 0 && _description.FormatHint != PixelFormat::Unknown) {
 			size_t dataSize = GetTexelSize(_description.FormatHint, _pixelType) * _description.Size;
-			uint8_t* dataStore = new uint8_t[dataSize];
-			glGetTextureImage(_rendererId, 0, *_description.Format, *_pixelType, dataSize, dataStore);
-			result["data"] = Base64::Encode(dataStore, dataSize);
+			std::vector<uint8_t> dataStore(dataSize);
+			glGetTextureImage(_rendererId, 0, *_description.FormatHint, *_pixelType, static_cast<GLsizei>(dataSize), dataStore.data());
+			result["data"] = BlobStore::Write(dataStore.data(), dataSize);
 		}
 	}
 	return result;
@@ -105,14 +113,14 @@ Texture1D::Sptr Texture1D::FromJson(const nlohmann::json& data)
 	Texture1D::Sptr result = std::make_shared<Texture1D>(description);
 
 	// If we embedded data into the JSON, load it now
-	if (description.Filename.empty() && data.contains("data") && data["data"].is_string()) {
+	if (description.Filename.empty() && data.contains("data") && BlobStore::IsBlob(data["data"])) {
 		PixelType type = JsonParseEnum(PixelType, data, "pixel_type", PixelType::Unknown);
 		try {
-			std::string rawData = Base64::Decode(data['data'].get<std::string>());
+			std::string rawData = BlobStore::Read(data["data"]);
 			result->LoadData(description.Size, description.FormatHint, type, rawData.data());
 		}
-		catch (std::runtime_error()) {
-			LOG_WARN("JSON blob had data, but failed to load to texture");
+		catch (const std::runtime_error& e) {
+			LOG_WARN("JSON blob had data, but failed to load to texture: {}", e.what());
 		}
 	}
 
@@ -3,7 +3,8 @@
 #include <Logging.h>
 #include "GLM/glm.hpp"
 #include "Utils/JsonGlmHelpers.h"
-#include "Utils/Base64.h"
+#include "Utils/BlobStore.h"
+#include "Utils/FileHelpers.h"
 
 /// <summary>
 /// Get the number of mipmap levels required for a texture of the given size
@@ -30,43 +31,128 @@ nlohmann::json Texture2D::ToJson() const {
 	}
 	else if (_pixelType != PixelType::Unknown) {
 		result["size_x"] = _description.Width;
-		result["size_y"] = _description.Width;
+		result["size_y"] = _description.Height;
 
 		result["format"] = ~_description.FormatHint;
+		result["internal_format"] = ~_description.Format;
 		result["pixel_type"] = ~_pixelType;
 		if (_description.Width * _description.Height > 0 && _description.FormatHint != PixelFormat::Unknown) {
+			// Generated textures only live on the GPU, so we have to read them back
 			size_t dataSize = GetTexelSize(_description.FormatHint, _pixelType) * _description.Width * _description.Height;
-			uint8_t* dataStore = new uint8_t[dataSize];
-			glGetTextureImage(_rendererId, 0, *_description.Format, *_pixelType, dataSize, dataStore);
-			result["data"] = Base64::Encode(dataStore, dataSize);
+			std::vector<uint8_t> dataStore(dataSize);
+			glGetTextureImage(_rendererId, 0, *_description.FormatHint, *_pixelType, static_cast<GLsizei>(dataSize), dataStore.data());
+			result["data"] = BlobStore::Write(dataStore.data(), dataSize);
 		}
 	}
 
 	return result;
 }
 
-Texture2D::Sptr Texture2D::FromJson(const nlohmann::json& data)
-{
+/// <summary>
+/// Parses the description of a texture from it's JSON manifest entry
+/// </summary>
+inline Texture2DDescription ParseDescription(const nlohmann::json& data) {
 	Texture2DDescription descr = Texture2DDescription();
-	descr.Filename = data["filename"];
+	descr.Filename = JsonGet<std::string>(data, "filename", "");
 	descr.HorizontalWrap = JsonParseEnum(WrapMode, data, "wrap_s", WrapMode::ClampToEdge);
 	descr.VerticalWrap   = JsonParseEnum(WrapMode, data, "wrap_t", WrapMode::ClampToEdge);
 	descr.MinificationFilter  = JsonParseEnum(MinFilter, data, "filter_min", MinFilter::NearestMipNearest);
 	descr.MagnificationFilter = JsonParseEnum(MagFilter, data, "filter_mag", MagFilter::Linear);
 	descr.MaxAnisotropic      = JsonGet(data, "anisotropic", 0.0f);
 	descr.GenerateMipMaps     = JsonGet(data, "generate_mipmaps", false);
+	return descr;
+}
+
+std::function<Texture2D::Sptr()> Texture2D::PrepareFromJson(const nlohmann::json& data, JobSystem* jobs)
+{
+	Texture2DDescription descr = ParseDescription(data);
+
+	// Embedded or generated textures have nothing to decode ahead of time
+	if (descr.Filename.empty()) {
+		return [data]() { return FromJson(data); };
+	}
+
+	// Decode the image now, on whatever thread we were called from. Note that the flip flag is global
+	// in STBI, but every texture in the project loads flipped so racing on it is harmless
+	int width = 0, height = 0, numChannels = 0;
+	const int targetChannels = GetTexelComponentCount(descr.FormatHint);
+	stbi_set_flip_vertically_on_load(true);
+	std::shared_ptr<uint8_t> image(stbi_load(descr.Filename.c_str(), &width, &height, &numChannels, targetChannels), stbi_image_free);
+	if (targetChannels != 0) {
+		numChannels = targetChannels;
+	}
+
+	// The GL side of loading happens later on the main thread
+	return [descr, image, width, height, numChannels]() {
+		Texture2DDescription uploadDescr = descr;
+		uploadDescr.Filename.clear();
+
+		Texture2D::Sptr result = std::make_shared<Texture2D>(uploadDescr);
+		result->_description.Filename = descr.Filename;
+		if (image == nullptr) {
+			LOG_WARN("STBI Failed to load image from \"{}\"", descr.Filename);
+		} else {
+			result->_UploadImage(width, height, numChannels, image.get());
+		}
+		result->SetDebugName(descr.Filename);
+		return result;
+	};
+}
+
+std::string Texture2D::GetContentKey(const Texture2DDescription& description) {
+	if (description.Filename.empty()) {
+		return "";
+	}
+	uint64_t hash = FileHelpers::HashFile(description.Filename);
+	if (hash == 0) {
+		return "";
+	}
+
+	// Anything that changes how the image ends up on the GPU needs to be part of the key
+	return std::to_string(hash) +
+		":" + std::to_string(*description.HorizontalWrap) +
+		":" + std::to_string(*description.VerticalWrap) +
+		":" + std::to_string(*description.MinificationFilter) +
+		":" + std::to_string(*description.MagnificationFilter) +
+		":" + std::to_string(description.MaxAnisotropic) +
+		":" + std::to_string(description.GenerateMipMaps) +
+		":" + std::to_string(description.MultisampleCount) +
+		":" + std::to_string(*description.Format) +
+		":" + std::to_string(*description.FormatHint);
+}
+
+std::string Texture2D::GetContentKey(const std::string& filePath) {
+	Texture2DDescription description = Texture2DDescription();
+	description.Filename = filePath;
+	return GetContentKey(description);
+}
+
+Texture2D::Sptr Texture2D::FromJson(const nlohmann::json& data)
+{
+	Texture2DDescription descr = ParseDescription(data);
+
+	// Embedded textures need to know their size up front so the storage can be allocated
+	if (descr.Filename.empty()) {
+		descr.Width  = JsonGet(data, "size_x", descr.Width);
+		descr.Height = JsonGet(data, "size_y", descr.Height);
+		descr.FormatHint = JsonParseEnum(PixelFormat, data, "format", descr.FormatHint);
+		descr.Format = JsonParseEnum(InternalFormat, data, "internal_format", InternalFormat::Unknown);
+		if (descr.Format == InternalFormat::Unknown && descr.FormatHint != PixelFormat::Unknown) {
+			descr.Format = GetInternalFormatForChannels8(GetTexelComponentCount(descr.FormatHint));
+		}
+	}
 
 	Texture2D::Sptr result = std::make_shared<Texture2D>(descr);
 
 	// If we embedded data into the JSON, load it now
-	if (descr.Filename.empty() && data.contains("data") && data["data"].is_string()) {
+	if (descr.Filename.empty() && data.contains("data") && BlobStore::IsBlob(data["data"])) {
 		PixelType type = JsonParseEnum(PixelType, data, "pixel_type", PixelType::Unknown);
 		try {
-			std::string rawData = Base64::Decode(data['data'].get<std::string>());
+			std::string rawData = BlobStore::Read(data["data"]);
 			result->LoadData(descr.Width, descr.Height, descr.FormatHint, type, rawData.data());
 		}
-		catch (std::runtime_error()) {
-			LOG_WARN("JSON blob had data, but failed to load to texture");
+		catch (const std::runtime_error& e) {
+			LOG_WARN("JSON blob had data, but failed to load to texture: {}", e.what());
 		}
 	}
 
@@ -94,10 +180,18 @@ Texture2D::Texture2D(const std::string& filePath) :
 	_LoadDataFromFile();
 }
 
+size_t Texture2D::GetGpuMemoryUsage() const {
+	if (_description.MultisampleCount > 1) {
+		return _EstimateMemoryUsage(_description.Format, _description.Width, _description.Height, 1, false) * _description.MultisampleCount;
+	}
+	return _EstimateMemoryUsage(_description.Format, _description.Width, _description.Height, 1, _description.GenerateMipMaps);
+}
+
 void Texture2D::SetMinFilter(MinFilter value) {
 	if (_description.MultisampleCount == 1) {
 		_description.MinificationFilter = value;
 		glTextureParameteri(_rendererId, GL_TEXTURE_MIN_FILTER, *_description.MinificationFilter);
+		_MarkDirty();
 	}
 	else {
 		LOG_WARN("Attempted to set minification filter on a multisampled texture, ignoring");
@@ -108,6 +202,7 @@ void Texture2D::SetMagFilter(MagFilter value) {
 	if (_description.MultisampleCount == 1) {
 		_description.MagnificationFilter = value;
 		glTextureParameteri(_rendererId, GL_TEXTURE_MAG_FILTER, *_description.MagnificationFilter);
+		_MarkDirty();
 	} else {
 		LOG_WARN("Attempted to set magnification filter on a multisampled texture, ignoring");
 	}
@@ -117,6 +212,7 @@ void Texture2D::SetAnisoLevel(float value) {
 	if (value != _description.MaxAnisotropic) {
 		_description.MaxAnisotropic = glm::clamp(value, 1.0f, ITexture::GetLimits().MAX_ANISOTROPY);
 		glTextureParameterf(_rendererId, GL_TEXTURE_MAX_ANISOTROPY, _description.MaxAnisotropic);
+		_MarkDirty();
 
 		if (_description.GenerateMipMaps) {
 			glGenerateTextureMipmap(_rendererId);
@@ -139,6 +235,7 @@ void Texture2D::LoadData(uint32_t width, uint32_t height, PixelFormat format, Pi
 
 	// Upload our data to our image
 	glTextureSubImage2D(_rendererId, 0, offsetX, offsetY, width, height, (GLenum)format, (GLenum)type, data);
+	_MarkDirty();
 
 	// If requested, generate mip-maps for our texture
 	if (_description.GenerateMipMaps) {
@@ -164,33 +261,11 @@ void Texture2D::_LoadDataFromFile() {
 			return ;
 		}
 
-		// We should estimate a good format for our data
-
 		// numChannels will store the number of channels in the image on disk, if we overrode that we should use the override value
 		if (targetChannels != 0)
 			numChannels = targetChannels;
 
-		// We'll determine a recommended format for the image based on number of channels
-		// We hinted that we wanted a certain number of channels, but we're not guaranteed
-		// that all those channels exist (ex: loading an RGB image but requesting RGBA)
-		InternalFormat internal_format = GetInternalFormatForChannels8(numChannels);
-		PixelFormat    image_format = GetPixelFormatForChannels(numChannels);
-
-		// This is one of those poorly documented things in OpenGL
-		if ((numChannels * width) % 4 != 0) {
-			LOG_WARN("The alignment of a horizontal line is not a multiple of 4, this will require a call to glPixelStorei(GL_PACK_ALIGNMENT)");
-		}
-
-		// Update our description to match what we loaded
-		_description.Format = internal_format;
-		_description.Width = width;
-		_description.Height = height;
-
-		// Allocates our memory
-		_SetTextureParams();
-
-		// Upload data to our texture
-		LoadData(width, height, image_format, PixelType::UByte, data);
+		_UploadImage(width, height, numChannels, data);
 
 		// We now have data in the image, we can clear the STBI data
 		stbi_image_free(data);
@@ -199,6 +274,32 @@ void Texture2D::_LoadDataFromFile() {
 	SetDebugName(_description.Filename);
 }
 
+void Texture2D::_UploadImage(int width, int height, int numChannels, uint8_t* data) {
+	// We should estimate a good format for our data
+
+	// We'll determine a recommended format for the image based on number of channels
+	// We hinted that we wanted a certain number of channels, but we're not guaranteed
+	// that all those channels exist (ex: loading an RGB image but requesting RGBA)
+	InternalFormat internal_format = GetInternalFormatForChannels8(numChannels);
+	PixelFormat    image_format = GetPixelFormatForChannels(numChannels);
+
+	// This is one of those poorly documented things in OpenGL
+	if ((numChannels * width) % 4 != 0) {
+		LOG_WARN("The alignment of a horizontal line is not a multiple of 4, this will require a call to glPixelStorei(GL_PACK_ALIGNMENT)");
+	}
+
+	// Update our description to match what we loaded
+	_description.Format = internal_format;
+	_description.Width = width;
+	_description.Height = height;
+
+	// Allocates our memory
+	_SetTextureParams();
+
+	// Upload data to our texture
+	LoadData(width, height, image_format, PixelType::UByte, data);
+}
+
 void Texture2D::_SetTextureParams() {
 	// If we have a multisampled texture, and the current type is 2D, change it to 2D multisampled
 	if (_description.MultisampleCount > 1 && _type == TextureType::_2D) {
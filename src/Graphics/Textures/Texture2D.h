@@ -1,6 +1,9 @@
 #pragma once
+#include <functional>
 #include "ITexture.h"
 
+class JobSystem;
+
 /// <summary>
 /// Describes all parameters we can manipulate with our 2D Textures
 /// </summary>
@@ -141,8 +144,28 @@ public:
 	/// </summary>
 	const Texture2DDescription& GetDescription() const { return _description; }
 
+	virtual size_t GetGpuMemoryUsage() const override;
+	virtual bool CanReload() const override { return !_description.Filename.empty(); }
+
 	virtual nlohmann::json ToJson() const override;
 	static Texture2D::Sptr FromJson(const nlohmann::json& data);
+	/// <summary>
+	/// Reads and decodes the image for a manifest entry without touching OpenGL, so that it may
+	/// be called from a worker thread. The returned function creates the texture, and must be
+	/// invoked on the main thread
+	/// </summary>
+	/// <param name="data">The manifest entry for the texture</param>
+	/// <param name="jobs">Unused, images are decoded on the calling thread</param>
+	static std::function<Texture2D::Sptr()> PrepareFromJson(const nlohmann::json& data, JobSystem* jobs);
+
+	/// <summary>
+	/// Gets a key that identifies the texture that would be created from the given description,
+	/// based on the contents of the source file and all of the loading parameters. Textures that
+	/// share a key are identical (see ResourceManager::CreateAsset)
+	/// </summary>
+	/// <returns>The key for the texture, or an empty string if the texture is not loaded from a file</returns>
+	static std::string GetContentKey(const Texture2DDescription& description);
+	static std::string GetContentKey(const std::string& filePath);
 
 protected:
 	Texture2DDescription _description;
@@ -154,6 +177,11 @@ protected:
 	/// </summary>
 	void _LoadDataFromFile();
 	/// <summary>
+	/// Allocates this texture to fit a decoded 8 bit image, and uploads the image data
+	/// Will overwrite description size and format
+	/// </summary>
+	void _UploadImage(int width, int height, int numChannels, uint8_t* data);
+	/// <summary>
 	/// Allocates our texture's memory and sets sampling / filtering parameters
 	/// </summary>
 	void _SetTextureParams();
@@ -1,5 +1,5 @@
 #include "Texture3D.h"
-#include "Utils/Base64.h"
+#include "Utils/BlobStore.h"
 #include "Utils/JsonGlmHelpers.h"
 #include "Utils/StringUtils.h"
 #include <Logging.h>
@@ -36,12 +36,14 @@ void Texture3D::SetMinFilter(MinFilter value)
 {
 	_description.MinificationFilter = value;
 	glTextureParameteri(_rendererId, GL_TEXTURE_MIN_FILTER, *_description.MinificationFilter);
+	_MarkDirty();
 }
 
 void Texture3D::SetMagFilter(MagFilter value)
 {
 	_description.MagnificationFilter = value;
 	glTextureParameteri(_rendererId, GL_TEXTURE_MAG_FILTER, *_description.MagnificationFilter);
+	_MarkDirty();
 }
 
 void Texture3D::LoadData(uint32_t width, uint32_t height, uint32_t depth, PixelFormat format, PixelType type, void* data, uint32_t offsetX /*= 0*/, uint32_t offsetY /*= 0*/, uint32_t offsetZ /*= 0*/)
@@ -58,6 +60,7 @@ void Texture3D::LoadData(uint32_t width, uint32_t height, uint32_t depth, PixelF
 
 	// Upload our data to our image
 	glTextureSubImage3D(_rendererId, 0, offsetX, offsetY, offsetZ, width, height, depth, (GLenum)format, (GLenum)type, data);
+	_MarkDirty();
 
 	// If requested, generate mip-maps for our texture
 	if (_description.GenerateMipMaps) {
@@ -65,6 +68,10 @@ void Texture3D::LoadData(uint32_t width, uint32_t height, uint32_t depth, PixelF
 	}
 }
 
+size_t Texture3D::GetGpuMemoryUsage() const {
+	return _EstimateMemoryUsage(_description.Format, _description.Width, _description.Height, _description.Depth, _description.GenerateMipMaps);
+}
+
 nlohmann::json Texture3D::ToJson() const
 {
 	nlohmann::json result = {
@@ -89,9 +96,9 @@ nlohmann::json Texture3D::ToJson() const
 
 		if ((_description.Width * _description.Height * _description.Depth) > 0 && _description.FormatHint != PixelFormat::Unknown) {
 			size_t dataSize = GetTexelSize(_description.FormatHint, _pixelType) * _description.Width * _description.Height * _description.Depth;
-			uint8_t* dataStore = new uint8_t[dataSize];
-			glGetTextureImage(_rendererId, 0, *_description.Format, *_pixelType, dataSize, dataStore);
-			result["data"] = Base64::Encode(dataStore, dataSize);
+			std::vector<uint8_t> dataStore(dataSize);
+			glGetTextureImage(_rendererId, 0, *_description.FormatHint, *_pixelType, static_cast<GLsizei>(dataSize), dataStore.data());
+			result["data"] = BlobStore::Write(dataStore.data(), dataSize);
 		}
 	}
 	return result;
@@ -118,14 +125,14 @@ Texture3D::Sptr Texture3D::FromJson(const nlohmann::json& data)
 	Texture3D::Sptr result = std::make_shared<Texture3D>(description);
 
 	// If we embedded data into the JSON, load it now
-	if (description.Filename.empty() && data.contains("data") && data["data"].is_string()) {
+	if (description.Filename.empty() && data.contains("data") && BlobStore::IsBlob(data["data"])) {
 		PixelType type = JsonParseEnum(PixelType, data, "pixel_type", PixelType::Unknown);
 		try {
-			std::string rawData = Base64::Decode(data['data'].get<std::string>());
+			std::string rawData = BlobStore::Read(data["data"]);
 			result->LoadData(description.Width, description.Height, description.Depth, description.FormatHint, type, rawData.data());
 		}
-		catch (std::runtime_error()) {
-			LOG_WARN("JSON blob had data, but failed to load to texture");
+		catch (const std::runtime_error& e) {
+			LOG_WARN("JSON blob had data, but failed to load to texture: {}", e.what());
 		}
 	}
 
@@ -143,6 +143,9 @@ public:
 	/// </summary>
 	const Texture3DDescription& GetDescription() const { return _description; }
 
+	virtual size_t GetGpuMemoryUsage() const override;
+	virtual bool CanReload() const override { return !_description.Filename.empty(); }
+
 	virtual nlohmann::json ToJson() const override;
 	static Texture3D::Sptr FromJson(const nlohmann::json& data);
 
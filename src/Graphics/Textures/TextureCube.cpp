@@ -26,6 +26,10 @@ TextureCube::TextureCube(const TextureCubeDescription& description) :
 	_LoadFromDescription();
 }
 
+size_t TextureCube::GetGpuMemoryUsage() const {
+	return _EstimateMemoryUsage(_description.Format, _description.Size, _description.Size, 1, false) * 6;
+}
+
 nlohmann::json TextureCube::ToJson() const
 {
 	nlohmann::json result;
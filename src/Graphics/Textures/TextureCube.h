@@ -108,6 +108,9 @@ public:
 	/// </summary>
 	const TextureCubeDescription& GetDescription() const { return _description; }
 
+	virtual size_t GetGpuMemoryUsage() const override;
+	virtual bool CanReload() const override { return !_description.Filename.empty() || !_description.FaceFileNames.empty(); }
+
 	virtual nlohmann::json ToJson() const override;
 	static TextureCube::Sptr FromJson(const nlohmann::json& data);
 
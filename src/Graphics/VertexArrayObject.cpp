@@ -8,7 +8,13 @@ VertexArrayObject::VertexArrayObject() :
 	_handle(0),
 	_vertexCount(0),
 	_elementCount(0),
-	_vertexBuffers(std::vector<VertexBufferBinding*>())
+	_vertexBuffers(std::vector<VertexBufferBinding*>()),
+	_submeshes(std::vector<Submesh>()),
+	_lods(std::vector<Lod>()),
+	_hasBounds(false),
+	_boundsMin(glm::vec3(0.0f)),
+	_boundsMax(glm::vec3(0.0f)),
+	_vertexEncoding(VertexEncoding::Float)
 {
 	glCreateVertexArrays(1, &_handle);
 }
@@ -113,6 +119,16 @@ void VertexArrayObject::Draw(DrawMode mode) {
 	Unbind();
 }
 
+void VertexArrayObject::DrawRange(uint32_t firstElement, uint32_t count, DrawMode mode) {
+	if (_indexBuffer == nullptr) {
+		glDrawArrays((GLenum)mode, firstElement, count);
+	} else {
+		// The "pointer" is the byte offset into the bound index buffer
+		size_t offset = static_cast<size_t>(firstElement) * _indexBuffer->GetElementSize();
+		glDrawElements((GLenum)mode, count, (GLenum)_indexBuffer->GetElementType(), reinterpret_cast<const void*>(offset));
+	}
+}
+
 void VertexArrayObject::DrawInstanced(uint32_t instanceCount, DrawMode mode /*= DrawMode::TriangleList*/)
 {
 	Bind();
@@ -136,8 +152,47 @@ void VertexArrayObject::Unbind() {
 	glBindVertexArray(0);
 }
 
+void VertexArrayObject::SetSubmeshes(const std::vector<Submesh>& submeshes) {
+	_submeshes = submeshes;
+}
+
+void VertexArrayObject::SetLods(const std::vector<Lod>& lods) {
+	_lods = lods;
+}
+
+VertexArrayObject::Sptr VertexArrayObject::CreateLod(const IndexBuffer::Sptr& indices, const std::vector<Submesh>& submeshes) const {
+	VertexArrayObject::Sptr result = Create();
+	result->SetDebugName(GetDebugName() + " - LOD");
+	result->SetIndexBuffer(indices);
+	for (const auto& binding : _vertexBuffers) {
+		result->AddVertexBuffer(binding->Buffer, binding->Attributes, binding->Instanced);
+	}
+	result->SetVDecl(_vDecl);
+	result->SetSubmeshes(submeshes);
+	if (_hasBounds) {
+		result->SetBounds(_boundsMin, _boundsMax);
+	}
+	return result;
+}
+
+void VertexArrayObject::SetBounds(const glm::vec3& min, const glm::vec3& max) {
+	_hasBounds = true;
+	_boundsMin = min;
+	_boundsMax = max;
+}
+
 void VertexArrayObject::SetVDecl(const VertexDeclaration& vDecl) {
 	_vDecl = vDecl;
+
+	// The packed vertex types store their normals in fewer components than a float normal would need
+	_vertexEncoding = VertexEncoding::Float;
+	for (const BufferAttribute& attrib : _vDecl) {
+		if (attrib.Usage == AttribUsage::Tangent && attrib.Type == AttributeType::Short && attrib.Size == 4) {
+			_vertexEncoding = VertexEncoding::TangentFrame;
+		} else if (attrib.Usage == AttribUsage::Normal && attrib.Type == AttributeType::Short && attrib.Size == 2 && _vertexEncoding == VertexEncoding::Float) {
+			_vertexEncoding = VertexEncoding::OctNormal;
+		}
+	}
 }
 
 const VertexArrayObject::VertexDeclaration& VertexArrayObject::GetVDecl() {
@@ -148,6 +203,22 @@ GlResourceType VertexArrayObject::GetResourceClass() const {
 	return GlResourceType::VertexArray;
 }
 
+size_t VertexArrayObject::GetGpuMemoryUsage() const {
+	size_t result = _indexBuffer != nullptr ? _indexBuffer->GetGpuMemoryUsage() : 0;
+	for (const VertexBufferBinding* binding : _vertexBuffers) {
+		if (binding->Buffer != nullptr) {
+			result += binding->Buffer->GetGpuMemoryUsage();
+		}
+	}
+	// Our LODs share our vertex buffers, so we only count their indices
+	for (const Lod& lod : _lods) {
+		if (lod.Mesh != nullptr && lod.Mesh->_indexBuffer != nullptr) {
+			result += lod.Mesh->_indexBuffer->GetGpuMemoryUsage();
+		}
+	}
+	return result;
+}
+
 VertexArrayObject::VertexBufferBinding* VertexArrayObject::GetBufferBinding(AttribUsage usage) {
 	for (auto& binding : _vertexBuffers) {
 		// Search for the BufferAttribute with the matching usage
@@ -177,6 +248,11 @@ VertexArrayObject::Sptr VertexArrayObject::Clone() const
 	}
 
 	result->SetVDecl(_vDecl);
+	result->SetSubmeshes(_submeshes);
+	result->SetLods(_lods);
+	if (_hasBounds) {
+		result->SetBounds(_boundsMin, _boundsMax);
+	}
 
 	return result;
 }
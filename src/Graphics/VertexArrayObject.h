@@ -50,6 +50,71 @@ struct BufferAttribute {
 		Slot(slot), Size(size), Type(type), Stride(stride), Offset(offset), Usage(usage), Normalized(normalized) { }
 };
 
+/// <summary>
+/// A range of elements within a mesh that are drawn with the same material, see VertexArrayObject::DrawRange
+///
+/// This is stored as is in binary mesh files, so it's layout should not change
+/// </summary>
+struct Submesh {
+	/// <summary>
+	/// The first element (index, or vertex for meshes without indices) of the range
+	/// </summary>
+	uint32_t FirstIndex = 0;
+	/// <summary>
+	/// The number of elements in the range
+	/// </summary>
+	uint32_t IndexCount = 0;
+	/// <summary>
+	/// The material slot that the range should be drawn with (see RenderComponent::GetMaterial)
+	/// </summary>
+	uint32_t MaterialSlot = 0;
+	uint32_t Reserved = 0;
+};
+
+/// <summary>
+/// How the vertices of a mesh are encoded, which shaders decode with DecodeVertex (see fragments/vertex_decode.glsl
+/// and VertexCompression). The values match the VERTEX_ENCODING defines in the shader
+/// </summary>
+ENUM(VertexEncoding, uint32_t,
+	// Positions, normals and tangents are floats
+	Float        = 0,
+	// Positions are quantized within the mesh's bounds and normals are octahedral encoded, see VertexPackedPosNormTexCol
+	OctNormal    = 1,
+	// Positions are quantized within the mesh's bounds and the tangent frame is a quaternion, see VertexPackedPosNormTexColTangents
+	TangentFrame = 2
+);
+
+/// <summary>
+/// Describes one simplified level of detail of a mesh, see MeshSimplifier and VertexArrayObject::GetLods
+///
+/// Every level shares the mesh's vertices, and has it's own indices and submeshes. This is stored as
+/// is in binary mesh files, so it's layout should not change
+/// </summary>
+struct MeshLod {
+	/// <summary>
+	/// The first index of the level, within the indices of all the levels
+	/// </summary>
+	uint32_t FirstIndex = 0;
+	/// <summary>
+	/// The number of indices in the level
+	/// </summary>
+	uint32_t IndexCount = 0;
+	/// <summary>
+	/// The first of the level's submeshes, within the submeshes of all the levels. The submesh ranges
+	/// are relative to FirstIndex
+	/// </summary>
+	uint32_t FirstSubmesh = 0;
+	/// <summary>
+	/// The number of submeshes in the level
+	/// </summary>
+	uint32_t SubmeshCount = 0;
+	/// <summary>
+	/// How far the simplified surface is from the full detail mesh, relative to the mesh's bounding radius
+	/// </summary>
+	float    Error = 0.0f;
+	uint32_t Reserved = 0;
+};
+
 /// <summary>
 /// The Vertex Array Object wraps around an OpenGL VAO and basically represents all of the data for a mesh
 /// </summary>
@@ -120,6 +185,55 @@ public:
 	/// <returns>A const pointer to the binding, or nullptr if none is found</returns>
 	VertexBufferBinding* GetBufferBinding(AttribUsage usage);
 
+	/// <summary>
+	/// Sets the ranges of this mesh that should be drawn with different materials. An empty list
+	/// (the default) means the whole mesh uses material slot 0
+	/// </summary>
+	/// <param name="submeshes">The submeshes, in the order they should be drawn</param>
+	void SetSubmeshes(const std::vector<Submesh>& submeshes);
+	const std::vector<Submesh>& GetSubmeshes() const { return _submeshes; }
+
+	/// <summary>
+	/// A simplified version of a mesh, drawn in it's place when it is small on screen
+	/// </summary>
+	struct Lod {
+		/// <summary>
+		/// The VAO to draw for this level, it shares the vertex buffers of the full detail mesh
+		/// </summary>
+		Sptr  Mesh;
+		/// <summary>
+		/// How far the simplified surface is from the full detail mesh, relative to the mesh's bounding radius
+		/// </summary>
+		float Error;
+	};
+
+	/// <summary>
+	/// Sets the simplified levels of detail for this mesh, from the most to the least detailed. This
+	/// VAO is always level 0, so it should not be included
+	/// </summary>
+	/// <param name="lods">The levels of detail, each with an increasing error</param>
+	void SetLods(const std::vector<Lod>& lods);
+	const std::vector<Lod>& GetLods() const { return _lods; }
+
+	/// <summary>
+	/// Creates a VAO for one of this mesh's levels of detail, which draws from the same vertex
+	/// buffers using the given indices
+	/// </summary>
+	/// <param name="indices">The indices of the level of detail</param>
+	/// <param name="submeshes">The submeshes of the level, which should match this mesh's submeshes</param>
+	/// <returns>A VAO for the level of detail, to add to SetLods</returns>
+	Sptr CreateLod(const IndexBuffer::Sptr& indices, const std::vector<Submesh>& submeshes) const;
+
+	/// <summary>
+	/// Sets the bounding box of this mesh's vertices, which is used to work out how large it is on screen
+	/// </summary>
+	/// <param name="min">The minimum position of any vertex</param>
+	/// <param name="max">The maximum position of any vertex</param>
+	void SetBounds(const glm::vec3& min, const glm::vec3& max);
+	bool HasBounds() const { return _hasBounds; }
+	const glm::vec3& GetBoundsMin() const { return _boundsMin; }
+	const glm::vec3& GetBoundsMax() const { return _boundsMax; }
+
 	/// <summary>
 	/// Renders this VAO, using the specified draw mode
 	/// </summary>
@@ -134,6 +248,16 @@ public:
 	/// <param name="mode">The primitive mode for rendering the mesh</param>
 	void DrawInstanced(uint32_t instanceCount, DrawMode mode = DrawMode::TriangleList);
 
+	/// <summary>
+	/// Renders a range of elements from this VAO. Unlike Draw, this does not bind or unbind the VAO,
+	/// so the caller must call Bind first. This lets the submeshes of a mesh be drawn one after the
+	/// other from the same buffers, without rebinding the VAO for each one
+	/// </summary>
+	/// <param name="firstElement">The first index (or vertex, if the VAO has no indices) to draw</param>
+	/// <param name="count">The number of elements to draw</param>
+	/// <param name="mode">The draw mode for primitives in this VAO</param>
+	void DrawRange(uint32_t firstElement, uint32_t count, DrawMode mode = DrawMode::TriangleList);
+
 	/// <summary>
 	/// Binds this VAO as the source of data for draw operations
 	/// </summary>
@@ -150,6 +274,17 @@ public:
 
 	void SetVDecl(const VertexDeclaration& vDecl);
 	const VertexDeclaration& GetVDecl();
+	/// <summary>
+	/// Gets how this mesh's vertices are encoded, based on it's vertex declaration. Meshes that are not
+	/// Float need their bounds to decode their positions
+	/// </summary>
+	VertexEncoding GetVertexEncoding() const { return _vertexEncoding; }
+
+	/// <summary>
+	/// Gets the total size of all the buffers bound to this VAO, note that buffers shared
+	/// between VAOs will be counted by each of them
+	/// </summary>
+	virtual size_t GetGpuMemoryUsage() const override;
 
 protected:
 	
@@ -158,9 +293,20 @@ protected:
 	// The vertex buffers bound to this VAO
 	std::vector<VertexBufferBinding*> _vertexBuffers;
 
+	// The ranges of the mesh that are drawn with different materials
+	std::vector<Submesh> _submeshes;
+
+	// The simplified versions of this mesh, not including this one
+	std::vector<Lod> _lods;
+
+	bool      _hasBounds;
+	glm::vec3 _boundsMin;
+	glm::vec3 _boundsMax;
+
 	// Stores a copy of one of the vertex declarations
 	// defined in VertexTypes.cpp
 	VertexDeclaration _vDecl;
+	VertexEncoding    _vertexEncoding;
 
 	uint32_t _vertexCount;
 	uint32_t _elementCount;
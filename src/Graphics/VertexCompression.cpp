@@ -0,0 +1,168 @@
+#include "Graphics/VertexCompression.h"
+
+#include <cstring>
+#include <Logging.h>
+
+// Quantizes a value in the 0-1 range to an unsigned normalized 16 bit value
+static uint16_t ToUnorm16(float value) {
+	return static_cast<uint16_t>(glm::clamp(value, 0.0f, 1.0f) * 65535.0f + 0.5f);
+}
+
+// Quantizes a value in the -1 to 1 range to a signed normalized 16 bit value
+static int16_t ToSnorm16(float value) {
+	return static_cast<int16_t>(glm::round(glm::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+// Quantizes a value in the 0-1 range to an unsigned normalized 8 bit value
+static uint8_t ToUnorm8(float value) {
+	return static_cast<uint8_t>(glm::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+// Returns 1 or -1, treating 0 as positive so that the octahedral folds don't collapse
+static glm::vec2 SignNotZero(const glm::vec2& value) {
+	return glm::vec2(value.x >= 0.0f ? 1.0f : -1.0f, value.y >= 0.0f ? 1.0f : -1.0f);
+}
+
+glm::vec2 VertexCompression::EncodeOctahedral(const glm::vec3& normal) {
+	float length = glm::abs(normal.x) + glm::abs(normal.y) + glm::abs(normal.z);
+	if (length <= 0.0f) {
+		return glm::vec2(0.0f);
+	}
+	glm::vec3 n = normal / length;
+	glm::vec2 result = glm::vec2(n.x, n.y);
+	// Fold the lower half of the octahedron over the upper half
+	if (n.z < 0.0f) {
+		result = (1.0f - glm::abs(glm::vec2(n.y, n.x))) * SignNotZero(result);
+	}
+	return result;
+}
+
+glm::vec3 VertexCompression::DecodeOctahedral(const glm::vec2& encoded) {
+	glm::vec3 n = glm::vec3(encoded.x, encoded.y, 1.0f - glm::abs(encoded.x) - glm::abs(encoded.y));
+	if (n.z < 0.0f) {
+		glm::vec2 folded = (1.0f - glm::abs(glm::vec2(n.y, n.x))) * SignNotZero(glm::vec2(n.x, n.y));
+		n.x = folded.x;
+		n.y = folded.y;
+	}
+	return glm::normalize(n);
+}
+
+glm::vec4 VertexCompression::EncodeTangentFrame(const glm::vec3& normal, const glm::vec3& tangent, const glm::vec3& bitangent) {
+	glm::vec3 n = glm::length(normal) > 0.0f ? glm::normalize(normal) : glm::vec3(0.0f, 0.0f, 1.0f);
+
+	// Make the tangent perpendicular to the normal, falling back to any perpendicular direction
+	glm::vec3 t = tangent - n * glm::dot(n, tangent);
+	if (glm::length(t) < 1e-6f) {
+		t = glm::abs(n.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+		t = t - n * glm::dot(n, t);
+	}
+	t = glm::normalize(t);
+	glm::vec3 b = glm::cross(n, t);
+	float handedness = glm::dot(b, bitangent) < 0.0f ? -1.0f : 1.0f;
+
+	// Convert the rotation matrix with columns T, B, N into a quaternion
+	glm::vec4 q;
+	float trace = t.x + b.y + n.z;
+	if (trace > 0.0f) {
+		float s = glm::sqrt(trace + 1.0f) * 2.0f;
+		q = glm::vec4((b.z - n.y) / s, (n.x - t.z) / s, (t.y - b.x) / s, 0.25f * s);
+	} else if (t.x > b.y && t.x > n.z) {
+		float s = glm::sqrt(1.0f + t.x - b.y - n.z) * 2.0f;
+		q = glm::vec4(0.25f * s, (b.x + t.y) / s, (n.x + t.z) / s, (b.z - n.y) / s);
+	} else if (b.y > n.z) {
+		float s = glm::sqrt(1.0f + b.y - t.x - n.z) * 2.0f;
+		q = glm::vec4((b.x + t.y) / s, 0.25f * s, (n.y + b.z) / s, (n.x - t.z) / s);
+	} else {
+		float s = glm::sqrt(1.0f + n.z - t.x - b.y) * 2.0f;
+		q = glm::vec4((n.x + t.z) / s, (n.y + b.z) / s, 0.25f * s, (t.y - b.x) / s);
+	}
+	q = glm::normalize(q);
+
+	// q and -q are the same rotation, so we can make W positive and use it's sign for the handedness.
+	// W can't be allowed to round to 0 when quantized though, or we would lose the sign
+	if (q.w < 0.0f) {
+		q = -q;
+	}
+	const float bias = 1.0f / 32767.0f;
+	if (q.w < bias) {
+		float scale = glm::sqrt(1.0f - bias * bias) / glm::max(glm::length(glm::vec3(q)), 1e-6f);
+		q = glm::vec4(glm::vec3(q) * scale, bias);
+	}
+	return handedness < 0.0f ? -q : q;
+}
+
+void VertexCompression::DecodeTangentFrame(const glm::vec4& frame, glm::vec3& normal, glm::vec3& tangent, glm::vec3& bitangent) {
+	glm::vec4 q = glm::normalize(frame);
+	glm::vec3 axis = glm::vec3(q);
+	// Rotate the X and Z axes by the quaternion
+	tangent = glm::vec3(1.0f, 0.0f, 0.0f) + 2.0f * glm::cross(axis, glm::cross(axis, glm::vec3(1.0f, 0.0f, 0.0f)) + q.w * glm::vec3(1.0f, 0.0f, 0.0f));
+	normal = glm::vec3(0.0f, 0.0f, 1.0f) + 2.0f * glm::cross(axis, glm::cross(axis, glm::vec3(0.0f, 0.0f, 1.0f)) + q.w * glm::vec3(0.0f, 0.0f, 1.0f));
+	bitangent = glm::cross(normal, tangent) * (frame.w < 0.0f ? -1.0f : 1.0f);
+}
+
+glm::vec3 VertexCompression::DecodePosition(const uint16_t* position, const glm::vec3& boundsMin, const glm::vec3& boundsMax) {
+	return boundsMin + glm::vec3(position[0], position[1], position[2]) / 65535.0f * (boundsMax - boundsMin);
+}
+
+bool VertexCompression::Compress(const VertexPosNormTexColTangents* vertices, size_t count, const glm::vec3& boundsMin, const glm::vec3& boundsMax, PackedVertices& result) {
+	if (count == 0) {
+		return false;
+	}
+
+	// Flat meshes have no extent along one of the axes, all of their positions quantize to 0 on that axis
+	glm::vec3 extent = boundsMax - boundsMin;
+	glm::vec3 invExtent = glm::vec3(
+		extent.x > 0.0f ? 1.0f / extent.x : 0.0f,
+		extent.y > 0.0f ? 1.0f / extent.y : 0.0f,
+		extent.z > 0.0f ? 1.0f / extent.z : 0.0f
+	);
+
+	// Meshes without tangents (ex: loaded without calculating them) only need their normals
+	bool hasTangents = false;
+	for (size_t ix = 0; ix < count && !hasTangents; ix++) {
+		hasTangents = vertices[ix].Tangent != glm::vec3(0.0f);
+	}
+
+	result.Count = static_cast<uint32_t>(count);
+	if (hasTangents) {
+		result.Stride = sizeof(VertexPackedPosNormTexColTangents);
+		result.VDecl = &VertexPackedPosNormTexColTangents::V_DECL;
+	} else {
+		result.Stride = sizeof(VertexPackedPosNormTexCol);
+		result.VDecl = &VertexPackedPosNormTexCol::V_DECL;
+	}
+	result.Data.resize(count * result.Stride);
+
+	for (size_t ix = 0; ix < count; ix++) {
+		const VertexPosNormTexColTangents& vertex = vertices[ix];
+		glm::vec3 position = (vertex.Position - boundsMin) * invExtent;
+		uint16_t quantized[4] = { ToUnorm16(position.x), ToUnorm16(position.y), ToUnorm16(position.z), 0 };
+		uint8_t color[4] = { ToUnorm8(vertex.Color.r), ToUnorm8(vertex.Color.g), ToUnorm8(vertex.Color.b), ToUnorm8(vertex.Color.a) };
+
+		if (hasTangents) {
+			VertexPackedPosNormTexColTangents packed;
+			memcpy(packed.Position, quantized, sizeof(quantized));
+			glm::vec4 frame = EncodeTangentFrame(vertex.Normal, vertex.Tangent, vertex.BiTangent);
+			packed.TangentFrame[0] = ToSnorm16(frame.x);
+			packed.TangentFrame[1] = ToSnorm16(frame.y);
+			packed.TangentFrame[2] = ToSnorm16(frame.z);
+			packed.TangentFrame[3] = ToSnorm16(frame.w);
+			packed.UV = vertex.UV;
+			memcpy(packed.Color, color, sizeof(color));
+			memcpy(result.Data.data() + ix * result.Stride, &packed, sizeof(packed));
+		} else {
+			VertexPackedPosNormTexCol packed;
+			memcpy(packed.Position, quantized, sizeof(quantized));
+			glm::vec2 normal = EncodeOctahedral(vertex.Normal);
+			packed.Normal[0] = ToSnorm16(normal.x);
+			packed.Normal[1] = ToSnorm16(normal.y);
+			packed.UV = vertex.UV;
+			memcpy(packed.Color, color, sizeof(color));
+			memcpy(result.Data.data() + ix * result.Stride, &packed, sizeof(packed));
+		}
+	}
+
+	LOG_TRACE("Compressed {} vertices from {} to {} bytes each ({:.1f} KB -> {:.1f} KB)", count, sizeof(VertexPosNormTexColTangents), result.Stride,
+		count * sizeof(VertexPosNormTexColTangents) / 1024.0f, result.Data.size() / 1024.0f);
+	return true;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <GLM/glm.hpp>
+
+#include "Graphics/VertexTypes.h"
+
+/// <summary>
+/// Packs VertexPosNormTexColTangents vertices into VertexPackedPosNormTexColTangents or VertexPackedPosNormTexCol
+/// when a mesh is baked or saved to a binary file, which takes them from 72 bytes down to 28 or 24 bytes
+///
+/// The encodings are:
+///   - Positions are unsigned normalized 16 bit values within the mesh's bounds, which are stored on the VAO
+///   - Normals are octahedral encoded (Cigolle et al. 2014) into two signed normalized 16 bit values
+///   - Tangent frames are quaternions of signed normalized 16 bit values, with the bitangent's handedness
+///     in the sign of W (Frey and Herzeg 2011)
+///   - Colours are unsigned normalized 8 bit values
+///
+/// The vertex shaders decode these with DecodeVertex in fragments/vertex_decode.glsl, using the
+/// u_PositionScale, u_PositionOffset and u_VertexEncoding instance uniforms
+/// </summary>
+class VertexCompression {
+public:
+	/// <summary>
+	/// Vertices that have been packed into one of the compressed vertex types
+	/// </summary>
+	struct PackedVertices {
+		std::vector<uint8_t> Data;
+		uint32_t             Stride = 0;
+		uint32_t             Count = 0;
+		// The V_DECL of the packed vertex type
+		const std::vector<BufferAttribute>* VDecl = nullptr;
+	};
+
+	/// <summary>
+	/// Packs a unit length normal into 2 values in the -1 to 1 range, by projecting it onto an octahedron
+	/// </summary>
+	static glm::vec2 EncodeOctahedral(const glm::vec3& normal);
+	/// <summary>
+	/// Unpacks a normal that was packed with EncodeOctahedral
+	/// </summary>
+	static glm::vec3 DecodeOctahedral(const glm::vec2& encoded);
+
+	/// <summary>
+	/// Packs a tangent frame into a quaternion, the tangent is made orthogonal to the normal first so the
+	/// normal is kept exactly. The sign of W stores which way the bitangent faces
+	/// </summary>
+	/// <param name="normal">The vertex's normal</param>
+	/// <param name="tangent">The vertex's tangent, if it is zero or parallel to the normal any perpendicular direction is used</param>
+	/// <param name="bitangent">The vertex's bitangent, only it's handedness is kept</param>
+	static glm::vec4 EncodeTangentFrame(const glm::vec3& normal, const glm::vec3& tangent, const glm::vec3& bitangent);
+	/// <summary>
+	/// Unpacks a tangent frame that was packed with EncodeTangentFrame
+	/// </summary>
+	static void DecodeTangentFrame(const glm::vec4& frame, glm::vec3& normal, glm::vec3& tangent, glm::vec3& bitangent);
+
+	/// <summary>
+	/// Unpacks a quantized position, using the bounds that the mesh was packed with
+	/// </summary>
+	static glm::vec3 DecodePosition(const uint16_t* position, const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+
+	/// <summary>
+	/// Packs vertices into VertexPackedPosNormTexColTangents, or VertexPackedPosNormTexCol if none of
+	/// them have tangents, and logs how much memory was saved
+	/// </summary>
+	/// <param name="vertices">The vertices to pack</param>
+	/// <param name="count">The number of vertices</param>
+	/// <param name="boundsMin">The minimum position of any vertex</param>
+	/// <param name="boundsMax">The maximum position of any vertex</param>
+	/// <param name="result">Receives the packed vertices</param>
+	/// <returns>True if the vertices were packed</returns>
+	static bool Compress(const VertexPosNormTexColTangents* vertices, size_t count, const glm::vec3& boundsMin, const glm::vec3& boundsMax, PackedVertices& result);
+
+	/// <summary>
+	/// Other vertex types don't have a compressed form, so they are left as is
+	/// </summary>
+	template <typename VertType>
+	static bool Compress(const VertType* vertices, size_t count, const glm::vec3& boundsMin, const glm::vec3& boundsMax, PackedVertices& result) {
+		return false;
+	}
+
+protected:
+	VertexCompression() = default;
+	~VertexCompression() = default;
+};
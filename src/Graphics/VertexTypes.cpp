@@ -7,6 +7,8 @@ VertexPosNormCol* VPNC = nullptr;
 VertexPosNormTex* VPNT = nullptr;
 VertexPosNormTexCol* VPNTC = nullptr;
 VertexPosNormTexColTangents* VPNTCT = nullptr;
+VertexPackedPosNormTexCol* VPPNTC = nullptr;
+VertexPackedPosNormTexColTangents* VPPNTCT = nullptr;
 
 const std::vector<BufferAttribute> VertexPosCol::V_DECL = {
 	BufferAttribute(0, 3, AttributeType::Float, sizeof(VertexPosCol), (size_t)&VPC->Position, AttribUsage::Position),
@@ -41,4 +43,17 @@ const std::vector<BufferAttribute> VertexPosNormTexColTangents::V_DECL ={
 	BufferAttribute(4, 3, AttributeType::Float, sizeof(VertexPosNormTexColTangents), (size_t)&VPNTCT->Tangent, AttribUsage::Tangent),
 	BufferAttribute(5, 3, AttributeType::Float, sizeof(VertexPosNormTexColTangents), (size_t)&VPNTCT->BiTangent, AttribUsage::BiTangent)
 };
+// The packed types are normalized, so the shaders still receive floats that they decode with DecodeVertex (see fragments/vertex_decode.glsl)
+const std::vector<BufferAttribute> VertexPackedPosNormTexCol::V_DECL = {
+	BufferAttribute(0, 3, AttributeType::UShort, sizeof(VertexPackedPosNormTexCol), (size_t)&VPPNTC->Position, AttribUsage::Position, true),
+	BufferAttribute(1, 4, AttributeType::UByte, sizeof(VertexPackedPosNormTexCol), (size_t)&VPPNTC->Color, AttribUsage::Color, true),
+	BufferAttribute(2, 2, AttributeType::Short, sizeof(VertexPackedPosNormTexCol), (size_t)&VPPNTC->Normal, AttribUsage::Normal, true),
+	BufferAttribute(3, 2, AttributeType::Float, sizeof(VertexPackedPosNormTexCol), (size_t)&VPPNTC->UV, AttribUsage::Texture),
+};
+const std::vector<BufferAttribute> VertexPackedPosNormTexColTangents::V_DECL = {
+	BufferAttribute(0, 3, AttributeType::UShort, sizeof(VertexPackedPosNormTexColTangents), (size_t)&VPPNTCT->Position, AttribUsage::Position, true),
+	BufferAttribute(1, 4, AttributeType::UByte, sizeof(VertexPackedPosNormTexColTangents), (size_t)&VPPNTCT->Color, AttribUsage::Color, true),
+	BufferAttribute(3, 2, AttributeType::Float, sizeof(VertexPackedPosNormTexColTangents), (size_t)&VPPNTCT->UV, AttribUsage::Texture),
+	BufferAttribute(4, 4, AttributeType::Short, sizeof(VertexPackedPosNormTexColTangents), (size_t)&VPPNTCT->TangentFrame, AttribUsage::Tangent, true),
+};
 #pragma warning(pop)
\ No newline at end of file
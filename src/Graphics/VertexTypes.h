@@ -116,4 +116,41 @@ struct VertexPosNormTexColTangents {
 	{}
 
 	static const std::vector<BufferAttribute> V_DECL;
-};
\ No newline at end of file
+};
+
+/// <summary>
+/// The compressed form of VertexPosNormTexColTangents for meshes without tangents, see VertexCompression
+///
+/// Positions are unsigned normalized 16 bit values within the mesh's bounds, normals are octahedral
+/// encoded into two signed normalized 16 bit values, and colours are unsigned normalized 8 bit values
+/// </summary>
+struct VertexPackedPosNormTexCol {
+	// The 4th value is unused, it keeps the normal 4 byte aligned
+	uint16_t  Position[4];
+	int16_t   Normal[2];
+	glm::vec2 UV;
+	uint8_t   Color[4];
+
+	VertexPackedPosNormTexCol() : Position{ 0, 0, 0, 0 }, Normal{ 0, 0 }, UV(glm::vec2(0.0f)), Color{ 0, 0, 0, 255 } {}
+
+	static const std::vector<BufferAttribute> V_DECL;
+};
+
+/// <summary>
+/// The compressed form of VertexPosNormTexColTangents, see VertexCompression
+///
+/// Positions are unsigned normalized 16 bit values within the mesh's bounds, the normal, tangent and bitangent
+/// are packed into a quaternion of signed normalized 16 bit values, and colours are unsigned normalized 8 bit values
+/// </summary>
+struct VertexPackedPosNormTexColTangents {
+	// The 4th value is unused, it keeps the tangent frame 8 byte aligned
+	uint16_t  Position[4];
+	// Rotates the X, Y and Z axes onto the tangent, bitangent and normal, the sign of W is the bitangent's handedness
+	int16_t   TangentFrame[4];
+	glm::vec2 UV;
+	uint8_t   Color[4];
+
+	VertexPackedPosNormTexColTangents() : Position{ 0, 0, 0, 0 }, TangentFrame{ 0, 0, 0, 32767 }, UV(glm::vec2(0.0f)), Color{ 0, 0, 0, 255 } {}
+
+	static const std::vector<BufferAttribute> V_DECL;
+};
@@ -1,6 +1,21 @@
 #include "Base64.h"
+#include <array>
 #include <stdexcept>
 
+// The vector kernels are always built on x86, and picked at runtime based on what the CPU supports.
+// GCC and Clang need to be told which instruction set each function may use, MSVC allows any of them
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define BASE64_X86 1
+	#include <immintrin.h>
+	#if defined(_MSC_VER) && !defined(__clang__)
+		#include <intrin.h>
+		#define BASE64_TARGET(isa)
+	#else
+		#include <cpuid.h>
+		#define BASE64_TARGET(isa) __attribute__((target(isa)))
+	#endif
+#endif
+
 const char* Base64::LookupTables[2] = {
 	"ABCDEFGHIJKLMNOPQRSTUVWXYZ"
 	"abcdefghijklmnopqrstuvwxyz"
@@ -11,55 +26,339 @@ const char* Base64::LookupTables[2] = {
 	"0123456789-_."
 };
 
-uint32_t CharPos(const char input) {
-	if (input >= 'A' && input <= 'Z') return input - 'A';
-	else if (input >= 'a' && input <= 'z') return input - 'Z';
-	else if (input == '+' || input == '-') return 62;
-	else if (input == '/' || input == '_') return 63;
-	else if (input == '=' || input == '.') return 64;
-	else
-		throw std::runtime_error("Not a valid Base64 character");
+static constexpr uint8_t InvalidChar = 0xFF;
+
+/// <summary>
+/// Maps characters from either alphabet to their 6 bit value, or InvalidChar
+/// </summary>
+static constexpr std::array<uint8_t, 256> MakeDecodeTable() {
+	std::array<uint8_t, 256> result{};
+	for (size_t ix = 0; ix < result.size(); ix++) {
+		result[ix] = InvalidChar;
+	}
+	for (uint8_t ix = 0; ix < 26; ix++) {
+		result['A' + ix] = ix;
+		result['a' + ix] = 26 + ix;
+	}
+	for (uint8_t ix = 0; ix < 10; ix++) {
+		result['0' + ix] = 52 + ix;
+	}
+	result['+'] = result['-'] = 62;
+	result['/'] = result['_'] = 63;
+	return result;
+}
+static constexpr std::array<uint8_t, 256> DecodeTable = MakeDecodeTable();
+
+inline bool IsPadding(const char c) {
+	return c == '=' || c == '.';
 }
 
-std::string Base64::Encode(void* data, size_t sizeBytes, bool urlEncode, bool includeTrailing)
-{
-	// Determine the size of the output
-	size_t encodedLength = ((sizeBytes + 2) / 3) * 4;
+#if BASE64_X86
+/// <summary>
+/// The widest instruction set that both the CPU and the OS support
+/// </summary>
+enum class SimdLevel {
+	Scalar,
+	Ssse3,
+	Avx2
+};
+
+static void Cpuid(int leaf, int subleaf, uint32_t regs[4]) {
+	#if defined(_MSC_VER) && !defined(__clang__)
+	int result[4];
+	__cpuidex(result, leaf, subleaf);
+	for (int ix = 0; ix < 4; ix++) {
+		regs[ix] = static_cast<uint32_t>(result[ix]);
+	}
+	#else
+	__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+	#endif
+}
+
+static SimdLevel DetectSimdLevel() {
+	uint32_t regs[4];
+	Cpuid(0, 0, regs);
+	const uint32_t maxLeaf = regs[0];
+	if (maxLeaf < 1) {
+		return SimdLevel::Scalar;
+	}
+
+	Cpuid(1, 0, regs);
+	const bool hasSsse3 = (regs[2] & (1u << 9)) != 0;
+	const bool hasOsXsave = (regs[2] & (1u << 27)) != 0;
+	const bool hasAvx = (regs[2] & (1u << 28)) != 0;
+	if (!hasSsse3) {
+		return SimdLevel::Scalar;
+	}
+
+	// AVX registers are only usable if the OS saves them on a context switch
+	if (maxLeaf >= 7 && hasOsXsave && hasAvx) {
+		#if defined(_MSC_VER) && !defined(__clang__)
+		const uint64_t xcr0 = _xgetbv(0);
+		#else
+		uint32_t xcr0Low, xcr0High;
+		__asm__ volatile("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+		const uint64_t xcr0 = (static_cast<uint64_t>(xcr0High) << 32) | xcr0Low;
+		#endif
+		Cpuid(7, 0, regs);
+		if ((xcr0 & 0x6) == 0x6 && (regs[1] & (1u << 5)) != 0) {
+			return SimdLevel::Avx2;
+		}
+	}
+	return SimdLevel::Ssse3;
+}
+
+static SimdLevel GetSimdLevel() {
+	static const SimdLevel level = DetectSimdLevel();
+	return level;
+}
+
+/// <summary>
+/// Spreads 12 bytes of input out into 16 bytes that each hold a 6 bit index
+/// See http://0x80.pl/notesen/2016-01-12-sse-base64-encoding.html
+/// </summary>
+BASE64_TARGET("ssse3")
+inline __m128i EncodeReshuffle(__m128i input) {
+	input = _mm_shuffle_epi8(input, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+	const __m128i t0 = _mm_and_si128(input, _mm_set1_epi32(0x0fc0fc00));
+	const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+	const __m128i t2 = _mm_and_si128(input, _mm_set1_epi32(0x003f03f0));
+	const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+	return _mm_or_si128(t1, t3);
+}
+
+/// <summary>
+/// Converts 6 bit indices to characters, by grouping the indices into the ranges of the alphabet
+/// and adding the offset for that range from a 16 entry table
+/// </summary>
+BASE64_TARGET("ssse3")
+inline __m128i EncodeTranslate(__m128i indices, __m128i offsets) {
+	__m128i result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+	const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+	result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+	result = _mm_shuffle_epi8(offsets, result);
+	return _mm_add_epi8(result, indices);
+}
+
+/// <summary>
+/// Gets the table of offsets used by EncodeTranslate for the given alphabet
+/// </summary>
+BASE64_TARGET("ssse3")
+inline __m128i EncodeOffsets(const char* lut) {
+	const char digit = '0' - 52;
+	return _mm_setr_epi8('a' - 26, digit, digit, digit, digit, digit, digit, digit, digit, digit, digit,
+		static_cast<char>(lut[62] - 62), static_cast<char>(lut[63] - 63), 'A', 0, 0);
+}
+
+/// <summary>
+/// Converts 16 characters of either alphabet to their 6 bit values
+/// See http://0x80.pl/notesen/2016-01-17-sse-base64-decoding.html
+/// </summary>
+/// <returns>False if any of the characters are not Base64</returns>
+BASE64_TARGET("ssse3")
+inline bool DecodeTranslate(__m128i input, __m128i& values) {
+	// Map the URL safe alphabet onto the standard one so we only need one set of tables
+	const __m128i isDash = _mm_cmpeq_epi8(input, _mm_set1_epi8('-'));
+	const __m128i isUnderscore = _mm_cmpeq_epi8(input, _mm_set1_epi8('_'));
+	input = _mm_or_si128(_mm_andnot_si128(isDash, input), _mm_and_si128(isDash, _mm_set1_epi8('+')));
+	input = _mm_or_si128(_mm_andnot_si128(isUnderscore, input), _mm_and_si128(isUnderscore, _mm_set1_epi8('/')));
+
+	// The upper nibble of each character tells us which range of the alphabet it should be in
+	const __m128i upperNibble = _mm_and_si128(_mm_srli_epi32(input, 4), _mm_set1_epi8(0x0f));
+	const __m128i lowerBounds = _mm_setr_epi8(1, 1, 0x2b, 0x30, 0x41, 0x50, 0x61, 0x70, 1, 1, 1, 1, 1, 1, 1, 1);
+	const __m128i upperBounds = _mm_setr_epi8(0, 0, 0x2b, 0x39, 0x4f, 0x5a, 0x6f, 0x7a, 0, 0, 0, 0, 0, 0, 0, 0);
+	const __m128i offsets = _mm_setr_epi8(0, 0, 0x3e - 0x2b, 0x34 - 0x30, 0x00 - 0x41, 0x0f - 0x50, 0x1a - 0x61, 0x29 - 0x70, 0, 0, 0, 0, 0, 0, 0, 0);
+
+	const __m128i below = _mm_cmplt_epi8(input, _mm_shuffle_epi8(lowerBounds, upperNibble));
+	const __m128i above = _mm_cmpgt_epi8(input, _mm_shuffle_epi8(upperBounds, upperNibble));
+	// '/' is the only character that doesn't fit in a range
+	const __m128i isSlash = _mm_cmpeq_epi8(input, _mm_set1_epi8('/'));
+	const __m128i outside = _mm_andnot_si128(isSlash, _mm_or_si128(above, below));
+	if (_mm_movemask_epi8(outside) != 0) {
+		return false;
+	}
+
+	values = _mm_add_epi8(input, _mm_shuffle_epi8(offsets, upperNibble));
+	values = _mm_add_epi8(values, _mm_and_si128(isSlash, _mm_set1_epi8(-3)));
+	return true;
+}
 
-	// Allocate space for output
-	std::string result;
-	result.reserve(encodedLength);
+/// <summary>
+/// Packs 16 6 bit values into the first 12 bytes of the result
+/// </summary>
+BASE64_TARGET("ssse3")
+inline __m128i DecodePack(__m128i values) {
+	const __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+	const __m128i merged = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+	return _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+// The AVX2 versions work on two independent 128 bit lanes, which lines up with the in lane shuffles
+
+BASE64_TARGET("avx2")
+inline __m256i Broadcast(__m128i value) {
+	return _mm256_broadcastsi128_si256(value);
+}
+
+BASE64_TARGET("avx2")
+inline __m256i EncodeReshuffle(__m256i input) {
+	input = _mm256_shuffle_epi8(input, Broadcast(_mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1)));
+	const __m256i t0 = _mm256_and_si256(input, _mm256_set1_epi32(0x0fc0fc00));
+	const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+	const __m256i t2 = _mm256_and_si256(input, _mm256_set1_epi32(0x003f03f0));
+	const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+	return _mm256_or_si256(t1, t3);
+}
+
+BASE64_TARGET("avx2")
+inline __m256i EncodeTranslate(__m256i indices, __m256i offsets) {
+	__m256i result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+	const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+	result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+	result = _mm256_shuffle_epi8(offsets, result);
+	return _mm256_add_epi8(result, indices);
+}
+
+BASE64_TARGET("avx2")
+inline bool DecodeTranslate(__m256i input, __m256i& values) {
+	const __m256i isDash = _mm256_cmpeq_epi8(input, _mm256_set1_epi8('-'));
+	const __m256i isUnderscore = _mm256_cmpeq_epi8(input, _mm256_set1_epi8('_'));
+	input = _mm256_blendv_epi8(input, _mm256_set1_epi8('+'), isDash);
+	input = _mm256_blendv_epi8(input, _mm256_set1_epi8('/'), isUnderscore);
+
+	const __m256i upperNibble = _mm256_and_si256(_mm256_srli_epi32(input, 4), _mm256_set1_epi8(0x0f));
+	const __m256i lowerBounds = Broadcast(_mm_setr_epi8(1, 1, 0x2b, 0x30, 0x41, 0x50, 0x61, 0x70, 1, 1, 1, 1, 1, 1, 1, 1));
+	const __m256i upperBounds = Broadcast(_mm_setr_epi8(0, 0, 0x2b, 0x39, 0x4f, 0x5a, 0x6f, 0x7a, 0, 0, 0, 0, 0, 0, 0, 0));
+	const __m256i offsets = Broadcast(_mm_setr_epi8(0, 0, 0x3e - 0x2b, 0x34 - 0x30, 0x00 - 0x41, 0x0f - 0x50, 0x1a - 0x61, 0x29 - 0x70, 0, 0, 0, 0, 0, 0, 0, 0));
+
+	// AVX2 has no signed less than, so we flip the comparison
+	const __m256i below = _mm256_cmpgt_epi8(_mm256_shuffle_epi8(lowerBounds, upperNibble), input);
+	const __m256i above = _mm256_cmpgt_epi8(input, _mm256_shuffle_epi8(upperBounds, upperNibble));
+	const __m256i isSlash = _mm256_cmpeq_epi8(input, _mm256_set1_epi8('/'));
+	const __m256i outside = _mm256_andnot_si256(isSlash, _mm256_or_si256(above, below));
+	if (_mm256_movemask_epi8(outside) != 0) {
+		return false;
+	}
+
+	values = _mm256_add_epi8(input, _mm256_shuffle_epi8(offsets, upperNibble));
+	values = _mm256_add_epi8(values, _mm256_and_si256(isSlash, _mm256_set1_epi8(-3)));
+	return true;
+}
+
+/// <summary>
+/// Packs 32 6 bit values into the first 24 bytes of the result
+/// </summary>
+BASE64_TARGET("avx2")
+inline __m256i DecodePack(__m256i values) {
+	const __m256i pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+	const __m256i merged = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+	const __m256i packed = _mm256_shuffle_epi8(merged, Broadcast(_mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)));
+	// Each lane has 12 bytes at the start, move them next to each other
+	return _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+}
+
+// The kernels encode or decode as much as they can starting at pos, and return where they stopped. They load
+// 16 bytes for every 12 they encode, and write 16 bytes for every 12 they decode, so they stop short of the end
+
+BASE64_TARGET("ssse3")
+static size_t EncodeSsse3(const uint8_t* input, size_t sizeBytes, size_t pos, char*& output, const char* lut) {
+	const __m128i offsets = EncodeOffsets(lut);
+	for (; pos + 16 <= sizeBytes; pos += 12, output += 16) {
+		const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + pos));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(output), EncodeTranslate(EncodeReshuffle(block), offsets));
+	}
+	return pos;
+}
+
+BASE64_TARGET("avx2")
+static size_t EncodeAvx2(const uint8_t* input, size_t sizeBytes, size_t pos, char*& output, const char* lut) {
+	const __m256i offsets = Broadcast(EncodeOffsets(lut));
+	for (; pos + 28 <= sizeBytes; pos += 24, output += 32) {
+		const __m128i low  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + pos));
+		const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + pos + 12));
+		const __m256i block = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(output), EncodeTranslate(EncodeReshuffle(block), offsets));
+	}
+	return pos;
+}
+
+BASE64_TARGET("ssse3")
+static size_t DecodeSsse3(const uint8_t* in, size_t inLength, size_t pos, uint8_t* out, size_t outLength, size_t& outPos) {
+	for (; pos + 16 <= inLength && outPos + 16 <= outLength; pos += 16, outPos += 12) {
+		__m128i values;
+		if (!DecodeTranslate(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + pos)), values)) {
+			throw std::runtime_error("Input is not a base 64 string!");
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + outPos), DecodePack(values));
+	}
+	return pos;
+}
+
+BASE64_TARGET("avx2")
+static size_t DecodeAvx2(const uint8_t* in, size_t inLength, size_t pos, uint8_t* out, size_t outLength, size_t& outPos) {
+	for (; pos + 32 <= inLength && outPos + 32 <= outLength; pos += 32, outPos += 24) {
+		__m256i values;
+		if (!DecodeTranslate(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + pos)), values)) {
+			throw std::runtime_error("Input is not a base 64 string!");
+		}
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + outPos), DecodePack(values));
+	}
+	return pos;
+}
+#endif
+
+size_t Base64::GetEncodedSize(size_t sizeBytes, bool includeTrailing) {
+	if (includeTrailing) {
+		return ((sizeBytes + 2) / 3) * 4;
+	}
+	size_t remainder = sizeBytes % 3;
+	return (sizeBytes / 3) * 4 + (remainder == 0 ? 0 : remainder + 1);
+}
+
+std::string Base64::Encode(const void* data, size_t sizeBytes, bool urlEncode, bool includeTrailing)
+{
+	// We know exactly how big the output is, so we can write straight into it
+	std::string result(GetEncodedSize(sizeBytes, includeTrailing), '\0');
 
 	// Grab shorthands to various things we'll need
-	uint8_t* dataPtr = reinterpret_cast<uint8_t*>(data);
+	const uint8_t* input = reinterpret_cast<const uint8_t*>(data);
+	char* output = result.data();
 	const char* lut = LookupTables[urlEncode ? 1 : 0];
-	char paddingChar = lut[64];
-
-	// Iterate over all bytes in the data
-	for (size_t pos = 0; pos < sizeBytes; pos++) {
-		result.push_back(lut[(dataPtr[pos] & 0xfc) >> 2]); // 0b11111100 >> 2
-
-		if (pos + 1 < sizeBytes) {
-			// 0b00000011 << 4 + 0b11110000 >> 4
-			result.push_back(lut[((dataPtr[pos] & 0x03) << 4) + ((dataPtr[pos + 1] & 0xf0) >> 4)]);
-			
-			if (pos + 2 < sizeBytes) {
-				// 0b00001111 << 2 + 0b11000000 >> 6
-				result.push_back(lut[((dataPtr[pos + 1] & 0x0f) << 2) + ((dataPtr[pos + 2] & 0xc0) >> 6)]);
-				result.push_back(lut[dataPtr[pos + 2] & 0x3f]); // 0b00111111
-			}
-			else {
-				result.push_back(lut[(dataPtr[pos + 1] & 0x0f) << 2]); // 0b00001111 << 2
-				if (includeTrailing) {
-					result.push_back(paddingChar);
-				}
-			}
+	size_t pos = 0;
+
+	// The widest kernel does the bulk of the data, then the narrower one picks up what it left
+	#if BASE64_X86
+	const SimdLevel level = GetSimdLevel();
+	if (level >= SimdLevel::Avx2) {
+		pos = EncodeAvx2(input, sizeBytes, pos, output, lut);
+	}
+	if (level >= SimdLevel::Ssse3) {
+		pos = EncodeSsse3(input, sizeBytes, pos, output, lut);
+	}
+	#endif
+
+	// Handle the remaining full groups of 3 bytes
+	for (; pos + 3 <= sizeBytes; pos += 3) {
+		const uint32_t group = (input[pos] << 16) | (input[pos + 1] << 8) | input[pos + 2];
+		*output++ = lut[(group >> 18) & 0x3f];
+		*output++ = lut[(group >> 12) & 0x3f];
+		*output++ = lut[(group >> 6) & 0x3f];
+		*output++ = lut[group & 0x3f];
+	}
+
+	// Handle the last 1 or 2 bytes
+	const size_t remaining = sizeBytes - pos;
+	if (remaining > 0) {
+		const uint32_t group = (input[pos] << 16) | (remaining > 1 ? input[pos + 1] << 8 : 0);
+		*output++ = lut[(group >> 18) & 0x3f];
+		*output++ = lut[(group >> 12) & 0x3f];
+		if (remaining > 1) {
+			*output++ = lut[(group >> 6) & 0x3f];
 		}
-		else {
-			result.push_back(lut[(dataPtr[pos] & 0x03) << 4]); // 0b00000011 << 4
-			if (includeTrailing) {
-				result.push_back(paddingChar);
-				result.push_back(paddingChar);
+		if (includeTrailing) {
+			*output++ = lut[64];
+			if (remaining == 1) {
+				*output++ = lut[64];
 			}
 		}
 	}
@@ -69,39 +368,61 @@ std::string Base64::Encode(void* data, size_t sizeBytes, bool urlEncode, bool in
 
 std::string Base64::Decode(const std::string& input)
 {
-	if (input.empty()) return std::string();
+	// Padding is optional, so we just ignore it
+	size_t inLength = input.length();
+	while (inLength > 0 && (input.length() - inLength) < 2 && IsPadding(input[inLength - 1])) {
+		inLength--;
+	}
+	if (inLength == 0) return std::string();
 
-	if (!IsBase64(input)) {
+	// A single character left over can't represent a full byte
+	if (inLength % 4 == 1) {
 		throw std::runtime_error("Input is not a base 64 string!");
 	}
 
-	size_t inLength = input.length();
-	size_t approxOutLength = (inLength / 4) * 3;
-
-	std::string result;
-	result.reserve(approxOutLength);
-
-	for (size_t pos = 0; pos < inLength; pos += 4) {
-		size_t charPos1 = CharPos(input[pos + 1]);
-
-		result.push_back(static_cast<std::string::value_type>( ( CharPos(input[pos]) << 2 ) + ( (charPos1 & 0x30) >> 4) ) );
-
-		if (
-			(pos + 2 < inLength) &&
-			input[pos + 2] != '=' &&
-			input[pos + 2] != '.'
-		) {
-			size_t charPos2 = CharPos(input[pos + 2]);
-			result.push_back(static_cast<std::string::value_type>(((charPos1 & 0x0f) << 4) + ( (charPos2 & 0x3c) >> 2)));
-
-			if (
-				(pos + 3 < inLength) &&
-				input[pos + 3] != '=' &&
-				input[pos + 3] != '.'
-			) {
-				size_t charPos3 = CharPos(input[pos + 3]);
-				result.push_back(static_cast<std::string::value_type>(((charPos2 & 0x03) << 6) + charPos3));
-			}
+	// We know exactly how big the output is, so we can write straight into it
+	const size_t remainder = inLength % 4;
+	const size_t outLength = (inLength / 4) * 3 + (remainder == 0 ? 0 : remainder - 1);
+	std::string result(outLength, '\0');
+
+	const uint8_t* in = reinterpret_cast<const uint8_t*>(input.data());
+	uint8_t* out = reinterpret_cast<uint8_t*>(result.data());
+	size_t pos = 0;
+	size_t outPos = 0;
+
+	#if BASE64_X86
+	const SimdLevel level = GetSimdLevel();
+	if (level >= SimdLevel::Avx2) {
+		pos = DecodeAvx2(in, inLength, pos, out, outLength, outPos);
+	}
+	if (level >= SimdLevel::Ssse3) {
+		pos = DecodeSsse3(in, inLength, pos, out, outLength, outPos);
+	}
+	#endif
+
+	// Handle the remaining full groups of 4 characters
+	for (; pos + 4 <= inLength; pos += 4, outPos += 3) {
+		const uint8_t a = DecodeTable[in[pos]], b = DecodeTable[in[pos + 1]], c = DecodeTable[in[pos + 2]], d = DecodeTable[in[pos + 3]];
+		// InvalidChar is the only value with the top bit set
+		if ((a | b | c | d) & 0x80) {
+			throw std::runtime_error("Input is not a base 64 string!");
+		}
+		const uint32_t group = (a << 18) | (b << 12) | (c << 6) | d;
+		out[outPos] = static_cast<uint8_t>(group >> 16);
+		out[outPos + 1] = static_cast<uint8_t>(group >> 8);
+		out[outPos + 2] = static_cast<uint8_t>(group);
+	}
+
+	// Handle the last 2 or 3 characters
+	if (remainder > 0) {
+		const uint8_t a = DecodeTable[in[pos]], b = DecodeTable[in[pos + 1]], c = remainder > 2 ? DecodeTable[in[pos + 2]] : 0;
+		if ((a | b | c) & 0x80) {
+			throw std::runtime_error("Input is not a base 64 string!");
+		}
+		const uint32_t group = (a << 18) | (b << 12) | (c << 6);
+		out[outPos] = static_cast<uint8_t>(group >> 16);
+		if (remainder > 2) {
+			out[outPos + 1] = static_cast<uint8_t>(group >> 8);
 		}
 	}
 
@@ -111,9 +432,8 @@ std::string Base64::Decode(const std::string& input)
 bool Base64::IsBase64(const std::string& input)
 {
 	for (const char c : input) {
-		if (!(isalnum(c) || (c == '-') || (c == '_') || (c == '=') || (c == '.')))
+		if (DecodeTable[static_cast<uint8_t>(c)] == InvalidChar && !IsPadding(c))
 			return false;
 	}
 	return true;
 }
-
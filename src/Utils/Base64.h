@@ -1,12 +1,41 @@
 #pragma once
 
-#include <string>;
+#include <string>
+#include <cstdint>
 
+/// <summary>
+/// Encodes and decodes Base64 strings
+///
+/// On x86 CPUs that support AVX2 or SSSE3, the bulk of the data is processed 24 or 12 bytes at a
+/// time with vectorized lookups. The instruction set is picked at runtime, so no compiler flags are
+/// needed. The rest of the data (and CPUs without those instruction sets) use table driven scalar code
+/// </summary>
 class Base64 {
 public:
-	static std::string Encode(void* data, size_t sizeBytes, bool urlEncode = true, bool includeTrailing = false);
+	/// <summary>
+	/// Encodes binary data into a Base64 string
+	/// </summary>
+	/// <param name="data">The data to encode</param>
+	/// <param name="sizeBytes">The number of bytes to encode</param>
+	/// <param name="urlEncode">True to use the URL safe alphabet (-_.) instead of the standard one (+/=)</param>
+	/// <param name="includeTrailing">True to pad the output to a multiple of 4 characters</param>
+	static std::string Encode(const void* data, size_t sizeBytes, bool urlEncode = true, bool includeTrailing = false);
+	/// <summary>
+	/// Decodes a Base64 string in either alphabet, with or without padding
+	/// </summary>
+	/// <param name="input">The string to decode</param>
+	/// <returns>The decoded bytes</returns>
+	/// <exception cref="std::runtime_error">If the input is not valid Base64</exception>
 	static std::string Decode(const std::string& input);
+	/// <summary>
+	/// Returns true if the input only contains Base64 characters from either alphabet
+	/// </summary>
 	static bool IsBase64(const std::string& input);
 
+	/// <summary>
+	/// Gets the exact number of characters that Encode will produce for the given number of bytes
+	/// </summary>
+	static size_t GetEncodedSize(size_t sizeBytes, bool includeTrailing = false);
+
 	static const char* LookupTables[2];
-};
\ No newline at end of file
+};
@@ -0,0 +1,80 @@
+#include "Utils/BinaryStream.h"
+
+BinaryWriter::BinaryWriter() :
+	_data(std::vector<uint8_t>()),
+	_strings(std::vector<std::string>()),
+	_stringLookup(std::unordered_map<std::string, uint32_t>()),
+	_guids(std::vector<Guid>()),
+	_guidLookup(std::unordered_map<Guid, uint32_t>())
+{ }
+
+void BinaryWriter::WriteBytes(const void* data, size_t size) {
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	_data.insert(_data.end(), bytes, bytes + size);
+}
+
+void BinaryWriter::WriteString(const std::string& value) {
+	auto it = _stringLookup.find(value);
+	if (it == _stringLookup.end()) {
+		it = _stringLookup.emplace(value, static_cast<uint32_t>(_strings.size())).first;
+		_strings.push_back(value);
+	}
+	Write<uint32_t>(it->second);
+}
+
+void BinaryWriter::WriteGuid(const Guid& value) {
+	auto it = _guidLookup.find(value);
+	if (it == _guidLookup.end()) {
+		it = _guidLookup.emplace(value, static_cast<uint32_t>(_guids.size())).first;
+		_guids.push_back(value);
+	}
+	Write<uint32_t>(it->second);
+}
+
+BinaryReader::BinaryReader(const uint8_t* data, size_t size, const std::vector<std::string_view>* strings, const std::vector<Guid>* guids) :
+	_data(data),
+	_size(size),
+	_position(0),
+	_failed(false),
+	_strings(strings),
+	_guids(guids)
+{ }
+
+void BinaryReader::ReadBytes(void* result, size_t size) {
+	const uint8_t* span = ReadSpan(size);
+	if (span != nullptr) {
+		memcpy(result, span, size);
+	}
+}
+
+const uint8_t* BinaryReader::ReadSpan(size_t size) {
+	if (_failed || size > Remaining()) {
+		_failed = true;
+		return nullptr;
+	}
+	const uint8_t* result = _data + _position;
+	_position += size;
+	return result;
+}
+
+std::string_view BinaryReader::ReadString() {
+	uint32_t index = Read<uint32_t>();
+	if (_failed || _strings == nullptr || index >= _strings->size()) {
+		_failed = true;
+		return std::string_view();
+	}
+	return (*_strings)[index];
+}
+
+Guid BinaryReader::ReadGuid() {
+	uint32_t index = Read<uint32_t>();
+	if (_failed || _guids == nullptr || index >= _guids->size()) {
+		_failed = true;
+		return Guid();
+	}
+	return (*_guids)[index];
+}
+
+void BinaryReader::Skip(size_t size) {
+	ReadSpan(size);
+}
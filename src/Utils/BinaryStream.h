@@ -0,0 +1,167 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <type_traits>
+#include <cstring>
+#include <cstdint>
+
+#include "Utils/GUID.hpp"
+
+/// <summary>
+/// Appends binary data to a growable buffer, for writing binary files such as scenes
+///
+/// Strings and GUIDs are interned into tables instead of being written inline, and the
+/// body only stores a 32 bit index into the table. It is up to the owner of the writer to
+/// store the tables alongside the body (see Strings and Guids)
+///
+/// Values are written in the native byte order of the machine
+/// </summary>
+class BinaryWriter {
+public:
+	BinaryWriter();
+
+	/// <summary>
+	/// Writes a trivially copyable value to the end of the buffer
+	/// </summary>
+	/// <typeparam name="T">The type of value to write, must be trivially copyable (ex: ints, floats, glm types)</typeparam>
+	template <typename T>
+	void Write(const T& value) {
+		static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be written directly!");
+		WriteBytes(&value, sizeof(T));
+	}
+
+	/// <summary>
+	/// Writes a block of raw bytes to the end of the buffer
+	/// </summary>
+	void WriteBytes(const void* data, size_t size);
+	/// <summary>
+	/// Interns the string and writes it's index in the string table
+	/// </summary>
+	void WriteString(const std::string& value);
+	/// <summary>
+	/// Interns the GUID and writes it's index in the GUID table
+	/// </summary>
+	void WriteGuid(const Guid& value);
+
+	/// <summary>
+	/// Overwrites a value that was previously written at the given offset, used to
+	/// fill in sizes and counts once they are known
+	/// </summary>
+	template <typename T>
+	void Patch(size_t offset, const T& value) {
+		static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be written directly!");
+		memcpy(_data.data() + offset, &value, sizeof(T));
+	}
+
+	/// <summary>
+	/// Gets the number of bytes that have been written so far
+	/// </summary>
+	size_t Position() const { return _data.size(); }
+	/// <summary>
+	/// Gets the bytes that have been written
+	/// </summary>
+	const std::vector<uint8_t>& Data() const { return _data; }
+
+	/// <summary>
+	/// Gets all strings that have been interned, in the order of their indices
+	/// </summary>
+	const std::vector<std::string>& Strings() const { return _strings; }
+	/// <summary>
+	/// Gets all GUIDs that have been interned, in the order of their indices
+	/// </summary>
+	const std::vector<Guid>& Guids() const { return _guids; }
+
+private:
+	std::vector<uint8_t> _data;
+
+	std::vector<std::string> _strings;
+	std::unordered_map<std::string, uint32_t> _stringLookup;
+	std::vector<Guid> _guids;
+	std::unordered_map<Guid, uint32_t> _guidLookup;
+};
+
+/// <summary>
+/// Reads binary data written by a BinaryWriter from a block of memory, without taking
+/// ownership of or copying the memory (so that it can read directly from a mapped file)
+///
+/// Reading past the end of the data, or reading an index that is not in a table, will put
+/// the reader into a failed state rather than asserting, since the data may come from a
+/// corrupt file. Once failed, all reads will return default values, so callers only need to
+/// check IsValid once they are done reading
+/// </summary>
+class BinaryReader {
+public:
+	/// <summary>
+	/// Creates a new reader over the given memory
+	/// </summary>
+	/// <param name="data">The data to read from, must outlive the reader</param>
+	/// <param name="size">The size of the data, in bytes</param>
+	/// <param name="strings">The string table to resolve string indices with, must outlive the reader</param>
+	/// <param name="guids">The GUID table to resolve GUID indices with, must outlive the reader</param>
+	BinaryReader(const uint8_t* data, size_t size, const std::vector<std::string_view>* strings = nullptr, const std::vector<Guid>* guids = nullptr);
+
+	/// <summary>
+	/// Reads a trivially copyable value and advances the reader
+	/// </summary>
+	/// <typeparam name="T">The type of value to read, must be trivially copyable (ex: ints, floats, glm types)</typeparam>
+	template <typename T>
+	T Read() {
+		static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be read directly!");
+		T result{};
+		ReadBytes(&result, sizeof(T));
+		return result;
+	}
+
+	/// <summary>
+	/// Copies a block of raw bytes out of the data and advances the reader
+	/// </summary>
+	void ReadBytes(void* result, size_t size);
+	/// <summary>
+	/// Returns a pointer to the next size bytes in the data and advances the reader, or
+	/// nullptr if there is not enough data remaining
+	/// </summary>
+	const uint8_t* ReadSpan(size_t size);
+	/// <summary>
+	/// Reads a string that was written with BinaryWriter::WriteString. The result points
+	/// into the string table, and is only valid as long as the table is
+	/// </summary>
+	std::string_view ReadString();
+	/// <summary>
+	/// Reads a GUID that was written with BinaryWriter::WriteGuid
+	/// </summary>
+	Guid ReadGuid();
+
+	/// <summary>
+	/// Moves the reader forward by the given number of bytes
+	/// </summary>
+	void Skip(size_t size);
+
+	/// <summary>
+	/// Gets the offset of the reader from the start of the data
+	/// </summary>
+	size_t Position() const { return _position; }
+	/// <summary>
+	/// Gets the number of bytes left to read
+	/// </summary>
+	size_t Remaining() const { return _size - _position; }
+	/// <summary>
+	/// Returns true if all reads so far have been in bounds
+	/// </summary>
+	bool IsValid() const { return !_failed; }
+	/// <summary>
+	/// Puts the reader into a failed state, for when a caller finds the data to be invalid
+	/// </summary>
+	void Fail() { _failed = true; }
+
+private:
+	const uint8_t* _data;
+	size_t         _size;
+	size_t         _position;
+	bool           _failed;
+
+	const std::vector<std::string_view>* _strings;
+	const std::vector<Guid>* _guids;
+};
@@ -0,0 +1,207 @@
+#include "Utils/BlobStore.h"
+#include <fstream>
+#include <filesystem>
+#include <stdexcept>
+#include <map>
+#include <vector>
+#include <Logging.h>
+
+#include "Utils/Base64.h"
+
+size_t BlobStore::SidecarThreshold = 64 * 1024;
+float BlobStore::CompactThreshold = 0.5f;
+
+// State for the current write session, only ever touched from the main thread
+static std::ofstream WriteStream;
+static std::string WritePath;
+static uint64_t WriteOffset = 0;
+
+void BlobStore::BeginWrite(const std::string& path) {
+	if (IsWriting()) {
+		EndWrite();
+	}
+
+	WriteStream.open(path, std::ios::out | std::ios::binary | std::ios::app);
+	if (!WriteStream) {
+		LOG_WARN("Could not open blob file '{}', large data will be embedded", path);
+		return;
+	}
+	WritePath = path;
+	std::error_code error;
+	uintmax_t size = std::filesystem::file_size(path, error);
+	WriteOffset = error ? 0 : static_cast<uint64_t>(size);
+}
+
+void BlobStore::EndWrite() {
+	if (WriteStream.is_open()) {
+		WriteStream.close();
+	}
+	WritePath.clear();
+	WriteOffset = 0;
+}
+
+bool BlobStore::IsWriting() {
+	return WriteStream.is_open();
+}
+
+nlohmann::json BlobStore::Write(const void* data, size_t sizeBytes) {
+	if (!IsWriting() || sizeBytes < SidecarThreshold) {
+		return Base64::Encode(data, sizeBytes);
+	}
+
+	WriteStream.write(reinterpret_cast<const char*>(data), sizeBytes);
+	if (!WriteStream) {
+		LOG_WARN("Failed to write to blob file '{}', large data will be embedded", WritePath);
+		EndWrite();
+		return Base64::Encode(data, sizeBytes);
+	}
+
+	nlohmann::json result = nlohmann::json::object();
+	result["blob"] = WritePath;
+	result["offset"] = WriteOffset;
+	result["length"] = sizeBytes;
+	WriteOffset += sizeBytes;
+	return result;
+}
+
+std::string BlobStore::Read(const nlohmann::json& blob) {
+	if (blob.is_string()) {
+		return Base64::Decode(blob.get<std::string>());
+	}
+	if (!IsBlob(blob)) {
+		throw std::runtime_error("Value is not a blob!");
+	}
+
+	const std::string path = blob["blob"].get<std::string>();
+	const int64_t offset = blob["offset"].get<int64_t>();
+	const int64_t length = blob["length"].get<int64_t>();
+	if (offset < 0 || length < 0) {
+		throw std::runtime_error("Blob has a negative offset or length!");
+	}
+
+	std::ifstream in(path, std::ios::in | std::ios::binary);
+	if (!in) {
+		throw std::runtime_error("Could not open blob file '" + path + "'");
+	}
+	in.seekg(0, std::ios::end);
+	const int64_t size = static_cast<int64_t>(in.tellg());
+	if (offset > size || length > size - offset) {
+		throw std::runtime_error("Blob is outside of the range of '" + path + "'");
+	}
+
+	std::string result(length, '\0');
+	in.seekg(offset, std::ios::beg);
+	in.read(result.data(), length);
+	if (!in) {
+		throw std::runtime_error("Failed to read blob from '" + path + "'");
+	}
+	return result;
+}
+
+bool BlobStore::IsBlob(const nlohmann::json& blob) {
+	if (blob.is_string()) {
+		return true;
+	}
+	return blob.is_object() &&
+		blob.contains("blob") && blob["blob"].is_string() &&
+		blob.contains("offset") && blob["offset"].is_number_integer() &&
+		blob.contains("length") && blob["length"].is_number_integer();
+}
+
+// Finds every blob in a document that is stored in the given sidecar file
+static void FindBlobs(nlohmann::ordered_json& value, const std::string& path, std::vector<nlohmann::ordered_json*>& result) {
+	if (value.is_object()) {
+		auto blob = value.find("blob");
+		auto offset = value.find("offset");
+		auto length = value.find("length");
+		if (blob != value.end() && blob->is_string() && blob->get_ref<const std::string&>() == path &&
+			offset != value.end() && offset->is_number_integer() &&
+			length != value.end() && length->is_number_integer()) {
+			result.push_back(&value);
+			return;
+		}
+	}
+	if (value.is_structured()) {
+		for (nlohmann::ordered_json& child : value) {
+			FindBlobs(child, path, result);
+		}
+	}
+}
+
+size_t BlobStore::Compact(const std::string& path, nlohmann::ordered_json& document, bool force) {
+	if (IsWriting() && WritePath == path) {
+		LOG_WARN("Can't compact blob file '{}' while it is being written to", path);
+		return 0;
+	}
+	std::error_code error;
+	const uintmax_t fileSize = std::filesystem::file_size(path, error);
+	if (error) {
+		return 0;
+	}
+
+	std::vector<nlohmann::ordered_json*> blobs;
+	FindBlobs(document, path, blobs);
+
+	// Maps the (offset, length) of every referenced range to where it will be in the new file,
+	// several references can share a range so each one is only counted once
+	std::map<std::pair<int64_t, int64_t>, int64_t> ranges;
+	uintmax_t liveBytes = 0;
+	for (const nlohmann::ordered_json* blob : blobs) {
+		const int64_t offset = (*blob)["offset"].get<int64_t>();
+		const int64_t length = (*blob)["length"].get<int64_t>();
+		if (offset < 0 || length < 0 || static_cast<uintmax_t>(offset) + static_cast<uintmax_t>(length) > fileSize) {
+			LOG_WARN("Blob file '{}' is referenced outside of it's range, it will not be compacted", path);
+			return 0;
+		}
+		if (ranges.emplace(std::make_pair(offset, length), 0).second) {
+			liveBytes += length;
+		}
+	}
+	const uintmax_t deadBytes = liveBytes < fileSize ? fileSize - liveBytes : 0;
+	if (deadBytes == 0 || (!force && deadBytes <= fileSize * CompactThreshold)) {
+		return 0;
+	}
+
+	// Copy the referenced ranges into a new file in the order they were written, then swap it in
+	const std::string tempPath = path + ".tmp";
+	uintmax_t newSize = 0;
+	{
+		std::ifstream in(path, std::ios::in | std::ios::binary);
+		std::ofstream out(tempPath, std::ios::out | std::ios::binary | std::ios::trunc);
+		std::string buffer;
+		for (auto& [range, newOffset] : ranges) {
+			if (!in || !out) {
+				break;
+			}
+			buffer.resize(range.second);
+			in.seekg(range.first, std::ios::beg);
+			in.read(buffer.data(), range.second);
+			out.write(buffer.data(), range.second);
+			newOffset = static_cast<int64_t>(newSize);
+			newSize += range.second;
+		}
+		out.flush();
+		if (!in || !out) {
+			LOG_WARN("Failed to copy blobs while compacting '{}', leaving it as is", path);
+			out.close();
+			std::filesystem::remove(tempPath, error);
+			return 0;
+		}
+	}
+	std::filesystem::rename(tempPath, path, error);
+	if (error) {
+		LOG_WARN("Could not replace blob file '{}' while compacting it ({}), leaving it as is", path, error.message());
+		std::filesystem::remove(tempPath, error);
+		return 0;
+	}
+
+	// The new file is in place, so the references can be pointed at it
+	for (nlohmann::ordered_json* blob : blobs) {
+		const std::pair<int64_t, int64_t> range((*blob)["offset"].get<int64_t>(), (*blob)["length"].get<int64_t>());
+		(*blob)["offset"] = ranges[range];
+	}
+
+	const size_t reclaimed = static_cast<size_t>(fileSize - newSize);
+	LOG_INFO("Compacted blob file '{}', reclaimed {:.1f}KB of {:.1f}KB", path, reclaimed / 1024.0, fileSize / 1024.0);
+	return reclaimed;
+}
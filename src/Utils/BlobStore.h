@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <json.hpp>
+
+/// <summary>
+/// Handles large binary payloads (ex: embedded texture data) for JSON files
+///
+/// Small payloads are stored inline as a Base64 string. While a write session is open, payloads
+/// of at least SidecarThreshold bytes are instead appended to a sidecar binary file, and the JSON
+/// holds an object of the form { "blob": path, "offset": N, "length": M }
+///
+/// The sidecar is only ever appended to, so entries that were written by an earlier save (and
+/// were not re-serialized since) stay valid. Payloads that were re-serialized leave their old
+/// bytes behind, which Compact reclaims once enough of the file is no longer referenced
+/// </summary>
+class BlobStore {
+public:
+	BlobStore() = delete;
+
+	/// <summary>
+	/// The minimum size in bytes for a payload to be moved to the sidecar file, 64KiB by default
+	/// </summary>
+	static size_t SidecarThreshold;
+	/// <summary>
+	/// The fraction of a sidecar file that can be unreferenced before Compact rewrites it, 0.5 by default
+	/// </summary>
+	static float CompactThreshold;
+
+	/// <summary>
+	/// Starts a write session, large payloads written until EndWrite is called will be appended
+	/// to the given file, which is created if it does not exist
+	/// </summary>
+	/// <param name="path">The path of the sidecar file</param>
+	static void BeginWrite(const std::string& path);
+	/// <summary>
+	/// Ends the current write session, and flushes the sidecar file
+	/// </summary>
+	static void EndWrite();
+	/// <summary>
+	/// Returns true if a write session is open
+	/// </summary>
+	static bool IsWriting();
+
+	/// <summary>
+	/// Stores a binary payload, either in the sidecar file or as a Base64 string
+	/// </summary>
+	/// <param name="data">The data to store</param>
+	/// <param name="sizeBytes">The number of bytes to store</param>
+	/// <returns>The JSON value that references the payload, to be passed to Read</returns>
+	static nlohmann::json Write(const void* data, size_t sizeBytes);
+	/// <summary>
+	/// Loads a payload that was stored with Write, safe to call from any thread
+	/// </summary>
+	/// <param name="blob">The JSON value returned by Write</param>
+	/// <returns>The payload's bytes</returns>
+	/// <exception cref="std::runtime_error">If the blob is invalid, or could not be read</exception>
+	static std::string Read(const nlohmann::json& blob);
+	/// <summary>
+	/// Returns true if the JSON value looks like it was produced by Write
+	/// </summary>
+	static bool IsBlob(const nlohmann::json& blob);
+
+	/// <summary>
+	/// Rewrites a sidecar file so that it only holds the payloads that the given document references,
+	/// and updates their offsets in the document to match. Nothing is done unless more than
+	/// CompactThreshold of the file is unreferenced, or force is set
+	///
+	/// Every reference to the sidecar must be in the document, and nothing should be reading from
+	/// the sidecar with references that were copied out of it. If the file can't be rewritten, the
+	/// document and sidecar are left as they were
+	/// </summary>
+	/// <param name="path">The path of the sidecar file, as it was passed to BeginWrite</param>
+	/// <param name="document">The JSON that holds the references to the sidecar</param>
+	/// <param name="force">True to compact the sidecar even if it is under the threshold</param>
+	/// <returns>The number of bytes that were reclaimed</returns>
+	static size_t Compact(const std::string& path, nlohmann::ordered_json& document, bool force = false);
+};
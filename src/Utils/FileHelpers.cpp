@@ -1,6 +1,7 @@
 #include "Utils/FileHelpers.h"
 #include <fstream>
 #include <filesystem>
+#include <unordered_map>
 #include <Logging.h>
 
 #include "Utils/StringUtils.h"
@@ -100,3 +101,53 @@ void FileHelpers::WriteContentsToFile(const std::string& filename, const std::st
 	std::ofstream output(filename, std::ios::out | (append ? std::ios::app : 0));
 	output << contents;
 }
+
+uint64_t FileHelpers::HashFile(const std::string& filename) {
+	struct CachedHash {
+		std::filesystem::file_time_type WriteTime;
+		uintmax_t                       Size;
+		uint64_t                        Hash;
+	};
+	static std::unordered_map<std::string, CachedHash> cache;
+
+	std::error_code error;
+	std::filesystem::path path = std::filesystem::absolute(filename, error);
+	std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(path, error);
+	if (error) {
+		return 0;
+	}
+	uintmax_t size = std::filesystem::file_size(path, error);
+	if (error) {
+		return 0;
+	}
+
+	auto it = cache.find(path.string());
+	if (it != cache.end() && it->second.WriteTime == writeTime && it->second.Size == size) {
+		return it->second.Hash;
+	}
+
+	std::ifstream in(path, std::ios::in | std::ios::binary);
+	if (!in) {
+		return 0;
+	}
+
+	// FNV-1a, read in chunks so we never need the whole file in memory
+	uint64_t hash = 0xcbf29ce484222325ull;
+	char buffer[64 * 1024];
+	while (in) {
+		in.read(buffer, sizeof(buffer));
+		hash = HashData(buffer, static_cast<size_t>(in.gcount()), hash);
+	}
+
+	cache[path.string()] = CachedHash{ writeTime, size, hash };
+	return hash;
+}
+
+uint64_t FileHelpers::HashData(const void* data, size_t size, uint64_t hash) {
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+	for (size_t ix = 0; ix < size; ix++) {
+		hash ^= bytes[ix];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 
 class FileHelpers {
 public:
@@ -29,4 +30,22 @@ public:
 	/// <param name="contents">The contents of the file to write</param>
 	/// <param name="append">True if contents should be appended to end of existing files</param>
 	static void WriteContentsToFile(const std::string& filename, const std::string& contents, bool append = false);
+
+	/// <summary>
+	/// Computes a 64 bit FNV-1a hash of the contents of a file. Results are cached until the
+	/// file's size or modification time changes, so hashing the same file again is cheap
+	/// </summary>
+	/// <param name="filename">The path of the file to hash</param>
+	/// <returns>The hash of the file's contents, or 0 if the file could not be read</returns>
+	static uint64_t HashFile(const std::string& filename);
+
+	/// <summary>
+	/// Computes a 64 bit FNV-1a hash of some data, the same way HashFile does. Passing in the result of
+	/// a previous call as the hash continues hashing from there, so several pieces can be hashed together
+	/// </summary>
+	/// <param name="data">The data to hash</param>
+	/// <param name="size">The size of the data, in bytes</param>
+	/// <param name="hash">The hash to continue from, or the default to start a new hash</param>
+	/// <returns>The hash of the data</returns>
+	static uint64_t HashData(const void* data, size_t size, uint64_t hash = 0xcbf29ce484222325ull);
 };
\ No newline at end of file
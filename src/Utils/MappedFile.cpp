@@ -0,0 +1,94 @@
+#include "Utils/MappedFile.h"
+#include <Logging.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& filename) :
+	_data(nullptr),
+	_size(0),
+	_fileHandle(INVALID_HANDLE_VALUE),
+	_mappingHandle(nullptr)
+{
+	_fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (_fileHandle == INVALID_HANDLE_VALUE) {
+		LOG_ERROR("Could not open file '{}' for mapping", filename);
+		return;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(_fileHandle, &size) || size.QuadPart == 0) {
+		LOG_ERROR("Could not map empty or unreadable file '{}'", filename);
+		return;
+	}
+
+	_mappingHandle = CreateFileMappingA(_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (_mappingHandle == nullptr) {
+		LOG_ERROR("Could not map file '{}'", filename);
+		return;
+	}
+
+	_data = static_cast<const uint8_t*>(MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	_size = _data != nullptr ? static_cast<size_t>(size.QuadPart) : 0;
+}
+
+MappedFile::~MappedFile() {
+	if (_data != nullptr) {
+		UnmapViewOfFile(_data);
+	}
+	if (_mappingHandle != nullptr) {
+		CloseHandle(_mappingHandle);
+	}
+	if (_fileHandle != INVALID_HANDLE_VALUE) {
+		CloseHandle(_fileHandle);
+	}
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& filename) :
+	_data(nullptr),
+	_size(0),
+	_fileDescriptor(-1)
+{
+	_fileDescriptor = open(filename.c_str(), O_RDONLY);
+	if (_fileDescriptor < 0) {
+		LOG_ERROR("Could not open file '{}' for mapping", filename);
+		return;
+	}
+
+	struct stat info;
+	if (fstat(_fileDescriptor, &info) != 0 || info.st_size == 0) {
+		LOG_ERROR("Could not map empty or unreadable file '{}'", filename);
+		return;
+	}
+
+	void* mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, _fileDescriptor, 0);
+	if (mapping == MAP_FAILED) {
+		LOG_ERROR("Could not map file '{}'", filename);
+		return;
+	}
+
+	_data = static_cast<const uint8_t*>(mapping);
+	_size = static_cast<size_t>(info.st_size);
+}
+
+MappedFile::~MappedFile() {
+	if (_data != nullptr) {
+		munmap(const_cast<uint8_t*>(_data), _size);
+	}
+	if (_fileDescriptor >= 0) {
+		close(_fileDescriptor);
+	}
+}
+
+#endif
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+#include "Utils/Macros.h"
+
+/// <summary>
+/// Maps the contents of a file into memory as read-only, so that large binary files can be
+/// decoded in place without first being copied into a string or buffer. The mapping is
+/// released when the object is destroyed
+/// </summary>
+class MappedFile {
+public:
+	MAKE_PTRS(MappedFile);
+	NO_COPY(MappedFile);
+	NO_MOVE(MappedFile);
+
+	/// <summary>
+	/// Maps the file at the given path, check IsOpen to see if the mapping succeeded
+	/// </summary>
+	/// <param name="filename">The path of the file to map</param>
+	explicit MappedFile(const std::string& filename);
+	~MappedFile();
+
+	/// <summary>
+	/// Returns true if the file was mapped successfully
+	/// </summary>
+	bool IsOpen() const { return _data != nullptr; }
+	/// <summary>
+	/// Gets a pointer to the start of the mapped file, or nullptr if the file is not open
+	/// </summary>
+	const uint8_t* Data() const { return _data; }
+	/// <summary>
+	/// Gets the size of the mapped file, in bytes
+	/// </summary>
+	size_t Size() const { return _size; }
+
+private:
+	const uint8_t* _data;
+	size_t         _size;
+
+#ifdef _WIN32
+	void* _fileHandle;
+	void* _mappingHandle;
+#else
+	int   _fileDescriptor;
+#endif
+};
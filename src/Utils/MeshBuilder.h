@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
 #include "Graphics/VertexArrayObject.h"
+#include "Graphics/VertexCompression.h"
 
 /// <summary>
 /// A utility class that lets us add vertices and indices, then bake it into a final mesh, using interleaved
@@ -13,7 +14,11 @@ class MeshBuilder
 public:
 	MeshBuilder() :
 		_vertices(std::vector<VertType>()),
-		_indices(std::vector<uint32_t>()) {}
+		_indices(std::vector<uint32_t>()),
+		_submeshes(std::vector<Submesh>()),
+		_lods(std::vector<MeshLod>()),
+		_lodIndices(std::vector<uint32_t>()),
+		_lodSubmeshes(std::vector<Submesh>()) {}
 	~MeshBuilder() = default;
 
 	/// <summary>
@@ -70,6 +75,15 @@ public:
 		_indices.push_back(index);
 	}
 
+	/// <summary>
+	/// Adds a range of indices to the index buffer
+	/// </summary>
+	/// <param name="data">The array of indices to append to the buffer</param>
+	/// <param name="count">The number of indices in data</param>
+	void AddIndexRange(const uint32_t* data, size_t count) {
+		_indices.insert(_indices.end(), data, data + count);
+	}
+
 	/// <summary>
 	/// Adds a triangle between the three indices
 	/// </summary>
@@ -84,6 +98,78 @@ public:
 		_indices.push_back(c);
 	}
 	
+	/// <summary>
+	/// Adds a range of indices that should be drawn with the given material slot, the baked
+	/// VAO will draw each submesh separately (see VertexArrayObject::SetSubmeshes)
+	/// </summary>
+	/// <param name="firstIndex">The first index in the range</param>
+	/// <param name="indexCount">The number of indices in the range</param>
+	/// <param name="materialSlot">The material slot to draw the range with</param>
+	void AddSubmesh(uint32_t firstIndex, uint32_t indexCount, uint32_t materialSlot) {
+		Submesh submesh = Submesh();
+		submesh.FirstIndex = firstIndex;
+		submesh.IndexCount = indexCount;
+		submesh.MaterialSlot = materialSlot;
+		_submeshes.push_back(submesh);
+	}
+	/// <summary>
+	/// Gets the submeshes that have been added to this mesh
+	/// </summary>
+	const std::vector<Submesh>& GetSubmeshes() const { return _submeshes; }
+
+	/// <summary>
+	/// Adds a simplified level of detail to the mesh, which uses the same vertices with it's own
+	/// indices (see MeshSimplifier). Levels should be added from the most to the least detailed
+	/// </summary>
+	/// <param name="indices">The triangle list indices of the level</param>
+	/// <param name="submeshes">The submeshes of the level, relative to the start of indices</param>
+	/// <param name="error">How far the level is from the full detail mesh, relative to it's bounding radius</param>
+	void AddLod(const std::vector<uint32_t>& indices, const std::vector<Submesh>& submeshes, float error) {
+		MeshLod lod = MeshLod();
+		lod.FirstIndex = static_cast<uint32_t>(_lodIndices.size());
+		lod.IndexCount = static_cast<uint32_t>(indices.size());
+		lod.FirstSubmesh = static_cast<uint32_t>(_lodSubmeshes.size());
+		lod.SubmeshCount = static_cast<uint32_t>(submeshes.size());
+		lod.Error = error;
+		_lods.push_back(lod);
+		_lodIndices.insert(_lodIndices.end(), indices.begin(), indices.end());
+		_lodSubmeshes.insert(_lodSubmeshes.end(), submeshes.begin(), submeshes.end());
+	}
+	/// <summary>
+	/// Gets the levels of detail that have been added to this mesh
+	/// </summary>
+	const std::vector<MeshLod>& GetLods() const { return _lods; }
+	/// <summary>
+	/// Gets the indices of every level of detail, see MeshLod::FirstIndex
+	/// </summary>
+	const std::vector<uint32_t>& GetLodIndices() const { return _lodIndices; }
+	/// <summary>
+	/// Gets the submeshes of every level of detail, see MeshLod::FirstSubmesh
+	/// </summary>
+	const std::vector<Submesh>& GetLodSubmeshes() const { return _lodSubmeshes; }
+
+	/// <summary>
+	/// Calculates the bounding box of the vertices in the mesh
+	/// </summary>
+	/// <param name="min">Receives the minimum position of any vertex</param>
+	/// <param name="max">Receives the maximum position of any vertex</param>
+	/// <returns>True if the mesh has vertices with a 3 component float position</returns>
+	bool CalculateBounds(glm::vec3& min, glm::vec3& max) const {
+		for (const BufferAttribute& attrib : VertType::V_DECL) {
+			if (attrib.Usage == AttribUsage::Position && attrib.Type == AttributeType::Float && attrib.Size == 3 && !_vertices.empty()) {
+				const uint8_t* vertices = reinterpret_cast<const uint8_t*>(_vertices.data());
+				min = max = *reinterpret_cast<const glm::vec3*>(vertices + attrib.Offset);
+				for (size_t ix = 1; ix < _vertices.size(); ix++) {
+					const glm::vec3& pos = *reinterpret_cast<const glm::vec3*>(vertices + ix * sizeof(VertType) + attrib.Offset);
+					min = glm::min(min, pos);
+					max = glm::max(max, pos);
+				}
+				return true;
+			}
+		}
+		return false;
+	}
+
 	/// <summary>
 	/// Resizes the internal vector to allocate space for new vertices, can improve
 	/// performance when appending large meshes of a known size
@@ -117,36 +203,68 @@ public:
 	size_t GetTriangleCount() const { return _indices.size() > 0 ? _indices.size() / 3 : _vertices.size() / 3; }
 
 	/// <summary>
-	/// Creates and returns a VertexArraybject from the current data
+	/// Creates and returns a VertexArraybject from the current data. Vertex types that have a compressed
+	/// form are packed into it (see VertexCompression), so the VAO's vertex declaration may not be VertType's
 	/// </summary>
 	/// <returns>A VertexArrayObject</returns>
 	VertexArrayObject::Sptr Bake() {
+		glm::vec3 min, max;
+		bool hasBounds = CalculateBounds(min, max);
+
+		// Compressed positions are relative to the bounds, so we can only pack the vertices if we have them
 		VertexBuffer::Sptr vbo = VertexBuffer::Create();
-		vbo->LoadData(GetVertexDataPtr(), _vertices.size());
+		VertexCompression::PackedVertices packed;
+		const std::vector<BufferAttribute>* vDecl = &VertType::V_DECL;
+		if (hasBounds && VertexCompression::Compress(GetVertexDataPtr(), _vertices.size(), min, max, packed)) {
+			vbo->LoadData(packed.Data.data(), packed.Stride, packed.Count);
+			vDecl = packed.VDecl;
+		} else {
+			vbo->LoadData(GetVertexDataPtr(), _vertices.size());
+		}
 
+		// Most meshes have few enough vertices to use 16 bit indices
 		IndexBuffer::Sptr ebo = nullptr;
 		if (_indices.size() > 0) {
 			ebo = IndexBuffer::Create();
-			ebo->LoadData(GetIndexDataPtr(), _indices.size());
+			ebo->LoadIndices(GetIndexDataPtr(), static_cast<uint32_t>(_indices.size()), _vertices.size());
 		}
 
 		// Create VAO and attach the buffers
 		VertexArrayObject::Sptr result = VertexArrayObject::Create();
-		result->AddVertexBuffer(vbo, VertType::V_DECL);
+		result->AddVertexBuffer(vbo, *vDecl);
 		result->SetIndexBuffer(ebo);
+		result->SetSubmeshes(_submeshes);
 
 		// Store our vertex type in the VAO's vertex declaration
-		result->SetVDecl(VertType::V_DECL);
+		result->SetVDecl(*vDecl);
+
+		if (hasBounds) {
+			result->SetBounds(min, max);
+		}
+
+		// Each level of detail gets it's own index buffer, so the full detail mesh is unchanged
+		std::vector<VertexArrayObject::Lod> lods;
+		for (const MeshLod& lod : _lods) {
+			IndexBuffer::Sptr lodIndices = IndexBuffer::Create();
+			lodIndices->LoadIndices(_lodIndices.data() + lod.FirstIndex, lod.IndexCount, _vertices.size());
+			std::vector<Submesh> lodSubmeshes(_lodSubmeshes.begin() + lod.FirstSubmesh, _lodSubmeshes.begin() + lod.FirstSubmesh + lod.SubmeshCount);
+			lods.push_back({ result->CreateLod(lodIndices, lodSubmeshes), lod.Error });
+		}
+		result->SetLods(lods);
 
 		return result;
 	}
 	
 	/// <summary>
-	/// Resets this mesh, removing all vertices and indices
+	/// Resets this mesh, removing all vertices, indices, submeshes and levels of detail
 	/// </summary>
 	void Reset() {
 		_vertices.clear();
 		_indices.clear();
+		_submeshes.clear();
+		_lods.clear();
+		_lodIndices.clear();
+		_lodSubmeshes.clear();
 	}
 
 	/// <summary>
@@ -166,7 +284,14 @@ public:
 	
 protected:
 	friend class MeshFactory;
+	friend class MeshOptimizer;
+	friend class MeshSimplifier;
 	
 	std::vector<VertType> _vertices;
 	std::vector<uint32_t> _indices;
+	std::vector<Submesh>  _submeshes;
+
+	std::vector<MeshLod>  _lods;
+	std::vector<uint32_t> _lodIndices;
+	std::vector<Submesh>  _lodSubmeshes;
 };
@@ -7,6 +7,8 @@
 
 #include <EnumToString.h>
 
+class JobSystem;
+
 /// <summary>
 /// Represent the type of object added by a MeshBuilderParam
 /// </summary>
@@ -149,12 +151,22 @@ public:
 	static void InvertFaces(MeshBuilder<Vertex>& mesh);
 
 	/// <summary>
-	/// Calculates the tangents and bitangents from the normal and UV coords
+	/// Calculates the tangents and bitangents from the positions and UV coords, see TangentSpace::CalculateTangents
+	/// </summary>
+	/// <typeparam name="Vertex">The type of vertex the mesh consists of</typeparam>
+	/// <param name="mesh">The mesh to manipulate</param>
+	/// <param name="jobs">The job system to split large meshes between, or nullptr to use the calling thread</param>
+	template <typename Vertex>
+	static void CalculateTBN(MeshBuilder<Vertex>& mesh, JobSystem* jobs = nullptr);
+
+	/// <summary>
+	/// Replaces the normals of a mesh with smooth normals, see TangentSpace::CalculateNormals
 	/// </summary>
 	/// <typeparam name="Vertex">The type of vertex the mesh consists of</typeparam>
 	/// <param name="mesh">The mesh to manipulate</param>
+	/// <param name="jobs">The job system to split large meshes between, or nullptr to use the calling thread</param>
 	template <typename Vertex>
-	static void CalculateTBN(MeshBuilder<Vertex>& mesh);
+	static void CalculateNormals(MeshBuilder<Vertex>& mesh, JobSystem* jobs = nullptr);
 
 protected:	
 	MeshFactory() = default;
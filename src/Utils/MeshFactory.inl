@@ -10,6 +10,7 @@
 #include "MeshFactory.h"
 #include "Utils/JsonGlmHelpers.h"
 #include "Graphics/VertexParamMap.h"
+#include "Utils/TangentSpace.h"
 
 #define M_PI 3.14159265359f
 
@@ -554,7 +555,7 @@ void MeshFactory::InvertFaces(MeshBuilder<Vertex>& mesh)
 
 
 template <typename Vertex>
-void MeshFactory::CalculateTBN(MeshBuilder<Vertex>& mesh)
+void MeshFactory::CalculateTBN(MeshBuilder<Vertex>& mesh, JobSystem* jobs)
 {
 	VertexParamMap vMap = VertexParamMap(Vertex::V_DECL);
 	if (vMap.TangentOffset == -1 && vMap.BiTangentOffset == -1) {
@@ -570,50 +571,48 @@ void MeshFactory::CalculateTBN(MeshBuilder<Vertex>& mesh)
 		return;
 	}
 
-	for (size_t i = 0; i < mesh._vertices.size(); i++) {
-		vMap.SetTangent(mesh._vertices[i], glm::vec3(0.0f));
-		vMap.SetBiTangent(mesh._vertices[i], glm::vec3(0.0f));
+	// Pull the attributes out of the vertices, so the generator doesn't need to know about our vertex type
+	const size_t vertexCount = mesh._vertices.size();
+	std::vector<glm::vec3> positions(vertexCount);
+	std::vector<glm::vec2> uvs(vertexCount);
+	for (size_t i = 0; i < vertexCount; i++) {
+		positions[i] = vMap.GetPosition(mesh._vertices[i]);
+		uvs[i] = vMap.GetTexture(mesh._vertices[i]);
 	}
 
-	// Iterate over all indices in the mesh, we'll assume that the mesh is indexed
-	for (size_t i = 0; i < mesh._indices.size(); i += 3) {
-		Vertex& v1 = mesh._vertices[mesh._indices[i + 0u]];
-		Vertex& v2 = mesh._vertices[mesh._indices[i + 1u]];
-		Vertex& v3 = mesh._vertices[mesh._indices[i + 2u]];
-
-		// Extract the positions from the mesh
-		glm::vec3 pos[3];
-		pos[0] = vMap.GetPosition(v1);
-		pos[1] = vMap.GetPosition(v2);
-		pos[2] = vMap.GetPosition(v3);
-
-		// Extract the UVs from the mesh
-		glm::vec2 uvs[3];
-		uvs[0] = vMap.GetTexture(v1);
-		uvs[1] = vMap.GetTexture(v2);
-		uvs[2] = vMap.GetTexture(v3);
-
-		// Calculate 2 corner vectors
-		glm::vec3 deltaP1 = pos[1] - pos[0];
-		glm::vec3 deltaP2 = pos[2] - pos[0];
-
-		// Calculate UV deltas
-		glm::vec2 deltaT1 = uvs[1] - uvs[0];
-		glm::vec2 deltaT2 = uvs[2] - uvs[0];
-
-		// Use the deltas in position and UV to calculate the tangent and bitangent
-		// https://learnopengl.com/Advanced-Lighting/Normal-Mapping
-		float r = 1.0f / (deltaT1.x * deltaT2.y - deltaT1.y * deltaT2.x);
-		glm::vec3 tangent = glm::normalize((deltaP1 * deltaT2.y - deltaP2 * deltaT1.y) * r);
-		glm::vec3 bitangent = glm::normalize((deltaP2 * deltaT1.x - deltaP1 * deltaT2.x) * r);
-
-		// Set attributes in the vertex
-		vMap.SetTangent(v1, glm::normalize((vMap.GetTangent(v1) + tangent) / 2.0f));
-		vMap.SetTangent(v2, glm::normalize((vMap.GetTangent(v2) + tangent) / 2.0f));
-		vMap.SetTangent(v3, glm::normalize((vMap.GetTangent(v3) + tangent) / 2.0f));
-
-		vMap.SetBiTangent(v1, glm::normalize((vMap.GetBiTangent(v1) + bitangent) / 2.0f));
-		vMap.SetBiTangent(v2, glm::normalize((vMap.GetBiTangent(v1) + bitangent) / 2.0f));
-		vMap.SetBiTangent(v3, glm::normalize((vMap.GetBiTangent(v1) + bitangent) / 2.0f));
+	std::vector<glm::vec3> tangents(vertexCount);
+	std::vector<glm::vec3> bitangents(vertexCount);
+	TangentSpace::CalculateTangents(mesh._indices.data(), mesh._indices.size(), positions.data(), uvs.data(), vertexCount, tangents.data(), bitangents.data(), jobs);
+
+	for (size_t i = 0; i < vertexCount; i++) {
+		vMap.SetTangent(mesh._vertices[i], tangents[i]);
+		vMap.SetBiTangent(mesh._vertices[i], bitangents[i]);
+	}
+}
+
+template <typename Vertex>
+void MeshFactory::CalculateNormals(MeshBuilder<Vertex>& mesh, JobSystem* jobs)
+{
+	VertexParamMap vMap = VertexParamMap(Vertex::V_DECL);
+	if (vMap.PositionOffset == -1 || vMap.NormalOffset == -1) {
+		LOG_WARN("Vertex type does not have position and normal attributes, aborting CalculateNormals");
+		return;
+	}
+	if (mesh._indices.size() == 0) {
+		LOG_WARN("Mesh does not have indices, aborting CalculateNormals");
+		return;
+	}
+
+	const size_t vertexCount = mesh._vertices.size();
+	std::vector<glm::vec3> positions(vertexCount);
+	for (size_t i = 0; i < vertexCount; i++) {
+		positions[i] = vMap.GetPosition(mesh._vertices[i]);
+	}
+
+	std::vector<glm::vec3> normals(vertexCount);
+	TangentSpace::CalculateNormals(mesh._indices.data(), mesh._indices.size(), positions.data(), vertexCount, normals.data(), jobs);
+
+	for (size_t i = 0; i < vertexCount; i++) {
+		vMap.SetNormal(mesh._vertices[i], normals[i]);
 	}
 }
\ No newline at end of file
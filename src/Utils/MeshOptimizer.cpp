@@ -0,0 +1,286 @@
+#include "Utils/MeshOptimizer.h"
+
+#include <algorithm>
+#include <numeric>
+
+static constexpr uint32_t NoVertex = 0xFFFFFFFF;
+
+bool MeshOptimizer::Verbose = false;
+
+/// <summary>
+/// Simulates a FIFO cache using timestamps, a vertex is still in the cache if fewer than cacheSize
+/// vertices have been added since it was
+/// </summary>
+class VertexCacheSim {
+public:
+	VertexCacheSim(size_t vertexCount, uint32_t cacheSize) :
+		_added(std::vector<uint32_t>(vertexCount, 0)),
+		_time(cacheSize + 1),
+		_cacheSize(cacheSize)
+	{ }
+
+	// Adds the vertex to the cache, returning true if it wasn't there already
+	bool Touch(uint32_t vertex) {
+		if (_time - _added[vertex] > _cacheSize) {
+			_added[vertex] = _time++;
+			return true;
+		}
+		return false;
+	}
+	// Returns how long ago the vertex was added to the cache, larger than the cache size if it's not there
+	uint32_t Age(uint32_t vertex) const {
+		return _time - _added[vertex];
+	}
+	// Empties the cache
+	void Flush() {
+		_time += _cacheSize + 1;
+	}
+
+private:
+	std::vector<uint32_t> _added;
+	uint32_t              _time;
+	uint32_t              _cacheSize;
+};
+
+// Returns true if every index refers to a vertex, so the passes can index arrays with them directly
+static bool IndicesInRange(const uint32_t* indices, size_t indexCount, size_t vertexCount) {
+	for (size_t ix = 0; ix < indexCount; ix++) {
+		if (indices[ix] >= vertexCount) {
+			return false;
+		}
+	}
+	return true;
+}
+
+MeshOptimizer::CacheStats MeshOptimizer::AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize) {
+	CacheStats result = CacheStats();
+	if (indexCount < 3 || !IndicesInRange(indices, indexCount, vertexCount)) {
+		return result;
+	}
+
+	VertexCacheSim cache(vertexCount, cacheSize);
+	std::vector<bool> used(vertexCount, false);
+	size_t misses = 0;
+	size_t usedVertices = 0;
+	for (size_t ix = 0; ix < indexCount; ix++) {
+		misses += cache.Touch(indices[ix]) ? 1 : 0;
+		if (!used[indices[ix]]) {
+			used[indices[ix]] = true;
+			usedVertices++;
+		}
+	}
+
+	result.ACMR = static_cast<float>(misses) / static_cast<float>(indexCount / 3);
+	result.ATVR = static_cast<float>(misses) / static_cast<float>(usedVertices);
+	return result;
+}
+
+void MeshOptimizer::OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize, std::vector<uint32_t>* clusters) {
+	if (clusters != nullptr) {
+		clusters->clear();
+	}
+	const size_t triCount = indexCount / 3;
+	if (triCount == 0 || !IndicesInRange(indices, indexCount, vertexCount)) {
+		return;
+	}
+
+	// Build the list of triangles that use each vertex, live counts how many are still to be emitted
+	std::vector<uint32_t> live(vertexCount, 0);
+	for (size_t ix = 0; ix < triCount * 3; ix++) {
+		live[indices[ix]]++;
+	}
+	std::vector<uint32_t> adjacencyStart(vertexCount + 1, 0);
+	for (size_t ix = 0; ix < vertexCount; ix++) {
+		adjacencyStart[ix + 1] = adjacencyStart[ix] + live[ix];
+	}
+	std::vector<uint32_t> adjacency(triCount * 3);
+	std::vector<uint32_t> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+	for (size_t ix = 0; ix < triCount * 3; ix++) {
+		adjacency[fill[indices[ix]]++] = static_cast<uint32_t>(ix / 3);
+	}
+
+	std::vector<bool> emitted(triCount, false);
+	std::vector<uint32_t> output;
+	output.reserve(triCount * 3);
+	// Vertices of recently emitted triangles, which we fall back to when we run out of candidates
+	std::vector<uint32_t> deadEnd;
+	std::vector<uint32_t> candidates;
+	VertexCacheSim cache(vertexCount, cacheSize);
+	size_t scanCursor = 0;
+
+	// Fan out from a vertex, emitting all of it's triangles, then pick the next vertex to fan from
+	uint32_t fanning = indices[0];
+	bool newCluster = true;
+	while (fanning != NoVertex) {
+		if (newCluster && clusters != nullptr) {
+			clusters->push_back(static_cast<uint32_t>(output.size() / 3));
+		}
+		newCluster = false;
+
+		candidates.clear();
+		for (uint32_t adj = adjacencyStart[fanning]; adj < adjacencyStart[fanning + 1]; adj++) {
+			uint32_t tri = adjacency[adj];
+			if (emitted[tri]) { continue; }
+			emitted[tri] = true;
+			for (int corner = 0; corner < 3; corner++) {
+				uint32_t vertex = indices[tri * 3 + corner];
+				output.push_back(vertex);
+				deadEnd.push_back(vertex);
+				candidates.push_back(vertex);
+				live[vertex]--;
+				cache.Touch(vertex);
+			}
+		}
+
+		// Prefer the oldest vertex that will still be in the cache once all of it's triangles are emitted
+		fanning = NoVertex;
+		int bestPriority = -1;
+		for (uint32_t vertex : candidates) {
+			if (live[vertex] == 0) { continue; }
+			int priority = 0;
+			if (cache.Age(vertex) + 2 * live[vertex] <= cacheSize) {
+				priority = static_cast<int>(cache.Age(vertex));
+			}
+			if (priority > bestPriority) {
+				bestPriority = priority;
+				fanning = vertex;
+			}
+		}
+
+		// If none of the candidates have triangles left, we've hit a dead end and start a new cluster
+		if (fanning == NoVertex) {
+			newCluster = true;
+			while (!deadEnd.empty() && fanning == NoVertex) {
+				uint32_t vertex = deadEnd.back();
+				deadEnd.pop_back();
+				if (live[vertex] > 0) { fanning = vertex; }
+			}
+			while (fanning == NoVertex && scanCursor < vertexCount) {
+				if (live[scanCursor] > 0) { fanning = static_cast<uint32_t>(scanCursor); }
+				scanCursor++;
+			}
+		}
+	}
+
+	std::copy(output.begin(), output.end(), indices);
+}
+
+void MeshOptimizer::OptimizeOverdraw(uint32_t* indices, size_t indexCount, const glm::vec3* positions, size_t vertexCount, const std::vector<uint32_t>& clusters, uint32_t cacheSize, float threshold) {
+	const size_t triCount = indexCount / 3;
+	if (triCount == 0 || clusters.empty() || !IndicesInRange(indices, indexCount, vertexCount)) {
+		return;
+	}
+
+	auto countMisses = [&](VertexCacheSim& cache, size_t tri) {
+		return (cache.Touch(indices[tri * 3]) ? 1 : 0) + (cache.Touch(indices[tri * 3 + 1]) ? 1 : 0) + (cache.Touch(indices[tri * 3 + 2]) ? 1 : 0);
+	};
+
+	// Tipsify only flushes the cache rarely, so we split each cluster where the ACMR so far is
+	// close to what the whole cluster gets. This gives us smaller pieces to sort, for almost no cache cost
+	VertexCacheSim cache(vertexCount, cacheSize);
+	std::vector<uint32_t> splits;
+	for (size_t clusterIx = 0; clusterIx < clusters.size(); clusterIx++) {
+		size_t start = clusters[clusterIx];
+		size_t end = clusterIx + 1 < clusters.size() ? clusters[clusterIx + 1] : triCount;
+		if (start >= end) { continue; }
+
+		cache.Flush();
+		size_t clusterMisses = 0;
+		for (size_t tri = start; tri < end; tri++) {
+			clusterMisses += countMisses(cache, tri);
+		}
+		float limit = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - start);
+
+		cache.Flush();
+		splits.push_back(static_cast<uint32_t>(start));
+		size_t misses = 0;
+		size_t faces = 0;
+		for (size_t tri = start; tri < end; tri++) {
+			misses += countMisses(cache, tri);
+			faces++;
+			if (tri + 1 < end && static_cast<float>(misses) <= limit * static_cast<float>(faces)) {
+				splits.push_back(static_cast<uint32_t>(tri + 1));
+				cache.Flush();
+				misses = 0;
+				faces = 0;
+			}
+		}
+	}
+
+	// Find the area weighted center and normal of each piece, and of the mesh as a whole
+	struct Piece {
+		uint32_t  Start;
+		uint32_t  End;
+		glm::vec3 Centroid;
+		glm::vec3 Normal;
+		float     Area;
+		float     SortKey;
+	};
+	std::vector<Piece> pieces(splits.size());
+	glm::vec3 meshCentroid = glm::vec3(0.0f);
+	float meshArea = 0.0f;
+	for (size_t ix = 0; ix < splits.size(); ix++) {
+		Piece& piece = pieces[ix];
+		piece.Start = splits[ix];
+		piece.End = ix + 1 < splits.size() ? splits[ix + 1] : static_cast<uint32_t>(triCount);
+		piece.Centroid = glm::vec3(0.0f);
+		piece.Normal = glm::vec3(0.0f);
+		piece.Area = 0.0f;
+		for (uint32_t tri = piece.Start; tri < piece.End; tri++) {
+			const glm::vec3& a = positions[indices[tri * 3]];
+			const glm::vec3& b = positions[indices[tri * 3 + 1]];
+			const glm::vec3& c = positions[indices[tri * 3 + 2]];
+			glm::vec3 normal = glm::cross(b - a, c - a);
+			float area = glm::length(normal);
+			piece.Centroid += (a + b + c) * (area / 3.0f);
+			piece.Normal += normal;
+			piece.Area += area;
+		}
+		meshCentroid += piece.Centroid;
+		meshArea += piece.Area;
+		piece.Centroid = piece.Area > 0.0f ? piece.Centroid / piece.Area : glm::vec3(0.0f);
+	}
+	if (meshArea > 0.0f) {
+		meshCentroid /= meshArea;
+	}
+
+	// Pieces that face away from the center are more likely to be in front of the rest of the mesh, so draw them first
+	for (Piece& piece : pieces) {
+		float normalLength = glm::length(piece.Normal);
+		piece.SortKey = normalLength > 0.0f ? glm::dot(piece.Centroid - meshCentroid, piece.Normal / normalLength) : 0.0f;
+	}
+	std::stable_sort(pieces.begin(), pieces.end(), [](const Piece& a, const Piece& b) {
+		return a.SortKey > b.SortKey;
+	});
+
+	std::vector<uint32_t> output;
+	output.reserve(triCount * 3);
+	for (const Piece& piece : pieces) {
+		output.insert(output.end(), indices + piece.Start * 3, indices + piece.End * 3);
+	}
+	std::copy(output.begin(), output.end(), indices);
+}
+
+std::vector<uint32_t> MeshOptimizer::OptimizeVertexFetch(uint32_t* indices, size_t indexCount, size_t vertexCount) {
+	std::vector<uint32_t> remap(vertexCount, NoVertex);
+	if (!IndicesInRange(indices, indexCount, vertexCount)) {
+		std::iota(remap.begin(), remap.end(), 0);
+		return remap;
+	}
+
+	uint32_t next = 0;
+	for (size_t ix = 0; ix < indexCount; ix++) {
+		uint32_t& target = remap[indices[ix]];
+		if (target == NoVertex) {
+			target = next++;
+		}
+		indices[ix] = target;
+	}
+	// Keep any unused vertices, after all of the used ones
+	for (uint32_t& target : remap) {
+		if (target == NoVertex) {
+			target = next++;
+		}
+	}
+	return remap;
+}
@@ -0,0 +1,182 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <GLM/glm.hpp>
+#include <Logging.h>
+
+#include "MeshBuilder.h"
+
+/// <summary>
+/// Reorders the triangles and vertices of a mesh so that it renders faster, without changing how it looks
+///
+/// The pass is run when a mesh is built (loading an OBJ, converting it to a binary file or generating it
+/// from MeshBuilderParams), and does three things:
+///   - Orders triangles for the post-transform vertex cache, using Tipsify (Sander et al. 2007)
+///   - Sorts the clusters of triangles that Tipsify produces so that outward facing clusters are drawn
+///     first, which reduces overdraw without undoing the cache ordering
+///   - Reorders vertices in the order they are first used, so vertex fetches walk through memory
+///
+/// Submeshes and levels of detail are optimized individually, so their index ranges stay the same
+/// </summary>
+class MeshOptimizer {
+public:
+	/// <summary>
+	/// The post-transform cache size that we optimize for, a conservative size that suits most GPUs
+	/// </summary>
+	static constexpr uint32_t DefaultCacheSize = 16;
+	/// <summary>
+	/// True to have Optimize measure and log the cache statistics of every mesh before and after it is
+	/// optimized, false by default since it costs two extra passes over the indices
+	/// </summary>
+	static bool Verbose;
+
+	/// <summary>
+	/// How well an index buffer uses a FIFO post-transform vertex cache
+	/// </summary>
+	struct CacheStats {
+		/// <summary>
+		/// The average cache miss ratio, the number of vertices transformed per triangle (0.5 - 3, lower is better)
+		/// </summary>
+		float ACMR = 0.0f;
+		/// <summary>
+		/// The average transform to vertex ratio, the number of times each vertex is transformed (1 is optimal)
+		/// </summary>
+		float ATVR = 0.0f;
+	};
+
+	/// <summary>
+	/// Simulates a FIFO vertex cache to measure how well a triangle list will reuse transformed vertices
+	/// </summary>
+	/// <param name="indices">The triangle list indices</param>
+	/// <param name="indexCount">The number of indices, must be a multiple of 3</param>
+	/// <param name="vertexCount">The number of vertices that the indices refer to</param>
+	/// <param name="cacheSize">The number of vertices the simulated cache holds</param>
+	static CacheStats AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = DefaultCacheSize);
+
+	/// <summary>
+	/// Reorders the triangles in a triangle list for the post-transform vertex cache, using Tipsify
+	/// </summary>
+	/// <param name="indices">The triangle list indices to reorder in place</param>
+	/// <param name="indexCount">The number of indices, must be a multiple of 3</param>
+	/// <param name="vertexCount">The number of vertices that the indices refer to</param>
+	/// <param name="cacheSize">The number of vertices the cache holds</param>
+	/// <param name="clusters">If not null, receives the index of the first triangle of each cluster, where the cache was flushed</param>
+	static void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = DefaultCacheSize, std::vector<uint32_t>* clusters = nullptr);
+
+	/// <summary>
+	/// Reorders clusters of triangles so that outward facing clusters are drawn before the ones they may
+	/// cover. The indices should already be optimized with OptimizeVertexCache
+	/// </summary>
+	/// <param name="indices">The triangle list indices to reorder in place</param>
+	/// <param name="indexCount">The number of indices, must be a multiple of 3</param>
+	/// <param name="positions">The position of each vertex</param>
+	/// <param name="vertexCount">The number of vertices that the indices refer to</param>
+	/// <param name="clusters">The first triangle of each cluster from OptimizeVertexCache</param>
+	/// <param name="cacheSize">The number of vertices the cache holds</param>
+	/// <param name="threshold">How much worse than the Tipsify ordering (ACMR) we allow clusters to get, so they can be split up further</param>
+	static void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const glm::vec3* positions, size_t vertexCount, const std::vector<uint32_t>& clusters, uint32_t cacheSize = DefaultCacheSize, float threshold = 1.05f);
+
+	/// <summary>
+	/// Works out a new order for vertices so that they are stored in the order they are first used, and
+	/// updates the indices to match. Vertices that are never used are moved to the end
+	/// </summary>
+	/// <param name="indices">The indices to update in place</param>
+	/// <param name="indexCount">The number of indices</param>
+	/// <param name="vertexCount">The number of vertices</param>
+	/// <returns>The new location of each vertex</returns>
+	static std::vector<uint32_t> OptimizeVertexFetch(uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+	/// <summary>
+	/// Runs all of the optimizations on a mesh builder, logging the cache statistics before and after when Verbose is set
+	/// </summary>
+	/// <typeparam name="VertType">The type of vertex in the mesh</typeparam>
+	/// <param name="mesh">The mesh to optimize</param>
+	/// <param name="name">A name for the mesh to include in the log</param>
+	template <typename VertType>
+	static void Optimize(MeshBuilder<VertType>& mesh, const std::string& name);
+
+protected:
+	MeshOptimizer() = default;
+	~MeshOptimizer() = default;
+};
+
+template <typename VertType>
+void MeshOptimizer::Optimize(MeshBuilder<VertType>& mesh, const std::string& name) {
+	// Non indexed meshes don't use the cache
+	if (mesh._indices.empty() || mesh._vertices.empty() || mesh._indices.size() % 3 != 0) {
+		return;
+	}
+	uint32_t* indices = mesh._indices.data();
+	size_t vertexCount = mesh._vertices.size();
+	CacheStats before = Verbose ? AnalyzeVertexCache(indices, mesh._indices.size(), vertexCount) : CacheStats();
+
+	// We can only sort for overdraw if we can find the positions of the vertices
+	std::vector<glm::vec3> positions;
+	for (const BufferAttribute& attrib : VertType::V_DECL) {
+		if (attrib.Usage == AttribUsage::Position && attrib.Type == AttributeType::Float && attrib.Size == 3) {
+			positions.resize(vertexCount);
+			const uint8_t* vertices = reinterpret_cast<const uint8_t*>(mesh._vertices.data());
+			for (size_t ix = 0; ix < vertexCount; ix++) {
+				memcpy(&positions[ix], vertices + ix * sizeof(VertType) + attrib.Offset, sizeof(glm::vec3));
+			}
+			break;
+		}
+	}
+
+	// Each submesh is optimized on it's own, so that their ranges don't change
+	std::vector<Submesh> ranges = mesh._submeshes;
+	if (ranges.empty()) {
+		Submesh whole = Submesh();
+		whole.IndexCount = static_cast<uint32_t>(mesh._indices.size());
+		ranges.push_back(whole);
+	}
+	std::vector<uint32_t> clusters;
+	auto optimizeRanges = [&](uint32_t* rangeIndices, size_t indexCount, const std::vector<Submesh>& rangeList) {
+		for (const Submesh& range : rangeList) {
+			if (range.IndexCount % 3 != 0 || range.FirstIndex + (size_t)range.IndexCount > indexCount) {
+				continue;
+			}
+			OptimizeVertexCache(rangeIndices + range.FirstIndex, range.IndexCount, vertexCount, DefaultCacheSize, &clusters);
+			if (!positions.empty()) {
+				OptimizeOverdraw(rangeIndices + range.FirstIndex, range.IndexCount, positions.data(), vertexCount, clusters);
+			}
+		}
+	};
+	optimizeRanges(indices, mesh._indices.size(), ranges);
+
+	// Levels of detail get the same treatment, each of their submeshes is relative to the start of the level
+	for (const MeshLod& lod : mesh._lods) {
+		if (lod.FirstIndex + (size_t)lod.IndexCount > mesh._lodIndices.size() || lod.FirstSubmesh + (size_t)lod.SubmeshCount > mesh._lodSubmeshes.size()) {
+			continue;
+		}
+		std::vector<Submesh> lodRanges(mesh._lodSubmeshes.begin() + lod.FirstSubmesh, mesh._lodSubmeshes.begin() + lod.FirstSubmesh + lod.SubmeshCount);
+		if (lodRanges.empty()) {
+			Submesh whole = Submesh();
+			whole.IndexCount = lod.IndexCount;
+			lodRanges.push_back(whole);
+		}
+		optimizeRanges(mesh._lodIndices.data() + lod.FirstIndex, lod.IndexCount, lodRanges);
+	}
+
+	// Store the vertices in the order that they are used by the full detail mesh, the levels of detail
+	// share the vertices so they just need their indices remapped
+	std::vector<uint32_t> remap = OptimizeVertexFetch(indices, mesh._indices.size(), vertexCount);
+	std::vector<VertType> vertices(vertexCount);
+	for (size_t ix = 0; ix < vertexCount; ix++) {
+		vertices[remap[ix]] = mesh._vertices[ix];
+	}
+	mesh._vertices = std::move(vertices);
+	for (uint32_t& index : mesh._lodIndices) {
+		if (index < vertexCount) {
+			index = remap[index];
+		}
+	}
+
+	if (Verbose) {
+		CacheStats after = AnalyzeVertexCache(mesh._indices.data(), mesh._indices.size(), vertexCount);
+		LOG_INFO("Optimized mesh \"{}\" ({} triangles): ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}",
+			name, mesh._indices.size() / 3, before.ACMR, after.ACMR, before.ATVR, after.ATVR);
+	}
+}
@@ -0,0 +1,421 @@
+#include "Utils/MeshSimplifier.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+/// <summary>
+/// A symmetric 4x4 matrix that measures the area weighted squared distance of a point from a set of
+/// planes, or how far an attribute is from it's value across a set of triangles
+/// </summary>
+struct Quadric {
+	float A00 = 0.0f, A11 = 0.0f, A22 = 0.0f;
+	float A10 = 0.0f, A20 = 0.0f, A21 = 0.0f;
+	float B0 = 0.0f, B1 = 0.0f, B2 = 0.0f;
+	float C = 0.0f;
+	// The total area of the triangles that make up the quadric
+	float W = 0.0f;
+
+	void Add(const Quadric& other) {
+		A00 += other.A00; A11 += other.A11; A22 += other.A22;
+		A10 += other.A10; A20 += other.A20; A21 += other.A21;
+		B0 += other.B0; B1 += other.B1; B2 += other.B2;
+		C += other.C;
+		W += other.W;
+	}
+
+	// Adds the squared distance to the plane dot(normal, p) + d = 0, or the squared difference of an
+	// attribute that varies as dot(normal, p) + d
+	void AddPlane(const glm::vec3& normal, float d, float weight) {
+		A00 += weight * normal.x * normal.x;
+		A11 += weight * normal.y * normal.y;
+		A22 += weight * normal.z * normal.z;
+		A10 += weight * normal.y * normal.x;
+		A20 += weight * normal.z * normal.x;
+		A21 += weight * normal.z * normal.y;
+		B0 += weight * normal.x * d;
+		B1 += weight * normal.y * d;
+		B2 += weight * normal.z * d;
+		C += weight * d * d;
+	}
+
+	// Evaluates pT*A*p + 2*dot(B, p) + C
+	float Evaluate(const glm::vec3& p) const {
+		float rx = A00 * p.x + A10 * p.y + A20 * p.z + 2.0f * B0;
+		float ry = A10 * p.x + A11 * p.y + A21 * p.z + 2.0f * B1;
+		float rz = A20 * p.x + A21 * p.y + A22 * p.z + 2.0f * B2;
+		return rx * p.x + ry * p.y + rz * p.z + C;
+	}
+};
+
+/// <summary>
+/// The area weighted gradient and offset of a single attribute across a set of triangles, used along
+/// with an attribute quadric
+/// </summary>
+struct QuadricGrad {
+	glm::vec3 G = glm::vec3(0.0f);
+	float     D = 0.0f;
+
+	void Add(const QuadricGrad& other) {
+		G += other.G;
+		D += other.D;
+	}
+};
+
+// Hashes positions by their exact bits, so that vertices that were split for their attributes can be found
+struct PositionHash {
+	size_t operator()(const glm::vec3& pos) const {
+		uint32_t bits[3];
+		memcpy(bits, &pos, sizeof(bits));
+		return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+	}
+};
+
+struct PositionEqual {
+	bool operator()(const glm::vec3& a, const glm::vec3& b) const {
+		return memcmp(&a, &b, sizeof(glm::vec3)) == 0;
+	}
+};
+
+// The cosine of the furthest a triangle can turn in a single collapse
+static constexpr float MaxNormalTurn = 0.25f;
+
+// An edge that could be collapsed, moving From onto To
+struct Collapse {
+	uint32_t From;
+	uint32_t To;
+	// The cost of the collapse, including the change in attributes
+	float    Error;
+	// The squared distance that the surface moves, without the attributes
+	float    Distance;
+};
+
+size_t MeshSimplifier::Simplify(uint32_t* indices, size_t indexCount, const glm::vec3* positions, const float* attributes, const float* attributeWeights,
+	size_t attributeCount, size_t vertexCount, size_t targetIndexCount, float* error)
+{
+	if (error != nullptr) {
+		*error = 0.0f;
+	}
+	size_t count = indexCount / 3 * 3;
+	for (size_t ix = 0; ix < count; ix++) {
+		if (indices[ix] >= vertexCount) {
+			return count;
+		}
+	}
+	if (count <= targetIndexCount || vertexCount == 0) {
+		return count;
+	}
+	if (attributes == nullptr) {
+		attributeCount = 0;
+	}
+
+	// Work in a space where the mesh has a radius of 1, so the errors are relative to the mesh's size and
+	// are in a good range for floats
+	glm::vec3 min = positions[0], max = positions[0];
+	for (size_t ix = 1; ix < vertexCount; ix++) {
+		min = glm::min(min, positions[ix]);
+		max = glm::max(max, positions[ix]);
+	}
+	float radius = glm::length(max - min) * 0.5f;
+	float scale = radius > 0.0f ? 1.0f / radius : 1.0f;
+	std::vector<glm::vec3> points(vertexCount);
+	for (size_t ix = 0; ix < vertexCount; ix++) {
+		points[ix] = (positions[ix] - min) * scale;
+	}
+	std::vector<float> weighted(vertexCount * attributeCount);
+	for (size_t ix = 0; ix < weighted.size(); ix++) {
+		weighted[ix] = attributes[ix] * (attributeWeights != nullptr ? attributeWeights[ix % attributeCount] : 1.0f);
+	}
+
+	// Weld vertices that share a position, weld[v] is the first vertex with v's position, and the
+	// vertices with the same position (wedges) are linked in a loop through wedgeNext
+	std::vector<uint32_t> weld(vertexCount);
+	std::vector<uint32_t> wedgeNext(vertexCount);
+	{
+		std::unordered_map<glm::vec3, uint32_t, PositionHash, PositionEqual> firstWithPosition;
+		firstWithPosition.reserve(vertexCount);
+		for (uint32_t ix = 0; ix < vertexCount; ix++) {
+			auto it = firstWithPosition.emplace(positions[ix], ix).first;
+			weld[ix] = it->second;
+			if (it->second == ix) {
+				wedgeNext[ix] = ix;
+			} else {
+				wedgeNext[ix] = wedgeNext[it->second];
+				wedgeNext[it->second] = ix;
+			}
+		}
+	}
+
+	// Triangles that are already degenerate can't be collapsed properly, and can't be seen anyway
+	auto isDegenerate = [&](const uint32_t* tri) {
+		return weld[tri[0]] == weld[tri[1]] || weld[tri[1]] == weld[tri[2]] || weld[tri[0]] == weld[tri[2]];
+	};
+	size_t write = 0;
+	for (size_t ix = 0; ix < count; ix += 3) {
+		if (!isDegenerate(indices + ix)) {
+			memmove(indices + write, indices + ix, 3 * sizeof(uint32_t));
+			write += 3;
+		}
+	}
+	count = write;
+
+	// Build the quadrics for the position of each welded vertex, and the attributes of each vertex
+	std::vector<Quadric> positionQuadrics(vertexCount);
+	std::vector<Quadric> attributeQuadrics(attributeCount > 0 ? vertexCount : 0);
+	std::vector<QuadricGrad> gradients(vertexCount * attributeCount);
+	std::vector<QuadricGrad> triGradients(attributeCount);
+	for (size_t ix = 0; ix < count; ix += 3) {
+		const uint32_t* tri = indices + ix;
+		const glm::vec3& p0 = points[tri[0]];
+		const glm::vec3 p10 = points[tri[1]] - p0;
+		const glm::vec3 p20 = points[tri[2]] - p0;
+		glm::vec3 normal = glm::cross(p10, p20);
+		float length = glm::length(normal);
+		if (length <= 0.0f) { continue; }
+		float area = length * 0.5f;
+		normal /= length;
+
+		Quadric plane = Quadric();
+		plane.AddPlane(normal, -glm::dot(normal, p0), area);
+		plane.W = area;
+		for (int corner = 0; corner < 3; corner++) {
+			positionQuadrics[weld[tri[corner]]].Add(plane);
+		}
+
+		if (attributeCount == 0) { continue; }
+
+		// Each attribute varies linearly across the triangle as dot(gradient, p) + d, the quadric measures
+		// how far an attribute value is from that across the triangles around a vertex
+		float d00 = glm::dot(p10, p10), d01 = glm::dot(p10, p20), d11 = glm::dot(p20, p20);
+		float denominator = d00 * d11 - d01 * d01;
+		if (denominator == 0.0f) { continue; }
+		const glm::vec3 g1 = (d11 * p10 - d01 * p20) / denominator;
+		const glm::vec3 g2 = (d00 * p20 - d01 * p10) / denominator;
+
+		Quadric attributeQuadric = Quadric();
+		attributeQuadric.W = area;
+		for (size_t attrib = 0; attrib < attributeCount; attrib++) {
+			float a0 = weighted[tri[0] * attributeCount + attrib];
+			float a1 = weighted[tri[1] * attributeCount + attrib];
+			float a2 = weighted[tri[2] * attributeCount + attrib];
+			glm::vec3 gradient = g1 * (a1 - a0) + g2 * (a2 - a0);
+			float d = a0 - glm::dot(gradient, p0);
+			attributeQuadric.AddPlane(gradient, d, area);
+			triGradients[attrib].G = gradient * area;
+			triGradients[attrib].D = d * area;
+		}
+		for (int corner = 0; corner < 3; corner++) {
+			attributeQuadrics[tri[corner]].Add(attributeQuadric);
+			for (size_t attrib = 0; attrib < attributeCount; attrib++) {
+				gradients[tri[corner] * attributeCount + attrib].Add(triGradients[attrib]);
+			}
+		}
+	}
+
+	// The error of moving a vertex to a position, and giving it the attributes of another vertex
+	auto attributeError = [&](uint32_t vertex, const glm::vec3& p, uint32_t target) {
+		const Quadric& q = attributeQuadrics[vertex];
+		if (q.W <= 0.0f) { return 0.0f; }
+		float result = q.Evaluate(p);
+		for (size_t attrib = 0; attrib < attributeCount; attrib++) {
+			const QuadricGrad& grad = gradients[vertex * attributeCount + attrib];
+			float a = weighted[target * attributeCount + attrib];
+			result += a * a * q.W - 2.0f * a * (glm::dot(grad.G, p) + grad.D);
+		}
+		return glm::abs(result) / q.W;
+	};
+
+	std::vector<uint32_t> adjacencyStart(vertexCount + 1);
+	std::vector<uint32_t> adjacency;
+	std::vector<bool> used(vertexCount);
+	std::vector<bool> locked(vertexCount);
+	std::vector<bool> touched(vertexCount);
+	std::vector<uint32_t> remap(vertexCount);
+	std::vector<Collapse> candidates;
+	std::vector<std::pair<uint32_t, uint32_t>> wedgePairs;
+	std::vector<uint32_t> nexts, prevs;
+	float maxError = 0.0f;
+
+	// Finds the vertex that each of from's wedges moves to when from collapses onto to. This fails if
+	// a wedge does not share an edge with exactly one of to's wedges, which stops seams from moving
+	// off of themselves
+	auto matchWedges = [&](uint32_t from, uint32_t to) {
+		wedgePairs.clear();
+		for (uint32_t adj = adjacencyStart[from]; adj < adjacencyStart[from + 1]; adj++) {
+			const uint32_t* tri = indices + adjacency[adj] * 3;
+			uint32_t i = vertexCount, j = vertexCount;
+			for (int corner = 0; corner < 3; corner++) {
+				if (weld[tri[corner]] == from) { i = tri[corner]; }
+				if (weld[tri[corner]] == to) { j = tri[corner]; }
+			}
+			if (j == vertexCount) { continue; }
+			auto it = std::find_if(wedgePairs.begin(), wedgePairs.end(), [&](const auto& pair) { return pair.first == i; });
+			if (it == wedgePairs.end()) {
+				wedgePairs.push_back({ i, j });
+			} else if (it->second != j) {
+				return false;
+			}
+		}
+		uint32_t wedge = from;
+		do {
+			if (used[wedge] && std::find_if(wedgePairs.begin(), wedgePairs.end(), [&](const auto& pair) { return pair.first == wedge; }) == wedgePairs.end()) {
+				return false;
+			}
+			wedge = wedgeNext[wedge];
+		} while (wedge != from);
+		return !wedgePairs.empty();
+	};
+
+	// Checks if moving from onto to would flip any of the triangles that stay around from
+	auto hasFlips = [&](uint32_t from, uint32_t to) {
+		for (uint32_t adj = adjacencyStart[from]; adj < adjacencyStart[from + 1]; adj++) {
+			const uint32_t* tri = indices + adjacency[adj] * 3;
+			glm::vec3 before[3], after[3];
+			bool hasTo = false;
+			for (int corner = 0; corner < 3; corner++) {
+				uint32_t welded = weld[tri[corner]];
+				hasTo |= welded == to;
+				before[corner] = points[welded];
+				after[corner] = welded == from ? points[to] : before[corner];
+			}
+			if (hasTo) { continue; }
+			// Also reject triangles that would turn too far or become slivers, small turns can add up to a flip
+			// over several passes
+			glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+			glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+			float lengthAfter = glm::length(normalAfter);
+			float longestEdge = glm::max(glm::dot(after[1] - after[0], after[1] - after[0]), glm::max(glm::dot(after[2] - after[1], after[2] - after[1]), glm::dot(after[0] - after[2], after[0] - after[2])));
+			if (glm::dot(normalBefore, normalAfter) <= MaxNormalTurn * glm::length(normalBefore) * lengthAfter || lengthAfter <= 1e-4f * longestEdge) {
+				return true;
+			}
+		}
+		return false;
+	};
+
+	// Each pass finds the cheapest collapses that don't touch each other and applies them, until we
+	// reach the target or run out of edges that can be collapsed
+	while (count > targetIndexCount) {
+		const size_t triCount = count / 3;
+
+		// Find the triangles around each welded vertex
+		std::fill(adjacencyStart.begin(), adjacencyStart.end(), 0);
+		std::fill(used.begin(), used.end(), false);
+		for (size_t ix = 0; ix < count; ix++) {
+			adjacencyStart[weld[indices[ix]] + 1]++;
+			used[indices[ix]] = true;
+		}
+		for (size_t ix = 0; ix < vertexCount; ix++) {
+			adjacencyStart[ix + 1] += adjacencyStart[ix];
+		}
+		adjacency.resize(count);
+		{
+			std::vector<uint32_t> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+			for (size_t ix = 0; ix < count; ix++) {
+				adjacency[fill[weld[indices[ix]]]++] = static_cast<uint32_t>(ix / 3);
+			}
+		}
+
+		// Lock vertices on a border, where an edge only has a triangle on one side, and vertices where the
+		// mesh is not manifold, where an edge is shared by more than two triangles
+		for (uint32_t vertex = 0; vertex < vertexCount; vertex++) {
+			locked[vertex] = false;
+			touched[vertex] = false;
+			remap[vertex] = vertex;
+			if (weld[vertex] != vertex || adjacencyStart[vertex] == adjacencyStart[vertex + 1]) { continue; }
+			nexts.clear();
+			prevs.clear();
+			for (uint32_t adj = adjacencyStart[vertex]; adj < adjacencyStart[vertex + 1]; adj++) {
+				const uint32_t* tri = indices + adjacency[adj] * 3;
+				int corner = weld[tri[0]] == vertex ? 0 : (weld[tri[1]] == vertex ? 1 : 2);
+				nexts.push_back(weld[tri[(corner + 1) % 3]]);
+				prevs.push_back(weld[tri[(corner + 2) % 3]]);
+			}
+			std::sort(nexts.begin(), nexts.end());
+			std::sort(prevs.begin(), prevs.end());
+			locked[vertex] = nexts != prevs || std::adjacent_find(nexts.begin(), nexts.end()) != nexts.end();
+		}
+
+		// Find the cheapest direction to collapse each edge. Edges inside the mesh are used by two triangles in
+		// opposite directions, so we only look at them from one side
+		candidates.clear();
+		for (size_t tri = 0; tri < triCount; tri++) {
+			for (int corner = 0; corner < 3; corner++) {
+				uint32_t a = weld[indices[tri * 3 + corner]];
+				uint32_t b = weld[indices[tri * 3 + (corner + 1) % 3]];
+				if (a > b) { continue; }
+
+				Collapse best = { 0, 0, -1.0f, 0.0f };
+				for (int direction = 0; direction < 2; direction++) {
+					uint32_t from = direction == 0 ? a : b;
+					uint32_t to = direction == 0 ? b : a;
+					if (locked[from] || !matchWedges(from, to)) { continue; }
+					const Quadric& q = positionQuadrics[from];
+					float distance = q.W > 0.0f ? glm::abs(q.Evaluate(points[to])) / q.W : 0.0f;
+					float cost = distance;
+					for (const auto& pair : wedgePairs) {
+						cost += attributeCount > 0 ? attributeError(pair.first, points[to], pair.second) : 0.0f;
+					}
+					if (best.Error < 0.0f || cost < best.Error) {
+						best = { from, to, cost, distance };
+					}
+				}
+				if (best.Error >= 0.0f) {
+					candidates.push_back(best);
+				}
+			}
+		}
+		std::sort(candidates.begin(), candidates.end(), [](const Collapse& a, const Collapse& b) {
+			return a.Error < b.Error;
+		});
+
+		// Collapse the cheapest edges first. Collapses that touch the same triangles can't be checked for flips
+		// on their own, so we only do one collapse around each vertex per pass
+		const size_t trianglesToRemove = (count - targetIndexCount + 2) / 3;
+		size_t removed = 0;
+		for (const Collapse& collapse : candidates) {
+			if (removed >= trianglesToRemove) { break; }
+			if (touched[collapse.From] || touched[collapse.To]) { continue; }
+			if (hasFlips(collapse.From, collapse.To) || !matchWedges(collapse.From, collapse.To)) { continue; }
+
+			for (const auto& pair : wedgePairs) {
+				remap[pair.first] = pair.second;
+				if (attributeCount > 0) {
+					attributeQuadrics[pair.second].Add(attributeQuadrics[pair.first]);
+					for (size_t attrib = 0; attrib < attributeCount; attrib++) {
+						gradients[pair.second * attributeCount + attrib].Add(gradients[pair.first * attributeCount + attrib]);
+					}
+				}
+			}
+			positionQuadrics[collapse.To].Add(positionQuadrics[collapse.From]);
+
+			for (uint32_t adj = adjacencyStart[collapse.From]; adj < adjacencyStart[collapse.From + 1]; adj++) {
+				const uint32_t* tri = indices + adjacency[adj] * 3;
+				bool hasTo = false;
+				for (int corner = 0; corner < 3; corner++) {
+					touched[weld[tri[corner]]] = true;
+					hasTo |= weld[tri[corner]] == collapse.To;
+				}
+				removed += hasTo ? 1 : 0;
+			}
+			maxError = glm::max(maxError, collapse.Distance);
+		}
+		if (removed == 0) {
+			break;
+		}
+
+		// Move the collapsed vertices and remove the triangles that collapsed with them
+		write = 0;
+		for (size_t ix = 0; ix < count; ix += 3) {
+			uint32_t tri[3] = { remap[indices[ix]], remap[indices[ix + 1]], remap[indices[ix + 2]] };
+			if (!isDegenerate(tri)) {
+				memcpy(indices + write, tri, sizeof(tri));
+				write += 3;
+			}
+		}
+		count = write;
+	}
+
+	if (error != nullptr) {
+		*error = glm::sqrt(maxError);
+	}
+	return count;
+}
@@ -0,0 +1,176 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <GLM/glm.hpp>
+#include <Logging.h>
+
+#include "MeshBuilder.h"
+
+/// <summary>
+/// Generates simplified levels of detail for meshes, using quadric error metrics (Garland and Heckbert 1997)
+///
+/// Edges are collapsed into one of their existing vertices, so every level of detail can share the vertex
+/// buffer of the full detail mesh and only needs it's own indices. The error of a collapse includes how
+/// much it changes the surface's normals, UVs and colours (Hoppe 1999), and vertices that are split for
+/// their attributes (UV seams, hard edges) only collapse along the seam, so the seams stay intact
+///
+/// Vertices on the border of a mesh or submesh, and vertices where the mesh is not manifold, are locked,
+/// so holes don't open up and submeshes with different materials still meet after simplification
+/// </summary>
+class MeshSimplifier {
+public:
+	/// <summary>
+	/// The most levels of detail that GenerateLods will create, not including the full detail mesh
+	/// </summary>
+	static constexpr size_t DefaultMaxLods = 4;
+	/// <summary>
+	/// Each level of detail aims to have this fraction of the triangles of the one before it
+	/// </summary>
+	static constexpr float DefaultLodRatio = 0.5f;
+	/// <summary>
+	/// Meshes with fewer triangles than this are not worth simplifying any further
+	/// </summary>
+	static constexpr size_t MinLodTriangles = 32;
+
+	/// <summary>
+	/// Simplifies a triangle list by collapsing edges, until it has the target number of indices or
+	/// there are no more edges that can be collapsed
+	/// </summary>
+	/// <param name="indices">The triangle list indices to simplify in place</param>
+	/// <param name="indexCount">The number of indices, must be a multiple of 3</param>
+	/// <param name="positions">The position of each vertex</param>
+	/// <param name="attributes">attributeCount values for each vertex to keep intact (ex: normals and UVs), or nullptr</param>
+	/// <param name="attributeWeights">How important each attribute is compared to the position, or nullptr</param>
+	/// <param name="attributeCount">The number of attributes for each vertex</param>
+	/// <param name="vertexCount">The number of vertices</param>
+	/// <param name="targetIndexCount">The number of indices to aim for</param>
+	/// <param name="error">If not null, receives how far the simplified surface is from the original, relative to the bounding radius of the positions. This only measures the positions, the attributes just decide which edges are collapsed first</param>
+	/// <returns>The number of indices in the simplified triangle list, which are at the start of indices</returns>
+	static size_t Simplify(uint32_t* indices, size_t indexCount, const glm::vec3* positions, const float* attributes, const float* attributeWeights,
+		size_t attributeCount, size_t vertexCount, size_t targetIndexCount, float* error = nullptr);
+
+	/// <summary>
+	/// Generates a chain of levels of detail for a mesh builder, each simplified from the one before it,
+	/// and logs the triangle count and error of each one. Submeshes are simplified on their own, so each
+	/// level of detail has the same submeshes as the full detail mesh
+	/// </summary>
+	/// <typeparam name="VertType">The type of vertex in the mesh</typeparam>
+	/// <param name="mesh">The mesh to generate levels of detail for</param>
+	/// <param name="name">A name for the mesh to include in the log</param>
+	/// <param name="maxLods">The most levels of detail to generate</param>
+	/// <param name="ratio">The fraction of the triangles to keep in each level of detail</param>
+	template <typename VertType>
+	static void GenerateLods(MeshBuilder<VertType>& mesh, const std::string& name, size_t maxLods = DefaultMaxLods, float ratio = DefaultLodRatio);
+
+protected:
+	MeshSimplifier() = default;
+	~MeshSimplifier() = default;
+};
+
+template <typename VertType>
+void MeshSimplifier::GenerateLods(MeshBuilder<VertType>& mesh, const std::string& name, size_t maxLods, float ratio) {
+	const std::vector<uint32_t>& indices = mesh._indices;
+	if (indices.size() / 3 < MinLodTriangles * 2 || indices.size() % 3 != 0 || mesh.GetVertexCount() == 0) {
+		return;
+	}
+
+	// Pull the positions and the attributes we want to preserve out of the vertices. Normals are
+	// unit length and UVs tend to stay within 0-1, so they are weighted so that small differences
+	// don't stop the mesh from being simplified
+	const size_t vertexCount = mesh.GetVertexCount();
+	const uint8_t* vertices = reinterpret_cast<const uint8_t*>(mesh.GetVertexDataPtr());
+	std::vector<glm::vec3> positions;
+	std::vector<float> weights;
+	std::vector<const BufferAttribute*> sources;
+	for (const BufferAttribute& attrib : VertType::V_DECL) {
+		if (attrib.Type != AttributeType::Float) { continue; }
+		if (attrib.Usage == AttribUsage::Position && attrib.Size == 3) {
+			positions.resize(vertexCount);
+			for (size_t ix = 0; ix < vertexCount; ix++) {
+				memcpy(&positions[ix], vertices + ix * sizeof(VertType) + attrib.Offset, sizeof(glm::vec3));
+			}
+		} else if (attrib.Usage == AttribUsage::Normal && attrib.Size == 3) {
+			sources.push_back(&attrib);
+			weights.insert(weights.end(), 3, 0.5f);
+		} else if (attrib.Usage == AttribUsage::Texture && attrib.Size == 2) {
+			sources.push_back(&attrib);
+			weights.insert(weights.end(), 2, 1.0f);
+		} else if (attrib.Usage == AttribUsage::Color && attrib.Size >= 3) {
+			sources.push_back(&attrib);
+			weights.insert(weights.end(), 3, 0.5f);
+		}
+	}
+	if (positions.empty()) {
+		return;
+	}
+	const size_t attributeCount = weights.size();
+	std::vector<float> attributes(vertexCount * attributeCount);
+	for (size_t ix = 0; ix < vertexCount; ix++) {
+		float* target = attributes.data() + ix * attributeCount;
+		for (const BufferAttribute* attrib : sources) {
+			// Colours only use their RGB, so we only copy the first 3 components
+			size_t components = attrib->Usage == AttribUsage::Color ? 3 : attrib->Size;
+			memcpy(target, vertices + ix * sizeof(VertType) + attrib->Offset, components * sizeof(float));
+			target += components;
+		}
+	}
+
+	// Each submesh is simplified on it's own, so the levels of detail have the same submeshes
+	std::vector<Submesh> ranges = mesh._submeshes;
+	if (ranges.empty()) {
+		Submesh whole = Submesh();
+		whole.IndexCount = static_cast<uint32_t>(indices.size());
+		ranges.push_back(whole);
+	}
+	for (const Submesh& range : ranges) {
+		if (range.IndexCount % 3 != 0 || range.FirstIndex + (size_t)range.IndexCount > indices.size()) {
+			LOG_WARN("Mesh \"{}\" has a submesh outside of it's indices, skipping levels of detail", name);
+			return;
+		}
+	}
+	std::vector<std::vector<uint32_t>> current(ranges.size());
+	for (size_t ix = 0; ix < ranges.size(); ix++) {
+		current[ix].assign(indices.begin() + ranges[ix].FirstIndex, indices.begin() + ranges[ix].FirstIndex + ranges[ix].IndexCount);
+	}
+
+	size_t previousCount = indices.size();
+	float totalError = 0.0f;
+	for (size_t level = 0; level < maxLods; level++) {
+		// Simplify from the previous level, so each level only has to remove what the last one kept
+		float levelError = 0.0f;
+		size_t levelCount = 0;
+		for (size_t ix = 0; ix < ranges.size(); ix++) {
+			std::vector<uint32_t>& range = current[ix];
+			size_t target = static_cast<size_t>(range.size() / 3 * ratio) * 3;
+			float rangeError = 0.0f;
+			range.resize(Simplify(range.data(), range.size(), positions.data(), attributes.data(), weights.data(), attributeCount, vertexCount, target, &rangeError));
+			levelError = glm::max(levelError, rangeError);
+			levelCount += range.size();
+		}
+
+		// Stop once the mesh can't be simplified much further, the level wouldn't be worth drawing
+		if (levelCount == 0 || levelCount > previousCount * 0.85f || levelCount / 3 < MinLodTriangles) {
+			break;
+		}
+		// Each level is simplified from the last, so it's error can be at most the sum of the errors along the way
+		totalError += levelError;
+		previousCount = levelCount;
+
+		std::vector<uint32_t> lodIndices;
+		std::vector<Submesh> lodSubmeshes;
+		lodIndices.reserve(levelCount);
+		for (size_t ix = 0; ix < ranges.size(); ix++) {
+			if (!mesh._submeshes.empty()) {
+				Submesh submesh = ranges[ix];
+				submesh.FirstIndex = static_cast<uint32_t>(lodIndices.size());
+				submesh.IndexCount = static_cast<uint32_t>(current[ix].size());
+				lodSubmeshes.push_back(submesh);
+			}
+			lodIndices.insert(lodIndices.end(), current[ix].begin(), current[ix].end());
+		}
+		mesh.AddLod(lodIndices, lodSubmeshes, totalError);
+		LOG_INFO("Generated LOD {} for mesh \"{}\": {} -> {} triangles, error {:.4f}", mesh._lods.size(), name, indices.size() / 3, levelCount / 3, totalError);
+	}
+}
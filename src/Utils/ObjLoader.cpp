@@ -0,0 +1,600 @@
+#include "Utils/ObjLoader.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+
+#include "Application/JobSystem.h"
+#include "Utils/MappedFile.h"
+
+// Files smaller than this are parsed on the calling thread, since splitting them isn't worth the overhead
+static constexpr size_t MinParallelBytes = 1024 * 1024;
+// The smallest chunk of a file that we will hand to a single job
+static constexpr size_t MinChunkBytes = 256 * 1024;
+// Vertices are deduplicated in this many independent shards, picked by the top bits of their hash
+static constexpr uint32_t ShardBits = 6;
+static constexpr uint32_t NumShards = 1 << ShardBits;
+
+/// <summary>
+/// An open addressing hash map from vertex attribute indices to the ID of the first vertex that used
+/// them. Keys are stored in the slots so probing stays in cache, and are full 32 bit indices
+/// </summary>
+class VertexDedupTable {
+public:
+	VertexDedupTable() :
+		_slots(std::vector<Slot>(1024)),
+		_count(0)
+	{ }
+
+	/// <summary>
+	/// Finds the ID that was added with the given key, adding id if the key is new
+	/// </summary>
+	/// <param name="key">The position, UV and normal indices of the vertex</param>
+	/// <param name="id">The ID to store if the key hasn't been seen before</param>
+	/// <returns>The ID of the first matching key, which will be id if the key is new</returns>
+	uint32_t FindOrAdd(const glm::ivec3& key, uint32_t id) {
+		// Keep the table at most half full, so probe sequences stay short
+		if ((_count + 1) * 2 > _slots.size()) {
+			_Grow();
+		}
+
+		size_t mask = _slots.size() - 1;
+		for (size_t slot = Hash(key) & mask; ; slot = (slot + 1) & mask) {
+			Slot& entry = _slots[slot];
+			if (entry.Id == EmptySlot) {
+				entry.Key = key;
+				entry.Id = id;
+				_count++;
+				return id;
+			}
+			if (entry.Key == key) {
+				return entry.Id;
+			}
+		}
+	}
+
+	static uint32_t Hash(const glm::ivec3& key) {
+		uint64_t hash = static_cast<uint32_t>(key.x) * 0x9E3779B97F4A7C15ull;
+		hash ^= static_cast<uint32_t>(key.y) * 0xC2B2AE3D27D4EB4Full;
+		hash ^= static_cast<uint32_t>(key.z) * 0x165667B19E3779F9ull;
+		return static_cast<uint32_t>(hash ^ (hash >> 32));
+	}
+
+private:
+	static constexpr uint32_t EmptySlot = 0xFFFFFFFF;
+
+	struct Slot {
+		glm::ivec3 Key = glm::ivec3(0);
+		uint32_t   Id = EmptySlot;
+	};
+
+	std::vector<Slot> _slots;
+	size_t            _count;
+
+	void _Grow() {
+		std::vector<Slot> slots(_slots.size() * 2);
+		size_t mask = slots.size() - 1;
+		for (const Slot& entry : _slots) {
+			if (entry.Id != EmptySlot) {
+				size_t slot = Hash(entry.Key) & mask;
+				while (slots[slot].Id != EmptySlot) {
+					slot = (slot + 1) & mask;
+				}
+				slots[slot] = entry;
+			}
+		}
+		_slots = std::move(slots);
+	}
+};
+
+/// <summary>
+/// A face corner as it appears in a chunk of the file. Negative OBJ indices are relative to the
+/// attributes defined so far, so until we know how many attributes came before the chunk, they
+/// are stored relative to the start of the chunk
+/// </summary>
+struct ChunkCorner {
+	// 0 based position, UV and normal indices
+	glm::ivec3 Index;
+	// Bit n is set if attribute n is present, bit n + 3 if attribute n is relative to the chunk
+	uint8_t    Flags;
+};
+
+/// <summary>
+/// A range of lines from an OBJ file, and everything parsed from them
+/// </summary>
+struct ObjChunk {
+	const char* Begin;
+	const char* End;
+
+	std::vector<glm::vec3>   Positions;
+	std::vector<glm::vec2>   UVs;
+	std::vector<glm::vec3>   Normals;
+	std::vector<ChunkCorner> Corners;
+	// The number of corners in each face
+	std::vector<uint32_t>    FaceSizes;
+
+	// The number of positions, UVs and normals defined before this chunk
+	glm::ivec3 AttributeBase = glm::ivec3(0);
+	// Where this chunk's corners, unique vertices and indices start in the whole file
+	size_t CornerBase = 0;
+	size_t NumCorners = 0;
+	size_t VertexBase = 0;
+	size_t IndexBase = 0;
+	size_t NumIndices = 0;
+	size_t NumNewVertices = 0;
+	// The global indices of this chunk's corners that belong to each dedup shard, in file order
+	std::vector<uint32_t> ShardCorners[NumShards];
+	// The usemtl commands in this chunk, with the number of indices in the chunk before each one
+	std::vector<std::pair<size_t, std::string>> MaterialChanges;
+	// The first error that this chunk ran into, errors are reported in file order
+	std::string Error;
+};
+
+inline bool IsSpace(char c) {
+	return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+inline const char* SkipSpace(const char* it, const char* end) {
+	while (it < end && IsSpace(*it)) { it++; }
+	return it;
+}
+
+/// <summary>
+/// Parses a float from the line, leaving value as is if there isn't one
+/// </summary>
+inline const char* ParseFloat(const char* it, const char* end, float& value) {
+	it = SkipSpace(it, end);
+	// from_chars doesn't accept a leading plus
+	if (it < end && *it == '+') { it++; }
+	std::from_chars_result result = std::from_chars(it, end, value);
+	return result.ec == std::errc() ? result.ptr : it;
+}
+
+/// <summary>
+/// Parses a single attribute index from a face into a corner, leaving the attribute missing if there isn't one
+/// </summary>
+inline const char* ParseIndex(const char* it, const char* end, size_t localCount, int attribute, ChunkCorner& corner) {
+	int value = 0;
+	std::from_chars_result result = std::from_chars(it, end, value);
+	if (result.ec != std::errc()) {
+		return it;
+	}
+	if (value == 0) {
+		throw std::runtime_error("OBJ face refers to an attribute that does not exist");
+	}
+
+	// The OBJ format can have negative values, which are a reference from the last added attributes
+	if (value < 0) {
+		corner.Index[attribute] = static_cast<int>(localCount) + value;
+		corner.Flags |= (1 << attribute) | (1 << (attribute + 3));
+	} else {
+		corner.Index[attribute] = value - 1;
+		corner.Flags |= 1 << attribute;
+	}
+	return result.ptr;
+}
+
+/// <summary>
+/// Parses all of the lines in a chunk of an OBJ file. Attributes are stored in the chunk, and faces
+/// are passed to onFace as an array of corners, so the caller decides how to store them
+/// </summary>
+template <typename FaceFunc>
+static void ParseChunk(ObjChunk& chunk, FaceFunc&& onFace) {
+	std::vector<ChunkCorner> face;
+	const char* end = chunk.End;
+	const char* lineStart = chunk.Begin;
+	while (lineStart < end) {
+		// Find the end of the line, we never look past it
+		const char* lineEnd = static_cast<const char*>(memchr(lineStart, '\n', end - lineStart));
+		if (lineEnd == nullptr) { lineEnd = end; }
+
+		const char* it = SkipSpace(lineStart, lineEnd);
+		lineStart = lineEnd + 1;
+
+		// Read in the first part of the line (ex: f, v, vn, etc...), anything we don't know is ignored
+		const char* command = it;
+		while (it < lineEnd && !IsSpace(*it)) { it++; }
+		size_t commandLength = it - command;
+		if (commandLength == 0) { continue; }
+
+		// The usemtl command sets the material for the faces that follow it
+		if (commandLength == 6 && memcmp(command, "usemtl", 6) == 0) {
+			const char* nameStart = SkipSpace(it, lineEnd);
+			const char* nameEnd = lineEnd;
+			while (nameEnd > nameStart && IsSpace(nameEnd[-1])) { nameEnd--; }
+			chunk.MaterialChanges.emplace_back(chunk.NumIndices, std::string(nameStart, nameEnd));
+			continue;
+		}
+		if (commandLength > 2) { continue; }
+
+		// The v command defines a vertex's position
+		if (commandLength == 1 && command[0] == 'v') {
+			glm::vec3 position = glm::vec3(0.0f);
+			it = ParseFloat(it, lineEnd, position.x);
+			it = ParseFloat(it, lineEnd, position.y);
+			ParseFloat(it, lineEnd, position.z);
+			chunk.Positions.push_back(position);
+		}
+		else if (commandLength == 2 && command[0] == 'v' && command[1] == 't') {
+			glm::vec2 uv = glm::vec2(0.0f);
+			it = ParseFloat(it, lineEnd, uv.x);
+			ParseFloat(it, lineEnd, uv.y);
+			chunk.UVs.push_back(uv);
+		}
+		else if (commandLength == 2 && command[0] == 'v' && command[1] == 'n') {
+			glm::vec3 normal = glm::vec3(0.0f);
+			it = ParseFloat(it, lineEnd, normal.x);
+			it = ParseFloat(it, lineEnd, normal.y);
+			ParseFloat(it, lineEnd, normal.z);
+			chunk.Normals.push_back(normal);
+		}
+		// The f command defines a polygon in the mesh, made of position/uv/normal triples where
+		// the uv and normal are optional (ex: 1, 1/2, 1//3 or 1/2/3)
+		else if (commandLength == 1 && command[0] == 'f') {
+			face.clear();
+			while ((it = SkipSpace(it, lineEnd)) < lineEnd) {
+				ChunkCorner corner = { glm::ivec3(-1), 0 };
+				it = ParseIndex(it, lineEnd, chunk.Positions.size(), 0, corner);
+				if ((corner.Flags & 1) == 0) {
+					throw std::runtime_error("OBJ face is missing a position");
+				}
+				if (it < lineEnd && *it == '/') {
+					it++;
+					if (it < lineEnd && *it != '/') {
+						it = ParseIndex(it, lineEnd, chunk.UVs.size(), 1, corner);
+					}
+					if (it < lineEnd && *it == '/') {
+						it = ParseIndex(it + 1, lineEnd, chunk.Normals.size(), 2, corner);
+					}
+				}
+				// Skip anything else in the token that we don't understand
+				while (it < lineEnd && !IsSpace(*it)) { it++; }
+
+				face.push_back(corner);
+			}
+			onFace(face.data(), static_cast<uint32_t>(face.size()));
+			// Polygons are split into a triangle fan
+			chunk.NumIndices += face.size() > 2 ? (face.size() - 2) * 3 : 0;
+		}
+	}
+}
+
+/// <summary>
+/// Splits a file into roughly equal chunks, that always start at the beginning of a line
+/// </summary>
+static std::vector<ObjChunk> SplitChunks(const char* data, size_t size, size_t numChunks) {
+	std::vector<ObjChunk> result(numChunks);
+	const char* end = data + size;
+	const char* begin = data;
+	for (size_t ix = 0; ix < numChunks; ix++) {
+		const char* chunkEnd = end;
+		if (ix + 1 < numChunks) {
+			chunkEnd = std::max(begin, data + size / numChunks * (ix + 1));
+			const char* newline = static_cast<const char*>(memchr(chunkEnd, '\n', end - chunkEnd));
+			chunkEnd = newline != nullptr ? newline + 1 : end;
+		}
+		result[ix].Begin = begin;
+		result[ix].End = chunkEnd;
+		begin = chunkEnd;
+	}
+	return result;
+}
+
+/// <summary>
+/// Assigns material slots from the usemtl commands in the file, and reorders the triangles so each
+/// material is one contiguous range of indices. Triangles keep their file order within a material
+/// </summary>
+/// <param name="result">The parsed mesh, with indices in file order</param>
+/// <param name="changes">Every usemtl command in file order, with the number of indices before it</param>
+static void BuildSubmeshes(ObjMeshData& result, const std::vector<std::pair<size_t, std::string>>& changes) {
+	// Split the indices into runs that use the same material, merging neighbours with the same slot
+	std::unordered_map<std::string, uint32_t> slotLookup;
+	std::vector<Submesh> runs;
+	auto addRun = [&](size_t begin, size_t end, const std::string& material) {
+		if (end <= begin) { return; }
+		auto it = slotLookup.find(material);
+		if (it == slotLookup.end()) {
+			it = slotLookup.emplace(material, static_cast<uint32_t>(result.MaterialSlots.size())).first;
+			result.MaterialSlots.push_back(material);
+		}
+		if (!runs.empty() && runs.back().MaterialSlot == it->second) {
+			runs.back().IndexCount += static_cast<uint32_t>(end - begin);
+		} else {
+			Submesh run = Submesh();
+			run.FirstIndex = static_cast<uint32_t>(begin);
+			run.IndexCount = static_cast<uint32_t>(end - begin);
+			run.MaterialSlot = it->second;
+			runs.push_back(run);
+		}
+	};
+
+	size_t runStart = 0;
+	std::string material = "";
+	for (const auto& change : changes) {
+		addRun(runStart, change.first, material);
+		runStart = change.first;
+		material = change.second;
+	}
+	addRun(runStart, result.Indices.size(), material);
+
+	// A single material doesn't need a submesh table, the whole mesh is drawn at once
+	if (result.MaterialSlots.size() < 2) {
+		return;
+	}
+
+	// Slots are numbered in the order they're first used, so if there's one run per slot they are already in order
+	if (runs.size() == result.MaterialSlots.size()) {
+		result.Submeshes = std::move(runs);
+		return;
+	}
+
+	// Otherwise gather the runs for each slot together, so every material only needs one draw
+	result.Submeshes.resize(result.MaterialSlots.size());
+	for (const Submesh& run : runs) {
+		result.Submeshes[run.MaterialSlot].IndexCount += run.IndexCount;
+	}
+	uint32_t firstIndex = 0;
+	for (uint32_t slot = 0; slot < result.Submeshes.size(); slot++) {
+		result.Submeshes[slot].FirstIndex = firstIndex;
+		result.Submeshes[slot].MaterialSlot = slot;
+		firstIndex += result.Submeshes[slot].IndexCount;
+	}
+
+	std::vector<uint32_t> indices(result.Indices.size());
+	std::vector<uint32_t> writePos(result.Submeshes.size());
+	for (uint32_t slot = 0; slot < result.Submeshes.size(); slot++) {
+		writePos[slot] = result.Submeshes[slot].FirstIndex;
+	}
+	for (const Submesh& run : runs) {
+		std::copy_n(result.Indices.begin() + run.FirstIndex, run.IndexCount, indices.begin() + writePos[run.MaterialSlot]);
+		writePos[run.MaterialSlot] += run.IndexCount;
+	}
+	result.Indices = std::move(indices);
+}
+
+/// <summary>
+/// Parses a whole OBJ file in a single pass, deduplicating vertices as faces are read. Gives the same
+/// result as the chunked path, which does the same work in stages so it can be spread across threads
+/// </summary>
+static ObjMeshData ParseSerial(const char* data, size_t size) {
+	ObjMeshData result;
+	ObjChunk chunk;
+	chunk.Begin = data;
+	chunk.End = data + size;
+
+	VertexDedupTable table = VertexDedupTable();
+	std::vector<uint32_t> face;
+	// Faces may refer to attributes defined later in the file, so the upper bound is checked at the end
+	glm::ivec3 maxIndex = glm::ivec3(-1);
+	ParseChunk(chunk, [&](const ChunkCorner* corners, uint32_t count) {
+		face.clear();
+		for (uint32_t ix = 0; ix < count; ix++) {
+			// With a single chunk, relative indices are already resolved
+			glm::ivec3 key = glm::ivec3(-1);
+			for (int attribute = 0; attribute < 3; attribute++) {
+				if (corners[ix].Flags & (1 << attribute)) {
+					if (corners[ix].Index[attribute] < 0) {
+						throw std::runtime_error("OBJ face refers to an attribute that does not exist");
+					}
+					key[attribute] = corners[ix].Index[attribute];
+					maxIndex[attribute] = std::max(maxIndex[attribute], key[attribute]);
+				}
+			}
+
+			uint32_t next = static_cast<uint32_t>(result.Vertices.size());
+			uint32_t vertex = table.FindOrAdd(key, next);
+			if (vertex == next) {
+				if (next == 0xFFFFFFFF) {
+					throw std::runtime_error("OBJ file has too many face corners");
+				}
+				result.Vertices.push_back(key);
+			}
+			face.push_back(vertex);
+		}
+		// Polygons are split into a triangle fan
+		for (uint32_t ix = 2; ix < count; ix++) {
+			result.Indices.push_back(face[0]);
+			result.Indices.push_back(face[ix - 1]);
+			result.Indices.push_back(face[ix]);
+		}
+	});
+
+	if (static_cast<size_t>(maxIndex.x + 1) > chunk.Positions.size() ||
+		static_cast<size_t>(maxIndex.y + 1) > chunk.UVs.size() ||
+		static_cast<size_t>(maxIndex.z + 1) > chunk.Normals.size()) {
+		throw std::runtime_error("OBJ face refers to an attribute that does not exist");
+	}
+
+	result.Positions = std::move(chunk.Positions);
+	result.UVs = std::move(chunk.UVs);
+	result.Normals = std::move(chunk.Normals);
+	BuildSubmeshes(result, chunk.MaterialChanges);
+	return result;
+}
+
+ObjMeshData ObjLoader::Parse(const char* data, size_t size, JobSystem* jobs) {
+	// Work out how many pieces to split the file into, small files are handled in one go
+	size_t numChunks = 1;
+	if (jobs != nullptr && jobs->NumThreads() > 1 && size >= MinParallelBytes) {
+		numChunks = std::max<size_t>(1, std::min<size_t>(static_cast<size_t>(jobs->NumThreads()) * 4, size / MinChunkBytes));
+	}
+
+	// Small files, or having no worker threads, get a single pass over the file
+	if (numChunks == 1) {
+		return ParseSerial(data, size);
+	}
+
+	// Runs body for every index in [0, count) in parallel. Each stage only touches data owned by
+	// it's own index, so the result never depends on the schedule
+	auto forEach = [&](size_t count, const std::function<void(size_t)>& body) {
+		jobs->Wait(jobs->ParallelFor(count, 1, [&body](size_t begin, size_t end) {
+			for (size_t ix = begin; ix < end; ix++) { body(ix); }
+		}));
+	};
+	// Jobs can't throw, so each chunk records it's error and we report the first one in file order
+	auto throwErrors = [](const std::vector<ObjChunk>& chunks) {
+		for (const ObjChunk& chunk : chunks) {
+			if (!chunk.Error.empty()) {
+				throw std::runtime_error(chunk.Error);
+			}
+		}
+	};
+
+	// Parse each chunk into it's own arrays
+	std::vector<ObjChunk> chunks = SplitChunks(data, size, numChunks);
+	forEach(chunks.size(), [&](size_t ix) {
+		try {
+			ObjChunk& chunk = chunks[ix];
+			ParseChunk(chunk, [&chunk](const ChunkCorner* corners, uint32_t count) {
+				chunk.Corners.insert(chunk.Corners.end(), corners, corners + count);
+				chunk.FaceSizes.push_back(count);
+			});
+		} catch (const std::exception& e) {
+			chunks[ix].Error = e.what();
+		}
+	});
+	throwErrors(chunks);
+
+	// Work out where each chunk's data lands in the whole file
+	glm::ivec3 numAttributes = glm::ivec3(0);
+	size_t numCorners = 0;
+	size_t numIndices = 0;
+	for (ObjChunk& chunk : chunks) {
+		chunk.AttributeBase = numAttributes;
+		chunk.CornerBase = numCorners;
+		chunk.NumCorners = chunk.Corners.size();
+		chunk.IndexBase = numIndices;
+		numAttributes += glm::ivec3(static_cast<int>(chunk.Positions.size()), static_cast<int>(chunk.UVs.size()), static_cast<int>(chunk.Normals.size()));
+		numCorners += chunk.Corners.size();
+		numIndices += chunk.NumIndices;
+	}
+	if (numCorners >= 0xFFFFFFFFull) {
+		throw std::runtime_error("OBJ file has too many face corners");
+	}
+
+	ObjMeshData result;
+	result.Positions.reserve(numAttributes.x);
+	result.UVs.reserve(numAttributes.y);
+	result.Normals.reserve(numAttributes.z);
+	for (const ObjChunk& chunk : chunks) {
+		result.Positions.insert(result.Positions.end(), chunk.Positions.begin(), chunk.Positions.end());
+		result.UVs.insert(result.UVs.end(), chunk.UVs.begin(), chunk.UVs.end());
+		result.Normals.insert(result.Normals.end(), chunk.Normals.begin(), chunk.Normals.end());
+	}
+
+	// Resolves a corner to global attribute indices, recording an error if it's out of range
+	auto resolve = [&numAttributes](ObjChunk& chunk, const ChunkCorner& corner) {
+		glm::ivec3 key = glm::ivec3(-1);
+		for (int attribute = 0; attribute < 3; attribute++) {
+			if (corner.Flags & (1 << attribute)) {
+				int64_t index = corner.Index[attribute];
+				if (corner.Flags & (1 << (attribute + 3))) {
+					index += chunk.AttributeBase[attribute];
+				}
+				if (index < 0 || index >= numAttributes[attribute]) {
+					if (chunk.Error.empty()) {
+						chunk.Error = "OBJ face refers to an attribute that does not exist";
+					}
+					index = -1;
+				}
+				key[attribute] = static_cast<int>(index);
+			}
+		}
+		return key;
+	};
+
+	// Resolve every corner to global attribute indices, and sort them into dedup shards
+	std::vector<glm::ivec3> keys(numCorners);
+	forEach(chunks.size(), [&](size_t chunkIx) {
+		ObjChunk& chunk = chunks[chunkIx];
+		for (size_t ix = 0; ix < chunk.Corners.size(); ix++) {
+			glm::ivec3 key = resolve(chunk, chunk.Corners[ix]);
+			uint32_t globalIx = static_cast<uint32_t>(chunk.CornerBase + ix);
+			keys[globalIx] = key;
+			chunk.ShardCorners[VertexDedupTable::Hash(key) >> (32 - ShardBits)].push_back(globalIx);
+		}
+		// We don't need the raw corners anymore
+		chunk.Corners = std::vector<ChunkCorner>();
+	});
+	throwErrors(chunks);
+
+	// Find the first corner with the same attributes as each corner. Each shard visits it's corners in
+	// file order, so the first corner with a given key is always the one that it is recorded with
+	std::vector<uint32_t> firstCorner(numCorners);
+	forEach(NumShards, [&](size_t shard) {
+		VertexDedupTable table = VertexDedupTable();
+		for (const ObjChunk& chunk : chunks) {
+			for (uint32_t corner : chunk.ShardCorners[shard]) {
+				firstCorner[corner] = table.FindOrAdd(keys[corner], corner);
+			}
+		}
+	});
+
+	// Number the unique vertices in the order they first appear in the file, same as a serial pass would
+	forEach(chunks.size(), [&](size_t chunkIx) {
+		ObjChunk& chunk = chunks[chunkIx];
+		chunk.NumNewVertices = 0;
+		for (size_t corner = chunk.CornerBase; corner < chunk.CornerBase + chunk.NumCorners; corner++) {
+			chunk.NumNewVertices += firstCorner[corner] == corner ? 1 : 0;
+		}
+	});
+	size_t numVertices = 0;
+	for (ObjChunk& chunk : chunks) {
+		chunk.VertexBase = numVertices;
+		numVertices += chunk.NumNewVertices;
+	}
+
+	// Store the new vertices, and keep their index where we can find it from any corner
+	std::vector<uint32_t> vertexIndex(numCorners);
+	result.Vertices.resize(numVertices);
+	forEach(chunks.size(), [&](size_t chunkIx) {
+		ObjChunk& chunk = chunks[chunkIx];
+		uint32_t next = static_cast<uint32_t>(chunk.VertexBase);
+		for (size_t corner = chunk.CornerBase; corner < chunk.CornerBase + chunk.NumCorners; corner++) {
+			if (firstCorner[corner] == corner) {
+				result.Vertices[next] = keys[corner];
+				vertexIndex[corner] = next++;
+			}
+		}
+	});
+
+	// Split each polygon into a triangle fan
+	result.Indices.resize(numIndices);
+	forEach(chunks.size(), [&](size_t chunkIx) {
+		const ObjChunk& chunk = chunks[chunkIx];
+		size_t corner = chunk.CornerBase;
+		uint32_t* out = result.Indices.data() + chunk.IndexBase;
+		for (uint32_t faceSize : chunk.FaceSizes) {
+			for (uint32_t ix = 2; ix < faceSize; ix++) {
+				*out++ = vertexIndex[firstCorner[corner]];
+				*out++ = vertexIndex[firstCorner[corner + ix - 1]];
+				*out++ = vertexIndex[firstCorner[corner + ix]];
+			}
+			corner += faceSize;
+		}
+	});
+
+	// Material changes are rare, so we can gather them up on this thread
+	std::vector<std::pair<size_t, std::string>> materialChanges;
+	for (const ObjChunk& chunk : chunks) {
+		for (const auto& change : chunk.MaterialChanges) {
+			materialChanges.emplace_back(chunk.IndexBase + change.first, change.second);
+		}
+	}
+	BuildSubmeshes(result, materialChanges);
+
+	return result;
+}
+
+ObjMeshData ObjLoader::ParseFile(const std::string& filename, JobSystem* jobs) {
+	MappedFile file(filename);
+
+	// If our file fails to open, we will throw an error
+	if (!file.IsOpen()) {
+		throw std::runtime_error("Failed to open file");
+	}
+
+	return Parse(reinterpret_cast<const char*>(file.Data()), file.Size(), jobs);
+}
@@ -1,22 +1,77 @@
 #pragma once
 
 #include <string>
-#include <sstream>
-#include <fstream>
-#include <iostream>
+#include <vector>
+#include <stdexcept>
 #include <GLFW/glfw3.h>
-#include <filesystem>
 
 #include "MeshBuilder.h"
 #include "MeshFactory.h"
 #include "Graphics/VertexTypes.h"
-#include "Utils/StringUtils.h"
+#include "Graphics/VertexParamMap.h"
+
+class JobSystem;
+
+/// <summary>
+/// The geometry from an OBJ file, with each unique combination of attributes turned into a vertex
+/// </summary>
+struct ObjMeshData {
+	std::vector<glm::vec3>  Positions;
+	std::vector<glm::vec2>  UVs;
+	std::vector<glm::vec3>  Normals;
+	// The position, UV and normal index for each unique vertex, -1 if the attribute was not given
+	std::vector<glm::ivec3> Vertices;
+	// Triangle list indices into Vertices, grouped so that each material is a single range
+	std::vector<uint32_t>   Indices;
+	// The range of Indices for each material, empty if the whole file uses one material
+	std::vector<Submesh>    Submeshes;
+	// The names given to usemtl for each material slot, in the order they were first used. Faces
+	// before the first usemtl use a material with an empty name
+	std::vector<std::string> MaterialSlots;
+};
 
 class ObjLoader
 {
 public:
 	template <typename VertexType = VertexPosNormTexColTangents>
-	static VertexArrayObject::Sptr LoadFromFile(const std::string& filename, bool calcTangents = true);
+	static VertexArrayObject::Sptr LoadFromFile(const std::string& filename, bool calcTangents = true, JobSystem* jobs = nullptr, std::vector<std::string>* materialSlots = nullptr);
+
+	// Loads the mesh data without sending it to OpenGL, so it can be used off the main thread. If materialSlots
+	// is not null, it receives the usemtl name for each of the mesh's material slots. The mesh is left as it
+	// is in the file, levels of detail and cache ordering are left to whoever bakes it (see OptimizedObjLoader
+	// and MeshResource), so that tools which only need the triangles don't pay for them
+	template <typename VertexType = VertexPosNormTexColTangents>
+	static MeshBuilder<VertexType> LoadMeshFromFile(const std::string& filename, bool calcTangents = true, JobSystem* jobs = nullptr, std::vector<std::string>* materialSlots = nullptr);
+
+	/// <summary>
+	/// Parses the contents of an OBJ file. Handles polygons with any number of sides (as a
+	/// triangle fan), negative indices, and faces that are missing UVs or normals
+	///
+	/// Faces are grouped by their usemtl material into submeshes, so a file with several materials
+	/// can be drawn from one set of buffers with one draw per material. Groups and objects (g and o)
+	/// do not change the material, so they are merged into the submesh for their material
+	///
+	/// Large files are split into chunks at line boundaries that are parsed and deduplicated on
+	/// the job system, the result is always identical to parsing without a job system
+	/// </summary>
+	/// <param name="data">The text of the OBJ file, does not need to be null terminated</param>
+	/// <param name="size">The size of the text, in bytes</param>
+	/// <param name="jobs">The job system to parse on, or nullptr to parse on the calling thread</param>
+	/// <returns>The parsed and deduplicated geometry</returns>
+	/// <exception cref="std::runtime_error">If a face refers to an attribute that does not exist</exception>
+	static ObjMeshData Parse(const char* data, size_t size, JobSystem* jobs = nullptr);
+	/// <summary>
+	/// Maps an OBJ file into memory and parses it, see Parse
+	/// </summary>
+	/// <exception cref="std::runtime_error">If the file could not be opened, or is invalid</exception>
+	static ObjMeshData ParseFile(const std::string& filename, JobSystem* jobs = nullptr);
+
+	/// <summary>
+	/// Fills a mesh builder with the vertices, indices and submeshes from parsed OBJ data. If the
+	/// file has no normals, smooth normals are calculated for it (see MeshFactory::CalculateNormals)
+	/// </summary>
+	template <typename VertexType>
+	static void BuildMesh(const ObjMeshData& data, MeshBuilder<VertexType>& mesh, JobSystem* jobs = nullptr);
 
 protected:
 	ObjLoader() = default;
@@ -25,168 +80,63 @@ protected:
 
 
 template <typename VertexType>
-VertexArrayObject::Sptr ObjLoader::LoadFromFile(const std::string& filename, bool calcTangents) {
-	// Open our file in binary mode
-	std::ifstream file;
-	file.open(filename, std::ios::binary);
-
-	// If our file fails to open, we will throw an error
-	if (!file) {
-		throw std::runtime_error("Failed to open file");
-	}
-
-	// Could also take this in as a parameter
-	glm::vec4 color = glm::vec4(1.0f);
-
-	// We'll use a vertex param mapper for our attributes
-	VertexParamMap vMap = VertexParamMap(VertexType::V_DECL);
-
-	// Our attributes
-	std::vector<glm::vec3>  positions;
-	std::vector<glm::vec3>  normals;
-	std::vector<glm::vec2>  uvs;
-	std::vector<glm::ivec3> vertices;
-	std::vector<uint32_t>   indices;
+VertexArrayObject::Sptr ObjLoader::LoadFromFile(const std::string& filename, bool calcTangents, JobSystem* jobs, std::vector<std::string>* materialSlots) {
+	// Move our data into a VAO and return it
+	return LoadMeshFromFile<VertexType>(filename, calcTangents, jobs, materialSlots).Bake();
+}
 
-	// Maps a key generated from obj indices to a vertex index that
-	// has been added to the mesh already
-	std::unordered_map<uint64_t, uint32_t> vertexMap;
+template <typename VertexType>
+MeshBuilder<VertexType> ObjLoader::LoadMeshFromFile(const std::string& filename, bool calcTangents, JobSystem* jobs, std::vector<std::string>* materialSlots) {
+	float startTime = static_cast<float>(glfwGetTime());
 
 	// We'll use the mesh builder since it supports easily adding
 	// vertices and indices
 	MeshBuilder<VertexType> mesh = MeshBuilder<VertexType>();
+	ObjMeshData data = ParseFile(filename, jobs);
+	BuildMesh(data, mesh, jobs);
+	if (materialSlots != nullptr) {
+		*materialSlots = std::move(data.MaterialSlots);
+	}
 
-	// Storage for temporary data
-	std::string line;
-	glm::vec3 vecData;
-	glm::ivec3 vertexIndices;
+	if (calcTangents) {
+		MeshFactory::CalculateTBN(mesh, jobs);
+	}
 
-	float startTime = static_cast<float>(glfwGetTime());
+	// Calculate and trace out how long it took us to load
+	float endTime = static_cast<float>(glfwGetTime());
+	LOG_TRACE("Loaded OBJ file \"{}\" in {} seconds ({} vertices, {} indices)", filename, endTime - startTime, mesh.GetVertexCount(), mesh.GetIndexCount());
 
-	// Read and process the entire file
-	while (file.peek() != EOF) {
-		// Read in the first part of the line (ex: f, v, vn, etc...)
-		std::string command;
-		file >> command;
-
-		// We will ignore the rest of the line for comment lines
-		if (command == "#") {
-			std::getline(file, line);
-		}
-
-		// The v command defines a vertex's position
-		else if (command == "v") {
-			// Read in and store a position
-			file >> vecData.x >> vecData.y >> vecData.z;
-			positions.push_back(vecData);
-		}
-		// TODO: handle normals and textures
-		else if (command == "vn") {
-			// Read in and store a position
-			file >> vecData.x >> vecData.y >> vecData.z;
-			normals.push_back(vecData);
-		} 
-		else if (command == "vt") {
-			// Read in and store a position
-			file >> vecData.x >> vecData.y;
-			uvs.push_back(vecData);
-		}
-
-		// The f command defines a polygon in the mesh
-		// NOTE: make sure you triangulate in blender, otherwise it will
-		// output quads instead of triangles
-		else if (command == "f") {
-			// Read the rest of the line from the file
-			std::getline(file, line);
-			// Trim whitespace from either end of the line
-			StringTools::Trim(line);
-			// Create a string stream so we can use streaming operators on it
-			std::stringstream stream = std::stringstream(line);
-
-			uint32_t edges[4];
-			int ix = 0;
-			// Iterate over up to 4 sets of attributes
-			for (; ix < 4; ix++) {
-				if (stream.peek() != EOF) {
-					// Load in the faces, split up by slashes
-					char tempChar;
-					vertexIndices = glm::ivec3(0);
-					stream >> vertexIndices.x >> tempChar >> vertexIndices.y >> tempChar >> vertexIndices.z;
-					// The OBJ format can have negative values, which are a reference from the last added attributes
-					if (vertexIndices.x < 0) { vertexIndices.x = positions.size() + 1 + vertexIndices.x; }
-					if (vertexIndices.y < 0) { vertexIndices.y = uvs.size() + 1 + vertexIndices.y; }
-					if (vertexIndices.z < 0) { vertexIndices.z = normals.size() + 1 + vertexIndices.z; }
-
-					// We can construct a key using a bitmask of the attribute indices
-					// This let's us quickly look up a combination of attributes to see if it's already been added
-					// Note that this limits us to 2,097,150 unique attributes for positions, normals and textures
-					const uint64_t mask = 0b0'000000000000000000000'000000000000000000000'111111111111111111111;
-					uint64_t key = ((vertexIndices.x & mask) << 42) | ((vertexIndices.y & mask) << 21) | (vertexIndices.z & mask);
-
-					// Find the index associated with the combination of attributes
-					auto it = vertexMap.find(key);
-
-					// If it exists, we push the index to our indices
-					if (it != vertexMap.end()) {
-						edges[ix] = it->second;
-					} else {
-						vertices.push_back(vertexIndices - glm::ivec3(1));
-						uint32_t index = static_cast<uint32_t>(vertices.size()) - 1;
-
-						// Cache the index based on our key
-						vertexMap[key] = index;
-						// Add index to mesh, and add to edges list for if we are using quads
-						edges[ix] = index;
-					}
-				}
-				// We've reached the end of the line, break out of the loop
-				else { break; }
-			}
-
-			// Handling for triangle faces
-			if (ix == 3) {
-				indices.push_back(edges[0]);
-				indices.push_back(edges[1]);
-				indices.push_back(edges[2]);
-			}
-			// Handling for quad faces
-			else if (ix == 4) {
-				indices.push_back(edges[0]);
-				indices.push_back(edges[1]);
-				indices.push_back(edges[2]);
-
-				indices.push_back(edges[0]);
-				indices.push_back(edges[2]);
-				indices.push_back(edges[3]);
-			}
-		}
-	}
+	return mesh;
+}
+
+template <typename VertexType>
+void ObjLoader::BuildMesh(const ObjMeshData& data, MeshBuilder<VertexType>& mesh, JobSystem* jobs) {
+	// Could also take this in as a parameter
+	glm::vec4 color = glm::vec4(1.0f);
+
+	// We'll use a vertex param mapper for our attributes
+	VertexParamMap vMap = VertexParamMap(VertexType::V_DECL);
 
-	mesh.ReserveVertexSpace(vertices.size());
-	for (const auto& vertexIndices : vertices) {
+	mesh.ReserveVertexSpace(data.Vertices.size());
+	for (const auto& vertexIndices : data.Vertices) {
 		// Construct a new vertex using the indices for the vertex
 		VertexType vertex;
-		vMap.SetPosition(vertex, positions[vertexIndices.x]);
-		vMap.SetTexture(vertex, vertexIndices.y != 0 ? uvs[vertexIndices.y] : glm::vec2(0.0f));
-		vMap.SetNormal(vertex, vertexIndices.z != 0 ? normals[vertexIndices.z] : glm::vec3(0.0f, 0.0f, 1.0f));
+		vMap.SetPosition(vertex, data.Positions[vertexIndices.x]);
+		vMap.SetTexture(vertex, vertexIndices.y >= 0 ? data.UVs[vertexIndices.y] : glm::vec2(0.0f));
+		vMap.SetNormal(vertex, vertexIndices.z >= 0 ? data.Normals[vertexIndices.z] : glm::vec3(0.0f, 0.0f, 1.0f));
 		vMap.SetColor(vertex, color);
 
 		// Add to the mesh, get index of the added vertex
 		mesh.AddVertex(vertex);
 	}
-	mesh.ReserveIndexSpace(indices.size());
-	for (uint32_t ix : indices) {
-		mesh.AddIndex(ix);
+	uint32_t indexBase = static_cast<uint32_t>(mesh.GetIndexCount());
+	mesh.AddIndexRange(data.Indices.data(), data.Indices.size());
+	for (const Submesh& submesh : data.Submeshes) {
+		mesh.AddSubmesh(indexBase + submesh.FirstIndex, submesh.IndexCount, submesh.MaterialSlot);
 	}
 
-	if (calcTangents) {
-		MeshFactory::CalculateTBN(mesh);
+	// Without normals every vertex would face the same way, so we smooth them from the triangles instead
+	if (data.Normals.empty() && !data.Indices.empty()) {
+		MeshFactory::CalculateNormals(mesh, jobs);
 	}
-
-	// Calculate and trace out how long it took us to load
-	float endTime = static_cast<float>(glfwGetTime());
-	LOG_TRACE("Loaded OBJ file \"{}\" in {} seconds ({} vertices, {} indices)", filename, endTime - startTime, mesh.GetVertexCount(), mesh.GetIndexCount());
-
-	// Move our data into a VAO and return it
-	return mesh.Bake();
-}
\ No newline at end of file
+}
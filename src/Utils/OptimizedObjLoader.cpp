@@ -3,21 +3,27 @@
 #include "ObjLoader.h"
 
 #include <string>
-#include <sstream>
 #include <fstream>
-#include <iostream>
 #include <filesystem>
+#include <cstring>
+#include <memory>
 
 #include "Utils/StringUtils.h"
+#include "Utils/FileHelpers.h"
+#include "Utils/MappedFile.h"
+#include "Utils/MeshOptimizer.h"
+#include "Utils/MeshSimplifier.h"
 #include "GLFW/glfw3.h"
 #include "Logging.h"
 
 const char HEADER_BYTES[4] = { 'B', 'O', 'B', 'J' };
 const std::string binaryExtension = ".bin";
+// All sections in a binary file start on a multiple of this
+const size_t sectionAlignment = 16;
 
 namespace fs = std::filesystem;
 
-VertexArrayObject::Sptr OptimizedObjLoader::LoadFromFile(const std::string& filename) {
+VertexArrayObject::Sptr OptimizedObjLoader::LoadFromFile(const std::string& filename, MeshInfo* info, JobSystem* jobs) {
 	// Get the file extension and lowercase it
 	fs::path filePath = std::filesystem::path(filename);
 	std::string extension = filePath.extension().string();
@@ -27,16 +33,36 @@ VertexArrayObject::Sptr OptimizedObjLoader::LoadFromFile(const std::string& file
 	if (extension == ".obj") {
 		// Get the binary path
 		fs::path binPath = filePath.replace_extension(binaryExtension);
-		// If the file does not exist, convert the OBJ file to a binary file
-		if (!fs::exists(binPath)) {
-			ConvertToBinary(filename, binPath.string());
+		// Load the corresponding binary file, as long as it's still valid for the OBJ
+		VertexArrayObject::Sptr result = fs::exists(binPath) ? _LoadFromBinFile(binPath.string(), filename, info) : nullptr;
+		// If the file is missing, out of date or corrupt, convert the OBJ file to a binary file
+		if (result == nullptr) {
+			std::vector<std::string> materialSlots;
+			std::unique_ptr<MeshBuilder<VertexPosNormTexColTangents>> mesh(_LoadFromObjFile(filename, jobs, &materialSlots));
+			try {
+				SaveBinaryFile(*mesh, binPath.string(), filename, materialSlots);
+				result = _LoadFromBinFile(binPath.string(), filename, info);
+			} catch (const std::exception& e) {
+				LOG_WARN("Could not write binary mesh \"{}\": {}", binPath.string(), e.what());
+			}
+
+			// We already have the mesh, so a read only folder or a full disk shouldn't stop us from using it
+			if (result == nullptr) {
+				LOG_WARN("Using the mesh parsed from \"{}\" directly, it will be parsed again next time", filename);
+				result = mesh->Bake();
+				if (info != nullptr) {
+					info->HasBounds = mesh->CalculateBounds(info->BoundsMin, info->BoundsMax);
+					info->Submeshes = mesh->GetSubmeshes();
+					info->MaterialSlots = std::move(materialSlots);
+					info->Lods = mesh->GetLods();
+				}
+			}
 		}
-		// Load the corresponding binary file
-		return _LoadFromBinFile(binPath.string());
+		return result;
 	} 
 	// Load our fancy binary files
 	else if (extension == ".bin") {
-		return _LoadFromBinFile(filename);
+		return _LoadFromBinFile(filename, "", info);
 	}
 	// We've never met this extension in our life
 	else {
@@ -45,9 +71,10 @@ VertexArrayObject::Sptr OptimizedObjLoader::LoadFromFile(const std::string& file
 	}
 }
 
-void OptimizedObjLoader::ConvertToBinary(const std::string& inFile, const std::string& outFile) {
+void OptimizedObjLoader::ConvertToBinary(const std::string& inFile, const std::string& outFile, JobSystem* jobs) {
 	// Load in the input file
-	MeshBuilder<VertexPosNormTexColTangents>* mesh = _LoadFromObjFile(inFile);
+	std::vector<std::string> materialSlots;
+	std::unique_ptr<MeshBuilder<VertexPosNormTexColTangents>> mesh(_LoadFromObjFile(inFile, jobs, &materialSlots));
 
 	float startTime = static_cast<float>(glfwGetTime());
 
@@ -62,267 +89,386 @@ void OptimizedObjLoader::ConvertToBinary(const std::string& inFile, const std::s
 		outFileName = path.string();
 	}
 
-	// Save the mesh to the file
-	SaveBinaryFile(*mesh, outFileName);
+	// Save the mesh to the file, remembering where it came from so we can tell when it's out of date
+	SaveBinaryFile(*mesh, outFileName, inFile, materialSlots);
 
 	float endTime = static_cast<float>(glfwGetTime());
 	LOG_TRACE("Converted OBJ file to binary \"{}\" in {} seconds ({} vertices, {} indices)", inFile, endTime - startTime, mesh->GetVertexCount(), mesh->GetIndexCount());
-
-	// We no longer need the mesh data, free it
-	delete mesh;
 }
 
-MeshBuilder<VertexPosNormTexColTangents>* OptimizedObjLoader::_LoadFromObjFile(const std::string& filename) {
-	// Open our file in binary mode
-	std::ifstream file;
-	file.open(filename, std::ios::binary);
+MeshBuilder<VertexPosNormTexColTangents>* OptimizedObjLoader::_LoadFromObjFile(const std::string& filename, JobSystem* jobs, std::vector<std::string>* materialSlots) {
+	float startTime = static_cast<float>(glfwGetTime());
 
-	// If our file fails to open, we will throw an error
-	if (!file) {
-		throw std::runtime_error("Failed to open file");
-	}
+	// We'll use the mesh builder since it supports easily adding
+	// vertices and indices
+	MeshBuilder<VertexPosNormTexColTangents>* mesh = new MeshBuilder<VertexPosNormTexColTangents>();
+	ObjMeshData data = ObjLoader::ParseFile(filename, jobs);
+	ObjLoader::BuildMesh(data, *mesh, jobs);
+	*materialSlots = std::move(data.MaterialSlots);
 
-	// Could also take this in as a parameter
-	glm::vec4 color = glm::vec4(1.0f);
+	// Calculate our tangents
+	MeshFactory::CalculateTBN(*mesh, jobs);
 
-	// Our attributes
-	std::vector<glm::vec3>  positions;
-	std::vector<glm::vec3>  normals;
-	std::vector<glm::vec2>  uvs;
-	std::vector<glm::ivec3> vertices;
-	std::vector<uint32_t>   indices;
+	// Generate simplified versions of the mesh to draw when it's far away, these are saved in the binary file too
+	MeshSimplifier::GenerateLods(*mesh, filename);
 
-	// Maps a key generated from obj indices to a vertex index that
-	// has been added to the mesh already
-	std::unordered_map<uint64_t, uint32_t> vertexMap;
+	// Reorder the triangles and vertices so the GPU can reuse more work while drawing, this is saved in the binary file
+	MeshOptimizer::Optimize(*mesh, filename);
 
-	// We'll use the mesh builder since it supports easily adding
-	// vertices and indices
-	MeshBuilder<VertexPosNormTexColTangents>* mesh = new MeshBuilder<VertexPosNormTexColTangents>();
+	// Calculate and trace out how long it took us to load
+	float endTime = static_cast<float>(glfwGetTime());
+	LOG_TRACE("Loaded OBJ file \"{}\" in {} seconds ({} vertices, {} indices)", filename, endTime - startTime, mesh->GetVertexCount(), mesh->GetIndexCount());
 
-	// Storage for temporary data
-	std::string line;
-	glm::vec3 vecData;
-	glm::ivec3 vertexIndices;
+	return mesh;
+}
 
+VertexArrayObject::Sptr OptimizedObjLoader::_LoadFromBinFile(const std::string& filename, const std::string& sourceFilename, MeshInfo* info) {
 	float startTime = static_cast<float>(glfwGetTime());
 
-	// Read and process the entire file
-	while (file.peek() != EOF) {
-		// Read in the first part of the line (ex: f, v, vn, etc...)
-		std::string command;
-		file >> command;
+	// Map the file, so we can upload straight from the file without copying it into memory first
+	MappedFile file(filename);
+	if (!file.IsOpen()) { return nullptr; }
+	const uint8_t* data = file.Data();
+	const size_t size = file.Size();
+
+	auto invalid = [&](const char* reason) {
+		LOG_WARN("Binary mesh \"{}\" is invalid: {}", filename, reason);
+		return nullptr;
+	};
+
+	// Check the header bytes and version, which are in the same place for every version
+	uint16_t version = 0;
+	if (size < sizeof(HEADER_BYTES) + sizeof(version) || memcmp(data, HEADER_BYTES, sizeof(HEADER_BYTES)) != 0) {
+		return invalid("not a binary mesh file");
+	}
+	memcpy(&version, data + sizeof(HEADER_BYTES), sizeof(version));
+	if (version == 0x01) {
+		// Version 1 files don't know what they were made from, so we rebuild them if we have the source
+		if (!sourceFilename.empty()) {
+			LOG_INFO("Binary mesh \"{}\" uses an old format, rebuilding", filename);
+			return nullptr;
+		}
+		return _LoadFromBinFileV1(data, size, filename);
+	}
+	// Older files with the same layout can still be loaded, but are rebuilt if we have the source so they
+	// pick up the newer processing (see BinaryVersion)
+	if (version >= 0x02 && version < BinaryVersion && !sourceFilename.empty()) {
+		LOG_INFO("Binary mesh \"{}\" was built by an older version, rebuilding", filename);
+		return nullptr;
+	}
+	if (version < 0x02 || version > BinaryVersion) { return invalid("unsupported version"); }
 
-		// We will ignore the rest of the line for comment lines
-		if (command == "#") {
-			std::getline(file, line);
+	BinaryHeader header = BinaryHeader();
+	if (size < sizeof(BinaryHeader)) { return invalid("not enough data for the header"); }
+	memcpy(&header, data, sizeof(BinaryHeader));
+	if (header.HeaderSize != sizeof(BinaryHeader) || header.FileSize != size) { return invalid("file is truncated"); }
+
+	// Make sure the file still matches the OBJ it was built from. Copying or checking out a file changes it's
+	// write time without changing it's contents, so we check the hash before deciding it's out of date
+	if (!sourceFilename.empty()) {
+		std::error_code error;
+		uint64_t sourceSize = static_cast<uint64_t>(fs::file_size(sourceFilename, error));
+		int64_t sourceTime = error ? 0 : static_cast<int64_t>(fs::last_write_time(sourceFilename, error).time_since_epoch().count());
+		if (error || sourceSize != header.SourceSize ||
+			(sourceTime != header.SourceWriteTime && FileHelpers::HashFile(sourceFilename) != header.SourceHash)) {
+			LOG_INFO("Binary mesh \"{}\" is out of date with \"{}\", rebuilding", filename, sourceFilename);
+			return nullptr;
 		}
+	}
+
+	if (_ComputeChecksum(data + sizeof(BinaryHeader), size - sizeof(BinaryHeader)) != header.Checksum) {
+		return invalid("checksum does not match");
+	}
 
-		// The v command defines a vertex's position
-		else if (command == "v") {
-			// Read in and store a position
-			file >> vecData.x >> vecData.y >> vecData.z;
-			positions.push_back(vecData);
+	// Find all of our sections. Sections we don't know about are skipped, so that optional sections
+	// can be added without breaking older loaders
+	if (header.NumSections > (size - sizeof(BinaryHeader)) / sizeof(BinarySection)) { return invalid("section table is truncated"); }
+	const uint32_t numSectionTypes = static_cast<uint32_t>(SectionType::LodSubmeshes) + 1;
+	const uint8_t* sections[numSectionTypes] = { nullptr };
+	uint64_t sectionSizes[numSectionTypes] = { 0 };
+	for (uint32_t ix = 0; ix < header.NumSections; ix++) {
+		BinarySection section;
+		memcpy(&section, data + sizeof(BinaryHeader) + ix * sizeof(BinarySection), sizeof(BinarySection));
+		if (section.Offset % sectionAlignment != 0 || section.Offset > size || section.Size > size - section.Offset) {
+			return invalid("section is outside of the file");
 		}
-		// TODO: handle normals and textures
-		else if (command == "vn") {
-			// Read in and store a position
-			file >> vecData.x >> vecData.y >> vecData.z;
-			normals.push_back(vecData);
-		} else if (command == "vt") {
-			// Read in and store a position
-			file >> vecData.x >> vecData.y;
-			uvs.push_back(vecData);
+		uint32_t type = static_cast<uint32_t>(section.Type);
+		if (type < numSectionTypes) {
+			sections[type] = data + section.Offset;
+			sectionSizes[type] = section.Size;
 		}
+	}
 
-		// The f command defines a polygon in the mesh
-		// NOTE: make sure you triangulate in blender, otherwise it will
-		// output quads instead of triangles
-		else if (command == "f") {
-			// Read the rest of the line from the file
-			std::getline(file, line);
-			// Trim whitespace from either end of the line
-			StringTools::Trim(line);
-			// Create a string stream so we can use streaming operators on it
-			std::stringstream stream = std::stringstream(line);
-
-			uint32_t edges[4];
-			int ix = 0;
-			// Iterate over up to 4 sets of attributes
-			for (; ix < 4; ix++) {
-				if (stream.peek() != EOF) {
-					// Load in the faces, split up by slashes
-					char tempChar;
-					vertexIndices = glm::ivec3(0);
-					stream >> vertexIndices.x >> tempChar >> vertexIndices.y >> tempChar >> vertexIndices.z;
-					// The OBJ format can have negative values, which are a reference from the last added attributes
-					if (vertexIndices.x < 0) { vertexIndices.x = positions.size() + 1 + vertexIndices.x; }
-					if (vertexIndices.y < 0) { vertexIndices.y = uvs.size()       + 1 + vertexIndices.y; }
-					if (vertexIndices.z < 0) { vertexIndices.z = normals.size()   + 1 + vertexIndices.z; }
-
-					// We can construct a key using a bitmask of the attribute indices
-					// This let's us quickly look up a combination of attributes to see if it's already been added
-					// Note that this limits us to 2,097,150 unique attributes for positions, normals and textures
-					const uint64_t mask = 0b0'000000000000000000000'000000000000000000000'111111111111111111111;
-					uint64_t key = ((vertexIndices.x & mask) << 42) | ((vertexIndices.y & mask) << 21) | (vertexIndices.z & mask);
-
-					// Find the index associated with the combination of attributes
-					auto it = vertexMap.find(key);
-
-					// If it exists, we push the index to our indices
-					if (it != vertexMap.end()) {
-						edges[ix] = it->second;
-					} else {
-						vertices.push_back(vertexIndices - glm::ivec3(1));
-						uint32_t index = static_cast<uint32_t>(vertices.size()) - 1;
-
-						// Cache the index based on our key
-						vertexMap[key] = index;
-						// Add index to mesh, and add to edges list for if we are using quads
-						edges[ix] = index;
-					}
-				}
-				// We've reached the end of the line, break out of the loop
-				else { break; }
-			}
+	// Make sure our sections match what the header says we have
+	const uint32_t attributesIx = static_cast<uint32_t>(SectionType::Attributes);
+	const uint32_t indicesIx = static_cast<uint32_t>(SectionType::Indices);
+	const uint32_t verticesIx = static_cast<uint32_t>(SectionType::Vertices);
+	const uint32_t boundsIx = static_cast<uint32_t>(SectionType::Bounds);
+	const uint32_t submeshesIx = static_cast<uint32_t>(SectionType::Submeshes);
+	const uint32_t materialSlotsIx = static_cast<uint32_t>(SectionType::MaterialSlots);
+	const uint32_t lodsIx = static_cast<uint32_t>(SectionType::Lods);
+	const uint32_t lodIndicesIx = static_cast<uint32_t>(SectionType::LodIndices);
+	const uint32_t lodSubmeshesIx = static_cast<uint32_t>(SectionType::LodSubmeshes);
+	const size_t indexSize = GetIndexTypeSize(header.IndicesType);
+	if (sections[attributesIx] == nullptr || sectionSizes[attributesIx] != header.NumAttributes * sizeof(BufferAttribute)) {
+		return invalid("vertex attributes are missing");
+	}
+	if (sections[verticesIx] == nullptr || sectionSizes[verticesIx] != header.NumVertices * (uint64_t)header.VertexStride) {
+		return invalid("vertex data is missing");
+	}
+	if (header.NumIndices > 0 && (indexSize == 0 || sections[indicesIx] == nullptr || sectionSizes[indicesIx] != header.NumIndices * (uint64_t)indexSize)) {
+		return invalid("index data is missing");
+	}
+	if (sections[boundsIx] != nullptr && sectionSizes[boundsIx] != sizeof(glm::vec3) * 2) {
+		return invalid("bounds are the wrong size");
+	}
+	if (sections[submeshesIx] != nullptr && sectionSizes[submeshesIx] % sizeof(Submesh) != 0) {
+		return invalid("submesh table is the wrong size");
+	}
+	if (sections[materialSlotsIx] != nullptr && sectionSizes[materialSlotsIx] > 0 && sections[materialSlotsIx][sectionSizes[materialSlotsIx] - 1] != '\0') {
+		return invalid("material slot names are not terminated");
+	}
+	if (sections[lodsIx] != nullptr && (sectionSizes[lodsIx] % sizeof(MeshLod) != 0 || indexSize == 0 || sections[lodIndicesIx] == nullptr ||
+		sectionSizes[lodIndicesIx] % indexSize != 0 || sectionSizes[lodSubmeshesIx] % sizeof(Submesh) != 0)) {
+		return invalid("level of detail tables are the wrong size");
+	}
+
+	// Read all attributes from the file, this is basically our VDECL
+	std::vector<BufferAttribute> vertexDeclaration;
+	vertexDeclaration.resize(header.NumAttributes);
+	memcpy(vertexDeclaration.data(), sections[attributesIx], sectionSizes[attributesIx]);
+	for (const BufferAttribute& attrib : vertexDeclaration) {
+		if (attrib.Stride != header.VertexStride || attrib.Offset < 0 || attrib.Offset >= header.VertexStride) {
+			return invalid("vertex attributes do not match the vertex size");
+		}
+		// Compressed positions are stored relative to the mesh's bounds, see VertexCompression
+		if (attrib.Usage == AttribUsage::Position && attrib.Type != AttributeType::Float && sections[boundsIx] == nullptr) {
+			return invalid("compressed positions need the mesh's bounds");
+		}
+	}
 
-			// Handling for triangle faces
-			if (ix == 3) {
-				indices.push_back(edges[0]);
-				indices.push_back(edges[1]);
-				indices.push_back(edges[2]);
+	// Read the optional sections
+	MeshInfo meshInfo = MeshInfo();
+	if (sections[boundsIx] != nullptr) {
+		meshInfo.HasBounds = true;
+		memcpy(&meshInfo.BoundsMin, sections[boundsIx], sizeof(glm::vec3));
+		memcpy(&meshInfo.BoundsMax, sections[boundsIx] + sizeof(glm::vec3), sizeof(glm::vec3));
+	}
+	if (sections[submeshesIx] != nullptr) {
+		meshInfo.Submeshes.resize(sectionSizes[submeshesIx] / sizeof(Submesh));
+		memcpy(meshInfo.Submeshes.data(), sections[submeshesIx], sectionSizes[submeshesIx]);
+		for (const Submesh& submesh : meshInfo.Submeshes) {
+			if (submesh.FirstIndex > header.NumIndices || submesh.IndexCount > header.NumIndices - submesh.FirstIndex) {
+				return invalid("submesh is outside of the index data");
+			}
+		}
+	}
+	if (sections[materialSlotsIx] != nullptr) {
+		const char* names = reinterpret_cast<const char*>(sections[materialSlotsIx]);
+		const char* namesEnd = names + sectionSizes[materialSlotsIx];
+		for (const char* name = names; name < namesEnd; name += strlen(name) + 1) {
+			meshInfo.MaterialSlots.push_back(name);
+		}
+	}
+	std::vector<Submesh> lodSubmeshes;
+	if (sections[lodsIx] != nullptr) {
+		meshInfo.Lods.resize(sectionSizes[lodsIx] / sizeof(MeshLod));
+		memcpy(meshInfo.Lods.data(), sections[lodsIx], sectionSizes[lodsIx]);
+		lodSubmeshes.resize(sectionSizes[lodSubmeshesIx] / sizeof(Submesh));
+		if (!lodSubmeshes.empty()) {
+			memcpy(lodSubmeshes.data(), sections[lodSubmeshesIx], sectionSizes[lodSubmeshesIx]);
+		}
+		const uint64_t numLodIndices = sectionSizes[lodIndicesIx] / indexSize;
+		for (const MeshLod& lod : meshInfo.Lods) {
+			if (lod.FirstIndex > numLodIndices || lod.IndexCount > numLodIndices - lod.FirstIndex ||
+				lod.FirstSubmesh > lodSubmeshes.size() || lod.SubmeshCount > lodSubmeshes.size() - lod.FirstSubmesh) {
+				return invalid("level of detail is outside of it's tables");
 			}
-			// Handling for quad faces
-			else if (ix == 4) {
-				indices.push_back(edges[0]);
-				indices.push_back(edges[1]);
-				indices.push_back(edges[2]);
-
-				indices.push_back(edges[0]);
-				indices.push_back(edges[2]);
-				indices.push_back(edges[3]);
+			for (uint32_t ix = lod.FirstSubmesh; ix < lod.FirstSubmesh + lod.SubmeshCount; ix++) {
+				if (lodSubmeshes[ix].FirstIndex > lod.IndexCount || lodSubmeshes[ix].IndexCount > lod.IndexCount - lodSubmeshes[ix].FirstIndex) {
+					return invalid("level of detail submesh is outside of it's index data");
+				}
 			}
 		}
 	}
 
-	mesh->ReserveVertexSpace(vertices.size());
-	for (const auto& vertexIndices : vertices) {
-		// Construct a new vertex using the indices for the vertex
-		VertexPosNormTexColTangents vertex;
-		vertex.Position = positions[vertexIndices.x];
-		vertex.UV       = vertexIndices.y != 0 ? uvs[vertexIndices.y] : glm::vec2(0.0f);
-		vertex.Normal   = vertexIndices.z != 0 ? normals[vertexIndices.z] : glm::vec3(0.0f, 0.0f, 1.0f);
-		vertex.Color    = color;
+	// These will have the buffer pointers
+	IndexBuffer::Sptr indices = nullptr;
+	VertexBuffer::Sptr vertices = nullptr;
 
-		// Add to the mesh, get index of the added vertex
-		mesh->AddVertex(vertex);
+	// If we have index data, upload it straight from the file. The mesh never changes, so we can use immutable storage
+	if (header.NumIndices > 0) {
+		indices = IndexBuffer::Create(BufferUsage::StaticDraw);
+		indices->LoadStorage(sections[indicesIx], static_cast<uint32_t>(indexSize), header.NumIndices, header.IndicesType);
 	}
-	mesh->ReserveIndexSpace(indices.size());
-	for (uint32_t ix : indices) {
-		mesh->AddIndex(ix);
+
+	// Upload the vertices straight from the file as well
+	vertices = VertexBuffer::Create(BufferUsage::StaticDraw);
+	vertices->LoadStorage(sections[verticesIx], header.VertexStride, header.NumVertices);
+
+	// Create the VAO and attach our index and vertex buffers
+	VertexArrayObject::Sptr result = VertexArrayObject::Create();
+	result->SetIndexBuffer(indices);
+	result->AddVertexBuffer(vertices, vertexDeclaration);
+
+	// Copy in the vertex declaration we loaded
+	result->SetVDecl(vertexDeclaration);
+	result->SetSubmeshes(meshInfo.Submeshes);
+	if (meshInfo.HasBounds) {
+		result->SetBounds(meshInfo.BoundsMin, meshInfo.BoundsMax);
 	}
 
-	// Calculate our tangents
-	MeshFactory::CalculateTBN(*mesh);
+	// Each level of detail gets an index buffer, uploaded straight from the file like the full detail one
+	std::vector<VertexArrayObject::Lod> lods;
+	for (const MeshLod& lod : meshInfo.Lods) {
+		IndexBuffer::Sptr lodIndices = IndexBuffer::Create(BufferUsage::StaticDraw);
+		lodIndices->LoadStorage(sections[lodIndicesIx] + lod.FirstIndex * indexSize, static_cast<uint32_t>(indexSize), lod.IndexCount, header.IndicesType);
+		std::vector<Submesh> submeshes(lodSubmeshes.begin() + lod.FirstSubmesh, lodSubmeshes.begin() + lod.FirstSubmesh + lod.SubmeshCount);
+		lods.push_back({ result->CreateLod(lodIndices, submeshes), lod.Error });
+	}
+	result->SetLods(lods);
+
+	if (info != nullptr) {
+		*info = std::move(meshInfo);
+	}
 
 	// Calculate and trace out how long it took us to load
 	float endTime = static_cast<float>(glfwGetTime());
-	LOG_TRACE("Loaded OBJ file \"{}\" in {} seconds ({} vertices, {} indices)", filename, endTime - startTime, mesh->GetVertexCount(), mesh->GetIndexCount());
+	LOG_TRACE("Loaded OBJ file \"{}\" in {} seconds ({} vertices, {} indices)", filename, endTime - startTime, header.NumVertices, header.NumIndices);
 
-	// Move our data into a VAO and return it
-	return mesh;
+	return result;
 }
 
-VertexArrayObject::Sptr OptimizedObjLoader::_LoadFromBinFile(const std::string& filename) {
-
-	// Open the output file
-	std::ifstream file(filename, std::ios::binary);
-	// If our file fails to open, we will throw an error
-	if (!file) { throw std::runtime_error("Failed to open file"); }
-
+VertexArrayObject::Sptr OptimizedObjLoader::_LoadFromBinFileV1(const uint8_t* data, size_t size, const std::string& filename) {
 	float startTime = static_cast<float>(glfwGetTime());
 
-	// Get the file size so we can avoid reading past the end
-	file.seekg(0, std::ios::end);
-	size_t size = file.tellg();
-	file.seekg(0, std::ios::beg);
-
 	// Read the header from the file
-	BinaryHeader header = BinaryHeader();
-	if (size >= sizeof(BinaryHeader)) {
-		file.read(reinterpret_cast<char*>(&header), sizeof(BinaryHeader));
-	} else {
+	BinaryHeaderV1 header = BinaryHeaderV1();
+	if (size < sizeof(BinaryHeaderV1)) {
 		LOG_ERROR("Not enough data in the file!");
 		return nullptr;
 	}
+	memcpy(&header, data, sizeof(BinaryHeaderV1));
+
+	// Determine how many bytes we need in the file
+	const size_t indexSize = GetIndexTypeSize(header.IndicesType);
+	size_t requiredBytes =
+		sizeof(BinaryHeaderV1) +
+		(header.NumAttributes * sizeof(BufferAttribute)) +
+		(header.VertexStride * (size_t)header.NumVertices) +
+		(header.NumIndices * indexSize);
+
+	// Make sure there's enough data in the file
+	if (size < requiredBytes || (header.NumIndices > 0 && indexSize == 0)) {
+		LOG_ERROR("Not enough data in the file!");
+		return nullptr;
+	}
+	const uint8_t* read = data + sizeof(BinaryHeaderV1);
+
+	// Read all attributes from the file, this is basically our VDECL
+	std::vector<BufferAttribute> vertexDeclaration;
+	vertexDeclaration.resize(header.NumAttributes);
+	memcpy(vertexDeclaration.data(), read, header.NumAttributes * sizeof(BufferAttribute));
+	read += header.NumAttributes * sizeof(BufferAttribute);
+
+	// Version 1 has no alignment guarantees, but GL copies the data so that's fine
+	IndexBuffer::Sptr indices = nullptr;
+	if (header.NumIndices > 0) {
+		indices = IndexBuffer::Create(BufferUsage::StaticDraw);
+		indices->LoadStorage(read, static_cast<uint32_t>(indexSize), header.NumIndices, header.IndicesType);
+		read += header.NumIndices * indexSize;
+	}
 
-	// TODO: validate header
-
-	// Handle our version
-	if (header.Version == 0x01) {
-		// Determine how many bytes we need in the file
-		size_t requiredBytes =
-			sizeof(BinaryHeader) +
-			(header.NumAttributes * sizeof(BufferAttribute)) +
-			(header.VertexStride * (size_t)header.NumVertices) +
-			(header.NumIndices * GetIndexTypeSize(header.IndicesType));
-
-		// Make sure there's enough data in the file
-		if (size < requiredBytes) {
-			LOG_ERROR("Not enough data in the file!");
-			return nullptr;
-		}
-
-		// Read all attributes from the file, this is basically our VDECL
-		std::vector<BufferAttribute> vertexDeclaration;
-		vertexDeclaration.resize(header.NumAttributes);
-		for (int ix = 0; ix < header.NumAttributes; ix++) {
-			file.read(reinterpret_cast<char*>(&vertexDeclaration[ix]), sizeof(BufferAttribute));
-		}
-
-		// These will have the buffer pointers
-		IndexBuffer::Sptr indices = nullptr;
-		VertexBuffer::Sptr vertices = nullptr;
-
-		// If we have index data, load it
-		if (header.NumIndices > 0) {
-			// Create index buffer
-			indices = IndexBuffer::Create(BufferUsage::StaticDraw);
-
-			// Create memory to store indices, then read from the file
-			void* dataStore = malloc(header.NumIndices * GetIndexTypeSize(header.IndicesType));
-			file.read(reinterpret_cast<char*>(dataStore), header.NumIndices * GetIndexTypeSize(header.IndicesType));
-			
-			// Load data into OpenGL and free the CPU memory we allocated
-			indices->LoadData(dataStore, GetIndexTypeSize(header.IndicesType), header.NumIndices, header.IndicesType);
-			free(dataStore);
-		}
+	VertexBuffer::Sptr vertices = VertexBuffer::Create(BufferUsage::StaticDraw);
+	vertices->LoadStorage(read, header.VertexStride, header.NumVertices);
 
-		// Create a new VBO
-		vertices = VertexBuffer::Create(BufferUsage::StaticDraw);
+	// Create the VAO and attach our index and vertex buffers
+	VertexArrayObject::Sptr result = VertexArrayObject::Create();
+	result->SetIndexBuffer(indices);
+	result->AddVertexBuffer(vertices, vertexDeclaration);
+	result->SetVDecl(vertexDeclaration);
 
-		// Create memory to store vertices and load from file
-		void* vertexStore = malloc(header.NumVertices * (size_t)header.VertexStride);
-		file.read(reinterpret_cast<char*>(vertexStore), header.NumVertices * (size_t)header.VertexStride);
+	float endTime = static_cast<float>(glfwGetTime());
+	LOG_TRACE("Loaded OBJ file \"{}\" in {} seconds ({} vertices, {} indices)", filename, endTime - startTime, header.NumVertices, header.NumIndices);
 
-		// Load data into OpenGL and free the CPU copy
-		vertices->LoadData(vertexStore, header.VertexStride, header.NumVertices);
-		free(vertexStore);
+	return result;
+}
 
-		// Create the VAO and attach our index and vertex buffers
-		VertexArrayObject::Sptr result = VertexArrayObject::Create();
-		result->SetIndexBuffer(indices);
-		result->AddVertexBuffer(vertices, vertexDeclaration);
+/// <summary>
+/// Rounds an offset in a binary file up to the next section boundary
+/// </summary>
+inline uint64_t AlignSection(uint64_t offset) {
+	return (offset + sectionAlignment - 1) / sectionAlignment * sectionAlignment;
+}
 
-		// Copy in the vertex declaration we loaded
-		result->SetVDecl(vertexDeclaration);
+void OptimizedObjLoader::_WriteBinaryFile(BinaryHeader header, const std::vector<SectionData>& sections, const std::string& outFilename, const std::string& sourceFilename) {
+	// Lay out the section table right after the header, then each section on it's own boundary
+	std::vector<BinarySection> table(sections.size());
+	uint64_t offset = AlignSection(sizeof(BinaryHeader) + sections.size() * sizeof(BinarySection));
+	for (size_t ix = 0; ix < sections.size(); ix++) {
+		table[ix].Type = sections[ix].Type;
+		table[ix].Offset = offset;
+		table[ix].Size = sections[ix].Size;
+		offset = AlignSection(offset + sections[ix].Size);
+	}
 
-		// Calculate and trace out how long it took us to load
-		float endTime = static_cast<float>(glfwGetTime());
-		LOG_TRACE("Loaded OBJ file \"{}\" in {} seconds ({} vertices, {} indices)", filename, endTime - startTime, header.NumVertices, header.NumIndices);
+	// Build the whole file in memory, so we can checksum it before it hits the disk
+	std::vector<uint8_t> contents(offset, 0);
+	memcpy(contents.data() + sizeof(BinaryHeader), table.data(), table.size() * sizeof(BinarySection));
+	for (size_t ix = 0; ix < sections.size(); ix++) {
+		if (sections[ix].Size > 0) {
+			memcpy(contents.data() + table[ix].Offset, sections[ix].Data, sections[ix].Size);
+		}
+	}
 
-		return result;
+	// Fill in the rest of the header
+	header.Version = BinaryVersion;
+	header.HeaderSize = sizeof(BinaryHeader);
+	header.FileSize = contents.size();
+	header.NumSections = static_cast<uint32_t>(sections.size());
+	if (!sourceFilename.empty()) {
+		std::error_code error;
+		header.SourceSize = static_cast<uint64_t>(fs::file_size(sourceFilename, error));
+		header.SourceWriteTime = error ? 0 : static_cast<int64_t>(fs::last_write_time(sourceFilename, error).time_since_epoch().count());
+		header.SourceHash = FileHelpers::HashFile(sourceFilename);
 	}
+	header.Checksum = _ComputeChecksum(contents.data() + sizeof(BinaryHeader), contents.size() - sizeof(BinaryHeader));
+	memcpy(contents.data(), &header, sizeof(BinaryHeader));
+
+	// Write to a temporary file and then swap it in, so we never leave a half written file behind
+	std::string tempFilename = outFilename + ".tmp";
+	{
+		std::ofstream file(tempFilename, std::ios::binary);
+		if (!file) {
+			throw std::runtime_error("Failed to open output file");
+		}
+		file.write(reinterpret_cast<const char*>(contents.data()), contents.size());
+		file.close();
+		if (!file) {
+			std::error_code error;
+			fs::remove(tempFilename, error);
+			throw std::runtime_error("Failed to write output file");
+		}
+	}
+	std::error_code error;
+	fs::rename(tempFilename, outFilename, error);
+	if (error) {
+		fs::remove(tempFilename, error);
+		throw std::runtime_error("Failed to replace output file");
+	}
+}
 
-	return nullptr;
+uint64_t OptimizedObjLoader::_ComputeChecksum(const uint8_t* data, size_t size) {
+	// FNV-1a, but consuming 8 bytes at a time so that checking large meshes is cheap
+	uint64_t hash = 0xcbf29ce484222325ull;
+	size_t ix = 0;
+	for (; ix + sizeof(uint64_t) <= size; ix += sizeof(uint64_t)) {
+		uint64_t word;
+		memcpy(&word, data + ix, sizeof(uint64_t));
+		hash = (hash ^ word) * 0x100000001b3ull;
+	}
+	for (; ix < size; ix++) {
+		hash = (hash ^ data[ix]) * 0x100000001b3ull;
+	}
+	return hash;
 }
@@ -7,48 +7,114 @@
  */
 #pragma once
 #include <fstream>
+#include <vector>
+#include <GLM/glm.hpp>
 
 #include "Graphics/VertexArrayObject.h"
 #include "Graphics/VertexTypes.h"
+#include "Graphics/VertexCompression.h"
 
 #include "Utils/MeshBuilder.h"
 
+class JobSystem;
+
 /// <summary>
 /// An optimized OBJ loader that can convert an OBJ file to a binary representation
 /// that we can load significantly faster
+///
+/// Binary files (version 6) start with a BinaryHeader, followed by a table of sections. Every
+/// section starts on a 16 byte boundary, so the file can be memory mapped and uploaded to the GPU
+/// in place. The header records the size, modification time and hash of the OBJ file it was
+/// built from, as well as a checksum of everything after the header, so stale or corrupt files
+/// are detected and rebuilt
 /// </summary>
 class OptimizedObjLoader {
 public:
+	/// <summary>
+	/// Extra information stored alongside the mesh data in a binary file
+	/// </summary>
+	struct MeshInfo {
+		bool      HasBounds = false;
+		glm::vec3 BoundsMin = glm::vec3(0.0f);
+		glm::vec3 BoundsMax = glm::vec3(0.0f);
+		// The submeshes are also set on the loaded VAO, see VertexArrayObject::GetSubmeshes
+		std::vector<Submesh> Submeshes;
+		// The name of each material slot used by the submeshes
+		std::vector<std::string> MaterialSlots;
+		// The levels of detail stored in the file, which are also set on the loaded VAO (see VertexArrayObject::GetLods)
+		std::vector<MeshLod> Lods;
+	};
+
 	/// <summary>
 	/// Loads a VAO from an OBJ file. On the first time this is called for an OBJ file, will convert the OBJ file 
-	/// to a binary file and load that instead. On subsequent runs, the binary file will be loaded instead
+	/// to a binary file and load that instead. On subsequent runs, the binary file will be loaded instead, unless
+	/// it is out of date with the OBJ file or has been corrupted, in which case it is rebuilt
 	/// </summary>
 	/// <param name="filename">The path to the .obj or .bin file to load</param>
+	/// <param name="info">If not null, will be filled in with the bounds and submeshes stored in the file</param>
+	/// <param name="jobs">The job system to parse OBJ files on, or nullptr to parse on the calling thread</param>
 	/// <returns>A VAO loaded from disk</returns>
-	static VertexArrayObject::Sptr LoadFromFile(const std::string& filename);
+	static VertexArrayObject::Sptr LoadFromFile(const std::string& filename, MeshInfo* info = nullptr, JobSystem* jobs = nullptr);
 	/// <summary>
 	/// Manually converts an OBJ file into a binary mesh file
 	/// </summary>
 	/// <param name="inFile">The path to OBJ file to convert</param>
 	/// <param name="outFile">The output path for the bin file, or empty to use the inFile path and replace the extension with .bin</param>
-	static void ConvertToBinary(const std::string& inFile, const std::string& outFile = "");
+	/// <param name="jobs">The job system to parse the OBJ file on, or nullptr to parse on the calling thread</param>
+	static void ConvertToBinary(const std::string& inFile, const std::string& outFile = "", JobSystem* jobs = nullptr);
 
 	/// <summary>
 	/// Saves a mesh builder of the given type to a binary file
 	/// </summary>
-	/// <typeparam name="VertexType"></typeparam>
-	/// <param name="mesh"></param>
-	/// <param name="outFilename"></param>
+	/// <typeparam name="VertexType">The type of vertex stored in the mesh</typeparam>
+	/// <param name="mesh">The mesh to save</param>
+	/// <param name="outFilename">The path of the binary file to write</param>
+	/// <param name="sourceFilename">The file the mesh was generated from, used to detect when the binary file is out of date</param>
+	/// <param name="materialSlots">The names of the material slots used by the mesh's submeshes, if any</param>
 	template <typename VertexType>
-	static void SaveBinaryFile(MeshBuilder<VertexType>& mesh, const std::string& outFilename);
+	static void SaveBinaryFile(MeshBuilder<VertexType>& mesh, const std::string& outFilename, const std::string& sourceFilename = "", const std::vector<std::string>& materialSlots = {});
+
+	/// <summary>
+	/// Gets the version of the binary files that SaveBinaryFile writes. Binary files without a source
+	/// file can't be checked for being out of date, so their owners can use this to tell when to rebuild them
+	/// </summary>
+	static constexpr uint16_t GetBinaryVersion() { return BinaryVersion; }
 
 protected:
+	// Versions 3 and up have the same layout as version 2, but OBJ files are processed differently:
+	// 3 splits them into submeshes by material, 4 optimizes the triangle and vertex order, 5
+	// adds levels of detail, 6 stores compressed vertices and 7 stores 16 bit indices for small meshes
+	static constexpr uint16_t BinaryVersion = 7;
+
+	// Will be put at the start of version 1 binary files, which we can still load but no longer write
+	struct BinaryHeaderV1 {
+		char      HeaderBytes[4] ={ 'B', 'O', 'B', 'J' };
+		uint16_t  Version = 0;
+		uint32_t  NumIndices = 0;
+		IndexType IndicesType = IndexType::Unknown;
+		uint32_t  NumVertices = 0;
+		uint16_t  VertexStride = 0;
+		uint8_t   NumAttributes = 0;
+	};
+
 	// Will be put at the start of the binary file, contains info about the contents of the file
 	struct BinaryHeader {
 		// A check value so we can ensure that we're loading in the right file type
 		char      HeaderBytes[4] ={ 'B', 'O', 'B', 'J' };
 		// The version code, we can use this to create different loaders if our format changes
 		uint16_t  Version = 0;
+		// The size of this structure, so we can detect mismatched builds
+		uint16_t  HeaderSize = sizeof(BinaryHeader);
+		// The total size of the file, in bytes
+		uint64_t  FileSize = 0;
+		// A checksum of every byte in the file after this header
+		uint64_t  Checksum = 0;
+		// The FNV-1a hash of the file this was generated from, see FileHelpers::HashFile
+		uint64_t  SourceHash = 0;
+		// The last write time of the file this was generated from, in file clock ticks
+		int64_t   SourceWriteTime = 0;
+		// The size of the file this was generated from, in bytes
+		uint64_t  SourceSize = 0;
 		// The number of indices in the mesh
 		uint32_t  NumIndices = 0;
 		// The type of index to load
@@ -59,44 +125,110 @@ protected:
 		uint16_t  VertexStride = 0;
 		// The number of vertex attributes (basically how many VDECL entries there are)
 		uint8_t   NumAttributes = 0;
+		uint8_t   Padding = 0;
+		// The number of entries in the section table that follows the header
+		uint32_t  NumSections = 0;
+		uint32_t  Reserved[3] = { 0, 0, 0 };
+	};
+	static_assert(sizeof(BinaryHeader) % 16 == 0, "Binary header must keep the section table aligned");
+
+	enum class SectionType : uint32_t {
+		Attributes = 1, // BufferAttribute[NumAttributes]
+		Indices    = 2, // Indices of type IndicesType
+		Vertices   = 3, // NumVertices vertices of VertexStride bytes
+		Bounds     = 4, // glm::vec3[2], the min and max position
+		Submeshes  = 5, // Submesh[]
+		MaterialSlots = 6, // A null terminated name for each material slot
+		Lods       = 7, // MeshLod[]
+		LodIndices = 8, // Indices of type IndicesType for every level of detail
+		LodSubmeshes = 9 // Submesh[] for every level of detail
+	};
+
+	// An entry in the section table
+	struct BinarySection {
+		SectionType Type = SectionType::Attributes;
+		uint32_t    Reserved = 0;
+		uint64_t    Offset = 0;
+		uint64_t    Size = 0;
+	};
+
+	// A section of data to write to a binary file
+	struct SectionData {
+		SectionType Type;
+		const void* Data;
+		size_t      Size;
 	};
 
 	OptimizedObjLoader() = default;
 	~OptimizedObjLoader() = default;
 
-	static MeshBuilder<VertexPosNormTexColTangents>* _LoadFromObjFile(const std::string& filename);
-	static VertexArrayObject::Sptr _LoadFromBinFile(const std::string& filename);
+	static MeshBuilder<VertexPosNormTexColTangents>* _LoadFromObjFile(const std::string& filename, JobSystem* jobs, std::vector<std::string>* materialSlots);
+	// Returns nullptr if the file is invalid, or is out of date with sourceFilename when it is not empty
+	static VertexArrayObject::Sptr _LoadFromBinFile(const std::string& filename, const std::string& sourceFilename, MeshInfo* info);
+	static VertexArrayObject::Sptr _LoadFromBinFileV1(const uint8_t* data, size_t size, const std::string& filename);
+	static void _WriteBinaryFile(BinaryHeader header, const std::vector<SectionData>& sections, const std::string& outFilename, const std::string& sourceFilename);
+	static uint64_t _ComputeChecksum(const uint8_t* data, size_t size);
 };
 
 template <typename VertexType>
-void OptimizedObjLoader::SaveBinaryFile(MeshBuilder<VertexType>& mesh, const std::string& outFilename) {
-	// Open the output file
-	std::ofstream file(outFilename, std::ios::binary);
-	if (!file) {
-		throw std::runtime_error("Failed to open output file");
+void OptimizedObjLoader::SaveBinaryFile(MeshBuilder<VertexType>& mesh, const std::string& outFilename, const std::string& sourceFilename, const std::vector<std::string>& materialSlots) {
+	// If the vertex has a float position, we can store the bounds of the mesh
+	glm::vec3 bounds[2];
+	bool hasBounds = mesh.CalculateBounds(bounds[0], bounds[1]);
+
+	// Store the vertices in their compressed form if they have one, the same as MeshBuilder::Bake would
+	VertexCompression::PackedVertices packed;
+	const std::vector<BufferAttribute>* vDecl = &VertexType::V_DECL;
+	const void* vertexData = mesh.GetVertexDataPtr();
+	uint32_t vertexStride = sizeof(VertexType);
+	if (hasBounds && VertexCompression::Compress(mesh.GetVertexDataPtr(), mesh.GetVertexCount(), bounds[0], bounds[1], packed)) {
+		vDecl = packed.VDecl;
+		vertexData = packed.Data.data();
+		vertexStride = packed.Stride;
 	}
 
-	// Create the fixed size header for our output file
+	// Store the indices with the smallest type that can address all of the vertices, the levels of detail
+	// share the vertices of the full detail mesh so they use the same type
+	const IndexType indexType = IndexBuffer::GetSmallestType(mesh.GetVertexCount());
+	std::vector<uint8_t> indices = IndexBuffer::ConvertIndices(mesh.GetIndexDataPtr(), mesh.GetIndexCount(), indexType);
+	std::vector<uint8_t> lodIndices = IndexBuffer::ConvertIndices(mesh.GetLodIndices().data(), mesh.GetLodIndices().size(), indexType);
+
+	// Create the fixed size header for our output file, the rest is filled in when the file is written
 	BinaryHeader header  = BinaryHeader();
-	header.Version       = 0x01; // This is version 1! Update this and implement different readers if changes to format are made
-	header.NumIndices    = mesh.GetIndexCount();
-	header.IndicesType   = IndexType::UInt;
-	header.NumVertices   = mesh.GetVertexCount();
-	header.VertexStride  = sizeof(VertexType);
-	header.NumAttributes = VertexType::V_DECL.size();
-
-	// Write header bytes to the stream
-	file.write(reinterpret_cast<const char*>(&header), sizeof(BinaryHeader));
-
-	// Write which attributes we have to the stream
-	for (int ix = 0; ix < VertexType::V_DECL.size(); ix++) {
-		file.write(reinterpret_cast<const char*>(&VertexType::V_DECL[ix]), sizeof(BufferAttribute));
-	}
-	// Write any index data to the file
+	header.NumIndices    = static_cast<uint32_t>(mesh.GetIndexCount());
+	header.IndicesType   = indexType;
+	header.NumVertices   = static_cast<uint32_t>(mesh.GetVertexCount());
+	header.VertexStride  = vertexStride;
+	header.NumAttributes = static_cast<uint8_t>(vDecl->size());
+
+	std::vector<SectionData> sections;
+	sections.push_back({ SectionType::Attributes, vDecl->data(), vDecl->size() * sizeof(BufferAttribute) });
 	if (mesh.GetIndexCount() > 0) {
-		file.write(reinterpret_cast<const char*>(mesh.GetIndexDataPtr()), mesh.GetIndexCount() * sizeof(uint32_t));
+		sections.push_back({ SectionType::Indices, indices.data(), indices.size() });
+	}
+	sections.push_back({ SectionType::Vertices, vertexData, mesh.GetVertexCount() * (size_t)vertexStride });
+	if (hasBounds) {
+		sections.push_back({ SectionType::Bounds, bounds, sizeof(bounds) });
+	}
+
+	const std::vector<Submesh>& submeshes = mesh.GetSubmeshes();
+	if (!submeshes.empty()) {
+		sections.push_back({ SectionType::Submeshes, submeshes.data(), submeshes.size() * sizeof(Submesh) });
+	}
+
+	std::string slotNames;
+	for (const std::string& name : materialSlots) {
+		slotNames.append(name.c_str(), name.size() + 1);
+	}
+	if (!slotNames.empty()) {
+		sections.push_back({ SectionType::MaterialSlots, slotNames.data(), slotNames.size() });
+	}
+
+	if (!mesh.GetLods().empty()) {
+		sections.push_back({ SectionType::Lods, mesh.GetLods().data(), mesh.GetLods().size() * sizeof(MeshLod) });
+		sections.push_back({ SectionType::LodIndices, lodIndices.data(), lodIndices.size() });
+		sections.push_back({ SectionType::LodSubmeshes, mesh.GetLodSubmeshes().data(), mesh.GetLodSubmeshes().size() * sizeof(Submesh) });
 	}
 
-	// Write vertex data to file
-	file.write(reinterpret_cast<const char*>(mesh.GetVertexDataPtr()), mesh.GetVertexCount() * sizeof(VertexType));
+	_WriteBinaryFile(header, sections, outFilename, sourceFilename);
 }
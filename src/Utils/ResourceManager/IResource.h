@@ -4,6 +4,22 @@
 
 #include "Utils/TypeHelpers.h"
 
+/// <summary>
+/// Describes how much memory a resource is using, in bytes
+/// </summary>
+struct ResourceMemoryUsage {
+	size_t Cpu;
+	size_t Gpu;
+	// Memory that the resource shares with other resources (ex: generated meshes with the same parameters),
+	// the resource manager only counts it once for each SharedKey, no matter how many resources report it
+	size_t   Shared = 0;
+	// Identifies the shared memory, must be unique across all resource types. 0 if nothing is shared
+	uint64_t SharedKey = 0;
+
+	// The memory that would be freed by unloading just this resource, not including Shared
+	size_t Total() const { return Cpu + Gpu; }
+};
+
 /// <summary>
 /// Base class for graphics that the resource manager may want to manage
 /// (ex: textures, models, shaders, materials, etc...)
@@ -41,9 +57,43 @@ public:
 	/// <returns>The JSON blob for the resource</returns>
 	virtual nlohmann::json ToJson() const = 0;
 
+	/// <summary>
+	/// Returns true if this resource has changed since it was last written to the manifest.
+	/// Resources that don't track their changes are always dirty, so they are serialized on
+	/// every save
+	/// </summary>
+	virtual bool IsDirty() const { return true; }
+	/// <summary>
+	/// Called by the resource manager once the resource's current state is in the manifest
+	/// </summary>
+	virtual void ClearDirty() {}
+
+	/// <summary>
+	/// Gets an estimate of how much memory this resource is using, used by the resource
+	/// manager to keep resource types within their memory budgets
+	/// </summary>
+	virtual ResourceMemoryUsage GetMemoryUsage() const { return { 0, 0 }; }
+	/// <summary>
+	/// Returns true if this resource can be recreated exactly from it's manifest entry, which
+	/// allows the resource manager to unload it when nothing is using it
+	/// </summary>
+	virtual bool CanReload() const { return false; }
+
+	/// <summary>
+	/// Gets a number that changes whenever the resource is modified after it was created, so the
+	/// resource manager can tell when an asset no longer matches the content key it was created with
+	/// </summary>
+	uint32_t GetContentVersion() const { return _contentVersion; }
+
 protected:
 	Guid _guid;
-	IResource() : _guid(Guid::New()){}
+	uint32_t _contentVersion;
+	IResource() : _guid(Guid::New()), _contentVersion(0) {}
+
+	/// <summary>
+	/// Should be called whenever the resource's contents or settings are changed, see GetContentVersion
+	/// </summary>
+	void _ContentChanged() { _contentVersion++; }
 };
 
 /// <summary>
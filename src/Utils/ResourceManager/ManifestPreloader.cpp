@@ -0,0 +1,170 @@
+#include "Utils/ResourceManager/ManifestPreloader.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <Logging.h>
+
+/// <summary>
+/// Searches a manifest entry for strings that match the GUID of another entry, and
+/// adds the indices of those entries to result
+/// </summary>
+static void FindDependencies(const nlohmann::json& data, const std::unordered_map<std::string, size_t>& lookup, std::vector<size_t>& result) {
+	if (data.is_string()) {
+		auto it = lookup.find(data.get_ref<const std::string&>());
+		if (it != lookup.end() && std::find(result.begin(), result.end(), it->second) == result.end()) {
+			result.push_back(it->second);
+		}
+	} else if (data.is_structured()) {
+		for (const auto& item : data) {
+			FindDependencies(item, lookup, result);
+		}
+	}
+}
+
+ManifestPreloader::ManifestPreloader(JobSystem& jobs) :
+	_jobs(jobs),
+	_nodes(std::vector<Node>()),
+	_ready(std::vector<size_t>()),
+	_numRemaining(0),
+	_startTime(std::chrono::steady_clock::now())
+{ }
+
+ManifestPreloader::~ManifestPreloader() = default;
+
+void ManifestPreloader::Start() {
+	_startTime = std::chrono::steady_clock::now();
+	_nodes.clear();
+	_ready.clear();
+
+	// Gather everything that still needs to be loaded, in manifest order
+	std::unordered_map<std::string, size_t> lookup;
+	for (auto& [typeName, items] : ResourceManager::GetManifest().items()) {
+		if (!items.is_object()) {
+			continue;
+		}
+		for (auto& [guid, item] : items.items()) {
+			if (ResourceManager::IsLoaded(typeName, Guid(guid))) {
+				continue;
+			}
+
+			Node node;
+			node.TypeName = typeName;
+			node.Data = std::make_shared<const nlohmann::json>(item);
+			node.Job = nullptr;
+			node.Prepared = nullptr;
+			node.PendingDependencies = 0;
+			node.IsFinished = false;
+			lookup[guid] = _nodes.size();
+			_nodes.push_back(std::move(node));
+		}
+	}
+
+	// Link up the graph, resources that are already loaded are not in the lookup so they never block anything
+	std::vector<size_t> dependencies;
+	for (size_t ix = 0; ix < _nodes.size(); ix++) {
+		dependencies.clear();
+		FindDependencies(*_nodes[ix].Data, lookup, dependencies);
+		for (size_t dependency : dependencies) {
+			if (dependency != ix) {
+				_nodes[dependency].Dependents.push_back(ix);
+				_nodes[ix].PendingDependencies++;
+			}
+		}
+	}
+
+	// Preparing doesn't touch other resources, so every resource can be prepared at once
+	for (size_t ix = 0; ix < _nodes.size(); ix++) {
+		Node& node = _nodes[ix];
+		std::shared_ptr<PrepareResult> prepared = std::make_shared<PrepareResult>();
+		node.Prepared = prepared;
+
+		// The job only holds on to it's own copies, so the preloader can be thrown away at any time. The job
+		// system has to outlive the preloader anyway, so large resources may split their work across it
+		std::string typeName = node.TypeName;
+		std::shared_ptr<const nlohmann::json> data = node.Data;
+		JobSystem* jobs = &_jobs;
+		node.Job = _jobs.Schedule([prepared, typeName, data, jobs]() {
+			prepared->Finish = ResourceManager::PrepareLoad(typeName, *data, jobs);
+		});
+
+		if (node.PendingDependencies == 0) {
+			_ready.push_back(ix);
+		}
+	}
+	_numRemaining = _nodes.size();
+}
+
+bool ManifestPreloader::Update(float budgetMs) {
+	return _Update(std::chrono::steady_clock::now() + std::chrono::microseconds(static_cast<int64_t>(budgetMs * 1000.0f)));
+}
+
+void ManifestPreloader::Finish() {
+	while (!_Update(std::chrono::steady_clock::time_point::max())) {
+		// Everything that is ready is still being prepared, so help out until the first one is done
+		_jobs.Wait(_nodes[_ready.front()].Job);
+	}
+}
+
+bool ManifestPreloader::_Update(std::chrono::steady_clock::time_point deadline) {
+	while (_numRemaining > 0) {
+		if (std::chrono::steady_clock::now() >= deadline) {
+			return false;
+		}
+
+		// A dependency cycle leaves nothing ready, so we break it by loading the first entry in
+		// manifest order, which may load it's dependencies itself when it looks them up
+		if (_ready.empty()) {
+			for (size_t ix = 0; ix < _nodes.size(); ix++) {
+				if (!_nodes[ix].IsFinished) {
+					LOG_WARN("Resource {} in the manifest is part of a dependency cycle", _nodes[ix].Data->value("guid", std::string("null")));
+					_nodes[ix].PendingDependencies = 0;
+					_ready.push_back(ix);
+					break;
+				}
+			}
+		}
+
+		// Finish the first prepared resource in manifest order, so loading stays as predictable as possible
+		auto next = _ready.end();
+		for (auto it = _ready.begin(); it != _ready.end(); it++) {
+			if (JobSystem::IsComplete(_nodes[*it].Job) && (next == _ready.end() || *it < *next)) {
+				next = it;
+			}
+		}
+		if (next == _ready.end()) {
+			return false;
+		}
+
+		size_t index = *next;
+		_ready.erase(next);
+		_FinishNode(index);
+	}
+	return true;
+}
+
+void ManifestPreloader::_FinishNode(size_t index) {
+	Node& node = _nodes[index];
+	if (node.IsFinished) {
+		return;
+	}
+
+	if (node.Prepared->Finish) {
+		node.Prepared->Finish();
+	}
+	node.IsFinished = true;
+	node.Job = nullptr;
+	node.Prepared = nullptr;
+	node.Data = nullptr;
+	_numRemaining--;
+
+	for (size_t dependent : node.Dependents) {
+		if (--_nodes[dependent].PendingDependencies == 0 && !_nodes[dependent].IsFinished) {
+			_ready.push_back(dependent);
+		}
+	}
+
+	if (_numRemaining == 0) {
+		double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _startTime).count();
+		LOG_INFO("Preloaded {} resources in {:.2f}ms using {} threads", _nodes.size(), elapsed, _jobs.NumThreads());
+	}
+}
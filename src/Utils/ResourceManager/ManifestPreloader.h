@@ -0,0 +1,93 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "Application/JobSystem.h"
+#include "Utils/ResourceManager/ResourceManager.h"
+#include "Utils/Macros.h"
+
+/// <summary>
+/// Loads every resource in the resource manager's manifest that has not been loaded yet,
+/// preparing them on the job system's worker threads (see ResourceManager::PrepareLoad) and
+/// finishing them on the main thread
+///
+/// The manifest is treated as a dependency graph, where an entry depends on any other entry
+/// who's GUID appears anywhere in it's data (ex: a material depends on it's shader and
+/// textures). An entry is finished as soon as it has been prepared and all of it's
+/// dependencies have been finished, so independent resources don't wait on each other
+/// </summary>
+class ManifestPreloader {
+public:
+	MAKE_PTRS(ManifestPreloader);
+	NO_COPY(ManifestPreloader);
+	NO_MOVE(ManifestPreloader);
+
+	/// <summary>
+	/// Creates a new preloader, note that nothing is loaded until Start is called
+	/// </summary>
+	/// <param name="jobs">The job system to prepare resources on, must outlive the preloader</param>
+	ManifestPreloader(JobSystem& jobs);
+	~ManifestPreloader();
+
+	/// <summary>
+	/// Builds the dependency graph from the current manifest, and starts preparing all
+	/// resources that are not already loaded
+	/// </summary>
+	void Start();
+
+	/// <summary>
+	/// Finishes as many prepared resources as fits in the given budget, must be called on
+	/// the main thread. A single resource may run over the budget
+	/// </summary>
+	/// <param name="budgetMs">The maximum amount of time to spend, in milliseconds</param>
+	/// <returns>True once all resources have been loaded</returns>
+	bool Update(float budgetMs);
+	/// <summary>
+	/// Blocks until all resources have been loaded, the main thread will help prepare
+	/// resources while it waits
+	/// </summary>
+	void Finish();
+
+	/// <summary>
+	/// Returns true once all resources have been loaded
+	/// </summary>
+	bool IsDone() const { return _numRemaining == 0; }
+	/// <summary>
+	/// Gets the number of resources that were found to need loading
+	/// </summary>
+	size_t NumResources() const { return _nodes.size(); }
+	/// <summary>
+	/// Gets the number of resources that have not been finished yet
+	/// </summary>
+	size_t NumRemaining() const { return _numRemaining; }
+
+protected:
+	// Filled in by the job that prepares a resource
+	struct PrepareResult {
+		ResourceManager::FinishLoadFunc Finish;
+	};
+
+	struct Node {
+		std::string                    TypeName;
+		std::shared_ptr<const nlohmann::json> Data;
+		JobSystem::JobHandle           Job;
+		std::shared_ptr<PrepareResult> Prepared;
+		// Number of dependencies that have not been finished yet
+		int                            PendingDependencies;
+		// Indices of the nodes that depend on this one
+		std::vector<size_t>            Dependents;
+		bool                           IsFinished;
+	};
+
+	JobSystem&        _jobs;
+	std::vector<Node> _nodes;
+	// Nodes who's dependencies are all finished, in manifest order
+	std::vector<size_t> _ready;
+	size_t _numRemaining;
+	std::chrono::steady_clock::time_point _startTime;
+
+	bool _Update(std::chrono::steady_clock::time_point deadline);
+	void _FinishNode(size_t index);
+};
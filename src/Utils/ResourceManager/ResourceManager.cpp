@@ -1,11 +1,29 @@
 #include "Utils/ResourceManager/ResourceManager.h"
+#include "Utils/ResourceManager/ManifestPreloader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <Logging.h>
 
 #include "Utils/ObjLoader.h"
 #include "Utils/FileHelpers.h"
+#include "Utils/BlobStore.h"
 #include "Utils/StringUtils.h"
 
-std::map<std::type_index, std::map<Guid, IResource::Sptr>> ResourceManager::_resources;
+std::unordered_map<ResourceManager::ResourceKey, ResourceManager::ResourceEntry, ResourceManager::ResourceKeyHash> ResourceManager::_resources;
+uint32_t ResourceManager::_generation = 1;
+uint64_t ResourceManager::_useCounter = 0;
+std::vector<ResourceManager::ResourceKey> ResourceManager::_unmeasured;
+std::unordered_map<ResourceTypeId, size_t> ResourceManager::_memoryUsage;
+std::unordered_map<uint64_t, ResourceManager::SharedMemory> ResourceManager::_sharedMemory;
+std::map<std::string, ResourceManager::MemoryBudget> ResourceManager::_memoryBudgets;
+std::unordered_map<ResourceManager::ContentKey, ResourceManager::KeyedAsset, ResourceManager::ContentKeyHash> ResourceManager::_contentKeys;
+ResourceManager::DedupStats ResourceManager::_dedupStats = { 0, 0 };
 std::map<std::string, std::function<Guid(const nlohmann::json&)>> ResourceManager::_typeLoaders;
+std::map<std::string, std::function<ResourceManager::FinishLoadFunc(const nlohmann::json&, JobSystem*)>> ResourceManager::_typePreparers;
+std::map<std::string, ResourceTypeId> ResourceManager::_typeIds;
+std::unordered_map<ResourceTypeId, std::string> ResourceManager::_typeNames;
 
 nlohmann::ordered_json ResourceManager::_manifest;
 
@@ -21,12 +39,20 @@ const nlohmann::ordered_json& ResourceManager::GetManifest() {
 	return _manifest;
 }
 
-void ResourceManager::LoadManifest(const std::string& path, bool preloadAssets) {
+void ResourceManager::LoadManifest(const std::string& path, bool preloadAssets, JobSystem* jobs) {
 	std::string contents = FileHelpers::ReadFile(path);
-	nlohmann::ordered_json blob = nlohmann::ordered_json::parse(contents);
+	LoadManifestFromJson(nlohmann::ordered_json::parse(contents), preloadAssets, jobs);
+}
+
+void ResourceManager::LoadManifestFromJson(const nlohmann::ordered_json& blob, bool preloadAssets, JobSystem* jobs) {
 	_manifest = blob;
 
-	if (preloadAssets) {
+	if (preloadAssets && jobs != nullptr) {
+		ManifestPreloader preloader(*jobs);
+		preloader.Start();
+		preloader.Finish();
+	}
+	else if (preloadAssets) {
 		for (auto& [typeName, items] : blob.items()) {
 			auto& func = _typeLoaders[typeName];
 			if (func) {
@@ -38,23 +64,260 @@ void ResourceManager::LoadManifest(const std::string& path, bool preloadAssets)
 	}
 }
 
-void ResourceManager::SaveManifest(const std::string& path) {
-	// Update all resources in the manifest so they match their current representation
-	for (auto& [type, map] : _resources) {
-		std::string typeName = StringTools::SanitizeClassName(type.name());
-		for (auto& [guid, res] : map) {
-			if (res != nullptr) {
-				_manifest[typeName][guid.str()] = res->ToJson();
-				_manifest[typeName][guid.str()]["guid"] = res->GetGUID().str();
+bool ResourceManager::IsLoaded(const std::string& typeName, Guid id) {
+	auto type = _typeIds.find(typeName);
+	if (type == _typeIds.end()) {
+		return false;
+	}
+	auto it = _resources.find(ResourceKey{ type->second, id });
+	return it != _resources.end() && it->second.Resource != nullptr;
+}
+
+void ResourceManager::_Store(ResourceTypeId type, Guid id, const IResource::Sptr& resource) {
+	ResourceKey key = ResourceKey{ type, id };
+	auto [it, inserted] = _resources.try_emplace(key, ResourceEntry{ nullptr, 0, 0, 0 });
+	ResourceEntry& entry = it->second;
+	_Unmeasure(type, entry);
+
+	// Anything that cached the old resource needs to look it up again
+	if (entry.Resource != nullptr && entry.Resource != resource) {
+		_generation++;
+	}
+
+	entry.Resource = resource;
+	entry.LastUsed = ++_useCounter;
+	_unmeasured.push_back(key);
+}
+
+ResourceManager::ResourceEntry* ResourceManager::_FindKeyedAsset(ResourceTypeId type, const KeyedAsset& keyed) {
+	auto it = _resources.find(ResourceKey{ type, keyed.Id });
+	if (it == _resources.end() || it->second.Resource == nullptr) {
+		return nullptr;
+	}
+	// Settings changed through setters after the asset was made aren't in the key
+	const IResource::Sptr& resource = it->second.Resource;
+	if (resource != keyed.Asset.lock() || resource->GetContentVersion() != keyed.ContentVersion) {
+		return nullptr;
+	}
+	return &it->second;
+}
+
+void ResourceManager::_Measure(ResourceTypeId type, ResourceEntry& entry) {
+	_Unmeasure(type, entry);
+	ResourceMemoryUsage usage = entry.Resource->GetMemoryUsage();
+	entry.MemoryUsage = usage.Total();
+	_memoryUsage[type] += entry.MemoryUsage;
+
+	// Shared memory is counted by the first resource to report it
+	if (usage.SharedKey != 0) {
+		SharedMemory& shared = _sharedMemory[usage.SharedKey];
+		if (shared.NumUsers == 0) {
+			shared.Bytes = usage.Shared;
+			_memoryUsage[type] += shared.Bytes;
+		}
+		shared.NumUsers++;
+		entry.SharedKey = usage.SharedKey;
+	}
+}
+
+void ResourceManager::_Unmeasure(ResourceTypeId type, ResourceEntry& entry) {
+	_memoryUsage[type] -= entry.MemoryUsage;
+	entry.MemoryUsage = 0;
+	if (entry.SharedKey != 0) {
+		auto it = _sharedMemory.find(entry.SharedKey);
+		if (it != _sharedMemory.end() && --it->second.NumUsers == 0) {
+			_memoryUsage[type] -= it->second.Bytes;
+			_sharedMemory.erase(it);
+		}
+		entry.SharedKey = 0;
+	}
+}
+
+void ResourceManager::SetMemoryBudget(const std::string& typeName, size_t bytes) {
+	if (bytes == 0) {
+		_memoryBudgets.erase(typeName);
+	} else {
+		_memoryBudgets[typeName] = MemoryBudget{ bytes, false, false, 0, std::vector<ResourceKey>() };
+	}
+}
+
+size_t ResourceManager::GetMemoryBudget(const std::string& typeName) {
+	auto it = _memoryBudgets.find(typeName);
+	return it != _memoryBudgets.end() ? it->second.Bytes : 0;
+}
+
+size_t ResourceManager::GetMemoryUsage(const std::string& typeName) {
+	auto type = _typeIds.find(typeName);
+	if (type == _typeIds.end()) {
+		return 0;
+	}
+	auto it = _memoryUsage.find(type->second);
+	return it != _memoryUsage.end() ? it->second : 0;
+}
+
+ResourceManager::DedupStats ResourceManager::TakeDedupStats() {
+	DedupStats result = _dedupStats;
+	_dedupStats = { 0, 0 };
+	return result;
+}
+
+void ResourceManager::Update() {
+	for (const ResourceKey& key : _unmeasured) {
+		auto it = _resources.find(key);
+		if (it != _resources.end() && it->second.Resource != nullptr) {
+			_Measure(key.Type, it->second);
+		}
+	}
+	_unmeasured.clear();
+
+	for (auto& [typeName, budget] : _memoryBudgets) {
+		auto type = _typeIds.find(typeName);
+		if (type == _typeIds.end()) {
+			continue;
+		}
+		if (_memoryUsage[type->second] <= budget.Bytes) {
+			budget.HasWarned = false;
+			budget.IsBlocked = false;
+		} else if (!_IsBudgetBlocked(type->second, budget)) {
+			_EnforceBudget(type->second, budget);
+		}
+	}
+}
+
+void ResourceManager::_EnforceBudget(ResourceTypeId type, MemoryBudget& budget) {
+	// New resources were measured in Update, so only the ones that have changed since need measuring again
+	std::vector<std::pair<uint64_t, ResourceKey>> candidates;
+	budget.BlockedBy.clear();
+	for (auto& [key, entry] : _resources) {
+		if (key.Type != type || entry.Resource == nullptr) {
+			continue;
+		}
+		if (entry.Resource->IsDirty()) {
+			_Measure(type, entry);
+		}
+
+		// If anything outside of the resource manager has a reference, it's still in use
+		if (entry.Resource->CanReload()) {
+			if (entry.Resource.use_count() == 1) {
+				candidates.emplace_back(entry.LastUsed, key);
+			} else {
+				budget.BlockedBy.push_back(key);
 			}
 		}
 	}
+
+	// Unload the least recently used resources first
+	std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+	const std::string& typeName = _typeNames[type];
+	size_t numEvicted = 0;
+	for (size_t ix = 0; ix < candidates.size() && _memoryUsage[type] > budget.Bytes; ix++) {
+		auto it = _resources.find(candidates[ix].second);
+		IResource::Sptr resource = it->second.Resource;
+
+		// Make sure the manifest is up to date, since that's what we will reload from
+		_UpdateManifestEntry(typeName, resource);
+
+		// Memory shared with resources that are still loaded stays counted, since unloading this one won't free it
+		_Unmeasure(type, it->second);
+		_resources.erase(it);
+		numEvicted++;
+	}
+	size_t usage = _memoryUsage[type];
+
+	double usageMb = usage / (1024.0 * 1024.0);
+	double budgetMb = budget.Bytes / (1024.0 * 1024.0);
+	if (numEvicted > 0) {
+		_generation++;
+		LOG_INFO("Unloaded {} {} resources to stay within budget ({:.1f}MB / {:.1f}MB)", numEvicted, typeName, usageMb, budgetMb);
+	}
+	// Until something changes, another pass would end up in the same place
+	budget.IsBlocked = usage > budget.Bytes;
+	budget.BlockedUsage = usage;
+	if (!budget.IsBlocked) {
+		budget.BlockedBy.clear();
+	}
+	if (usage > budget.Bytes && !budget.HasWarned) {
+		LOG_WARN("{} resources are over budget, but all remaining resources are in use ({:.1f}MB / {:.1f}MB)", typeName, usageMb, budgetMb);
+		budget.HasWarned = true;
+	} else if (usage <= budget.Bytes) {
+		budget.HasWarned = false;
+	}
+}
+
+bool ResourceManager::_IsBudgetBlocked(ResourceTypeId type, const MemoryBudget& budget) {
+	if (!budget.IsBlocked || budget.BlockedUsage != _memoryUsage[type]) {
+		return false;
+	}
+	// A resource that was in use may have been let go, which would give us something to unload
+	for (const ResourceKey& key : budget.BlockedBy) {
+		auto it = _resources.find(key);
+		if (it == _resources.end() || it->second.Resource == nullptr || it->second.Resource.use_count() == 1) {
+			return false;
+		}
+	}
+	return true;
+}
+
+ResourceManager::FinishLoadFunc ResourceManager::PrepareLoad(const std::string& typeName, const nlohmann::json& data, JobSystem* jobs) {
+	auto preparer = _typePreparers.find(typeName);
+	if (preparer != _typePreparers.end()) {
+		return preparer->second(data, jobs);
+	}
+
+	auto loader = _typeLoaders.find(typeName);
+	if (loader == _typeLoaders.end() || !loader->second) {
+		return nullptr;
+	}
+	std::function<Guid(const nlohmann::json&)> load = loader->second;
+	return [load, data]() { load(data); };
+}
+
+bool ResourceManager::_UpdateManifestEntry(const std::string& typeName, const IResource::Sptr& resource) {
+	std::string guid = resource->GetGUID().str();
+	if (!resource->IsDirty()) {
+		// The manifest may have been replaced since the resource was loaded, search without inserting
+		auto type = _manifest.find(typeName);
+		if (type != _manifest.end() && type->is_object() && type->contains(guid)) {
+			return false;
+		}
+	}
+
+	nlohmann::json data = resource->ToJson();
+	data["guid"] = guid;
+	_manifest[typeName][guid] = std::move(data);
+	resource->ClearDirty();
+	return true;
+}
+
+void ResourceManager::SaveManifest(const std::string& path) {
+	auto start = std::chrono::steady_clock::now();
+
+	// Update the resources that have changed so the manifest matches their current representation,
+	// large binary payloads go into a sidecar file next to the manifest instead of the JSON
+	size_t numSerialized = 0;
+	const std::string blobPath = (std::filesystem::path(path).parent_path() / std::filesystem::path(path).stem()).string() + "-blobs.bin";
+	BlobStore::BeginWrite(blobPath);
+	for (auto& [key, entry] : _resources) {
+		if (entry.Resource != nullptr && _UpdateManifestEntry(_typeNames[key.Type], entry.Resource)) {
+			numSerialized++;
+		}
+	}
+	BlobStore::EndWrite();
+
+	// Re-serialized resources leave their old data behind in the sidecar, drop it once enough has built up
+	BlobStore::Compact(blobPath, _manifest);
 	FileHelpers::WriteContentsToFile(path, _manifest.dump(1,'\t'));
+
+	double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	LOG_INFO("Saved manifest to \"{}\" in {:.2f}ms, {} of {} resources had changed", path, elapsed, numSerialized, _resources.size());
 }
 
 void ResourceManager::Cleanup() {
-	for (auto& [type, map] : _resources) {
-		map.clear();
-	}
+	_resources.clear();
+	_contentKeys.clear();
+	_unmeasured.clear();
+	_memoryUsage.clear();
+	_sharedMemory.clear();
+	_generation++;
 }
 
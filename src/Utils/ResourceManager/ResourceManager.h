@@ -3,17 +3,56 @@
 #include <json.hpp>
 #include <unordered_map>
 #include <typeindex>
+#include <functional>
+#include <map>
 
 #include "Utils/GUID.hpp"
 #include "Utils/ResourceManager/IResource.h"
 #include "Utils/StringUtils.h"
 
+class JobSystem;
+
+/// <summary>
+/// Identifies a resource type without needing RTTI lookups, see ResourceTypeInfo
+/// </summary>
+typedef const void* ResourceTypeId;
+
+/// <summary>
+/// Provides a unique ID and the manifest name for a resource type. The ID is the address of a
+/// variable that exists once per type, so it is known at compile time, and the name is only
+/// sanitized the first time it is needed
+/// </summary>
+/// <typeparam name="T">The resource type</typeparam>
+template <typename T>
+struct ResourceTypeInfo {
+private:
+	// Not const, so that the linker can't merge the identical tags of different types into one
+	static inline char _tag;
+
+public:
+	static constexpr ResourceTypeId Id = &_tag;
+
+	/// <summary>
+	/// Gets the name that resources of this type are stored under in the manifest
+	/// </summary>
+	static const std::string& Name() {
+		static const std::string name = StringTools::SanitizeClassName(typeid(T).name());
+		return name;
+	}
+};
+
 /// <summary>
 /// Utility class for managing and loading resources from JSON
 /// manifest files
 /// </summary>
 class ResourceManager {
 public:
+	/// <summary>
+	/// Finishes loading a resource that was prepared with PrepareLoad, must be
+	/// invoked on the main thread
+	/// </summary>
+	typedef std::function<void()> FinishLoadFunc;
+
 	/// <summary>
 	/// Initializes the resource manager and performs any first-time
 	/// setup required
@@ -22,6 +61,12 @@ public:
 
 	/// <summary>
 	/// Creates a new asset, and forwards the arguments to it's constructor
+	///
+	/// Types that define a static GetContentKey taking the same arguments as the constructor are
+	/// deduplicated, if an asset with the same key already exists it is returned instead of
+	/// creating a new one (ex: two textures loaded from identical files with the same settings).
+	/// An asset that has been modified since it was created (see IResource::GetContentVersion),
+	/// or that has been unloaded or replaced since, no longer matches it's key and is not shared
 	/// </summary>
 	/// <typeparam name="T">The type of asset to create</typeparam>
 	/// <typeparam name="...TArgs">The types for the arguments to forward to the constructor</typeparam>
@@ -29,9 +74,33 @@ public:
 	/// <returns>The GUID of the newly created asset</returns>
 	template <typename T, typename ... TArgs, typename = std::enable_if<is_valid_resource<T>()>::type>
 	static std::shared_ptr<T> CreateAsset(TArgs&&... args) {
+		// If we already have an identical asset, we can share it instead of loading it again
+		std::string contentKey;
+		if constexpr (test_content_key<T, TArgs...>::value) {
+			contentKey = T::GetContentKey(args...);
+			if (!contentKey.empty()) {
+				auto it = _contentKeys.find(ContentKey{ ResourceTypeInfo<T>::Id, contentKey });
+				if (it != _contentKeys.end()) {
+					ResourceEntry* entry = _FindKeyedAsset(ResourceTypeInfo<T>::Id, it->second);
+					if (entry != nullptr) {
+						entry->LastUsed = ++_useCounter;
+						_dedupStats.NumResources++;
+						_dedupStats.NumBytes += entry->Resource->GetMemoryUsage().Total();
+						return std::static_pointer_cast<T>(entry->Resource);
+					}
+					// The asset is no longer the one the key was made for, the new one will take the key over
+					_contentKeys.erase(it);
+				}
+			}
+		}
+
 		// Create and store the asset
 		std::shared_ptr<T> asset = std::make_shared<T>(std::forward<TArgs>(args)...);
-		_resources[std::type_index(typeid(T))][asset->IResource::GetGUID()] = asset;
+		_typeNames.emplace(ResourceTypeInfo<T>::Id, ResourceTypeInfo<T>::Name());
+		_Store(ResourceTypeInfo<T>::Id, asset->IResource::GetGUID(), asset);
+		if (!contentKey.empty()) {
+			_contentKeys[ContentKey{ ResourceTypeInfo<T>::Id, contentKey }] = KeyedAsset{ asset->IResource::GetGUID(), asset, asset->GetContentVersion() };
+		}
 
 		// Get the JSON representation of the asset so we can store it in the manifest
 		nlohmann::json data = asset->ToJson();
@@ -41,40 +110,30 @@ public:
 		data["guid"] = guid;
 
 		// Store the JSON data in the resource manifest (based on the type's name)
-		_manifest[StringTools::SanitizeClassName(typeid(T).name())][guid] = data;
+		_manifest[ResourceTypeInfo<T>::Name()][guid] = data;
+		asset->ClearDirty();
 		return asset;
 	}
 
 	/// <summary>
-	/// Gets a shared pointer to the resource with the given type and GUID
+	/// Gets a shared pointer to the resource with the given type and GUID. Resources that are loaded
+	/// only cost a single hash lookup, resources that are only in the manifest will be loaded first
 	/// </summary>
 	/// <typeparam name="T">The type of resource to retreive</typeparam>
 	/// <param name="id">The ID of the resource to retrieve</param>
 	/// <returns>The resource with the given GUID, or nullptr if none exists</returns>
 	template<typename T, typename = std::enable_if<is_valid_resource<T>()>::type>
 	static std::shared_ptr<T> Get(Guid id) {
-		// Try and grab the asset from the resource pool
-		std::shared_ptr<T> result =  std::dynamic_pointer_cast<T>(_resources[std::type_index(typeid(T))][id]);
-
-		// If the asset is null, we can try finding it in the manifest to load it
-		if (result == nullptr) {
-			// Get the type name it'll be stored under
-			std::string typeName = StringTools::SanitizeClassName(typeid(T).name());
-
-			// If the manifest has an entry, we can load it!
-			if (_manifest[typeName].contains(id)) {
-				// Invoke the loader function with the manifest data
-				_typeLoaders[typeName](_manifest[typeName][id]);
-
-				// Search resources again to get the resource
-				return std::dynamic_pointer_cast<T>(_resources[std::type_index(typeid(T))][id]);
-			}
-		}
-
-		// If result wasn't null, or couldn't be found in the manifest, return here
-		return result;
+		ResourceEntry* entry = _GetEntry<T>(id);
+		return entry == nullptr ? nullptr : std::static_pointer_cast<T>(entry->Resource);
 	}
 
+	/// <summary>
+	/// Gets a number that changes whenever a resource is removed or replaced, so that cached
+	/// pointers to resources can tell when they need to be looked up again (see ResourceHandle)
+	/// </summary>
+	static uint32_t GetGeneration() { return _generation; }
+
 	/// <summary>
 	/// Registers a resource type with the resource manager, only types that have been registered
 	/// can be loaded from JSON manifest files!
@@ -84,16 +143,36 @@ public:
 	template <typename T, typename = std::enable_if<is_valid_resource<T>()>::type>
 	static void RegisterType() {
 		// Extract the type name from a sanitized version of they typeid name
-		std::string typeName = StringTools::SanitizeClassName(typeid(T).name());
+		const std::string& typeName = ResourceTypeInfo<T>::Name();
 
 		// Create the type loader for the type
 		_typeLoaders[typeName] = [](const nlohmann::json& data) {
 			IResource::Sptr res = T::FromJson(data);
 			res->OverrideGUID(Guid(data["guid"]));
-			_resources[std::type_index(typeid(T))][res->GetGUID()] = res;
+			res->ClearDirty();
+			_Store(ResourceTypeInfo<T>::Id, res->GetGUID(), res);
 			return res->GetGUID();
 		};
 
+		// Types can optionally split their loading, so that the parts that don't need a GL
+		// context (reading and decoding files) can be done on a worker thread
+		if constexpr (test_prepare_json<T, const nlohmann::json&, JobSystem*>::value) {
+			_typePreparers[typeName] = [](const nlohmann::json& data, JobSystem* jobs) -> FinishLoadFunc {
+				auto create = T::PrepareFromJson(data, jobs);
+				Guid guid = Guid(data["guid"]);
+				return [create, guid]() {
+					IResource::Sptr res = create();
+					if (res != nullptr) {
+						res->OverrideGUID(guid);
+						res->ClearDirty();
+						_Store(ResourceTypeInfo<T>::Id, guid, res);
+					}
+				};
+			};
+		}
+		_typeIds.emplace(typeName, ResourceTypeInfo<T>::Id);
+		_typeNames.emplace(ResourceTypeInfo<T>::Id, typeName);
+
 		// Make sure we haven't registered the type yet, then add an empty object
 		// to the manifest to ensure it can be saved
 		if (!_manifest.contains(typeName)) {
@@ -112,15 +191,12 @@ public:
 		typename = typename std::enable_if<std::is_base_of<IResource, ResourceType>::value>::type>
 		static void Each(std::function<void(const std::shared_ptr<ResourceType>&)> callback, bool includeDisabled = false) {
 
-		// We can use typeid and type_index to get a unique ID for our types
-		std::type_index type = std::type_index(typeid(ResourceType));
-
-		// Iterate over all the resources in the store
-		for (auto& [key, value] : _resources[type]) {
+		// Iterate over all the resources in the store, and pick out the ones with our type
+		for (auto& [key, entry] : _resources) {
 			// If the pointer is alive and matches our enabled criteria, invoke the callback
-			if (value != nullptr) {
+			if (key.Type == ResourceTypeInfo<ResourceType>::Id && entry.Resource != nullptr) {
 				// Upcast to resource type and invoke the callback
-				callback(std::dynamic_pointer_cast<ResourceType>(value));
+				callback(std::static_pointer_cast<ResourceType>(entry.Resource));
 			}
 		}
 	}
@@ -132,36 +208,327 @@ public:
 	/// <summary>
 	/// Loads a manifest file into the resource manager. Note that this will not perform load on the assets themselves 
 	/// unless preloadAssets is set to true
+	/// 
+	/// When a job system is given, assets are preloaded in parallel in dependency order (see ManifestPreloader),
+	/// otherwise they are loaded one at a time in manifest order
 	/// </summary>
 	/// <param name="path">The path to the JSON manifest file</param>
 	/// <param name="preloadAssets">True if all assets should be loaded into memory</param>
-	static void LoadManifest(const std::string& path, bool preloadAssets = false);
+	/// <param name="jobs">The job system to preload assets with, or nullptr to preload on the calling thread</param>
+	static void LoadManifest(const std::string& path, bool preloadAssets = false, JobSystem* jobs = nullptr);
 	/// <summary>
-	/// Saves the manifest to the given JSON file
+	/// Same as above, but takes a manifest that has already been parsed (ex: on a worker thread)
+	/// </summary>
+	/// <param name="manifest">The manifest to load</param>
+	/// <param name="preloadAssets">True if all assets should be loaded into memory</param>
+	/// <param name="jobs">The job system to preload assets with, or nullptr to preload on the calling thread</param>
+	static void LoadManifestFromJson(const nlohmann::ordered_json& manifest, bool preloadAssets = false, JobSystem* jobs = nullptr);
+
+	/// <summary>
+	/// Returns true if the resource with the given type name and GUID has been loaded
+	/// </summary>
+	/// <param name="typeName">The name of the resource type, as stored in the manifest</param>
+	/// <param name="id">The ID of the resource</param>
+	static bool IsLoaded(const std::string& typeName, Guid id);
+	/// <summary>
+	/// Prepares a manifest entry to be loaded. Types that define a static PrepareFromJson will
+	/// read and decode their data on the calling thread, which does not need to be the main
+	/// thread. All other types are loaded entirely by the returned function
+	/// </summary>
+	/// <param name="typeName">The name of the resource type, as stored in the manifest</param>
+	/// <param name="data">The manifest entry for the resource</param>
+	/// <param name="jobs">The job system that large resources may split their decoding between, or nullptr to decode on the calling thread</param>
+	/// <returns>A function that must be invoked on the main thread to create the resource, or nullptr if the type is not registered</returns>
+	static FinishLoadFunc PrepareLoad(const std::string& typeName, const nlohmann::json& data, JobSystem* jobs = nullptr);
+	/// <summary>
+	/// Saves the manifest to the given JSON file. Only resources that have changed since they
+	/// were last written to the manifest are serialized again (see IResource::IsDirty)
 	/// </summary>
 	/// <param name="path">The path to the file to output</param>
 	static void SaveManifest(const std::string& path);
 
+	/// <summary>
+	/// Sets the maximum amount of memory that resources of the given type should use. When a type
+	/// is over budget, the least recently used resources that nothing else is holding on to are
+	/// unloaded, and will be loaded again from the manifest the next time they are retrieved
+	/// </summary>
+	/// <param name="typeName">The name of the resource type, as stored in the manifest</param>
+	/// <param name="bytes">The budget in bytes, or 0 to remove the budget</param>
+	static void SetMemoryBudget(const std::string& typeName, size_t bytes);
+	/// <summary>
+	/// Gets the memory budget for the given resource type, or 0 if it does not have one
+	/// </summary>
+	static size_t GetMemoryBudget(const std::string& typeName);
+	/// <summary>
+	/// Gets the amount of memory that loaded resources of the given type were using when they were
+	/// last measured, in bytes (see ResourceManager::Update)
+	/// </summary>
+	static size_t GetMemoryUsage(const std::string& typeName);
+
+	/// <summary>
+	/// Counts the assets that CreateAsset returned instead of loading them again
+	/// </summary>
+	struct DedupStats {
+		size_t NumResources;
+		// The memory the duplicates would have used, in bytes
+		size_t NumBytes;
+	};
+	/// <summary>
+	/// Gets the number of duplicate assets that were avoided since the last call, and resets the count
+	/// </summary>
+	static DedupStats TakeDedupStats();
+
+	/// <summary>
+	/// Measures any resources that were added since the last update, and unloads resources from types
+	/// that are over their memory budget. Should be called once per frame on the main thread
+	/// </summary>
+	static void Update();
+
 	/// <summary>
 	/// Releases all resources held by the resource manager
 	/// </summary>
 	static void Cleanup();
 
 protected:
+	template <typename T>
+	friend class ResourceHandle;
+
+	/// <summary>
+	/// Identifies a single resource by it's type and GUID, so that all resources can
+	/// live in a single hash table
+	/// </summary>
+	struct ResourceKey {
+		ResourceTypeId Type;
+		Guid           Id;
+
+		bool operator ==(const ResourceKey& other) const { return Type == other.Type && Id == other.Id; }
+	};
+
+	struct ResourceKeyHash {
+		size_t operator()(const ResourceKey& key) const {
+			size_t seed = std::hash<Guid>()(key.Id);
+			return seed ^ (std::hash<ResourceTypeId>()(key.Type) + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+		}
+	};
+
+	struct ResourceEntry {
+		IResource::Sptr Resource;
+		// The value of _useCounter the last time the resource was retrieved
+		uint64_t        LastUsed;
+		// The total memory usage of the resource the last time it was measured, not including shared memory
+		size_t          MemoryUsage;
+		// The SharedKey the resource reported the last time it was measured, see ResourceMemoryUsage
+		uint64_t        SharedKey;
+	};
+
 	/// <summary>
-	/// This is a map of maps
-	/// The top level map uses type_index, so there's a map per resource type
-	/// The inner map handles mapping GUIDs to the corresponding resource
+	/// Stores all loaded resources, keyed by their type and GUID
 	/// </summary>
-	static std::map<std::type_index, std::map<Guid, IResource::Sptr>> _resources;
+	static std::unordered_map<ResourceKey, ResourceEntry, ResourceKeyHash> _resources;
+	/// <summary>
+	/// Bumped whenever a resource is removed or replaced, see GetGeneration
+	/// </summary>
+	static uint32_t _generation;
+	/// <summary>
+	/// Incremented every time a resource is retrieved, used to find the least recently used resources
+	/// </summary>
+	static uint64_t _useCounter;
+	/// <summary>
+	/// Resources that were added since the last update, they are measured in Update since most
+	/// resources are filled in after they are created
+	/// </summary>
+	static std::vector<ResourceKey> _unmeasured;
+	/// <summary>
+	/// The measured memory usage of each type of resource
+	/// </summary>
+	static std::unordered_map<ResourceTypeId, size_t> _memoryUsage;
+	struct SharedMemory {
+		size_t Bytes;
+		// The number of measured resources that reported this memory, it's counted until there are none left
+		size_t NumUsers;
+	};
+	/// <summary>
+	/// Memory that is shared between resources, by it's SharedKey, so that it's only counted once in _memoryUsage
+	/// </summary>
+	static std::unordered_map<uint64_t, SharedMemory> _sharedMemory;
+	struct MemoryBudget {
+		size_t Bytes;
+		// True if we've already warned that the type can't get under budget, so we don't warn every frame
+		bool   HasWarned;
+		// True if the last pass couldn't get under budget, we don't try again until the usage changes
+		// or one of the resources that were in use is let go, see _IsBudgetBlocked
+		bool   IsBlocked;
+		size_t BlockedUsage;
+		std::vector<ResourceKey> BlockedBy;
+	};
+	struct ContentKey {
+		ResourceTypeId Type;
+		std::string    Key;
+
+		bool operator ==(const ContentKey& other) const { return Type == other.Type && Key == other.Key; }
+	};
+	struct ContentKeyHash {
+		size_t operator()(const ContentKey& key) const {
+			size_t seed = std::hash<std::string>()(key.Key);
+			return seed ^ (std::hash<ResourceTypeId>()(key.Type) + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+		}
+	};
+	struct KeyedAsset {
+		Guid                  Id;
+		// The asset the key was made for, so that an asset that was unloaded and loaded again isn't mistaken for it
+		IResource::Wptr       Asset;
+		// The asset's content version when the key was made, if it has changed the key no longer describes it
+		uint32_t              ContentVersion;
+	};
+	/// <summary>
+	/// Maps the content keys of assets made with CreateAsset to the asset, see CreateAsset
+	/// </summary>
+	static std::unordered_map<ContentKey, KeyedAsset, ContentKeyHash> _contentKeys;
+	static DedupStats _dedupStats;
+
+	/// <summary>
+	/// Memory budgets by type name, so they may be set before the type is registered
+	/// </summary>
+	static std::map<std::string, MemoryBudget> _memoryBudgets;
 	/// <summary>
 	/// This map stores registered types, so we can load them from JSON files
 	/// </summary>
 	static std::map<std::string, std::function<Guid(const nlohmann::json&)>> _typeLoaders;
+	/// <summary>
+	/// Stores the optional split loaders for types that define PrepareFromJson, see PrepareLoad
+	/// </summary>
+	static std::map<std::string, std::function<FinishLoadFunc(const nlohmann::json&, JobSystem*)>> _typePreparers;
+	/// <summary>
+	/// Maps type names, as stored in the manifest, to their type ID and back again
+	/// </summary>
+	static std::map<std::string, ResourceTypeId> _typeIds;
+	static std::unordered_map<ResourceTypeId, std::string> _typeNames;
 
 	/// <summary>
 	/// We use an ORDERED JSON file to allow serializing types in the order they are registered.
 	/// This allows us to register dependencies before the dependent resource
 	/// </summary>
 	static nlohmann::ordered_json _manifest;
-};
\ No newline at end of file
+
+	/// <summary>
+	/// Finds the entry for a resource and marks it as used, loading the resource from the manifest
+	/// if it isn't loaded yet. Entries are always stored under their resource's own type
+	/// </summary>
+	/// <returns>The entry for the resource, or nullptr if it could not be found</returns>
+	template<typename T>
+	static ResourceEntry* _GetEntry(Guid id) {
+		auto it = _resources.find(ResourceKey{ ResourceTypeInfo<T>::Id, id });
+		if (it != _resources.end()) {
+			it->second.LastUsed = ++_useCounter;
+			return &it->second;
+		}
+
+		// If the manifest has an entry, we can load it! We search without operator[] so we don't insert anything
+		const std::string& typeName = ResourceTypeInfo<T>::Name();
+		auto type = _manifest.find(typeName);
+		if (type != _manifest.end() && type->is_object()) {
+			auto entry = type->find(id.str());
+			auto loader = _typeLoaders.find(typeName);
+			if (entry != type->end() && loader != _typeLoaders.end() && loader->second) {
+				// Invoke the loader function with the manifest data, then search resources again to get the resource
+				loader->second(*entry);
+				it = _resources.find(ResourceKey{ ResourceTypeInfo<T>::Id, id });
+				return it == _resources.end() ? nullptr : &it->second;
+			}
+		}
+
+		// Couldn't be found in the manifest either
+		return nullptr;
+	}
+
+	/// <summary>
+	/// Finds the entry for an asset that was made with a content key, if the asset is still loaded
+	/// and hasn't changed since the key was made
+	/// </summary>
+	/// <returns>The entry for the asset, or nullptr if the key no longer describes a loaded asset</returns>
+	static ResourceEntry* _FindKeyedAsset(ResourceTypeId type, const KeyedAsset& keyed);
+
+	/// <summary>
+	/// Adds a resource to the store, replacing any resource with the same type and GUID
+	/// </summary>
+	static void _Store(ResourceTypeId type, Guid id, const IResource::Sptr& resource);
+	/// <summary>
+	/// Measures a resource's memory usage and adds it to it's type's usage, replacing the last measurement
+	/// </summary>
+	static void _Measure(ResourceTypeId type, ResourceEntry& entry);
+	/// <summary>
+	/// Removes a resource's last measurement from it's type's usage. Shared memory is only removed once
+	/// the last resource that reported it is gone
+	/// </summary>
+	static void _Unmeasure(ResourceTypeId type, ResourceEntry& entry);
+	/// <summary>
+	/// Unloads the least recently used resources of the given type that can be reloaded, until
+	/// the type is within it's budget
+	/// </summary>
+	static void _EnforceBudget(ResourceTypeId type, MemoryBudget& budget);
+	/// <summary>
+	/// Returns true if nothing has changed since the last pass of _EnforceBudget failed to get the
+	/// type under budget, in which case another pass would fail the same way
+	/// </summary>
+	static bool _IsBudgetBlocked(ResourceTypeId type, const MemoryBudget& budget);
+	/// <summary>
+	/// Writes a resource to the manifest if it has changed, or if the manifest has no entry for it
+	/// </summary>
+	/// <returns>True if the resource was serialized</returns>
+	static bool _UpdateManifestEntry(const std::string& typeName, const IResource::Sptr& resource);
+};
+
+/// <summary>
+/// A lightweight reference to a resource by GUID, that caches the resource manager's entry for
+/// the resource once it has been looked up. The cache is only thrown away when a resource has
+/// been removed or replaced in the resource manager, so most accesses don't need to search at all
+///
+/// Like ResourceManager::Get, resolving a handle may load the resource from the manifest and
+/// marks the resource as used, so handles should only be resolved on the main thread. Handles
+/// do not keep their resource loaded, use Lock to hold on to it
+/// </summary>
+/// <typeparam name="T">The type of resource to reference</typeparam>
+template <typename T>
+class ResourceHandle {
+public:
+	ResourceHandle() : _id(Guid()), _entry(nullptr), _generation(0) {}
+	ResourceHandle(Guid id) : _id(id), _entry(nullptr), _generation(0) {}
+	// Only the GUID is taken, the resource may not be the one that the manager owns
+	ResourceHandle(const std::shared_ptr<T>& resource) :
+		_id(resource != nullptr ? resource->GetGUID() : Guid()),
+		_entry(nullptr),
+		_generation(0)
+	{ }
+
+	/// <summary>
+	/// Gets the GUID of the resource that this handle references
+	/// </summary>
+	Guid GetGUID() const { return _id; }
+
+	/// <summary>
+	/// Gets the resource, or nullptr if it does not exist. The pointer is owned by the
+	/// resource manager, use Lock if you need to hold on to it
+	/// </summary>
+	T* Get() const {
+		if (_entry == nullptr || _generation != ResourceManager::_generation) {
+			_entry = ResourceManager::_GetEntry<T>(_id);
+			_generation = ResourceManager::_generation;
+		} else {
+			// Keep the resource from looking unused to the memory budgets
+			_entry->LastUsed = ++ResourceManager::_useCounter;
+		}
+		return _entry == nullptr ? nullptr : static_cast<T*>(_entry->Resource.get());
+	}
+	/// <summary>
+	/// Gets a shared pointer to the resource, or nullptr if it does not exist
+	/// </summary>
+	std::shared_ptr<T> Lock() const { return ResourceManager::Get<T>(_id); }
+
+	T* operator->() const { return Get(); }
+	explicit operator bool() const { return Get() != nullptr; }
+
+private:
+	Guid                                    _id;
+	mutable ResourceManager::ResourceEntry* _entry;
+	mutable uint32_t                        _generation;
+};
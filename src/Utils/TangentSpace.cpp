@@ -0,0 +1,289 @@
+#include "Utils/TangentSpace.h"
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "Application/JobSystem.h"
+
+// Use SSE for the per triangle pass when the compiler is targeting it, everything has a scalar fallback
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define TANGENT_SPACE_SSE 1
+	#include <xmmintrin.h>
+#endif
+
+/// <summary>
+/// The vectors found for a triangle, or the sum of them for a vertex. The vertex pass reads these in a
+/// scattered order, so each triangle's vectors are kept together to make that one cache miss instead of several
+/// </summary>
+template <size_t Count>
+struct FaceVectors {
+	glm::vec3 Vectors[Count];
+
+	static FaceVectors Zero() {
+		FaceVectors result;
+		for (glm::vec3& vector : result.Vectors) {
+			vector = glm::vec3(0.0f);
+		}
+		return result;
+	}
+	void Add(const FaceVectors& other) {
+		for (size_t ix = 0; ix < Count; ix++) {
+			Vectors[ix] += other.Vectors[ix];
+		}
+	}
+};
+
+/// <summary>
+/// Lists the triangles that use each vertex. Each vertex's triangles are in the order they appear
+/// in the mesh, so sums over them are the same as adding the triangles to their vertices one by one
+/// </summary>
+struct VertexAdjacency {
+	std::vector<uint32_t> Start;
+	std::vector<uint32_t> Triangles;
+
+	VertexAdjacency(const uint32_t* indices, size_t triCount, size_t vertexCount) :
+		Start(vertexCount + 1, 0),
+		Triangles(triCount * 3)
+	{
+		for (size_t ix = 0; ix < triCount * 3; ix++) {
+			Start[indices[ix] + 1]++;
+		}
+		for (size_t ix = 0; ix < vertexCount; ix++) {
+			Start[ix + 1] += Start[ix];
+		}
+		std::vector<uint32_t> fill(Start.begin(), Start.end() - 1);
+		for (size_t ix = 0; ix < triCount * 3; ix++) {
+			Triangles[fill[indices[ix]]++] = static_cast<uint32_t>(ix / 3);
+		}
+	}
+};
+
+// Returns the vector with a length of 1, or zero if it has no length. This matches Normalize4 exactly
+static inline glm::vec3 NormalizeOrZero(const glm::vec3& value) {
+	float lengthSq = value.x * value.x + value.y * value.y + value.z * value.z;
+	return lengthSq > 0.0f ? value * (1.0f / std::sqrt(lengthSq)) : glm::vec3(0.0f);
+}
+
+// Returns true if every index refers to a vertex, so the passes can index arrays with them directly
+static bool IndicesInRange(const uint32_t* indices, size_t indexCount, size_t vertexCount) {
+	for (size_t ix = 0; ix < indexCount; ix++) {
+		if (indices[ix] >= vertexCount) {
+			return false;
+		}
+	}
+	return true;
+}
+
+#if TANGENT_SPACE_SSE
+// Loads one corner of 4 triangles, with each component in it's own register
+static inline void LoadCorners(const uint32_t* indices, size_t tri, int corner, const glm::vec3* positions, __m128& x, __m128& y, __m128& z) {
+	const glm::vec3& a = positions[indices[tri * 3 + corner]];
+	const glm::vec3& b = positions[indices[tri * 3 + 3 + corner]];
+	const glm::vec3& c = positions[indices[tri * 3 + 6 + corner]];
+	const glm::vec3& d = positions[indices[tri * 3 + 9 + corner]];
+	x = _mm_setr_ps(a.x, b.x, c.x, d.x);
+	y = _mm_setr_ps(a.y, b.y, c.y, d.y);
+	z = _mm_setr_ps(a.z, b.z, c.z, d.z);
+}
+static inline void LoadCorners(const uint32_t* indices, size_t tri, int corner, const glm::vec2* uvs, __m128& x, __m128& y) {
+	const glm::vec2& a = uvs[indices[tri * 3 + corner]];
+	const glm::vec2& b = uvs[indices[tri * 3 + 3 + corner]];
+	const glm::vec2& c = uvs[indices[tri * 3 + 6 + corner]];
+	const glm::vec2& d = uvs[indices[tri * 3 + 9 + corner]];
+	x = _mm_setr_ps(a.x, b.x, c.x, d.x);
+	y = _mm_setr_ps(a.y, b.y, c.y, d.y);
+}
+
+// Normalizes 4 vectors at once, vectors that have no length or that aren't valid become zero
+static inline void Normalize4(__m128& x, __m128& y, __m128& z, __m128 valid) {
+	__m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+	valid = _mm_and_ps(valid, _mm_cmpgt_ps(lengthSq, _mm_setzero_ps()));
+	// We need the full precision divide and square root here, _mm_rsqrt_ps is only good to about 12 bits
+	__m128 invLength = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(lengthSq));
+	x = _mm_and_ps(_mm_mul_ps(x, invLength), valid);
+	y = _mm_and_ps(_mm_mul_ps(y, invLength), valid);
+	z = _mm_and_ps(_mm_mul_ps(z, invLength), valid);
+}
+
+// Stores a vector for 4 triangles, going back from a register for each component to a vector for each triangle
+template <size_t Count>
+static inline void Store4(FaceVectors<Count>* faces, size_t vector, __m128 x, __m128 y, __m128 z) {
+	alignas(16) float values[3][4];
+	_mm_store_ps(values[0], x);
+	_mm_store_ps(values[1], y);
+	_mm_store_ps(values[2], z);
+	for (size_t ix = 0; ix < 4; ix++) {
+		faces[ix].Vectors[vector] = glm::vec3(values[0][ix], values[1][ix], values[2][ix]);
+	}
+}
+#endif
+
+// Finds the area weighted normal of every triangle in [begin, end), and stores them from the start of faces
+static void FindFaceNormals(const uint32_t* indices, const glm::vec3* positions, size_t begin, size_t end, FaceVectors<1>* faces) {
+	size_t tri = begin;
+	#if TANGENT_SPACE_SSE
+	for (; tri + 4 <= end; tri += 4) {
+		__m128 p0x, p0y, p0z, p1x, p1y, p1z, p2x, p2y, p2z;
+		LoadCorners(indices, tri, 0, positions, p0x, p0y, p0z);
+		LoadCorners(indices, tri, 1, positions, p1x, p1y, p1z);
+		LoadCorners(indices, tri, 2, positions, p2x, p2y, p2z);
+		__m128 d1x = _mm_sub_ps(p1x, p0x), d1y = _mm_sub_ps(p1y, p0y), d1z = _mm_sub_ps(p1z, p0z);
+		__m128 d2x = _mm_sub_ps(p2x, p0x), d2y = _mm_sub_ps(p2y, p0y), d2z = _mm_sub_ps(p2z, p0z);
+		Store4(faces + (tri - begin), 0,
+			_mm_sub_ps(_mm_mul_ps(d1y, d2z), _mm_mul_ps(d1z, d2y)),
+			_mm_sub_ps(_mm_mul_ps(d1z, d2x), _mm_mul_ps(d1x, d2z)),
+			_mm_sub_ps(_mm_mul_ps(d1x, d2y), _mm_mul_ps(d1y, d2x)));
+	}
+	#endif
+	for (; tri < end; tri++) {
+		const glm::vec3& p0 = positions[indices[tri * 3]];
+		glm::vec3 d1 = positions[indices[tri * 3 + 1]] - p0;
+		glm::vec3 d2 = positions[indices[tri * 3 + 2]] - p0;
+		faces[tri - begin].Vectors[0] = glm::vec3(d1.y * d2.z - d1.z * d2.y, d1.z * d2.x - d1.x * d2.z, d1.x * d2.y - d1.y * d2.x);
+	}
+}
+
+// Finds the tangent and bitangent of every triangle in [begin, end), and stores them from the start of faces
+// Each triangle's tangent and bitangent are the directions that it's U and V coordinates increase in
+// https://learnopengl.com/Advanced-Lighting/Normal-Mapping
+// We only need their directions, so rather than dividing by the UV determinant we just take it's sign
+static void FindFaceTangents(const uint32_t* indices, const glm::vec3* positions, const glm::vec2* uvs, size_t begin, size_t end, FaceVectors<2>* faces) {
+	size_t tri = begin;
+	#if TANGENT_SPACE_SSE
+	const __m128 signBit = _mm_set1_ps(-0.0f);
+	for (; tri + 4 <= end; tri += 4) {
+		__m128 p0x, p0y, p0z, p1x, p1y, p1z, p2x, p2y, p2z;
+		LoadCorners(indices, tri, 0, positions, p0x, p0y, p0z);
+		LoadCorners(indices, tri, 1, positions, p1x, p1y, p1z);
+		LoadCorners(indices, tri, 2, positions, p2x, p2y, p2z);
+		__m128 uv0x, uv0y, uv1x, uv1y, uv2x, uv2y;
+		LoadCorners(indices, tri, 0, uvs, uv0x, uv0y);
+		LoadCorners(indices, tri, 1, uvs, uv1x, uv1y);
+		LoadCorners(indices, tri, 2, uvs, uv2x, uv2y);
+
+		__m128 d1x = _mm_sub_ps(p1x, p0x), d1y = _mm_sub_ps(p1y, p0y), d1z = _mm_sub_ps(p1z, p0z);
+		__m128 d2x = _mm_sub_ps(p2x, p0x), d2y = _mm_sub_ps(p2y, p0y), d2z = _mm_sub_ps(p2z, p0z);
+		__m128 t1x = _mm_sub_ps(uv1x, uv0x), t1y = _mm_sub_ps(uv1y, uv0y);
+		__m128 t2x = _mm_sub_ps(uv2x, uv0x), t2y = _mm_sub_ps(uv2y, uv0y);
+
+		// Triangles with no UV area don't have a tangent, so they are left out
+		__m128 det = _mm_sub_ps(_mm_mul_ps(t1x, t2y), _mm_mul_ps(t1y, t2x));
+		__m128 valid = _mm_cmpneq_ps(det, _mm_setzero_ps());
+		__m128 sign = _mm_and_ps(det, signBit);
+
+		__m128 tx = _mm_xor_ps(_mm_sub_ps(_mm_mul_ps(d1x, t2y), _mm_mul_ps(d2x, t1y)), sign);
+		__m128 ty = _mm_xor_ps(_mm_sub_ps(_mm_mul_ps(d1y, t2y), _mm_mul_ps(d2y, t1y)), sign);
+		__m128 tz = _mm_xor_ps(_mm_sub_ps(_mm_mul_ps(d1z, t2y), _mm_mul_ps(d2z, t1y)), sign);
+		__m128 bx = _mm_xor_ps(_mm_sub_ps(_mm_mul_ps(d2x, t1x), _mm_mul_ps(d1x, t2x)), sign);
+		__m128 by = _mm_xor_ps(_mm_sub_ps(_mm_mul_ps(d2y, t1x), _mm_mul_ps(d1y, t2x)), sign);
+		__m128 bz = _mm_xor_ps(_mm_sub_ps(_mm_mul_ps(d2z, t1x), _mm_mul_ps(d1z, t2x)), sign);
+		Normalize4(tx, ty, tz, valid);
+		Normalize4(bx, by, bz, valid);
+		Store4(faces + (tri - begin), 0, tx, ty, tz);
+		Store4(faces + (tri - begin), 1, bx, by, bz);
+	}
+	#endif
+	for (; tri < end; tri++) {
+		const glm::vec3& p0 = positions[indices[tri * 3]];
+		const glm::vec2& uv0 = uvs[indices[tri * 3]];
+		glm::vec3 d1 = positions[indices[tri * 3 + 1]] - p0;
+		glm::vec3 d2 = positions[indices[tri * 3 + 2]] - p0;
+		glm::vec2 t1 = uvs[indices[tri * 3 + 1]] - uv0;
+		glm::vec2 t2 = uvs[indices[tri * 3 + 2]] - uv0;
+
+		FaceVectors<2>& face = faces[tri - begin];
+		float det = t1.x * t2.y - t1.y * t2.x;
+		if (det == 0.0f) {
+			face = FaceVectors<2>::Zero();
+			continue;
+		}
+		float sign = det < 0.0f ? -1.0f : 1.0f;
+		face.Vectors[0] = NormalizeOrZero((d1 * t2.y - d2 * t1.y) * sign);
+		face.Vectors[1] = NormalizeOrZero((d2 * t1.x - d1 * t2.x) * sign);
+	}
+}
+
+// Sums the vectors of the triangles around each vertex, and stores the normalized sums in outputs. findFaces
+// is called with ranges of triangles, and must store their vectors from the start of the array it's given
+template <size_t Count, typename FindFunc>
+static void SumAroundVertices(const uint32_t* indices, size_t triCount, size_t vertexCount, JobSystem* jobs, const FindFunc& findFaces, glm::vec3* const* outputs) {
+	auto store = [&](size_t vertex, const FaceVectors<Count>& sums) {
+		for (size_t ix = 0; ix < Count; ix++) {
+			outputs[ix][vertex] = NormalizeOrZero(sums.Vectors[ix]);
+		}
+	};
+
+	// On a single thread we can add the triangles straight to their vertices, which saves storing them
+	// and building the adjacency list. The triangles are added in order, so this gives the same sums
+	if (jobs == nullptr || jobs->NumThreads() <= 1 || triCount < TangentSpace::MinParallelTriangles) {
+		std::vector<FaceVectors<Count>> sums(vertexCount, FaceVectors<Count>::Zero());
+		FaceVectors<Count> block[256];
+		for (size_t begin = 0; begin < triCount; begin += 256) {
+			size_t end = std::min(begin + 256, triCount);
+			findFaces(begin, end, block);
+			for (size_t ix = 0; ix < (end - begin) * 3; ix++) {
+				sums[indices[begin * 3 + ix]].Add(block[ix / 3]);
+			}
+		}
+		for (size_t vertex = 0; vertex < vertexCount; vertex++) {
+			store(vertex, sums[vertex]);
+		}
+		return;
+	}
+
+	// Otherwise we find every triangle's vectors in parallel, then have each vertex gather them so that no two
+	// threads write to the same place. A few pieces for each thread keeps them all busy, even if some are slower
+	size_t grainSize = std::max<size_t>(1024, triCount / (static_cast<size_t>(jobs->NumThreads()) * 4));
+	grainSize = (grainSize + 3) & ~static_cast<size_t>(3);
+	std::vector<FaceVectors<Count>> faces(triCount);
+	JobSystem::JobHandle findJob = jobs->ParallelFor(triCount, grainSize, [&](size_t begin, size_t end) {
+		findFaces(begin, end, faces.data() + begin);
+	});
+
+	// The adjacency list only needs the indices, so we can build it while the triangles are being found
+	VertexAdjacency adjacency(indices, triCount, vertexCount);
+	jobs->Wait(findJob);
+
+	jobs->Wait(jobs->ParallelFor(vertexCount, std::max<size_t>(1024, vertexCount / (static_cast<size_t>(jobs->NumThreads()) * 4)), [&](size_t begin, size_t end) {
+		for (size_t vertex = begin; vertex < end; vertex++) {
+			FaceVectors<Count> sums = FaceVectors<Count>::Zero();
+			for (uint32_t adj = adjacency.Start[vertex]; adj < adjacency.Start[vertex + 1]; adj++) {
+				sums.Add(faces[adjacency.Triangles[adj]]);
+			}
+			store(vertex, sums);
+		}
+	}));
+}
+
+void TangentSpace::CalculateNormals(const uint32_t* indices, size_t indexCount, const glm::vec3* positions, size_t vertexCount,
+	glm::vec3* normals, JobSystem* jobs)
+{
+	std::fill(normals, normals + vertexCount, glm::vec3(0.0f));
+	const size_t triCount = indexCount / 3;
+	if (triCount == 0 || !IndicesInRange(indices, triCount * 3, vertexCount)) {
+		return;
+	}
+
+	// The cross product of two edges is as long as twice the triangle's area, so bigger triangles count for more
+	glm::vec3* outputs[1] = { normals };
+	SumAroundVertices<1>(indices, triCount, vertexCount, jobs, [&](size_t begin, size_t end, FaceVectors<1>* faces) {
+		FindFaceNormals(indices, positions, begin, end, faces);
+	}, outputs);
+}
+
+void TangentSpace::CalculateTangents(const uint32_t* indices, size_t indexCount, const glm::vec3* positions, const glm::vec2* uvs,
+	size_t vertexCount, glm::vec3* tangents, glm::vec3* bitangents, JobSystem* jobs)
+{
+	std::fill(tangents, tangents + vertexCount, glm::vec3(0.0f));
+	std::fill(bitangents, bitangents + vertexCount, glm::vec3(0.0f));
+	const size_t triCount = indexCount / 3;
+	if (triCount == 0 || !IndicesInRange(indices, triCount * 3, vertexCount)) {
+		return;
+	}
+
+	glm::vec3* outputs[2] = { tangents, bitangents };
+	SumAroundVertices<2>(indices, triCount, vertexCount, jobs, [&](size_t begin, size_t end, FaceVectors<2>* faces) {
+		FindFaceTangents(indices, positions, uvs, begin, end, faces);
+	}, outputs);
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <GLM/glm.hpp>
+
+class JobSystem;
+
+/// <summary>
+/// Generates smooth normals, tangents and bitangents for triangle lists
+///
+/// Each triangle's frame is found 4 triangles at a time with SSE when it's available. On one thread the
+/// frames are added straight to their vertices, on several threads they are stored and each vertex sums
+/// the frames around it using a vertex to triangle adjacency list. Every vertex only writes to itself, so
+/// neither pass needs any locking, and the result is the same no matter how many threads are used
+/// </summary>
+class TangentSpace {
+public:
+	/// <summary>
+	/// Meshes with fewer triangles than this are processed on the calling thread, since splitting
+	/// them up costs more than it saves
+	/// </summary>
+	static constexpr size_t MinParallelTriangles = 16384;
+
+	/// <summary>
+	/// Calculates smooth normals, by summing the area weighted normals of the triangles around each vertex
+	/// </summary>
+	/// <param name="indices">The triangle list indices</param>
+	/// <param name="indexCount">The number of indices, must be a multiple of 3</param>
+	/// <param name="positions">The position of each vertex</param>
+	/// <param name="vertexCount">The number of vertices</param>
+	/// <param name="normals">Receives the normal of each vertex, vertices without any triangles get a zero normal</param>
+	/// <param name="jobs">The job system to split large meshes between, or nullptr to use the calling thread</param>
+	static void CalculateNormals(const uint32_t* indices, size_t indexCount, const glm::vec3* positions, size_t vertexCount,
+		glm::vec3* normals, JobSystem* jobs = nullptr);
+
+	/// <summary>
+	/// Calculates tangents and bitangents from the positions and UVs, by averaging the directions of the
+	/// UV axes of the triangles around each vertex. Triangles with no UV area are skipped
+	/// </summary>
+	/// <param name="indices">The triangle list indices</param>
+	/// <param name="indexCount">The number of indices, must be a multiple of 3</param>
+	/// <param name="positions">The position of each vertex</param>
+	/// <param name="uvs">The texture coordinate of each vertex</param>
+	/// <param name="vertexCount">The number of vertices</param>
+	/// <param name="tangents">Receives the tangent of each vertex, vertices without any triangles get a zero tangent</param>
+	/// <param name="bitangents">Receives the bitangent of each vertex, vertices without any triangles get a zero bitangent</param>
+	/// <param name="jobs">The job system to split large meshes between, or nullptr to use the calling thread</param>
+	static void CalculateTangents(const uint32_t* indices, size_t indexCount, const glm::vec3* positions, const glm::vec2* uvs,
+		size_t vertexCount, glm::vec3* tangents, glm::vec3* bitangents, JobSystem* jobs = nullptr);
+
+protected:
+	TangentSpace() = default;
+	~TangentSpace() = default;
+};
@@ -11,4 +11,34 @@ namespace detail {
 } // detail::
 
 template<class T, class Arg>
-struct test_json : decltype(detail::test_json<T, Arg>(0)){};
\ No newline at end of file
+struct test_json : decltype(detail::test_json<T, Arg>(0)){};
+
+namespace detail {
+	template<class T, class A0>
+	static auto test_binary(int)->sfinae_true<decltype(T::FromBinary(std::declval<A0>()))>;
+	template<class, class A0>
+	static auto test_binary(long)->std::false_type;
+} // detail::
+
+template<class T, class Arg>
+struct test_binary : decltype(detail::test_binary<T, Arg>(0)){};
+
+namespace detail {
+	template<class T, class... Args>
+	static auto test_prepare_json(int)->sfinae_true<decltype(T::PrepareFromJson(std::declval<Args>()...))>;
+	template<class, class...>
+	static auto test_prepare_json(long)->std::false_type;
+} // detail::
+
+template<class T, class... Args>
+struct test_prepare_json : decltype(detail::test_prepare_json<T, Args...>(0)){};
+
+namespace detail {
+	template<class T, class... Args>
+	static auto test_content_key(int)->sfinae_true<decltype(T::GetContentKey(std::declval<Args>()...))>;
+	template<class, class...>
+	static auto test_content_key(long)->std::false_type;
+} // detail::
+
+template<class T, class... Args>
+struct test_content_key : decltype(detail::test_content_key<T, Args...>(0)){};
@@ -0,0 +1,303 @@
+#include "TestFramework.h"
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include "Gameplay/Scene.h"
+#include "Gameplay/Components/ComponentManager.h"
+#include "Gameplay/Components/Camera.h"
+#include "Gameplay/Components/Light.h"
+#include "Gameplay/Components/RotatingBehaviour.h"
+#include "Utils/BinaryStream.h"
+#include "Utils/MappedFile.h"
+
+using namespace Gameplay;
+
+// A component without binary hooks, so it's stored as encoded JSON inside it's block
+class JsonOnlyComponent : public IComponent {
+public:
+	typedef std::shared_ptr<JsonOnlyComponent> Sptr;
+
+	std::string Label;
+	float       Value = 0.0f;
+
+	virtual void RenderImGui() override {}
+	virtual nlohmann::json ToJson() const override {
+		return { { "label", Label }, { "value", Value } };
+	}
+	static JsonOnlyComponent::Sptr FromJson(const nlohmann::json& blob) {
+		JsonOnlyComponent::Sptr result = std::make_shared<JsonOnlyComponent>();
+		result->Label = blob["label"].get<std::string>();
+		result->Value = blob["value"].get<float>();
+		return result;
+	}
+	MAKE_TYPENAME(JsonOnlyComponent);
+};
+
+static void RegisterTestComponents() {
+	Tests::InitEngine();
+	ComponentManager::RegisterType<JsonOnlyComponent>();
+}
+
+static std::string TempPath(const std::string& name) {
+	return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static std::vector<uint8_t> ReadAll(const std::string& path) {
+	std::ifstream file(path, std::ios::binary);
+	return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static void WriteAll(const std::string& path, const std::vector<uint8_t>& data) {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+// Builds a scene with a hierarchy, native binary components and a component that falls back to JSON
+static Scene::Sptr BuildScene(size_t count) {
+	Scene::Sptr scene = std::make_shared<Scene>();
+	scene->SetAmbientLight(glm::vec3(0.2f, 0.3f, 0.4f));
+
+	GameObject::Sptr parent = nullptr;
+	for (size_t ix = 0; ix < count; ix++) {
+		GameObject::Sptr object = scene->CreateGameObject("Object " + std::to_string(ix));
+		object->SetPostion(glm::vec3(static_cast<float>(ix), -1.5f, 0.25f * ix));
+		object->SetRotation(glm::vec3(10.0f, 20.0f, static_cast<float>(ix % 360)));
+		object->SetScale(glm::vec3(1.0f + 0.01f * ix));
+		object->AlwaysLoaded = ix % 3 == 0;
+
+		// Every tenth object starts a new parent, the ones after it are it's children
+		if (ix % 10 == 0) {
+			parent = object;
+		} else {
+			parent->AddChild(object);
+		}
+
+		if (ix % 2 == 0) {
+			object->Add<RotatingBehaviour>()->RotationSpeed = glm::vec3(0.0f, 0.0f, 5.0f + ix);
+		}
+		if (ix % 5 == 0) {
+			Light::Sptr light = object->Add<Light>();
+			light->SetColor(glm::vec3(1.0f, 0.5f, 0.25f));
+			light->SetRadius(3.0f + ix);
+			light->SetIntensity(0.5f);
+		}
+		if (ix % 7 == 0) {
+			JsonOnlyComponent::Sptr note = object->Add<JsonOnlyComponent>();
+			note->Label = "note " + std::to_string(ix);
+			note->Value = ix * 0.5f;
+		}
+	}
+	return scene;
+}
+
+TEST_CASE(BinaryStream_RoundTrip) {
+	BinaryWriter writer;
+	writer.Write<uint32_t>(0xDEADBEEF);
+	writer.Write(glm::vec3(1.0f, 2.0f, 3.0f));
+	writer.WriteString("hello");
+	writer.WriteString("world");
+	writer.WriteString("hello");
+	Guid id = Guid::New();
+	writer.WriteGuid(id);
+	writer.WriteGuid(id);
+	size_t offset = writer.Position();
+	writer.Write<int32_t>(0);
+	writer.Patch<int32_t>(offset, -42);
+
+	// Strings and GUIDs are interned, repeats share an index
+	CHECK(writer.Strings().size() == 2);
+	CHECK(writer.Guids().size() == 1);
+
+	std::vector<std::string_view> strings(writer.Strings().begin(), writer.Strings().end());
+	BinaryReader reader(writer.Data().data(), writer.Data().size(), &strings, &writer.Guids());
+	CHECK(reader.Read<uint32_t>() == 0xDEADBEEF);
+	CHECK(reader.Read<glm::vec3>() == glm::vec3(1.0f, 2.0f, 3.0f));
+	CHECK(reader.ReadString() == "hello");
+	CHECK(reader.ReadString() == "world");
+	CHECK(reader.ReadString() == "hello");
+	CHECK(reader.ReadGuid() == id);
+	CHECK(reader.ReadGuid() == id);
+	CHECK(reader.Read<int32_t>() == -42);
+	CHECK(reader.Remaining() == 0);
+	CHECK(reader.IsValid());
+}
+
+TEST_CASE(BinaryStream_ReadsOutOfBoundsFail) {
+	BinaryWriter writer;
+	writer.Write<uint16_t>(7);
+	writer.Write<uint32_t>(5); // Not a valid string index
+
+	// Reading past the end fails and returns a default value
+	BinaryReader shortReader(writer.Data().data(), 2);
+	CHECK(shortReader.Read<uint16_t>() == 7);
+	CHECK(shortReader.Read<uint32_t>() == 0);
+	CHECK(!shortReader.IsValid());
+	CHECK(shortReader.ReadSpan(1) == nullptr);
+
+	// So does looking up an index that isn't in the table
+	std::vector<std::string_view> strings = { "only" };
+	BinaryReader reader(writer.Data().data(), writer.Data().size(), &strings);
+	reader.Skip(2);
+	CHECK(reader.ReadString().empty());
+	CHECK(!reader.IsValid());
+
+	// Skipping past the end fails too
+	BinaryReader skipper(writer.Data().data(), writer.Data().size());
+	skipper.Skip(writer.Data().size() + 1);
+	CHECK(!skipper.IsValid());
+}
+
+TEST_CASE(MappedFile_MapsContents) {
+	std::string path = TempPath("mapped_file_test.bin");
+	std::vector<uint8_t> data(4096 * 3 + 17);
+	for (size_t ix = 0; ix < data.size(); ix++) {
+		data[ix] = static_cast<uint8_t>(ix * 31);
+	}
+	WriteAll(path, data);
+
+	{
+		MappedFile file(path);
+		REQUIRE(file.IsOpen());
+		CHECK(file.Size() == data.size());
+		CHECK(memcmp(file.Data(), data.data(), data.size()) == 0);
+	}
+
+	MappedFile missing(TempPath("mapped_file_test_missing.bin"));
+	CHECK(!missing.IsOpen());
+	CHECK(missing.Data() == nullptr);
+	std::filesystem::remove(path);
+}
+
+TEST_CASE(BinaryScene_RoundTripMatchesSource) {
+	RegisterTestComponents();
+	const size_t count = 200;
+	Scene::Sptr source = BuildScene(count);
+	std::string path = TempPath("binary_scene_test.bscene");
+	source->SaveBinary(path);
+
+	Scene::Sptr loaded = Scene::LoadBinary(path);
+	REQUIRE(loaded != nullptr);
+	REQUIRE(loaded->NumObjects() == source->NumObjects());
+	CHECK(loaded->GetAmbientLight() == source->GetAmbientLight());
+	REQUIRE(loaded->MainCamera != nullptr);
+	CHECK(loaded->MainCamera->GetGameObject()->GetGUID() == source->MainCamera->GetGameObject()->GetGUID());
+
+	int wrongObjects = 0;
+	int wrongComponents = 0;
+	for (int ix = 0; ix < source->NumObjects(); ix++) {
+		GameObject::Sptr expected = source->GetObjectByIndex(ix);
+		GameObject::Sptr actual = loaded->FindObjectByGUID(expected->GetGUID());
+		if (actual == nullptr) {
+			wrongObjects++;
+			continue;
+		}
+
+		bool sameParent = (expected->GetParent() == nullptr) == (actual->GetParent() == nullptr) &&
+			(expected->GetParent() == nullptr || expected->GetParent()->GetGUID() == actual->GetParent()->GetGUID());
+		if (actual->Name != expected->Name || !sameParent || actual->AlwaysLoaded != expected->AlwaysLoaded ||
+			actual->GetPosition() != expected->GetPosition() ||
+			actual->GetRotation() != expected->GetRotation() ||
+			actual->GetScale() != expected->GetScale()) {
+			wrongObjects++;
+		}
+
+		// Native binary components
+		RotatingBehaviour::Sptr rotating = expected->Get<RotatingBehaviour>();
+		if (rotating != nullptr && (actual->Get<RotatingBehaviour>() == nullptr || actual->Get<RotatingBehaviour>()->RotationSpeed != rotating->RotationSpeed)) {
+			wrongComponents++;
+		}
+		Light::Sptr light = expected->Get<Light>();
+		Light::Sptr loadedLight = actual->Get<Light>();
+		if (light != nullptr && (loadedLight == nullptr || loadedLight->GetColor() != light->GetColor() ||
+			loadedLight->GetRadius() != light->GetRadius() || loadedLight->GetIntensity() != light->GetIntensity())) {
+			wrongComponents++;
+		}
+
+		// Components that fall back to JSON
+		JsonOnlyComponent::Sptr note = expected->Get<JsonOnlyComponent>();
+		JsonOnlyComponent::Sptr loadedNote = actual->Get<JsonOnlyComponent>();
+		if ((note == nullptr) != (loadedNote == nullptr) || (note != nullptr && (loadedNote->Label != note->Label || loadedNote->Value != note->Value))) {
+			wrongComponents++;
+		}
+	}
+	CHECK(wrongObjects == 0);
+	CHECK(wrongComponents == 0);
+	std::filesystem::remove(path);
+}
+
+TEST_CASE(BinaryScene_RejectsOtherVersionsAndGarbage) {
+	RegisterTestComponents();
+	std::string path = TempPath("binary_scene_version_test.bscene");
+	BuildScene(20)->SaveBinary(path);
+	std::vector<uint8_t> valid = ReadAll(path);
+	REQUIRE(valid.size() > 8);
+
+	// The version follows the magic number in the header
+	std::vector<uint8_t> data = valid;
+	data[4]++;
+	WriteAll(path, data);
+	CHECK(Scene::LoadBinary(path) == nullptr);
+
+	data = valid;
+	data[0] = 'X';
+	WriteAll(path, data);
+	CHECK(Scene::LoadBinary(path) == nullptr);
+
+	WriteAll(path, std::vector<uint8_t>(3, 0));
+	CHECK(Scene::LoadBinary(path) == nullptr);
+
+	std::filesystem::remove(path);
+	CHECK(Scene::LoadBinary(path) == nullptr);
+}
+
+TEST_CASE(BinaryScene_SurvivesTruncationAndCorruption) {
+	RegisterTestComponents();
+	std::string path = TempPath("binary_scene_fuzz_test.bscene");
+	BuildScene(50)->SaveBinary(path);
+	std::vector<uint8_t> valid = ReadAll(path);
+	REQUIRE(!valid.empty());
+
+	// Every truncated file has to be rejected, not crash or loop forever
+	int truncatedLoads = 0;
+	for (size_t size = 0; size < valid.size(); size += 1 + valid.size() / 300) {
+		WriteAll(path, std::vector<uint8_t>(valid.begin(), valid.begin() + size));
+		truncatedLoads += Scene::LoadBinary(path) != nullptr ? 1 : 0;
+	}
+	CHECK(truncatedLoads == 0);
+
+	// Random byte flips may still produce a loadable scene (ex: a flipped float), but never a crash
+	std::mt19937 random(1234);
+	std::uniform_int_distribution<size_t> offsets(0, valid.size() - 1);
+	std::uniform_int_distribution<int> bytes(0, 255);
+	int loaded = 0;
+	for (int round = 0; round < 300; round++) {
+		std::vector<uint8_t> data = valid;
+		int flips = 1 + round % 8;
+		for (int ix = 0; ix < flips; ix++) {
+			data[offsets(random)] = static_cast<uint8_t>(bytes(random));
+		}
+		WriteAll(path, data);
+		loaded += Scene::LoadBinary(path) != nullptr ? 1 : 0;
+	}
+	Tests::Report("Corrupted binary scenes that still loaded", loaded, "of 300");
+
+	std::filesystem::remove(path);
+}
+
+TEST_CASE(BinaryScene_BenchmarkBinaryVsJson) {
+	RegisterTestComponents();
+	const size_t count = 50000;
+	Scene::Sptr scene = BuildScene(count);
+	std::string binaryPath = TempPath("binary_scene_bench.bscene");
+	scene->SaveBinary(binaryPath);
+	nlohmann::json blob = scene->ToJson();
+
+	double binaryMs = Tests::TimeMs([&]() { Scene::LoadBinary(binaryPath); }, 3);
+	double jsonMs = Tests::TimeMs([&]() { Scene::FromJson(blob); }, 3);
+	Tests::Report("50k objects, LoadBinary", binaryMs);
+	Tests::Report("50k objects, FromJson (already parsed)", jsonMs);
+	Tests::Report("50k objects, speedup", jsonMs / binaryMs, "x");
+	std::filesystem::remove(binaryPath);
+}
@@ -0,0 +1,214 @@
+#include "TestFramework.h"
+
+#include <filesystem>
+#include <map>
+#include <random>
+#include <stdexcept>
+
+#include "Utils/Base64.h"
+#include "Utils/BlobStore.h"
+
+static std::string RandomBytes(std::mt19937& rng, size_t size) {
+	std::string result(size, '\0');
+	std::uniform_int_distribution<int> byte(0, 255);
+	for (char& c : result) {
+		c = static_cast<char>(byte(rng));
+	}
+	return result;
+}
+
+// Mostly small sizes that land on every remainder of the vector loops, with the odd large one
+static size_t RandomSize(std::mt19937& rng, int iteration) {
+	if (iteration % 50 == 0) {
+		return std::uniform_int_distribution<size_t>(1000, 20000)(rng);
+	}
+	return std::uniform_int_distribution<size_t>(0, 200)(rng);
+}
+
+TEST_CASE(Base64_RoundTripFuzz) {
+	std::mt19937 rng(1234);
+	size_t wrongSize = 0;
+	size_t wrongChars = 0;
+	size_t mismatches = 0;
+	for (int ix = 0; ix < 2000; ix++) {
+		std::string data = RandomBytes(rng, RandomSize(rng, ix));
+		for (bool urlEncode : { false, true }) {
+			for (bool includeTrailing : { false, true }) {
+				std::string encoded = Base64::Encode(data.data(), data.size(), urlEncode, includeTrailing);
+				wrongSize += encoded.size() != Base64::GetEncodedSize(data.size(), includeTrailing) ? 1 : 0;
+				wrongChars += !Base64::IsBase64(encoded) ? 1 : 0;
+				mismatches += Base64::Decode(encoded) != data ? 1 : 0;
+			}
+		}
+	}
+	CHECK(wrongSize == 0);
+	CHECK(wrongChars == 0);
+	CHECK(mismatches == 0);
+}
+
+TEST_CASE(Base64_RejectsCorruptInputFuzz) {
+	std::mt19937 rng(5678);
+	const std::string invalid = "!@#$%^&*() \t\n\x80\xff\"\\";
+	size_t accepted = 0;
+	for (int ix = 0; ix < 2000; ix++) {
+		std::string data = RandomBytes(rng, RandomSize(rng, ix) + 1);
+		std::string encoded = Base64::Encode(data.data(), data.size());
+
+		// Anywhere in the string, so that both the vector and scalar paths see bad characters
+		size_t pos = std::uniform_int_distribution<size_t>(0, encoded.size() - 1)(rng);
+		encoded[pos] = invalid[std::uniform_int_distribution<size_t>(0, invalid.size() - 1)(rng)];
+		CHECK(!Base64::IsBase64(encoded));
+		try {
+			Base64::Decode(encoded);
+			accepted++;
+		} catch (const std::runtime_error&) {
+			// Expected
+		}
+	}
+	CHECK(accepted == 0);
+
+	// A single character left over can't hold a whole byte
+	bool threw = false;
+	try {
+		Base64::Decode("QUJDR");
+	} catch (const std::runtime_error&) {
+		threw = true;
+	}
+	CHECK(threw);
+}
+
+TEST_CASE(BlobStore_RoundTripFuzz) {
+	std::filesystem::path folder = std::filesystem::temp_directory_path() / "blob_store_test";
+	std::filesystem::remove_all(folder);
+	std::filesystem::create_directories(folder);
+	std::string path = (folder / "fuzz-blobs.bin").string();
+
+	size_t threshold = BlobStore::SidecarThreshold;
+	BlobStore::SidecarThreshold = 256;
+
+	// Written over a few sessions, since the sidecar is appended to by every save
+	std::mt19937 rng(91011);
+	std::vector<std::string> payloads;
+	std::vector<nlohmann::json> blobs;
+	for (int session = 0; session < 3; session++) {
+		BlobStore::BeginWrite(path);
+		REQUIRE(BlobStore::IsWriting());
+		for (int ix = 0; ix < 100; ix++) {
+			payloads.push_back(RandomBytes(rng, std::uniform_int_distribution<size_t>(0, 2000)(rng)));
+			blobs.push_back(BlobStore::Write(payloads.back().data(), payloads.back().size()));
+		}
+		BlobStore::EndWrite();
+	}
+
+	size_t numInline = 0;
+	size_t numSidecar = 0;
+	size_t mismatches = 0;
+	for (size_t ix = 0; ix < payloads.size(); ix++) {
+		CHECK(BlobStore::IsBlob(blobs[ix]));
+		numInline += blobs[ix].is_string() ? 1 : 0;
+		numSidecar += blobs[ix].is_object() ? 1 : 0;
+		mismatches += BlobStore::Read(blobs[ix]) != payloads[ix] ? 1 : 0;
+	}
+	CHECK(numInline > 0);
+	CHECK(numSidecar > 0);
+	CHECK(mismatches == 0);
+
+	// References past the end of the file must fail instead of reading garbage
+	nlohmann::json outside = nlohmann::json::object();
+	outside["blob"] = path;
+	outside["offset"] = std::filesystem::file_size(path);
+	outside["length"] = 1;
+	bool threw = false;
+	try {
+		BlobStore::Read(outside);
+	} catch (const std::runtime_error&) {
+		threw = true;
+	}
+	CHECK(threw);
+
+	BlobStore::SidecarThreshold = threshold;
+	std::filesystem::remove_all(folder);
+}
+
+TEST_CASE(BlobStore_CompactDropsUnreferencedData) {
+	std::filesystem::path folder = std::filesystem::temp_directory_path() / "blob_store_compact_test";
+	std::filesystem::remove_all(folder);
+	std::filesystem::create_directories(folder);
+	std::string path = (folder / "manifest-blobs.bin").string();
+
+	size_t threshold = BlobStore::SidecarThreshold;
+	BlobStore::SidecarThreshold = 16;
+
+	// Stand in for a manifest, each save re-serializes some of the entries
+	std::mt19937 rng(1213);
+	std::map<std::string, std::string> payloads;
+	nlohmann::ordered_json document;
+	auto save = [&](const std::vector<std::string>& changed) {
+		BlobStore::BeginWrite(path);
+		for (const std::string& name : changed) {
+			payloads[name] = RandomBytes(rng, 1000);
+			document["textures"][name]["data"] = BlobStore::Write(payloads[name].data(), payloads[name].size());
+		}
+		BlobStore::EndWrite();
+	};
+	auto countMismatches = [&]() {
+		size_t result = 0;
+		for (const auto& [name, payload] : payloads) {
+			result += BlobStore::Read(document["textures"][name]["data"]) != payload ? 1 : 0;
+		}
+		return result;
+	};
+
+	save({ "a", "b", "c", "d" });
+	CHECK(BlobStore::Compact(path, document) == 0);
+
+	// A fifth of the file is dead, which is under the threshold
+	save({ "a" });
+	CHECK(BlobStore::Compact(path, document) == 0);
+	CHECK(std::filesystem::file_size(path) == 5000);
+
+	// Forcing it reclaims the dead data, and everything still reads back
+	CHECK(BlobStore::Compact(path, document, true) == 1000);
+	CHECK(std::filesystem::file_size(path) == 4000);
+	CHECK(countMismatches() == 0);
+
+	// Copies of a reference only keep their data once, and are all pointed at the new location
+	document["copy"] = document["textures"]["d"]["data"];
+	save({ "a", "b", "c" });
+	CHECK(BlobStore::Compact(path, document) == 0);
+	save({ "a", "b", "c" });
+	CHECK(BlobStore::Compact(path, document) == 6000);
+	CHECK(std::filesystem::file_size(path) == 4000);
+	CHECK(countMismatches() == 0);
+	CHECK(BlobStore::Read(document["copy"]) == payloads["d"]);
+	CHECK(!std::filesystem::exists(path + ".tmp"));
+
+	// References to other files are left alone
+	document.erase("copy");
+	document["other"] = { { "blob", "other-blobs.bin" }, { "offset", 123 }, { "length", 4 } };
+	save({ "a", "b", "c", "d" });
+	CHECK(BlobStore::Compact(path, document, true) == 4000);
+	CHECK(document["other"]["offset"] == 123);
+	CHECK(countMismatches() == 0);
+
+	BlobStore::SidecarThreshold = threshold;
+	std::filesystem::remove_all(folder);
+}
+
+TEST_CASE(Base64_BenchmarkThroughput) {
+	std::mt19937 rng(1415);
+	const size_t size = 16 * 1024 * 1024;
+	std::string data = RandomBytes(rng, size);
+
+	std::string encoded;
+	double encodeMs = Tests::TimeMs([&]() { encoded = Base64::Encode(data.data(), data.size()); }, 5);
+	std::string decoded;
+	double decodeMs = Tests::TimeMs([&]() { decoded = Base64::Decode(encoded); }, 5);
+	CHECK(decoded == data);
+
+	const double sizeMb = size / (1024.0 * 1024.0);
+	Tests::Report("Base64 Encode, 16MB", encodeMs);
+	Tests::Report("Base64 Encode throughput", sizeMb / (encodeMs / 1000.0), "MB/s");
+	Tests::Report("Base64 Decode, 16MB", decodeMs);
+	Tests::Report("Base64 Decode throughput", sizeMb / (decodeMs / 1000.0), "MB/s");
+}
@@ -0,0 +1,257 @@
+#include "TestFramework.h"
+
+#include <filesystem>
+#include <fstream>
+#include <BulletCollision/CollisionShapes/btTriangleMesh.h>
+
+#include "Gameplay/Scene.h"
+#include "Gameplay/MeshResource.h"
+#include "Gameplay/Components/RenderComponent.h"
+#include "Gameplay/Physics/Colliders/ConvexMeshCollider.h"
+#include "Graphics/ShaderProgram.h"
+#include "Utils/MeshSimplifier.h"
+#include "Utils/ObjLoader.h"
+#include "Utils/OptimizedObjLoader.h"
+
+using namespace Gameplay;
+
+// Grids on either side of the most vertices that 16 bit indices can address
+struct IndexWidthCase {
+	const char* Name;
+	int         QuadsX;
+	int         QuadsY;
+	IndexType   Expected;
+};
+static const IndexWidthCase IndexWidthCases[] = {
+	{ "16 bit", 255, 255, IndexType::UShort }, // 65536 vertices
+	{ "32 bit", 256, 255, IndexType::UInt },   // 65792 vertices
+};
+
+// A flat grid with one unit per quad, split into two submeshes, with a level of detail
+static MeshBuilder<VertexPosNormTexCol> BuildGrid(int quadsX, int quadsY) {
+	MeshBuilder<VertexPosNormTexCol> result;
+	for (int y = 0; y <= quadsY; y++) {
+		for (int x = 0; x <= quadsX; x++) {
+			result.AddVertex(glm::vec3(x, y, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec2(x, y) / glm::vec2(quadsX, quadsY), glm::vec4(1.0f));
+		}
+	}
+	for (int y = 0; y < quadsY; y++) {
+		for (int x = 0; x < quadsX; x++) {
+			uint32_t corner = y * (quadsX + 1) + x;
+			result.AddIndexTri(corner, corner + 1, corner + quadsX + 2);
+			result.AddIndexTri(corner, corner + quadsX + 2, corner + quadsX + 1);
+		}
+	}
+	uint32_t half = static_cast<uint32_t>(result.GetIndexCount() / 2 / 3 * 3);
+	result.AddSubmesh(0, half, 0);
+	result.AddSubmesh(half, static_cast<uint32_t>(result.GetIndexCount()) - half, 1);
+	MeshSimplifier::GenerateLods(result, "grid", 1);
+	return result;
+}
+
+// Writes the same grid as BuildGrid as an OBJ file, without the submeshes
+static void WriteGridObj(const std::string& path, int quadsX, int quadsY) {
+	std::ofstream file(path);
+	for (int y = 0; y <= quadsY; y++) {
+		for (int x = 0; x <= quadsX; x++) {
+			file << "v " << x << " " << y << " 0\n";
+		}
+	}
+	for (int y = 0; y < quadsY; y++) {
+		for (int x = 0; x < quadsX; x++) {
+			// OBJ indices start at 1
+			int corner = y * (quadsX + 1) + x + 1;
+			file << "f " << corner << " " << corner + 1 << " " << corner + quadsX + 2 << " " << corner + quadsX + 1 << "\n";
+		}
+	}
+}
+
+// Reads an index buffer back from OpenGL, widening the indices to 32 bits
+static std::vector<uint32_t> ReadIndices(const IndexBuffer::Sptr& buffer) {
+	std::vector<uint8_t> data(buffer->GetTotalSize());
+	glGetNamedBufferSubData(buffer->GetHandle(), 0, data.size(), data.data());
+	std::vector<uint32_t> result(buffer->GetElementCount());
+	for (size_t ix = 0; ix < result.size(); ix++) {
+		switch (buffer->GetElementType()) {
+			case IndexType::UByte:
+				result[ix] = data[ix];
+				break;
+			case IndexType::UShort:
+				result[ix] = reinterpret_cast<const uint16_t*>(data.data())[ix];
+				break;
+			default:
+				result[ix] = reinterpret_cast<const uint32_t*>(data.data())[ix];
+				break;
+		}
+	}
+	return result;
+}
+
+// Counts the triangles that OpenGL actually draws in func
+template <typename Func>
+static GLuint CountTrianglesDrawn(Func&& func) {
+	GLuint query = 0;
+	glGenQueries(1, &query);
+	glBeginQuery(GL_PRIMITIVES_GENERATED, query);
+	func();
+	glEndQuery(GL_PRIMITIVES_GENERATED);
+	GLuint result = 0;
+	glGetQueryObjectuiv(query, GL_QUERY_RESULT, &result);
+	glDeleteQueries(1, &query);
+	return result;
+}
+
+// A shader that only needs positions, so any of our meshes can be drawn with it
+static ShaderProgram::Sptr GetPositionShader() {
+	static ShaderProgram::Sptr result = nullptr;
+	if (result == nullptr) {
+		result = ShaderProgram::Create();
+		result->LoadShaderPart(R"LIT(#version 450
+			layout (location = 0) in vec3 inPosition;
+			void main() {
+				gl_Position = vec4(inPosition * 0.001, 1.0);
+			}
+		)LIT", ShaderPartType::Vertex);
+		result->LoadShaderPart(R"LIT(#version 450
+			layout (location = 0) out vec4 outColor;
+			void main() {
+				outColor = vec4(1.0);
+			}
+		)LIT", ShaderPartType::Fragment);
+		result->Link();
+	}
+	return result;
+}
+
+// Checks that a VAO has the index type we expect, the same indices as the mesh it was made from, and draws all of them
+template <typename VertexType>
+static void CheckIndices(const VertexArrayObject::Sptr& vao, const MeshBuilder<VertexType>& mesh, IndexType expected) {
+	REQUIRE(vao != nullptr);
+	IndexBuffer::Sptr indices = vao->GetIndexBuffer();
+	REQUIRE(indices != nullptr);
+	CHECK(indices->GetElementType() == expected);
+	CHECK(indices->GetElementSize() == GetIndexTypeSize(expected));
+	CHECK(indices->GetTotalSize() == mesh.GetIndexCount() * GetIndexTypeSize(expected));
+	std::vector<uint32_t> readBack = ReadIndices(indices);
+	CHECK(readBack.size() == mesh.GetIndexCount());
+	CHECK(std::equal(readBack.begin(), readBack.end(), mesh.GetIndexDataPtr()));
+
+	// Every level of detail shares the vertices, so they need the same index type
+	REQUIRE(vao->GetLods().size() == mesh.GetLods().size());
+	for (size_t ix = 0; ix < mesh.GetLods().size(); ix++) {
+		const MeshLod& lod = mesh.GetLods()[ix];
+		IndexBuffer::Sptr lodIndices = vao->GetLods()[ix].Mesh->GetIndexBuffer();
+		REQUIRE(lodIndices != nullptr);
+		CHECK(lodIndices->GetElementType() == expected);
+		std::vector<uint32_t> lodReadBack = ReadIndices(lodIndices);
+		CHECK(lodReadBack.size() == lod.IndexCount);
+		CHECK(std::equal(lodReadBack.begin(), lodReadBack.end(), mesh.GetLodIndices().begin() + lod.FirstIndex));
+	}
+
+	GetPositionShader()->Bind();
+	const GLuint triangles = static_cast<GLuint>(mesh.GetIndexCount() / 3);
+	CHECK(CountTrianglesDrawn([&]() { vao->Draw(); }) == triangles);
+	CHECK(CountTrianglesDrawn([&]() { vao->DrawInstanced(2); }) == triangles * 2);
+	for (const Submesh& submesh : vao->GetSubmeshes()) {
+		vao->Bind();
+		CHECK(CountTrianglesDrawn([&]() { vao->DrawRange(submesh.FirstIndex, submesh.IndexCount); }) == submesh.IndexCount / 3);
+		VertexArrayObject::Unbind();
+	}
+}
+
+// Collects the triangles that bullet was given
+struct TriangleCollector : public btInternalTriangleIndexCallback {
+	std::vector<glm::vec3> Corners;
+
+	virtual void internalProcessTriangleIndex(btVector3* triangle, int partId, int triangleIndex) override {
+		for (int ix = 0; ix < 3; ix++) {
+			Corners.push_back(glm::vec3(triangle[ix].x(), triangle[ix].y(), triangle[ix].z()));
+		}
+	}
+};
+
+TEST_CASE(IndexBuffer_PicksSmallestType) {
+	CHECK(IndexBuffer::GetSmallestType(0) == IndexType::UShort);
+	CHECK(IndexBuffer::GetSmallestType(65536) == IndexType::UShort);
+	CHECK(IndexBuffer::GetSmallestType(65537) == IndexType::UInt);
+	CHECK(IndexBuffer::GetSmallestType(1 << 24) == IndexType::UInt);
+
+	const uint32_t indices[] = { 0, 1, 255, 256, 65534, 65535 };
+	std::vector<uint8_t> shorts = IndexBuffer::ConvertIndices(indices, 6, IndexType::UShort);
+	REQUIRE(shorts.size() == 6 * sizeof(uint16_t));
+	std::vector<uint8_t> ints = IndexBuffer::ConvertIndices(indices, 6, IndexType::UInt);
+	REQUIRE(ints.size() == 6 * sizeof(uint32_t));
+	for (size_t ix = 0; ix < 6; ix++) {
+		CHECK(reinterpret_cast<const uint16_t*>(shorts.data())[ix] == indices[ix]);
+		CHECK(reinterpret_cast<const uint32_t*>(ints.data())[ix] == indices[ix]);
+	}
+}
+
+TEST_CASE(IndexBuffer_EveryMeshPathUsesBothWidths) {
+	Tests::InitEngine();
+	if (!Tests::InitGL()) {
+		Tests::Report("No OpenGL context, skipped", 0.0, "");
+		return;
+	}
+
+	std::filesystem::path folder = std::filesystem::temp_directory_path() / "index_width_test";
+	std::filesystem::remove_all(folder);
+	std::filesystem::create_directories(folder);
+
+	for (const IndexWidthCase& test : IndexWidthCases) {
+		MeshBuilder<VertexPosNormTexCol> mesh = BuildGrid(test.QuadsX, test.QuadsY);
+		REQUIRE(IndexBuffer::GetSmallestType(mesh.GetVertexCount()) == test.Expected);
+		REQUIRE(!mesh.GetLods().empty());
+
+		// Meshes built at runtime, which includes generated meshes before they're cached
+		VertexArrayObject::Sptr baked = mesh.Bake();
+		CheckIndices(baked, mesh, test.Expected);
+
+		// Binary files, which is how cached generated meshes and converted OBJs are loaded
+		std::string binPath = (folder / (std::string("grid-") + test.Name + ".bin")).string();
+		OptimizedObjLoader::SaveBinaryFile(mesh, binPath);
+		CheckIndices(OptimizedObjLoader::LoadFromFile(binPath), mesh, test.Expected);
+
+		// OBJ files, loaded directly and baked into a binary file. The loader may order vertices
+		// differently, so we only check the widths and that they draw every triangle
+		std::string objPath = (folder / (std::string("grid-") + test.Name + ".obj")).string();
+		WriteGridObj(objPath, test.QuadsX, test.QuadsY);
+		for (VertexArrayObject::Sptr loaded : { ObjLoader::LoadFromFile(objPath), OptimizedObjLoader::LoadFromFile(objPath) }) {
+			REQUIRE(loaded != nullptr);
+			CHECK(loaded->GetVertexCount() == mesh.GetVertexCount());
+			CHECK(loaded->GetIndexBuffer()->GetElementType() == test.Expected);
+			for (const VertexArrayObject::Lod& lod : loaded->GetLods()) {
+				CHECK(lod.Mesh->GetIndexBuffer()->GetElementType() == test.Expected);
+			}
+			GetPositionShader()->Bind();
+			CHECK(CountTrianglesDrawn([&]() { loaded->Draw(); }) == mesh.GetIndexCount() / 3);
+		}
+
+		// Colliders read the indices back from OpenGL
+		MeshResource::Sptr resource = std::make_shared<MeshResource>();
+		resource->Mesh = baked;
+		Scene::Sptr scene = std::make_shared<Scene>();
+		GameObject::Sptr object = scene->CreateGameObject("Grid");
+		object->Add<RenderComponent>()->SetMesh(resource);
+		Physics::ConvexMeshCollider::Sptr collider = Physics::ConvexMeshCollider::Create();
+		collider->Awake(object.get());
+		REQUIRE(resource->BulletTriMesh != nullptr);
+		CHECK(resource->BulletTriMesh->getNumTriangles() == static_cast<int>(mesh.GetIndexCount() / 3));
+
+		TriangleCollector triangles;
+		btVector3 huge = btVector3(1e6f, 1e6f, 1e6f);
+		resource->BulletTriMesh->InternalProcessAllTriangles(&triangles, -huge, huge);
+		REQUIRE(triangles.Corners.size() == mesh.GetIndexCount());
+		size_t mismatches = 0;
+		for (size_t ix = 0; ix < triangles.Corners.size(); ix++) {
+			const glm::vec3& expected = mesh.GetVertexDataPtr()[mesh.GetIndexDataPtr()[ix]].Position;
+			mismatches += glm::length(triangles.Corners[ix] - expected) > 1e-3f ? 1 : 0;
+		}
+		CHECK(mismatches == 0);
+
+		Tests::Report(std::string(test.Name) + " grid, " + std::to_string(mesh.GetVertexCount()) + " vertices, index buffer",
+					  baked->GetIndexBuffer()->GetTotalSize() / 1024.0, "KB");
+	}
+
+	std::filesystem::remove_all(folder);
+}
@@ -0,0 +1,307 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+#include "Application/JobSystem.h"
+#include "Application/FrameGraph.h"
+
+// Worker counts to run the correctness tests with, 0 means the waiting thread does all the work
+static const int TestWorkerCounts[] = { 0, 1, 3, 7 };
+
+TEST_CASE(JobSystem_ManyTinyJobsUnderContention) {
+	for (int workers : TestWorkerCounts) {
+		JobSystem jobs(workers);
+		const int count = 20000;
+		std::atomic<int> sum(0);
+		std::vector<JobSystem::JobHandle> handles;
+		handles.reserve(count);
+		for (int ix = 0; ix < count; ix++) {
+			handles.push_back(jobs.Schedule([&sum, ix]() { sum += ix; }));
+		}
+		jobs.WaitAll(handles);
+		CHECK(sum == count * (count - 1) / 2);
+	}
+}
+
+TEST_CASE(JobSystem_ScheduleFromManyThreads) {
+	JobSystem jobs(3);
+	const int threads = 4;
+	const int perThread = 5000;
+	std::atomic<int> ran(0);
+
+	// External threads all push to the shared queue while the workers are stealing from it
+	std::vector<std::thread> schedulers;
+	for (int ix = 0; ix < threads; ix++) {
+		schedulers.emplace_back([&]() {
+			std::vector<JobSystem::JobHandle> handles;
+			for (int job = 0; job < perThread; job++) {
+				handles.push_back(jobs.Schedule([&ran]() { ran++; }));
+			}
+			jobs.WaitAll(handles);
+		});
+	}
+	for (std::thread& thread : schedulers) {
+		thread.join();
+	}
+	CHECK(ran == threads * perThread);
+}
+
+TEST_CASE(JobSystem_DependenciesRunInOrder) {
+	for (int workers : TestWorkerCounts) {
+		JobSystem jobs(workers);
+
+		// A long chain, each link must see the one before it
+		const int length = 2000;
+		std::atomic<int> last(-1);
+		std::atomic<int> outOfOrder(0);
+		JobSystem::JobHandle previous = nullptr;
+		for (int ix = 0; ix < length; ix++) {
+			previous = jobs.Schedule([&, ix]() {
+				if (last.exchange(ix) != ix - 1) {
+					outOfOrder++;
+				}
+			}, { previous });
+		}
+		jobs.Wait(previous);
+		CHECK(outOfOrder == 0);
+		CHECK(last == length - 1);
+
+		// A wide fan in, the join must see every input
+		std::atomic<int> inputs(0);
+		std::vector<JobSystem::JobHandle> fanIn;
+		for (int ix = 0; ix < 500; ix++) {
+			fanIn.push_back(jobs.Schedule([&]() { inputs++; }));
+		}
+		int seen = -1;
+		jobs.Wait(jobs.Schedule([&]() { seen = inputs; }, fanIn));
+		CHECK(seen == 500);
+	}
+}
+
+TEST_CASE(JobSystem_NestedParallelFor) {
+	for (int workers : TestWorkerCounts) {
+		JobSystem jobs(workers);
+		const size_t outer = 64;
+		const size_t inner = 1000;
+		std::vector<std::atomic<int>> counts(outer * inner);
+		for (auto& count : counts) {
+			count = 0;
+		}
+
+		// Waiting inside a job has to help out, or the pool would deadlock with all workers waiting
+		JobSystem::JobHandle all = jobs.ParallelFor(outer, 1, [&](size_t begin, size_t end) {
+			for (size_t row = begin; row < end; row++) {
+				jobs.Wait(jobs.ParallelFor(inner, 37, [&, row](size_t first, size_t last) {
+					for (size_t col = first; col < last; col++) {
+						counts[row * inner + col]++;
+					}
+				}));
+			}
+		});
+		jobs.Wait(all);
+
+		int wrong = 0;
+		for (auto& count : counts) {
+			wrong += count != 1 ? 1 : 0;
+		}
+		CHECK(wrong == 0);
+	}
+}
+
+TEST_CASE(JobSystem_ExceptionReachesWaiter) {
+	for (int workers : TestWorkerCounts) {
+		JobSystem jobs(workers);
+
+		bool caught = false;
+		try {
+			jobs.Wait(jobs.Schedule([]() { throw std::runtime_error("job failed"); }));
+		} catch (const std::runtime_error& e) {
+			caught = std::string(e.what()) == "job failed";
+		}
+		CHECK(caught);
+
+		// One failed chunk fails the whole range, and anything that depends on it is skipped
+		std::atomic<int> chunksRan(0);
+		JobSystem::JobHandle range = jobs.ParallelFor(100, 1, [&](size_t begin, size_t) {
+			chunksRan++;
+			if (begin == 42) {
+				throw std::logic_error("chunk failed");
+			}
+		});
+		bool continuationRan = false;
+		JobSystem::JobHandle continuation = jobs.Then(range, [&]() { continuationRan = true; });
+		caught = false;
+		try {
+			jobs.Wait(continuation);
+		} catch (const std::logic_error&) {
+			caught = true;
+		}
+		CHECK(caught);
+		CHECK(!continuationRan);
+		CHECK(chunksRan == 100);
+
+		// Depending on a job that has already failed is no different
+		caught = false;
+		try {
+			jobs.Wait(jobs.Then(range, []() {}));
+		} catch (const std::logic_error&) {
+			caught = true;
+		}
+		CHECK(caught);
+
+		// WaitAll lets everything finish, then reports the failure
+		std::atomic<int> finished(0);
+		std::vector<JobSystem::JobHandle> handles;
+		for (int ix = 0; ix < 50; ix++) {
+			handles.push_back(jobs.Schedule([&finished, ix]() {
+				finished++;
+				if (ix == 10) {
+					throw std::runtime_error("one of many");
+				}
+			}));
+		}
+		caught = false;
+		try {
+			jobs.WaitAll(handles);
+		} catch (const std::runtime_error&) {
+			caught = true;
+		}
+		CHECK(caught);
+		CHECK(finished == 50);
+
+		// The pool is still usable after all that
+		std::atomic<int> after(0);
+		jobs.Wait(jobs.ParallelFor(1000, 10, [&](size_t begin, size_t end) { after += static_cast<int>(end - begin); }));
+		CHECK(after == 1000);
+	}
+}
+
+TEST_CASE(FrameGraph_PhasesWaitOnTheirDependencies) {
+	for (int workers : TestWorkerCounts) {
+		JobSystem jobs(workers);
+		FrameGraph frame(jobs);
+
+		for (int frameIx = 0; frameIx < 20; frameIx++) {
+			std::atomic<int> updated(0);
+			std::atomic<int> physicsSawUpdates[2] = { -1, -1 };
+			std::atomic<int> culled(0);
+			std::atomic<int> cullSawPhysics(0);
+			int drawListSawCulled = -1;
+
+			// Two fixed ticks, each tick's Physics must wait on the Update work scheduled before it
+			for (int tick = 0; tick < 2; tick++) {
+				frame.ParallelFor(FramePhase::Update, 256, 16, [&](size_t begin, size_t end) {
+					updated += static_cast<int>(end - begin);
+				});
+				frame.Schedule(FramePhase::Physics, [&, tick]() { physicsSawUpdates[tick] = updated.load(); });
+			}
+			frame.ParallelFor(FramePhase::Cull, 1000, 50, [&](size_t begin, size_t end) {
+				cullSawPhysics += physicsSawUpdates[0] >= 256 && physicsSawUpdates[1] == 512 ? 1 : 0;
+				culled += static_cast<int>(end - begin);
+			});
+			frame.Schedule(FramePhase::BuildDrawList, [&]() { drawListSawCulled = culled; });
+
+			frame.Wait(FramePhase::BuildDrawList);
+			CHECK(drawListSawCulled == 1000);
+			CHECK(cullSawPhysics == 20);
+			frame.EndFrame();
+		}
+	}
+}
+
+TEST_CASE(FrameGraph_IndependentPhasesOverlap) {
+	JobSystem jobs(3);
+	FrameGraph frame(jobs);
+	frame.ClearDependencies(FramePhase::Cull);
+	CHECK(!frame.DependsOn(FramePhase::Cull, FramePhase::Physics));
+	CHECK(frame.DependsOn(FramePhase::BuildDrawList, FramePhase::Cull));
+
+	// Physics can't finish until Cull has started, which only works if they are allowed to overlap
+	std::atomic<bool> cullStarted(false);
+	frame.Schedule(FramePhase::Physics, [&]() {
+		while (!cullStarted) {
+			std::this_thread::yield();
+		}
+	});
+	frame.Schedule(FramePhase::Cull, [&]() { cullStarted = true; });
+	frame.EndFrame();
+	CHECK(cullStarted);
+}
+
+TEST_CASE(FrameGraph_RunWaitsOnDependencies) {
+	JobSystem jobs(2);
+	FrameGraph frame(jobs);
+	std::atomic<int> updated(0);
+	frame.ParallelFor(FramePhase::Update, 100, 1, [&](size_t begin, size_t end) {
+		std::this_thread::sleep_for(std::chrono::microseconds(50));
+		updated += static_cast<int>(end - begin);
+	});
+	int seen = -1;
+	frame.Run(FramePhase::Physics, [&]() { seen = updated; });
+	CHECK(seen == 100);
+
+	// A failure in a phase is reported once, to whoever waits on it
+	frame.Schedule(FramePhase::Cull, []() { throw std::runtime_error("cull failed"); });
+	bool caught = false;
+	try {
+		frame.Wait(FramePhase::Cull);
+	} catch (const std::runtime_error&) {
+		caught = true;
+	}
+	CHECK(caught);
+	frame.EndFrame();
+}
+
+// Some busy work that doesn't touch memory, so the benchmark measures the scheduler rather than bandwidth
+static float BusyWork(size_t index) {
+	float value = static_cast<float>(index);
+	for (int ix = 0; ix < 100; ix++) {
+		value = std::sin(value) * 0.5f + 1.0f;
+	}
+	return value;
+}
+
+TEST_CASE(JobSystem_BenchmarkScaling) {
+	const size_t count = 100000;
+	std::vector<float> results(count);
+	int maxThreads = std::max<int>(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+	double singleMs = 0.0;
+	for (int threads = 1; threads <= maxThreads; threads++) {
+		JobSystem jobs(threads - 1);
+
+		double parallelForMs = Tests::TimeMs([&]() {
+			jobs.Wait(jobs.ParallelFor(count, 0, [&](size_t begin, size_t end) {
+				for (size_t ix = begin; ix < end; ix++) {
+					results[ix] = BusyWork(ix);
+				}
+			}));
+		}, 5);
+		if (threads == 1) {
+			singleMs = parallelForMs;
+		}
+
+		// Lots of small jobs, which is where queue contention shows up
+		double smallJobsMs = Tests::TimeMs([&]() {
+			jobs.Wait(jobs.ParallelFor(count, 64, [&](size_t begin, size_t end) {
+				for (size_t ix = begin; ix < end; ix++) {
+					results[ix] = BusyWork(ix);
+				}
+			}));
+		}, 5);
+
+		int wrong = 0;
+		for (size_t ix = 0; ix < count; ix += 997) {
+			wrong += results[ix] != BusyWork(ix) ? 1 : 0;
+		}
+		CHECK(wrong == 0);
+
+		std::string prefix = std::to_string(threads) + " threads, ";
+		Tests::Report(prefix + "ParallelFor 100k, even split", parallelForMs);
+		Tests::Report(prefix + "ParallelFor 100k, grain 64", smallJobsMs);
+		Tests::Report(prefix + "speedup over 1 thread", singleMs / parallelForMs, "x");
+	}
+}
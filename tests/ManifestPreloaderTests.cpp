@@ -0,0 +1,76 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <thread>
+
+#include "Application/JobSystem.h"
+#include "Utils/ResourceManager/ResourceManager.h"
+#include "Utils/ResourceManager/ManifestPreloader.h"
+
+static const std::string ManifestPath = "res/scene-manifest.json";
+
+// Counts the entries in the manifest that the resource manager has loaded
+static size_t CountLoaded(size_t& total) {
+	size_t result = 0;
+	total = 0;
+	for (auto& [typeName, items] : ResourceManager::GetManifest().items()) {
+		if (!items.is_object()) {
+			continue;
+		}
+		for (auto& [guid, item] : items.items()) {
+			total++;
+			result += ResourceManager::IsLoaded(typeName, Guid(guid)) ? 1 : 0;
+		}
+	}
+	return result;
+}
+
+TEST_CASE(ManifestPreloader_ColdStartScaling) {
+	Tests::InitEngine();
+	// Finishing resources creates textures, shaders and meshes
+	if (!Tests::InitGL()) {
+		Tests::Report("No OpenGL context, skipped", 0.0, "");
+		return;
+	}
+
+	const int hardwareWorkers = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+	std::vector<int> workerCounts = { 0, 1, std::max(1, hardwareWorkers / 2), hardwareWorkers };
+	workerCounts.erase(std::unique(workerCounts.begin(), workerCounts.end()), workerCounts.end());
+
+	double serialMs = 0.0;
+	size_t expectedResources = 0;
+	for (int workers : workerCounts) {
+		// Start every run from nothing, including the generated meshes that would otherwise come out of the cache
+		ResourceManager::Cleanup();
+		std::error_code error;
+		std::filesystem::remove_all("cache/meshes", error);
+		ResourceManager::LoadManifest(ManifestPath);
+
+		JobSystem jobs(workers);
+		ManifestPreloader preloader(jobs);
+		auto start = std::chrono::steady_clock::now();
+		preloader.Start();
+		preloader.Finish();
+		double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		size_t total = 0;
+		size_t loaded = CountLoaded(total);
+		CHECK(preloader.IsDone());
+		CHECK(loaded == total);
+		// Every run should load the same thing no matter how many threads it had
+		if (expectedResources == 0) {
+			expectedResources = preloader.NumResources();
+		}
+		CHECK(preloader.NumResources() == expectedResources);
+
+		if (workers == 0) {
+			serialMs = elapsedMs;
+		}
+		std::string prefix = "scene-manifest cold start, " + std::to_string(jobs.NumThreads()) + " threads";
+		Tests::Report(prefix, elapsedMs);
+		Tests::Report(prefix + ", speedup", serialMs / elapsedMs, "x");
+	}
+
+	ResourceManager::Cleanup();
+}
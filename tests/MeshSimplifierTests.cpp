@@ -0,0 +1,264 @@
+#include "TestFramework.h"
+
+#include <GLM/gtc/matrix_transform.hpp>
+
+#include "Application/JobSystem.h"
+#include "Application/Layers/RenderLayer.h"
+#include "Gameplay/MeshResource.h"
+#include "Graphics/ShaderProgram.h"
+#include "Utils/MeshSimplifier.h"
+#include "Utils/ObjLoader.h"
+
+// A flat square grid in the XZ plane, size quads on each side, with one unit per quad
+static MeshBuilder<VertexPosNormTexCol> BuildGrid(int size) {
+	MeshBuilder<VertexPosNormTexCol> result;
+	for (int y = 0; y <= size; y++) {
+		for (int x = 0; x <= size; x++) {
+			glm::vec2 uv = glm::vec2(x, y) / static_cast<float>(size);
+			result.AddVertex(glm::vec3(x, 0.0f, y), glm::vec3(0.0f, 1.0f, 0.0f), uv, glm::vec4(1.0f));
+		}
+	}
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			uint32_t corner = y * (size + 1) + x;
+			result.AddIndexTri(corner, corner + size + 1, corner + 1);
+			result.AddIndexTri(corner + 1, corner + size + 1, corner + size + 2);
+		}
+	}
+	return result;
+}
+
+// Checks that each level of detail has fewer triangles and at least as much error as the one before it,
+// that they only use vertices in the mesh, and that they all have the mesh's submeshes
+template <typename VertexType>
+static void CheckLodChain(const MeshBuilder<VertexType>& mesh) {
+	const std::vector<MeshLod>& lods = mesh.GetLods();
+	const std::vector<uint32_t>& lodIndices = mesh.GetLodIndices();
+	size_t previousCount = mesh.GetIndexCount();
+	float previousError = 0.0f;
+	size_t outOfRange = 0;
+	for (const MeshLod& lod : lods) {
+		CHECK(lod.IndexCount % 3 == 0);
+		CHECK(lod.IndexCount < previousCount);
+		CHECK(lod.IndexCount / 3 >= MeshSimplifier::MinLodTriangles);
+		CHECK(lod.Error >= previousError);
+		REQUIRE(lod.FirstIndex + (size_t)lod.IndexCount <= lodIndices.size());
+		for (uint32_t ix = lod.FirstIndex; ix < lod.FirstIndex + lod.IndexCount; ix++) {
+			outOfRange += lodIndices[ix] >= mesh.GetVertexCount() ? 1 : 0;
+		}
+
+		CHECK(lod.SubmeshCount == mesh.GetSubmeshes().size());
+		uint32_t covered = 0;
+		for (uint32_t ix = lod.FirstSubmesh; ix < lod.FirstSubmesh + lod.SubmeshCount; ix++) {
+			const Submesh& submesh = mesh.GetLodSubmeshes()[ix];
+			CHECK(submesh.MaterialSlot == mesh.GetSubmeshes()[ix - lod.FirstSubmesh].MaterialSlot);
+			CHECK(submesh.FirstIndex == covered);
+			covered += submesh.IndexCount;
+		}
+		CHECK(lod.SubmeshCount == 0 || covered == lod.IndexCount);
+
+		previousCount = lod.IndexCount;
+		previousError = lod.Error;
+	}
+	CHECK(outOfRange == 0);
+}
+
+TEST_CASE(MeshSimplifier_ObjLoaderLeavesMeshesAsAuthored) {
+	// Levels of detail are only generated when a mesh is baked, loading the OBJ shouldn't pay for them
+	MeshBuilder<VertexPosNormTexColTangents> mesh = ObjLoader::LoadMeshFromFile("res/monkey.obj");
+	CHECK(mesh.GetVertexCount() > 0);
+	CHECK(mesh.GetLods().empty());
+	CHECK(mesh.GetLodIndices().empty());
+}
+
+TEST_CASE(MeshSimplifier_MeshResourcesGetLods) {
+	Tests::InitEngine();
+	if (!Tests::InitGL()) {
+		Tests::Report("No OpenGL context, skipped", 0.0, "");
+		return;
+	}
+
+	// Without the optimized loader the OBJ is baked as it's loaded, which still has to give it levels of detail
+	JobSystem jobs;
+	for (const char* path : { "res/monkey.obj", "res/Tank.obj" }) {
+		const MeshBuilder<VertexPosNormTexColTangents> source = ObjLoader::LoadMeshFromFile(path);
+		Gameplay::MeshResource::Sptr resource = Gameplay::MeshResource::PrepareFromJson({ { "filename", path } }, &jobs)();
+		REQUIRE(resource->Mesh != nullptr);
+		CHECK(!resource->Mesh->GetLods().empty());
+		CHECK(resource->Mesh->GetVertexCount() == source.GetVertexCount());
+		CHECK(resource->Mesh->GetIndexCount() == source.GetIndexCount());
+	}
+}
+
+TEST_CASE(MeshSimplifier_GeneratesLodChain) {
+	for (const char* name : { "monkey", "Tank", "test" }) {
+		const MeshBuilder<VertexPosNormTexColTangents> source = ObjLoader::LoadMeshFromFile(std::string("res/") + name + ".obj");
+		std::vector<uint32_t> indices(source.GetIndexDataPtr(), source.GetIndexDataPtr() + source.GetIndexCount());
+
+		// Starts from a copy each time, since the levels are added on to the mesh
+		MeshBuilder<VertexPosNormTexColTangents> mesh;
+		double ms = Tests::TimeMs([&]() {
+			mesh = source;
+			MeshSimplifier::GenerateLods(mesh, name);
+		}, 3);
+		REQUIRE(!mesh.GetLods().empty());
+		CheckLodChain(mesh);
+
+		// The full detail mesh must be left alone
+		CHECK(std::equal(indices.begin(), indices.end(), mesh.GetIndexDataPtr()));
+
+		std::string prefix = std::string(name) + ".obj (" + std::to_string(indices.size() / 3) + " triangles), ";
+		Tests::Report(prefix + "GenerateLods", ms);
+		for (size_t ix = 0; ix < mesh.GetLods().size(); ix++) {
+			Tests::Report(prefix + "LOD " + std::to_string(ix + 1), mesh.GetLods()[ix].IndexCount / 3, "triangles");
+		}
+	}
+}
+
+TEST_CASE(MeshSimplifier_FlatGridKeepsItsShape) {
+	const int size = 32;
+	MeshBuilder<VertexPosNormTexCol> mesh = BuildGrid(size);
+	MeshSimplifier::GenerateLods(mesh, "grid");
+	REQUIRE(mesh.GetLods().size() >= 2);
+	CheckLodChain(mesh);
+
+	const VertexPosNormTexCol* vertices = mesh.GetVertexDataPtr();
+	const std::vector<uint32_t>& lodIndices = mesh.GetLodIndices();
+	for (const MeshLod& lod : mesh.GetLods()) {
+		// Nothing moves off the plane, so there is no error
+		CHECK_NEAR(lod.Error, 0.0f, 1e-4f);
+
+		// Border vertices are locked, so the outline and area of the grid must be the same, and no
+		// triangles can be flipped over
+		std::vector<bool> used(mesh.GetVertexCount(), false);
+		float area = 0.0f;
+		size_t flipped = 0;
+		for (uint32_t ix = lod.FirstIndex; ix < lod.FirstIndex + lod.IndexCount; ix += 3) {
+			const glm::vec3& a = vertices[lodIndices[ix]].Position;
+			const glm::vec3& b = vertices[lodIndices[ix + 1]].Position;
+			const glm::vec3& c = vertices[lodIndices[ix + 2]].Position;
+			glm::vec3 normal = glm::cross(b - a, c - a);
+			area += glm::length(normal) * 0.5f;
+			flipped += normal.y < 0.0f ? 1 : 0;
+			used[lodIndices[ix]] = used[lodIndices[ix + 1]] = used[lodIndices[ix + 2]] = true;
+		}
+		CHECK_NEAR(area, static_cast<float>(size * size), 1e-2f);
+		CHECK(flipped == 0);
+
+		size_t missingBorder = 0;
+		for (int ix = 0; ix <= size; ix++) {
+			missingBorder += !used[ix] ? 1 : 0;
+			missingBorder += !used[size * (size + 1) + ix] ? 1 : 0;
+			missingBorder += !used[ix * (size + 1)] ? 1 : 0;
+			missingBorder += !used[ix * (size + 1) + size] ? 1 : 0;
+		}
+		CHECK(missingBorder == 0);
+	}
+}
+
+TEST_CASE(MeshSimplifier_SkipsSmallMeshes) {
+	// Too few triangles to be worth simplifying
+	MeshBuilder<VertexPosNormTexCol> mesh = BuildGrid(4);
+	MeshSimplifier::GenerateLods(mesh, "small grid");
+	CHECK(mesh.GetLods().empty());
+}
+
+TEST_CASE(MeshSimplifier_BenchmarkFarField) {
+	if (!Tests::InitGL()) {
+		Tests::Report("No OpenGL context, skipped", 0.0, "");
+		return;
+	}
+
+	MeshBuilder<VertexPosNormTexColTangents> builder = ObjLoader::LoadMeshFromFile("res/monkey.obj");
+	MeshSimplifier::GenerateLods(builder, "monkey");
+	VertexArrayObject::Sptr mesh = builder.Bake();
+	REQUIRE(!mesh->GetLods().empty());
+	REQUIRE(mesh->HasBounds());
+
+	// A 1080p camera with a 60 degree field of view, the same as the render layer's defaults
+	const float pixelError = 1.0f;
+	const float hysteresis = 0.75f;
+	glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+	float pixelScale = projection[1][1] * 1080.0f * 0.5f;
+	glm::vec3 cameraPos = glm::vec3(0.0f);
+	glm::mat4 view = glm::lookAt(cameraPos, glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+
+	// Moving away from the camera should never pick a more detailed level, and staying on a coarser
+	// level should never pick a more detailed one than starting from the full detail mesh would
+	const int maxLevel = static_cast<int>(mesh->GetLods().size());
+	int previous = 0;
+	size_t regressions = 0;
+	size_t unstable = 0;
+	for (float distance = 1.0f; distance < 500.0f; distance *= 1.1f) {
+		glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -distance));
+		int level = RenderLayer::SelectLod(mesh, model, 0, cameraPos, false, pixelScale, pixelError, hysteresis);
+		int sticky = RenderLayer::SelectLod(mesh, model, maxLevel, cameraPos, false, pixelScale, pixelError, hysteresis);
+		regressions += level < previous ? 1 : 0;
+		unstable += sticky < level ? 1 : 0;
+		previous = level;
+	}
+	CHECK(regressions == 0);
+	CHECK(unstable == 0);
+	CHECK(RenderLayer::SelectLod(mesh, glm::mat4(1.0f), 0, cameraPos, false, pixelScale, pixelError, hysteresis) == 0);
+	CHECK(previous > 0);
+
+	// A field of monkeys stretching off into the distance, drawn with a shader that only decodes positions
+	std::vector<glm::mat4> models;
+	for (int z = 0; z < 40; z++) {
+		for (int x = -10; x < 10; x++) {
+			models.push_back(glm::translate(glm::mat4(1.0f), glm::vec3(x * 10.0f, -2.0f, -10.0f - z * 10.0f)));
+		}
+	}
+	ShaderProgram::Sptr shader = ShaderProgram::Create();
+	shader->LoadShaderPart(R"LIT(
+		#version 450
+		layout (location = 0) in vec3 inPosition;
+		uniform mat4 u_ModelViewProjection;
+		uniform vec3 u_PositionOffset;
+		uniform vec3 u_PositionScale;
+		void main() {
+			gl_Position = u_ModelViewProjection * vec4(u_PositionOffset + inPosition * u_PositionScale, 1.0);
+		}
+	)LIT", ShaderPartType::Vertex);
+	shader->LoadShaderPart(R"LIT(
+		#version 450
+		layout (location = 0) out vec4 outColor;
+		void main() {
+			outColor = vec4(1.0);
+		}
+	)LIT", ShaderPartType::Fragment);
+	REQUIRE(shader->Link());
+	shader->Bind();
+	shader->SetUniform("u_PositionOffset", mesh->GetBoundsMin());
+	shader->SetUniform("u_PositionScale", mesh->GetBoundsMax() - mesh->GetBoundsMin());
+	glEnable(GL_DEPTH_TEST);
+
+	std::vector<int> levels(models.size(), 0);
+	size_t triangles = 0;
+	auto drawField = [&](bool useLods) {
+		triangles = 0;
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		for (size_t ix = 0; ix < models.size(); ix++) {
+			levels[ix] = useLods ? RenderLayer::SelectLod(mesh, models[ix], levels[ix], cameraPos, false, pixelScale, pixelError, hysteresis) : 0;
+			const VertexArrayObject::Sptr& lod = levels[ix] > 0 ? mesh->GetLods()[levels[ix] - 1].Mesh : mesh;
+			shader->SetUniformMatrix("u_ModelViewProjection", projection * view * models[ix]);
+			lod->Draw();
+			triangles += lod->GetElementCount() / 3;
+		}
+		glFinish();
+	};
+
+	double fullMs = Tests::TimeMs([&]() { drawField(false); }, 20);
+	size_t fullTriangles = triangles;
+	double lodMs = Tests::TimeMs([&]() { drawField(true); }, 20);
+	size_t lodTriangles = triangles;
+	CHECK(lodTriangles < fullTriangles);
+
+	std::string prefix = "Far field, " + std::to_string(models.size()) + " monkeys, ";
+	Tests::Report(prefix + "full detail triangles", fullTriangles, "triangles");
+	Tests::Report(prefix + "triangles with LODs", lodTriangles, "triangles");
+	Tests::Report(prefix + "full detail frame", fullMs);
+	Tests::Report(prefix + "frame with LODs", lodMs);
+	Tests::Report(prefix + "speedup", fullMs / lodMs, "x");
+	glDisable(GL_DEPTH_TEST);
+}
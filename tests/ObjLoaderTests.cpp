@@ -0,0 +1,515 @@
+#include "TestFramework.h"
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "Application/JobSystem.h"
+#include "Utils/ObjLoader.h"
+#include "Utils/StringUtils.h"
+
+static ObjMeshData ParseText(const std::string& text, JobSystem* jobs = nullptr) {
+	return ObjLoader::Parse(text.data(), text.size(), jobs);
+}
+
+static bool ParseThrows(const std::string& text, JobSystem* jobs = nullptr) {
+	try {
+		ParseText(text, jobs);
+	} catch (const std::runtime_error&) {
+		return true;
+	}
+	return false;
+}
+
+static bool VecEquals(const glm::vec3& a, float x, float y, float z) {
+	return a.x == x && a.y == y && a.z == z;
+}
+
+TEST_CASE(ObjTokenizer_ParsesAttributes) {
+	// Comments, unknown commands, CRLF line endings, extra whitespace, exponents, leading plus signs
+	// and a missing newline at the end of the file
+	std::string text =
+		"# A comment\r\n"
+		"mtllib scene.mtl\r\n"
+		"  v 1.5 -2 +3e2\r\n"
+		"v\t0.0   0.0\t0.0 1.0\r\n"
+		"v 1 0 0\r\n"
+		"\r\n"
+		"vt 0.25 .5\r\n"
+		"vn 0 1 0\r\n"
+		"s off\r\n"
+		"o Thing\r\n"
+		"f 1/1/1 2/1/1 3/1/1";
+	ObjMeshData data = ParseText(text);
+
+	REQUIRE(data.Positions.size() == 3);
+	CHECK(VecEquals(data.Positions[0], 1.5f, -2.0f, 300.0f));
+	CHECK(VecEquals(data.Positions[1], 0.0f, 0.0f, 0.0f));
+	CHECK(VecEquals(data.Positions[2], 1.0f, 0.0f, 0.0f));
+	REQUIRE(data.UVs.size() == 1);
+	CHECK(data.UVs[0].x == 0.25f);
+	CHECK(data.UVs[0].y == 0.5f);
+	REQUIRE(data.Normals.size() == 1);
+	CHECK(VecEquals(data.Normals[0], 0.0f, 1.0f, 0.0f));
+
+	REQUIRE(data.Vertices.size() == 3);
+	CHECK(data.Vertices[0] == glm::ivec3(0, 0, 0));
+	CHECK(data.Vertices[1] == glm::ivec3(1, 0, 0));
+	CHECK(data.Vertices[2] == glm::ivec3(2, 0, 0));
+	CHECK(data.Indices == std::vector<uint32_t>({ 0, 1, 2 }));
+	CHECK(data.Submeshes.empty());
+	CHECK(data.MaterialSlots == std::vector<std::string>({ "" }));
+}
+
+TEST_CASE(ObjTokenizer_TriangulatesPolygons) {
+	std::string text =
+		"v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nv -1 1 0\n"
+		"f 1 2 3 4 5\n"
+		"f 1 2 3 4\n"
+		// Lines and points don't make any triangles
+		"f 1 2\n"
+		"f 1\n";
+	ObjMeshData data = ParseText(text);
+
+	// Polygons become a triangle fan around their first corner
+	CHECK(data.Vertices.size() == 5);
+	CHECK(data.Indices == std::vector<uint32_t>({ 0, 1, 2, 0, 2, 3, 0, 3, 4, 0, 1, 2, 0, 2, 3 }));
+}
+
+TEST_CASE(ObjTokenizer_ResolvesNegativeIndices) {
+	std::string text =
+		"v 0 0 0\nv 1 0 0\nv 0 1 0\n"
+		"vt 0 0\nvt 1 1\n"
+		"f -3/-2 -2/-1 -1/-1\n"
+		"v 1 1 0\n"
+		// Relative to the attributes defined so far, not the end of the file
+		"f -4/1 -1/-1 -2/2\n";
+	ObjMeshData data = ParseText(text);
+
+	REQUIRE(data.Vertices.size() == 4);
+	CHECK(data.Vertices[0] == glm::ivec3(0, 0, -1));
+	CHECK(data.Vertices[1] == glm::ivec3(1, 1, -1));
+	CHECK(data.Vertices[2] == glm::ivec3(2, 1, -1));
+	CHECK(data.Vertices[3] == glm::ivec3(3, 1, -1));
+	CHECK(data.Indices == std::vector<uint32_t>({ 0, 1, 2, 0, 3, 2 }));
+}
+
+TEST_CASE(ObjTokenizer_HandlesMissingAttributes) {
+	std::string text =
+		"v 0 0 0\nv 1 0 0\nv 0 1 0\n"
+		"vt 0 0\n"
+		"vn 0 0 1\n"
+		"f 1 2 3\n"
+		"f 1/1 2/1 3/1\n"
+		"f 1//1 2//1 3//1\n"
+		"f 1/1/1 2/1/1 3/1/1\n";
+	ObjMeshData data = ParseText(text);
+
+	// Every combination of attributes is a different vertex, even with the same position
+	REQUIRE(data.Vertices.size() == 12);
+	CHECK(data.Vertices[0] == glm::ivec3(0, -1, -1));
+	CHECK(data.Vertices[3] == glm::ivec3(0, 0, -1));
+	CHECK(data.Vertices[6] == glm::ivec3(0, -1, 0));
+	CHECK(data.Vertices[9] == glm::ivec3(0, 0, 0));
+	CHECK(data.Indices.size() == 12);
+}
+
+TEST_CASE(ObjTokenizer_DeduplicatesVertices) {
+	std::string text =
+		"v 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 1 0\n"
+		"vn 0 0 1\nvn 0 0 -1\n"
+		"f 1//1 2//1 3//1\n"
+		"f 2//1 4//1 3//1\n"
+		// Same positions, but facing the other way
+		"f 3//2 2//2 1//2\n";
+	ObjMeshData data = ParseText(text);
+
+	CHECK(data.Vertices.size() == 7);
+	CHECK(data.Indices == std::vector<uint32_t>({ 0, 1, 2, 1, 3, 2, 4, 5, 6 }));
+}
+
+TEST_CASE(ObjTokenizer_DeduplicatesLargeIndices) {
+	// Indices past 2^21 used to be masked off when building the dedup key, so they would collide
+	// with the start of the file
+	const size_t numPositions = (1 << 21) + 2;
+	std::string text;
+	text.reserve(numPositions * 8 + 256);
+	for (size_t ix = 0; ix < numPositions; ix++) {
+		text += "v 0 0 0\n";
+	}
+	text += "f 1 2097153 2\n";
+	text += "f 2097153 1 2097154\n";
+	ObjMeshData data = ParseText(text);
+
+	REQUIRE(data.Vertices.size() == 4);
+	CHECK(data.Vertices[0].x == 0);
+	CHECK(data.Vertices[1].x == (1 << 21));
+	CHECK(data.Vertices[2].x == 1);
+	CHECK(data.Vertices[3].x == (1 << 21) + 1);
+	CHECK(data.Indices == std::vector<uint32_t>({ 0, 1, 2, 1, 0, 3 }));
+}
+
+TEST_CASE(ObjTokenizer_GroupsMaterials) {
+	std::string text =
+		"v 0 0 0\nv 1 0 0\nv 0 1 0\n"
+		"f 1 2 3\n"
+		"usemtl Red \n"
+		"f 1 2 3\n"
+		"f 1 2 3\n"
+		"usemtl Blue\n"
+		"g NotAMaterial\n"
+		"f 3 2 1\n"
+		"usemtl Red\n"
+		"f 2 3 1\n";
+	ObjMeshData data = ParseText(text);
+
+	// Faces before the first usemtl get an unnamed slot, and trailing whitespace isn't part of the name
+	CHECK(data.MaterialSlots == std::vector<std::string>({ "", "Red", "Blue" }));
+	REQUIRE(data.Submeshes.size() == 3);
+	CHECK(data.Submeshes[0].FirstIndex == 0);
+	CHECK(data.Submeshes[0].IndexCount == 3);
+	CHECK(data.Submeshes[1].FirstIndex == 3);
+	CHECK(data.Submeshes[1].IndexCount == 9);
+	CHECK(data.Submeshes[1].MaterialSlot == 1);
+	CHECK(data.Submeshes[2].FirstIndex == 12);
+	CHECK(data.Submeshes[2].IndexCount == 3);
+	CHECK(data.Submeshes[2].MaterialSlot == 2);
+
+	// Each material is one range, and keeps it's triangles in file order
+	CHECK(data.Indices == std::vector<uint32_t>({ 0, 1, 2, 0, 1, 2, 0, 1, 2, 1, 2, 0, 2, 1, 0 }));
+}
+
+TEST_CASE(ObjTokenizer_RejectsInvalidFaces) {
+	const std::string positions = "v 0 0 0\nv 1 0 0\nv 0 1 0\n";
+	CHECK(ParseThrows(positions + "f 0 1 2\n"));
+	CHECK(ParseThrows(positions + "f 1 2 4\n"));
+	CHECK(ParseThrows(positions + "f -4 -2 -1\n"));
+	CHECK(ParseThrows(positions + "f 1/1 2/1 3/1\n"));
+	CHECK(ParseThrows(positions + "f 1//1 2//1 3//1\n"));
+	CHECK(ParseThrows(positions + "f /1 2 3\n"));
+
+	// Faces can refer forwards to attributes that are defined later on
+	CHECK(!ParseThrows("f 1 2 3\n" + positions));
+}
+
+// Builds a file big enough to be split into chunks, using every kind of face the parser handles. Each row
+// of the grid defines it's own attributes, and some rows refer back to the previous ones with negative indices
+static std::string BuildLargeObj(int size) {
+	std::string text;
+	text.reserve(static_cast<size_t>(size) * size * 64);
+	const char* materials[] = { "Grass", "Stone", "Water" };
+	for (int y = 0; y <= size; y++) {
+		for (int x = 0; x <= size; x++) {
+			text += "v " + std::to_string(x) + " " + std::to_string(y) + " " + std::to_string((x * y) % 7 * 0.125f) + "\n";
+			text += "vt " + std::to_string(x / static_cast<float>(size)) + " " + std::to_string(y / static_cast<float>(size)) + "\n";
+		}
+		text += "vn 0 0 1\n";
+		if (y == 0) {
+			continue;
+		}
+		if (y % 17 == 0) {
+			text += std::string("usemtl ") + materials[(y / 17) % 3] + "\n";
+		}
+
+		const int row = size + 1;
+	const int numPositions = row * row;
+		for (int x = 0; x < size; x++) {
+			// 1 based indices of the quad's corners, in the previous row and this one
+			const int a = (y - 1) * row + x + 1, b = a + 1, c = y * row + x + 2, d = c - 1;
+			switch ((x + y) % 4) {
+				case 0:
+					text += "f " + std::to_string(a) + "/" + std::to_string(a) + "/" + std::to_string(y) + " " +
+						std::to_string(b) + "/" + std::to_string(b) + "/" + std::to_string(y) + " " +
+						std::to_string(c) + "/" + std::to_string(c) + "/" + std::to_string(y) + " " +
+						std::to_string(d) + "/" + std::to_string(d) + "/" + std::to_string(y) + "\n";
+					break;
+				case 1:
+					// Relative to the end of this row
+					text += "f " + std::to_string(a - (y + 1) * row - 1) + "/" + std::to_string(a - (y + 1) * row - 1) + " " +
+						std::to_string(b - (y + 1) * row - 1) + "/" + std::to_string(b - (y + 1) * row - 1) + " " +
+						std::to_string(c - (y + 1) * row - 1) + "/" + std::to_string(c - (y + 1) * row - 1) + "\n";
+					break;
+				case 2:
+					text += "f " + std::to_string(a) + "//-1 " + std::to_string(b) + "//-1 " + std::to_string(c) + "//-1 " + std::to_string(d) + "//-1\n";
+					break;
+				default:
+					text += "f " + std::to_string(a) + " " + std::to_string(c) + " " + std::to_string(d) + "\n";
+					break;
+			}
+		}
+	}
+	return text;
+}
+
+static size_t CountDifferences(const ObjMeshData& a, const ObjMeshData& b) {
+	size_t result = 0;
+	auto compare = [&](const auto& x, const auto& y, auto&& equal) {
+		if (x.size() != y.size()) {
+			result++;
+			return;
+		}
+		for (size_t ix = 0; ix < x.size(); ix++) {
+			result += equal(x[ix], y[ix]) ? 0 : 1;
+		}
+	};
+	compare(a.Positions, b.Positions, [](const glm::vec3& x, const glm::vec3& y) { return x.x == y.x && x.y == y.y && x.z == y.z; });
+	compare(a.UVs, b.UVs, [](const glm::vec2& x, const glm::vec2& y) { return x.x == y.x && x.y == y.y; });
+	compare(a.Normals, b.Normals, [](const glm::vec3& x, const glm::vec3& y) { return x.x == y.x && x.y == y.y && x.z == y.z; });
+	compare(a.Vertices, b.Vertices, [](const glm::ivec3& x, const glm::ivec3& y) { return x == y; });
+	compare(a.Indices, b.Indices, [](uint32_t x, uint32_t y) { return x == y; });
+	compare(a.Submeshes, b.Submeshes, [](const Submesh& x, const Submesh& y) {
+		return x.FirstIndex == y.FirstIndex && x.IndexCount == y.IndexCount && x.MaterialSlot == y.MaterialSlot;
+	});
+	compare(a.MaterialSlots, b.MaterialSlots, [](const std::string& x, const std::string& y) { return x == y; });
+	return result;
+}
+
+TEST_CASE(ObjParser_ParallelMatchesSerial) {
+	std::string text = BuildLargeObj(400);
+	REQUIRE(text.size() > 4 * 1024 * 1024);
+	ObjMeshData serial = ParseText(text);
+	CHECK(serial.Submeshes.size() == 4);
+	// Half of the faces are quads and half are triangles
+	CHECK(serial.Indices.size() == 400 * (200 * 6 + 200 * 3));
+
+	for (int workers : { 1, 3, 7, 15 }) {
+		JobSystem jobs(workers);
+		// Parsed a few times, since the schedule changes from run to run
+		for (int run = 0; run < 3; run++) {
+			CHECK(CountDifferences(serial, ParseText(text, &jobs)) == 0);
+		}
+	}
+
+	// Real files, test.obj is large enough to be split up
+	JobSystem jobs;
+	for (const char* path : { "res/monkey.obj", "res/Tank.obj", "res/test.obj" }) {
+		CHECK(CountDifferences(ObjLoader::ParseFile(path), ObjLoader::ParseFile(path, &jobs)) == 0);
+	}
+}
+
+TEST_CASE(ObjParser_ParallelReportsErrors) {
+	std::string text = BuildLargeObj(300);
+	JobSystem jobs(3);
+
+	// Broken faces at the end of the file, and one that refers past the attributes defined so far
+	CHECK(ParseThrows(text + "f 0 1 2\n", &jobs));
+	CHECK(ParseThrows(text + "f 1 2 99999999\n", &jobs));
+	CHECK(ParseThrows("f -1 -2 -3\n" + text, &jobs));
+	CHECK(!ParseThrows("f 1 2 3\n" + text, &jobs));
+}
+
+TEST_CASE(ObjParser_BenchmarkThreadScaling) {
+	std::string text = BuildLargeObj(1000);
+	double serialMs = Tests::TimeMs([&]() { ParseText(text); }, 3);
+	Tests::Report(std::to_string(text.size() / (1024 * 1024)) + "MB OBJ, serial Parse", serialMs);
+
+	for (int threads : { 2, 4, 8, 16 }) {
+		JobSystem jobs(threads - 1);
+		double parallelMs = Tests::TimeMs([&]() { ParseText(text, &jobs); }, 3);
+		Tests::Report(std::to_string(threads) + " threads, Parse", parallelMs);
+		Tests::Report(std::to_string(threads) + " threads, speedup", serialMs / parallelMs, "x");
+	}
+}
+
+// The iostream parser that ObjLoader used before the tokenizer, kept as a reference for what the
+// tokenizer should produce. Like the original it only handles triangles and quads with all three
+// attribute indices, and can only tell apart 2^21 of each attribute. The only addition is that it
+// remembers which usemtl each triangle came after, so that its triangles can be grouped the same way
+struct LegacyObjData {
+	std::vector<glm::vec3>   Positions;
+	std::vector<glm::vec2>   UVs;
+	std::vector<glm::vec3>   Normals;
+	std::vector<glm::ivec3>  Vertices;
+	std::vector<uint32_t>    Indices;
+	std::vector<std::string> TriangleMaterials;
+};
+
+static LegacyObjData LegacyParseFile(const std::string& filename) {
+	std::ifstream file(filename, std::ios::binary);
+	if (!file) {
+		throw std::runtime_error("Failed to open file");
+	}
+
+	LegacyObjData result;
+	std::unordered_map<uint64_t, uint32_t> vertexMap;
+	std::string line;
+	std::string material = "";
+	glm::vec3 vecData;
+	glm::vec2 uvData;
+	glm::ivec3 vertexIndices;
+	while (file.peek() != EOF) {
+		std::string command;
+		file >> command;
+
+		if (command == "#") {
+			std::getline(file, line);
+		} else if (command == "v") {
+			file >> vecData.x >> vecData.y >> vecData.z;
+			result.Positions.push_back(vecData);
+		} else if (command == "vn") {
+			file >> vecData.x >> vecData.y >> vecData.z;
+			result.Normals.push_back(vecData);
+		} else if (command == "vt") {
+			file >> uvData.x >> uvData.y;
+			result.UVs.push_back(uvData);
+		} else if (command == "usemtl") {
+			file >> material;
+		} else if (command == "f") {
+			std::getline(file, line);
+			StringTools::Trim(line);
+			std::stringstream stream = std::stringstream(line);
+
+			uint32_t edges[4];
+			int ix = 0;
+			for (; ix < 4; ix++) {
+				if (stream.peek() == EOF) {
+					break;
+				}
+				char tempChar;
+				vertexIndices = glm::ivec3(0);
+				stream >> vertexIndices.x >> tempChar >> vertexIndices.y >> tempChar >> vertexIndices.z;
+				if (vertexIndices.x < 0) { vertexIndices.x = static_cast<int>(result.Positions.size()) + 1 + vertexIndices.x; }
+				if (vertexIndices.y < 0) { vertexIndices.y = static_cast<int>(result.UVs.size()) + 1 + vertexIndices.y; }
+				if (vertexIndices.z < 0) { vertexIndices.z = static_cast<int>(result.Normals.size()) + 1 + vertexIndices.z; }
+
+				const uint64_t mask = 0b111111111111111111111;
+				uint64_t key = ((vertexIndices.x & mask) << 42) | ((vertexIndices.y & mask) << 21) | (vertexIndices.z & mask);
+				auto it = vertexMap.find(key);
+				if (it != vertexMap.end()) {
+					edges[ix] = it->second;
+				} else {
+					result.Vertices.push_back(vertexIndices - glm::ivec3(1));
+					edges[ix] = static_cast<uint32_t>(result.Vertices.size()) - 1;
+					vertexMap[key] = edges[ix];
+				}
+			}
+
+			if (ix >= 3) {
+				result.Indices.insert(result.Indices.end(), { edges[0], edges[1], edges[2] });
+				result.TriangleMaterials.push_back(material);
+			}
+			if (ix == 4) {
+				result.Indices.insert(result.Indices.end(), { edges[0], edges[2], edges[3] });
+				result.TriangleMaterials.push_back(material);
+			}
+		}
+	}
+	return result;
+}
+
+// The triangles for each material, in file order
+typedef std::map<std::string, std::vector<uint32_t>> TrianglesByMaterial;
+
+static TrianglesByMaterial GroupTriangles(const ObjMeshData& data) {
+	TrianglesByMaterial result;
+	if (data.Submeshes.empty()) {
+		result[data.MaterialSlots.empty() ? "" : data.MaterialSlots[0]] = data.Indices;
+		return result;
+	}
+	for (const Submesh& submesh : data.Submeshes) {
+		std::vector<uint32_t>& indices = result[data.MaterialSlots[submesh.MaterialSlot]];
+		indices.insert(indices.end(), data.Indices.begin() + submesh.FirstIndex, data.Indices.begin() + submesh.FirstIndex + submesh.IndexCount);
+	}
+	return result;
+}
+
+static TrianglesByMaterial GroupTriangles(const LegacyObjData& data) {
+	TrianglesByMaterial result;
+	for (size_t ix = 0; ix < data.TriangleMaterials.size(); ix++) {
+		std::vector<uint32_t>& indices = result[data.TriangleMaterials[ix]];
+		indices.insert(indices.end(), data.Indices.begin() + ix * 3, data.Indices.begin() + ix * 3 + 3);
+	}
+	return result;
+}
+
+static size_t CountDifferences(const LegacyObjData& expected, const ObjMeshData& actual) {
+	ObjMeshData legacyStreams;
+	legacyStreams.Positions = expected.Positions;
+	legacyStreams.UVs = expected.UVs;
+	legacyStreams.Normals = expected.Normals;
+	legacyStreams.Vertices = expected.Vertices;
+	ObjMeshData actualStreams;
+	actualStreams.Positions = actual.Positions;
+	actualStreams.UVs = actual.UVs;
+	actualStreams.Normals = actual.Normals;
+	actualStreams.Vertices = actual.Vertices;
+
+	// Both keep each material's triangles in file order, the tokenizer also moves them next to each other
+	return CountDifferences(legacyStreams, actualStreams) + (GroupTriangles(expected) == GroupTriangles(actual) ? 0 : 1);
+}
+
+// Writes a grid of quads and triangles that the legacy parser can read, with materials that are used
+// more than once so the tokenizer has to regroup the triangles
+static void WriteLegacyCompatibleObj(const std::string& path, int size) {
+	std::ofstream file(path, std::ios::binary);
+	const char* materials[] = { "Grass", "Stone", "Water" };
+	const int row = size + 1;
+	const int numPositions = row * row;
+	for (int y = 0; y <= size; y++) {
+		for (int x = 0; x <= size; x++) {
+			file << "v " << x << " " << y << " " << ((x * y) % 7 * 0.125f) << "\n";
+			file << "vt " << (x / static_cast<float>(size)) << " " << (y / static_cast<float>(size)) << "\n";
+		}
+		file << "vn 0 " << (y % 3) * 0.5f << " 1\n";
+	}
+	for (int y = 1; y <= size; y++) {
+		if (y % 23 == 1) {
+			file << "usemtl " << materials[(y / 23) % 3] << "\n";
+		}
+		for (int x = 0; x < size; x++) {
+			const int a = (y - 1) * row + x + 1, b = a + 1, c = y * row + x + 2, d = c - 1;
+			if ((x + y) % 2 == 0) {
+				file << "f " << a << "/" << a << "/" << y << " " << b << "/" << b << "/" << y << " " << c << "/" << c << "/" << y << " " << d << "/" << d << "/" << y << "\n";
+			} else {
+				file << "f " << a << "/" << a << "/" << y << " " << c << "/" << c << "/" << y << " " << d << "/" << d << "/" << y << "\n";
+				file << "f -" << (numPositions + 1 - a) << "/" << a << "/-1 " << b << "/" << b << "/" << y << " " << c << "/" << c << "/" << y << "\n";
+			}
+		}
+	}
+}
+
+TEST_CASE(ObjParser_MatchesLegacyParser) {
+	std::filesystem::path folder = std::filesystem::temp_directory_path() / "obj_legacy_parity";
+	std::filesystem::create_directories(folder);
+	std::string synthetic = (folder / "grid.obj").string();
+	WriteLegacyCompatibleObj(synthetic, 700);
+
+	JobSystem jobs;
+	for (const std::string& path : { std::string("res/Tank.obj"), std::string("res/monkey.obj"), synthetic }) {
+		LegacyObjData expected = LegacyParseFile(path);
+		REQUIRE(!expected.Indices.empty());
+		CHECK(CountDifferences(expected, ObjLoader::ParseFile(path)) == 0);
+		CHECK(CountDifferences(expected, ObjLoader::ParseFile(path, &jobs)) == 0);
+	}
+
+	std::error_code error;
+	std::filesystem::remove_all(folder, error);
+}
+
+TEST_CASE(ObjParser_BenchmarkVsLegacyParser) {
+	std::filesystem::path folder = std::filesystem::temp_directory_path() / "obj_legacy_benchmark";
+	std::filesystem::create_directories(folder);
+	std::string synthetic = (folder / "grid.obj").string();
+	WriteLegacyCompatibleObj(synthetic, 700);
+
+	JobSystem jobs;
+	for (const std::string& path : { std::string("res/Tank.obj"), std::string("res/monkey.obj"), synthetic }) {
+		const int reps = path == synthetic ? 1 : 10;
+		double legacyMs = Tests::TimeMs([&]() { LegacyParseFile(path); }, reps);
+		double serialMs = Tests::TimeMs([&]() { ObjLoader::ParseFile(path); }, reps);
+		double parallelMs = Tests::TimeMs([&]() { ObjLoader::ParseFile(path, &jobs); }, reps);
+
+		std::string prefix = std::filesystem::path(path).filename().string() + " (" +
+			std::to_string(std::filesystem::file_size(path) / 1024) + "KB), ";
+		Tests::Report(prefix + "legacy iostream parse", legacyMs);
+		Tests::Report(prefix + "tokenizer parse", serialMs);
+		Tests::Report(prefix + "tokenizer parse, " + std::to_string(jobs.NumThreads()) + " threads", parallelMs);
+		Tests::Report(prefix + "speedup", legacyMs / serialMs, "x");
+	}
+
+	std::error_code error;
+	std::filesystem::remove_all(folder, error);
+}
@@ -0,0 +1,220 @@
+#include "TestFramework.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+
+#include "Utils/ObjLoader.h"
+#include "Utils/OptimizedObjLoader.h"
+
+// Exposes the old file header, so that the tests can write version 1 files
+class BinaryFormats : public OptimizedObjLoader {
+public:
+	using OptimizedObjLoader::BinaryHeaderV1;
+};
+
+static std::filesystem::path MakeTestFolder(const std::string& name) {
+	std::filesystem::path folder = std::filesystem::temp_directory_path() / name;
+	std::filesystem::remove_all(folder);
+	std::filesystem::create_directories(folder);
+	return folder;
+}
+
+// Writes a mesh in the version 1 layout, a header followed by the attributes, 32 bit indices and vertices
+template <typename VertexType>
+static void WriteV1File(MeshBuilder<VertexType>& mesh, const std::string& path) {
+	BinaryFormats::BinaryHeaderV1 header;
+	header.Version = 1;
+	header.NumIndices = static_cast<uint32_t>(mesh.GetIndexCount());
+	header.IndicesType = IndexType::UInt;
+	header.NumVertices = static_cast<uint32_t>(mesh.GetVertexCount());
+	header.VertexStride = sizeof(VertexType);
+	header.NumAttributes = static_cast<uint8_t>(VertexType::V_DECL.size());
+
+	std::ofstream file(path, std::ios::binary);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(VertexType::V_DECL.data()), VertexType::V_DECL.size() * sizeof(BufferAttribute));
+	file.write(reinterpret_cast<const char*>(mesh.GetIndexDataPtr()), mesh.GetIndexCount() * sizeof(uint32_t));
+	file.write(reinterpret_cast<const char*>(mesh.GetVertexDataPtr()), mesh.GetVertexCount() * sizeof(VertexType));
+}
+
+// Reads a buffer back from OpenGL
+static std::vector<uint8_t> ReadBuffer(const IBuffer::Sptr& buffer) {
+	std::vector<uint8_t> result(buffer != nullptr ? buffer->GetTotalSize() : 0);
+	if (!result.empty()) {
+		glGetNamedBufferSubData(buffer->GetHandle(), 0, result.size(), result.data());
+	}
+	return result;
+}
+
+static std::vector<uint8_t> ReadFile(const std::filesystem::path& path) {
+	std::ifstream file(path, std::ios::binary);
+	return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static void WriteFile(const std::filesystem::path& path, const std::vector<uint8_t>& contents) {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char*>(contents.data()), contents.size());
+}
+
+// Returns true if both meshes upload exactly the same vertices, indices, submeshes and levels of detail
+static bool SameGeometry(const VertexArrayObject::Sptr& expected, const VertexArrayObject::Sptr& actual) {
+	if (expected->GetVertexCount() != actual->GetVertexCount() || expected->GetIndexCount() != actual->GetIndexCount() ||
+		expected->GetSubmeshes().size() != actual->GetSubmeshes().size() || expected->GetLods().size() != actual->GetLods().size()) {
+		return false;
+	}
+	if (ReadBuffer(expected->GetIndexBuffer()) != ReadBuffer(actual->GetIndexBuffer()) ||
+		ReadBuffer(expected->GetBufferBinding(AttribUsage::Position)->GetBuffer()) != ReadBuffer(actual->GetBufferBinding(AttribUsage::Position)->GetBuffer())) {
+		return false;
+	}
+	for (size_t ix = 0; ix < expected->GetSubmeshes().size(); ix++) {
+		if (expected->GetSubmeshes()[ix].FirstIndex != actual->GetSubmeshes()[ix].FirstIndex ||
+			expected->GetSubmeshes()[ix].IndexCount != actual->GetSubmeshes()[ix].IndexCount) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE(OptimizedObjLoader_RebuildsDamagedBinaries) {
+	if (!Tests::InitGL()) {
+		Tests::Report("No OpenGL context, skipped", 0.0, "");
+		return;
+	}
+
+	// Each way that a binary file can go bad, applied to a good binary file next to it's OBJ
+	struct Damage {
+		const char* Name;
+		std::function<void(const std::filesystem::path& obj, const std::filesystem::path& bin)> Apply;
+	};
+	const std::vector<Damage> damages = {
+		{ "corrupt header", [](const auto&, const auto& bin) {
+			std::vector<uint8_t> contents = ReadFile(bin);
+			memcpy(contents.data(), "XXXX", 4);
+			WriteFile(bin, contents);
+		} },
+		{ "truncated", [](const auto&, const auto& bin) {
+			std::vector<uint8_t> contents = ReadFile(bin);
+			contents.resize(contents.size() / 2);
+			WriteFile(bin, contents);
+		} },
+		{ "checksum mismatch", [](const auto&, const auto& bin) {
+			// Somewhere in the vertex data, the header and section table are still intact
+			std::vector<uint8_t> contents = ReadFile(bin);
+			contents[contents.size() * 3 / 4] ^= 0x5A;
+			WriteFile(bin, contents);
+		} },
+		{ "stale", [](const auto& obj, const auto&) {
+			// A comment doesn't change the mesh, but the binary no longer matches the OBJ it was built from
+			std::ofstream file(obj, std::ios::app);
+			file << "\n# Edited after the binary was built\n";
+		} }
+	};
+
+	for (const Damage& damage : damages) {
+		std::filesystem::path folder = MakeTestFolder("optimized_obj_damage_test");
+		std::filesystem::path obj = folder / "monkey.obj";
+		std::filesystem::path bin = folder / "monkey.bin";
+		std::filesystem::copy_file("res/monkey.obj", obj);
+
+		VertexArrayObject::Sptr expected = OptimizedObjLoader::LoadFromFile(obj.string());
+		REQUIRE(expected != nullptr);
+		REQUIRE(std::filesystem::is_regular_file(bin));
+		const std::vector<uint8_t> good = ReadFile(bin);
+
+		damage.Apply(obj, bin);
+		const std::vector<uint8_t> damaged = ReadFile(bin);
+
+		OptimizedObjLoader::MeshInfo info;
+		VertexArrayObject::Sptr recovered = OptimizedObjLoader::LoadFromFile(obj.string(), &info);
+		REQUIRE(recovered != nullptr);
+		CHECK(SameGeometry(expected, recovered));
+		CHECK(info.HasBounds);
+		CHECK(info.Lods.size() == recovered->GetLods().size());
+
+		// The binary should have been rebuilt, and be good enough to load on it's own
+		const std::vector<uint8_t> rebuilt = ReadFile(bin);
+		CHECK(rebuilt != damaged);
+		CHECK(!std::filesystem::exists(folder / "monkey.bin.tmp"));
+		if (damage.Name != std::string("stale")) {
+			CHECK(rebuilt == good);
+		}
+		VertexArrayObject::Sptr fromBinary = OptimizedObjLoader::LoadFromFile(bin.string());
+		REQUIRE(fromBinary != nullptr);
+		CHECK(SameGeometry(expected, fromBinary));
+
+		std::filesystem::remove_all(folder);
+	}
+}
+
+TEST_CASE(OptimizedObjLoader_FallsBackWhenBinaryCantBeWritten) {
+	if (!Tests::InitGL()) {
+		Tests::Report("No OpenGL context, skipped", 0.0, "");
+		return;
+	}
+
+	std::filesystem::path folder = MakeTestFolder("optimized_obj_fallback_test");
+	std::filesystem::copy_file("res/monkey.obj", folder / "monkey.obj");
+
+	// A folder where the binary file should go means it can never be written
+	std::filesystem::create_directories(folder / "monkey.bin");
+
+	OptimizedObjLoader::MeshInfo info;
+	VertexArrayObject::Sptr mesh = OptimizedObjLoader::LoadFromFile((folder / "monkey.obj").string(), &info);
+	REQUIRE(mesh != nullptr);
+	CHECK(mesh->GetVertexCount() > 0);
+	CHECK(mesh->GetIndexCount() > 0);
+	CHECK(info.HasBounds);
+	CHECK(info.Submeshes.size() == mesh->GetSubmeshes().size());
+	CHECK(info.Lods.size() == mesh->GetLods().size());
+	CHECK(std::filesystem::is_directory(folder / "monkey.bin"));
+	CHECK(!std::filesystem::exists(folder / "monkey.bin.tmp"));
+
+	// Once the path is free it should be written, and give the same mesh back
+	std::filesystem::remove_all(folder / "monkey.bin");
+	VertexArrayObject::Sptr converted = OptimizedObjLoader::LoadFromFile((folder / "monkey.obj").string());
+	REQUIRE(converted != nullptr);
+	CHECK(std::filesystem::is_regular_file(folder / "monkey.bin"));
+	CHECK(converted->GetVertexCount() == mesh->GetVertexCount());
+	CHECK(converted->GetIndexCount() == mesh->GetIndexCount());
+
+	std::filesystem::remove_all(folder);
+}
+
+TEST_CASE(OptimizedObjLoader_BenchmarkV1VsCurrent) {
+	if (!Tests::InitGL()) {
+		Tests::Report("No OpenGL context, skipped", 0.0, "");
+		return;
+	}
+
+	std::filesystem::path folder = MakeTestFolder("optimized_obj_benchmark");
+	for (const char* name : { "monkey", "test" }) {
+		MeshBuilder<VertexPosNormTexColTangents> mesh = ObjLoader::LoadMeshFromFile(std::string("res/") + name + ".obj");
+		std::string v1Path = (folder / (std::string(name) + "-v1.bin")).string();
+		std::string currentPath = (folder / (std::string(name) + ".bin")).string();
+		WriteV1File(mesh, v1Path);
+		OptimizedObjLoader::SaveBinaryFile(mesh, currentPath);
+
+		VertexArrayObject::Sptr v1 = OptimizedObjLoader::LoadFromFile(v1Path);
+		VertexArrayObject::Sptr current = OptimizedObjLoader::LoadFromFile(currentPath);
+		REQUIRE(v1 != nullptr);
+		REQUIRE(current != nullptr);
+		CHECK(v1->GetVertexCount() == current->GetVertexCount());
+		CHECK(v1->GetIndexCount() == current->GetIndexCount());
+
+		// glFinish so the time includes the uploads actually completing
+		double v1Ms = Tests::TimeMs([&]() { v1 = OptimizedObjLoader::LoadFromFile(v1Path); glFinish(); }, 20);
+		double currentMs = Tests::TimeMs([&]() { current = OptimizedObjLoader::LoadFromFile(currentPath); glFinish(); }, 20);
+
+		std::string prefix = std::string(name) + ".obj (" + std::to_string(mesh.GetVertexCount()) + " vertices), ";
+		Tests::Report(prefix + "v1 load", v1Ms);
+		Tests::Report(prefix + "v" + std::to_string(OptimizedObjLoader::GetBinaryVersion()) + " load", currentMs);
+		Tests::Report(prefix + "speedup", v1Ms / currentMs, "x");
+		Tests::Report(prefix + "v1 size", std::filesystem::file_size(v1Path) / 1024.0, "KB");
+		Tests::Report(prefix + "v" + std::to_string(OptimizedObjLoader::GetBinaryVersion()) + " size", std::filesystem::file_size(currentPath) / 1024.0, "KB");
+	}
+
+	std::filesystem::remove_all(folder);
+}
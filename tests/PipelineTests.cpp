@@ -0,0 +1,195 @@
+#include "TestFramework.h"
+
+#include "Application/JobSystem.h"
+#include "Application/FrameGraph.h"
+#include "Application/FrameLoop.h"
+#include "Application/SnapshotBuffer.h"
+#include "Gameplay/Scene.h"
+#include "Gameplay/Components/ComponentManager.h"
+#include "Gameplay/Components/RotatingBehaviour.h"
+
+using namespace Gameplay;
+
+// A parallel component that moves it's object along a fixed velocity
+class DriftBehaviour : public IComponent {
+public:
+	typedef std::shared_ptr<DriftBehaviour> Sptr;
+
+	glm::vec3 Velocity = glm::vec3(0.0f);
+
+	virtual void Update(float deltaTime) override {
+		GetGameObject()->SetPostion(GetGameObject()->GetPosition() + Velocity * deltaTime);
+	}
+	virtual UpdateAccess GetUpdateAccess() const override { return UpdateAccess::Parallel(); }
+
+	virtual void RenderImGui() override {}
+	virtual nlohmann::json ToJson() const override { return nlohmann::json::object(); }
+	static DriftBehaviour::Sptr FromJson(const nlohmann::json&) { return std::make_shared<DriftBehaviour>(); }
+	MAKE_TYPENAME(DriftBehaviour);
+};
+
+// What a frame would draw, the interpolated world transform of every object, along with the
+// simulated transforms and the blend factor that it was interpolated from
+struct FrameOutput {
+	std::vector<glm::mat4> Rendered;
+	std::vector<glm::mat4> Simulated;
+	float                  Alpha = 0.0f;
+};
+
+static const float FixedDeltaTime = 1.0f / 60.0f;
+static const int   MaxTicksPerFrame = 3;
+
+static Scene::Sptr BuildScene(size_t count) {
+	Scene::Sptr scene = std::make_shared<Scene>();
+	scene->IsPlaying = true;
+	for (size_t ix = 0; ix < count; ix++) {
+		GameObject::Sptr object = scene->CreateGameObject("Object");
+		object->SetPostion(glm::vec3(static_cast<float>(ix % 50), static_cast<float>(ix / 50), 0.0f));
+		object->Add<RotatingBehaviour>()->RotationSpeed = glm::vec3(0.0f, 0.0f, 30.0f + (ix % 11));
+		object->Add<DriftBehaviour>()->Velocity = glm::vec3(0.0f, 0.0f, 1.0f + (ix % 5));
+	}
+	return scene;
+}
+
+// Runs frames through the same FrameLoop as Application::_Run, with the render layer's capture cut
+// down to copying the transforms into a snapshot, and rendering cut down to keeping the snapshot
+static std::vector<FrameOutput> RunFrames(JobSystem& jobs, bool pipelined, const std::vector<float>& frameTimes) {
+	const size_t count = 2000;
+	Scene::Sptr scene = BuildScene(count);
+	std::vector<GameObject*> objects;
+	for (size_t ix = 0; ix < count; ix++) {
+		objects.push_back(scene->GetObjectByIndex(static_cast<int>(ix)).get());
+	}
+
+	FrameGraph frame(jobs);
+	FrameLoop loop(jobs, frame);
+	loop.FixedDeltaTime = FixedDeltaTime;
+	loop.MaxTicksPerFrame = MaxTicksPerFrame;
+	loop.IsPipelined = pipelined;
+
+	SnapshotBuffer<FrameOutput> snapshots;
+	std::vector<FrameOutput> result;
+
+	FrameLoop::Stages stages;
+	// Same as LogicUpdateLayer::OnFixedUpdate
+	stages.Simulate = [&](int ticks) {
+		for (int tick = 0; tick < ticks; tick++) {
+			frame.Run(FramePhase::Update, [&]() { scene->Update(FixedDeltaTime, &jobs); });
+			frame.Run(FramePhase::Physics, [&]() { scene->DoPhysics(FixedDeltaTime); });
+		}
+	};
+	// Captured on the job system, split up the same way the render layer culls
+	stages.Capture = [&](float alpha) {
+		scene->InterpolateTransforms(alpha);
+		FrameOutput& capture = snapshots.Back();
+		capture.Rendered.resize(count);
+		capture.Simulated.resize(count);
+		capture.Alpha = alpha;
+		frame.ParallelFor(FramePhase::BuildDrawList, count, 64, [&](size_t begin, size_t end) {
+			for (size_t ix = begin; ix < end; ix++) {
+				capture.Rendered[ix] = objects[ix]->GetRenderTransform();
+				capture.Simulated[ix] = objects[ix]->GetTransform();
+			}
+		});
+	};
+	// "Draw" the frame while the next one is simulated
+	stages.Render = [&]() {
+		frame.Wait(FramePhase::BuildDrawList);
+		snapshots.Publish();
+		result.push_back(snapshots.Front());
+	};
+
+	for (float dt : frameTimes) {
+		loop.RunFrame(dt, stages);
+		loop.EndFrame();
+	}
+	return result;
+}
+
+// Counts the frames where part of the output differs, comparing expected[ix] to actual[ix + offset]
+template <typename T>
+static size_t CountMismatchedFrames(const std::vector<FrameOutput>& expected, const std::vector<FrameOutput>& actual, T FrameOutput::* part, size_t offset = 0) {
+	size_t mismatches = 0;
+	for (size_t ix = 0; ix + offset < actual.size() && ix < expected.size(); ix++) {
+		mismatches += expected[ix].*part != actual[ix + offset].*part ? 1 : 0;
+	}
+	return mismatches;
+}
+
+// Uneven frame times, so frames run anywhere from 0 to MaxTicksPerFrame ticks
+static std::vector<float> VariableFrameTimes() {
+	std::vector<float> frameTimes;
+	const float pattern[] = { 0.010f, 0.025f, 0.0166f, 0.040f, 0.005f, 0.070f, 0.012f };
+	for (int ix = 0; ix < 60; ix++) {
+		frameTimes.push_back(pattern[ix % 7]);
+	}
+	return frameTimes;
+}
+
+TEST_CASE(Pipeline_MatchesSingleThreadedFrameForFrame) {
+	Tests::InitEngine();
+	ComponentManager::RegisterType<DriftBehaviour>();
+
+	std::vector<float> frameTimes = VariableFrameTimes();
+
+	// With no workers, every job runs on the main thread when it's waited on
+	JobSystem singleThreaded(0);
+	std::vector<FrameOutput> expected = RunFrames(singleThreaded, true, frameTimes);
+	CHECK(expected.size() == frameTimes.size());
+
+	for (int workers : { 1, 3, -1 }) {
+		JobSystem jobs(workers);
+		std::vector<FrameOutput> actual = RunFrames(jobs, true, frameTimes);
+		CHECK(actual.size() == expected.size());
+		CHECK(CountMismatchedFrames(expected, actual, &FrameOutput::Rendered) == 0);
+	}
+}
+
+TEST_CASE(Pipeline_TrailsSerialByOneFrame) {
+	Tests::InitEngine();
+	ComponentManager::RegisterType<DriftBehaviour>();
+
+	// One tick per frame, so the only difference pipelining should make is drawing a frame later
+	std::vector<float> frameTimes(60, FixedDeltaTime);
+
+	JobSystem serialJobs(0);
+	std::vector<FrameOutput> serial = RunFrames(serialJobs, false, frameTimes);
+	JobSystem pipelinedJobs(3);
+	std::vector<FrameOutput> pipelined = RunFrames(pipelinedJobs, true, frameTimes);
+
+	// Nothing has moved by the first pipelined frame, so things only differ from there on
+	CHECK(serial.front().Rendered != serial.back().Rendered);
+	CHECK(CountMismatchedFrames(serial, pipelined, &FrameOutput::Rendered, 1) == 0);
+}
+
+TEST_CASE(Pipeline_TrailsSerialWithVariableFrameTimes) {
+	Tests::InitEngine();
+	ComponentManager::RegisterType<DriftBehaviour>();
+
+	std::vector<float> frameTimes = VariableFrameTimes();
+	JobSystem serialJobs(0);
+	std::vector<FrameOutput> serial = RunFrames(serialJobs, false, frameTimes);
+	JobSystem pipelinedJobs(3);
+	std::vector<FrameOutput> pipelined = RunFrames(pipelinedJobs, true, frameTimes);
+	CHECK(serial.size() == frameTimes.size());
+	CHECK(pipelined.size() == frameTimes.size());
+
+	// Each pipelined frame shows the ticks that the serial frame before it ran, with the blend
+	// factor of it's own frame, since the frame times are the same
+	CHECK(serial.front().Simulated != serial.back().Simulated);
+	CHECK(CountMismatchedFrames(serial, pipelined, &FrameOutput::Simulated, 1) == 0);
+	CHECK(CountMismatchedFrames(serial, pipelined, &FrameOutput::Alpha) == 0);
+
+	// Frames with no ticks reuse the previous frame's ticks, so where two serial frames in a row
+	// show the same ticks, the pipelined frame in between must render exactly what the serial one did
+	size_t compared = 0;
+	size_t mismatches = 0;
+	for (size_t ix = 1; ix < serial.size(); ix++) {
+		if (serial[ix].Simulated == serial[ix - 1].Simulated) {
+			compared++;
+			mismatches += serial[ix].Rendered != pipelined[ix].Rendered ? 1 : 0;
+		}
+	}
+	CHECK(compared > 0);
+	CHECK(mismatches == 0);
+}
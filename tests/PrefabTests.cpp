@@ -0,0 +1,184 @@
+#include "TestFramework.h"
+
+#include "Gameplay/Scene.h"
+#include "Gameplay/Prefab.h"
+#include "Gameplay/Components/RotatingBehaviour.h"
+#include "Gameplay/Components/JumpBehaviour.h"
+#include "Gameplay/Components/MaterialSwapBehaviour.h"
+#include "Gameplay/Components/TriggerVolumeEnterBehaviour.h"
+#include "Gameplay/Components/SimpleCameraControl.h"
+#include "Gameplay/Components/PlayerController.h"
+#include "Gameplay/Components/EnemyScript.h"
+#include "Gameplay/Components/TopEnemyScript.h"
+#include "Gameplay/Components/Bolt.h"
+#include "Gameplay/Components/Light.h"
+#include "Gameplay/Physics/RigidBody.h"
+#include "Gameplay/Physics/Colliders/BoxCollider.h"
+
+using namespace Gameplay;
+using namespace Gameplay::Physics;
+
+// Gets the components of the given types from an object, nullptr for any that are missing
+template <typename ... Types>
+static std::vector<IComponent::Sptr> GetAll(const GameObject::Sptr& object) {
+	return { std::static_pointer_cast<IComponent>(object->Get<Types>())... };
+}
+#define TEN_COMPONENTS RotatingBehaviour, JumpBehaviour, MaterialSwapBehaviour, TriggerVolumeEnterBehaviour, \
+	SimpleCameraControl, PlayerController, EnemyScript, TopEnemyScript, Bolt, Light
+
+// Builds an object with ten components, like a typical spawned enemy
+static GameObject::Sptr CreateTenComponentObject(const Scene::Sptr& scene) {
+	GameObject::Sptr object = scene->CreateGameObject("Template");
+	object->SetPostion(glm::vec3(1.0f, 2.0f, 3.0f));
+	object->Add<RotatingBehaviour>()->RotationSpeed = glm::vec3(0.0f, 0.0f, 90.0f);
+	object->Add<JumpBehaviour>();
+	object->Add<MaterialSwapBehaviour>();
+	object->Add<TriggerVolumeEnterBehaviour>();
+	object->Add<SimpleCameraControl>();
+	object->Add<PlayerController>();
+	object->Add<EnemyScript>();
+	object->Add<TopEnemyScript>();
+	object->Add<Bolt>();
+	object->Add<Light>();
+	return object;
+}
+
+TEST_CASE(Prefab_InstanceMatchesTemplate) {
+	Tests::InitEngine();
+	Scene::Sptr scene = std::make_shared<Scene>();
+	GameObject::Sptr source = CreateTenComponentObject(scene);
+	Prefab::Sptr prefab = Prefab::FromGameObject(source);
+
+	GameObject::Sptr instance = prefab->Instantiate(scene.get());
+	REQUIRE(instance != nullptr);
+	CHECK(instance != source);
+	CHECK(instance->GetGUID() != source->GetGUID());
+	CHECK(instance->GetPosition() == source->GetPosition());
+	std::vector<IComponent::Sptr> sourceComponents = GetAll<TEN_COMPONENTS>(source);
+	std::vector<IComponent::Sptr> instanceComponents = GetAll<TEN_COMPONENTS>(instance);
+	for (size_t ix = 0; ix < sourceComponents.size(); ix++) {
+		REQUIRE(instanceComponents[ix] != nullptr);
+		CHECK(instanceComponents[ix] != sourceComponents[ix]);
+		CHECK(instanceComponents[ix]->GetGUID() != sourceComponents[ix]->GetGUID());
+		CHECK(instanceComponents[ix]->GetGameObject() == instance.get());
+	}
+	CHECK(instance->Get<RotatingBehaviour>()->RotationSpeed == glm::vec3(0.0f, 0.0f, 90.0f));
+
+	// Instances must not share state with the template
+	instance->Get<RotatingBehaviour>()->RotationSpeed = glm::vec3(1.0f);
+	CHECK(prefab->Instantiate(scene.get())->Get<RotatingBehaviour>()->RotationSpeed == glm::vec3(0.0f, 0.0f, 90.0f));
+}
+
+TEST_CASE(Prefab_PoolResetsToTemplate) {
+	Tests::InitEngine();
+	Scene::Sptr scene = std::make_shared<Scene>();
+	GameObject::Sptr source = CreateTenComponentObject(scene);
+	Prefab::Sptr prefab = Prefab::FromGameObject(source);
+	// Only the pooled instances should be left in the scene when we update it
+	scene->RemoveGameObject(source);
+	PrefabPool pool(prefab, scene.get(), 2);
+	CHECK(pool.NumFree() == 2);
+	CHECK(pool.NumActive() == 0);
+
+	GameObject::Sptr first = pool.Spawn();
+	first->SetPostion(glm::vec3(10.0f));
+	first->Get<RotatingBehaviour>()->RotationSpeed = glm::vec3(5.0f);
+	CHECK(pool.Release(first));
+	CHECK(!pool.Release(first));
+	for (const auto& component : GetAll<TEN_COMPONENTS>(first)) {
+		CHECK(!component->IsEnabled);
+	}
+
+	// Released instances sit out of the scene update, even if something turns a component back on
+	scene->IsPlaying = true;
+	first->Get<RotatingBehaviour>()->IsEnabled = true;
+	glm::quat releasedRotation = first->GetRotation();
+	scene->Update(1.0f);
+	CHECK(first->GetRotation() == releasedRotation);
+
+	// The pool hands back the instance we released, in it's template state
+	GameObject::Sptr second = pool.Spawn();
+	CHECK(second == first);
+	CHECK(second->GetPosition() == glm::vec3(1.0f, 2.0f, 3.0f));
+	CHECK(second->Get<RotatingBehaviour>()->RotationSpeed == glm::vec3(0.0f, 0.0f, 90.0f));
+	for (const auto& component : GetAll<TEN_COMPONENTS>(second)) {
+		CHECK(component->IsEnabled);
+	}
+}
+
+TEST_CASE(Prefab_PoolRemovesBodiesFromWorld) {
+	Tests::InitEngine();
+	Scene::Sptr scene = std::make_shared<Scene>();
+	GameObject::Sptr source = scene->CreateGameObject("Body");
+	RigidBody::Sptr sourceBody = source->Add<RigidBody>(RigidBodyType::Dynamic);
+	sourceBody->AddCollider(BoxCollider::Create());
+	Prefab::Sptr prefab = Prefab::FromGameObject(source);
+
+	PrefabPool pool(prefab, scene.get());
+	GameObject::Sptr instance = pool.Spawn();
+	// The test scene is never awoken, so we wake the instance ourselves to create it's body
+	instance->Awake();
+	int inWorld = scene->GetPhysicsWorld()->getNumCollisionObjects();
+	CHECK(instance->Get<RigidBody>()->IsInWorld());
+
+	// Released instances must not collide with anything
+	CHECK(pool.Release(instance));
+	CHECK(!instance->Get<RigidBody>()->IsInWorld());
+	CHECK(scene->GetPhysicsWorld()->getNumCollisionObjects() == inWorld - 1);
+
+	// Respawning gets a body back into the world, without leaving the old one behind
+	GameObject::Sptr respawned = pool.Spawn();
+	respawned->Awake();
+	CHECK(respawned->Get<RigidBody>()->IsInWorld());
+	CHECK(scene->GetPhysicsWorld()->getNumCollisionObjects() == inWorld);
+}
+
+TEST_CASE(Prefab_BenchmarkInstantiate) {
+	Tests::InitEngine();
+	const int count = 1000;
+	Scene::Sptr scene = std::make_shared<Scene>();
+	GameObject::Sptr source = CreateTenComponentObject(scene);
+	Prefab::Sptr prefab = Prefab::FromGameObject(source);
+
+	// The old way of cloning an object, which pays for the JSON round trip on every spawn
+	std::vector<GameObject::Sptr> created;
+	created.reserve(count);
+	double jsonMs = Tests::TimeMs([&]() {
+		created.clear();
+		for (int ix = 0; ix < count; ix++) {
+			nlohmann::json blob = source->ToJson();
+			created.push_back(GameObject::FromJson(scene.get(), blob));
+		}
+	});
+	CHECK(created.size() == count);
+	for (const auto& component : GetAll<TEN_COMPONENTS>(created.back())) {
+		CHECK(component != nullptr);
+	}
+	created.clear();
+
+	double prefabMs = Tests::TimeMs([&]() {
+		for (int ix = 0; ix < count; ix++) {
+			created.push_back(prefab->Instantiate(scene.get()));
+		}
+		for (const auto& object : created) {
+			scene->RemoveGameObject(object);
+		}
+		created.clear();
+	});
+
+	PrefabPool pool(prefab, scene.get(), count);
+	double pooledMs = Tests::TimeMs([&]() {
+		for (int ix = 0; ix < count; ix++) {
+			created.push_back(pool.Spawn());
+		}
+		for (const auto& object : created) {
+			pool.Release(object);
+		}
+		created.clear();
+	});
+
+	Tests::Report("1000 x 10 component objects, JSON round trip", jsonMs);
+	Tests::Report("1000 x 10 component objects, Prefab::Instantiate", prefabMs);
+	Tests::Report("1000 x 10 component objects, PrefabPool::Spawn + Release", pooledMs);
+	Tests::Report("Prefab::Instantiate speedup over JSON round trip", jsonMs / prefabMs, "x");
+}
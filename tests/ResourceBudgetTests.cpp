@@ -0,0 +1,218 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <filesystem>
+
+#include "Utils/ResourceManager/ResourceManager.h"
+#include "Graphics/Textures/Texture2D.h"
+
+// Stands in for generated meshes, every resource with the same key shares a block of memory
+class SharedBlockResource : public IResource {
+public:
+	typedef std::shared_ptr<SharedBlockResource> Sptr;
+
+	static constexpr size_t OwnBytes = 100;
+	static constexpr size_t SharedBytes = 1000;
+
+	uint64_t Key;
+
+	SharedBlockResource(uint64_t key) : IResource(), Key(key) {}
+
+	virtual nlohmann::json ToJson() const override { return { { "key", Key } }; }
+	static SharedBlockResource::Sptr FromJson(const nlohmann::json& blob) { return std::make_shared<SharedBlockResource>(blob["key"].get<uint64_t>()); }
+	virtual bool CanReload() const override { return true; }
+	virtual ResourceMemoryUsage GetMemoryUsage() const override {
+		ResourceMemoryUsage result = { OwnBytes, 0 };
+		result.Shared = SharedBytes;
+		result.SharedKey = Key;
+		return result;
+	}
+};
+
+// A resource that counts how many times the resource manager has measured it
+class CountedResource : public IResource {
+public:
+	typedef std::shared_ptr<CountedResource> Sptr;
+
+	static constexpr size_t Bytes = 100;
+	static inline size_t NumMeasured = 0;
+
+	virtual nlohmann::json ToJson() const override { return nlohmann::json::object(); }
+	static CountedResource::Sptr FromJson(const nlohmann::json&) { return std::make_shared<CountedResource>(); }
+	virtual bool CanReload() const override { return true; }
+	virtual ResourceMemoryUsage GetMemoryUsage() const override {
+		NumMeasured++;
+		return { Bytes, 0 };
+	}
+};
+
+// Gets the GUIDs of every texture in res/textures, loading them through the resource manager
+static std::vector<Guid> LoadAllTextures() {
+	std::vector<Guid> result;
+	for (const auto& file : std::filesystem::directory_iterator("res/textures")) {
+		if (file.is_regular_file() && file.path().extension() == ".png") {
+			Texture2D::Sptr texture = ResourceManager::CreateAsset<Texture2D>(file.path().generic_string());
+			result.push_back(texture->GetGUID());
+		}
+	}
+	return result;
+}
+
+TEST_CASE(ResourceBudget_CyclingTexturesStaysWithinBudget) {
+	Tests::InitEngine();
+	if (!Tests::InitGL()) {
+		Tests::Report("No OpenGL context, skipped", 0.0, "");
+		return;
+	}
+	const std::string& typeName = ResourceTypeInfo<Texture2D>::Name();
+
+	std::vector<Guid> textures = LoadAllTextures();
+	REQUIRE(textures.size() > 4);
+	ResourceManager::Update();
+
+	// Remember what every texture looks like, so we can tell that reloading gives back the same thing
+	std::vector<glm::uvec2> sizes;
+	size_t largest = 0;
+	for (Guid id : textures) {
+		Texture2D::Sptr texture = ResourceManager::Get<Texture2D>(id);
+		REQUIRE(texture != nullptr);
+		sizes.push_back(glm::uvec2(texture->GetWidth(), texture->GetHeight()));
+		largest = std::max(largest, texture->GetMemoryUsage().Total());
+	}
+
+	// Room for a few textures at a time, but nowhere near all of them
+	size_t budget = largest * 3;
+	ResourceManager::SetMemoryBudget(typeName, budget);
+	ResourceManager::Update();
+	CHECK(ResourceManager::GetMemoryUsage(typeName) <= budget);
+
+	// Something outside the manager is holding on to this one, so it has to stay loaded
+	Texture2D::Sptr held = ResourceManager::Get<Texture2D>(textures[0]);
+
+	size_t numReloaded = 0;
+	size_t mismatches = 0;
+	for (int round = 0; round < 3; round++) {
+		for (size_t ix = 1; ix < textures.size(); ix++) {
+			if (!ResourceManager::IsLoaded(typeName, textures[ix])) {
+				numReloaded++;
+			}
+			Texture2D::Sptr texture = ResourceManager::Get<Texture2D>(textures[ix]);
+			REQUIRE(texture != nullptr);
+			CHECK(texture->GetGUID() == textures[ix]);
+			mismatches += glm::uvec2(texture->GetWidth(), texture->GetHeight()) != sizes[ix] ? 1 : 0;
+			texture = nullptr;
+
+			ResourceManager::Update();
+			CHECK(ResourceManager::GetMemoryUsage(typeName) <= budget);
+			CHECK(ResourceManager::IsLoaded(typeName, textures[0]));
+		}
+	}
+	CHECK(mismatches == 0);
+	// The budget can't fit every texture, so some must have been evicted and loaded again
+	CHECK(numReloaded > 0);
+
+	Tests::Report("Texture budget", budget / (1024.0 * 1024.0), "MB");
+	Tests::Report("Textures reloaded over 3 rounds", numReloaded, "textures");
+
+	held = nullptr;
+	ResourceManager::SetMemoryBudget(typeName, 0);
+}
+
+TEST_CASE(ResourceBudget_SharedMemoryIsCountedOnce) {
+	ResourceManager::RegisterType<SharedBlockResource>();
+	const std::string& typeName = ResourceTypeInfo<SharedBlockResource>::Name();
+	const size_t own = SharedBlockResource::OwnBytes;
+	const size_t shared = SharedBlockResource::SharedBytes;
+
+	// Created oldest first, so a1 and a2 are the first to be unloaded
+	Guid a1 = ResourceManager::CreateAsset<SharedBlockResource>(0xA)->GetGUID();
+	Guid a2 = ResourceManager::CreateAsset<SharedBlockResource>(0xA)->GetGUID();
+	SharedBlockResource::Sptr a3 = ResourceManager::CreateAsset<SharedBlockResource>(0xA);
+	SharedBlockResource::Sptr b1 = ResourceManager::CreateAsset<SharedBlockResource>(0xB);
+	ResourceManager::Update();
+	CHECK(ResourceManager::GetMemoryUsage(typeName) == own * 4 + shared * 2);
+
+	// a3 still uses the shared block, so unloading a1 and a2 only frees their own memory
+	ResourceManager::SetMemoryBudget(typeName, own + shared + 200);
+	ResourceManager::Update();
+	CHECK(!ResourceManager::IsLoaded(typeName, a1));
+	CHECK(!ResourceManager::IsLoaded(typeName, a2));
+	CHECK(ResourceManager::GetMemoryUsage(typeName) == own * 2 + shared * 2);
+
+	// Once the last one goes, so does the shared block
+	Guid a3Id = a3->GetGUID();
+	a3 = nullptr;
+	ResourceManager::Update();
+	CHECK(!ResourceManager::IsLoaded(typeName, a3Id));
+	CHECK(ResourceManager::IsLoaded(typeName, b1->GetGUID()));
+	CHECK(ResourceManager::GetMemoryUsage(typeName) == own + shared);
+
+	b1 = nullptr;
+	ResourceManager::SetMemoryBudget(typeName, 0);
+}
+
+TEST_CASE(ResourceBudget_HandlesKeepResourcesInUse) {
+	ResourceManager::RegisterType<SharedBlockResource>();
+	const std::string& typeName = ResourceTypeInfo<SharedBlockResource>::Name();
+	const size_t own = SharedBlockResource::OwnBytes;
+	const size_t shared = SharedBlockResource::SharedBytes;
+
+	ResourceHandle<SharedBlockResource> older(ResourceManager::CreateAsset<SharedBlockResource>(0xC));
+	ResourceHandle<SharedBlockResource> newer(ResourceManager::CreateAsset<SharedBlockResource>(0xD));
+	REQUIRE(older.Get() != nullptr);
+	REQUIRE(newer.Get() != nullptr);
+	// The second access comes from the handle's cache, but should still count as a use
+	CHECK(older->Key == 0xC);
+	ResourceManager::Update();
+
+	// Only room for one of them, so the one that was used least recently goes
+	ResourceManager::SetMemoryBudget(typeName, own + shared + 200);
+	ResourceManager::Update();
+	CHECK(ResourceManager::IsLoaded(typeName, older.GetGUID()));
+	CHECK(!ResourceManager::IsLoaded(typeName, newer.GetGUID()));
+
+	// The handle notices that it's resource was unloaded, and loads it again from the manifest
+	REQUIRE(newer.Get() != nullptr);
+	CHECK(newer->GetGUID() == newer.GetGUID());
+	CHECK(newer->Key == 0xD);
+	CHECK(ResourceManager::IsLoaded(typeName, newer.GetGUID()));
+
+	// A resource that the manager doesn't own can't be resolved, even if we had a pointer to it
+	SharedBlockResource::Sptr stray = std::make_shared<SharedBlockResource>(0xE);
+	ResourceHandle<SharedBlockResource> strayHandle(stray);
+	CHECK(strayHandle.GetGUID() == stray->GetGUID());
+	CHECK(!strayHandle);
+
+	ResourceManager::SetMemoryBudget(typeName, 0);
+}
+
+TEST_CASE(ResourceBudget_InUseResourcesAreNotRemeasured) {
+	ResourceManager::RegisterType<CountedResource>();
+	const std::string& typeName = ResourceTypeInfo<CountedResource>::Name();
+
+	std::vector<CountedResource::Sptr> held;
+	for (int ix = 0; ix < 10; ix++) {
+		held.push_back(ResourceManager::CreateAsset<CountedResource>());
+	}
+	ResourceManager::Update();
+
+	// Everything is in use, so the first pass can't unload anything and the ones after it shouldn't bother trying
+	ResourceManager::SetMemoryBudget(typeName, CountedResource::Bytes * 5);
+	ResourceManager::Update();
+	size_t measuredAfterFirstPass = CountedResource::NumMeasured;
+	for (int frame = 0; frame < 100; frame++) {
+		ResourceManager::Update();
+	}
+	CHECK(CountedResource::NumMeasured == measuredAfterFirstPass);
+	CHECK(ResourceManager::GetMemoryUsage(typeName) == CountedResource::Bytes * 10);
+
+	// Letting go of some gives the next pass something to unload
+	Guid released = held[0]->GetGUID();
+	held.erase(held.begin(), held.begin() + 5);
+	ResourceManager::Update();
+	CHECK(!ResourceManager::IsLoaded(typeName, released));
+	CHECK(ResourceManager::GetMemoryUsage(typeName) == CountedResource::Bytes * 5);
+
+	held.clear();
+	ResourceManager::SetMemoryBudget(typeName, 0);
+}
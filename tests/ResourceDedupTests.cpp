@@ -0,0 +1,112 @@
+#include "TestFramework.h"
+
+#include "Utils/ResourceManager/ResourceManager.h"
+#include "Graphics/Textures/Texture2D.h"
+
+// A resource that is deduplicated by name, and can be changed after it is made
+class NamedResource : public IResource {
+public:
+	typedef std::shared_ptr<NamedResource> Sptr;
+
+	std::string Name;
+	int         Value;
+
+	NamedResource(const std::string& name) : IResource(), Name(name), Value(0) {}
+
+	void SetValue(int value) {
+		Value = value;
+		_ContentChanged();
+	}
+
+	static std::string GetContentKey(const std::string& name) { return name; }
+
+	virtual nlohmann::json ToJson() const override { return { { "name", Name }, { "value", Value } }; }
+	static NamedResource::Sptr FromJson(const nlohmann::json& blob) {
+		NamedResource::Sptr result = std::make_shared<NamedResource>(blob["name"].get<std::string>());
+		result->Value = blob["value"];
+		return result;
+	}
+	virtual bool CanReload() const override { return true; }
+	virtual ResourceMemoryUsage GetMemoryUsage() const override { return { 100, 0 }; }
+};
+
+TEST_CASE(ResourceDedup_SharesIdenticalAssets) {
+	ResourceManager::RegisterType<NamedResource>();
+	ResourceManager::TakeDedupStats();
+
+	NamedResource::Sptr first = ResourceManager::CreateAsset<NamedResource>("dedup-a");
+	NamedResource::Sptr same = ResourceManager::CreateAsset<NamedResource>("dedup-a");
+	NamedResource::Sptr other = ResourceManager::CreateAsset<NamedResource>("dedup-b");
+	CHECK(first == same);
+	CHECK(first != other);
+
+	ResourceManager::DedupStats stats = ResourceManager::TakeDedupStats();
+	CHECK(stats.NumResources == 1);
+	CHECK(stats.NumBytes == 100);
+}
+
+TEST_CASE(ResourceDedup_ChangedAssetsAreNotShared) {
+	ResourceManager::RegisterType<NamedResource>();
+	ResourceManager::TakeDedupStats();
+
+	// Once it's been changed, the asset no longer looks like what a fresh one with that name would
+	NamedResource::Sptr changed = ResourceManager::CreateAsset<NamedResource>("dedup-changed");
+	changed->SetValue(42);
+	NamedResource::Sptr fresh = ResourceManager::CreateAsset<NamedResource>("dedup-changed");
+	CHECK(fresh != changed);
+	CHECK(fresh->Value == 0);
+	CHECK(changed->Value == 42);
+
+	// The fresh asset takes over the key
+	NamedResource::Sptr again = ResourceManager::CreateAsset<NamedResource>("dedup-changed");
+	CHECK(again == fresh);
+	CHECK(ResourceManager::TakeDedupStats().NumResources == 1);
+}
+
+TEST_CASE(ResourceDedup_ReloadedAssetsAreNotShared) {
+	ResourceManager::RegisterType<NamedResource>();
+	const std::string& typeName = ResourceTypeInfo<NamedResource>::Name();
+
+	// Change the asset, then let the budget unload it so it comes back from the manifest with a new content version
+	Guid id;
+	{
+		NamedResource::Sptr changed = ResourceManager::CreateAsset<NamedResource>("dedup-reloaded");
+		changed->SetValue(7);
+		id = changed->GetGUID();
+	}
+	ResourceManager::Update();
+	ResourceManager::SetMemoryBudget(typeName, 1);
+	ResourceManager::Update();
+	ResourceManager::SetMemoryBudget(typeName, 0);
+	REQUIRE(!ResourceManager::IsLoaded(typeName, id));
+	NamedResource::Sptr reloaded = ResourceManager::Get<NamedResource>(id);
+	REQUIRE(reloaded != nullptr);
+	CHECK(reloaded->Value == 7);
+
+	NamedResource::Sptr fresh = ResourceManager::CreateAsset<NamedResource>("dedup-reloaded");
+	CHECK(fresh != reloaded);
+	CHECK(fresh->Value == 0);
+}
+
+TEST_CASE(ResourceDedup_TextureSettersDropTheKey) {
+	Tests::InitEngine();
+	if (!Tests::InitGL()) {
+		Tests::Report("No OpenGL context, skipped", 0.0, "");
+		return;
+	}
+
+	// The same as DefaultSceneLayer, which changes the filters on a texture it loaded
+	Texture2D::Sptr leaves = ResourceManager::CreateAsset<Texture2D>("res/textures/leaves.png");
+	CHECK(ResourceManager::CreateAsset<Texture2D>("res/textures/leaves.png") == leaves);
+	leaves->SetMinFilter(MinFilter::Nearest);
+	leaves->SetMagFilter(MagFilter::Nearest);
+
+	Texture2D::Sptr fresh = ResourceManager::CreateAsset<Texture2D>("res/textures/leaves.png");
+	CHECK(fresh != leaves);
+	CHECK(fresh->GetMinFilter() != MinFilter::Nearest);
+	CHECK(fresh->GetMagFilter() != MagFilter::Nearest);
+	CHECK(leaves->GetMinFilter() == MinFilter::Nearest);
+
+	// A different file is never shared
+	CHECK(ResourceManager::CreateAsset<Texture2D>("res/textures/box-diffuse.png") != fresh);
+}
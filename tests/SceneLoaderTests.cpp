@@ -0,0 +1,110 @@
+#include "TestFramework.h"
+
+#include <filesystem>
+#include <thread>
+
+#include "Application/JobSystem.h"
+#include "Application/SceneLoader.h"
+#include "Gameplay/Scene.h"
+#include "Gameplay/Components/ComponentManager.h"
+
+using namespace Gameplay;
+
+// How long the slow component takes to load and to wake up, in milliseconds
+static const double SlowStepMs = 0.25;
+
+static void BusyWait(double ms) {
+	auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(static_cast<int64_t>(ms * 1000.0));
+	while (std::chrono::steady_clock::now() < end) { }
+}
+
+// A component that is slow to load and to wake up, so that a handful of them fill a frame's budget
+class SlowToLoad : public IComponent {
+public:
+	typedef std::shared_ptr<SlowToLoad> Sptr;
+
+	bool IsAwake = false;
+
+	virtual void Awake() override {
+		BusyWait(SlowStepMs);
+		IsAwake = true;
+	}
+
+	virtual void RenderImGui() override {}
+	virtual nlohmann::json ToJson() const override { return nlohmann::json::object(); }
+	static SlowToLoad::Sptr FromJson(const nlohmann::json&) {
+		BusyWait(SlowStepMs);
+		return std::make_shared<SlowToLoad>();
+	}
+	MAKE_TYPENAME(SlowToLoad);
+};
+
+TEST_CASE(SceneLoader_YieldsWithinBudget) {
+	Tests::InitEngine();
+	// Waking the scene creates it's skybox mesh
+	if (!Tests::InitGL()) {
+		Tests::Report("No OpenGL context, skipped", 0.0, "");
+		return;
+	}
+	ComponentManager::RegisterType<SlowToLoad>();
+
+	// A fixed batch of 128 of these would take 32ms, several times the budget
+	const int count = 600;
+	std::filesystem::path folder = std::filesystem::temp_directory_path() / "scene_loader_test";
+	std::filesystem::create_directories(folder);
+	std::string path = (folder / "slow.json").string();
+	{
+		Scene::Sptr scene = std::make_shared<Scene>();
+		for (int ix = 0; ix < count; ix++) {
+			scene->CreateGameObject("Slow " + std::to_string(ix))->Add<SlowToLoad>();
+		}
+		scene->Save(path);
+	}
+
+	JobSystem jobs;
+	SceneLoader loader(jobs);
+	loader.Start(path);
+
+	const float budgetMs = 4.0f;
+	Scene::Sptr loaded = nullptr;
+	double maxMs = 0.0;
+	int ticks = 0;
+	float lastProgress = 0.0f;
+	bool progressWentBack = false;
+	while (loaded == nullptr && loader.IsLoading() && ticks < 100000) {
+		auto start = std::chrono::steady_clock::now();
+		loaded = loader.Tick(budgetMs);
+		maxMs = std::max(maxMs, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+		ticks++;
+
+		if (loaded == nullptr) {
+			progressWentBack |= loader.GetProgress() < lastProgress;
+			lastProgress = loader.GetProgress();
+			std::this_thread::yield();
+		}
+	}
+	REQUIRE(loaded != nullptr);
+	CHECK(loaded->NumObjects() == count);
+	CHECK(!progressWentBack);
+
+	int awake = 0;
+	for (int ix = 0; ix < count; ix++) {
+		SlowToLoad::Sptr component = loaded->GetObjectByIndex(ix)->Get<SlowToLoad>();
+		awake += component != nullptr && component->IsAwake ? 1 : 0;
+	}
+	CHECK(awake == count);
+
+	// A step only stops between components, so a frame runs over by at most one slow component,
+	// plus some slack for the scheduler
+	const double frameLimitMs = budgetMs + SlowStepMs + 2.0;
+	CHECK(maxMs < frameLimitMs);
+	// Loading and waking everything takes a few hundred milliseconds, which has to be spread over many frames
+	CHECK(ticks >= static_cast<int>(count * SlowStepMs * 2.0 / frameLimitMs));
+
+	Tests::Report("600 slow components, frames to load (4ms budget)", ticks, "frames");
+	Tests::Report("600 slow components, longest Tick (4ms budget)", maxMs);
+
+	loaded = nullptr;
+	std::error_code error;
+	std::filesystem::remove_all(folder, error);
+}
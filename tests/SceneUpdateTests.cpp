@@ -0,0 +1,261 @@
+#include "TestFramework.h"
+
+#include <thread>
+#include <unordered_set>
+
+#include "Application/JobSystem.h"
+#include "Gameplay/Scene.h"
+#include "Gameplay/Components/ComponentManager.h"
+#include "Gameplay/Components/RotatingBehaviour.h"
+
+using namespace Gameplay;
+
+// Scene::_UpdateObjects only hands a run to the job system once it's at least twice this long
+static constexpr size_t ParallelUpdateTestGrain = 256;
+
+// A parallel component that depends on RotatingBehaviour running first on the same object
+class SpinToScale : public IComponent {
+public:
+	typedef std::shared_ptr<SpinToScale> Sptr;
+
+	// The thread that last updated this component
+	std::thread::id UpdatedOn;
+
+	virtual void Update(float deltaTime) override {
+		GetGameObject()->SetScale(glm::vec3(1.0f + 0.1f * glm::sin(glm::radians(GetGameObject()->GetRotationEuler().z))));
+		UpdatedOn = std::this_thread::get_id();
+	}
+	virtual UpdateAccess GetUpdateAccess() const override { return UpdateAccess::Parallel(); }
+
+	virtual void RenderImGui() override {}
+	virtual nlohmann::json ToJson() const override { return nlohmann::json::object(); }
+	static SpinToScale::Sptr FromJson(const nlohmann::json&) { return std::make_shared<SpinToScale>(); }
+	MAKE_TYPENAME(SpinToScale);
+};
+
+// A serial component that reads the objects on either side of it, so it only gets the same
+// result as a serial update if everything before it has updated and nothing after it has
+class FollowNeighbours : public IComponent {
+public:
+	typedef std::shared_ptr<FollowNeighbours> Sptr;
+
+	GameObject* Before = nullptr;
+	GameObject* After = nullptr;
+
+	virtual void Update(float deltaTime) override {
+		GetGameObject()->SetPostion(Before->GetPosition() * 0.5f + After->GetScale() + glm::vec3(0.0f, 0.0f, After->GetRotationEuler().z * 0.01f));
+	}
+
+	virtual void RenderImGui() override {}
+	virtual nlohmann::json ToJson() const override { return nlohmann::json::object(); }
+	static FollowNeighbours::Sptr FromJson(const nlohmann::json&) { return std::make_shared<FollowNeighbours>(); }
+	MAKE_TYPENAME(FollowNeighbours);
+};
+
+// Shared state that lives on one object, and is touched by parallel components on others
+class Tally : public IComponent {
+public:
+	typedef std::shared_ptr<Tally> Sptr;
+
+	uint32_t Value = 1;
+
+	virtual UpdateAccess GetUpdateAccess() const override { return UpdateAccess::Parallel(); }
+	virtual void RenderImGui() override {}
+	virtual nlohmann::json ToJson() const override { return nlohmann::json::object(); }
+	static Tally::Sptr FromJson(const nlohmann::json&) { return std::make_shared<Tally>(); }
+	MAKE_TYPENAME(Tally);
+};
+
+// Folds it's id into a tally, so the result depends on the order that the writers ran in
+class AddToTally : public IComponent {
+public:
+	typedef std::shared_ptr<AddToTally> Sptr;
+
+	Tally*   Target = nullptr;
+	uint32_t Id = 0;
+
+	virtual void Update(float deltaTime) override {
+		Target->Value = Target->Value * 31u + Id;
+	}
+	virtual UpdateAccess GetUpdateAccess() const override { return UpdateAccess::Parallel().Write<Tally>(); }
+
+	virtual void RenderImGui() override {}
+	virtual nlohmann::json ToJson() const override { return nlohmann::json::object(); }
+	static AddToTally::Sptr FromJson(const nlohmann::json&) { return std::make_shared<AddToTally>(); }
+	MAKE_TYPENAME(AddToTally);
+};
+
+// Remembers the value of a tally when it was updated
+class ReadTally : public IComponent {
+public:
+	typedef std::shared_ptr<ReadTally> Sptr;
+
+	Tally*   Source = nullptr;
+	uint32_t Seen = 0;
+
+	virtual void Update(float deltaTime) override {
+		Seen = Source->Value;
+	}
+	virtual UpdateAccess GetUpdateAccess() const override { return UpdateAccess::Parallel().Read<Tally>(); }
+
+	virtual void RenderImGui() override {}
+	virtual nlohmann::json ToJson() const override { return nlohmann::json::object(); }
+	static ReadTally::Sptr FromJson(const nlohmann::json&) { return std::make_shared<ReadTally>(); }
+	MAKE_TYPENAME(ReadTally);
+};
+
+static void RegisterTestComponents() {
+	Tests::InitEngine();
+	ComponentManager::RegisterType<SpinToScale>();
+	ComponentManager::RegisterType<FollowNeighbours>();
+	ComponentManager::RegisterType<Tally>();
+	ComponentManager::RegisterType<AddToTally>();
+	ComponentManager::RegisterType<ReadTally>();
+}
+
+// Fills a scene with rotating objects, with a serial object every so often that reads it's neighbours
+static Scene::Sptr BuildScene(size_t count, size_t serialEvery) {
+	Scene::Sptr scene = std::make_shared<Scene>();
+	scene->IsPlaying = true;
+	std::vector<GameObject::Sptr> objects;
+	objects.reserve(count);
+	for (size_t ix = 0; ix < count; ix++) {
+		GameObject::Sptr object = scene->CreateGameObject("Object");
+		object->SetPostion(glm::vec3(static_cast<float>(ix), 0.0f, 0.0f));
+		object->SetRotation(glm::vec3(0.0f, 0.0f, static_cast<float>(ix % 360)));
+		objects.push_back(object);
+	}
+	for (size_t ix = 0; ix < count; ix++) {
+		if (serialEvery > 0 && ix % serialEvery == serialEvery / 2 && ix > 0 && ix + 1 < count) {
+			FollowNeighbours::Sptr follow = objects[ix]->Add<FollowNeighbours>();
+			follow->Before = objects[ix - 1].get();
+			follow->After = objects[ix + 1].get();
+		} else {
+			objects[ix]->Add<RotatingBehaviour>()->RotationSpeed = glm::vec3(0.0f, 0.0f, 10.0f + (ix % 7));
+			objects[ix]->Add<SpinToScale>();
+		}
+	}
+	return scene;
+}
+
+static std::vector<GameObject::Sptr> GetObjects(const Scene::Sptr& scene, size_t count) {
+	std::vector<GameObject::Sptr> result;
+	result.reserve(count);
+	for (size_t ix = 0; ix < count; ix++) {
+		result.push_back(scene->GetObjectByIndex(static_cast<int>(ix)));
+	}
+	return result;
+}
+
+// Returns true if every object in the two scenes has exactly the same transform
+static bool TransformsMatch(const std::vector<GameObject::Sptr>& expected, const std::vector<GameObject::Sptr>& actual) {
+	size_t mismatches = 0;
+	for (size_t ix = 0; ix < expected.size(); ix++) {
+		if (expected[ix]->GetPosition() != actual[ix]->GetPosition() ||
+			expected[ix]->GetRotation() != actual[ix]->GetRotation() ||
+			expected[ix]->GetScale() != actual[ix]->GetScale()) {
+			mismatches++;
+		}
+	}
+	return mismatches == 0;
+}
+
+TEST_CASE(SceneUpdate_ParallelMatchesSerial) {
+	RegisterTestComponents();
+	const size_t count = 100000;
+	const float dt = 1.0f / 60.0f;
+
+	for (int workers : { 0, 3, -1 }) {
+		// Short runs that are updated inline between lots of serial objects, and runs that are long
+		// enough to be split up into jobs
+		for (size_t serialEvery : { size_t(97), size_t(1500) }) {
+			JobSystem jobs(workers);
+			Scene::Sptr serial = BuildScene(count, serialEvery);
+			Scene::Sptr parallel = BuildScene(count, serialEvery);
+			for (int tick = 0; tick < 5; tick++) {
+				serial->Update(dt, nullptr);
+				parallel->Update(dt, &jobs);
+			}
+
+			// Every object runs the same math in the same order, so the results should match exactly
+			std::vector<GameObject::Sptr> actual = GetObjects(parallel, count);
+			CHECK(TransformsMatch(GetObjects(serial, count), actual));
+
+			// The long runs should have been shared out between the workers, not all run on one thread
+			if (serialEvery > ParallelUpdateTestGrain * 2 && jobs.NumWorkers() > 0) {
+				std::unordered_set<std::thread::id> threads;
+				for (const GameObject::Sptr& object : actual) {
+					SpinToScale::Sptr spin = object->Get<SpinToScale>();
+					if (spin != nullptr) {
+						threads.insert(spin->UpdatedOn);
+					}
+				}
+				CHECK(threads.size() > 1);
+			}
+		}
+	}
+}
+
+TEST_CASE(SceneUpdate_ParallelRespectsDeclaredAccess) {
+	RegisterTestComponents();
+	const size_t count = 20000;
+	const float dt = 1.0f / 60.0f;
+
+	// A tally on the first object, with writers and readers of it spread through long parallel runs
+	auto build = [&]() {
+		Scene::Sptr scene = BuildScene(count, 0);
+		std::vector<GameObject::Sptr> objects = GetObjects(scene, count);
+		Tally* tally = objects[0]->Add<Tally>().get();
+		for (size_t ix = 1; ix < count; ix++) {
+			if (ix % 700 == 0) {
+				AddToTally::Sptr writer = objects[ix]->Add<AddToTally>();
+				writer->Target = tally;
+				writer->Id = static_cast<uint32_t>(ix);
+			} else if (ix % 700 == 350) {
+				objects[ix]->Add<ReadTally>()->Source = tally;
+			}
+		}
+		return scene;
+	};
+
+	JobSystem jobs;
+	Scene::Sptr serial = build();
+	Scene::Sptr parallel = build();
+	for (int tick = 0; tick < 5; tick++) {
+		serial->Update(dt, nullptr);
+		parallel->Update(dt, &jobs);
+	}
+
+	// Writers ran in object order, and every reader saw the tally as it was at it's place in that order
+	std::vector<GameObject::Sptr> expected = GetObjects(serial, count);
+	std::vector<GameObject::Sptr> actual = GetObjects(parallel, count);
+	CHECK(expected[0]->Get<Tally>()->Value == actual[0]->Get<Tally>()->Value);
+	size_t readMismatches = 0;
+	for (size_t ix = 0; ix < count; ix++) {
+		ReadTally::Sptr reader = expected[ix]->Get<ReadTally>();
+		if (reader != nullptr && reader->Seen != actual[ix]->Get<ReadTally>()->Seen) {
+			readMismatches++;
+		}
+	}
+	CHECK(readMismatches == 0);
+	CHECK(TransformsMatch(expected, actual));
+}
+
+TEST_CASE(SceneUpdate_BenchmarkSerialVsParallel) {
+	RegisterTestComponents();
+	const size_t count = 100000;
+	const float dt = 1.0f / 60.0f;
+	JobSystem jobs;
+
+	// All parallel, and with a serial object every 1000 objects splitting it up into runs
+	for (size_t serialEvery : { size_t(0), size_t(1000) }) {
+		Scene::Sptr scene = BuildScene(count, serialEvery);
+		double serialMs = Tests::TimeMs([&]() { scene->Update(dt, nullptr); }, 10);
+		double parallelMs = Tests::TimeMs([&]() { scene->Update(dt, &jobs); }, 10);
+
+		std::string prefix = serialEvery == 0 ? "100k objects, " : "100k objects (1 in 1000 serial), ";
+		Tests::Report(prefix + "serial Update", serialMs);
+		Tests::Report(prefix + "parallel Update, " + std::to_string(jobs.NumThreads()) + " threads", parallelMs);
+		Tests::Report(prefix + "speedup", serialMs / parallelMs, "x");
+	}
+}
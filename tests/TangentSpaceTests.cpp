@@ -0,0 +1,270 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Application/JobSystem.h"
+#include "Utils/TangentSpace.h"
+
+// A triangle list with the attributes that TangentSpace needs
+struct TangentTestMesh {
+	std::vector<glm::vec3> Positions;
+	std::vector<glm::vec2> UVs;
+	std::vector<uint32_t>  Indices;
+};
+
+// The results of running TangentSpace over a mesh
+struct TangentFrames {
+	std::vector<glm::vec3> Normals;
+	std::vector<glm::vec3> Tangents;
+	std::vector<glm::vec3> Bitangents;
+};
+
+// A unit sphere around the origin with rings from pole to pole, and twice as many segments around it. U wraps
+// around the Z axis and V goes from the north pole to the south pole, with a seam where U wraps around
+static TangentTestMesh BuildSphere(int rings) {
+	TangentTestMesh result;
+	const int segments = rings * 2;
+	for (int ring = 0; ring <= rings; ring++) {
+		for (int segment = 0; segment <= segments; segment++) {
+			glm::vec2 uv = glm::vec2(segment / static_cast<float>(segments), ring / static_cast<float>(rings));
+			float theta = uv.x * 6.28318531f;
+			float phi = uv.y * 3.14159265f;
+			result.Positions.push_back(glm::vec3(std::sin(phi) * std::cos(theta), std::sin(phi) * std::sin(theta), std::cos(phi)));
+			result.UVs.push_back(uv);
+		}
+	}
+	// The triangles touching the poles would have two corners on the pole, so we leave them out
+	const uint32_t row = segments + 1;
+	for (int ring = 0; ring < rings; ring++) {
+		for (int segment = 0; segment < segments; segment++) {
+			uint32_t a = ring * row + segment, b = a + 1, c = a + row, d = c + 1;
+			if (ring != 0) {
+				result.Indices.insert(result.Indices.end(), { a, c, b });
+			}
+			if (ring != rings - 1) {
+				result.Indices.insert(result.Indices.end(), { b, c, d });
+			}
+		}
+	}
+	return result;
+}
+
+// A flat square in the XY plane, facing +Z, with it's UVs tiled uvScale times across it
+static TangentTestMesh BuildPlane(int quads, float uvScale) {
+	TangentTestMesh result;
+	for (int y = 0; y <= quads; y++) {
+		for (int x = 0; x <= quads; x++) {
+			result.Positions.push_back(glm::vec3(x * 0.1f, y * 0.1f, 0.0f));
+			result.UVs.push_back(glm::vec2(x * uvScale / quads, y * uvScale / quads));
+		}
+	}
+	const uint32_t row = quads + 1;
+	for (int y = 0; y < quads; y++) {
+		for (int x = 0; x < quads; x++) {
+			uint32_t a = y * row + x, b = a + 1, c = a + row, d = c + 1;
+			result.Indices.insert(result.Indices.end(), { a, b, c, b, d, c });
+		}
+	}
+	return result;
+}
+
+static TangentFrames Calculate(const TangentTestMesh& mesh, JobSystem* jobs = nullptr) {
+	TangentFrames result;
+	const size_t count = mesh.Positions.size();
+	result.Normals.resize(count);
+	result.Tangents.resize(count);
+	result.Bitangents.resize(count);
+	TangentSpace::CalculateNormals(mesh.Indices.data(), mesh.Indices.size(), mesh.Positions.data(), count, result.Normals.data(), jobs);
+	TangentSpace::CalculateTangents(mesh.Indices.data(), mesh.Indices.size(), mesh.Positions.data(), mesh.UVs.data(), count,
+		result.Tangents.data(), result.Bitangents.data(), jobs);
+	return result;
+}
+
+// The loop that MeshFactory::CalculateTBN used before TangentSpace, with it's bitangent fixed to use each
+// vertex's own value. It keeps a running average of the triangle frames, so the result depends on their order
+static void ReferenceTangents(const TangentTestMesh& mesh, std::vector<glm::vec3>& tangents, std::vector<glm::vec3>& bitangents) {
+	tangents.assign(mesh.Positions.size(), glm::vec3(0.0f));
+	bitangents.assign(mesh.Positions.size(), glm::vec3(0.0f));
+	for (size_t ix = 0; ix < mesh.Indices.size(); ix += 3) {
+		const uint32_t corners[3] = { mesh.Indices[ix], mesh.Indices[ix + 1], mesh.Indices[ix + 2] };
+		glm::vec3 deltaPos1 = mesh.Positions[corners[1]] - mesh.Positions[corners[0]];
+		glm::vec3 deltaPos2 = mesh.Positions[corners[2]] - mesh.Positions[corners[0]];
+		glm::vec2 deltaUv1 = mesh.UVs[corners[1]] - mesh.UVs[corners[0]];
+		glm::vec2 deltaUv2 = mesh.UVs[corners[2]] - mesh.UVs[corners[0]];
+
+		float r = 1.0f / (deltaUv1.x * deltaUv2.y - deltaUv1.y * deltaUv2.x);
+		glm::vec3 tangent = glm::normalize((deltaPos1 * deltaUv2.y - deltaPos2 * deltaUv1.y) * r);
+		glm::vec3 bitangent = glm::normalize((deltaPos2 * deltaUv1.x - deltaPos1 * deltaUv2.x) * r);
+		for (uint32_t corner : corners) {
+			tangents[corner] = glm::normalize((tangents[corner] + tangent) / 2.0f);
+			bitangents[corner] = glm::normalize((bitangents[corner] + bitangent) / 2.0f);
+		}
+	}
+}
+
+// The angle between two directions in degrees, zero vectors only match other zero vectors
+static float AngleBetween(const glm::vec3& a, const glm::vec3& b) {
+	float lengths = glm::length(a) * glm::length(b);
+	if (lengths == 0.0f) {
+		return glm::length(a) == glm::length(b) ? 0.0f : 180.0f;
+	}
+	return glm::degrees(std::acos(glm::clamp(glm::dot(a, b) / lengths, -1.0f, 1.0f)));
+}
+
+static bool IsFinite(const glm::vec3& value) {
+	return std::isfinite(value.x) && std::isfinite(value.y) && std::isfinite(value.z);
+}
+
+TEST_CASE(TangentSpace_PlaneIsExact) {
+	// Tiling the UVs scales the frames, which shouldn't change their directions
+	for (float uvScale : { 1.0f, 20.0f }) {
+		TangentTestMesh mesh = BuildPlane(64, uvScale);
+		TangentFrames frames = Calculate(mesh);
+		float maxNormal = 0.0f, maxTangent = 0.0f, maxBitangent = 0.0f;
+		for (size_t ix = 0; ix < mesh.Positions.size(); ix++) {
+			maxNormal = std::max(maxNormal, AngleBetween(frames.Normals[ix], glm::vec3(0.0f, 0.0f, 1.0f)));
+			maxTangent = std::max(maxTangent, AngleBetween(frames.Tangents[ix], glm::vec3(1.0f, 0.0f, 0.0f)));
+			maxBitangent = std::max(maxBitangent, AngleBetween(frames.Bitangents[ix], glm::vec3(0.0f, 1.0f, 0.0f)));
+			CHECK_NEAR(glm::length(frames.Tangents[ix]), 1.0f, 1e-5f);
+		}
+		CHECK(maxNormal < 0.01f);
+		CHECK(maxTangent < 0.01f);
+		CHECK(maxBitangent < 0.01f);
+	}
+}
+
+TEST_CASE(TangentSpace_SphereMatchesReference) {
+	// The largest differences from the old loop's tangents and from the true surface, as measured when
+	// TangentSpace was written, with some headroom. Both shrink as the sphere gets smoother
+	struct Tolerance {
+		int   Rings;
+		float Reference;
+		float Surface;
+	};
+	const Tolerance tolerances[] = { { 16, 2.5f, 7.0f }, { 64, 0.75f, 2.0f }, { 256, 0.2f, 0.5f } };
+
+	for (const Tolerance& tolerance : tolerances) {
+		TangentTestMesh mesh = BuildSphere(tolerance.Rings);
+		TangentFrames frames = Calculate(mesh);
+		std::vector<glm::vec3> refTangents, refBitangents;
+		ReferenceTangents(mesh, refTangents, refBitangents);
+
+		float maxReference = 0.0f, maxSurface = 0.0f, maxNormal = 0.0f;
+		double sumSurface = 0.0, sumRefSurface = 0.0;
+		size_t numSurface = 0, notFinite = 0;
+		for (size_t ix = 0; ix < mesh.Positions.size(); ix++) {
+			notFinite += !IsFinite(frames.Tangents[ix]) || !IsFinite(frames.Bitangents[ix]) || !IsFinite(frames.Normals[ix]) ? 1 : 0;
+			maxReference = std::max(maxReference, AngleBetween(frames.Tangents[ix], refTangents[ix]));
+
+			// The true tangent and bitangent point along increasing U and V, they don't exist at the poles
+			const glm::vec3& position = mesh.Positions[ix];
+			float radius = std::sqrt(position.x * position.x + position.y * position.y);
+			if (radius > 1e-4f) {
+				glm::vec3 tangent = glm::vec3(-position.y, position.x, 0.0f) / radius;
+				glm::vec3 bitangent = glm::cross(tangent, position);
+				float surface = std::max(AngleBetween(frames.Tangents[ix], tangent), AngleBetween(frames.Bitangents[ix], bitangent));
+				maxSurface = std::max(maxSurface, surface);
+				maxNormal = std::max(maxNormal, AngleBetween(frames.Normals[ix], position));
+				sumSurface += surface;
+				sumRefSurface += std::max(AngleBetween(refTangents[ix], tangent), AngleBetween(refBitangents[ix], bitangent));
+				numSurface++;
+			}
+		}
+		CHECK(notFinite == 0);
+		CHECK(maxReference < tolerance.Reference);
+		CHECK(maxSurface < tolerance.Surface);
+		CHECK(maxNormal < tolerance.Surface);
+		// Weighting every triangle the same should never be further from the surface than the running average
+		CHECK(sumSurface <= sumRefSurface);
+
+		std::string prefix = "Sphere, " + std::to_string(mesh.Indices.size() / 3) + " triangles, ";
+		Tests::Report(prefix + "largest tangent difference from old loop", maxReference, "deg");
+		Tests::Report(prefix + "largest difference from surface", maxSurface, "deg");
+		Tests::Report(prefix + "average difference from surface", sumSurface / numSurface, "deg");
+		Tests::Report(prefix + "old loop's average difference from surface", sumRefSurface / numSurface, "deg");
+		Tests::Report(prefix + "largest normal difference from surface", maxNormal, "deg");
+	}
+}
+
+TEST_CASE(TangentSpace_ParallelMatchesSerial) {
+	TangentTestMesh mesh = BuildSphere(128);
+	REQUIRE(mesh.Indices.size() / 3 > TangentSpace::MinParallelTriangles);
+	TangentFrames serial = Calculate(mesh);
+
+	// Every vertex adds up it's triangles in the same order no matter how the work is split, so the results match exactly
+	for (int workers : { 1, 3, 7 }) {
+		JobSystem jobs(workers);
+		TangentFrames parallel = Calculate(mesh, &jobs);
+		size_t mismatches = 0;
+		for (size_t ix = 0; ix < mesh.Positions.size(); ix++) {
+			mismatches += parallel.Normals[ix] != serial.Normals[ix] ? 1 : 0;
+			mismatches += parallel.Tangents[ix] != serial.Tangents[ix] ? 1 : 0;
+			mismatches += parallel.Bitangents[ix] != serial.Bitangents[ix] ? 1 : 0;
+		}
+		CHECK(mismatches == 0);
+	}
+}
+
+TEST_CASE(TangentSpace_SkipsDegenerateTriangles) {
+	TangentTestMesh mesh = BuildPlane(2, 1.0f);
+	const uint32_t good = static_cast<uint32_t>(mesh.Positions.size());
+
+	// A triangle with all of it's UVs in one spot, which shares a vertex with a good triangle
+	mesh.Positions.push_back(glm::vec3(0.0f, 0.0f, 1.0f));
+	mesh.Positions.push_back(glm::vec3(0.0f, 1.0f, 1.0f));
+	mesh.UVs.push_back(glm::vec2(0.0f));
+	mesh.UVs.push_back(glm::vec2(0.0f));
+	mesh.Indices.insert(mesh.Indices.end(), { 0, good, good + 1 });
+
+	// A triangle with no area, and a vertex that no triangle uses
+	mesh.Positions.push_back(glm::vec3(5.0f));
+	mesh.UVs.push_back(glm::vec2(0.5f));
+	mesh.Positions.push_back(glm::vec3(6.0f));
+	mesh.UVs.push_back(glm::vec2(0.25f));
+	mesh.Indices.insert(mesh.Indices.end(), { good + 2, good + 2, good + 2 });
+
+	TangentFrames frames = Calculate(mesh);
+	size_t notFinite = 0;
+	for (size_t ix = 0; ix < mesh.Positions.size(); ix++) {
+		notFinite += !IsFinite(frames.Tangents[ix]) || !IsFinite(frames.Bitangents[ix]) || !IsFinite(frames.Normals[ix]) ? 1 : 0;
+	}
+	CHECK(notFinite == 0);
+
+	// The shared vertex keeps the frame of the good triangles
+	CHECK(AngleBetween(frames.Tangents[0], glm::vec3(1.0f, 0.0f, 0.0f)) < 0.01f);
+	CHECK(AngleBetween(frames.Bitangents[0], glm::vec3(0.0f, 1.0f, 0.0f)) < 0.01f);
+	// Vertices that only have degenerate triangles, or none at all, get zeros
+	CHECK(frames.Tangents[good + 1] == glm::vec3(0.0f));
+	CHECK(frames.Tangents[good + 2] == glm::vec3(0.0f));
+	CHECK(frames.Normals[good + 2] == glm::vec3(0.0f));
+	CHECK(frames.Tangents[good + 3] == glm::vec3(0.0f));
+	CHECK(frames.Bitangents[good + 3] == glm::vec3(0.0f));
+	CHECK(frames.Normals[good + 3] == glm::vec3(0.0f));
+}
+
+TEST_CASE(TangentSpace_Benchmark) {
+	JobSystem jobs;
+	for (int rings : { 64, 256 }) {
+		TangentTestMesh mesh = BuildSphere(rings);
+		TangentFrames frames = Calculate(mesh);
+		std::vector<glm::vec3> refTangents, refBitangents;
+		const int reps = rings > 100 ? 5 : 50;
+
+		double referenceMs = Tests::TimeMs([&]() { ReferenceTangents(mesh, refTangents, refBitangents); }, reps);
+		double serialMs = Tests::TimeMs([&]() {
+			TangentSpace::CalculateTangents(mesh.Indices.data(), mesh.Indices.size(), mesh.Positions.data(), mesh.UVs.data(),
+				mesh.Positions.size(), frames.Tangents.data(), frames.Bitangents.data());
+		}, reps);
+		double parallelMs = Tests::TimeMs([&]() {
+			TangentSpace::CalculateTangents(mesh.Indices.data(), mesh.Indices.size(), mesh.Positions.data(), mesh.UVs.data(),
+				mesh.Positions.size(), frames.Tangents.data(), frames.Bitangents.data(), &jobs);
+		}, reps);
+
+		std::string prefix = "Sphere, " + std::to_string(mesh.Indices.size() / 3) + " triangles, ";
+		Tests::Report(prefix + "old loop", referenceMs);
+		Tests::Report(prefix + "CalculateTangents", serialMs);
+		Tests::Report(prefix + "CalculateTangents, " + std::to_string(jobs.NumWorkers()) + " workers", parallelMs);
+	}
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+#include <stdexcept>
+#include <chrono>
+#include <cmath>
+
+/// <summary>
+/// A minimal test harness for the engine
+///
+/// Every .cpp file in this folder is compiled into a single test executable along with all of
+/// the engine sources except entry_point.cpp. It should be run from the repository root so that
+/// res/ can be found, and returns the number of tests that failed. Passing names on the command
+/// line only runs the tests that contain one of them (ex: Tests.exe Prefab TangentSpace). See
+/// README.md in this folder for how to set up the test target
+///
+/// Benchmarks are ordinary tests that log their timings with Tests::Report, their pass/fail
+/// checks only cover the correctness of the results, since timings depend on the machine
+/// </summary>
+namespace Tests {
+	typedef std::function<void()> TestFunc;
+
+	struct TestCase {
+		const char* Name;
+		TestFunc    Body;
+	};
+
+	/// <summary>
+	/// Thrown by REQUIRE to stop the current test after a failed check
+	/// </summary>
+	struct RequireFailed : public std::runtime_error {
+		using std::runtime_error::runtime_error;
+	};
+
+	/// <summary>
+	/// Gets all the tests that have been registered with TEST_CASE
+	/// </summary>
+	std::vector<TestCase>& Registry();
+
+	/// <summary>
+	/// Records a failed check in the test that is currently running
+	/// </summary>
+	void ReportFailure(const char* file, int line, const std::string& expression);
+
+	/// <summary>
+	/// Logs a named measurement, ex: a benchmark's timing or a speedup
+	/// </summary>
+	void Report(const std::string& name, double value, const char* unit = "ms");
+
+	/// <summary>
+	/// Registers the engine's resource and component types, only does work the first time it's called
+	/// </summary>
+	void InitEngine();
+
+	/// <summary>
+	/// Creates a hidden window with an OpenGL context for tests that need one, only does work the first
+	/// time it's called. Returns false if no context could be created, in which case the test should
+	/// log that it was skipped and return
+	/// </summary>
+	bool InitGL();
+
+	/// <summary>
+	/// Runs a function reps times after one untimed warm up run, and returns the average time in milliseconds
+	/// </summary>
+	template <typename Func>
+	double TimeMs(Func&& func, int reps = 1) {
+		func();
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int ix = 0; ix < reps; ix++) {
+			func();
+		}
+		auto end = std::chrono::high_resolution_clock::now();
+		return std::chrono::duration<double, std::milli>(end - start).count() / reps;
+	}
+
+	struct Registrar {
+		Registrar(const char* name, const TestFunc& body) {
+			Registry().push_back({ name, body });
+		}
+	};
+}
+
+#define TEST_CASE(name) \
+	static void name(); \
+	static Tests::Registrar name##_Registrar(#name, name); \
+	static void name()
+
+#define CHECK(expr) \
+	do { if (!(expr)) { Tests::ReportFailure(__FILE__, __LINE__, #expr); } } while (false)
+
+#define REQUIRE(expr) \
+	do { if (!(expr)) { Tests::ReportFailure(__FILE__, __LINE__, #expr); throw Tests::RequireFailed(#expr); } } while (false)
+
+#define CHECK_NEAR(a, b, tolerance) \
+	CHECK(std::abs((a) - (b)) <= (tolerance))
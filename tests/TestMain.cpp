@@ -0,0 +1,160 @@
+#include "TestFramework.h"
+
+#include <cstdio>
+#include <cstring>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "Logging.h"
+#include "Utils/ResourceManager/ResourceManager.h"
+
+// Graphics
+#include "Graphics/ShaderProgram.h"
+#include "Graphics/Textures/Texture1D.h"
+#include "Graphics/Textures/Texture2D.h"
+#include "Graphics/Textures/Texture3D.h"
+#include "Graphics/Textures/TextureCube.h"
+#include "Graphics/Font.h"
+#include "Graphics/Framebuffer.h"
+
+// Gameplay
+#include "Gameplay/Material.h"
+#include "Gameplay/MeshResource.h"
+#include "Gameplay/Prefab.h"
+
+// Components
+#include "Gameplay/Components/ComponentManager.h"
+#include "Gameplay/Components/Camera.h"
+#include "Gameplay/Components/RenderComponent.h"
+#include "Gameplay/Components/RotatingBehaviour.h"
+#include "Gameplay/Components/JumpBehaviour.h"
+#include "Gameplay/Components/MaterialSwapBehaviour.h"
+#include "Gameplay/Components/TriggerVolumeEnterBehaviour.h"
+#include "Gameplay/Components/SimpleCameraControl.h"
+#include "Gameplay/Components/PlayerController.h"
+#include "Gameplay/Components/EnemyScript.h"
+#include "Gameplay/Components/TopEnemyScript.h"
+#include "Gameplay/Components/Bolt.h"
+#include "Gameplay/Components/ParticleSystem.h"
+#include "Gameplay/Components/Light.h"
+#include "Gameplay/Components/WinScreenBehaviour.h"
+#include "Gameplay/Components/LoseScreenBehaviour.h"
+#include "Gameplay/Components/GUI/RectTransform.h"
+#include "Gameplay/Components/GUI/GuiPanel.h"
+#include "Gameplay/Components/GUI/GuiText.h"
+#include "Gameplay/Physics/RigidBody.h"
+#include "Gameplay/Physics/TriggerVolume.h"
+
+namespace Tests {
+	// The number of failed checks in the test that is currently running
+	static int _currentFailures = 0;
+
+	std::vector<TestCase>& Registry() {
+		static std::vector<TestCase> tests;
+		return tests;
+	}
+
+	void ReportFailure(const char* file, int line, const std::string& expression) {
+		printf("    FAILED %s(%d): %s\n", file, line, expression.c_str());
+		_currentFailures++;
+	}
+
+	void Report(const std::string& name, double value, const char* unit) {
+		printf("    %-64s %10.3f %s\n", name.c_str(), value, unit);
+	}
+
+	void InitEngine() {
+		static bool isInitialized = false;
+		if (isInitialized) {
+			return;
+		}
+		isInitialized = true;
+
+		using namespace Gameplay;
+		using namespace Gameplay::Physics;
+
+		// Mirrors Application::_RegisterClasses, so tests can load the same files as the game
+		ResourceManager::Init();
+		ResourceManager::RegisterType<Texture1D>();
+		ResourceManager::RegisterType<Texture2D>();
+		ResourceManager::RegisterType<Texture3D>();
+		ResourceManager::RegisterType<TextureCube>();
+		ResourceManager::RegisterType<ShaderProgram>();
+		ResourceManager::RegisterType<Material>();
+		ResourceManager::RegisterType<MeshResource>();
+		ResourceManager::RegisterType<Font>();
+		ResourceManager::RegisterType<Framebuffer>();
+		ResourceManager::RegisterType<Prefab>();
+
+		ComponentManager::RegisterType<Camera>();
+		ComponentManager::RegisterType<RenderComponent>();
+		ComponentManager::RegisterType<RigidBody>();
+		ComponentManager::RegisterType<TriggerVolume>();
+		ComponentManager::RegisterType<RotatingBehaviour>();
+		ComponentManager::RegisterType<PlayerController>();
+		ComponentManager::RegisterType<EnemyScript>();
+		ComponentManager::RegisterType<TopEnemyScript>();
+		ComponentManager::RegisterType<Bolt>();
+		ComponentManager::RegisterType<JumpBehaviour>();
+		ComponentManager::RegisterType<MaterialSwapBehaviour>();
+		ComponentManager::RegisterType<TriggerVolumeEnterBehaviour>();
+		ComponentManager::RegisterType<SimpleCameraControl>();
+		ComponentManager::RegisterType<RectTransform>();
+		ComponentManager::RegisterType<GuiPanel>();
+		ComponentManager::RegisterType<GuiText>();
+		ComponentManager::RegisterType<ParticleSystem>();
+		ComponentManager::RegisterType<Light>();
+		ComponentManager::RegisterType<WinScreen>();
+		ComponentManager::RegisterType<LoseScreen>();
+	}
+
+	bool InitGL() {
+		static int result = -1;
+		if (result == -1) {
+			result = 0;
+			if (glfwInit() == GLFW_TRUE) {
+				glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+				GLFWwindow* window = glfwCreateWindow(64, 64, "Tests", nullptr, nullptr);
+				if (window != nullptr) {
+					glfwMakeContextCurrent(window);
+					result = gladLoadGLLoader((GLADloadproc)glfwGetProcAddress) != 0 ? 1 : 0;
+				}
+			}
+		}
+		return result == 1;
+	}
+}
+
+int main(int argc, char** args) {
+	Logger::Init();
+
+	int failedTests = 0;
+	int ranTests = 0;
+	for (const Tests::TestCase& test : Tests::Registry()) {
+		// If any names were given, only run the tests that contain one of them
+		bool selected = argc <= 1;
+		for (int ix = 1; ix < argc && !selected; ix++) {
+			selected = strstr(test.Name, args[ix]) != nullptr;
+		}
+		if (!selected) {
+			continue;
+		}
+
+		printf("[ RUN  ] %s\n", test.Name);
+		Tests::_currentFailures = 0;
+		try {
+			test.Body();
+		} catch (const Tests::RequireFailed&) {
+			// Already reported
+		} catch (const std::exception& e) {
+			Tests::ReportFailure(__FILE__, __LINE__, std::string("Unhandled exception: ") + e.what());
+		}
+		printf("[ %s ] %s\n", Tests::_currentFailures == 0 ? "PASS" : "FAIL", test.Name);
+		failedTests += Tests::_currentFailures == 0 ? 0 : 1;
+		ranTests++;
+	}
+
+	printf("%d of %d tests passed\n", ranTests - failedTests, ranTests);
+	Logger::Uninitialize();
+	return failedTests;
+}
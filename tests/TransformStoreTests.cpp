@@ -0,0 +1,229 @@
+#include "TestFramework.h"
+
+#include <GLM/gtc/matrix_transform.hpp>
+#include <GLM/gtc/quaternion.hpp>
+
+#include "Gameplay/TransformStore.h"
+#include "Gameplay/Scene.h"
+
+using namespace Gameplay;
+
+// The matrix that the old GameObject code built for a transform
+static glm::mat4 ReferenceLocal(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
+	return glm::translate(glm::mat4(1.0f), position) * glm::mat4_cast(rotation) * glm::scale(glm::mat4(1.0f), scale);
+}
+
+static bool MatricesNear(const glm::mat4& a, const glm::mat4& b, float tolerance) {
+	for (int col = 0; col < 4; col++) {
+		for (int row = 0; row < 4; row++) {
+			if (std::abs(a[col][row] - b[col][row]) > tolerance) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// Gives each transform in the store a different position, rotation and scale
+static void Scramble(TransformStore& store, const std::vector<TransformStore::Handle>& handles, float seed) {
+	for (size_t ix = 0; ix < handles.size(); ix++) {
+		float t = seed + ix * 0.37f;
+		store.SetPosition(handles[ix], glm::vec3(glm::sin(t), glm::cos(t * 1.3f), t * 0.01f));
+		store.SetRotation(handles[ix], glm::quat(glm::vec3(t * 0.1f, t * 0.2f, t * 0.05f)));
+		store.SetScale(handles[ix], glm::vec3(1.0f + 0.01f * glm::sin(t)));
+	}
+}
+
+// Checks every world matrix and inverse against a naive recalculation up the chain of parents
+static void CheckAgainstReference(TransformStore& store, const std::vector<TransformStore::Handle>& handles, const std::vector<int>& parents) {
+	std::vector<glm::mat4> reference(handles.size());
+	for (size_t ix = 0; ix < handles.size(); ix++) {
+		glm::mat4 local = ReferenceLocal(store.GetPosition(handles[ix]), store.GetRotation(handles[ix]), store.GetScale(handles[ix]));
+		// Parents always come first in the test hierarchies, so theirs is already done
+		reference[ix] = parents[ix] < 0 ? local : reference[parents[ix]] * local;
+	}
+	for (size_t ix = 0; ix < handles.size(); ix++) {
+		CHECK(MatricesNear(store.GetWorld(handles[ix]), reference[ix], 1e-3f));
+		CHECK(MatricesNear(store.GetInverseWorld(handles[ix]) * reference[ix], glm::mat4(1.0f), 1e-3f));
+	}
+}
+
+// Builds a single chain, each transform parented to the one before it
+static void BuildDeep(TransformStore& store, size_t count, std::vector<TransformStore::Handle>& handles, std::vector<int>& parents) {
+	for (size_t ix = 0; ix < count; ix++) {
+		handles.push_back(store.Create());
+		parents.push_back(static_cast<int>(ix) - 1);
+		if (ix > 0) {
+			store.SetParent(handles[ix], handles[ix - 1]);
+		}
+	}
+}
+
+// Builds one root with every other transform as a direct child
+static void BuildWide(TransformStore& store, size_t count, std::vector<TransformStore::Handle>& handles, std::vector<int>& parents) {
+	for (size_t ix = 0; ix < count; ix++) {
+		handles.push_back(store.Create());
+		parents.push_back(ix == 0 ? -1 : 0);
+		if (ix > 0) {
+			store.SetParent(handles[ix], handles[0]);
+		}
+	}
+}
+
+TEST_CASE(TransformStore_DeepHierarchyMatchesReference) {
+	TransformStore store;
+	std::vector<TransformStore::Handle> handles;
+	std::vector<int> parents;
+	// Scales compound down the chain, so keep it short enough to stay well conditioned
+	BuildDeep(store, 64, handles, parents);
+	Scramble(store, handles, 0.0f);
+	store.Update();
+	CheckAgainstReference(store, handles, parents);
+
+	// Moving the root must reach the end of the chain, with or without an Update in between
+	store.SetPosition(handles[0], glm::vec3(5.0f, 0.0f, 0.0f));
+	CheckAgainstReference(store, handles, parents);
+	store.Update();
+	CheckAgainstReference(store, handles, parents);
+}
+
+TEST_CASE(TransformStore_WideHierarchyMatchesReference) {
+	TransformStore store;
+	std::vector<TransformStore::Handle> handles;
+	std::vector<int> parents;
+	BuildWide(store, 1000, handles, parents);
+	Scramble(store, handles, 1.0f);
+	store.Update();
+	CheckAgainstReference(store, handles, parents);
+
+	store.SetRotation(handles[0], glm::quat(glm::vec3(0.0f, 0.0f, 1.0f)));
+	store.Update();
+	CheckAgainstReference(store, handles, parents);
+}
+
+TEST_CASE(TransformStore_ReparentAndDestroy) {
+	TransformStore store;
+	TransformStore::Handle a = store.Create();
+	TransformStore::Handle b = store.Create();
+	TransformStore::Handle c = store.Create();
+	store.SetPosition(a, glm::vec3(1.0f, 0.0f, 0.0f));
+	store.SetPosition(b, glm::vec3(0.0f, 1.0f, 0.0f));
+	store.SetPosition(c, glm::vec3(0.0f, 0.0f, 1.0f));
+
+	// c was created before it's new parent, so the store has to re-order itself
+	store.SetParent(b, c);
+	store.SetParent(c, a);
+	store.Update();
+	CHECK(MatricesNear(store.GetWorld(b), glm::translate(glm::mat4(1.0f), glm::vec3(1.0f, 1.0f, 1.0f)), 1e-5f));
+
+	// Children of a destroyed transform become roots
+	store.Destroy(c);
+	CHECK(store.Size() == 2);
+	store.Update();
+	CHECK(MatricesNear(store.GetWorld(b), glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 1.0f, 0.0f)), 1e-5f));
+	CHECK(MatricesNear(store.GetWorld(a), glm::translate(glm::mat4(1.0f), glm::vec3(1.0f, 0.0f, 0.0f)), 1e-5f));
+}
+
+TEST_CASE(TransformStore_VeryDeepHierarchies) {
+	// Far deeper than any real scene, resolving or sorting this one level at a time on the stack would overflow it
+	const size_t count = 200000;
+	TransformStore store;
+	std::vector<TransformStore::Handle> handles;
+	for (size_t ix = 0; ix < count; ix++) {
+		handles.push_back(store.Create());
+		store.SetPosition(handles[ix], glm::vec3(1.0f, 0.0f, 0.0f));
+	}
+	// Every transform is created before it's parent, so sorting has to reverse the whole store
+	for (size_t ix = 0; ix + 1 < count; ix++) {
+		store.SetParent(handles[ix], handles[ix + 1]);
+	}
+
+	// Reading before the first Update resolves the whole chain
+	CHECK_NEAR(store.GetWorld(handles[0])[3][0], static_cast<float>(count), 1e-3f);
+	store.Update();
+	CHECK_NEAR(store.GetWorld(handles[0])[3][0], static_cast<float>(count), 1e-3f);
+	CHECK_NEAR(store.GetWorld(handles[count / 2])[3][0], static_cast<float>(count - count / 2), 1e-3f);
+
+	// Moving the root reaches the other end, with or without an Update in between
+	store.SetPosition(handles[count - 1], glm::vec3(2.0f, 0.0f, 0.0f));
+	CHECK_NEAR(store.GetWorld(handles[0])[3][0], static_cast<float>(count + 1), 1e-3f);
+	store.Update();
+	CHECK_NEAR(store.GetWorld(handles[1])[3][0], static_cast<float>(count), 1e-3f);
+}
+
+TEST_CASE(TransformStore_ObjectOutlivesScene) {
+	Tests::InitEngine();
+	Scene::Sptr scene = std::make_shared<Scene>();
+	GameObject::Sptr kept = scene->CreateGameObject("Kept");
+	GameObject::Sptr removed = scene->CreateGameObject("Removed");
+	scene->RemoveGameObject(removed);
+	scene->Update(0.0f);
+
+	// Positions are returned as copies, so holding on to one while the store grows is safe
+	const glm::vec3& position = kept->GetPosition();
+	for (int ix = 0; ix < 100; ix++) {
+		scene->CreateGameObject("Filler");
+	}
+	CHECK(position == kept->GetPosition());
+
+	// Neither object is in the scene's list when it is destroyed, and they must not touch it afterwards
+	scene->RemoveGameObject(kept);
+	scene->Update(0.0f);
+	scene = nullptr;
+	kept = nullptr;
+	removed = nullptr;
+}
+
+TEST_CASE(TransformStore_BenchmarkHierarchies) {
+	const size_t count = 100000;
+	struct Shape {
+		const char* Name;
+		void (*Build)(TransformStore&, size_t, std::vector<TransformStore::Handle>&, std::vector<int>&);
+	};
+	const Shape shapes[] = { { "deep", BuildDeep }, { "wide", BuildWide } };
+
+	for (const Shape& shape : shapes) {
+		TransformStore store;
+		std::vector<TransformStore::Handle> handles;
+		std::vector<int> parents;
+		shape.Build(store, count, handles, parents);
+		Scramble(store, handles, 0.0f);
+		store.Update();
+
+		// Moving the root dirties every transform below it
+		float time = 0.0f;
+		double rootMs = Tests::TimeMs([&]() {
+			time += 0.1f;
+			store.SetPosition(handles[0], glm::vec3(time, 0.0f, 0.0f));
+			store.Update();
+		}, 20);
+
+		// Moving every transform, like a scene full of moving objects
+		double allMs = Tests::TimeMs([&]() {
+			time += 0.1f;
+			Scramble(store, handles, time);
+			store.Update();
+		}, 5);
+
+		// Nothing moved, Update should find nothing to do
+		double idleMs = Tests::TimeMs([&]() {
+			store.Update();
+		}, 100);
+
+		// The naive recalculation that the old GameObject code did, for comparison
+		std::vector<glm::mat4> worlds(count), inverses(count);
+		double naiveMs = Tests::TimeMs([&]() {
+			for (size_t ix = 0; ix < count; ix++) {
+				glm::mat4 local = ReferenceLocal(store.GetPosition(handles[ix]), store.GetRotation(handles[ix]), store.GetScale(handles[ix]));
+				worlds[ix] = parents[ix] < 0 ? local : worlds[parents[ix]] * local;
+				inverses[ix] = glm::inverse(worlds[ix]);
+			}
+		}, 5);
+
+		std::string prefix = std::string("100k transforms, ") + shape.Name + ", ";
+		Tests::Report(prefix + "move root + Update", rootMs);
+		Tests::Report(prefix + "move all + Update", allMs);
+		Tests::Report(prefix + "idle Update", idleMs);
+		Tests::Report(prefix + "naive world + glm::inverse", naiveMs);
+	}
+}
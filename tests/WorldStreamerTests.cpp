@@ -0,0 +1,149 @@
+#include "TestFramework.h"
+
+#include <filesystem>
+#include <thread>
+
+#include "Application/JobSystem.h"
+#include "Application/WorldStreamer.h"
+#include "Gameplay/Scene.h"
+#include "Gameplay/Components/RotatingBehaviour.h"
+
+using namespace Gameplay;
+
+static const float WorldSize = 200.0f;
+static const float CellSize = 10.0f;
+static const float LoadRadius = 25.0f;
+static const float UnloadRadius = 35.0f;
+
+struct SourceObject {
+	Guid      Id;
+	glm::vec3 Position;
+};
+
+// Fills a square world with objects on a regular grid and saves it split into cells, returns the path of the scene
+static std::string BuildStreamedWorld(const std::string& name, int perSide, std::vector<SourceObject>& objects) {
+	Scene::Sptr scene = std::make_shared<Scene>();
+	float spacing = WorldSize / perSide;
+	for (int y = 0; y < perSide; y++) {
+		for (int x = 0; x < perSide; x++) {
+			GameObject::Sptr object = scene->CreateGameObject("Prop");
+			object->SetPostion(glm::vec3((x + 0.5f) * spacing, (y + 0.5f) * spacing, 0.0f));
+			object->Add<RotatingBehaviour>()->RotationSpeed = glm::vec3(0.0f, 0.0f, 45.0f);
+			objects.push_back({ object->GetGUID(), object->GetPosition() });
+		}
+	}
+
+	std::filesystem::path folder = std::filesystem::temp_directory_path() / name;
+	std::filesystem::create_directories(folder);
+	std::string path = (folder / "world.json").string();
+	scene->SaveStreamed(path, CellSize, LoadRadius, UnloadRadius);
+	return path;
+}
+
+// Distance on the X and Y axes from a point to the cell that a position falls in, the same way the streamer measures it
+static float DistanceToCellOf(const glm::vec3& position, const glm::vec2& point) {
+	glm::vec2 cellMin = glm::floor(glm::vec2(position) / CellSize) * CellSize;
+	glm::vec2 nearest = glm::clamp(point, cellMin, cellMin + CellSize);
+	return glm::length(point - nearest);
+}
+
+// Ticks the streamer until there is nothing left to load around the focus
+static void Settle(WorldStreamer& streamer, const Scene::Sptr& scene, const glm::vec3& focus) {
+	for (int ix = 0; ix < 10000; ix++) {
+		streamer.Tick(focus, 1000.0f);
+		scene->Update(0.0f, nullptr);
+		if (streamer.NumPendingCells() == 0) {
+			return;
+		}
+		std::this_thread::yield();
+	}
+}
+
+// Counts objects that should be loaded but aren't, and objects that should have been unloaded but weren't
+static void CountWrongObjects(const Scene::Sptr& scene, const std::vector<SourceObject>& objects, const glm::vec3& focus, int& missing, int& extra) {
+	missing = 0;
+	extra = 0;
+	for (const SourceObject& object : objects) {
+		float distance = DistanceToCellOf(object.Position, glm::vec2(focus));
+		bool isLoaded = scene->FindObjectByGUID(object.Id) != nullptr;
+		if (distance <= LoadRadius && !isLoaded) {
+			missing++;
+		} else if (distance > UnloadRadius && isLoaded) {
+			extra++;
+		}
+	}
+}
+
+TEST_CASE(WorldStreamer_FlyThrough) {
+	Tests::InitEngine();
+
+	std::vector<SourceObject> objects;
+	std::string path = BuildStreamedWorld("world_streamer_test", 150, objects);
+	Scene::Sptr scene = Scene::Load(path);
+	REQUIRE(scene != nullptr);
+	REQUIRE(scene->IsStreamed());
+
+	JobSystem jobs;
+	WorldStreamer streamer(jobs);
+	streamer.SetScene(scene);
+	CHECK(streamer.NumCells() == static_cast<int>((WorldSize / CellSize) * (WorldSize / CellSize)));
+
+	glm::vec3 start = glm::vec3(5.0f, 5.0f, 0.0f);
+	Settle(streamer, scene, start);
+	int missing, extra;
+	CountWrongObjects(scene, objects, start, missing, extra);
+	CHECK(missing == 0);
+	CHECK(extra == 0);
+
+	// Fly diagonally across the world and back at a steady speed, a frame at a time
+	const float budgetMs = 2.0f;
+	const int frames = 600;
+	std::vector<double> tickMs;
+	tickMs.reserve(frames * 2);
+	int peakObjects = 0;
+	glm::vec3 end = glm::vec3(WorldSize - 5.0f, WorldSize - 5.0f, 0.0f);
+	for (int pass = 0; pass < 2; pass++) {
+		for (int frame = 0; frame <= frames; frame++) {
+			float t = static_cast<float>(frame) / frames;
+			glm::vec3 focus = pass == 0 ? glm::mix(start, end, t) : glm::mix(end, start, t);
+
+			auto tickStart = std::chrono::high_resolution_clock::now();
+			streamer.Tick(focus, budgetMs);
+			tickMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - tickStart).count());
+			scene->Update(1.0f / 60.0f, nullptr);
+			peakObjects = std::max(peakObjects, scene->NumObjects());
+		}
+
+		// Once it catches up, the streamed objects match the focus exactly
+		glm::vec3 focus = pass == 0 ? end : start;
+		Settle(streamer, scene, focus);
+		CountWrongObjects(scene, objects, focus, missing, extra);
+		CHECK(missing == 0);
+		CHECK(extra == 0);
+	}
+
+	// Only the area around the focus should ever have been in memory
+	CHECK(peakObjects < static_cast<int>(objects.size()) / 4);
+
+	// Work is only interrupted between objects, and unloading a cell is not budgeted, so a Tick can
+	// run over a little. The slack covers that and the odd time the scheduler takes the thread away
+	const double slackMs = 1.0;
+	double maxMs = 0.0;
+	double totalMs = 0.0;
+	int overBudget = 0;
+	for (double ms : tickMs) {
+		maxMs = std::max(maxMs, ms);
+		totalMs += ms;
+		overBudget += ms > budgetMs + slackMs ? 1 : 0;
+	}
+	CHECK(overBudget <= static_cast<int>(tickMs.size()) / 100);
+	CHECK(maxMs < budgetMs * 5.0);
+	Tests::Report("Fly-through, " + std::to_string(objects.size()) + " objects, average Tick", totalMs / tickMs.size());
+	Tests::Report("Fly-through, longest Tick (2ms budget)", maxMs);
+	Tests::Report("Fly-through, frames over budget (+1ms)", overBudget, "frames");
+	Tests::Report("Fly-through, peak objects loaded", peakObjects, "objects");
+
+	streamer.SetScene(nullptr);
+	std::error_code error;
+	std::filesystem::remove_all(std::filesystem::path(path).parent_path(), error);
+}